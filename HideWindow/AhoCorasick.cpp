@@ -0,0 +1,126 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "AhoCorasick.h"
+#include <deque>
+
+// ===================== AhoCorasick 类实现 =====================
+AhoCorasick::AhoCorasick(quint32 options)
+    : m_options(options)
+{
+}
+
+int AhoCorasick::addPattern(QStringView pattern) {
+    if (pattern.isEmpty()) {
+        return -1;
+    }
+    QString folded;
+    folded.resize(pattern.size());
+    for (qsizetype i = 0; i < pattern.size(); ++i) {
+        folded[i] = QChar(fold(pattern.utf16()[i]));
+    }
+    auto it = m_patternIds.constFind(folded);
+    if (it != m_patternIds.constEnd()) {
+        return it.value();
+    }
+    const int id = static_cast<int>(m_patterns.size());
+    m_patternIds.insert(folded, id);
+    m_patternLengths.push_back(static_cast<int>(folded.size()));
+    m_patterns.push_back(folded);
+    return id;
+}
+
+void AhoCorasick::clear() {
+    m_patternIds.clear();
+    m_patterns.clear();
+    m_patternLengths.clear();
+    m_classes.clear();
+    m_classCount = 0;
+    m_next.clear();
+    m_dictLink.clear();
+    m_outputBegin.clear();
+    m_outputs.clear();
+}
+
+void AhoCorasick::build() {
+    m_next.clear();
+    m_dictLink.clear();
+    m_outputBegin.clear();
+    m_outputs.clear();
+
+    // 只给模式中出现过的码元分配字符类，其余码元都落在类 0，转移表宽度与字母表大小无关
+    m_classes.assign(0x10000, 0);
+    m_classCount = 1;
+    for (const QString& pattern : m_patterns) {
+        for (QChar c : pattern) {
+            quint16& cls = m_classes[c.unicode()];
+            if (cls == 0) {
+                cls = static_cast<quint16>(m_classCount++);
+            }
+        }
+    }
+
+    // 建立字典树，未定义的转移为 -1
+    std::vector<std::vector<int>> ownOutputs(1);
+    m_next.assign(m_classCount, -1);
+    for (std::size_t id = 0; id < m_patterns.size(); ++id) {
+        qint32 state = 0;
+        for (QChar c : m_patterns[id]) {
+            const std::size_t slot = static_cast<std::size_t>(state) * m_classCount + m_classes[c.unicode()];
+            if (m_next[slot] < 0) {
+                const qint32 created = static_cast<qint32>(ownOutputs.size());
+                ownOutputs.emplace_back();
+                m_next.resize(m_next.size() + m_classCount, -1);
+                m_next[slot] = created;
+            }
+            state = m_next[slot];
+        }
+        ownOutputs[state].push_back(static_cast<int>(id));
+    }
+
+    // 按层次补全失败转移，得到完整 DFA；同时求出每个状态的字典后缀链接
+    const std::size_t stateCount = ownOutputs.size();
+    std::vector<qint32> fail(stateCount, 0);
+    m_dictLink.assign(stateCount, 0);
+    std::deque<qint32> queue;
+    for (std::size_t cls = 0; cls < m_classCount; ++cls) {
+        qint32& child = m_next[cls];
+        if (child < 0) {
+            child = 0;
+        }
+        else {
+            queue.push_back(child);
+        }
+    }
+    while (!queue.empty()) {
+        const qint32 state = queue.front();
+        queue.pop_front();
+        const std::size_t row = static_cast<std::size_t>(state) * m_classCount;
+        const std::size_t failRow = static_cast<std::size_t>(fail[state]) * m_classCount;
+        for (std::size_t cls = 0; cls < m_classCount; ++cls) {
+            qint32& child = m_next[row + cls];
+            if (child < 0) {
+                child = m_next[failRow + cls];
+                continue;
+            }
+            const qint32 target = m_next[failRow + cls];
+            fail[child] = target;
+            m_dictLink[child] = !ownOutputs[target].empty() ? target : m_dictLink[target];
+            queue.push_back(child);
+        }
+    }
+
+    m_outputBegin.reserve(stateCount + 1);
+    for (const std::vector<int>& outputs : ownOutputs) {
+        m_outputBegin.push_back(static_cast<qint32>(m_outputs.size()));
+        m_outputs.insert(m_outputs.end(), outputs.begin(), outputs.end());
+    }
+    m_outputBegin.push_back(static_cast<qint32>(m_outputs.size()));
+}
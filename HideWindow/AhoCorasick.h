@@ -0,0 +1,95 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+#ifndef AHOCORASICK_H
+#define AHOCORASICK_H
+#include <QChar>
+#include <QHash>
+#include <QString>
+#include <QStringView>
+#include <QtGlobal>
+#include <vector>
+
+// 多模式字面量匹配（Aho-Corasick）：一次扫描文本即可找出所有模式的所有出现位置。
+// 字符按 UTF-16 码元处理；编译后为稠密 DFA（状态 × 字符类），扫描时每个码元只查一次表。
+class AhoCorasick {
+public:
+    enum Option : quint32 {
+        CaseInsensitive = 0x1,  // 按 Unicode 大小写折叠比较
+        UnifySeparators = 0x2   // 把 '/' 视为 '\\'（用于路径）
+    };
+
+    explicit AhoCorasick(quint32 options = CaseInsensitive);
+
+    // 添加模式并返回其编号；相同（折叠后）的模式返回同一编号。空模式返回 -1
+    int addPattern(QStringView pattern);
+    // 修改模式后必须重新编译才能扫描
+    void build();
+    void clear();
+
+    int patternCount() const { return static_cast<int>(m_patternLengths.size()); }
+    int patternLength(int id) const { return m_patternLengths[id]; }
+    int stateCount() const { return static_cast<int>(m_dictLink.size()); }
+    quint32 options() const { return m_options; }
+
+    // 与编译时相同的字符规范化，供调用方自行比较（例如通配符校验）
+    char16_t fold(char16_t c) const { return fold(c, m_options); }
+    static char16_t fold(char16_t c, quint32 options) {
+        if ((options & UnifySeparators) && c == u'/') {
+            return u'\\';
+        }
+        if (options & CaseInsensitive) {
+            if (c < 0x80) {
+                return (c >= u'A' && c <= u'Z') ? static_cast<char16_t>(c + 32) : c;
+            }
+            return static_cast<char16_t>(QChar::toCaseFolded(static_cast<char32_t>(c)));
+        }
+        return c;
+    }
+
+    // 对每次出现调用 fn(patternId, end)，end 为出现位置之后的下标；fn 返回 false 时停止扫描
+    template <typename Fn>
+    void scan(QStringView text, Fn fn) const {
+        if (m_next.empty()) {
+            return;
+        }
+        qint32 state = 0;
+        const qsizetype length = text.size();
+        const char16_t* data = text.utf16();
+        for (qsizetype i = 0; i < length; ++i) {
+            const quint16 cls = m_classes[fold(data[i])];
+            state = m_next[static_cast<std::size_t>(state) * m_classCount + cls];
+            for (qint32 s = m_outputBegin[state] != m_outputBegin[state + 1] ? state : m_dictLink[state];
+                s > 0; s = m_dictLink[s]) {
+                for (qint32 o = m_outputBegin[s]; o < m_outputBegin[s + 1]; ++o) {
+                    if (!fn(m_outputs[o], static_cast<int>(i + 1))) {
+                        return;
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    quint32 m_options;
+    QHash<QString, int> m_patternIds; // 折叠后的模式 -> 编号
+    std::vector<QString> m_patterns;
+    std::vector<int> m_patternLengths;
+
+    // 编译结果
+    std::vector<quint16> m_classes;     // 折叠后的码元 -> 字符类（0 表示不出现在任何模式中）
+    std::size_t m_classCount = 0;
+    std::vector<qint32> m_next;         // 状态 * m_classCount + 字符类 -> 下一状态
+    std::vector<qint32> m_dictLink;     // 最近的、自身带输出的后缀状态（0 表示没有）
+    std::vector<qint32> m_outputBegin;  // 状态自身的输出在 m_outputs 中的范围（多一个哨兵）
+    std::vector<int> m_outputs;
+};
+#endif
@@ -0,0 +1,315 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "AsyncLog.h"
+#include "Metrics.h"
+#include "SpscRing.h"
+#include <QDebug>
+#include <QMutex>
+#include <QSemaphore>
+#include <QThread>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace AsyncLog {
+
+namespace {
+constexpr quint64 kRateWindowNs = 1000ull * 1000 * 1000;
+constexpr std::size_t kQueueCapacity = 4096;
+// 后台线程没有被唤醒时的最长等待，也是限流汇总的报告间隔
+constexpr int kIdleWaitMs = 100;
+
+// 单个线程的队列：只有所属线程写入，后台线程（或 flush 的调用者）读取
+struct ThreadQueue {
+    SpscRing<Record> ring{ kQueueCapacity };
+    std::atomic<bool> orphaned{ false }; // 所属线程已退出，取空后即可回收
+};
+
+struct LogState {
+    QMutex mutex; // 保护 queues/categories 列表
+    std::vector<std::shared_ptr<ThreadQueue>> queues;
+    std::vector<Category*> categories;
+    quint64 retiredDropped = 0; // 已回收队列的丢弃数
+
+    QMutex drainMutex; // 同一时刻只有一个线程取出并输出记录，保证输出顺序
+    std::vector<Record> batch;
+    quint64 reportedDropped = 0;
+    quint64 lastReport = 0;
+
+    QThread* thread = nullptr;
+    QSemaphore wakeup;
+    std::atomic<bool> running{ false };
+    std::atomic<bool> sleeping{ false };
+};
+
+LogState& state() {
+    static LogState instance;
+    return instance;
+}
+
+// 线程退出时标记队列，剩余记录仍会被输出
+struct QueueOwner {
+    std::shared_ptr<ThreadQueue> queue;
+    ~QueueOwner() {
+        if (queue) {
+            queue->orphaned.store(true, std::memory_order_release);
+        }
+    }
+};
+
+thread_local QueueOwner t_owner;
+
+ThreadQueue* currentQueue() {
+    ThreadQueue* queue = t_owner.queue.get();
+    if (queue) {
+        return queue;
+    }
+    LogState& s = state();
+    t_owner.queue = std::make_shared<ThreadQueue>();
+    QMutexLocker locker(&s.mutex);
+    s.queues.push_back(t_owner.queue);
+    return t_owner.queue.get();
+}
+
+QString formatArgument(const Record& record, int index) {
+    const quint64 value = record.args[index];
+    switch (record.types[index]) {
+    case Record::Int:
+        return QString::number(static_cast<qint64>(value));
+    case Record::UInt:
+        return QString::number(value);
+    case Record::Double: {
+        double number = 0;
+        std::memcpy(&number, &value, sizeof(number));
+        return QString::number(number);
+    }
+    case Record::Pointer:
+        return QStringLiteral("0x") + QString::number(value, 16);
+    case Record::String:
+        return QString::fromUtf8(reinterpret_cast<const char*>(value));
+    case Record::Utf16: {
+        const int length = qMin(static_cast<int>(record.textLength), static_cast<int>(Record::kTextCapacity));
+        QString text = QString::fromUtf16(record.text, length);
+        if (record.textLength > Record::kTextCapacity) {
+            text += QChar(0x2026);
+        }
+        return text;
+    }
+    default:
+        return QString();
+    }
+}
+
+void emitLine(Level level, const char* category, const QString& text) {
+    // 保留分类名，QT_MESSAGE_PATTERN 中的 %{category} 仍然可用
+    QMessageLogger logger(nullptr, 0, nullptr, category);
+    switch (level) {
+    case Level::Debug:
+        logger.debug().noquote() << text;
+        break;
+    case Level::Info:
+        logger.info().noquote() << text;
+        break;
+    case Level::Warning:
+        logger.warning().noquote() << text;
+        break;
+    }
+}
+
+void reportLosses(LogState& s, bool force) {
+    const quint64 now = detail::now();
+    if (!force && now - s.lastReport < kRateWindowNs) {
+        return;
+    }
+    s.lastReport = now;
+    std::vector<Category*> categories;
+    {
+        QMutexLocker locker(&s.mutex);
+        categories = s.categories;
+    }
+    for (Category* category : categories) {
+        const quint64 suppressed = category->takeSuppressed();
+        if (suppressed) {
+            emitLine(Level::Warning, category->name(),
+                QStringLiteral("%1 messages suppressed by rate limit").arg(suppressed));
+        }
+    }
+    const quint64 dropped = droppedCount();
+    if (dropped != s.reportedDropped) {
+        emitLine(Level::Warning, "log", QStringLiteral("%1 messages dropped, log queue full").arg(dropped - s.reportedDropped));
+        s.reportedDropped = dropped;
+    }
+}
+
+// 取出所有队列中的记录，按时间戳排序后输出；返回输出的条数
+int drain(bool forceReport) {
+    LogState& s = state();
+    QMutexLocker drainLocker(&s.drainMutex);
+    std::vector<std::shared_ptr<ThreadQueue>> queues;
+    {
+        QMutexLocker locker(&s.mutex);
+        queues = s.queues;
+    }
+
+    s.batch.clear();
+    Record record;
+    std::vector<ThreadQueue*> finished;
+    for (const std::shared_ptr<ThreadQueue>& queue : queues) {
+        // 所属线程已退出时不会再有写入，取空后即可回收
+        if (queue->orphaned.load(std::memory_order_acquire)) {
+            finished.push_back(queue.get());
+        }
+        while (queue->ring.pop(record)) {
+            s.batch.push_back(record);
+        }
+    }
+    // 各线程的记录分别有序，合并后按时间戳排列
+    std::stable_sort(s.batch.begin(), s.batch.end(), [](const Record& a, const Record& b) {
+        return a.timestamp < b.timestamp;
+    });
+    for (const Record& entry : s.batch) {
+        emitLine(entry.level, entry.category->name(), format(entry));
+    }
+
+    if (!finished.empty()) {
+        QMutexLocker locker(&s.mutex);
+        s.queues.erase(std::remove_if(s.queues.begin(), s.queues.end(),
+            [&](const std::shared_ptr<ThreadQueue>& queue) {
+                if (std::find(finished.begin(), finished.end(), queue.get()) == finished.end()) {
+                    return false;
+                }
+                s.retiredDropped += queue->ring.droppedCount();
+                return true;
+            }), s.queues.end());
+    }
+    reportLosses(s, forceReport);
+    return static_cast<int>(s.batch.size());
+}
+
+void run() {
+    LogState& s = state();
+    while (s.running.load()) {
+        if (drain(false) > 0) {
+            continue;
+        }
+        // 先声明要休眠再检查一次，避免错过刚写入的记录；极端情况下最多延迟 kIdleWaitMs
+        s.sleeping.store(true);
+        if (drain(false) > 0) {
+            s.sleeping.store(false);
+            continue;
+        }
+        s.wakeup.tryAcquire(1, kIdleWaitMs);
+        s.sleeping.store(false);
+    }
+}
+} // namespace
+
+// ===================== Category 类实现 =====================
+Category::Category(const char* name, quint32 maxPerSecond)
+    : m_name(name)
+    , m_maxPerSecond(maxPerSecond)
+{
+    LogState& s = state();
+    QMutexLocker locker(&s.mutex);
+    s.categories.push_back(this);
+}
+
+bool Category::admit() {
+    const quint32 limit = maxPerSecond();
+    if (limit == 0) {
+        return true;
+    }
+    // 固定一秒窗口计数；窗口切换时的竞争只会让个别记录多放行或多丢弃，不影响限流效果
+    const quint64 now = detail::now();
+    quint64 windowStart = m_windowStart.load(std::memory_order_relaxed);
+    if (now - windowStart >= kRateWindowNs
+        && m_windowStart.compare_exchange_strong(windowStart, now, std::memory_order_relaxed)) {
+        m_windowCount.store(0, std::memory_order_relaxed);
+    }
+    if (m_windowCount.fetch_add(1, std::memory_order_relaxed) < limit) {
+        return true;
+    }
+    m_suppressed.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+namespace detail {
+quint64 now() {
+    return Metrics::now();
+}
+
+void submit(const Record& record) {
+    currentQueue()->ring.push(record);
+    LogState& s = state();
+    // 后台线程空闲等待时才需要唤醒，平时只有一次读取
+    if (s.sleeping.load(std::memory_order_relaxed) && s.sleeping.exchange(false)) {
+        s.wakeup.release();
+    }
+}
+} // namespace detail
+
+QString format(const Record& record) {
+    const char* format = record.format ? record.format : "";
+    QString out;
+    out.reserve(static_cast<int>(std::strlen(format)) + 32);
+    const char* literal = format;
+    for (const char* p = format; *p; ++p) {
+        // 只识别 %1..%4，其余 % 原样输出
+        if (p[0] == '%' && p[1] >= '1' && p[1] <= '0' + Record::kMaxArgs) {
+            const int index = p[1] - '1';
+            out += QString::fromUtf8(literal, static_cast<int>(p - literal));
+            out += index < record.argCount ? formatArgument(record, index) : QString();
+            ++p;
+            literal = p + 1;
+        }
+    }
+    out += QString::fromUtf8(literal);
+    return out;
+}
+
+void start() {
+    LogState& s = state();
+    if (s.thread) {
+        return;
+    }
+    s.running.store(true);
+    s.thread = QThread::create(&run);
+    s.thread->setObjectName(QStringLiteral("AsyncLog"));
+    s.thread->start(QThread::LowPriority);
+}
+
+void stop() {
+    LogState& s = state();
+    if (s.thread) {
+        s.running.store(false);
+        s.wakeup.release();
+        s.thread->wait();
+        delete s.thread;
+        s.thread = nullptr;
+    }
+    drain(true);
+}
+
+void flush() {
+    drain(true);
+}
+
+quint64 droppedCount() {
+    LogState& s = state();
+    QMutexLocker locker(&s.mutex);
+    quint64 total = s.retiredDropped;
+    for (const std::shared_ptr<ThreadQueue>& queue : s.queues) {
+        total += queue->ring.droppedCount();
+    }
+    return total;
+}
+
+} // namespace AsyncLog
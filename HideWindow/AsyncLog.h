@@ -0,0 +1,199 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+#ifndef ASYNCLOG_H
+#define ASYNCLOG_H
+// 异步二进制日志：调用方只把格式串指针和参数写入本线程的无锁环形队列（定长记录、不分配内存），
+// 由后台线程统一格式化后交给 Qt 的消息处理器（qDebug/qInfo/qWarning）。
+//
+// 用法：
+//     AsyncLog::Category s_windowLog("window");
+//     HW_LOG_DEBUG(s_windowLog, "Hidden window: %1 Title: %2", hwnd, AsyncLog::Text(buffer, length));
+// 格式串必须是字符串字面量（记录中只保存指针，作为格式 id），占位符为 %1..%4。
+#include <QString>
+#include <QtGlobal>
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+namespace AsyncLog {
+
+enum class Level : quint8 {
+    Debug,
+    Info,
+    Warning
+};
+
+// 日志分类，带每秒条数上限（0 表示不限）；超出部分丢弃并计数，由后台线程汇总报告一次。
+// 分类对象必须具有静态存储期（构造时登记到全局列表，不会注销）。
+class Category {
+public:
+    explicit Category(const char* name, quint32 maxPerSecond = 0);
+    Category(const Category&) = delete;
+    Category& operator=(const Category&) = delete;
+
+    const char* name() const { return m_name; }
+
+    void setMaxPerSecond(quint32 maxPerSecond) { m_maxPerSecond.store(maxPerSecond, std::memory_order_relaxed); }
+    quint32 maxPerSecond() const { return m_maxPerSecond.load(std::memory_order_relaxed); }
+
+    // 按限流决定本条是否写入；拒绝时计入 suppressed
+    bool admit();
+    // 取出并清零被限流丢弃的条数
+    quint64 takeSuppressed() { return m_suppressed.exchange(0, std::memory_order_relaxed); }
+
+private:
+    const char* m_name;
+    std::atomic<quint32> m_maxPerSecond;
+    std::atomic<quint64> m_windowStart{ 0 }; // 当前一秒窗口的起点（纳秒）
+    std::atomic<quint32> m_windowCount{ 0 };
+    std::atomic<quint64> m_suppressed{ 0 };
+};
+
+// 按值捕获的 UTF-16 文本参数；写入记录时截断为 kTextCapacity 个字符
+struct Text {
+    Text(const char16_t* data, int length) : utf16(data), wide(nullptr), length(length) {}
+    Text(const wchar_t* data, int length) : utf16(nullptr), wide(data), length(length) {}
+    Text(const QString& text) : utf16(reinterpret_cast<const char16_t*>(text.utf16())), wide(nullptr), length(static_cast<int>(text.size())) {}
+
+    const char16_t* utf16;
+    const wchar_t* wide;
+    int length;
+};
+
+// 定长日志记录（128 字节）
+struct Record {
+    static constexpr int kMaxArgs = 4;
+    static constexpr int kTextCapacity = 32;
+
+    enum ArgType : quint8 {
+        None,
+        Int,
+        UInt,
+        Double,
+        Pointer,
+        String, // 指向静态存储期的 C 字符串
+        Utf16   // 记录内的 text 槽位
+    };
+
+    const char* format = nullptr; // 格式 id：字符串字面量的地址
+    Category* category = nullptr;
+    quint64 timestamp = 0;        // Metrics::now()
+    quint64 args[kMaxArgs] = {};
+    quint8 types[kMaxArgs] = {};
+    Level level = Level::Debug;
+    quint8 argCount = 0;
+    quint16 textLength = 0;       // 原始长度，超过 kTextCapacity 时格式化后加省略号
+    char16_t text[kTextCapacity] = {};
+};
+static_assert(sizeof(Record) == 128, "log records are fixed size");
+static_assert(std::is_trivially_copyable<Record>::value, "log records are copied without locks");
+
+namespace detail {
+// 把记录写入当前线程的队列；队列满时丢弃并计数
+void submit(const Record& record);
+quint64 now();
+
+template <typename T>
+typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type
+encode(Record& record, T value) {
+    const int index = record.argCount++;
+    if (std::is_signed<T>::value) {
+        record.types[index] = Record::Int;
+        record.args[index] = static_cast<quint64>(static_cast<qint64>(value));
+    }
+    else {
+        record.types[index] = Record::UInt;
+        record.args[index] = static_cast<quint64>(value);
+    }
+}
+
+inline void encode(Record& record, bool value) {
+    const int index = record.argCount++;
+    record.types[index] = Record::UInt;
+    record.args[index] = value ? 1 : 0;
+}
+
+inline void encode(Record& record, double value) {
+    const int index = record.argCount++;
+    record.types[index] = Record::Double;
+    std::memcpy(&record.args[index], &value, sizeof(value));
+}
+
+inline void encode(Record& record, const char* value) {
+    const int index = record.argCount++;
+    record.types[index] = Record::String;
+    record.args[index] = reinterpret_cast<quint64>(value);
+}
+
+template <typename T>
+void encode(Record& record, T* value) {
+    const int index = record.argCount++;
+    record.types[index] = Record::Pointer;
+    record.args[index] = reinterpret_cast<quint64>(value);
+}
+
+// 记录只有一个文本槽位，每条日志最多一个文本参数
+inline void encode(Record& record, const Text& value) {
+    const int index = record.argCount++;
+    record.types[index] = Record::Utf16;
+    const int length = qMax(0, value.length);
+    const int copied = qMin(length, static_cast<int>(Record::kTextCapacity));
+    for (int i = 0; i < copied; ++i) {
+        record.text[i] = value.utf16 ? value.utf16[i] : static_cast<char16_t>(value.wide[i]);
+    }
+    record.textLength = static_cast<quint16>(qMin(length, 0xFFFF));
+}
+
+inline void encodeAll(Record&) {}
+
+template <typename T, typename... Rest>
+void encodeAll(Record& record, const T& value, const Rest&... rest) {
+    encode(record, value);
+    encodeAll(record, rest...);
+}
+} // namespace detail
+
+template <typename... Args>
+void write(Category& category, Level level, const char* format, const Args&... args) {
+    static_assert(sizeof...(Args) <= Record::kMaxArgs, "too many log arguments");
+    if (!category.admit()) {
+        return;
+    }
+    Record record;
+    record.format = format;
+    record.category = &category;
+    record.level = level;
+    record.timestamp = detail::now();
+    detail::encodeAll(record, args...);
+    detail::submit(record);
+}
+
+// 启动后台格式化线程；此前写入的记录保留在队列中，启动后一并输出
+void start();
+// 输出所有已写入的记录并停止后台线程
+void stop();
+// 在调用线程同步输出所有已写入的记录
+void flush();
+
+// 因队列满而丢弃的记录数
+quint64 droppedCount();
+
+// 把一条记录格式化为文本（不含分类与级别前缀）
+QString format(const Record& record);
+
+} // namespace AsyncLog
+
+#define HW_LOG_DEBUG(category, ...) ::AsyncLog::write(category, ::AsyncLog::Level::Debug, __VA_ARGS__)
+#define HW_LOG_INFO(category, ...) ::AsyncLog::write(category, ::AsyncLog::Level::Info, __VA_ARGS__)
+#define HW_LOG_WARNING(category, ...) ::AsyncLog::write(category, ::AsyncLog::Level::Warning, __VA_ARGS__)
+
+#endif
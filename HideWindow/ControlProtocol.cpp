@@ -0,0 +1,112 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "ControlProtocol.h"
+
+namespace ControlProtocol {
+
+namespace {
+void appendU32(QByteArray& out, quint32 value) {
+    const char bytes[4] = {
+        static_cast<char>(value & 0xff),
+        static_cast<char>((value >> 8) & 0xff),
+        static_cast<char>((value >> 16) & 0xff),
+        static_cast<char>((value >> 24) & 0xff)
+    };
+    out.append(bytes, 4);
+}
+
+quint32 readU32(const char* data) {
+    const auto* bytes = reinterpret_cast<const uchar*>(data);
+    return static_cast<quint32>(bytes[0]) | (static_cast<quint32>(bytes[1]) << 8)
+        | (static_cast<quint32>(bytes[2]) << 16) | (static_cast<quint32>(bytes[3]) << 24);
+}
+} // namespace
+
+void appendFrame(QByteArray& out, quint8 code, quint32 id, const QByteArray& payload) {
+    out.reserve(out.size() + kHeaderSize + payload.size());
+    appendU32(out, static_cast<quint32>(kHeaderSize - 4 + payload.size()));
+    out.append(static_cast<char>(code));
+    appendU32(out, id);
+    out.append(payload);
+}
+
+ParseResult takeFrame(const QByteArray& buffer, qsizetype& offset, Frame& frame) {
+    if (buffer.size() - offset < 4) {
+        return ParseResult::Incomplete;
+    }
+    const quint32 length = readU32(buffer.constData() + offset);
+    if (length < kHeaderSize - 4 || length > kMaxFrameSize) {
+        return ParseResult::Invalid;
+    }
+    if (static_cast<quint64>(buffer.size() - offset - 4) < length) {
+        return ParseResult::Incomplete;
+    }
+    const char* data = buffer.constData() + offset + 4;
+    frame.code = static_cast<quint8>(data[0]);
+    frame.id = readU32(data + 1);
+    frame.payload = QByteArray(data + 5, static_cast<qsizetype>(length) - 5);
+    offset += 4 + static_cast<qsizetype>(length);
+    return ParseResult::Frame;
+}
+
+// ===================== PayloadWriter 类实现 =====================
+void PayloadWriter::writeVarint(quint64 value) {
+    char bytes[10];
+    int count = 0;
+    do {
+        char byte = static_cast<char>(value & 0x7f);
+        value >>= 7;
+        if (value != 0) {
+            byte = static_cast<char>(byte | 0x80);
+        }
+        bytes[count++] = byte;
+    } while (value != 0);
+    m_out.append(bytes, count);
+}
+
+void PayloadWriter::writeString(const QString& text) {
+    const QByteArray utf8 = text.toUtf8();
+    writeVarint(static_cast<quint64>(utf8.size()));
+    m_out.append(utf8);
+}
+
+// ===================== PayloadReader 类实现 =====================
+bool PayloadReader::readVarint(quint64& value) {
+    value = 0;
+    for (int shift = 0; m_ok && shift < 64; shift += 7) {
+        if (m_cursor == m_end) {
+            break;
+        }
+        const auto byte = static_cast<uchar>(*m_cursor++);
+        value |= static_cast<quint64>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    m_ok = false;
+    return false;
+}
+
+bool PayloadReader::readString(QString& text) {
+    quint64 length = 0;
+    if (!readVarint(length)) {
+        return false;
+    }
+    if (length > static_cast<quint64>(m_end - m_cursor)) {
+        m_ok = false;
+        return false;
+    }
+    text = QString::fromUtf8(m_cursor, static_cast<qsizetype>(length));
+    m_cursor += length;
+    return true;
+}
+
+} // namespace ControlProtocol
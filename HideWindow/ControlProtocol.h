@@ -0,0 +1,104 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+#ifndef CONTROLPROTOCOL_H
+#define CONTROLPROTOCOL_H
+// 本地控制协议的帧格式（QLocalSocket 之上）：
+//
+//     u32 length   小端，其后 code + id + payload 的字节数
+//     u8  code     请求为 Opcode，响应为 Status
+//     u32 id       小端，请求方自选，响应原样带回
+//     payload      由 varint（无符号 LEB128）与字符串（varint 字节数 + UTF-8）组成
+//
+// 客户端可以不等响应连续发送多条请求（流水线），服务端按到达顺序逐条执行，
+// 同一次读到的所有请求的响应合并为一次写出。
+#include <QByteArray>
+#include <QString>
+#include <QtGlobal>
+
+namespace ControlProtocol {
+
+constexpr int kHeaderSize = 9;
+// 单帧上限，超过视为协议错误并断开连接
+constexpr quint32 kMaxFrameSize = 16 * 1024 * 1024;
+
+enum class Opcode : quint8 {
+    Ping = 1,
+    HidePids = 2,      // varint n, n × varint pid              -> varint 改变的窗口数
+    ShowPids = 3,      // 同上
+    HideName = 4,      // string 可执行文件名通配符（不区分大小写） -> varint 匹配的进程数, varint 改变的窗口数
+    ShowName = 5,      // 同上
+    AddRule = 6,       // string 规则（语法见 RuleEngine.h）      -> varint 改变的窗口数
+    RemoveRule = 7,    // 同上
+    ListProcesses = 8, // string 名称通配符（空串表示全部）        -> varint n, n × { pid, ppid, name, path, 已隐藏窗口数 }
+    QueryState = 9,    // -> varint 已隐藏窗口数, varint 已索引窗口数, varint n, n × pid, varint m, m × string 规则
+    ShowAll = 10,      // -> varint 改变的窗口数
+    Shutdown = 11,     // 还原所有窗口后退出（无界面实例）或只关闭控制服务（图形界面实例）
+    Stats = 12         // -> string 性能指标报告（Metrics::Registry::dump，每行一个指标）
+};
+
+// 响应码；非 Ok 时 payload 为一条错误信息字符串
+enum class Status : quint8 {
+    Ok = 0,
+    BadRequest = 1,  // 载荷格式错误或参数无效
+    UnknownOpcode = 2,
+    Unavailable = 3  // 当前实例不支持（例如平台没有窗口系统）
+};
+
+struct Frame {
+    quint8 code = 0;
+    quint32 id = 0;
+    QByteArray payload;
+};
+
+// 在 out 末尾追加一帧
+void appendFrame(QByteArray& out, quint8 code, quint32 id, const QByteArray& payload);
+
+enum class ParseResult {
+    Frame,      // 取出一帧，offset 前移
+    Incomplete, // 数据不足一帧，等待更多数据
+    Invalid     // 长度非法，应断开连接
+};
+// 从 buffer 的 offset 处取出一帧。调用方处理完一批后再一次性丢弃 offset 之前的数据
+ParseResult takeFrame(const QByteArray& buffer, qsizetype& offset, Frame& frame);
+
+// 载荷编码
+class PayloadWriter {
+public:
+    explicit PayloadWriter(QByteArray& out) : m_out(out) {}
+    void writeVarint(quint64 value);
+    void writeString(const QString& text);
+
+private:
+    QByteArray& m_out;
+};
+
+// 载荷解码；任何一次读取越界后 ok() 为 false，之后的读取都返回 false
+class PayloadReader {
+public:
+    explicit PayloadReader(const QByteArray& payload)
+        : m_cursor(payload.constData())
+        , m_end(payload.constData() + payload.size())
+    {
+    }
+    bool readVarint(quint64& value);
+    bool readString(QString& text);
+    bool atEnd() const { return m_cursor == m_end; }
+    bool ok() const { return m_ok; }
+
+private:
+    const char* m_cursor;
+    const char* m_end;
+    bool m_ok = true;
+};
+
+} // namespace ControlProtocol
+#endif
@@ -0,0 +1,160 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "ControlServer.h"
+#include "AsyncLog.h"
+#include "ControlProtocol.h"
+#include "ControlService.h"
+#include "Trace.h"
+#include <QLocalServer>
+#include <QLocalSocket>
+
+namespace {
+AsyncLog::Category s_controlLog("control", 20);
+
+// 探测同名服务是否仍在运行的等待时间
+constexpr int kProbeTimeoutMs = 200;
+} // namespace
+
+// ===================== ControlServer 类实现 =====================
+ControlServer::ControlServer(ControlService* service, QObject* parent)
+    : QObject(parent)
+    , m_service(service)
+    , m_server(new QLocalServer(this))
+{
+    // 命名管道 / 套接字文件只对当前用户开放
+    m_server->setSocketOptions(QLocalServer::UserAccessOption);
+    connect(m_server, &QLocalServer::newConnection, this, &ControlServer::onNewConnection);
+    connect(m_service, &ControlService::responseReady, this, &ControlServer::onResponseReady);
+}
+
+ControlServer::~ControlServer() {
+    close();
+}
+
+bool ControlServer::listen(const QString& name) {
+    if (m_server->listen(name)) {
+        return true;
+    }
+    if (m_server->serverError() == QAbstractSocket::AddressInUseError) {
+        if (isServing(name)) {
+            HW_LOG_INFO(s_controlLog, "Control server already running: %1", name);
+            return false;
+        }
+        // 无人应答：上次异常退出遗留的套接字文件
+        QLocalServer::removeServer(name);
+        if (m_server->listen(name)) {
+            return true;
+        }
+    }
+    HW_LOG_WARNING(s_controlLog, "Control server failed to listen: %1", m_server->errorString());
+    return false;
+}
+
+bool ControlServer::isServing(const QString& name) {
+    QLocalSocket probe;
+    probe.connectToServer(name);
+    return probe.waitForConnected(kProbeTimeoutMs);
+}
+
+void ControlServer::close() {
+    m_server->close();
+    for (auto it = m_connections.cbegin(); it != m_connections.cend(); ++it) {
+        m_service->cancel(reinterpret_cast<quintptr>(it.key()));
+        it.key()->disconnect(this);
+        it.key()->abort();
+        it.key()->deleteLater();
+    }
+    m_connections.clear();
+}
+
+bool ControlServer::isListening() const {
+    return m_server->isListening();
+}
+
+QString ControlServer::defaultServerName() {
+#ifdef Q_OS_WIN
+    const QString user = qEnvironmentVariable("USERNAME");
+#else
+    const QString user = qEnvironmentVariable("USER");
+#endif
+    return QStringLiteral("HideWindow.control.") + (user.isEmpty() ? QStringLiteral("default") : user);
+}
+
+void ControlServer::onNewConnection() {
+    while (QLocalSocket* socket = m_server->nextPendingConnection()) {
+        m_connections.insert(socket, Connection());
+        connect(socket, &QLocalSocket::readyRead, this, [this, socket]() { onReadyRead(socket); });
+        connect(socket, &QLocalSocket::disconnected, this, [this, socket]() {
+            m_connections.remove(socket);
+            m_service->cancel(reinterpret_cast<quintptr>(socket));
+            socket->deleteLater();
+        });
+    }
+}
+
+void ControlServer::onReadyRead(QLocalSocket* socket) {
+    HW_TRACE_SCOPE("control", "onReadyRead");
+    const auto found = m_connections.find(socket);
+    if (found == m_connections.end()) {
+        return;
+    }
+    found->buffer.append(socket->readAll());
+    if (!found->waiting) {
+        processFrames(socket);
+    }
+}
+
+void ControlServer::onResponseReady(quintptr tag, const QByteArray& response) {
+    QLocalSocket* socket = reinterpret_cast<QLocalSocket*>(tag);
+    const auto found = m_connections.find(socket);
+    if (found == m_connections.end()) {
+        return;
+    }
+    found->waiting = false;
+    // 推迟期间到达的请求接着执行，响应与这条一起写出
+    processFrames(socket, response);
+}
+
+void ControlServer::processFrames(QLocalSocket* socket, QByteArray responses) {
+    const auto found = m_connections.find(socket);
+    if (found == m_connections.end()) {
+        return;
+    }
+    Connection& connection = found.value();
+
+    // 流水线：取出已到达的全部整帧依次执行，响应攒在一起一次写出
+    qsizetype offset = 0;
+    ControlProtocol::Frame frame;
+    ControlProtocol::ParseResult result;
+    while ((result = ControlProtocol::takeFrame(connection.buffer, offset, frame)) == ControlProtocol::ParseResult::Frame) {
+        if (!m_service->handle(frame, responses, reinterpret_cast<quintptr>(socket))) {
+            connection.waiting = true;
+            break;
+        }
+    }
+    connection.buffer.remove(0, offset);
+    if (!responses.isEmpty()) {
+        socket->write(responses);
+        socket->flush();
+    }
+    if (result == ControlProtocol::ParseResult::Invalid) {
+        HW_LOG_WARNING(s_controlLog, "Dropping control connection after malformed frame");
+        dropConnection(socket);
+    }
+}
+
+void ControlServer::dropConnection(QLocalSocket* socket) {
+    m_connections.remove(socket);
+    m_service->cancel(reinterpret_cast<quintptr>(socket));
+    socket->disconnect(this);
+    socket->disconnectFromServer();
+    socket->deleteLater();
+}
@@ -0,0 +1,60 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+#ifndef CONTROLSERVER_H
+#define CONTROLSERVER_H
+// 本地控制服务：在 QLocalServer 上接受连接，拆出请求帧交给 ControlService 执行。
+// 只有当前用户可以连接；一次读到的全部请求的响应合并为一次写出。
+// 请求被 ControlService 推迟（等待后台快照）时，该连接之后的请求留在缓冲区，响应到达后再继续执行
+#include <QByteArray>
+#include <QHash>
+#include <QObject>
+#include <QString>
+
+class ControlService;
+class QLocalServer;
+class QLocalSocket;
+
+class ControlServer : public QObject {
+    Q_OBJECT
+public:
+    // service 不归本对象所有，须比本对象活得久
+    explicit ControlServer(ControlService* service, QObject* parent = nullptr);
+    ~ControlServer() override;
+
+    // 开始监听。同名服务已在运行时返回 false；上次异常退出遗留的套接字文件会被清理
+    bool listen(const QString& name = defaultServerName());
+    void close();
+    bool isListening() const;
+
+    // 同名服务是否已有实例在应答。启动时先检查，已有实例时交给它处理，
+    // 不再创建会争用隐藏窗口日志的第二个核心
+    static bool isServing(const QString& name = defaultServerName());
+    // 按用户区分的默认服务名，同一用户的 hidewindow-cli 与图形界面据此相互发现
+    static QString defaultServerName();
+
+private:
+    struct Connection {
+        QByteArray buffer;     // 尚未执行的数据（含未凑成整帧的部分）
+        bool waiting = false;  // 有一条请求等待 ControlService 的延后响应
+    };
+    void onNewConnection();
+    void onReadyRead(QLocalSocket* socket);
+    void onResponseReady(quintptr tag, const QByteArray& response);
+    // 依次执行缓冲区中的整帧，直到数据不足或遇到被推迟的请求；responses 为已有的待写响应
+    void processFrames(QLocalSocket* socket, QByteArray responses = QByteArray());
+    void dropConnection(QLocalSocket* socket);
+
+    ControlService* m_service;
+    QLocalServer* m_server;
+    QHash<QLocalSocket*, Connection> m_connections;
+};
+#endif
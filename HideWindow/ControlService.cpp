@@ -0,0 +1,313 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "ControlService.h"
+#include "AhoCorasick.h"
+#include "HideProcess.h"
+#include "Metrics.h"
+#include "RuleEngine.h"
+#include "Trace.h"
+#include <QHash>
+#include <QThread>
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <vector>
+
+using namespace ControlProtocol;
+
+namespace {
+// 一次请求最多携带的 PID 数，防止畸形载荷让服务端分配过多内存
+constexpr quint64 kMaxPidsPerRequest = 65536;
+} // namespace
+
+// ===================== ControlService 类实现 =====================
+ControlService::ControlService(HideProcess* hide, std::unique_ptr<ProcessSource> source, QObject* parent)
+    : QObject(parent)
+    , m_hide(hide)
+    , m_source(source ? std::move(source) : createDefaultProcessSource())
+{
+}
+
+ControlService::~ControlService() {
+    if (m_worker) {
+        m_cancelSnapshot.store(true, std::memory_order_relaxed);
+        m_worker->disconnect(this);
+        m_worker->wait();
+        delete m_worker;
+    }
+}
+
+bool ControlService::needsSnapshot(quint8 code) {
+    const Opcode opcode = static_cast<Opcode>(code);
+    return opcode == Opcode::HideName || opcode == Opcode::ShowName || opcode == Opcode::ListProcesses;
+}
+
+bool ControlService::handle(const Frame& request, QByteArray& out, quintptr tag) {
+    if (!needsSnapshot(request.code) || !m_source) {
+        respond(request, out);
+        return true;
+    }
+    // 遍历全部进程需要数十到数百毫秒，不在界面线程进行；同时到达的请求共用一次快照
+    if (m_worker) {
+        m_queued.push_back({ request, tag });
+    }
+    else {
+        m_waiting.push_back({ request, tag });
+        startSnapshotWorker();
+    }
+    return false;
+}
+
+void ControlService::handleNow(const Frame& request, QByteArray& out) {
+    if (needsSnapshot(request.code)) {
+        m_snapshotValid = takeSnapshot();
+    }
+    respond(request, out);
+    m_snapshotValid = false;
+}
+
+void ControlService::cancel(quintptr tag) {
+    const auto sameTag = [tag](const Deferred& deferred) { return deferred.tag == tag; };
+    m_waiting.erase(std::remove_if(m_waiting.begin(), m_waiting.end(), sameTag), m_waiting.end());
+    m_queued.erase(std::remove_if(m_queued.begin(), m_queued.end(), sameTag), m_queued.end());
+}
+
+void ControlService::startSnapshotWorker() {
+    m_cancelSnapshot.store(false, std::memory_order_relaxed);
+    ProcessSource* source = m_source.get();
+    m_worker = QThread::create([this, source]() {
+        HW_TRACE_SCOPE("control", "snapshotWorker");
+        m_backBufferOk = source->snapshot(m_backBuffer, m_cancelSnapshot);
+    });
+    m_worker->setObjectName(QStringLiteral("ControlSnapshot"));
+    connect(m_worker, &QThread::finished, this, &ControlService::onSnapshotFinished);
+    m_worker->start(QThread::LowPriority);
+}
+
+void ControlService::onSnapshotFinished() {
+    m_worker->deleteLater();
+    m_snapshot.swap(m_backBuffer);
+    m_snapshotValid = m_backBufferOk;
+
+    // 接收方可能在 responseReady 中断开连接（cancel）或继续提交该连接后续的请求（handle）。
+    // 先取出本批；分发完之前 m_worker 不置空，新到的快照请求排入 m_queued
+    std::vector<Deferred> ready;
+    ready.swap(m_waiting);
+    for (const Deferred& deferred : ready) {
+        QByteArray response;
+        respond(deferred.request, response);
+        emit responseReady(deferred.tag, response);
+    }
+    m_snapshotValid = false;
+    m_worker = nullptr;
+
+    if (!m_queued.empty()) {
+        m_waiting.swap(m_queued);
+        startSnapshotWorker();
+    }
+}
+
+void ControlService::respond(const Frame& request, QByteArray& out) {
+    HW_TRACE_SCOPE("control", "handle");
+    PayloadReader in(request.payload);
+    QByteArray payload;
+    PayloadWriter writer(payload);
+    QString error;
+    Status status = execute(static_cast<Opcode>(request.code), in, writer, error);
+    // 多余的字节同样视为格式错误，便于日后扩展字段时发现新旧版本不匹配；
+    // 会修改状态的请求在执行前已自行检查
+    if (status == Status::Ok && (!in.ok() || !in.atEnd())) {
+        status = Status::BadRequest;
+        error = QStringLiteral("malformed payload");
+    }
+    if (status != Status::Ok) {
+        payload.clear();
+        writer.writeString(error);
+    }
+    appendFrame(out, static_cast<quint8>(status), request.id, payload);
+    if (status == Status::Ok && static_cast<Opcode>(request.code) == Opcode::Shutdown) {
+        emit shutdownRequested();
+    }
+}
+
+Status ControlService::execute(Opcode opcode, PayloadReader& in, PayloadWriter& out, QString& error) {
+    auto writeChanged = [&out](int changed) {
+        out.writeVarint(static_cast<quint64>(changed));
+    };
+    auto requireWindowSystem = [&]() {
+        if (!m_hide->hasWindowSystem()) {
+            error = QStringLiteral("no window system on this platform");
+            return false;
+        }
+        return true;
+    };
+
+    switch (opcode) {
+    case Opcode::Ping:
+        return Status::Ok;
+
+    case Opcode::HidePids:
+    case Opcode::ShowPids: {
+        QSet<qint64> pids;
+        if (!readPids(in, pids) || !in.atEnd()) {
+            error = QStringLiteral("malformed PID list");
+            return Status::BadRequest;
+        }
+        if (!requireWindowSystem()) {
+            return Status::Unavailable;
+        }
+        writeChanged(opcode == Opcode::HidePids ? m_hide->hidePids(pids) : m_hide->showPids(pids));
+        return Status::Ok;
+    }
+
+    case Opcode::HideName:
+    case Opcode::ShowName: {
+        QString pattern;
+        if (!in.readString(pattern) || pattern.isEmpty() || !in.atEnd()) {
+            error = QStringLiteral("missing name pattern");
+            return Status::BadRequest;
+        }
+        if (!requireWindowSystem()) {
+            return Status::Unavailable;
+        }
+        if (!m_snapshotValid) {
+            error = QStringLiteral("process snapshot failed");
+            return Status::Unavailable;
+        }
+        const QSet<qint64> pids = pidsMatching(pattern);
+        const int changed = opcode == Opcode::HideName ? m_hide->hidePids(pids) : m_hide->showPids(pids);
+        out.writeVarint(static_cast<quint64>(pids.size()));
+        writeChanged(changed);
+        return Status::Ok;
+    }
+
+    case Opcode::AddRule:
+    case Opcode::RemoveRule: {
+        QString rule;
+        if (!in.readString(rule) || rule.trimmed().isEmpty() || !in.atEnd()) {
+            error = QStringLiteral("missing rule");
+            return Status::BadRequest;
+        }
+        if (!requireWindowSystem()) {
+            return Status::Unavailable;
+        }
+        int changed = 0;
+        if (opcode == Opcode::AddRule) {
+            if (!m_hide->addHideRule(rule, &error, &changed)) {
+                return Status::BadRequest;
+            }
+        }
+        else if (!m_hide->removeHideRule(rule, &changed)) {
+            error = QStringLiteral("no such rule");
+            return Status::BadRequest;
+        }
+        writeChanged(changed);
+        return Status::Ok;
+    }
+
+    case Opcode::ListProcesses: {
+        QString pattern;
+        if (!in.readString(pattern)) {
+            error = QStringLiteral("missing name pattern");
+            return Status::BadRequest;
+        }
+        if (!m_snapshotValid) {
+            error = QStringLiteral("process snapshot failed");
+            return Status::Unavailable;
+        }
+        QHash<qint64, int> hiddenCounts;
+        m_hide->hiddenWindows().forEach([&hiddenCounts](const HiddenWindowRecord& record) {
+            ++hiddenCounts[record.pid];
+        });
+        std::vector<const ProcessEntry*> listed;
+        listed.reserve(m_snapshot.size());
+        for (const ProcessEntry& entry : std::as_const(m_snapshot)) {
+            if (pattern.isEmpty() || RuleEngine::globMatch(pattern, entry.name, AhoCorasick::CaseInsensitive)) {
+                listed.push_back(&entry);
+            }
+        }
+        out.writeVarint(listed.size());
+        for (const ProcessEntry* entry : listed) {
+            out.writeVarint(static_cast<quint64>(entry->pid));
+            out.writeVarint(static_cast<quint64>(qMax<qint64>(0, entry->parentPid)));
+            out.writeString(entry->name);
+            out.writeString(entry->exePath);
+            out.writeVarint(static_cast<quint64>(hiddenCounts.value(entry->pid)));
+        }
+        return Status::Ok;
+    }
+
+    case Opcode::QueryState: {
+        const HiddenWindowRegistry& hidden = m_hide->hiddenWindows();
+        QSet<qint64> pids;
+        hidden.forEach([&pids](const HiddenWindowRecord& record) { pids.insert(record.pid); });
+        out.writeVarint(static_cast<quint64>(hidden.count()));
+        out.writeVarint(static_cast<quint64>(m_hide->windowIndex()->size()));
+        out.writeVarint(static_cast<quint64>(pids.size()));
+        for (qint64 pid : std::as_const(pids)) {
+            out.writeVarint(static_cast<quint64>(pid));
+        }
+        const QStringList rules = m_hide->hideRules();
+        out.writeVarint(static_cast<quint64>(rules.size()));
+        for (const QString& rule : rules) {
+            out.writeString(rule);
+        }
+        return Status::Ok;
+    }
+
+    case Opcode::ShowAll:
+        writeChanged(m_hide->showAllHiddenWindows());
+        return Status::Ok;
+
+    case Opcode::Stats:
+        out.writeString(Metrics::registry().dump());
+        return Status::Ok;
+
+    case Opcode::Shutdown:
+        return Status::Ok;
+    }
+    error = QStringLiteral("unknown opcode");
+    return Status::UnknownOpcode;
+}
+
+bool ControlService::takeSnapshot() {
+    if (!m_source) {
+        return false;
+    }
+    const std::atomic<bool> cancelled{ false };
+    return m_source->snapshot(m_snapshot, cancelled);
+}
+
+QSet<qint64> ControlService::pidsMatching(const QString& pattern) const {
+    QSet<qint64> pids;
+    for (const ProcessEntry& entry : m_snapshot) {
+        if (RuleEngine::globMatch(pattern, entry.name, AhoCorasick::CaseInsensitive)) {
+            pids.insert(entry.pid);
+        }
+    }
+    return pids;
+}
+
+bool ControlService::readPids(PayloadReader& in, QSet<qint64>& pids) {
+    quint64 count = 0;
+    if (!in.readVarint(count) || count > kMaxPidsPerRequest) {
+        return false;
+    }
+    pids.reserve(static_cast<qsizetype>(count));
+    for (quint64 i = 0; i < count; ++i) {
+        quint64 pid = 0;
+        if (!in.readVarint(pid) || pid == 0 || pid > static_cast<quint64>(std::numeric_limits<qint64>::max())) {
+            return false;
+        }
+        pids.insert(static_cast<qint64>(pid));
+    }
+    return true;
+}
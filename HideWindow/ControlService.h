@@ -0,0 +1,85 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+#ifndef CONTROLSERVICE_H
+#define CONTROLSERVICE_H
+// 控制协议请求的执行：只依赖 HideProcess 与 ProcessSource，不涉及套接字，
+// 图形界面实例与无界面实例（hidewindow-cli serve）共用
+#include <QByteArray>
+#include <QList>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "ControlProtocol.h"
+#include "ProcessSource.h"
+
+class HideProcess;
+class QThread;
+
+class ControlService : public QObject {
+    Q_OBJECT
+public:
+    // hide 不归本对象所有，须比本对象活得久；source 为空时使用当前平台的默认实现
+    explicit ControlService(HideProcess* hide, std::unique_ptr<ProcessSource> source = nullptr,
+        QObject* parent = nullptr);
+    ~ControlService() override;
+
+    // 执行一条请求。必须在 HideProcess 所在线程调用。能立即完成时把响应帧追加到 out 并返回 true；
+    // 需要进程快照的请求（按名称隐藏 / 显示、列出进程）不在本线程遍历进程：快照在后台线程生成，
+    // 此时返回 false，完成后在本线程执行该请求并发出 responseReady(tag, 响应帧)。
+    // tag 由调用方选择（例如区分连接）；调用方在响应到达前应暂缓同一来源的后续请求，保证按序执行
+    bool handle(const ControlProtocol::Frame& request, QByteArray& out, quintptr tag);
+    // 在本线程同步执行（含快照），供没有事件循环的调用方使用；不与 handle 混用
+    void handleNow(const ControlProtocol::Frame& request, QByteArray& out);
+    // 丢弃 tag 尚未完成的请求，它们不会再发出 responseReady（例如连接已断开）
+    void cancel(quintptr tag);
+
+signals:
+    // 收到 Shutdown 请求。响应已追加到 out，接收方应在发送完毕后再退出
+    void shutdownRequested();
+    // handle 返回 false 的请求已执行完毕
+    void responseReady(quintptr tag, const QByteArray& response);
+
+private:
+    struct Deferred {
+        ControlProtocol::Frame request;
+        quintptr tag;
+    };
+    static bool needsSnapshot(quint8 code);
+    // 执行一条请求并追加响应帧；需要快照的请求使用当前的 m_snapshot
+    void respond(const ControlProtocol::Frame& request, QByteArray& out);
+    ControlProtocol::Status execute(ControlProtocol::Opcode opcode, ControlProtocol::PayloadReader& in,
+        ControlProtocol::PayloadWriter& out, QString& error);
+    // 在本线程刷新 m_snapshot（handleNow 使用）
+    bool takeSnapshot();
+    void startSnapshotWorker();
+    void onSnapshotFinished();
+    // 可执行文件名匹配 pattern 的 PID（来自 m_snapshot）
+    QSet<qint64> pidsMatching(const QString& pattern) const;
+    static bool readPids(ControlProtocol::PayloadReader& in, QSet<qint64>& pids);
+
+    HideProcess* m_hide;
+    std::unique_ptr<ProcessSource> m_source;
+    QList<ProcessEntry> m_snapshot; // 复用容量
+    bool m_snapshotValid = false;   // m_snapshot 是为当前执行的请求刚生成的
+
+    // 后台快照：工作线程只写 m_backBuffer 与 m_backBufferOk，finished 之后才在本线程读取
+    QThread* m_worker = nullptr;
+    std::atomic<bool> m_cancelSnapshot{ false };
+    QList<ProcessEntry> m_backBuffer;
+    bool m_backBufferOk = false;
+    std::vector<Deferred> m_waiting; // 由进行中的快照服务
+    std::vector<Deferred> m_queued;  // 快照开始之后到达，等下一次快照，不使用早于请求的数据
+};
+#endif
@@ -9,86 +9,189 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 #include "GlobalHook.h"
+#include "Metrics.h"
+#include "Trace.h"
 
-// ========== 关键修复：静态成员类外初始化（兼容所有C++版本） ==========
-GlobalHook* GlobalHook::s_instance = nullptr;
+// 钩子回调实现（由 HookMultiplexer 在钩子线程中同步调用）
+// 系统输入路径上的每个按键都要经过这里：只做查表、一次 DFA 转移和一次无锁入队，立即返回
+bool GlobalHook::handleHookEvent(const HookEvent& event) {
+    GlobalHookPrivate* d = this->d_ptr;
+    if (!d->isHookActive) {
+        return false;
+    }
 
-// 钩子回调函数实现
-LRESULT CALLBACK GlobalHook::lowLevelKeyboardProc(int nCode, WPARAM wParam, LPARAM lParam) {
-    // nCode >= 0 才处理，且实例必须有效
-    if (nCode >= 0 && GlobalHook::s_instance != nullptr) {
-        GlobalHookPrivate* d = GlobalHook::s_instance->d_ptr;
-        if (!d || !d->isHookActive || d->targetKey == Qt::Key_unknown) {
-            return CallNextHookEx(d->hookHandle, nCode, wParam, lParam);
-        }
+    const bool keyDown = !(event.flags & HookEvent::KeyUp);
+    const KeyStateTracker::Transition transition = d->keyState.update(event.vk, keyDown);
+    if (transition == KeyStateTracker::Transition::Repeat && d->keyState.suppressRepeats()) {
+        // 自动重复不进入匹配器，既不会重复触发也不会打断组合键；被拦截按键的重复同样拦截
+        return d->matcher.swallowsKey(event.vk);
+    }
 
-        // 只处理按键按下事件
-        if (wParam == WM_KEYDOWN || wParam == WM_SYSKEYDOWN) {
-            KBDLLHOOKSTRUCT* pKeyStruct = reinterpret_cast<KBDLLHOOKSTRUCT*>(lParam);
-            // Win32虚拟键码转Qt::Key
-			Qt::Key qtKey = getQtKeyFromVK(pKeyStruct->vkCode);
-
-            // 检测到目标按键，发射信号
-            if (qtKey == d->targetKey) {
-                emit GlobalHook::s_instance->targetKeyPressed(qtKey);
-                // 如需拦截按键，取消下面注释（慎用，会阻止系统接收该按键）
-                // return 1;
-            }
+    // 抬起事件也要送入匹配器，用于跟踪修饰键状态
+    const HotkeyMatch match = d->matcher.feed(event.vk, keyDown, event.timestamp);
+    // payload 即 HookEvent::binding：绑定 id，或 -1 表示单键监控
+    qint32 payload = -1;
+    bool matched = false;
+    if (match.bindingId >= 0) {
+        payload = match.bindingId;
+        matched = true;
+    }
+    // 单键监控：Win32虚拟键码转Qt::Key
+    else if (keyDown && d->targetKey != Qt::Key_unknown
+        && KeyMap::qtKeyFromVk(event.vk) == d->targetKey) {
+        matched = true;
+    }
+
+    // 按下立即触发，或抬起时触发之前记录的匹配；交给分发线程发射信号
+    if ((matched && d->keyState.trigger(event.vk, payload, event.timestamp))
+        || (!keyDown && d->keyState.release(event.vk, event.timestamp, payload))) {
+        HW_TRACE_INSTANT("hook", "hotkeyTriggered");
+        HookEvent triggered = event;
+        triggered.binding = payload;
+        Metrics::Registry& metrics = Metrics::registry();
+        metrics.eventsMatched.add();
+        metrics.lastHotkeyTimestamp.store(event.timestamp, std::memory_order_relaxed);
+        if (!d->dispatcher.post(triggered)) {
+            metrics.eventsDropped.add();
         }
     }
 
-    // 必须传递给下一个钩子，否则系统可能异常
-    return CallNextHookEx(nullptr, nCode, wParam, lParam);
+    // 绑定要求拦截：不再传递给系统
+    return match.swallow;
 }
 
 // 构造函数
 GlobalHook::GlobalHook(QObject* parent)
     : QObject(parent)  // 显式初始化QObject基类
     , d_ptr(new GlobalHookPrivate) {
-    // 赋值静态实例指针
-    GlobalHook::s_instance = this;
+    // 钩子可能漏掉修饰键的抬起，匹配时以系统的实际按键状态校正
+    d_ptr->matcher.setKeyStateProbe([](std::uint32_t vk) {
+        return (GetAsyncKeyState(static_cast<int>(vk)) & 0x8000) != 0;
+    });
+    // 分发线程中直接转发为 targetKeyPressed，接收者按各自线程排队处理
+    connect(&d_ptr->dispatcher, &HookEventDispatcher::eventReceived, this, [this](const HookEvent& event) {
+        if (event.binding >= 0) {
+            emit hotkeyTriggered(event.binding);
+        }
+        else {
+            emit targetKeyPressed(KeyMap::qtKeyFromVk(event.vk));
+        }
+    }, Qt::DirectConnection);
+    d_ptr->dispatcher.start();
 }
 
 // 析构函数
 GlobalHook::~GlobalHook() {
     // 析构时自动停止钩子，释放资源
     stopGlobalHook();
+    d_ptr->dispatcher.stop();
     delete d_ptr;
-    GlobalHook::s_instance = nullptr;
 }
 
-// 设置全局钩子（监控指定按键）
-void GlobalHook::setGlobalHook(Qt::Key key) {
+HookEventDispatcher* GlobalHook::dispatcher() const {
+    return &d_ptr->dispatcher;
+}
+
+int GlobalHook::addHotkey(const QKeySequence& sequence, bool swallow) {
     GlobalHookPrivate* d = this->d_ptr;
-    QMutexLocker locker(&d->mutex); // 线程安全锁
+    QMutexLocker locker(&d->mutex);
+
+    const int id = d->matcher.addBinding(sequence, swallow);
+    if (id < 0) {
+        return -1;
+    }
+    d->matcher.compile();
+    if (!d->isHookActive && !installHook()) {
+        d->matcher.removeBinding(id);
+        d->matcher.compile();
+        return -1;
+    }
+    qInfo() << "已添加热键" << sequence.toString() << "id:" << id;
+    return id;
+}
+
+void GlobalHook::removeHotkey(int id) {
+    GlobalHookPrivate* d = this->d_ptr;
+    QMutexLocker locker(&d->mutex);
+
+    if (d->matcher.removeBinding(id)) {
+        d->matcher.compile();
+    }
+}
+
+void GlobalHook::setChordTimeout(int milliseconds) {
+    GlobalHookPrivate* d = this->d_ptr;
+    QMutexLocker locker(&d->mutex);
+    d->matcher.setChordTimeout(static_cast<quint64>(qMax(0, milliseconds)) * 1000 * 1000);
+}
+
+void GlobalHook::setSuppressRepeats(bool suppress) {
+    d_ptr->keyState.setSuppressRepeats(suppress);
+}
 
-    // 先停止已有激活的钩子
+void GlobalHook::setDebounceInterval(int milliseconds) {
+    d_ptr->keyState.setDebounceInterval(static_cast<quint64>(qMax(0, milliseconds)) * 1000 * 1000);
+}
+
+void GlobalHook::setFireOnRelease(bool onRelease) {
+    d_ptr->keyState.setFireOnRelease(onRelease);
+}
+
+const KeyStateTracker& GlobalHook::keyState() const {
+    return d_ptr->keyState;
+}
+
+bool GlobalHook::installHook() {
+    GlobalHookPrivate* d = this->d_ptr;
     if (d->isHookActive) {
-        stopGlobalHook();
+        return true;
     }
 
-    // 设置目标按键
-    d->targetKey = key;
+    // 之前的修饰键 / 组合键 / 按键状态已不可信
+    d->matcher.reset();
+    d->keyState.reset();
+    d->isHookActive = true;
 
-    // 安装低级键盘全局钩子
-    d->hookHandle = SetWindowsHookExW(
-        WH_KEYBOARD_LL,                // 钩子类型：低级键盘钩子
-        lowLevelKeyboardProc,          // 回调函数
-        GetModuleHandleW(nullptr),     // 当前模块句柄（LL钩子无需DLL）
-        0                              // 0 = 全局监控所有线程
-    );
+    // 多个 GlobalHook 共享同一个系统钩子，各自只订阅自己的回调
+    HookMultiplexer::Subscription subscription;
+    subscription.delivery = HookMultiplexer::Delivery::Direct;
+    subscription.handler = [this](const HookEvent& event) { return handleHookEvent(event); };
+    int errorCode = 0;
+    d->subscription = HookMultiplexer::instance().subscribe(subscription, &errorCode);
 
     // 检查钩子安装是否成功
-    if (d->hookHandle == nullptr) {
-        int errorCode = GetLastError();
-        // 修复：避免重载解析错误，拆分输出内容
-        qCritical() << "全局钩子安装失败，错误码：" << errorCode;
+    if (d->subscription < 0) {
         emit hookInstallFailed(errorCode);
         d->isHookActive = false;
+        return false;
+    }
+    return true;
+}
+
+void GlobalHook::uninstallHook() {
+    GlobalHookPrivate* d = this->d_ptr;
+    if (d->subscription >= 0) {
+        // 退订返回后回调不会再执行
+        HookMultiplexer::instance().unsubscribe(d->subscription);
+        d->subscription = -1;
+    }
+    d->isHookActive = false;
+}
+
+// 设置全局钩子（监控指定按键）
+void GlobalHook::setGlobalHook(Qt::Key key) {
+    GlobalHookPrivate* d = this->d_ptr;
+    QMutexLocker locker(&d->mutex); // 线程安全锁
+
+    // 先停止已有激活的钩子（不能调用 stopGlobalHook，mutex 不可重入）
+    uninstallHook();
+
+    // 设置目标按键
+    d->targetKey = key;
+    if (!installHook()) {
         return;
     }
 
-    d->isHookActive = true;
     // 修复：拆分QKeySequence输出，避免重载冲突
     QString keyText = QKeySequence(key).toString();
     qInfo() << "全局钩子已启动，监控按键：" << keyText;
@@ -99,11 +202,8 @@ void GlobalHook::stopGlobalHook() {
     GlobalHookPrivate* d = this->d_ptr;
     QMutexLocker locker(&d->mutex);
 
-    if (d->isHookActive && d->hookHandle != nullptr) {
-        // 卸载钩子
-        UnhookWindowsHookEx(d->hookHandle);
-        d->hookHandle = nullptr;
-        d->isHookActive = false;
+    if (d->isHookActive) {
+        uninstallHook();
         d->targetKey = Qt::Key_unknown;
         qInfo() << "全局钩子已停止";
     }
@@ -111,14 +211,6 @@ void GlobalHook::stopGlobalHook() {
 
 Qt::Key getQtKeyFromVK(DWORD vkCode)
 {
-    // 先查功能键映射
-    if (vkToQtKey.contains(vkCode)) {
-        return vkToQtKey[vkCode];
-    }
-    // 再查字母/数字键映射
-    if (charVkToQtKey.contains(vkCode)) {
-        return charVkToQtKey[vkCode];
-    }
-    // 未找到则返回unknown
-    return Qt::Key_unknown;
+    // 单次数组访问，未映射的键返回unknown
+    return KeyMap::qtKeyFromVk(vkCode);
 }
\ No newline at end of file
@@ -0,0 +1,253 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "HiddenWindowRegistry.h"
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QLockFile>
+#include <QStandardPaths>
+#include <cstring>
+
+namespace {
+const char kJournalMagic[8] = { 'H', 'W', 'J', 'R', 'N', 'L', '\0', '\0' };
+constexpr quint32 kJournalVersion = 1;
+constexpr quint32 kInitialCapacity = 64;
+
+qint64 journalBytes(quint32 capacity) {
+    return 24 + static_cast<qint64>(capacity) * static_cast<qint64>(sizeof(HiddenWindowRecord));
+}
+} // namespace
+
+// ===================== HiddenWindowRegistry 类实现 =====================
+HiddenWindowRegistry::HiddenWindowRegistry() {
+    mapFile(kInitialCapacity);
+    initHeader(kInitialCapacity);
+}
+
+HiddenWindowRegistry::~HiddenWindowRegistry() {
+    close();
+}
+
+QString HiddenWindowRegistry::defaultJournalPath() {
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)
+        + QStringLiteral("/hidden-windows.journal");
+}
+
+bool HiddenWindowRegistry::open(const QString& path) {
+    close();
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    // 持锁进程退出后锁文件即视为过期；锁可能持有很久，不按存在时长判断过期
+    auto lock = std::make_unique<QLockFile>(path + QStringLiteral(".lock"));
+    lock->setStaleLockTime(0);
+    if (!lock->tryLock(0)) {
+        qint64 owner = 0;
+        lock->getLockInfo(&owner, nullptr, nullptr);
+        qWarning() << "Hidden window journal" << path << "is in use by process" << owner
+                   << ", keeping records in memory only";
+        mapFile(kInitialCapacity);
+        initHeader(kInitialCapacity);
+        return false;
+    }
+    m_lock = std::move(lock);
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadWrite)) {
+        qWarning() << "Cannot open hidden window journal" << path << ":" << m_file.errorString();
+        m_lock.reset();
+        mapFile(kInitialCapacity);
+        initHeader(kInitialCapacity);
+        return false;
+    }
+
+    // 校验上次遗留的日志；格式不符时视为空日志重新初始化
+    const qint64 size = m_file.size();
+    if (size >= journalBytes(0)) {
+        m_data = m_file.map(0, size);
+        const JournalHeader* existing = header();
+        const bool valid = m_data
+            && std::memcmp(existing->magic, kJournalMagic, sizeof(kJournalMagic)) == 0
+            && existing->version == kJournalVersion
+            && journalBytes(existing->capacity) <= size
+            && existing->count <= existing->capacity;
+        if (valid) {
+            rebuildSlots();
+            if (!m_slots.isEmpty()) {
+                qInfo() << "Recovered" << m_slots.size() << "hidden windows from journal";
+            }
+            return true;
+        }
+        qWarning() << "Hidden window journal is corrupt, starting empty";
+        if (m_data) {
+            m_file.unmap(m_data);
+            m_data = nullptr;
+        }
+    }
+
+    if (!mapFile(kInitialCapacity)) {
+        qWarning() << "Cannot map hidden window journal" << path << ":" << m_file.errorString();
+        m_file.close();
+        m_lock.reset();
+        mapFile(kInitialCapacity);
+        initHeader(kInitialCapacity);
+        return false;
+    }
+    initHeader(kInitialCapacity);
+    return true;
+}
+
+void HiddenWindowRegistry::close() {
+    if (m_file.isOpen()) {
+        if (m_data) {
+            m_file.unmap(m_data);
+        }
+        m_file.close();
+    }
+    m_lock.reset();
+    m_data = nullptr;
+    m_memory.clear();
+    m_slots.clear();
+}
+
+HiddenWindowRegistry::JournalHeader* HiddenWindowRegistry::header() const {
+    return reinterpret_cast<JournalHeader*>(m_data);
+}
+
+HiddenWindowRecord* HiddenWindowRegistry::records() const {
+    return reinterpret_cast<HiddenWindowRecord*>(m_data + sizeof(JournalHeader));
+}
+
+quint32 HiddenWindowRegistry::recordCount() const {
+    return m_data ? header()->count : 0;
+}
+
+int HiddenWindowRegistry::count() const {
+    return static_cast<int>(recordCount());
+}
+
+void HiddenWindowRegistry::initHeader(quint32 capacity) {
+    if (!m_data) {
+        return;
+    }
+    JournalHeader* h = header();
+    std::memcpy(h->magic, kJournalMagic, sizeof(kJournalMagic));
+    h->version = kJournalVersion;
+    h->capacity = capacity;
+    h->count = 0;
+    h->reserved = 0;
+    m_slots.clear();
+}
+
+bool HiddenWindowRegistry::mapFile(quint32 capacity) {
+    const qint64 bytes = journalBytes(capacity);
+    if (!m_file.isOpen()) {
+        // 内存后备存储，resize 保留已有内容
+        m_memory.resize(bytes);
+        m_data = reinterpret_cast<uchar*>(m_memory.data());
+        return true;
+    }
+
+    if (m_data) {
+        m_file.unmap(m_data);
+        m_data = nullptr;
+    }
+    if (!m_file.resize(bytes)) {
+        return false;
+    }
+    m_data = m_file.map(0, bytes);
+    return m_data != nullptr;
+}
+
+bool HiddenWindowRegistry::ensureCapacity(quint32 needed) {
+    const quint32 capacity = header()->capacity;
+    if (needed <= capacity) {
+        return true;
+    }
+    const quint32 newCapacity = qMax(needed, capacity * 2);
+    if (!mapFile(newCapacity)) {
+        qWarning() << "Cannot grow hidden window journal:" << m_file.errorString();
+        // 回到原大小继续使用已有记录
+        mapFile(capacity);
+        return false;
+    }
+    header()->capacity = newCapacity;
+    return true;
+}
+
+void HiddenWindowRegistry::rebuildSlots() {
+    m_slots.clear();
+    m_slots.reserve(recordCount());
+    for (quint32 i = 0; i < recordCount();) {
+        const WindowId id = static_cast<WindowId>(records()[i].windowId);
+        if (m_slots.contains(id)) {
+            // removeSlot 中途崩溃留下的重复记录：丢弃后出现的一条，否则它不在 m_slots 中，永远无法删除
+            const quint32 last = recordCount() - 1;
+            records()[i] = records()[last];
+            header()->count = last;
+            continue;
+        }
+        m_slots.insert(id, i);
+        ++i;
+    }
+}
+
+const HiddenWindowRecord* HiddenWindowRegistry::find(WindowId id) const {
+    auto it = m_slots.constFind(id);
+    return it != m_slots.constEnd() ? &records()[it.value()] : nullptr;
+}
+
+bool HiddenWindowRegistry::add(const HiddenWindowRecord& record) {
+    if (!m_data) {
+        return false;
+    }
+    const WindowId id = static_cast<WindowId>(record.windowId);
+    auto it = m_slots.constFind(id);
+    if (it != m_slots.constEnd()) {
+        records()[it.value()] = record;
+        return true;
+    }
+
+    const quint32 slot = recordCount();
+    if (!ensureCapacity(slot + 1)) {
+        return false;
+    }
+    // 先写完整记录，再发布新的 count
+    records()[slot] = record;
+    header()->count = slot + 1;
+    m_slots.insert(id, slot);
+    return true;
+}
+
+bool HiddenWindowRegistry::remove(WindowId id) {
+    auto it = m_slots.constFind(id);
+    if (it == m_slots.constEnd()) {
+        return false;
+    }
+    removeSlot(it.value());
+    return true;
+}
+
+void HiddenWindowRegistry::removeSlot(quint32 slot) {
+    const quint32 last = recordCount() - 1;
+    m_slots.remove(static_cast<WindowId>(records()[slot].windowId));
+    if (slot != last) {
+        // 用末尾记录填补空位；在此处崩溃只会留下一条重复记录，还原时无害
+        records()[slot] = records()[last];
+        m_slots.insert(static_cast<WindowId>(records()[slot].windowId), slot);
+    }
+    header()->count = last;
+}
+
+void HiddenWindowRegistry::clear() {
+    if (m_data) {
+        header()->count = 0;
+    }
+    m_slots.clear();
+}
@@ -0,0 +1,95 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+#ifndef HIDDENWINDOWREGISTRY_H
+#define HIDDENWINDOWREGISTRY_H
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QString>
+#include <memory>
+#include "WindowSystem.h"
+
+class QLockFile;
+
+// 日志中的一条记录：被本程序隐藏的窗口及其隐藏前的状态
+struct HiddenWindowRecord {
+    quint64 windowId = 0;
+    qint64 pid = 0;
+    WindowPlacement placement;
+};
+static_assert(sizeof(HiddenWindowRecord) == 40, "journal record layout must stay stable");
+
+// 已隐藏窗口登记表，以内存映射的日志文件为后备存储
+//
+// 文件布局：JournalHeader 之后紧跟 capacity 条 HiddenWindowRecord。
+// 写入顺序为"先写记录、再改 count"，进程在任意时刻被杀死后，
+// 下次启动读到的前 count 条记录都是完整的。
+// 日志文件由旁边的 .lock 文件独占：同一时刻只有一个实例读写并还原其中的记录
+class HiddenWindowRegistry {
+public:
+    HiddenWindowRegistry();
+    ~HiddenWindowRegistry();
+    HiddenWindowRegistry(const HiddenWindowRegistry&) = delete;
+    HiddenWindowRegistry& operator=(const HiddenWindowRegistry&) = delete;
+
+    // 打开（或创建）日志文件并载入上次遗留的记录；失败时退回纯内存存储并返回 false。
+    // 日志已被另一个存活的实例锁定时不读取其中的记录（那些窗口由该实例负责还原）
+    bool open(const QString& path);
+    void close();
+    bool isPersistent() const { return m_file.isOpen(); }
+
+    // 登记一个窗口，同一窗口重复登记时覆盖旧记录
+    bool add(const HiddenWindowRecord& record);
+    bool remove(WindowId id);
+    bool contains(WindowId id) const { return m_slots.contains(id); }
+    const HiddenWindowRecord* find(WindowId id) const;
+    int count() const;
+    void clear();
+
+    // 遍历所有记录（不修改登记表）
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        const HiddenWindowRecord* all = records();
+        for (quint32 i = 0; i < recordCount(); ++i) {
+            fn(all[i]);
+        }
+    }
+
+    // 默认日志文件路径（应用本地数据目录）
+    static QString defaultJournalPath();
+
+private:
+    struct JournalHeader {
+        char magic[8];
+        quint32 version;
+        quint32 capacity;
+        quint32 count;
+        quint32 reserved;
+    };
+    static_assert(sizeof(JournalHeader) == 24, "journal header layout must stay stable");
+
+    JournalHeader* header() const;
+    HiddenWindowRecord* records() const;
+    quint32 recordCount() const;
+    bool ensureCapacity(quint32 needed);
+    bool mapFile(quint32 capacity);
+    void initHeader(quint32 capacity);
+    void removeSlot(quint32 slot);
+    void rebuildSlots();
+
+    QFile m_file;
+    std::unique_ptr<QLockFile> m_lock; // 持有期间 m_file 为本实例独占
+    QByteArray m_memory;      // 无法使用文件时的内存后备存储
+    uchar* m_data = nullptr;  // 指向映射区或 m_memory
+    QHash<WindowId, quint32> m_slots;
+};
+#endif
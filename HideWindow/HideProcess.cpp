@@ -0,0 +1,486 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "HideProcess.h"
+#include "AsyncLog.h"
+#include "Metrics.h"
+#include "ProcessHandleCache.h"
+#include "Trace.h"
+#include <QDebug>
+#include <QHash>
+#include <QThread>
+
+namespace {
+AsyncLog::Category s_hideLog("hide", 20);
+
+// 热键按下后多久内完成的隐藏计入端到端延迟
+constexpr quint64 kHotkeyAttributionWindowNs = 5ull * 1000 * 1000 * 1000;
+
+// 显示状态与正常位置相同即视为已还原（flags 由系统维护，不参与比较）
+bool samePlacement(const WindowPlacement& a, const WindowPlacement& b) {
+    return a.showCmd == b.showCmd && a.left == b.left && a.top == b.top && a.right == b.right && a.bottom == b.bottom;
+}
+} // namespace
+
+// ===================== HideProcess 类实现 =====================
+HideProcess::HideProcess(QObject* parent)
+    : HideProcess(IndexBuild::Synchronous, parent)
+{
+}
+
+HideProcess::HideProcess(IndexBuild indexBuild, QObject* parent)
+    : HideProcess(createDefaultWindowSystem(), HiddenWindowRegistry::defaultJournalPath(), indexBuild, parent)
+{
+}
+
+HideProcess::HideProcess(std::unique_ptr<WindowSystem> windowSystem, const QString& journalPath,
+    IndexBuild indexBuild, QObject* parent)
+    : QObject(parent)
+    , m_windowSystem(std::move(windowSystem))
+    , m_windowIndex(std::make_unique<WindowIndex>(m_windowSystem.get()))
+{
+    // 一次遍历建立索引，之后由窗口事件维护
+    if (indexBuild == IndexBuild::Background && m_windowSystem) {
+        startWindowIndexBuild();
+    }
+    else {
+        m_windowIndex->rebuild();
+    }
+    m_windowIndex->setObserver(this);
+
+    // 缓存只在 acquire 时淘汰空闲句柄；规则匹配之后可能很久不再 acquire，按空闲时限定期清理
+    ProcessHandleCache& handles = ProcessHandleCache::instance();
+    m_handleEvictTimer.setInterval(qMax(1000, handles.idleMs()));
+    connect(&m_handleEvictTimer, &QTimer::timeout, this, [&handles]() { handles.evictIdle(); });
+    m_handleEvictTimer.start();
+
+    // 日志中遗留的记录说明上次未正常退出，直接按记录还原，无需遍历桌面
+    if (!journalPath.isEmpty()) {
+        m_hiddenWindows.open(journalPath);
+    }
+    if (m_hiddenWindows.count() > 0) {
+        showAllHiddenWindows();
+    }
+}
+
+HideProcess::~HideProcess() {
+    finishWindowIndexBuild();
+    m_windowIndex->setObserver(nullptr);
+    showAllHiddenWindows();
+    // 索引引用窗口系统，必须先于它销毁
+    m_windowIndex.reset();
+}
+
+const WindowIndex* HideProcess::windowIndex() const {
+    return m_windowIndex.get();
+}
+
+const HiddenWindowRegistry& HideProcess::hiddenWindows() const {
+    return m_hiddenWindows;
+}
+
+template <typename Pred>
+int HideProcess::restoreHiddenWindows(Pred pred) {
+    HW_TRACE_SCOPE("hide", "restoreHiddenWindows");
+    Metrics::ScopedTimer timer(Metrics::registry().showDuration);
+    if (!m_windowSystem) {
+        return 0;
+    }
+    // 复杂度只与已隐藏窗口数量有关，不遍历桌面。先只读出记录：还原成功后才从登记表删除，
+    // 失败的窗口（无响应、权限不足等）保留记录，之后的还原或下次启动时重试
+    std::vector<HiddenWindowRecord> records;
+    m_hiddenWindows.forEach([&](const HiddenWindowRecord& record) {
+        if (pred(record)) {
+            records.push_back(record);
+        }
+    });
+    if (records.empty()) {
+        return 0;
+    }
+
+    std::vector<WindowId> ids;
+    ids.reserve(records.size());
+    std::vector<HiddenWindowRecord> restoring;
+    restoring.reserve(records.size());
+    for (const HiddenWindowRecord& record : records) {
+        const WindowId id = static_cast<WindowId>(record.windowId);
+        // 窗口已销毁或句柄已被其他进程复用：没有可还原的对象，记录作废
+        WindowInfo info;
+        if (!m_windowSystem->queryWindow(id, info) || info.pid != record.pid) {
+            m_hiddenWindows.remove(id);
+            continue;
+        }
+        ids.push_back(id);
+        restoring.push_back(record);
+        // 先更新缓存并豁免规则，显示引起的窗口事件不会再触发自动隐藏
+        m_windowIndex->setCachedVisible(id, true);
+        m_ruleExempt.insert(id);
+    }
+    // 可见性一批提交；隐藏时未改变最小化 / 最大化状态，显示后即恢复原样
+    m_windowSystem->setWindowsVisible(ids, true);
+
+    int restored = 0;
+    for (const HiddenWindowRecord& record : restoring) {
+        const WindowId id = static_cast<WindowId>(record.windowId);
+        // 隐藏期间显示状态或位置被改动过（例如上次异常退出后）时按记录精确还原
+        WindowPlacement current;
+        if (m_windowSystem->windowPlacement(id, current) && !samePlacement(current, record.placement)) {
+            m_windowSystem->restoreWindowPlacement(id, record.placement);
+        }
+        WindowInfo info;
+        if (!m_windowSystem->queryWindow(id, info) || !info.visible) {
+            HW_LOG_WARNING(s_hideLog, "Failed to restore window of PID %1, keeping its record", record.pid);
+            m_windowIndex->setCachedVisible(id, false);
+            m_ruleExempt.remove(id);
+            continue;
+        }
+        m_hiddenWindows.remove(id);
+        ++restored;
+    }
+    return restored;
+}
+
+void HideProcess::rebuildWindowIndex() {
+    finishWindowIndexBuild();
+    m_windowIndex->rebuild();
+    pruneRuleExempt();
+}
+
+void HideProcess::pruneRuleExempt() {
+    for (auto it = m_ruleExempt.begin(); it != m_ruleExempt.end();) {
+        it = m_windowIndex->find(*it) ? std::next(it) : m_ruleExempt.erase(it);
+    }
+}
+
+void HideProcess::startWindowIndexBuild() {
+    if (m_indexWorker) {
+        return;
+    }
+    m_windowIndex->beginRebuild();
+    m_indexScratch.clear();
+    WindowSystem* system = m_windowSystem.get();
+    std::vector<WindowInfo>* windows = &m_indexScratch;
+    QThread* worker = QThread::create([system, windows]() {
+        HW_TRACE_SCOPE("hide", "backgroundIndexBuild");
+        system->enumerateTopLevelWindows(*windows);
+    });
+    m_indexWorker = worker;
+    // 队列连接回到本线程合并；若之前已被 finishWindowIndexBuild 同步收尾则忽略
+    connect(worker, &QThread::finished, this, [this, worker]() {
+        if (m_indexWorker == worker) {
+            finishWindowIndexBuild();
+        }
+    });
+    worker->start();
+}
+
+void HideProcess::finishWindowIndexBuild() {
+    if (!m_indexWorker) {
+        return;
+    }
+    HW_TRACE_SCOPE("hide", "finishWindowIndexBuild");
+    // 遍历读取本进程窗口的标题时限时等待本线程，这里阻塞不会死锁
+    m_indexWorker->wait();
+    delete m_indexWorker;
+    m_indexWorker = nullptr;
+    m_windowIndex->finishRebuild(m_indexScratch);
+    pruneRuleExempt();
+    HW_LOG_DEBUG(s_hideLog, "Window index built in background: %1 windows", m_windowIndex->size());
+    emit windowIndexReady();
+}
+
+void HideProcess::hideProcess(qint64 pid) {
+    if (pid <= 0) {
+        qWarning() << "Invalid PID:" << pid;
+        return;
+    }
+    HW_LOG_DEBUG(s_hideLog, "Trying to hide process (PID: %1)", pid);
+    hideWindowsOf({ pid });
+}
+
+void HideProcess::showProcess(qint64 pid) {
+    if (pid <= 0) {
+        qWarning() << "Invalid PID:" << pid;
+        return;
+    }
+    HW_LOG_DEBUG(s_hideLog, "Trying to show process (PID: %1)", pid);
+    restoreHiddenWindows([pid](const HiddenWindowRecord& record) { return record.pid == pid; });
+}
+
+void HideProcess::hideProcesses(const QVariantList& pids) {
+    hidePids(toPidSet(pids));
+}
+
+void HideProcess::showProcesses(const QVariantList& pids) {
+    showPids(toPidSet(pids));
+}
+
+int HideProcess::hidePids(const QSet<qint64>& pids) {
+    return hideWindowsOf(pids);
+}
+
+int HideProcess::showPids(const QSet<qint64>& pids) {
+    if (pids.isEmpty()) {
+        return 0;
+    }
+    return restoreHiddenWindows([&pids](const HiddenWindowRecord& record) { return pids.contains(record.pid); });
+}
+
+int HideProcess::showAllHiddenWindows() {
+    return restoreHiddenWindows([](const HiddenWindowRecord&) { return true; });
+}
+
+QSet<qint64> HideProcess::toPidSet(const QVariantList& pids) {
+    QSet<qint64> set;
+    set.reserve(pids.size());
+    for (const QVariant& value : pids) {
+        bool ok = false;
+        const qint64 pid = value.toLongLong(&ok);
+        if (ok && pid > 0) {
+            set.insert(pid);
+        }
+        else {
+            qWarning() << "Invalid PID:" << value;
+        }
+    }
+    return set;
+}
+
+int HideProcess::hideWindowsOf(const QSet<qint64>& pids) {
+    if (pids.isEmpty()) {
+        return 0;
+    }
+    if (!m_windowSystem) {
+        qWarning() << "No window system available on this platform";
+        return 0;
+    }
+    HW_TRACE_SCOPE("hide", "hideWindowsOf");
+    finishWindowIndexBuild();
+    Metrics::Registry& metrics = Metrics::registry();
+    Metrics::ScopedTimer timer(metrics.hideDuration);
+
+    // 先收集再修改，避免修改可见性时触发的窗口事件改动正在遍历的索引。
+    // 待隐藏列表是局部变量：提交时的窗口事件可能重入 windowUpdated 再次收集
+    std::vector<WindowId> pending;
+    if (pids.size() == 1) {
+        m_windowIndex->forEachWindowOf(*pids.cbegin(), [&](const WindowInfo& window) { stageHide(window, pending); });
+    }
+    else {
+        // 多个进程时对索引只遍历一次，用哈希集合判断归属
+        m_windowIndex->forEachWindow([&](const WindowInfo& window) {
+            if (pids.contains(window.pid)) {
+                stageHide(window, pending);
+            }
+        });
+    }
+    if (pending.empty()) {
+        HW_LOG_WARNING(s_hideLog, "No window to hide for %1 PIDs (first: %2)", pids.size(), *pids.cbegin());
+        return 0;
+    }
+    const int hidden = commitPendingHide(pending);
+
+    // 热键按下后不久完成的隐藏视为由该热键触发，记录端到端延迟
+    const quint64 hotkey = metrics.lastHotkeyTimestamp.exchange(0, std::memory_order_relaxed);
+    const quint64 finished = Metrics::now();
+    if (hotkey != 0 && finished - hotkey < kHotkeyAttributionWindowNs) {
+        metrics.hotkeyToHidden.record(finished - hotkey);
+    }
+    return hidden;
+}
+
+void HideProcess::stageHide(const WindowInfo& window, std::vector<WindowId>& pending) {
+    if (!window.visible) {
+        return;
+    }
+    HiddenWindowRecord record;
+    record.windowId = window.id;
+    record.pid = window.pid;
+    if (m_windowSystem->windowPlacement(window.id, record.placement) && m_hiddenWindows.add(record)) {
+        pending.push_back(window.id);
+    }
+}
+
+int HideProcess::commitPendingHide(const std::vector<WindowId>& pending) {
+    m_windowSystem->setWindowsVisible(pending, false);
+    int hidden = 0;
+    for (WindowId id : pending) {
+        // 窗口已销毁，或因无响应、权限不足仍然可见：撤销登记，不算作已隐藏
+        WindowInfo info;
+        const bool exists = m_windowSystem->queryWindow(id, info);
+        if (!exists || info.visible) {
+            if (exists) {
+                HW_LOG_WARNING(s_hideLog, "Failed to hide window of PID %1", info.pid);
+            }
+            m_hiddenWindows.remove(id);
+            continue;
+        }
+        m_windowIndex->setCachedVisible(id, false);
+        ++hidden;
+    }
+    return hidden;
+}
+
+QStringList HideProcess::hideRules() const {
+    return m_rules.ruleTexts();
+}
+
+bool HideProcess::setHideRules(const QStringList& rules) {
+    bool ok = true;
+    m_rules.clear();
+    for (const QString& text : rules) {
+        const QString trimmed = text.trimmed();
+        // 空行与 # 注释行
+        if (trimmed.isEmpty() || trimmed.startsWith(QLatin1Char('#'))) {
+            continue;
+        }
+        QString error;
+        if (m_rules.addRule(trimmed, &error) < 0) {
+            qWarning() << "Ignoring hide rule" << trimmed << ":" << error;
+            ok = false;
+        }
+    }
+    m_rules.compile();
+    applyHideRules();
+    return ok;
+}
+
+bool HideProcess::addHideRule(const QString& rule, QString* error, int* changed) {
+    const QString trimmed = rule.trimmed();
+    if (changed) {
+        *changed = 0;
+    }
+    if (m_rules.ruleTexts().contains(trimmed)) {
+        return true;
+    }
+    if (m_rules.addRule(trimmed, error) < 0) {
+        return false;
+    }
+    m_rules.compile();
+    const int hidden = applyHideRules();
+    if (changed) {
+        *changed = hidden;
+    }
+    return true;
+}
+
+bool HideProcess::removeHideRule(const QString& rule, int* changed) {
+    const QString trimmed = rule.trimmed();
+    QStringList remaining = m_rules.ruleTexts();
+    if (remaining.removeAll(trimmed) == 0) {
+        return false;
+    }
+    RuleEngine removed;
+    removed.addRule(trimmed);
+    removed.compile();
+    setHideRules(remaining);
+    if (!m_windowSystem) {
+        return true;
+    }
+
+    // 登记表只记录窗口，不记录是哪条规则隐藏的：按当前窗口属性重新匹配
+    const bool needsPath = removed.usesField(RuleField::ExePath) || removed.usesField(RuleField::ExeName)
+        || m_rules.usesField(RuleField::ExePath) || m_rules.usesField(RuleField::ExeName);
+    QHash<qint64, QString> exePaths;
+    const int restored = restoreHiddenWindows([&](const HiddenWindowRecord& record) {
+        WindowInfo info;
+        if (!m_windowSystem->queryWindow(static_cast<WindowId>(record.windowId), info)) {
+            return false;
+        }
+        auto it = exePaths.find(record.pid);
+        if (it == exePaths.end()) {
+            it = exePaths.insert(record.pid, needsPath ? m_windowSystem->processImagePath(record.pid) : QString());
+        }
+        return matchRule(removed, info, it.value()) >= 0 && matchHideRule(info, it.value()) < 0;
+    });
+    if (changed) {
+        *changed = restored;
+    }
+    return true;
+}
+
+int HideProcess::applyHideRules() {
+    if (m_rules.isEmpty() || !m_windowSystem) {
+        return 0;
+    }
+    HW_TRACE_SCOPE("hide", "applyHideRules");
+    finishWindowIndexBuild();
+    std::vector<WindowId> pending;
+    // 同一进程的多个窗口只查询一次路径
+    QHash<qint64, QString> exePaths;
+    m_windowIndex->forEachWindow([&](const WindowInfo& window) {
+        if (!window.visible || m_ruleExempt.contains(window.id)) {
+            return;
+        }
+        auto it = exePaths.find(window.pid);
+        if (it == exePaths.end()) {
+            it = exePaths.insert(window.pid, ruleExePath(window.pid));
+        }
+        if (matchHideRule(window, it.value()) >= 0) {
+            stageHide(window, pending);
+        }
+    });
+    if (pending.empty()) {
+        return 0;
+    }
+    HW_LOG_INFO(s_hideLog, "Hide rules matched %1 windows", pending.size());
+    return commitPendingHide(pending);
+}
+
+QString HideProcess::ruleExePath(qint64 pid) const {
+    // 只在有规则用到时才查询进程路径（需要打开进程）
+    if (m_rules.usesField(RuleField::ExePath) || m_rules.usesField(RuleField::ExeName)) {
+        return m_windowSystem->processImagePath(pid);
+    }
+    return QString();
+}
+
+int HideProcess::matchHideRule(const WindowInfo& window, const QString& exePath) const {
+    return matchRule(m_rules, window, exePath);
+}
+
+int HideProcess::matchRule(const RuleEngine& rules, const WindowInfo& window, const QString& exePath) {
+    if (rules.isEmpty()) {
+        return -1;
+    }
+    QStringView exeName(exePath);
+    const qsizetype separator = qMax(exePath.lastIndexOf(QLatin1Char('\\')), exePath.lastIndexOf(QLatin1Char('/')));
+    if (separator >= 0) {
+        exeName = exeName.mid(separator + 1);
+    }
+
+    RuleSubject subject;
+    subject.exeName = exeName;
+    subject.exePath = exePath;
+    subject.className = window.className;
+    subject.title = window.title;
+    return rules.match(subject);
+}
+
+void HideProcess::windowUpdated(const WindowInfo& info) {
+    if (!info.visible || m_rules.isEmpty() || !m_windowSystem || m_ruleExempt.contains(info.id)) {
+        return;
+    }
+    HW_TRACE_SCOPE("hide", "autoHide");
+    const int rule = matchHideRule(info, ruleExePath(info.pid));
+    if (rule < 0) {
+        return;
+    }
+    std::vector<WindowId> pending;
+    stageHide(info, pending);
+    if (pending.empty() || commitPendingHide(pending) == 0) {
+        return;
+    }
+    HW_LOG_DEBUG(s_hideLog, "Auto-hid window of PID %1 by rule %2", info.pid, rule);
+    emit windowAutoHidden(info.pid, m_rules.ruleText(rule));
+}
+
+void HideProcess::windowRemoved(WindowId id) {
+    m_ruleExempt.remove(id);
+}
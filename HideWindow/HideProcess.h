@@ -0,0 +1,119 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+#ifndef HIDEPROCESS_H
+#define HIDEPROCESS_H
+// 隐藏 / 显示的核心逻辑，只依赖 QtCore，图形界面与无界面的控制服务共用
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+#include <QVariantList>
+#include <memory>
+#include <vector>
+#include "WindowSystem.h"
+#include "WindowIndex.h"
+#include "HiddenWindowRegistry.h"
+#include "RuleEngine.h"
+
+class QThread;
+
+// 窗口查找基于 WindowIndex，隐藏/显示只需查表而不必遍历桌面
+class HideProcess : public QObject, private WindowIndexObserver {
+    Q_OBJECT
+public:
+    // 构造时如何建立窗口索引：Background 在后台线程遍历桌面，完成后发出 windowIndexReady，
+    // 供启动时与界面构建并行；未完成前的隐藏请求会先等待遍历结束
+    enum class IndexBuild { Synchronous, Background };
+
+    explicit HideProcess(QObject* parent = nullptr);
+    explicit HideProcess(IndexBuild indexBuild, QObject* parent = nullptr);
+    // 使用指定的窗口系统（例如模拟桌面）与日志文件（为空时只登记在内存中）
+    explicit HideProcess(std::unique_ptr<WindowSystem> windowSystem,
+        const QString& journalPath = HiddenWindowRegistry::defaultJournalPath(),
+        IndexBuild indexBuild = IndexBuild::Synchronous, QObject* parent = nullptr);
+    // 析构时还原所有由本程序隐藏的窗口
+    ~HideProcess() override;
+    // 当前平台是否有可用的窗口系统（没有时隐藏 / 显示不做任何事）
+    bool hasWindowSystem() const { return m_windowSystem != nullptr; }
+    const WindowIndex* windowIndex() const;
+    // 后台建立索引已完成（同步建立时总为 true）
+    bool isWindowIndexReady() const { return m_indexWorker == nullptr; }
+    const HiddenWindowRegistry& hiddenWindows() const;
+    // 当前的自动隐藏规则（语法见 RuleEngine.h）
+    Q_INVOKABLE QStringList hideRules() const;
+    // 供 C++ 调用方（如控制服务）直接传入 PID 集合，语义同 hideProcesses / showProcesses；
+    // 返回实际隐藏 / 还原的窗口数
+    int hidePids(const QSet<qint64>& pids);
+    int showPids(const QSet<qint64>& pids);
+    // 追加一条规则并立即应用；已存在时不重复添加，语法错误时返回 false 并写入 error。
+    // changed 非空时写入因此隐藏的窗口数
+    bool addHideRule(const QString& rule, QString* error = nullptr, int* changed = nullptr);
+    // 移除一条规则，并还原由本程序隐藏、匹配该规则且不再匹配其他规则的窗口；规则不存在时返回 false。
+    // changed 非空时写入还原的窗口数
+    bool removeHideRule(const QString& rule, int* changed = nullptr);
+public slots:
+    void hideProcess(qint64 pid = 0);
+    void showProcess(qint64 pid = 0);
+    // 一次遍历匹配多个进程的窗口，所有可见性修改合并为一批提交
+    void hideProcesses(const QVariantList& pids);
+    void showProcesses(const QVariantList& pids);
+    // 丢弃窗口缓存并重新遍历桌面
+    void rebuildWindowIndex();
+    // 还原登记表中的所有窗口，返回实际还原的窗口数
+    int showAllHiddenWindows();
+    // 替换自动隐藏规则并立即应用到现有窗口；有语法错误的规则被忽略，此时返回 false
+    bool setHideRules(const QStringList& rules);
+    // 对现有的所有可见窗口重新应用规则（手动还原过的窗口除外），返回隐藏的窗口数
+    int applyHideRules();
+signals:
+    // 窗口因命中规则被自动隐藏
+    void windowAutoHidden(qint64 pid, const QString& rule);
+    // 后台建立的窗口索引已合并完成
+    void windowIndexReady();
+private:
+    // WindowIndexObserver：新出现或变为可见的窗口按规则自动隐藏
+    void windowUpdated(const WindowInfo& info) override;
+    void windowRemoved(WindowId id) override;
+    // 规则用到 exe / path 字段时查询进程路径，否则返回空串
+    QString ruleExePath(qint64 pid) const;
+    // 命中的规则 id，未命中返回 -1
+    int matchHideRule(const WindowInfo& window, const QString& exePath) const;
+    static int matchRule(const RuleEngine& rules, const WindowInfo& window, const QString& exePath);
+    // 登记窗口隐藏前的状态并加入 pending；登记失败的窗口不隐藏，保证总能还原
+    void stageHide(const WindowInfo& window, std::vector<WindowId>& pending);
+    // 一次提交 pending 中所有窗口的隐藏。pending 由调用方持有：提交时触发的窗口事件
+    // 可能重入 windowUpdated，共享的成员列表会被其清空。
+    // 提交后仍可见的窗口撤销登记，返回实际隐藏的窗口数
+    int commitPendingHide(const std::vector<WindowId>& pending);
+    int hideWindowsOf(const QSet<qint64>& pids);
+    // 只还原登记表中由本程序隐藏的窗口，不触碰进程自己隐藏的窗口；返回实际还原的窗口数。
+    // 记录在窗口确实恢复可见后才移除
+    template <typename Pred>
+    int restoreHiddenWindows(Pred pred);
+    static QSet<qint64> toPidSet(const QVariantList& pids);
+    // 在后台线程遍历桌面；finishWindowIndexBuild 等待其结束并合并进索引，未在进行时不做任何事
+    void startWindowIndexBuild();
+    void finishWindowIndexBuild();
+    // rebuild 不逐个通知删除，清理已不存在的窗口
+    void pruneRuleExempt();
+
+    std::unique_ptr<WindowSystem> m_windowSystem;
+    std::unique_ptr<WindowIndex> m_windowIndex;
+    HiddenWindowRegistry m_hiddenWindows;
+    RuleEngine m_rules;
+    QSet<WindowId> m_ruleExempt; // 用户手动还原的窗口，不再被规则自动隐藏
+    QTimer m_handleEvictTimer; // 规则查询进程路径后，定期关闭进程句柄缓存中空闲的句柄
+    QThread* m_indexWorker = nullptr;
+    std::vector<WindowInfo> m_indexScratch; // 后台遍历的结果，只在工作线程结束后读取
+};
+#endif
@@ -0,0 +1,112 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "HookEventDispatcher.h"
+#include "Metrics.h"
+
+// ===================== HookEventDispatcher 类实现 =====================
+HookEventDispatcher::HookEventDispatcher(std::size_t capacity, QObject* parent)
+    : QObject(parent)
+    , m_ring(capacity)
+{
+    qRegisterMetaType<HookEvent>();
+}
+
+HookEventDispatcher::~HookEventDispatcher() {
+    stop();
+}
+
+quint64 HookEventDispatcher::now() {
+    return Metrics::now();
+}
+
+bool HookEventDispatcher::post(const HookEvent& event) {
+    m_posted.fetch_add(1, std::memory_order_relaxed);
+    const bool queued = m_ring.push(event);
+    // 只有分发线程声明要休眠时才需要唤醒，避免每个事件都触碰信号量
+    if (m_sleeping.exchange(false)) {
+        m_wakeup.release();
+    }
+    return queued;
+}
+
+void HookEventDispatcher::setOverflowPolicy(OverflowPolicy policy) {
+    m_ring.setOverflowPolicy(policy);
+}
+
+HookEventDispatcher::OverflowPolicy HookEventDispatcher::overflowPolicy() const {
+    return m_ring.overflowPolicy();
+}
+
+std::size_t HookEventDispatcher::capacity() const {
+    return m_ring.capacity();
+}
+
+quint64 HookEventDispatcher::postedCount() const {
+    return m_posted.load(std::memory_order_relaxed);
+}
+
+quint64 HookEventDispatcher::droppedCount() const {
+    return m_ring.droppedCount();
+}
+
+quint64 HookEventDispatcher::dispatchedCount() const {
+    return m_dispatched.load(std::memory_order_relaxed);
+}
+
+void HookEventDispatcher::start() {
+    if (m_thread) {
+        return;
+    }
+    m_running.store(true);
+    m_thread = QThread::create([this]() { run(); });
+    m_thread->setObjectName(QStringLiteral("HookEventDispatcher"));
+    // 分发线程只做转发，提高优先级以缩短按键到处理的延迟
+    m_thread->start(QThread::TimeCriticalPriority);
+}
+
+void HookEventDispatcher::stop() {
+    if (!m_thread) {
+        return;
+    }
+    m_running.store(false);
+    m_wakeup.release();
+    m_thread->wait();
+    delete m_thread;
+    m_thread = nullptr;
+}
+
+void HookEventDispatcher::dispatch(const HookEvent& event) {
+    m_dispatched.fetch_add(1, std::memory_order_relaxed);
+    Metrics::registry().dispatchDelay.record(Metrics::now() - event.timestamp);
+    emit eventReceived(event);
+}
+
+void HookEventDispatcher::run() {
+    HookEvent event;
+    while (m_running.load(std::memory_order_relaxed)) {
+        while (m_ring.pop(event)) {
+            dispatch(event);
+        }
+
+        // 先声明休眠再复查队列：生产者在声明之前入队的事件会在复查时被看到，
+        // 之后入队的事件会通过 m_sleeping 唤醒本线程
+        m_sleeping.store(true);
+        if (m_ring.pop(event)) {
+            m_sleeping.store(false);
+            dispatch(event);
+            continue;
+        }
+        if (m_running.load(std::memory_order_relaxed)) {
+            m_wakeup.acquire();
+        }
+    }
+    m_sleeping.store(false);
+}
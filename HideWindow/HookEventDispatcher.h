@@ -0,0 +1,80 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+#ifndef HOOKEVENTDISPATCHER_H
+#define HOOKEVENTDISPATCHER_H
+#include <QObject>
+#include <QSemaphore>
+#include <QThread>
+#include <atomic>
+#include "SpscRing.h"
+
+// 钩子回调交给分发线程的紧凑事件
+struct HookEvent {
+    enum Flag : quint32 {
+        KeyUp = 0x1,    // 按键抬起（否则为按下）
+        Injected = 0x2, // 由 SendInput 等注入
+        SystemKey = 0x4 // WM_SYSKEYDOWN/WM_SYSKEYUP（Alt 组合）
+    };
+    quint32 vk = 0;
+    quint32 flags = 0;
+    quint64 timestamp = 0; // steady_clock 纳秒
+    qint32 binding = -1;   // 完成的热键绑定 id（见 HotkeyMatcher），-1 表示普通按键
+};
+Q_DECLARE_METATYPE(HookEvent)
+
+// 钩子回调（生产者）与分发线程（消费者）之间的无锁交接
+// post() 只做一次入队和一次原子交换，绝不阻塞；分发线程取出事件后发出 eventReceived
+class HookEventDispatcher : public QObject {
+    Q_OBJECT
+public:
+    using OverflowPolicy = SpscRing<HookEvent>::OverflowPolicy;
+
+    explicit HookEventDispatcher(std::size_t capacity = 1024, QObject* parent = nullptr);
+    ~HookEventDispatcher() override;
+    HookEventDispatcher(const HookEventDispatcher&) = delete;
+    HookEventDispatcher& operator=(const HookEventDispatcher&) = delete;
+
+    // 仅由单一生产者线程（钩子线程）调用；队列满时按溢出策略丢弃并返回 false
+    bool post(const HookEvent& event);
+
+    void setOverflowPolicy(OverflowPolicy policy);
+    OverflowPolicy overflowPolicy() const;
+    std::size_t capacity() const;
+
+    quint64 postedCount() const;
+    quint64 droppedCount() const;
+    quint64 dispatchedCount() const;
+
+    // 当前时刻（与 HookEvent::timestamp 同一时钟）
+    static quint64 now();
+
+public slots:
+    void start();
+    void stop();
+
+signals:
+    // 在分发线程中发出；连接到其他线程的对象时按常规排队投递
+    void eventReceived(const HookEvent& event);
+
+private:
+    void run();
+    void dispatch(const HookEvent& event);
+
+    SpscRing<HookEvent> m_ring;
+    QSemaphore m_wakeup;
+    QThread* m_thread = nullptr;
+    std::atomic<bool> m_running{ false };
+    std::atomic<bool> m_sleeping{ false }; // 分发线程即将等待，生产者需要唤醒它
+    std::atomic<quint64> m_posted{ 0 };
+    std::atomic<quint64> m_dispatched{ 0 };
+};
+#endif
@@ -0,0 +1,219 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "HookMultiplexer.h"
+#include "Metrics.h"
+#include "Trace.h"
+#include <QDebug>
+#include <QMetaObject>
+#include <QThread>
+#ifdef Q_OS_WIN
+#include <windows.h>
+#endif
+
+namespace {
+// 当前线程正在 deliver() 中的层数；在订阅者回调里退订时不能等待读者归零
+thread_local int t_deliverDepth = 0;
+
+#ifdef Q_OS_WIN
+LRESULT CALLBACK lowLevelKeyboardProc(int nCode, WPARAM wParam, LPARAM lParam) {
+    if (nCode >= 0) {
+        const bool keyDown = wParam == WM_KEYDOWN || wParam == WM_SYSKEYDOWN;
+        const bool keyUp = wParam == WM_KEYUP || wParam == WM_SYSKEYUP;
+        if (keyDown || keyUp) {
+            const KBDLLHOOKSTRUCT* pKeyStruct = reinterpret_cast<const KBDLLHOOKSTRUCT*>(lParam);
+            HookEvent event;
+            event.vk = pKeyStruct->vkCode;
+            event.flags = (keyUp ? HookEvent::KeyUp : 0)
+                | ((wParam == WM_SYSKEYDOWN || wParam == WM_SYSKEYUP) ? HookEvent::SystemKey : 0)
+                | ((pKeyStruct->flags & LLKHF_INJECTED) ? HookEvent::Injected : 0);
+            event.timestamp = HookEventDispatcher::now();
+            // 任一订阅者要求拦截：不再传递给系统
+            if (HookMultiplexer::instance().deliver(event)) {
+                return 1;
+            }
+        }
+    }
+    // 必须传递给下一个钩子，否则系统可能异常
+    return CallNextHookEx(nullptr, nCode, wParam, lParam);
+}
+#endif
+} // namespace
+
+// ===================== HookMultiplexer 类实现 =====================
+HookMultiplexer& HookMultiplexer::instance() {
+    static HookMultiplexer multiplexer;
+    return multiplexer;
+}
+
+HookMultiplexer::HookMultiplexer()
+    : m_table(new Table)
+{
+}
+
+HookMultiplexer::~HookMultiplexer() {
+    uninstallHook();
+    delete m_table.load();
+    qDeleteAll(m_retired);
+}
+
+HookMultiplexer::KeyFilter HookMultiplexer::allKeys() {
+    return KeyFilter();
+}
+
+HookMultiplexer::KeyFilter HookMultiplexer::keys(std::initializer_list<quint32> vks) {
+    KeyFilter filter;
+    for (quint32 vk : vks) {
+        if (vk < filter.size()) {
+            filter.set(vk);
+        }
+    }
+    return filter;
+}
+
+int HookMultiplexer::subscriberCount() const {
+    QMutexLocker locker(&m_writeMutex);
+    return m_table.load()->subscribers.size();
+}
+
+bool HookMultiplexer::deliver(const HookEvent& event) {
+    Metrics::Registry& metrics = Metrics::registry();
+    metrics.eventsSeen.add();
+    Metrics::ScopedTimer timer(metrics.hookTime);
+    HW_TRACE_SCOPE("hook", "deliver");
+
+    // 先登记读者再读取表指针：写者替换表后看到读者计数为零，说明没有人还持有旧表
+    m_readers.fetch_add(1);
+    ++t_deliverDepth;
+    const Table* table = m_table.load();
+
+    bool swallow = false;
+    for (const Subscriber& subscriber : table->subscribers) {
+        if (!subscriber.allKeys && (event.vk >= subscriber.keys.size() || !subscriber.keys.test(event.vk))) {
+            continue;
+        }
+        if (subscriber.delivery == Delivery::Direct) {
+            swallow = (*subscriber.handler)(event) || swallow;
+        }
+        else {
+            std::shared_ptr<std::atomic<bool>> active = subscriber.active;
+            std::shared_ptr<Handler> handler = subscriber.handler;
+            QMetaObject::invokeMethod(subscriber.context, [active, handler, event]() {
+                if (active->load()) {
+                    (*handler)(event);
+                }
+            }, Qt::QueuedConnection);
+        }
+    }
+
+    --t_deliverDepth;
+    m_readers.fetch_sub(1);
+    return swallow;
+}
+
+void HookMultiplexer::publish(Table* table) {
+    Table* old = m_table.exchange(table);
+    if (t_deliverDepth > 0) {
+        // 在订阅者回调中修改订阅：本线程自己就是读者，等待会死锁
+        m_retired.append(old);
+        return;
+    }
+    while (m_readers.load() != 0) {
+        QThread::yieldCurrentThread();
+    }
+    delete old;
+    qDeleteAll(m_retired);
+    m_retired.clear();
+}
+
+int HookMultiplexer::subscribe(const Subscription& subscription, int* errorCode) {
+    if (!subscription.handler || (subscription.delivery == Delivery::Queued && !subscription.context)) {
+        qWarning() << "Invalid hook subscription";
+        return -1;
+    }
+
+    QMutexLocker locker(&m_writeMutex);
+    const Table* current = m_table.load();
+    if (current->subscribers.isEmpty() && !installHook(errorCode)) {
+        return -1;
+    }
+
+    Subscriber subscriber;
+    subscriber.id = m_nextId++;
+    subscriber.keys = subscription.keys;
+    subscriber.allKeys = subscription.keys.none();
+    subscriber.delivery = subscription.delivery;
+    subscriber.context = subscription.context;
+    subscriber.active = std::make_shared<std::atomic<bool>>(true);
+    subscriber.handler = std::make_shared<Handler>(subscription.handler);
+
+    Table* table = new Table(*current);
+    table->subscribers.append(subscriber);
+    publish(table);
+    return subscriber.id;
+}
+
+void HookMultiplexer::unsubscribe(int id) {
+    QMutexLocker locker(&m_writeMutex);
+    const Table* current = m_table.load();
+    Table* table = new Table;
+    table->subscribers.reserve(current->subscribers.size());
+    for (const Subscriber& subscriber : current->subscribers) {
+        if (subscriber.id == id) {
+            subscriber.active->store(false);
+        }
+        else {
+            table->subscribers.append(subscriber);
+        }
+    }
+    if (table->subscribers.size() == current->subscribers.size()) {
+        delete table;
+        return;
+    }
+
+    publish(table);
+    if (table->subscribers.isEmpty()) {
+        uninstallHook();
+    }
+}
+
+bool HookMultiplexer::installHook(int* errorCode) {
+#ifdef Q_OS_WIN
+    if (m_hookHandle) {
+        return true;
+    }
+    // 安装低级键盘全局钩子（LL钩子无需DLL，0 = 全局监控所有线程）
+    HHOOK hook = SetWindowsHookExW(WH_KEYBOARD_LL, lowLevelKeyboardProc, GetModuleHandleW(nullptr), 0);
+    if (hook == nullptr) {
+        const int error = static_cast<int>(GetLastError());
+        qCritical() << "全局钩子安装失败，错误码：" << error;
+        if (errorCode) {
+            *errorCode = error;
+        }
+        return false;
+    }
+    m_hookHandle = hook;
+    qInfo() << "全局钩子已安装";
+#else
+    // 其他平台没有系统钩子，事件由模拟事件源通过 deliver() 注入
+    Q_UNUSED(errorCode);
+#endif
+    return true;
+}
+
+void HookMultiplexer::uninstallHook() {
+#ifdef Q_OS_WIN
+    if (m_hookHandle) {
+        UnhookWindowsHookEx(static_cast<HHOOK>(m_hookHandle));
+        m_hookHandle = nullptr;
+        qInfo() << "全局钩子已卸载";
+    }
+#endif
+}
@@ -0,0 +1,93 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+#ifndef HOOKMULTIPLEXER_H
+#define HOOKMULTIPLEXER_H
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <atomic>
+#include <bitset>
+#include <functional>
+#include <memory>
+#include "HookEventDispatcher.h"
+
+// 进程内唯一的键盘钩子，按订阅者的过滤集合把事件分发给任意数量的订阅者
+// 钩子路径读取订阅表不加锁：表不可变，订阅/退订时原子替换整张表，
+// 旧表在所有正在分发的读者离开后才释放（RCU 风格）。
+class HookMultiplexer {
+public:
+    using KeyFilter = std::bitset<256>;
+    // Direct 回调在钩子线程中同步执行，返回 true 表示拦截该按键；必须快速返回
+    using Handler = std::function<bool(const HookEvent&)>;
+
+    enum class Delivery {
+        Direct, // 在钩子线程中同步调用，可拦截按键
+        Queued  // 投递到 context 所在线程的事件循环，不能拦截
+    };
+
+    struct Subscription {
+        KeyFilter keys;       // 关心的虚拟键码；全部清零表示接收所有按键
+        Delivery delivery = Delivery::Direct;
+        QObject* context = nullptr; // Queued 时必填；销毁前必须先退订
+        Handler handler;
+    };
+
+    static HookMultiplexer& instance();
+
+    HookMultiplexer(const HookMultiplexer&) = delete;
+    HookMultiplexer& operator=(const HookMultiplexer&) = delete;
+
+    // 返回订阅 id；第一个订阅者到来时安装系统钩子，安装失败返回 -1 并写入 errorCode
+    // 系统钩子回调运行在安装它的线程上，该线程需要有消息循环
+    int subscribe(const Subscription& subscription, int* errorCode = nullptr);
+    // 返回后保证该订阅的 Direct 回调不再执行（在自身回调中退订时除外），
+    // 已投递但未执行的 Queued 事件会被丢弃；最后一个订阅者离开时卸载系统钩子
+    void unsubscribe(int id);
+    int subscriberCount() const;
+
+    // 把一次按键事件分发给所有匹配的订阅者；任一 Direct 订阅者要求拦截时返回 true
+    // 由系统钩子回调调用，也可由模拟事件源直接调用
+    bool deliver(const HookEvent& event);
+
+    static KeyFilter allKeys();
+    static KeyFilter keys(std::initializer_list<quint32> vks);
+
+private:
+    HookMultiplexer();
+    ~HookMultiplexer();
+
+    struct Subscriber {
+        int id;
+        KeyFilter keys;
+        bool allKeys;
+        Delivery delivery;
+        QObject* context;
+        // 与 Queued 闭包共享，退订后置为 false
+        std::shared_ptr<std::atomic<bool>> active;
+        std::shared_ptr<Handler> handler;
+    };
+    struct Table {
+        QList<Subscriber> subscribers;
+    };
+
+    void publish(Table* table);
+    bool installHook(int* errorCode);
+    void uninstallHook();
+
+    std::atomic<Table*> m_table;
+    std::atomic<int> m_readers{ 0 };
+    mutable QMutex m_writeMutex;     // 串行化订阅/退订，不参与分发
+    QList<Table*> m_retired;         // 回调内退订时无法等待读者，延后释放
+    int m_nextId = 1;
+    void* m_hookHandle = nullptr;    // HHOOK（Windows）
+};
+#endif
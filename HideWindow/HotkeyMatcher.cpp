@@ -0,0 +1,333 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "HotkeyMatcher.h"
+#include <QDebug>
+
+namespace {
+// 左右修饰键各占一位，查询时合并为 HotkeyModifier 掩码
+constexpr std::uint8_t kLeftCtrl = 0x01, kRightCtrl = 0x02;
+constexpr std::uint8_t kLeftAlt = 0x04, kRightAlt = 0x08;
+constexpr std::uint8_t kLeftShift = 0x10, kRightShift = 0x20;
+constexpr std::uint8_t kLeftMeta = 0x40, kRightMeta = 0x80;
+
+// 状态号占转移键的高 20 位
+constexpr int kMaxStates = (1 << 20) - 1;
+constexpr std::uint64_t kDefaultChordTimeoutNs = 1500ull * 1000 * 1000;
+
+std::uint8_t sideBitForVk(std::uint32_t vk) {
+    using namespace KeyMap;
+    switch (vk) {
+    case Vk::Control: case Vk::LControl: return kLeftCtrl;
+    case Vk::RControl: return kRightCtrl;
+    case Vk::Menu: case Vk::LMenu: return kLeftAlt;
+    case Vk::RMenu: return kRightAlt;
+    case Vk::Shift: case Vk::LShift: return kLeftShift;
+    case Vk::RShift: return kRightShift;
+    case Vk::LWin: return kLeftMeta;
+    case Vk::RWin: return kRightMeta;
+    default: return 0;
+    }
+}
+
+// 每个修饰键位对应的左右虚拟键码，重新同步时逐个查询
+struct SideKey {
+    std::uint32_t vk;
+    std::uint8_t bit;
+};
+constexpr SideKey kSideKeys[] = {
+    { KeyMap::Vk::LControl, kLeftCtrl }, { KeyMap::Vk::RControl, kRightCtrl },
+    { KeyMap::Vk::LMenu, kLeftAlt }, { KeyMap::Vk::RMenu, kRightAlt },
+    { KeyMap::Vk::LShift, kLeftShift }, { KeyMap::Vk::RShift, kRightShift },
+    { KeyMap::Vk::LWin, kLeftMeta }, { KeyMap::Vk::RWin, kRightMeta },
+};
+
+std::uint8_t modifiersFromQt(Qt::KeyboardModifiers modifiers) {
+    std::uint8_t result = 0;
+    if (modifiers & Qt::ControlModifier) result |= HotkeyModifier::Ctrl;
+    if (modifiers & Qt::AltModifier) result |= HotkeyModifier::Alt;
+    if (modifiers & Qt::ShiftModifier) result |= HotkeyModifier::Shift;
+    if (modifiers & Qt::MetaModifier) result |= HotkeyModifier::Meta;
+    return result;
+}
+} // namespace
+
+// ===================== HotkeyMatcher 类实现 =====================
+HotkeyMatcher::HotkeyMatcher()
+    : m_chordTimeout(kDefaultChordTimeoutNs)
+{
+    compile();
+}
+
+bool HotkeyMatcher::strokesFromSequence(const QKeySequence& sequence, QList<HotkeyStroke>& strokes) {
+    strokes.clear();
+    for (int i = 0; i < sequence.count(); ++i) {
+        const QKeyCombination combination = sequence[i];
+        const std::uint8_t vk = KeyMap::vkFromQtKey(combination.key());
+        // 修饰键不能作为组合键中的一步（它们只改变修饰键掩码）
+        if (vk == 0 || sideBitForVk(vk) != 0) {
+            strokes.clear();
+            return false;
+        }
+        HotkeyStroke stroke;
+        stroke.vk = vk;
+        stroke.modifiers = modifiersFromQt(combination.keyboardModifiers());
+        strokes.append(stroke);
+    }
+    return !strokes.isEmpty();
+}
+
+int HotkeyMatcher::addBinding(const QKeySequence& sequence, bool swallow) {
+    QList<HotkeyStroke> strokes;
+    if (!strokesFromSequence(sequence, strokes)) {
+        qWarning() << "Cannot bind hotkey" << sequence.toString() << ": unmapped key";
+        return -1;
+    }
+    return addBinding(strokes, swallow);
+}
+
+int HotkeyMatcher::addBinding(const QList<HotkeyStroke>& strokes, bool swallow) {
+    if (strokes.isEmpty()) {
+        return -1;
+    }
+    Binding binding{ m_nextId++, strokes, swallow };
+    m_bindings.append(binding);
+    return binding.id;
+}
+
+bool HotkeyMatcher::removeBinding(int id) {
+    for (int i = 0; i < m_bindings.size(); ++i) {
+        if (m_bindings[i].id == id) {
+            m_bindings.removeAt(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+void HotkeyMatcher::clearBindings() {
+    m_bindings.clear();
+}
+
+int HotkeyMatcher::bindingCount() const {
+    return m_bindings.size();
+}
+
+void HotkeyMatcher::setChordTimeout(std::uint64_t timeoutNs) {
+    m_chordTimeout = timeoutNs;
+}
+
+std::uint64_t HotkeyMatcher::chordTimeout() const {
+    return m_chordTimeout;
+}
+
+std::uint32_t HotkeyMatcher::transitionKey(int state, std::uint8_t modifiers, std::uint8_t vk) {
+    return (static_cast<std::uint32_t>(state) << 12) | (static_cast<std::uint32_t>(modifiers & 0xF) << 8) | vk;
+}
+
+int HotkeyMatcher::findTransition(int state, std::uint8_t modifiers, std::uint8_t vk) const {
+    const std::uint32_t key = transitionKey(state, modifiers, vk);
+    const Transition* table = m_transitions.constData();
+    // 乘法散列 + 线性探测；装载因子不超过 1/2
+    std::uint32_t index = (key * 0x9E3779B1u) & m_transitionMask;
+    for (;;) {
+        const Transition& t = table[index];
+        if (t.key == key) {
+            return t.target;
+        }
+        if (t.key == kEmptyKey) {
+            return -1;
+        }
+        index = (index + 1) & m_transitionMask;
+    }
+}
+
+void HotkeyMatcher::insertTransition(std::uint32_t key, int target) {
+    std::uint32_t index = (key * 0x9E3779B1u) & m_transitionMask;
+    while (m_transitions[index].key != kEmptyKey) {
+        index = (index + 1) & m_transitionMask;
+    }
+    m_transitions[index].key = key;
+    m_transitions[index].target = target;
+}
+
+void HotkeyMatcher::compile() {
+    // 按前缀树建立状态，转移直接写入最终的开放寻址表
+    int transitionCount = 0;
+    for (const Binding& binding : m_bindings) {
+        transitionCount += binding.strokes.size();
+    }
+    std::uint32_t capacity = 16;
+    while (capacity < static_cast<std::uint32_t>(transitionCount) * 2) {
+        capacity <<= 1;
+    }
+
+    m_states.clear();
+    m_states.append(State());
+    m_transitions.fill(Transition(), capacity);
+    m_transitionMask = capacity - 1;
+
+    for (const Binding& binding : m_bindings) {
+        int state = kRootState;
+        bool dropped = false;
+        for (const HotkeyStroke& stroke : binding.strokes) {
+            if (m_states[state].bindingId >= 0) {
+                // 较短的绑定先完成，后续步骤永远到达不了
+                qWarning() << "Hotkey binding" << binding.id << "is shadowed by binding" << m_states[state].bindingId;
+                dropped = true;
+                break;
+            }
+            int next = findTransition(state, stroke.modifiers, stroke.vk);
+            if (next < 0) {
+                if (m_states.size() >= kMaxStates) {
+                    qWarning() << "Hotkey table is full, dropping binding" << binding.id;
+                    dropped = true;
+                    break;
+                }
+                next = m_states.size();
+                m_states.append(State());
+                m_states[state].hasChildren = true;
+                insertTransition(transitionKey(state, stroke.modifiers, stroke.vk), next);
+            }
+            state = next;
+            if (binding.swallow) {
+                // 要拦截的组合键，其前缀也必须拦截，否则前台程序会收到半个组合键
+                m_states[state].swallow = true;
+            }
+        }
+        if (dropped) {
+            continue;
+        }
+        if (m_states[state].bindingId >= 0) {
+            qWarning() << "Hotkey binding" << binding.id << "duplicates binding" << m_states[state].bindingId;
+            continue;
+        }
+        if (m_states[state].hasChildren) {
+            qWarning() << "Hotkey binding" << binding.id << "shadows longer chords starting with it";
+        }
+        m_states[state].bindingId = binding.id;
+        m_states[state].swallow = binding.swallow;
+    }
+
+    // 状态编号已变化，丢弃进行中的组合键
+    m_state = kRootState;
+}
+
+bool HotkeyMatcher::updateModifiers(std::uint32_t vk, bool keyDown) {
+    const std::uint8_t bit = sideBitForVk(vk);
+    if (bit == 0) {
+        return false;
+    }
+    if (keyDown) {
+        m_sideModifiers |= bit;
+    }
+    else {
+        m_sideModifiers &= static_cast<std::uint8_t>(~bit);
+    }
+    return true;
+}
+
+void HotkeyMatcher::setKeyStateProbe(KeyStateProbe probe) {
+    m_keyStateProbe = probe;
+}
+
+void HotkeyMatcher::resyncModifiers() {
+    std::uint8_t held = 0;
+    for (const SideKey& side : kSideKeys) {
+        if (m_keyStateProbe(side.vk)) {
+            held |= side.bit;
+        }
+    }
+    m_sideModifiers = held;
+}
+
+std::uint8_t HotkeyMatcher::currentModifiers() const {
+    std::uint8_t result = 0;
+    if (m_sideModifiers & (kLeftCtrl | kRightCtrl)) result |= HotkeyModifier::Ctrl;
+    if (m_sideModifiers & (kLeftAlt | kRightAlt)) result |= HotkeyModifier::Alt;
+    if (m_sideModifiers & (kLeftShift | kRightShift)) result |= HotkeyModifier::Shift;
+    if (m_sideModifiers & (kLeftMeta | kRightMeta)) result |= HotkeyModifier::Meta;
+    return result;
+}
+
+bool HotkeyMatcher::inChord() const {
+    return m_state != kRootState;
+}
+
+bool HotkeyMatcher::swallowsKey(std::uint32_t vk) const {
+    return vk <= 0xFF && (m_swallowedDown[vk >> 6] & (1ull << (vk & 63))) != 0;
+}
+
+void HotkeyMatcher::reset() {
+    m_state = kRootState;
+    m_chordDeadline = 0;
+    m_sideModifiers = 0;
+    for (std::uint64_t& word : m_swallowedDown) {
+        word = 0;
+    }
+}
+
+bool HotkeyMatcher::step(int state, std::uint8_t vk, std::uint64_t timestamp, HotkeyMatch& match) {
+    const int next = findTransition(state, currentModifiers(), vk);
+    if (next < 0) {
+        m_state = kRootState;
+        return false;
+    }
+    const State& target = m_states[next];
+    match.swallow = target.swallow;
+    if (target.bindingId >= 0) {
+        match.bindingId = target.bindingId;
+        m_state = kRootState;
+    }
+    else {
+        m_state = next;
+        m_chordDeadline = timestamp + m_chordTimeout;
+    }
+    return true;
+}
+
+HotkeyMatch HotkeyMatcher::feed(std::uint32_t vk, bool keyDown, std::uint64_t timestamp) {
+    HotkeyMatch match;
+    if (vk > 0xFF) {
+        return match;
+    }
+    const std::uint64_t bit = 1ull << (vk & 63);
+    std::uint64_t& swallowedWord = m_swallowedDown[vk >> 6];
+
+    if (updateModifiers(vk, keyDown) || !keyDown) {
+        // 被拦截的按键，其抬起事件也不让系统看到
+        if (!keyDown && (swallowedWord & bit)) {
+            swallowedWord &= ~bit;
+            match.swallow = true;
+        }
+        return match;
+    }
+
+    if (m_state != kRootState && timestamp > m_chordDeadline) {
+        m_state = kRootState; // 组合键超时
+    }
+    // 漏掉的修饰键抬起会让普通按键命中带修饰键的绑定（或错过不带修饰键的绑定），
+    // 只在结果可能受影响时查询实际状态，其余按键不产生额外开销
+    if (m_keyStateProbe) {
+        const std::uint8_t key = static_cast<std::uint8_t>(vk);
+        if (m_sideModifiers != 0 || findTransition(m_state, 0, key) >= 0 || findTransition(kRootState, 0, key) >= 0) {
+            resyncModifiers();
+        }
+    }
+    const int state = m_state;
+    if (!step(state, static_cast<std::uint8_t>(vk), timestamp, match) && state != kRootState) {
+        // 组合键中途失配：把当前按键当作新序列的第一步重新匹配
+        step(kRootState, static_cast<std::uint8_t>(vk), timestamp, match);
+    }
+    if (match.swallow) {
+        swallowedWord |= bit;
+    }
+    return match;
+}
@@ -0,0 +1,124 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+#ifndef HOTKEYMATCHER_H
+#define HOTKEYMATCHER_H
+// 平台无关的多绑定 / 组合键（chord）热键匹配器，不包含 windows.h
+#include <QKeySequence>
+#include <QList>
+#include <cstdint>
+#include "KeyMap.h"
+
+// 修饰键位掩码（左右键合并）
+namespace HotkeyModifier {
+constexpr std::uint8_t Ctrl = 0x1;
+constexpr std::uint8_t Alt = 0x2;
+constexpr std::uint8_t Shift = 0x4;
+constexpr std::uint8_t Meta = 0x8;
+} // namespace HotkeyModifier
+
+// 组合键中的一步：非修饰键的虚拟键码 + 按下时的修饰键掩码
+struct HotkeyStroke {
+    std::uint8_t vk = 0;
+    std::uint8_t modifiers = 0;
+};
+
+// 单次按键的匹配结果
+struct HotkeyMatch {
+    int bindingId = -1;  // 完成的绑定；-1 表示没有绑定完成
+    bool swallow = false; // 钩子应拦截该按键（绑定完成、组合键前缀或被拦截按键的抬起）
+};
+
+// 绑定表编译为 DFA：状态为组合键前缀，转移表以 (状态, 修饰键, 虚拟键码) 为键做开放寻址，
+// 每次按键最多两次查表（当前状态失配时回到起始状态重试一次），与绑定数量无关。
+// 非线程安全：绑定的增删、compile() 与 feed() 须在同一线程调用
+// （低级键盘钩子回调运行在安装钩子的线程上）。
+class HotkeyMatcher {
+public:
+    HotkeyMatcher();
+
+    // 添加绑定，返回绑定 id；序列为空或含无法映射的按键时返回 -1
+    // 增删绑定后须调用 compile() 才对 feed() 生效
+    int addBinding(const QKeySequence& sequence, bool swallow = false);
+    int addBinding(const QList<HotkeyStroke>& strokes, bool swallow = false);
+    bool removeBinding(int id);
+    void clearBindings();
+    int bindingCount() const;
+
+    // 组合键相邻两步之间允许的最大间隔（纳秒，与 HookEvent::timestamp 同一时钟）
+    void setChordTimeout(std::uint64_t timeoutNs);
+    std::uint64_t chordTimeout() const;
+
+    // 重建 DFA；前缀冲突（某绑定是另一绑定的前缀）时短绑定优先并输出警告
+    void compile();
+
+    // 输入一次按键事件（含修饰键自身与抬起事件），不分配内存
+    HotkeyMatch feed(std::uint32_t vk, bool keyDown, std::uint64_t timestamp);
+    // 丢弃进行中的组合键与修饰键状态（例如钩子重新安装后）
+    void reset();
+
+    // 查询某个虚拟键此刻是否按下（Windows 下为 GetAsyncKeyState）。钩子会漏掉部分抬起事件
+    // （Ctrl+Alt+Del、Win+L、切换到安全桌面、钩子超时），修饰键因此一直"按住"时普通按键会
+    // 命中带修饰键的绑定并被拦截。设置后，在认为有修饰键按住或按键可能命中绑定时按实际状态重新同步
+    using KeyStateProbe = bool (*)(std::uint32_t vk);
+    void setKeyStateProbe(KeyStateProbe probe);
+
+    std::uint8_t currentModifiers() const;
+    bool inChord() const;
+    // 该按键的按下已被拦截（其自动重复与抬起也应拦截）
+    bool swallowsKey(std::uint32_t vk) const;
+
+    // QKeySequence 转换为按键步骤；无法映射时返回 false
+    static bool strokesFromSequence(const QKeySequence& sequence, QList<HotkeyStroke>& strokes);
+
+private:
+    struct Binding {
+        int id;
+        QList<HotkeyStroke> strokes;
+        bool swallow;
+    };
+    struct State {
+        int bindingId = -1;   // 接受状态对应的绑定
+        bool swallow = false; // 经过该状态的任一绑定要求拦截
+        bool hasChildren = false;
+    };
+    struct Transition {
+        std::uint32_t key = kEmptyKey;
+        std::int32_t target = 0;
+    };
+
+    static constexpr std::uint32_t kEmptyKey = 0xFFFFFFFFu;
+    static constexpr int kRootState = 0;
+
+    static std::uint32_t transitionKey(int state, std::uint8_t modifiers, std::uint8_t vk);
+    int findTransition(int state, std::uint8_t modifiers, std::uint8_t vk) const;
+    void insertTransition(std::uint32_t key, int target);
+    bool updateModifiers(std::uint32_t vk, bool keyDown);
+    void resyncModifiers();
+    bool step(int state, std::uint8_t vk, std::uint64_t timestamp, HotkeyMatch& match);
+
+    QList<Binding> m_bindings;
+    int m_nextId = 1;
+    std::uint64_t m_chordTimeout;
+
+    // 编译结果
+    QList<State> m_states;
+    QList<Transition> m_transitions; // 容量为 2 的幂
+    std::uint32_t m_transitionMask = 0;
+
+    // 运行时状态
+    int m_state = kRootState;
+    std::uint64_t m_chordDeadline = 0;
+    std::uint8_t m_sideModifiers = 0; // 左右修饰键各占一位
+    std::uint64_t m_swallowedDown[4] = {}; // 已拦截按下的虚拟键码，其抬起也一并拦截
+    KeyStateProbe m_keyStateProbe = nullptr;
+};
+#endif
@@ -0,0 +1,85 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "IconLoader.h"
+#include "Trace.h"
+#include <QFileInfo>
+#include <QStringList>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <shellapi.h>
+#pragma comment(lib, "Shell32.lib")
+#endif
+
+namespace {
+// 解码结果与请求尺寸不同时按比例缩放
+QImage fitToSize(const QImage& image, const QSize& size) {
+    if (image.isNull() || !size.isValid() || image.size() == size) {
+        return image;
+    }
+    return image.scaled(size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+}
+} // namespace
+
+#ifdef Q_OS_WIN
+// ===================== ExecutableIconLoader 类实现 =====================
+QImage ExecutableIconLoader::load(const QString& exePath, const QSize& size) {
+    HW_TRACE_SCOPE("icon", "ExtractIconEx");
+    HICON large = nullptr;
+    HICON small = nullptr;
+    // 列表中的图标一般不超过 16px，小尺寸请求只取小图标，省去一次解码
+    const bool wantLarge = !size.isValid() || size.width() > 16 || size.height() > 16;
+    const UINT extracted = ExtractIconExW(reinterpret_cast<LPCWSTR>(exePath.utf16()), 0,
+        wantLarge ? &large : nullptr, wantLarge ? nullptr : &small, 1);
+    if (extracted == 0 || extracted == UINT_MAX) {
+        return QImage();
+    }
+    HICON icon = wantLarge ? large : small;
+    QImage image = icon ? QImage::fromHICON(icon) : QImage();
+    if (icon) {
+        DestroyIcon(icon);
+    }
+    return fitToSize(image, size);
+}
+
+std::unique_ptr<IconLoader> createDefaultIconLoader() {
+    return std::make_unique<ExecutableIconLoader>();
+}
+#endif
+
+#ifdef Q_OS_LINUX
+// ===================== ThemeIconLoader 类实现 =====================
+QImage ThemeIconLoader::load(const QString& exePath, const QSize& size) {
+    HW_TRACE_SCOPE("icon", "ThemeIconLoader::load");
+    const QString name = QFileInfo(exePath).fileName();
+    if (name.isEmpty()) {
+        return QImage();
+    }
+    // 先找与请求尺寸一致的主题图标，再退到常见尺寸与 pixmaps 目录
+    QStringList candidates;
+    if (size.isValid()) {
+        candidates << QString("/usr/share/icons/hicolor/%1x%2/apps/%3.png").arg(size.width()).arg(size.height()).arg(name);
+    }
+    candidates << QString("/usr/share/icons/hicolor/48x48/apps/%1.png").arg(name)
+               << QString("/usr/share/pixmaps/%1.png").arg(name);
+    for (const QString& candidate : std::as_const(candidates)) {
+        QImage image(candidate);
+        if (!image.isNull()) {
+            return fitToSize(image, size);
+        }
+    }
+    return QImage();
+}
+
+std::unique_ptr<IconLoader> createDefaultIconLoader() {
+    return std::make_unique<ThemeIconLoader>();
+}
+#endif
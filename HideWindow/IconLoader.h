@@ -0,0 +1,46 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+#ifndef ICONLOADER_H
+#define ICONLOADER_H
+#include <QImage>
+#include <QSize>
+#include <QString>
+#include <memory>
+
+// 图标解码接口：ProcessIconProvider 只依赖此接口，测试与基准可替换为合成实现
+// load() 在线程池的工作线程上并发调用，实现必须可重入且不得访问 GUI 对象
+class IconLoader {
+public:
+    virtual ~IconLoader() = default;
+    // 取可执行文件 exePath 的图标并缩放到 size；没有图标时返回空图像
+    virtual QImage load(const QString& exePath, const QSize& size) = 0;
+};
+
+#ifdef Q_OS_WIN
+// 通过 ExtractIconExW 读取可执行文件内嵌的第一个图标（不经过 Shell，工作线程无需初始化 COM）
+class ExecutableIconLoader : public IconLoader {
+public:
+    QImage load(const QString& exePath, const QSize& size) override;
+};
+#endif
+
+#ifdef Q_OS_LINUX
+// 可执行文件本身不带图标，按文件名在 hicolor 主题与 /usr/share/pixmaps 中查找同名 PNG
+class ThemeIconLoader : public IconLoader {
+public:
+    QImage load(const QString& exePath, const QSize& size) override;
+};
+#endif
+
+// 返回当前平台的默认图标解码器
+std::unique_ptr<IconLoader> createDefaultIconLoader();
+#endif
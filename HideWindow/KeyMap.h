@@ -0,0 +1,239 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+#ifndef KEYMAP_H
+#define KEYMAP_H
+// 平台无关的 Win32 虚拟键码 <-> Qt::Key 映射表，全部在编译期生成
+// 不包含 windows.h，虚拟键码取值与 WinUser.h 中的 VK_* 一致
+#include <QtCore/qnamespace.h>
+#include <array>
+#include <cstdint>
+
+namespace KeyMap {
+
+// 虚拟键码（与 WinUser.h 的 VK_* 取值相同）
+namespace Vk {
+constexpr std::uint8_t LButton = 0x01, RButton = 0x02, Cancel = 0x03, MButton = 0x04;
+constexpr std::uint8_t XButton1 = 0x05, XButton2 = 0x06;
+constexpr std::uint8_t Back = 0x08, Tab = 0x09, Clear = 0x0C, Return = 0x0D;
+constexpr std::uint8_t Shift = 0x10, Control = 0x11, Menu = 0x12, Pause = 0x13, Capital = 0x14;
+constexpr std::uint8_t Escape = 0x1B, Space = 0x20, Prior = 0x21, Next = 0x22, End = 0x23, Home = 0x24;
+constexpr std::uint8_t Left = 0x25, Up = 0x26, Right = 0x27, Down = 0x28;
+constexpr std::uint8_t Select = 0x29, Print = 0x2A, Execute = 0x2B, Snapshot = 0x2C;
+constexpr std::uint8_t Insert = 0x2D, Delete = 0x2E, Help = 0x2F;
+constexpr std::uint8_t Digit0 = 0x30, LetterA = 0x41;
+constexpr std::uint8_t LWin = 0x5B, RWin = 0x5C, Apps = 0x5D, Sleep = 0x5F;
+constexpr std::uint8_t Numpad0 = 0x60, Multiply = 0x6A, Add = 0x6B, Separator = 0x6C;
+constexpr std::uint8_t Subtract = 0x6D, Decimal = 0x6E, Divide = 0x6F;
+constexpr std::uint8_t F1 = 0x70;
+constexpr std::uint8_t NumLock = 0x90, Scroll = 0x91, OemFjMasshou = 0x93, OemFjTouroku = 0x94;
+constexpr std::uint8_t LShift = 0xA0, RShift = 0xA1, LControl = 0xA2, RControl = 0xA3, LMenu = 0xA4, RMenu = 0xA5;
+constexpr std::uint8_t BrowserBack = 0xA6, BrowserForward = 0xA7, BrowserRefresh = 0xA8, BrowserStop = 0xA9;
+constexpr std::uint8_t BrowserSearch = 0xAA, BrowserFavorites = 0xAB, BrowserHome = 0xAC;
+constexpr std::uint8_t VolumeMute = 0xAD, VolumeDown = 0xAE, VolumeUp = 0xAF;
+constexpr std::uint8_t MediaNextTrack = 0xB0, MediaPrevTrack = 0xB1, MediaStop = 0xB2, MediaPlayPause = 0xB3;
+constexpr std::uint8_t LaunchMail = 0xB4, LaunchMediaSelect = 0xB5, LaunchApp1 = 0xB6, LaunchApp2 = 0xB7;
+constexpr std::uint8_t Play = 0xFA, Zoom = 0xFB;
+} // namespace Vk
+
+namespace detail {
+struct KeyPair {
+    Qt::Key qtKey;
+    std::uint8_t vk;
+};
+
+constexpr std::array<Qt::Key, 256> buildVkToQt() {
+    std::array<Qt::Key, 256> table{};
+    for (auto& key : table) {
+        key = Qt::Key_unknown; // 鼠标按键、未映射键均为 unknown
+    }
+
+    // 基础功能键
+    table[Vk::Cancel] = Qt::Key_Cancel;
+    table[Vk::Back] = Qt::Key_Backspace;
+    table[Vk::Tab] = Qt::Key_Tab;
+    table[Vk::Clear] = Qt::Key_Clear;
+    table[Vk::Return] = Qt::Key_Return;
+    table[Vk::Shift] = Qt::Key_Shift;
+    table[Vk::Control] = Qt::Key_Control;
+    table[Vk::Menu] = Qt::Key_Alt;
+    table[Vk::Pause] = Qt::Key_Pause;
+    table[Vk::Capital] = Qt::Key_CapsLock;
+    table[Vk::Escape] = Qt::Key_Escape;
+    table[Vk::Space] = Qt::Key_Space;
+    table[Vk::Prior] = Qt::Key_PageUp;
+    table[Vk::Next] = Qt::Key_PageDown;
+    table[Vk::End] = Qt::Key_End;
+    table[Vk::Home] = Qt::Key_Home;
+    table[Vk::Left] = Qt::Key_Left;
+    table[Vk::Up] = Qt::Key_Up;
+    table[Vk::Right] = Qt::Key_Right;
+    table[Vk::Down] = Qt::Key_Down;
+    table[Vk::Select] = Qt::Key_Select;
+    table[Vk::Print] = Qt::Key_Printer;
+    table[Vk::Execute] = Qt::Key_Execute;
+    table[Vk::Snapshot] = Qt::Key_Print;
+    table[Vk::Insert] = Qt::Key_Insert;
+    table[Vk::Delete] = Qt::Key_Delete;
+    table[Vk::Help] = Qt::Key_Help;
+
+    // 主键盘数字 0-9、字母 A-Z（Qt::Key 与 ASCII 码一致）
+    for (int i = 0; i < 10; ++i) {
+        table[Vk::Digit0 + i] = static_cast<Qt::Key>(Qt::Key_0 + i);
+    }
+    for (int i = 0; i < 26; ++i) {
+        table[Vk::LetterA + i] = static_cast<Qt::Key>(Qt::Key_A + i);
+    }
+
+    // Windows键/应用键
+    table[Vk::LWin] = Qt::Key_Meta;
+    table[Vk::RWin] = Qt::Key_Meta;
+    table[Vk::Apps] = Qt::Key_Menu;
+    table[Vk::Sleep] = Qt::Key_Sleep;
+
+    // 小键盘
+    for (int i = 0; i < 10; ++i) {
+        table[Vk::Numpad0 + i] = static_cast<Qt::Key>(Qt::Key_0 + i);
+    }
+    table[Vk::Multiply] = Qt::Key_Asterisk;
+    table[Vk::Add] = Qt::Key_Plus;
+    table[Vk::Subtract] = Qt::Key_Minus;
+    table[Vk::Divide] = Qt::Key_Slash;
+
+    // 功能键F1-F24
+    for (int i = 0; i < 24; ++i) {
+        table[Vk::F1 + i] = static_cast<Qt::Key>(Qt::Key_F1 + i);
+    }
+
+    // 数字锁定/滚动锁定
+    table[Vk::NumLock] = Qt::Key_NumLock;
+    table[Vk::Scroll] = Qt::Key_ScrollLock;
+
+    // 日文/特殊键盘
+    table[Vk::OemFjMasshou] = Qt::Key_Massyo;
+    table[Vk::OemFjTouroku] = Qt::Key_Touroku;
+
+    // 左右修饰键（和主键值一致）
+    table[Vk::LShift] = Qt::Key_Shift;
+    table[Vk::RShift] = Qt::Key_Shift;
+    table[Vk::LControl] = Qt::Key_Control;
+    table[Vk::RControl] = Qt::Key_Control;
+    table[Vk::LMenu] = Qt::Key_Alt;
+    table[Vk::RMenu] = Qt::Key_Alt;
+
+    // 浏览器/多媒体键
+    table[Vk::BrowserBack] = Qt::Key_Back;
+    table[Vk::BrowserForward] = Qt::Key_Forward;
+    table[Vk::BrowserRefresh] = Qt::Key_Refresh;
+    table[Vk::BrowserStop] = Qt::Key_Stop;
+    table[Vk::BrowserSearch] = Qt::Key_Search;
+    table[Vk::BrowserFavorites] = Qt::Key_Favorites;
+    table[Vk::BrowserHome] = Qt::Key_HomePage;
+    table[Vk::VolumeMute] = Qt::Key_VolumeMute;
+    table[Vk::VolumeDown] = Qt::Key_VolumeDown;
+    table[Vk::VolumeUp] = Qt::Key_VolumeUp;
+    table[Vk::MediaNextTrack] = Qt::Key_MediaNext;
+    table[Vk::MediaPrevTrack] = Qt::Key_MediaPrevious;
+    table[Vk::MediaStop] = Qt::Key_MediaStop;
+    table[Vk::MediaPlayPause] = Qt::Key_MediaTogglePlayPause;
+    table[Vk::LaunchMail] = Qt::Key_LaunchMail;
+    table[Vk::LaunchMediaSelect] = Qt::Key_LaunchMedia;
+    table[Vk::LaunchApp1] = Qt::Key_Launch0;
+    table[Vk::LaunchApp2] = Qt::Key_Launch1;
+
+    // 其他多媒体键
+    table[Vk::Play] = Qt::Key_Play;
+    table[Vk::Zoom] = Qt::Key_Zoom;
+    return table;
+}
+
+constexpr std::array<Qt::Key, 256> kVkToQt = buildVkToQt();
+
+constexpr std::size_t countMapped() {
+    std::size_t count = 0;
+    for (Qt::Key key : kVkToQt) {
+        if (key != Qt::Key_unknown) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+// 反向表：按 Qt::Key 排序，多个虚拟键映射到同一 Qt::Key 时保留码值最小的一个
+// （例如 Key_0 对应主键盘 0x30 而不是小键盘，Key_Shift 对应 VK_SHIFT 而不是 VK_LSHIFT）
+template <std::size_t N>
+constexpr std::array<KeyPair, N> buildQtToVk() {
+    std::array<KeyPair, N> pairs{};
+    std::size_t n = 0;
+    for (int vk = 0; vk < 256; ++vk) {
+        const Qt::Key key = kVkToQt[vk];
+        if (key == Qt::Key_unknown) {
+            continue;
+        }
+        // 插入排序；相等键不插入，从而保留先出现（码值更小）的虚拟键
+        std::size_t pos = n;
+        bool duplicate = false;
+        while (pos > 0 && pairs[pos - 1].qtKey >= key) {
+            if (pairs[pos - 1].qtKey == key) {
+                duplicate = true;
+                break;
+            }
+            --pos;
+        }
+        if (duplicate) {
+            continue;
+        }
+        for (std::size_t i = n; i > pos; --i) {
+            pairs[i] = pairs[i - 1];
+        }
+        pairs[pos] = { key, static_cast<std::uint8_t>(vk) };
+        ++n;
+    }
+    // 重复项留下的尾部空位填充 Key_unknown（其值大于所有有效键），保持有序
+    for (std::size_t i = n; i < N; ++i) {
+        pairs[i] = { Qt::Key_unknown, 0 };
+    }
+    return pairs;
+}
+
+constexpr auto kQtToVk = buildQtToVk<countMapped()>();
+} // namespace detail
+
+// 虚拟键码 -> Qt::Key，一次数组访问，可在键盘钩子回调中直接使用
+constexpr Qt::Key qtKeyFromVk(std::uint32_t vk) {
+    return vk < 256 ? detail::kVkToQt[vk] : Qt::Key_unknown;
+}
+
+// Qt::Key -> 虚拟键码（二分查找，仅用于配置阶段），未映射返回 0
+constexpr std::uint8_t vkFromQtKey(Qt::Key key) {
+    std::size_t lo = 0;
+    std::size_t hi = detail::kQtToVk.size();
+    while (lo < hi) {
+        const std::size_t mid = (lo + hi) / 2;
+        if (detail::kQtToVk[mid].qtKey < key) {
+            lo = mid + 1;
+        }
+        else {
+            hi = mid;
+        }
+    }
+    return lo < detail::kQtToVk.size() && detail::kQtToVk[lo].qtKey == key ? detail::kQtToVk[lo].vk : 0;
+}
+
+static_assert(qtKeyFromVk(0x41) == Qt::Key_A, "letter mapping");
+static_assert(qtKeyFromVk(Vk::Numpad0 + 5) == Qt::Key_5, "numpad mapping");
+static_assert(qtKeyFromVk(Vk::LButton) == Qt::Key_unknown, "mouse buttons are not keys");
+static_assert(vkFromQtKey(Qt::Key_0) == Vk::Digit0, "reverse prefers main keyboard digits");
+static_assert(vkFromQtKey(Qt::Key_Shift) == Vk::Shift, "reverse prefers generic modifiers");
+static_assert(vkFromQtKey(Qt::Key_unknown) == 0, "unknown has no virtual key");
+
+} // namespace KeyMap
+#endif
@@ -0,0 +1,122 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "KeyStateTracker.h"
+
+// ===================== KeyStateTracker 类实现 =====================
+KeyStateTracker::KeyStateTracker() {
+    reset();
+}
+
+void KeyStateTracker::setSuppressRepeats(bool suppress) {
+    m_suppressRepeats.store(suppress, std::memory_order_relaxed);
+}
+
+bool KeyStateTracker::suppressRepeats() const {
+    return m_suppressRepeats.load(std::memory_order_relaxed);
+}
+
+void KeyStateTracker::setDebounceInterval(quint64 intervalNs) {
+    m_debounceNs.store(intervalNs, std::memory_order_relaxed);
+}
+
+quint64 KeyStateTracker::debounceInterval() const {
+    return m_debounceNs.load(std::memory_order_relaxed);
+}
+
+void KeyStateTracker::setFireOnRelease(bool onRelease) {
+    m_fireOnRelease.store(onRelease, std::memory_order_relaxed);
+}
+
+bool KeyStateTracker::fireOnRelease() const {
+    return m_fireOnRelease.load(std::memory_order_relaxed);
+}
+
+void KeyStateTracker::reset() {
+    for (std::uint64_t& word : m_down) {
+        word = 0;
+    }
+    for (int i = 0; i < 256; ++i) {
+        m_lastFire[i] = 0;
+        m_armed[i] = kNotArmed;
+    }
+}
+
+bool KeyStateTracker::isDown(quint32 vk) const {
+    return vk < 256 && (m_down[vk >> 6] & (1ull << (vk & 63))) != 0;
+}
+
+KeyStateTracker::Transition KeyStateTracker::update(quint32 vk, bool keyDown) {
+    if (vk >= 256) {
+        return keyDown ? Transition::Press : Transition::StrayRelease;
+    }
+    std::uint64_t& word = m_down[vk >> 6];
+    const std::uint64_t bit = 1ull << (vk & 63);
+
+    if (keyDown) {
+        if (word & bit) {
+            if (suppressRepeats()) {
+                m_suppressedRepeats.fetch_add(1, std::memory_order_relaxed);
+            }
+            return Transition::Repeat;
+        }
+        word |= bit;
+        return Transition::Press;
+    }
+
+    if (!(word & bit)) {
+        return Transition::StrayRelease;
+    }
+    word &= ~bit;
+    return Transition::Release;
+}
+
+bool KeyStateTracker::passDebounce(quint32 vk, quint64 timestamp) {
+    const quint64 interval = debounceInterval();
+    if (interval != 0 && m_lastFire[vk] != 0 && timestamp - m_lastFire[vk] < interval) {
+        m_suppressedBounces.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    m_lastFire[vk] = timestamp;
+    m_fired.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool KeyStateTracker::trigger(quint32 vk, qint32 payload, quint64 timestamp) {
+    if (vk >= 256) {
+        return false;
+    }
+    if (fireOnRelease()) {
+        m_armed[vk] = payload;
+        return false;
+    }
+    return passDebounce(vk, timestamp);
+}
+
+bool KeyStateTracker::release(quint32 vk, quint64 timestamp, qint32& payload) {
+    if (vk >= 256 || m_armed[vk] == kNotArmed) {
+        return false;
+    }
+    payload = m_armed[vk];
+    m_armed[vk] = kNotArmed;
+    return passDebounce(vk, timestamp);
+}
+
+quint64 KeyStateTracker::suppressedRepeats() const {
+    return m_suppressedRepeats.load(std::memory_order_relaxed);
+}
+
+quint64 KeyStateTracker::suppressedBounces() const {
+    return m_suppressedBounces.load(std::memory_order_relaxed);
+}
+
+quint64 KeyStateTracker::firedCount() const {
+    return m_fired.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,77 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+#ifndef KEYSTATETRACKER_H
+#define KEYSTATETRACKER_H
+// 平台无关的按键状态跟踪：合并自动重复、去抖、可选抬起时触发
+#include <QtGlobal>
+#include <atomic>
+#include <cstdint>
+
+// 按住按键时系统会连续发送按下事件（自动重复）；本类按虚拟键码记录按下/抬起状态，
+// 决定一次触发应在何时发出。所有状态为定长数组，钩子回调中调用不分配内存。
+// update()/trigger()/release() 仅由钩子线程调用；选项与计数可从任意线程读写。
+class KeyStateTracker {
+public:
+    enum class Transition {
+        Press,        // 首次按下
+        Repeat,       // 已按下时再次收到按下（自动重复）
+        Release,      // 抬起
+        StrayRelease  // 没有对应按下的抬起（例如钩子安装前已按下）
+    };
+
+    KeyStateTracker();
+
+    // 自动重复是否被丢弃（默认丢弃）
+    void setSuppressRepeats(bool suppress);
+    bool suppressRepeats() const;
+    // 同一按键两次触发之间的最短间隔（纳秒），0 表示不去抖
+    void setDebounceInterval(quint64 intervalNs);
+    quint64 debounceInterval() const;
+    // 为 true 时触发推迟到按键抬起
+    void setFireOnRelease(bool onRelease);
+    bool fireOnRelease() const;
+
+    // 记录一次按下/抬起；被丢弃的自动重复计入 suppressedRepeats
+    Transition update(quint32 vk, bool keyDown);
+    bool isDown(quint32 vk) const;
+
+    // 按下时匹配到触发（payload 为调用者自定义的标识）；返回 true 表示应立即触发，
+    // 抬起时触发模式下只记录 payload 并返回 false
+    bool trigger(quint32 vk, qint32 payload, quint64 timestamp);
+    // 抬起时取出之前记录的 payload；返回 true 表示应触发
+    bool release(quint32 vk, quint64 timestamp, qint32& payload);
+
+    // 丢弃所有按键状态（例如钩子重新安装后）
+    void reset();
+
+    quint64 suppressedRepeats() const;
+    quint64 suppressedBounces() const;
+    quint64 firedCount() const;
+
+private:
+    bool passDebounce(quint32 vk, quint64 timestamp);
+
+    static constexpr qint32 kNotArmed = INT32_MIN;
+
+    std::atomic<bool> m_suppressRepeats{ true };
+    std::atomic<bool> m_fireOnRelease{ false };
+    std::atomic<quint64> m_debounceNs{ 0 };
+
+    std::uint64_t m_down[4] = {};  // 每个虚拟键码一位
+    quint64 m_lastFire[256];       // 上次触发时间，0 表示从未触发
+    qint32 m_armed[256];           // 抬起时触发的 payload
+
+    std::atomic<quint64> m_suppressedRepeats{ 0 };
+    std::atomic<quint64> m_suppressedBounces{ 0 };
+    std::atomic<quint64> m_fired{ 0 };
+};
+#endif
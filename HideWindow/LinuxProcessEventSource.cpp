@@ -0,0 +1,213 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "ProcessEventSource.h"
+#include "Trace.h"
+#include <QDebug>
+
+#ifdef Q_OS_LINUX
+#include <cerrno>
+#include <cstring>
+#include <linux/cn_proc.h>
+#include <linux/connector.h>
+#include <linux/netlink.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+constexpr std::size_t kReceiveBufferSize = 16 * 1024;
+// netlink 不可用时轮询 /proc 的间隔
+constexpr int kPollingIntervalMs = 500;
+
+std::unique_ptr<ProcessEventSource> createPollingSource() {
+    return std::make_unique<PollingProcessEventSource>(std::make_unique<LinuxProcessSource>(), kPollingIntervalMs);
+}
+} // namespace
+
+// ===================== NetlinkProcessEventSource 类实现 =====================
+std::unique_ptr<NetlinkProcessEventSource> NetlinkProcessEventSource::create() {
+    const int fd = socket(PF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_CONNECTOR);
+    if (fd < 0) {
+        qInfo() << "Process connector unavailable. Error:" << errno;
+        return nullptr;
+    }
+    sockaddr_nl address = {};
+    address.nl_family = AF_NETLINK;
+    address.nl_groups = CN_IDX_PROC;
+    address.nl_pid = 0; // 由内核分配
+    // 订阅进程连接器的多播组需要 CAP_NET_ADMIN，普通用户在这里得到 EPERM
+    if (bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0) {
+        qInfo() << "Process connector requires CAP_NET_ADMIN, falling back to polling. Error:" << errno;
+        close(fd);
+        return nullptr;
+    }
+    // 事件突发时给内核留出更大的接收缓冲，减少 ENOBUFS
+    const int receiveBuffer = 1024 * 1024;
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &receiveBuffer, sizeof(receiveBuffer));
+    return std::unique_ptr<NetlinkProcessEventSource>(new NetlinkProcessEventSource(fd));
+}
+
+NetlinkProcessEventSource::NetlinkProcessEventSource(int socket)
+    : m_socket(socket)
+    , m_stopFd(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK))
+{
+}
+
+NetlinkProcessEventSource::~NetlinkProcessEventSource() {
+    stop();
+    if (m_stopFd >= 0) {
+        close(m_stopFd);
+    }
+    if (m_socket >= 0) {
+        close(m_socket);
+    }
+}
+
+std::unique_ptr<ProcessEventSource> NetlinkProcessEventSource::createFallback() const {
+    return createPollingSource();
+}
+
+bool NetlinkProcessEventSource::subscribe(bool enable) {
+    // nlmsghdr + cn_msg + 操作码，按内核要求连续排列（cn_msg 以柔性数组结尾，只能手工布局）
+    constexpr std::size_t kLength = NLMSG_LENGTH(sizeof(cn_msg) + sizeof(proc_cn_mcast_op));
+    alignas(nlmsghdr) char buffer[NLMSG_SPACE(sizeof(cn_msg) + sizeof(proc_cn_mcast_op))] = {};
+    auto* header = reinterpret_cast<nlmsghdr*>(buffer);
+    header->nlmsg_len = kLength;
+    header->nlmsg_type = NLMSG_DONE;
+    header->nlmsg_pid = static_cast<__u32>(getpid());
+    auto* message = static_cast<cn_msg*>(NLMSG_DATA(header));
+    message->id.idx = CN_IDX_PROC;
+    message->id.val = CN_VAL_PROC;
+    message->len = sizeof(proc_cn_mcast_op);
+    const proc_cn_mcast_op op = enable ? PROC_CN_MCAST_LISTEN : PROC_CN_MCAST_IGNORE;
+    std::memcpy(message->data, &op, sizeof(op));
+    return send(m_socket, buffer, kLength, 0) == static_cast<ssize_t>(kLength);
+}
+
+bool NetlinkProcessEventSource::startWatching() {
+    if (m_stopFd < 0 || !subscribe(true)) {
+        qWarning() << "Failed to subscribe to process events. Error:" << errno;
+        return false;
+    }
+    m_thread = QThread::create([this] { run(); });
+    m_thread->setObjectName(QStringLiteral("ProcessEvents"));
+    m_thread->start();
+    return true;
+}
+
+void NetlinkProcessEventSource::stopWatching() {
+    if (!m_thread) {
+        return;
+    }
+    const quint64 one = 1;
+    if (write(m_stopFd, &one, sizeof(one)) < 0) {
+        qWarning() << "Failed to wake process event thread. Error:" << errno;
+    }
+    m_thread->wait();
+    delete m_thread;
+    m_thread = nullptr;
+    quint64 value = 0;
+    if (read(m_stopFd, &value, sizeof(value)) < 0 && errno != EAGAIN) {
+        qWarning() << "Failed to reset process event stop flag. Error:" << errno;
+    }
+    subscribe(false);
+}
+
+void NetlinkProcessEventSource::run() {
+    alignas(nlmsghdr) char buffer[kReceiveBufferSize];
+    pollfd fds[2] = {
+        { m_socket, POLLIN, 0 },
+        { m_stopFd, POLLIN, 0 }
+    };
+    for (;;) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            qWarning() << "poll on process connector failed. Error:" << errno;
+            return;
+        }
+        if (fds[1].revents) {
+            return;
+        }
+        // 一次唤醒读空套接字，突发事件合并为少数几次通知
+        for (;;) {
+            const ssize_t length = recv(m_socket, buffer, sizeof(buffer), MSG_DONTWAIT);
+            if (length < 0) {
+                if (errno == ENOBUFS) {
+                    // 内核缓冲溢出，事件已经丢失，只能整体校准
+                    postOverflow();
+                    continue;
+                }
+                if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                    qWarning() << "recv on process connector failed. Error:" << errno;
+                }
+                break;
+            }
+            handleMessage(buffer, static_cast<std::size_t>(length));
+        }
+    }
+}
+
+void NetlinkProcessEventSource::handleMessage(const char* data, std::size_t length) {
+    HW_TRACE_SCOPE("process", "NetlinkProcessEventSource::handleMessage");
+    int remaining = static_cast<int>(length);
+    for (auto* header = reinterpret_cast<const nlmsghdr*>(data); NLMSG_OK(header, remaining);
+        header = NLMSG_NEXT(header, remaining)) {
+        if (header->nlmsg_type == NLMSG_ERROR || header->nlmsg_type == NLMSG_NOOP) {
+            continue;
+        }
+        const auto* message = static_cast<const cn_msg*>(NLMSG_DATA(header));
+        if (message->id.idx != CN_IDX_PROC || message->id.val != CN_VAL_PROC) {
+            continue;
+        }
+        const auto* event = reinterpret_cast<const proc_event*>(message->data);
+        ProcessEvent out;
+        switch (event->what) {
+        case proc_event::PROC_EVENT_FORK:
+            // 只关心新进程，新线程（child_pid != child_tgid）忽略
+            if (event->event_data.fork.child_pid != event->event_data.fork.child_tgid) {
+                continue;
+            }
+            out.kind = ProcessEvent::Started;
+            if (!m_reader.query(event->event_data.fork.child_tgid, out.entry)) {
+                continue; // 已经退出
+            }
+            break;
+        case proc_event::PROC_EVENT_EXEC:
+            // exec 之后可执行文件与名称都变了，按同一 PID 更新
+            out.kind = ProcessEvent::Started;
+            if (!m_reader.query(event->event_data.exec.process_tgid, out.entry)) {
+                continue;
+            }
+            break;
+        case proc_event::PROC_EVENT_EXIT:
+            if (event->event_data.exit.process_pid != event->event_data.exit.process_tgid) {
+                continue;
+            }
+            out.kind = ProcessEvent::Exited;
+            out.entry.pid = event->event_data.exit.process_tgid;
+            break;
+        default:
+            continue;
+        }
+        post(out);
+    }
+}
+
+std::unique_ptr<ProcessEventSource> createDefaultProcessEventSource() {
+    if (auto netlink = NetlinkProcessEventSource::create()) {
+        return netlink;
+    }
+    return createPollingSource();
+}
+#endif
@@ -0,0 +1,233 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "ProcessSource.h"
+#include "Trace.h"
+#include <QDebug>
+
+#ifdef Q_OS_LINUX
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+// getdents64 返回的目录项布局（glibc 未导出该结构体）
+struct LinuxDirent64 {
+    quint64 d_ino;
+    qint64 d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[1];
+};
+
+constexpr size_t kDirBufferSize = 64 * 1024;
+constexpr size_t kFileBufferSize = 4096;
+
+// 一次 read 读完小文件，返回读取的字节数，失败返回 -1
+ssize_t readSmallFile(int dirFd, const char* path, char* buffer, size_t size) {
+    const int fd = openat(dirFd, path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+    const ssize_t length = read(fd, buffer, size - 1);
+    close(fd);
+    if (length >= 0) {
+        buffer[length] = '\0';
+    }
+    return length;
+}
+} // namespace
+
+// ===================== /proc 解析 =====================
+namespace LinuxProcfs {
+
+bool parsePid(const char* name, qint64& pid) {
+    if (*name < '1' || *name > '9') {
+        return false;
+    }
+    qint64 value = 0;
+    for (; *name; ++name) {
+        if (*name < '0' || *name > '9') {
+            return false;
+        }
+        value = value * 10 + (*name - '0');
+    }
+    pid = value;
+    return true;
+}
+
+bool parseStat(const char* stat, ProcessEntry& entry) {
+    const char* commBegin = std::strchr(stat, '(');
+    const char* commEnd = std::strrchr(stat, ')');
+    if (!commBegin || !commEnd || commEnd < commBegin) {
+        return false;
+    }
+    entry.name = QString::fromUtf8(commBegin + 1, static_cast<int>(commEnd - commBegin - 1));
+
+    // ')' 之后依次为第 3 个字段（state）起的各字段，starttime 为第 22 个字段
+    const char* cursor = commEnd + 1;
+    for (int field = 3; field <= 22; ++field) {
+        while (*cursor == ' ') {
+            ++cursor;
+        }
+        if (*cursor == '\0') {
+            return false;
+        }
+        if (field == 4) {
+            entry.parentPid = std::strtoll(cursor, nullptr, 10);
+        }
+        else if (field == 22) {
+            entry.startTime = std::strtoull(cursor, nullptr, 10);
+            return true;
+        }
+        while (*cursor != ' ' && *cursor != '\0') {
+            ++cursor;
+        }
+    }
+    return false;
+}
+
+qint64 exeLinkLength(const char* target, qint64 length, qint64 capacity) {
+    // readlinkat 不写结尾 '\0'，填满缓冲区时无法区分恰好放下与被截断
+    if (length <= 0 || length >= capacity) {
+        return -1;
+    }
+    static const char kDeleted[] = " (deleted)";
+    constexpr qint64 kDeletedLength = sizeof(kDeleted) - 1;
+    if (length > kDeletedLength && std::memcmp(target + length - kDeletedLength, kDeleted, kDeletedLength) == 0) {
+        length -= kDeletedLength;
+    }
+    return length;
+}
+
+} // namespace LinuxProcfs
+
+// ===================== LinuxProcessSource 类实现 =====================
+LinuxProcessSource::LinuxProcessSource()
+    : m_procFd(open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC))
+    , m_dirBuffer(kDirBufferSize)
+    , m_fileBuffer(kFileBufferSize)
+{
+    if (m_procFd < 0) {
+        qWarning() << "Failed to open /proc. Error:" << errno;
+    }
+}
+
+LinuxProcessSource::~LinuxProcessSource() {
+    if (m_procFd >= 0) {
+        close(m_procFd);
+    }
+}
+
+template <typename Fn>
+bool LinuxProcessSource::forEachPidDirectory(Fn fn) {
+    if (m_procFd < 0) {
+        return false;
+    }
+    // 复用常驻的 /proc 描述符，每次遍历前回到目录开头
+    if (lseek(m_procFd, 0, SEEK_SET) < 0) {
+        qWarning() << "Failed to rewind /proc. Error:" << errno;
+        return false;
+    }
+    for (;;) {
+        // 一次系统调用批量读取多个目录项
+        const long bytes = syscall(SYS_getdents64, m_procFd, m_dirBuffer.data(), m_dirBuffer.size());
+        if (bytes < 0) {
+            qWarning() << "getdents64 on /proc failed. Error:" << errno;
+            return false;
+        }
+        if (bytes == 0) {
+            return true;
+        }
+
+        for (long offset = 0; offset < bytes;) {
+            const auto* dirent = reinterpret_cast<const LinuxDirent64*>(m_dirBuffer.data() + offset);
+            offset += dirent->d_reclen;
+
+            qint64 pid = 0;
+            if (dirent->d_type != DT_DIR || !LinuxProcfs::parsePid(dirent->d_name, pid)) {
+                continue;
+            }
+            if (!fn(dirent->d_name, pid)) {
+                return false;
+            }
+        }
+    }
+}
+
+bool LinuxProcessSource::readEntry(const char* pidName, ProcessEntry& entry) {
+    char path[64];
+    char* buffer = m_fileBuffer.data();
+
+    // 相对常驻的 /proc 描述符访问，不为每个 PID 目录持有描述符
+    std::snprintf(path, sizeof(path), "%s/stat", pidName);
+    if (readSmallFile(m_procFd, path, buffer, m_fileBuffer.size()) <= 0 || !LinuxProcfs::parseStat(buffer, entry)) {
+        return false; // 进程已退出
+    }
+
+    // 无权限、内核线程或路径过长时没有 exePath，名称沿用 comm
+    std::snprintf(path, sizeof(path), "%s/exe", pidName);
+    const qint64 length = LinuxProcfs::exeLinkLength(buffer,
+        readlinkat(m_procFd, path, buffer, m_fileBuffer.size()), static_cast<qint64>(m_fileBuffer.size()));
+    if (length > 0) {
+        entry.exePath = QString::fromLocal8Bit(buffer, static_cast<int>(length));
+        const char* slash = static_cast<const char*>(memrchr(buffer, '/', static_cast<size_t>(length)));
+        if (slash) {
+            // exe 名称不受 comm 的 15 字节截断限制
+            entry.name = QString::fromLocal8Bit(slash + 1, static_cast<int>(buffer + length - slash - 1));
+        }
+    }
+    return true;
+}
+
+bool LinuxProcessSource::snapshot(QList<ProcessEntry>& out, const std::atomic<bool>& cancelled) {
+    HW_TRACE_SCOPE("process", "LinuxProcessSource::snapshot");
+    out.clear();
+    return forEachPidDirectory([&](const char* name, qint64 pid) {
+        if (cancelled.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        ProcessEntry entry;
+        entry.pid = pid;
+        if (readEntry(name, entry)) {
+            out.append(entry);
+        }
+        return true;
+    });
+}
+
+bool LinuxProcessSource::listPids(std::vector<qint64>& out) {
+    out.clear();
+    return forEachPidDirectory([&](const char*, qint64 pid) {
+        out.push_back(pid);
+        return true;
+    });
+}
+
+bool LinuxProcessSource::query(qint64 pid, ProcessEntry& entry) {
+    if (m_procFd < 0 || pid <= 0) {
+        return false;
+    }
+    char name[32];
+    std::snprintf(name, sizeof(name), "%lld", static_cast<long long>(pid));
+    entry = ProcessEntry();
+    entry.pid = pid;
+    return readEntry(name, entry);
+}
+
+std::unique_ptr<ProcessSource> createDefaultProcessSource() {
+    return std::make_unique<LinuxProcessSource>();
+}
+#endif
@@ -0,0 +1,122 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "ProcessStats.h"
+#include "Trace.h"
+#include <QDebug>
+
+#ifdef Q_OS_LINUX
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+constexpr size_t kStatBufferSize = 1024;
+
+// 跳过一个以空格结尾的字段，返回下一个字段的起点；到达结尾时返回 nullptr
+const char* nextField(const char* cursor) {
+    while (*cursor != ' ' && *cursor != '\0') {
+        ++cursor;
+    }
+    while (*cursor == ' ') {
+        ++cursor;
+    }
+    return *cursor == '\0' ? nullptr : cursor;
+}
+
+// 从 /proc/[pid]/stat 中取出 utime(14)、stime(15)、starttime(22) 与 rss(24)。
+// comm 可能包含空格和括号，因此从最后一个 ')' 之后的第 3 个字段开始计数
+bool parseCounters(const char* stat, quint64& ticks, quint64& startTime, quint64& rssPages) {
+    const char* cursor = std::strrchr(stat, ')');
+    if (!cursor || cursor[1] != ' ') {
+        return false;
+    }
+    cursor += 2;
+    for (int field = 3; field <= 24 && cursor; ++field, cursor = nextField(cursor)) {
+        switch (field) {
+        case 14:
+            ticks = std::strtoull(cursor, nullptr, 10);
+            break;
+        case 15:
+            ticks += std::strtoull(cursor, nullptr, 10);
+            break;
+        case 22:
+            startTime = std::strtoull(cursor, nullptr, 10);
+            break;
+        case 24:
+            rssPages = std::strtoull(cursor, nullptr, 10);
+            return true;
+        default:
+            break;
+        }
+    }
+    return false;
+}
+} // namespace
+
+// ===================== LinuxProcessStatsSource 类实现 =====================
+LinuxProcessStatsSource::LinuxProcessStatsSource()
+    : m_procFd(open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC))
+    , m_nsPerTick(1000000000ull / static_cast<quint64>(qMax(1L, sysconf(_SC_CLK_TCK))))
+    , m_pageSize(static_cast<quint64>(qMax(1L, sysconf(_SC_PAGESIZE))))
+    , m_buffer(kStatBufferSize)
+{
+    if (m_procFd < 0) {
+        qWarning() << "Failed to open /proc. Error:" << errno;
+    }
+}
+
+LinuxProcessStatsSource::~LinuxProcessStatsSource() {
+    if (m_procFd >= 0) {
+        close(m_procFd);
+    }
+}
+
+void LinuxProcessStatsSource::sample(const std::vector<ProcessKey>& keys, std::vector<ProcessCounters>& out) {
+    HW_TRACE_SCOPE("process", "LinuxProcessStatsSource::sample");
+    out.assign(keys.size(), ProcessCounters());
+    if (m_procFd < 0) {
+        return;
+    }
+    char path[32];
+    char* buffer = m_buffer.data();
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        std::snprintf(path, sizeof(path), "%lld/stat", static_cast<long long>(keys[i].pid));
+        const int fd = openat(m_procFd, path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            continue; // 进程已退出
+        }
+        const ssize_t length = read(fd, buffer, m_buffer.size() - 1);
+        close(fd);
+        if (length <= 0) {
+            continue;
+        }
+        buffer[length] = '\0';
+
+        quint64 ticks = 0;
+        quint64 startTime = 0;
+        quint64 rssPages = 0;
+        // starttime 与快照中的创建时间同源，不一致说明 PID 已被复用
+        if (!parseCounters(buffer, ticks, startTime, rssPages) || startTime != keys[i].startTime) {
+            continue;
+        }
+        out[i].cpuTime = ticks * m_nsPerTick;
+        out[i].workingSet = rssPages * m_pageSize;
+        out[i].valid = true;
+    }
+}
+
+std::unique_ptr<ProcessStatsSource> createDefaultProcessStatsSource() {
+    return std::make_unique<LinuxProcessStatsSource>();
+}
+#endif
@@ -0,0 +1,241 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "Metrics.h"
+#include <QTextStream>
+
+namespace Metrics {
+
+namespace {
+std::atomic<int> s_nextShard{ 0 };
+
+double toMicroseconds(quint64 ns) {
+    return static_cast<double>(ns) / 1000.0;
+}
+
+void writeHistogram(QTextStream& out, const LatencyHistogram& histogram) {
+    const HistogramSnapshot s = histogram.snapshot();
+    out << histogram.name()
+        << " count=" << s.count
+        << " mean_us=" << QString::number(toMicroseconds(static_cast<quint64>(s.mean())), 'f', 3)
+        << " p50_us=" << QString::number(toMicroseconds(s.percentile(0.50)), 'f', 3)
+        << " p90_us=" << QString::number(toMicroseconds(s.percentile(0.90)), 'f', 3)
+        << " p99_us=" << QString::number(toMicroseconds(s.percentile(0.99)), 'f', 3)
+        << " p999_us=" << QString::number(toMicroseconds(s.percentile(0.999)), 'f', 3)
+        << " max_us=" << QString::number(toMicroseconds(s.max()), 'f', 3)
+        << "\n";
+}
+
+void writeCounter(QTextStream& out, const Counter& counter) {
+    out << counter.name() << " " << counter.value() << "\n";
+}
+} // namespace
+
+int currentShard() {
+    thread_local const int shard = s_nextShard.fetch_add(1, std::memory_order_relaxed) % kShardCount;
+    return shard;
+}
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+// ===================== HistogramSnapshot 实现 =====================
+double HistogramSnapshot::mean() const {
+    return count ? static_cast<double>(sum) / static_cast<double>(count) : 0.0;
+}
+
+quint64 HistogramSnapshot::percentile(double q) const {
+    if (count == 0) {
+        return 0;
+    }
+    // 排名向上取整，q = 1 时即最大值所在桶
+    const quint64 rank = qMax<quint64>(1, static_cast<quint64>(q * static_cast<double>(count) + 0.999999));
+    quint64 seen = 0;
+    for (int i = 0; i < static_cast<int>(buckets.size()); ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            return LatencyHistogram::bucketUpperBound(i);
+        }
+    }
+    return LatencyHistogram::bucketUpperBound(static_cast<int>(buckets.size()) - 1);
+}
+
+quint64 HistogramSnapshot::max() const {
+    for (int i = static_cast<int>(buckets.size()) - 1; i >= 0; --i) {
+        if (buckets[i]) {
+            return LatencyHistogram::bucketUpperBound(i);
+        }
+    }
+    return 0;
+}
+
+// ===================== LatencyHistogram 类实现 =====================
+LatencyHistogram::Shard::Shard() {
+    for (std::atomic<quint64>& bucket : buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+LatencyHistogram::LatencyHistogram(const char* name)
+    : m_name(name)
+{
+}
+
+quint64 LatencyHistogram::bucketUpperBound(int index) {
+    if (index < kSubBucketCount) {
+        return static_cast<quint64>(index);
+    }
+    const int shift = index / kSubBucketCount - 1;
+    const quint64 sub = static_cast<quint64>(index % kSubBucketCount);
+    return ((kSubBucketCount + sub) << shift) + ((quint64(1) << shift) - 1);
+}
+
+HistogramSnapshot LatencyHistogram::snapshot() const {
+    // 读取与记录并发时快照可能相差几个样本，不影响统计意义
+    HistogramSnapshot result;
+    result.buckets.assign(kBucketCount, 0);
+    for (const Shard& shard : m_shards) {
+        result.sum += shard.sum.load(std::memory_order_relaxed);
+        for (int i = 0; i < kBucketCount; ++i) {
+            result.buckets[i] += shard.buckets[i].load(std::memory_order_relaxed);
+        }
+    }
+    for (quint64 bucket : result.buckets) {
+        result.count += bucket;
+    }
+    return result;
+}
+
+void LatencyHistogram::reset() {
+    for (Shard& shard : m_shards) {
+        shard.sum.store(0, std::memory_order_relaxed);
+        for (std::atomic<quint64>& bucket : shard.buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+// ===================== Counter 类实现 =====================
+Counter::Counter(const char* name)
+    : m_name(name)
+{
+}
+
+quint64 Counter::value() const {
+    quint64 total = 0;
+    for (const Shard& shard : m_shards) {
+        total += shard.value.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void Counter::reset() {
+    for (Shard& shard : m_shards) {
+        shard.value.store(0, std::memory_order_relaxed);
+    }
+}
+
+// ===================== Registry 实现 =====================
+void Registry::reset() {
+    eventsSeen.reset();
+    eventsMatched.reset();
+    eventsDropped.reset();
+    hookTime.reset();
+    dispatchDelay.reset();
+    hideDuration.reset();
+    showDuration.reset();
+    hotkeyToHidden.reset();
+}
+
+QString Registry::dump() const {
+    QString text;
+    QTextStream out(&text);
+    writeCounter(out, eventsSeen);
+    writeCounter(out, eventsMatched);
+    writeCounter(out, eventsDropped);
+    writeHistogram(out, hookTime);
+    writeHistogram(out, dispatchDelay);
+    writeHistogram(out, hideDuration);
+    writeHistogram(out, showDuration);
+    writeHistogram(out, hotkeyToHidden);
+    return text;
+}
+
+} // namespace Metrics
+
+// ===================== MetricsStats 类实现 =====================
+MetricsStats::MetricsStats(QObject* parent)
+    : QObject(parent)
+{
+    m_timer.setInterval(1000);
+    connect(&m_timer, &QTimer::timeout, this, &MetricsStats::refresh);
+    m_timer.start();
+    refresh();
+}
+
+int MetricsStats::interval() const {
+    return m_timer.interval();
+}
+
+void MetricsStats::setInterval(int milliseconds) {
+    if (milliseconds == m_timer.interval()) {
+        return;
+    }
+    // 0 表示停止自动刷新，只在调用 refresh() 时更新
+    if (milliseconds > 0) {
+        m_timer.start(milliseconds);
+    }
+    else {
+        m_timer.stop();
+        m_timer.setInterval(0);
+    }
+    emit intervalChanged();
+}
+
+void MetricsStats::refresh() {
+    const Metrics::Registry& metrics = Metrics::registry();
+    m_eventsSeen = metrics.eventsSeen.value();
+    m_eventsMatched = metrics.eventsMatched.value();
+    m_eventsDropped = metrics.eventsDropped.value();
+
+    const Metrics::HistogramSnapshot hook = metrics.hookTime.snapshot();
+    m_hookP50 = hook.percentile(0.50) / 1000.0;
+    m_hookP99 = hook.percentile(0.99) / 1000.0;
+    m_hookMax = hook.max() / 1000.0;
+
+    const Metrics::HistogramSnapshot dispatch = metrics.dispatchDelay.snapshot();
+    m_dispatchP50 = dispatch.percentile(0.50) / 1000.0;
+    m_dispatchP99 = dispatch.percentile(0.99) / 1000.0;
+
+    const Metrics::HistogramSnapshot hide = metrics.hideDuration.snapshot();
+    m_hideP50 = hide.percentile(0.50) / 1000.0;
+    m_hideP99 = hide.percentile(0.99) / 1000.0;
+
+    const Metrics::HistogramSnapshot show = metrics.showDuration.snapshot();
+    m_showP50 = show.percentile(0.50) / 1000.0;
+    m_showP99 = show.percentile(0.99) / 1000.0;
+
+    const Metrics::HistogramSnapshot endToEnd = metrics.hotkeyToHidden.snapshot();
+    m_hotkeyToHiddenP50 = endToEnd.percentile(0.50) / 1000.0;
+    m_hotkeyToHiddenP99 = endToEnd.percentile(0.99) / 1000.0;
+
+    emit updated();
+}
+
+void MetricsStats::reset() {
+    Metrics::registry().reset();
+    refresh();
+}
+
+QString MetricsStats::dump() const {
+    return Metrics::registry().dump();
+}
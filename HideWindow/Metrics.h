@@ -0,0 +1,231 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+#ifndef METRICS_H
+#define METRICS_H
+// 常开的延迟直方图与计数器：记录路径只有一次查表和两次 relaxed 原子加，不加锁、不分配内存
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QtGlobal>
+#include <QtCore/qalgorithms.h>
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+namespace Metrics {
+
+// 记录时使用的分片数；每个线程固定落在一个分片上，分片之间按缓存行对齐
+constexpr int kShardCount = 8;
+
+// 当前线程的分片号（首次调用时轮流分配）
+int currentShard();
+
+// 单调时钟，纳秒（与 HookEvent::timestamp 同一时钟）
+inline quint64 now() {
+    return static_cast<quint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// 合并各分片后的直方图快照
+struct HistogramSnapshot {
+    quint64 count = 0;
+    quint64 sum = 0;
+    std::vector<quint64> buckets;
+
+    double mean() const;
+    // q 取 [0, 1]，返回所在桶的上界（纳秒）
+    quint64 percentile(double q) const;
+    quint64 max() const;
+};
+
+// HDR 风格的对数-线性直方图：每个 2 的幂区间再均分 32 个子桶，相对误差约 3%，
+// 覆盖 1 ns 到约 18 分钟，超出部分计入最后一个桶
+class LatencyHistogram {
+public:
+    static constexpr int kSubBucketBits = 5;
+    static constexpr int kSubBucketCount = 1 << kSubBucketBits;
+    static constexpr int kMaxExponent = 40;
+    static constexpr int kBucketCount = (kMaxExponent - kSubBucketBits + 2) * kSubBucketCount;
+
+    explicit LatencyHistogram(const char* name);
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    const char* name() const { return m_name; }
+
+    void record(quint64 valueNs) {
+        Shard& shard = m_shards[currentShard()];
+        // 样本数在快照时由各桶求和，记录路径只做两次原子加
+        shard.buckets[bucketIndex(valueNs)].fetch_add(1, std::memory_order_relaxed);
+        shard.sum.fetch_add(valueNs, std::memory_order_relaxed);
+    }
+
+    HistogramSnapshot snapshot() const;
+    void reset();
+
+    static int bucketIndex(quint64 value) {
+        if (value < kSubBucketCount) {
+            return static_cast<int>(value);
+        }
+        int exponent = 63 - static_cast<int>(qCountLeadingZeroBits(value));
+        if (exponent > kMaxExponent) {
+            return kBucketCount - 1;
+        }
+        const int shift = exponent - kSubBucketBits;
+        return (shift + 1) * kSubBucketCount + static_cast<int>((value >> shift) - kSubBucketCount);
+    }
+    // 桶内最大值（纳秒）
+    static quint64 bucketUpperBound(int index);
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<quint64> sum{ 0 };
+        std::atomic<quint64> buckets[kBucketCount];
+        Shard();
+    };
+
+    const char* m_name;
+    Shard m_shards[kShardCount];
+};
+
+// 分片计数器
+class Counter {
+public:
+    explicit Counter(const char* name);
+    Counter(const Counter&) = delete;
+    Counter& operator=(const Counter&) = delete;
+
+    const char* name() const { return m_name; }
+    void add(quint64 n = 1) {
+        m_shards[currentShard()].value.fetch_add(n, std::memory_order_relaxed);
+    }
+    quint64 value() const;
+    void reset();
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<quint64> value{ 0 };
+    };
+
+    const char* m_name;
+    Shard m_shards[kShardCount];
+};
+
+// 作用域计时：析构时把经过的时间记入直方图
+class ScopedTimer {
+public:
+    explicit ScopedTimer(LatencyHistogram& histogram)
+        : m_histogram(histogram)
+        , m_start(now())
+    {
+    }
+    ~ScopedTimer() { m_histogram.record(now() - m_start); }
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    LatencyHistogram& m_histogram;
+    quint64 m_start;
+};
+
+// 进程内的全部指标
+struct Registry {
+    Counter eventsSeen{ "hook.events_seen" };       // 进入钩子回调的按键事件
+    Counter eventsMatched{ "hook.events_matched" }; // 匹配到绑定 / 目标按键并投递
+    Counter eventsDropped{ "hook.events_dropped" }; // 分发队列满而丢弃
+
+    LatencyHistogram hookTime{ "hook.time_in_callback" };   // 钩子回调内耗时
+    LatencyHistogram dispatchDelay{ "hook.dispatch_delay" }; // 按键发生到分发线程发出信号
+    LatencyHistogram hideDuration{ "hide.duration" };
+    LatencyHistogram showDuration{ "show.duration" };
+    LatencyHistogram hotkeyToHidden{ "hide.hotkey_to_hidden" }; // 热键触发到窗口隐藏完成
+
+    // 最近一次热键触发的时间戳；下一次隐藏完成时据此记录端到端延迟
+    std::atomic<quint64> lastHotkeyTimestamp{ 0 };
+
+    void reset();
+    // 纯文本报告，每行一个指标
+    QString dump() const;
+};
+
+Registry& registry();
+
+} // namespace Metrics
+
+// 供界面 / QML 读取的指标快照，按固定间隔刷新（延迟单位为微秒）
+class MetricsStats : public QObject {
+    Q_OBJECT
+    Q_PROPERTY(int interval READ interval WRITE setInterval NOTIFY intervalChanged)
+    Q_PROPERTY(quint64 eventsSeen READ eventsSeen NOTIFY updated)
+    Q_PROPERTY(quint64 eventsMatched READ eventsMatched NOTIFY updated)
+    Q_PROPERTY(quint64 eventsDropped READ eventsDropped NOTIFY updated)
+    Q_PROPERTY(double hookP50 READ hookP50 NOTIFY updated)
+    Q_PROPERTY(double hookP99 READ hookP99 NOTIFY updated)
+    Q_PROPERTY(double hookMax READ hookMax NOTIFY updated)
+    Q_PROPERTY(double dispatchP50 READ dispatchP50 NOTIFY updated)
+    Q_PROPERTY(double dispatchP99 READ dispatchP99 NOTIFY updated)
+    Q_PROPERTY(double hideP50 READ hideP50 NOTIFY updated)
+    Q_PROPERTY(double hideP99 READ hideP99 NOTIFY updated)
+    Q_PROPERTY(double showP50 READ showP50 NOTIFY updated)
+    Q_PROPERTY(double showP99 READ showP99 NOTIFY updated)
+    Q_PROPERTY(double hotkeyToHiddenP50 READ hotkeyToHiddenP50 NOTIFY updated)
+    Q_PROPERTY(double hotkeyToHiddenP99 READ hotkeyToHiddenP99 NOTIFY updated)
+
+public:
+    explicit MetricsStats(QObject* parent = nullptr);
+
+    int interval() const;
+    void setInterval(int milliseconds);
+
+    quint64 eventsSeen() const { return m_eventsSeen; }
+    quint64 eventsMatched() const { return m_eventsMatched; }
+    quint64 eventsDropped() const { return m_eventsDropped; }
+    double hookP50() const { return m_hookP50; }
+    double hookP99() const { return m_hookP99; }
+    double hookMax() const { return m_hookMax; }
+    double dispatchP50() const { return m_dispatchP50; }
+    double dispatchP99() const { return m_dispatchP99; }
+    double hideP50() const { return m_hideP50; }
+    double hideP99() const { return m_hideP99; }
+    double showP50() const { return m_showP50; }
+    double showP99() const { return m_showP99; }
+    double hotkeyToHiddenP50() const { return m_hotkeyToHiddenP50; }
+    double hotkeyToHiddenP99() const { return m_hotkeyToHiddenP99; }
+
+    Q_INVOKABLE QString dump() const;
+
+public slots:
+    void refresh();
+    void reset();
+
+signals:
+    void intervalChanged();
+    void updated();
+
+private:
+    QTimer m_timer;
+    quint64 m_eventsSeen = 0;
+    quint64 m_eventsMatched = 0;
+    quint64 m_eventsDropped = 0;
+    double m_hookP50 = 0;
+    double m_hookP99 = 0;
+    double m_hookMax = 0;
+    double m_dispatchP50 = 0;
+    double m_dispatchP99 = 0;
+    double m_hideP50 = 0;
+    double m_hideP99 = 0;
+    double m_showP50 = 0;
+    double m_showP99 = 0;
+    double m_hotkeyToHiddenP50 = 0;
+    double m_hotkeyToHiddenP99 = 0;
+};
+#endif
@@ -0,0 +1,133 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+#ifndef PROCESSDIFF_H
+#define PROCESSDIFF_H
+// 平台无关的快照差分引擎（仅依赖标准库，可在 Linux 上单独编译）
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// 进程唯一标识：PID 会被系统复用，必须与进程创建时间一起作为键
+struct ProcessKey {
+    std::int64_t pid = 0;
+    std::uint64_t startTime = 0;
+
+    bool operator==(const ProcessKey& other) const {
+        return pid == other.pid && startTime == other.startTime;
+    }
+    bool operator!=(const ProcessKey& other) const {
+        return !(*this == other);
+    }
+};
+
+struct ProcessKeyHash {
+    std::size_t operator()(const ProcessKey& key) const noexcept {
+        // splitmix64 混合，避免 PID 连续时哈希聚集
+        std::uint64_t h = static_cast<std::uint64_t>(key.pid) ^ (key.startTime * 0x9E3779B97F4A7C15ull);
+        h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+        h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+        return static_cast<std::size_t>(h ^ (h >> 31));
+    }
+};
+
+// 一次刷新需要对模型执行的区间操作，按返回顺序依次套用即可
+struct ProcessDiffOp {
+    enum Kind {
+        Remove, // 删除 [first, last]
+        Insert, // 在 first 处插入新快照中 [first, last] 的条目
+        Change, // 行 [first, last] 的键不变但内容变化
+        Reset   // 存活行的相对顺序变化，无法用区间操作表达，需整体重置
+    };
+    Kind kind;
+    int first;
+    int last;
+};
+
+// 计算 oldKeys -> newKeys 的最小区间操作序列
+// - Remove 按从后往前的顺序给出，行号即旧列表中的行号
+// - 所有 Remove 执行完后，Insert/Change 的行号与新快照下标一致
+// sameContent(oldRow, newIndex) 判断存活行内容是否未变
+template <typename SameContent>
+std::vector<ProcessDiffOp> diffProcessKeys(const std::vector<ProcessKey>& oldKeys,
+                                           const std::vector<ProcessKey>& newKeys,
+                                           SameContent sameContent)
+{
+    std::vector<ProcessDiffOp> ops;
+    const int oldCount = static_cast<int>(oldKeys.size());
+    const int newCount = static_cast<int>(newKeys.size());
+
+    std::unordered_map<ProcessKey, int, ProcessKeyHash> newIndex;
+    newIndex.reserve(newKeys.size());
+    for (int i = 0; i < newCount; ++i) {
+        newIndex.emplace(newKeys[i], i);
+    }
+
+    // 1. 找出已退出的进程（连续区间合并），同时记录存活行在新快照中的位置
+    std::vector<int> survivorOld;
+    std::vector<int> survivorNew;
+    survivorOld.reserve(oldKeys.size());
+    survivorNew.reserve(oldKeys.size());
+    std::vector<ProcessDiffOp> removals;
+    int runStart = -1;
+    for (int i = 0; i < oldCount; ++i) {
+        auto it = newIndex.find(oldKeys[i]);
+        if (it == newIndex.end()) {
+            if (runStart < 0) {
+                runStart = i;
+            }
+            continue;
+        }
+        if (runStart >= 0) {
+            removals.push_back({ ProcessDiffOp::Remove, runStart, i - 1 });
+            runStart = -1;
+        }
+        if (!survivorNew.empty() && it->second <= survivorNew.back()) {
+            // 存活行顺序被打乱，区间操作无法表达
+            return { { ProcessDiffOp::Reset, 0, newCount - 1 } };
+        }
+        survivorOld.push_back(i);
+        survivorNew.push_back(it->second);
+    }
+    if (runStart >= 0) {
+        removals.push_back({ ProcessDiffOp::Remove, runStart, oldCount - 1 });
+    }
+    ops.reserve(removals.size() + 8);
+    ops.insert(ops.end(), removals.rbegin(), removals.rend());
+
+    // 2. 按新快照顺序合并插入区间；删除完成后模型行号与新下标一致
+    std::vector<ProcessDiffOp> changes;
+    std::size_t s = 0;
+    int j = 0;
+    while (j < newCount) {
+        if (s < survivorNew.size() && survivorNew[s] == j) {
+            if (!sameContent(survivorOld[s], j)) {
+                if (!changes.empty() && changes.back().last == j - 1) {
+                    changes.back().last = j;
+                }
+                else {
+                    changes.push_back({ ProcessDiffOp::Change, j, j });
+                }
+            }
+            ++s;
+            ++j;
+            continue;
+        }
+        const int insertStart = j;
+        const int nextSurvivor = s < survivorNew.size() ? survivorNew[s] : newCount;
+        j = nextSurvivor;
+        ops.push_back({ ProcessDiffOp::Insert, insertStart, j - 1 });
+    }
+    ops.insert(ops.end(), changes.begin(), changes.end());
+    return ops;
+}
+#endif
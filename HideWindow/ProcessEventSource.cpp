@@ -0,0 +1,203 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "ProcessEventSource.h"
+#include "Trace.h"
+#include <QDebug>
+#include <QFileInfo>
+#include <algorithm>
+
+// ===================== ProcessEventSource 类实现 =====================
+bool ProcessEventSource::start(std::function<void()> notify) {
+    if (m_running) {
+        return true;
+    }
+    {
+        QMutexLocker locker(&m_mutex);
+        m_notify = std::move(notify);
+        m_signalled = false;
+    }
+    m_running = startWatching();
+    return m_running;
+}
+
+void ProcessEventSource::stop() {
+    if (!m_running) {
+        return;
+    }
+    stopWatching();
+    m_running = false;
+    QMutexLocker locker(&m_mutex);
+    m_notify = nullptr;
+}
+
+bool ProcessEventSource::takeEvents(QList<ProcessEvent>& out) {
+    QMutexLocker locker(&m_mutex);
+    if (out.isEmpty()) {
+        // 常见情况：直接交换，双方的容量都得到复用
+        out.swap(m_events);
+    }
+    else {
+        out.append(m_events);
+        m_events.clear();
+    }
+    const bool overflow = m_overflow;
+    m_overflow = false;
+    m_signalled = false;
+    return overflow;
+}
+
+void ProcessEventSource::post(const ProcessEvent& event) {
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_events.size() >= kQueueLimit) {
+            // GUI 线程跟不上时不再积压，由一次完整刷新代替
+            m_overflow = true;
+        }
+        else {
+            m_events.append(event);
+        }
+    }
+    signal();
+}
+
+void ProcessEventSource::postOverflow() {
+    {
+        QMutexLocker locker(&m_mutex);
+        m_overflow = true;
+    }
+    signal();
+}
+
+void ProcessEventSource::signal() {
+    std::function<void()> notify;
+    {
+        QMutexLocker locker(&m_mutex);
+        // 上一次通知之后还没有取走事件时不再重复通知
+        if (m_signalled || !m_notify) {
+            return;
+        }
+        m_signalled = true;
+        notify = m_notify;
+    }
+    notify();
+}
+
+// ===================== PollingProcessEventSource 类实现 =====================
+PollingProcessEventSource::PollingProcessEventSource(std::unique_ptr<ProcessSource> source, int intervalMs)
+    : m_source(std::move(source))
+    , m_intervalMs(qMax(intervalMs, 10))
+{
+}
+
+PollingProcessEventSource::~PollingProcessEventSource() {
+    stop();
+}
+
+bool PollingProcessEventSource::startWatching() {
+    if (!m_source) {
+        return false;
+    }
+    m_thread = QThread::create([this] { run(); });
+    m_thread->setObjectName(QStringLiteral("ProcessPolling"));
+    m_thread->start(QThread::LowPriority);
+    return true;
+}
+
+void PollingProcessEventSource::stopWatching() {
+    if (m_thread) {
+        m_stop.release();
+        m_thread->wait();
+        delete m_thread;
+        m_thread = nullptr;
+        // 丢弃线程退出前可能未被消费的信号
+        m_stop.tryAcquire(m_stop.available());
+    }
+    m_previous.clear();
+}
+
+void PollingProcessEventSource::run() {
+    poll(true);
+    while (!m_stop.tryAcquire(1, m_intervalMs)) {
+        poll(false);
+    }
+}
+
+void PollingProcessEventSource::poll(bool baseline) {
+    HW_TRACE_SCOPE("process", "PollingProcessEventSource::poll");
+    if (!m_source->listPids(m_current)) {
+        return;
+    }
+    std::sort(m_current.begin(), m_current.end());
+    if (!baseline) {
+        // 两个有序集合归并比较：只在 previous 中的已退出，只在 current 中的是新进程
+        auto previous = m_previous.cbegin();
+        auto current = m_current.cbegin();
+        while (previous != m_previous.cend() || current != m_current.cend()) {
+            if (current == m_current.cend() || (previous != m_previous.cend() && *previous < *current)) {
+                ProcessEvent event;
+                event.kind = ProcessEvent::Exited;
+                event.entry.pid = *previous++;
+                post(event);
+            }
+            else if (previous == m_previous.cend() || *current < *previous) {
+                ProcessEvent event;
+                event.kind = ProcessEvent::Started;
+                if (m_source->query(*current, event.entry)) {
+                    post(event);
+                }
+                ++current;
+            }
+            else {
+                ++previous;
+                ++current;
+            }
+        }
+    }
+    m_previous.swap(m_current);
+}
+
+// ===================== FakeProcessEventSource 类实现 =====================
+void FakeProcessEventSource::emitStarted(const ProcessEntry& entry) {
+    ProcessEvent event;
+    event.kind = ProcessEvent::Started;
+    event.entry = entry;
+    post(event);
+}
+
+void FakeProcessEventSource::emitExited(qint64 pid) {
+    ProcessEvent event;
+    event.kind = ProcessEvent::Exited;
+    event.entry.pid = pid;
+    post(event);
+}
+
+void FakeProcessEventSource::emitOverflow() {
+    postOverflow();
+}
+
+void FakeProcessEventSource::forkStorm(qint64 firstPid, int count, qint64 parentPid, const QString& exePath) {
+    ProcessEntry entry;
+    entry.parentPid = parentPid;
+    entry.exePath = exePath;
+    entry.name = QFileInfo(exePath).fileName();
+    for (int i = 0; i < count; ++i) {
+        entry.pid = firstPid + i;
+        entry.startTime = static_cast<quint64>(entry.pid);
+        emitStarted(entry);
+    }
+}
+
+#ifdef Q_OS_WIN
+std::unique_ptr<ProcessEventSource> createDefaultProcessEventSource() {
+    // Toolhelp 快照只列 PID 时很便宜，新进程才需要打开查询
+    return std::make_unique<PollingProcessEventSource>(std::make_unique<ToolhelpProcessSource>(), 1000);
+}
+#endif
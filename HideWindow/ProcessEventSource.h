@@ -0,0 +1,140 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+#ifndef PROCESSEVENTSOURCE_H
+#define PROCESSEVENTSOURCE_H
+// 进程启动 / 退出通知：模型据此逐行增删，完整快照只用于定期校准。
+// 事件在后台线程产生，先放入带上限的队列，由 GUI 线程一次取走；
+// 队列溢出或事件丢失时报告 overflow，调用方应退回一次完整刷新。
+#include <QList>
+#include <QMutex>
+#include <QSemaphore>
+#include <QThread>
+#include <QtGlobal>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "ProcessSource.h"
+
+struct ProcessEvent {
+    enum Kind : quint8 {
+        Started, // 新进程，或已有进程的元数据变化（例如 exec 之后）
+        Exited   // 只有 entry.pid 有效
+    };
+    Kind kind = Started;
+    ProcessEntry entry;
+};
+
+class ProcessEventSource {
+public:
+    ProcessEventSource() = default;
+    ProcessEventSource(const ProcessEventSource&) = delete;
+    ProcessEventSource& operator=(const ProcessEventSource&) = delete;
+    virtual ~ProcessEventSource() = default;
+
+    // 开始监听；队列由空变为非空时在事件线程调用 notify（调用方自行转到 GUI 线程）
+    bool start(std::function<void()> notify);
+    void stop();
+    bool isRunning() const { return m_running; }
+    // start 失败时可代替本事件源的实现（例如 netlink 订阅被拒绝时轮询），没有则返回空指针
+    virtual std::unique_ptr<ProcessEventSource> createFallback() const { return nullptr; }
+
+    // 取出所有待处理事件（追加到 out）；返回期间是否发生过溢出
+    bool takeEvents(QList<ProcessEvent>& out);
+
+    // 队列上限，超出后丢弃新事件并标记溢出
+    static constexpr qsizetype kQueueLimit = 16384;
+
+protected:
+    virtual bool startWatching() = 0;
+    virtual void stopWatching() = 0;
+
+    // 由事件线程调用
+    void post(const ProcessEvent& event);
+    void postOverflow();
+
+private:
+    void signal();
+
+    QMutex m_mutex;
+    QList<ProcessEvent> m_events;
+    bool m_overflow = false;
+    bool m_signalled = false; // 已通知但事件尚未取走
+    std::function<void()> m_notify;
+    bool m_running = false;
+};
+
+// 定期列出 PID 并与上一次比较；新 PID 单独查询元数据。无法订阅系统通知时的通用实现
+class PollingProcessEventSource : public ProcessEventSource {
+public:
+    PollingProcessEventSource(std::unique_ptr<ProcessSource> source, int intervalMs);
+    ~PollingProcessEventSource() override;
+
+protected:
+    bool startWatching() override;
+    void stopWatching() override;
+
+private:
+    void run();
+    // 与上一轮的 PID 集合比较并发出事件；第一轮只记录基准
+    void poll(bool baseline);
+
+    std::unique_ptr<ProcessSource> m_source;
+    int m_intervalMs;
+    QThread* m_thread = nullptr;
+    QSemaphore m_stop;
+    std::vector<qint64> m_previous; // 有序
+    std::vector<qint64> m_current;
+};
+
+// 由调用方直接注入事件，用于确定性地重现进程风暴等场景；不产生任何系统事件
+class FakeProcessEventSource : public ProcessEventSource {
+public:
+    void emitStarted(const ProcessEntry& entry);
+    void emitExited(qint64 pid);
+    void emitOverflow();
+    // 连续启动 count 个进程，PID 从 firstPid 开始递增
+    void forkStorm(qint64 firstPid, int count, qint64 parentPid, const QString& exePath);
+
+protected:
+    bool startWatching() override { return true; }
+    void stopWatching() override {}
+};
+
+#ifdef Q_OS_LINUX
+// netlink 进程连接器（NETLINK_CONNECTOR / CN_IDX_PROC）。需要 CAP_NET_ADMIN，
+// 无权限时 create 返回空指针，订阅在 start 时被拒绝则由 createFallback 退回轮询
+class NetlinkProcessEventSource : public ProcessEventSource {
+public:
+    static std::unique_ptr<NetlinkProcessEventSource> create();
+    ~NetlinkProcessEventSource() override;
+    std::unique_ptr<ProcessEventSource> createFallback() const override;
+
+protected:
+    bool startWatching() override;
+    void stopWatching() override;
+
+private:
+    explicit NetlinkProcessEventSource(int socket);
+    void run();
+    bool subscribe(bool enable);
+    void handleMessage(const char* data, std::size_t length);
+
+    int m_socket = -1;
+    int m_stopFd = -1; // eventfd，写入后唤醒 poll
+    QThread* m_thread = nullptr;
+    LinuxProcessSource m_reader; // 按 PID 读取新进程的 /proc 元数据
+};
+#endif
+
+// 当前平台的默认实现：Linux 优先使用 netlink，否则轮询 /proc；Windows 轮询 Toolhelp 快照
+std::unique_ptr<ProcessEventSource> createDefaultProcessEventSource();
+#endif
@@ -0,0 +1,574 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "ProcessFilterModel.h"
+#include "ProcessListModel.h"
+#include "Trace.h"
+#include <algorithm>
+#include <numeric>
+
+namespace {
+// 失效文档超过该数量且多于存活文档时重建索引
+constexpr int kMinDeadDocsForRebuild = 1024;
+// 结果变化分散成过多区间时，逐段增删（每段都要移动后续行、视图逐段处理）比一次重置更慢
+constexpr int kMaxRangeSignals = 64;
+// 追加字符时，上一次结果不超过该行数才在其中逐行校验；更多时查倒排表更快
+constexpr std::size_t kMaxNarrowingRows = 4096;
+} // namespace
+
+// ===================== ProcessFilterModel 类实现 =====================
+ProcessFilterModel::ProcessFilterModel(QObject* parent)
+    : QAbstractProxyModel(parent)
+    , m_nameRole(ProcessListModel::NameRole)
+    , m_pathRole(ProcessListModel::FileRole)
+{
+}
+
+void ProcessFilterModel::setSourceModel(QAbstractItemModel* model) {
+    beginResetModel();
+    if (sourceModel()) {
+        disconnect(sourceModel(), nullptr, this, nullptr);
+    }
+    QAbstractProxyModel::setSourceModel(model);
+    if (model) {
+        connect(model, &QAbstractItemModel::modelAboutToBeReset, this, &ProcessFilterModel::onSourceAboutToBeReset);
+        connect(model, &QAbstractItemModel::modelReset, this, &ProcessFilterModel::onSourceReset);
+        // 源模型的布局变化与移动在进程列表中不会出现，按重置处理即可
+        connect(model, &QAbstractItemModel::layoutAboutToBeChanged, this, &ProcessFilterModel::onSourceAboutToBeReset);
+        connect(model, &QAbstractItemModel::layoutChanged, this, &ProcessFilterModel::onSourceReset);
+        connect(model, &QAbstractItemModel::rowsAboutToBeMoved, this, &ProcessFilterModel::onSourceAboutToBeReset);
+        connect(model, &QAbstractItemModel::rowsMoved, this, &ProcessFilterModel::onSourceReset);
+        connect(model, &QAbstractItemModel::rowsAboutToBeRemoved, this, &ProcessFilterModel::onSourceRowsAboutToBeRemoved);
+        connect(model, &QAbstractItemModel::rowsRemoved, this, &ProcessFilterModel::onSourceRowsRemoved);
+        connect(model, &QAbstractItemModel::rowsInserted, this, &ProcessFilterModel::onSourceRowsInserted);
+        connect(model, &QAbstractItemModel::dataChanged, this, &ProcessFilterModel::onSourceDataChanged);
+    }
+    rebuildIndex();
+    std::vector<int> rows;
+    std::vector<int> scores;
+    computeRows(rows, scores, Scope::All);
+    m_rows.swap(rows);
+    m_scores.swap(scores);
+    endResetModel();
+    setCount();
+}
+
+void ProcessFilterModel::setMatchRoles(int nameRole, int pathRole) {
+    if (m_nameRole == nameRole && m_pathRole == pathRole) {
+        return;
+    }
+    m_nameRole = nameRole;
+    m_pathRole = pathRole;
+    onSourceAboutToBeReset();
+    onSourceReset();
+}
+
+QString ProcessFilterModel::filterText() const {
+    return m_filterText;
+}
+
+void ProcessFilterModel::setFilterText(const QString& text) {
+    if (m_filterText == text) {
+        return;
+    }
+    HW_TRACE_SCOPE("filter", "setFilterText");
+    const QStringList oldTerms = m_terms;
+    const QString oldPattern = m_fuzzyPattern;
+    m_filterText = text;
+    m_terms = TrigramIndex::terms(text);
+    m_fuzzyPattern = m_terms.join(QString());
+    emit filterTextChanged();
+    if (m_terms == oldTerms) {
+        return; // 只有空白变化
+    }
+
+    // 查询只变得更严格时，新结果必然是旧结果的子集，只需在旧结果中筛选
+    const bool narrowing = m_fuzzy
+        ? !oldPattern.isEmpty() && m_fuzzyPattern.contains(oldPattern)
+        : !oldTerms.isEmpty() && TrigramIndex::narrows(oldTerms, m_terms);
+    // 前面的词不变、末尾的词变严格或新增一个词时，上一次的结果只需再确认末尾的词
+    const qsizetype prefix = m_terms.size() - 1;
+    const bool lastTermOnly = !m_fuzzy && !oldTerms.isEmpty() && prefix >= 0
+        && (oldTerms.size() == prefix || (oldTerms.size() == m_terms.size() && m_terms.last().contains(oldTerms.last())))
+        && std::equal(m_terms.begin(), m_terms.begin() + prefix, oldTerms.begin());
+    // 末尾的词只是在后面追加了字符时，已记录的出现位置仍是下界
+    if (!(lastTermOnly && oldTerms.size() == m_terms.size() && m_terms.last().startsWith(oldTerms.last()))) {
+        std::fill(m_termStart.begin(), m_termStart.end(), 0);
+    }
+    std::vector<int> rows;
+    std::vector<int> scores;
+    computeRows(rows, scores, lastTermOnly ? Scope::LastTerm : narrowing ? Scope::Previous : Scope::All);
+    if (m_fuzzy) {
+        // 按得分排序后行的相对顺序会变化，无法用区间增删表达
+        beginResetModel();
+        m_rows.swap(rows);
+        m_scores.swap(scores);
+        endResetModel();
+    }
+    else {
+        applyRows(rows);
+    }
+    setCount();
+}
+
+bool ProcessFilterModel::fuzzy() const {
+    return m_fuzzy;
+}
+
+void ProcessFilterModel::setFuzzy(bool enabled) {
+    if (m_fuzzy == enabled) {
+        return;
+    }
+    beginResetModel();
+    m_fuzzy = enabled;
+    std::vector<int> rows;
+    std::vector<int> scores;
+    computeRows(rows, scores, Scope::All);
+    m_rows.swap(rows);
+    m_scores.swap(scores);
+    endResetModel();
+    emit fuzzyChanged();
+    setCount();
+}
+
+int ProcessFilterModel::count() const {
+    return static_cast<int>(m_rows.size());
+}
+
+void ProcessFilterModel::setCount() {
+    if (m_lastCount == count()) {
+        return;
+    }
+    m_lastCount = count();
+    emit countChanged();
+}
+
+QModelIndex ProcessFilterModel::index(int row, int column, const QModelIndex& parent) const {
+    if (parent.isValid() || row < 0 || row >= count() || column < 0 || column >= columnCount()) {
+        return QModelIndex();
+    }
+    return createIndex(row, column);
+}
+
+QModelIndex ProcessFilterModel::parent(const QModelIndex& child) const {
+    Q_UNUSED(child);
+    return QModelIndex();
+}
+
+int ProcessFilterModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : count();
+}
+
+int ProcessFilterModel::columnCount(const QModelIndex& parent) const {
+    if (parent.isValid() || !sourceModel()) {
+        return 0;
+    }
+    return sourceModel()->columnCount();
+}
+
+QModelIndex ProcessFilterModel::mapToSource(const QModelIndex& proxyIndex) const {
+    if (!proxyIndex.isValid() || !sourceModel() || proxyIndex.row() >= count()) {
+        return QModelIndex();
+    }
+    return sourceModel()->index(m_rows[proxyIndex.row()], proxyIndex.column());
+}
+
+QModelIndex ProcessFilterModel::mapFromSource(const QModelIndex& sourceIndex) const {
+    if (!sourceIndex.isValid() || sourceIndex.model() != sourceModel()) {
+        return QModelIndex();
+    }
+    const int row = proxyRowOf(sourceIndex.row());
+    return row < 0 ? QModelIndex() : index(row, sourceIndex.column());
+}
+
+void ProcessFilterModel::onSourceAboutToBeReset() {
+    beginResetModel();
+}
+
+void ProcessFilterModel::onSourceReset() {
+    rebuildIndex();
+    std::vector<int> rows;
+    std::vector<int> scores;
+    computeRows(rows, scores, Scope::All);
+    m_rows.swap(rows);
+    m_scores.swap(scores);
+    endResetModel();
+    setCount();
+}
+
+void ProcessFilterModel::onSourceRowsAboutToBeRemoved(const QModelIndex& parent, int first, int last) {
+    if (parent.isValid()) {
+        return;
+    }
+    // 在源行仍然有效时先移除对应的代理行；非模糊模式下它们是一个连续区间
+    int i = count() - 1;
+    while (i >= 0) {
+        if (m_rows[i] < first || m_rows[i] > last) {
+            --i;
+            continue;
+        }
+        const int end = i;
+        while (i >= 0 && m_rows[i] >= first && m_rows[i] <= last) {
+            --i;
+        }
+        beginRemoveRows(QModelIndex(), i + 1, end);
+        m_rows.erase(m_rows.begin() + i + 1, m_rows.begin() + end + 1);
+        if (!m_scores.empty()) {
+            m_scores.erase(m_scores.begin() + i + 1, m_scores.begin() + end + 1);
+        }
+        endRemoveRows();
+    }
+}
+
+void ProcessFilterModel::onSourceRowsRemoved(const QModelIndex& parent, int first, int last) {
+    if (parent.isValid()) {
+        return;
+    }
+    const int removed = last - first + 1;
+    for (int row = first; row <= last; ++row) {
+        const quint32 doc = m_rowDoc[row];
+        m_index.remove(doc);
+        m_docRow[doc] = -1;
+    }
+    m_rowDoc.erase(m_rowDoc.begin() + first, m_rowDoc.begin() + last + 1);
+    for (int& row : m_rows) {
+        if (row > last) {
+            row -= removed;
+        }
+    }
+    if (m_index.deadCount() > qMax(kMinDeadDocsForRebuild, m_index.aliveCount())) {
+        // 源行号不受影响，只需重建索引与文档映射
+        rebuildIndex();
+    }
+    else {
+        updateDocRows(first);
+    }
+    setCount();
+}
+
+void ProcessFilterModel::onSourceRowsInserted(const QModelIndex& parent, int first, int last) {
+    if (parent.isValid()) {
+        return;
+    }
+    const int inserted = last - first + 1;
+    for (int& row : m_rows) {
+        if (row >= first) {
+            row += inserted;
+        }
+    }
+    m_rowDoc.insert(m_rowDoc.begin() + first, inserted, 0);
+    for (int row = first; row <= last; ++row) {
+        m_rowDoc[row] = indexSourceRow(row);
+    }
+    updateDocRows(first);
+
+    if (m_fuzzy) {
+        for (int row = first; row <= last; ++row) {
+            int score = 0;
+            if (rowMatches(row, &score)) {
+                insertMatch(row, score);
+            }
+        }
+    }
+    else {
+        // 新行在代理中同样相邻，命中的部分一次插入
+        std::vector<int> matched;
+        for (int row = first; row <= last; ++row) {
+            if (rowMatches(row, nullptr)) {
+                matched.push_back(row);
+            }
+        }
+        if (!matched.empty()) {
+            const int position = static_cast<int>(std::lower_bound(m_rows.begin(), m_rows.end(), first) - m_rows.begin());
+            beginInsertRows(QModelIndex(), position, position + static_cast<int>(matched.size()) - 1);
+            m_rows.insert(m_rows.begin() + position, matched.begin(), matched.end());
+            endInsertRows();
+        }
+    }
+    setCount();
+}
+
+void ProcessFilterModel::onSourceDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight, const QList<int>& roles) {
+    if (topLeft.parent().isValid()) {
+        return;
+    }
+    const bool textChanged = roles.isEmpty() || roles.contains(m_nameRole) || roles.contains(m_pathRole);
+    for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
+        int proxyRow = proxyRowOf(row);
+        if (!textChanged) {
+            if (proxyRow >= 0) {
+                emit dataChanged(index(proxyRow, 0), index(proxyRow, columnCount() - 1), roles);
+            }
+            continue;
+        }
+
+        // 文本变化：以新文档号重新登记
+        m_index.remove(m_rowDoc[row]);
+        m_docRow[m_rowDoc[row]] = -1;
+        m_rowDoc[row] = indexSourceRow(row);
+        m_docRow.resize(m_index.nextDoc(), -1);
+        m_docRow[m_rowDoc[row]] = row;
+
+        int score = 0;
+        const bool matched = rowMatches(row, &score);
+        if (proxyRow >= 0 && matched && (!m_fuzzy || m_scores[proxyRow] == score)) {
+            emit dataChanged(index(proxyRow, 0), index(proxyRow, columnCount() - 1), roles);
+            continue;
+        }
+        if (proxyRow >= 0) {
+            beginRemoveRows(QModelIndex(), proxyRow, proxyRow);
+            m_rows.erase(m_rows.begin() + proxyRow);
+            if (!m_scores.empty()) {
+                m_scores.erase(m_scores.begin() + proxyRow);
+            }
+            endRemoveRows();
+        }
+        if (matched) {
+            insertMatch(row, score);
+        }
+    }
+    setCount();
+}
+
+void ProcessFilterModel::rebuildIndex() {
+    HW_TRACE_SCOPE("filter", "rebuildIndex");
+    m_index.clear();
+    m_termStart.clear();
+    const int rows = sourceModel() ? sourceModel()->rowCount() : 0;
+    m_rowDoc.resize(rows);
+    for (int row = 0; row < rows; ++row) {
+        m_rowDoc[row] = indexSourceRow(row);
+    }
+    m_docRow.assign(m_index.nextDoc(), -1);
+    updateDocRows(0);
+}
+
+quint32 ProcessFilterModel::indexSourceRow(int row) {
+    const QModelIndex source = sourceModel()->index(row, 0);
+    return m_index.add(source.data(m_nameRole).toString(), source.data(m_pathRole).toString());
+}
+
+void ProcessFilterModel::updateDocRows(int firstRow) {
+    m_docRow.resize(m_index.nextDoc(), -1);
+    for (int row = firstRow; row < static_cast<int>(m_rowDoc.size()); ++row) {
+        m_docRow[m_rowDoc[row]] = row;
+    }
+}
+
+bool ProcessFilterModel::rowMatches(int row, int* score) const {
+    if (score) {
+        *score = 0;
+    }
+    if (m_terms.isEmpty()) {
+        return true;
+    }
+    if (!m_fuzzy) {
+        return m_index.matches(m_rowDoc[row], m_terms);
+    }
+    const int value = m_index.fuzzyScore(m_rowDoc[row], m_fuzzyPattern);
+    if (score) {
+        *score = value;
+    }
+    return value >= 0;
+}
+
+void ProcessFilterModel::computeRows(std::vector<int>& out, std::vector<int>& scores, Scope scope) {
+    out.clear();
+    scores.clear();
+    const int sourceRows = static_cast<int>(m_rowDoc.size());
+    if (m_terms.isEmpty()) {
+        out.resize(sourceRows);
+        std::iota(out.begin(), out.end(), 0);
+        if (m_fuzzy) {
+            scores.assign(out.size(), 0);
+        }
+        return;
+    }
+
+    if (m_fuzzy) {
+        std::vector<std::pair<int, int>> ranked; // (得分, 源行)
+        auto consider = [&](int row) {
+            const int score = m_index.fuzzyScore(m_rowDoc[row], m_fuzzyPattern);
+            if (score >= 0) {
+                ranked.emplace_back(score, row);
+            }
+        };
+        if (scope != Scope::All) {
+            for (int row : m_rows) {
+                consider(row);
+            }
+        }
+        else {
+            for (int row = 0; row < sourceRows; ++row) {
+                consider(row);
+            }
+        }
+        // 得分高的在前，同分保持源模型顺序
+        std::sort(ranked.begin(), ranked.end(), [](const std::pair<int, int>& a, const std::pair<int, int>& b) {
+            return a.first != b.first ? a.first > b.first : a.second < b.second;
+        });
+        out.reserve(ranked.size());
+        scores.reserve(ranked.size());
+        for (const std::pair<int, int>& entry : ranked) {
+            scores.push_back(entry.first);
+            out.push_back(entry.second);
+        }
+        return;
+    }
+
+    if (scope == Scope::LastTerm) {
+        const QString& term = m_terms.last();
+        if (term.size() <= 3) {
+            // 短词的倒排表就是精确结果，与上一次的结果求交集即可
+            const std::vector<quint32>* list = m_index.postings(term);
+            if (!list) {
+                return;
+            }
+            std::vector<char> hit(m_index.nextDoc(), 0);
+            for (quint32 doc : *list) {
+                hit[doc] = 1;
+            }
+            for (int row : m_rows) {
+                if (hit[m_rowDoc[row]]) {
+                    out.push_back(row);
+                }
+            }
+            return;
+        }
+        m_termStart.resize(m_index.nextDoc(), 0);
+        for (int row : m_rows) {
+            const quint32 doc = m_rowDoc[row];
+            const int start = m_index.find(doc, term, m_termStart[doc]);
+            if (start >= 0) {
+                m_termStart[doc] = start;
+                out.push_back(row);
+            }
+        }
+        return;
+    }
+    // 上一次结果已经很少时直接在其中筛选，否则交给倒排表
+    if (scope == Scope::Previous && m_rows.size() <= kMaxNarrowingRows) {
+        for (int row : m_rows) {
+            if (m_index.matches(m_rowDoc[row], m_terms)) {
+                out.push_back(row);
+            }
+        }
+        return;
+    }
+    std::vector<quint32> docs;
+    m_index.lookup(m_terms, docs);
+    // 文档号与源行的顺序不一定一致（源模型中间插入的行文档号更大），借助按行的标记恢复升序
+    std::vector<char> hit(sourceRows, 0);
+    for (quint32 doc : docs) {
+        hit[m_docRow[doc]] = 1;
+    }
+    out.reserve(docs.size());
+    for (int row = 0; row < sourceRows; ++row) {
+        if (hit[row]) {
+            out.push_back(row);
+        }
+    }
+}
+
+void ProcessFilterModel::applyRows(const std::vector<int>& rows) {
+    // 两个有序序列归并：标出需要保留的旧行，同时统计删除段与插入段的数量。
+    // 删除段是旧行中连续未保留的部分，插入段是新行中连续的新增部分，只有保留行会打断它们
+    std::vector<char> keep(m_rows.size(), 0);
+    int ranges = 0;
+    bool inRemoval = false;
+    bool inInsertion = false;
+    for (std::size_t i = 0, j = 0; i < m_rows.size() || j < rows.size();) {
+        if (j == rows.size() || (i < m_rows.size() && m_rows[i] < rows[j])) {
+            ranges += inRemoval ? 0 : 1;
+            inRemoval = true;
+            ++i;
+        }
+        else if (i == m_rows.size() || rows[j] < m_rows[i]) {
+            ranges += inInsertion ? 0 : 1;
+            inInsertion = true;
+            ++j;
+        }
+        else {
+            keep[i++] = 1;
+            ++j;
+            inRemoval = false;
+            inInsertion = false;
+        }
+    }
+    if (ranges > kMaxRangeSignals) {
+        beginResetModel();
+        m_rows = rows;
+        endResetModel();
+        return;
+    }
+
+    // 从后往前删除连续区间，前面的行号不受影响
+    int i = count() - 1;
+    while (i >= 0) {
+        if (keep[i]) {
+            --i;
+            continue;
+        }
+        const int end = i;
+        while (i >= 0 && !keep[i]) {
+            --i;
+        }
+        beginRemoveRows(QModelIndex(), i + 1, end);
+        m_rows.erase(m_rows.begin() + i + 1, m_rows.begin() + end + 1);
+        endRemoveRows();
+    }
+
+    // 此时 m_rows 是 rows 的子序列，按新顺序合并插入区间
+    std::size_t current = 0;
+    std::size_t next = 0;
+    while (next < rows.size()) {
+        if (current < m_rows.size() && m_rows[current] == rows[next]) {
+            ++current;
+            ++next;
+            continue;
+        }
+        const std::size_t begin = next;
+        while (next < rows.size() && (current == m_rows.size() || rows[next] != m_rows[current])) {
+            ++next;
+        }
+        beginInsertRows(QModelIndex(), static_cast<int>(current), static_cast<int>(current + next - begin) - 1);
+        m_rows.insert(m_rows.begin() + current, rows.begin() + begin, rows.begin() + next);
+        endInsertRows();
+        current += next - begin;
+    }
+}
+
+void ProcessFilterModel::insertMatch(int row, int score) {
+    int position = 0;
+    if (m_fuzzy) {
+        while (position < count()
+            && (m_scores[position] > score || (m_scores[position] == score && m_rows[position] < row))) {
+            ++position;
+        }
+    }
+    else {
+        position = static_cast<int>(std::lower_bound(m_rows.begin(), m_rows.end(), row) - m_rows.begin());
+    }
+    beginInsertRows(QModelIndex(), position, position);
+    m_rows.insert(m_rows.begin() + position, row);
+    if (m_fuzzy) {
+        m_scores.insert(m_scores.begin() + position, score);
+    }
+    endInsertRows();
+}
+
+int ProcessFilterModel::proxyRowOf(int sourceRow) const {
+    if (m_fuzzy) {
+        const auto it = std::find(m_rows.begin(), m_rows.end(), sourceRow);
+        return it == m_rows.end() ? -1 : static_cast<int>(it - m_rows.begin());
+    }
+    const auto it = std::lower_bound(m_rows.begin(), m_rows.end(), sourceRow);
+    return (it == m_rows.end() || *it != sourceRow) ? -1 : static_cast<int>(it - m_rows.begin());
+}
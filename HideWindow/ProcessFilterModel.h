@@ -0,0 +1,95 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+#ifndef PROCESSFILTERMODEL_H
+#define PROCESSFILTERMODEL_H
+#include <QAbstractProxyModel>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <vector>
+#include "TrigramIndex.h"
+
+// 进程列表的搜索过滤代理：按名称与可执行文件路径做子串过滤（多个词以空格分隔，须全部出现）。
+// - 名称与路径建有 n 元组倒排索引，源模型增删行时增量维护
+// - 在上一次查询后追加字符只在上一次的结果中筛选，逐字输入时只确认末尾的词
+// - 结果变化以最少的行区间增删发出；变化过于分散时改为一次重置
+// - fuzzy 为 true 时改为按字符顺序的模糊匹配，按得分排序（结果变化时整体重置）
+class ProcessFilterModel : public QAbstractProxyModel {
+    Q_OBJECT
+    Q_PROPERTY(QString filterText READ filterText WRITE setFilterText NOTIFY filterTextChanged)
+    Q_PROPERTY(bool fuzzy READ fuzzy WRITE setFuzzy NOTIFY fuzzyChanged)
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+public:
+    // 源模型中用于匹配的角色（默认为 ProcessListModel 的名称与文件角色）
+    explicit ProcessFilterModel(QObject* parent = nullptr);
+
+    void setSourceModel(QAbstractItemModel* sourceModel) override;
+    void setMatchRoles(int nameRole, int pathRole);
+
+    QString filterText() const;
+    void setFilterText(const QString& text);
+    bool fuzzy() const;
+    void setFuzzy(bool enabled);
+    int count() const;
+
+    QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex& child) const override;
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QModelIndex mapToSource(const QModelIndex& proxyIndex) const override;
+    QModelIndex mapFromSource(const QModelIndex& sourceIndex) const override;
+signals:
+    void filterTextChanged();
+    void fuzzyChanged();
+    void countChanged();
+private slots:
+    void onSourceAboutToBeReset();
+    void onSourceReset();
+    void onSourceRowsAboutToBeRemoved(const QModelIndex& parent, int first, int last);
+    void onSourceRowsRemoved(const QModelIndex& parent, int first, int last);
+    void onSourceRowsInserted(const QModelIndex& parent, int first, int last);
+    void onSourceDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight, const QList<int>& roles);
+private:
+    // 重新为源模型的全部行建索引（源模型重置或失效文档过多时）
+    void rebuildIndex();
+    quint32 indexSourceRow(int row);
+    void updateDocRows(int firstRow);
+    // 计算结果的范围：全部源行；上一次的结果；上一次的结果且只需确认末尾的词
+    enum class Scope { All, Previous, LastTerm };
+    // 计算当前查询的全部结果（源行号；非模糊模式升序，模糊模式按得分排序）
+    void computeRows(std::vector<int>& out, std::vector<int>& scores, Scope scope);
+    bool rowMatches(int row, int* score) const;
+    // 非模糊模式：以最少的区间增删把 m_rows 变为 rows（两者均升序）
+    void applyRows(const std::vector<int>& rows);
+    // 把新匹配的源行插入到应在的位置
+    void insertMatch(int row, int score);
+    int proxyRowOf(int sourceRow) const;
+    void setCount();
+
+    TrigramIndex m_index;
+    int m_nameRole;
+    int m_pathRole;
+    QString m_filterText;
+    QStringList m_terms;
+    QString m_fuzzyPattern; // 模糊模式下去掉空白的查询
+    bool m_fuzzy = false;
+    int m_lastCount = 0;
+
+    std::vector<quint32> m_rowDoc; // 源行 -> 文档号
+    std::vector<int> m_docRow;     // 文档号 -> 源行（失效为 -1）
+    std::vector<int> m_rows;       // 代理行 -> 源行
+    std::vector<int> m_scores;     // 模糊模式下与 m_rows 对应的得分
+    // 文档号 -> 末尾词在文本中首次出现位置的下界。末尾词只会变长时下界依然成立，
+    // 逐字输入时从这里继续查找，通常一次比较即可确认；其他查询变化时清零
+    std::vector<int> m_termStart;
+};
+#endif
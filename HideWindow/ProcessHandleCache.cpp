@@ -0,0 +1,278 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "ProcessHandleCache.h"
+#include "Metrics.h"
+#include "Trace.h"
+
+#ifdef Q_OS_LINUX
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434
+#endif
+#endif
+
+namespace {
+#ifdef Q_OS_LINUX
+// 读取 /proc/[pid]/stat 的第 22 个字段 starttime（comm 可能含空格，从最后一个 ')' 之后计数）
+bool readStartTime(qint64 pid, quint64& startTime) {
+    char path[32];
+    std::snprintf(path, sizeof(path), "/proc/%lld/stat", static_cast<long long>(pid));
+    const int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    char buffer[1024];
+    const ssize_t length = read(fd, buffer, sizeof(buffer) - 1);
+    close(fd);
+    if (length <= 0) {
+        return false;
+    }
+    buffer[length] = '\0';
+    const char* cursor = std::strrchr(buffer, ')');
+    if (!cursor) {
+        return false;
+    }
+    for (int field = 2; field < 22; ++field) {
+        cursor = std::strchr(cursor + 1, ' ');
+        if (!cursor) {
+            return false;
+        }
+    }
+    startTime = std::strtoull(cursor + 1, nullptr, 10);
+    return true;
+}
+#endif
+} // namespace
+
+// ===================== ProcessHandle 类实现 =====================
+ProcessHandle::ProcessHandle(Native native, qint64 pid, quint64 startTime)
+    : m_native(native)
+    , m_pid(pid)
+    , m_startTime(startTime)
+{
+}
+
+#ifdef Q_OS_WIN
+std::unique_ptr<ProcessHandle> ProcessHandle::open(qint64 pid, quint64 startTime, int* errorCode) {
+    HW_TRACE_SCOPE("process", "OpenProcess");
+    // 受限查询权限足以读取创建时间、CPU 时间、工作集与映像路径；SYNCHRONIZE 用于判断是否已退出
+    HANDLE hProcess = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION | SYNCHRONIZE, FALSE, static_cast<DWORD>(pid));
+    if (hProcess == nullptr) {
+        if (errorCode) {
+            *errorCode = static_cast<int>(GetLastError());
+        }
+        return nullptr;
+    }
+    FILETIME creation, exit, kernel, user;
+    if (!GetProcessTimes(hProcess, &creation, &exit, &kernel, &user)) {
+        // 先取错误码：CloseHandle 可能覆盖它
+        if (errorCode) {
+            *errorCode = static_cast<int>(GetLastError());
+        }
+        CloseHandle(hProcess);
+        return nullptr;
+    }
+    const quint64 created = (static_cast<quint64>(creation.dwHighDateTime) << 32) | creation.dwLowDateTime;
+    if (startTime != 0 && created != startTime) {
+        if (errorCode) {
+            *errorCode = 0;
+        }
+        CloseHandle(hProcess);
+        return nullptr;
+    }
+    return std::unique_ptr<ProcessHandle>(new ProcessHandle(hProcess, pid, created));
+}
+
+ProcessHandle::~ProcessHandle() {
+    CloseHandle(m_native);
+}
+
+bool ProcessHandle::isAlive() const {
+    return WaitForSingleObject(m_native, 0) == WAIT_TIMEOUT;
+}
+#endif
+
+#ifdef Q_OS_LINUX
+std::unique_ptr<ProcessHandle> ProcessHandle::open(qint64 pid, quint64 startTime, int* errorCode) {
+    HW_TRACE_SCOPE("process", "pidfd_open");
+    const int fd = static_cast<int>(syscall(SYS_pidfd_open, static_cast<pid_t>(pid), 0));
+    if (fd < 0) {
+        if (errorCode) {
+            *errorCode = errno;
+        }
+        return nullptr;
+    }
+    // 先取得 pidfd 再读 starttime：若读到的值相符，pidfd 指向的必然是同一个进程
+    quint64 started = 0;
+    const bool haveStartTime = readStartTime(pid, started);
+    if (!haveStartTime || (startTime != 0 && started != startTime)) {
+        // 读不到 stat 说明进程已在两次调用之间退出
+        if (errorCode) {
+            *errorCode = haveStartTime ? 0 : ESRCH;
+        }
+        close(fd);
+        return nullptr;
+    }
+    return std::unique_ptr<ProcessHandle>(new ProcessHandle(fd, pid, started));
+}
+
+ProcessHandle::~ProcessHandle() {
+    close(m_native);
+}
+
+bool ProcessHandle::isAlive() const {
+    // 进程退出后 pidfd 变为可读
+    pollfd descriptor = { m_native, POLLIN, 0 };
+    return poll(&descriptor, 1, 0) == 0;
+}
+#endif
+
+// ===================== ProcessHandleCache 类实现 =====================
+ProcessHandleCache::ProcessHandleCache(int capacity, int idleMs)
+    : m_capacity(qMax(1, capacity))
+    , m_idleNs(static_cast<quint64>(qMax(0, idleMs)) * 1000000ull)
+{
+}
+
+ProcessHandleCache& ProcessHandleCache::instance() {
+    static ProcessHandleCache cache;
+    return cache;
+}
+
+std::shared_ptr<ProcessHandle> ProcessHandleCache::acquire(qint64 pid, quint64 startTime) {
+    if (pid <= 0) {
+        return nullptr;
+    }
+    const quint64 now = Metrics::now();
+    QMutexLocker locker(&m_mutex);
+    evictIdleLocked(now);
+
+    const auto found = m_index.constFind(pid);
+    if (found != m_index.constEnd()) {
+        const EntryList::iterator it = found.value();
+        if (it->handle->isAlive()) {
+            // 存活进程独占该 PID：创建时间不符说明所要的进程早已退出
+            if (startTime != 0 && it->handle->startTime() != startTime) {
+                return nullptr;
+            }
+            ++m_stats.hits;
+            it->lastUsed = now;
+            m_entries.splice(m_entries.begin(), m_entries, it);
+            return it->handle;
+        }
+        eraseLocked(it);
+    }
+
+    // 打开进程是系统调用，不在锁内进行；并发打开同一进程时以后完成者为准
+    locker.unlock();
+    std::shared_ptr<ProcessHandle> handle(ProcessHandle::open(pid, startTime));
+    locker.relock();
+    ++m_stats.opens;
+    if (!handle) {
+        ++m_stats.failures;
+        return nullptr;
+    }
+    const auto existing = m_index.constFind(pid);
+    if (existing != m_index.constEnd()) {
+        eraseLocked(existing.value());
+    }
+    // 采样按 PID 顺序循环访问全部进程，进程数超过容量时按 LRU 淘汰会让每次访问都落空。
+    // 缓存已满时新句柄不入缓存、用完即关，已缓存的句柄等空闲超时或进程退出后再让位
+    if (m_index.size() >= m_capacity) {
+        ++m_stats.uncached;
+        return handle;
+    }
+    m_entries.push_front({ handle, now });
+    m_index.insert(pid, m_entries.begin());
+    return handle;
+}
+
+std::shared_ptr<ProcessHandle> ProcessHandleCache::acquireTransient(qint64 pid, quint64 startTime, int* errorCode) {
+    if (pid <= 0) {
+        if (errorCode) {
+            *errorCode = 0;
+        }
+        return nullptr;
+    }
+    {
+        QMutexLocker locker(&m_mutex);
+        const auto found = m_index.constFind(pid);
+        if (found != m_index.constEnd() && found.value()->handle->isAlive()) {
+            const std::shared_ptr<ProcessHandle>& handle = found.value()->handle;
+            if (startTime != 0 && handle->startTime() != startTime) {
+                if (errorCode) {
+                    *errorCode = 0;
+                }
+                return nullptr;
+            }
+            ++m_stats.hits;
+            return handle;
+        }
+    }
+    std::shared_ptr<ProcessHandle> handle(ProcessHandle::open(pid, startTime, errorCode));
+    QMutexLocker locker(&m_mutex);
+    ++m_stats.opens;
+    if (!handle) {
+        ++m_stats.failures;
+        return nullptr;
+    }
+    ++m_stats.transient;
+    return handle;
+}
+
+void ProcessHandleCache::remove(qint64 pid) {
+    QMutexLocker locker(&m_mutex);
+    const auto found = m_index.constFind(pid);
+    if (found != m_index.constEnd()) {
+        eraseLocked(found.value());
+    }
+}
+
+void ProcessHandleCache::evictIdle() {
+    const quint64 now = Metrics::now();
+    QMutexLocker locker(&m_mutex);
+    evictIdleLocked(now);
+}
+
+void ProcessHandleCache::clear() {
+    QMutexLocker locker(&m_mutex);
+    m_stats.evictions += m_entries.size();
+    m_entries.clear();
+    m_index.clear();
+}
+
+ProcessHandleCache::Stats ProcessHandleCache::stats() const {
+    QMutexLocker locker(&m_mutex);
+    Stats stats = m_stats;
+    stats.open = static_cast<int>(m_index.size());
+    return stats;
+}
+
+void ProcessHandleCache::evictIdleLocked(quint64 now) {
+    // 尾部最久未用，遇到第一个未超时的条目即可停止
+    // 其他线程可能刚以更晚的时刻更新过条目，now 较小时不算超时
+    while (!m_entries.empty() && now > m_entries.back().lastUsed && now - m_entries.back().lastUsed > m_idleNs) {
+        eraseLocked(std::prev(m_entries.end()));
+    }
+}
+
+void ProcessHandleCache::eraseLocked(EntryList::iterator it) {
+    m_index.remove(it->handle->pid());
+    m_entries.erase(it);
+    ++m_stats.evictions;
+}
@@ -0,0 +1,112 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+#ifndef PROCESSHANDLECACHE_H
+#define PROCESSHANDLECACHE_H
+// 按需获取的进程句柄：只申请查询与等待退出所需的最小权限，放在有上限的缓存中，
+// 长时间未使用或进程退出后关闭。模型与快照只保存 PID 与创建时间，不持有句柄
+#include <QHash>
+#include <QMutex>
+#include <QtGlobal>
+#include <list>
+#include <memory>
+#include "ProcessDiff.h"
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#endif
+
+// 一个已打开的进程句柄（Windows 为 HANDLE，Linux 为 pidfd），析构时关闭
+class ProcessHandle {
+public:
+#ifdef Q_OS_WIN
+    using Native = HANDLE;
+#else
+    using Native = int;
+#endif
+    // 以最小权限打开进程；startTime 非 0 时校验创建时间，不符（PID 已被复用）或无法打开时返回空
+    // 并写入 errorCode：失败调用之后立即取得的系统错误码，创建时间不符时为 0
+    static std::unique_ptr<ProcessHandle> open(qint64 pid, quint64 startTime, int* errorCode = nullptr);
+    ~ProcessHandle();
+    ProcessHandle(const ProcessHandle&) = delete;
+    ProcessHandle& operator=(const ProcessHandle&) = delete;
+
+    Native native() const { return m_native; }
+    qint64 pid() const { return m_pid; }
+    // 打开时读取的创建时间，与 ProcessEntry::startTime 同源
+    quint64 startTime() const { return m_startTime; }
+    // 进程尚未退出。进程存活期间其 PID 不会被复用，因此存活的句柄总是指向同一个进程
+    bool isAlive() const;
+
+private:
+    ProcessHandle(Native native, qint64 pid, quint64 startTime);
+
+    Native m_native;
+    qint64 m_pid;
+    quint64 m_startTime;
+};
+
+// 线程安全的进程句柄缓存。取出的句柄由 shared_ptr 持有，被淘汰后仍在使用的句柄
+// 会在最后一个使用者释放时关闭
+class ProcessHandleCache {
+public:
+    static constexpr int kDefaultCapacity = 1024;
+    static constexpr int kDefaultIdleMs = 30000;
+
+    struct Stats {
+        quint64 hits = 0;
+        quint64 opens = 0;     // 实际打开（含失败）的次数
+        quint64 failures = 0;  // 无法打开或创建时间不符
+        quint64 uncached = 0;  // 缓存已满，打开后未放入缓存
+        quint64 transient = 0; // acquireTransient 打开、用完即关的句柄
+        quint64 evictions = 0; // 因空闲或进程退出而关闭
+        int open = 0;          // 当前缓存中的句柄数
+    };
+
+    explicit ProcessHandleCache(int capacity = kDefaultCapacity, int idleMs = kDefaultIdleMs);
+
+    // 全局共享的实例（快照、采样与窗口系统共用）
+    static ProcessHandleCache& instance();
+
+    // 取 (pid, startTime) 对应的句柄；startTime 为 0 时不校验创建时间。
+    // 缓存的句柄所属进程已退出时重新打开；无法打开时返回空。缓存已满时返回的句柄不入缓存
+    std::shared_ptr<ProcessHandle> acquire(qint64 pid, quint64 startTime = 0);
+    std::shared_ptr<ProcessHandle> acquire(const ProcessKey& key) { return acquire(key.pid, key.startTime); }
+    // 一次性的访问（例如完整快照逐个查询全部进程）：缓存中有存活的句柄时复用，否则打开一个
+    // 不入缓存的句柄，调用方释放即关闭。不更新使用时间，也不会让缓存被一次遍历占满。
+    // 返回空时 errorCode 的含义同 ProcessHandle::open
+    std::shared_ptr<ProcessHandle> acquireTransient(qint64 pid, quint64 startTime = 0, int* errorCode = nullptr);
+    // 进程退出时调用，立即关闭句柄，避免退出的进程对象被句柄拖住
+    void remove(qint64 pid);
+    // 关闭超过空闲时限的句柄。acquire 时也会顺带检查；长时间没有 acquire 时
+    // 由持有者定时调用（见 HideProcess），否则空闲句柄会一直保持打开
+    void evictIdle();
+    int idleMs() const { return static_cast<int>(m_idleNs / 1000000ull); }
+    void clear();
+    Stats stats() const;
+
+private:
+    struct Entry {
+        std::shared_ptr<ProcessHandle> handle;
+        quint64 lastUsed; // 单调时钟，纳秒
+    };
+    using EntryList = std::list<Entry>;
+    void evictIdleLocked(quint64 now);
+    void eraseLocked(EntryList::iterator it);
+
+    const int m_capacity;
+    const quint64 m_idleNs;
+    mutable QMutex m_mutex;
+    EntryList m_entries; // 头部为最近使用
+    QHash<qint64, EntryList::iterator> m_index;
+    Stats m_stats;
+};
+#endif
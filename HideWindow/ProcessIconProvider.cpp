@@ -0,0 +1,239 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "ProcessIconProvider.h"
+#include "Trace.h"
+#include <QMetaObject>
+#include <QUrl>
+#include <algorithm>
+
+namespace {
+// 每个缓存条目除像素外的固定开销（键、链表节点与哈希槽）
+constexpr qint64 kEntryOverhead = 128;
+
+// 单个请求对应的 QML 响应：解码结果到达后排队发出 finished，
+// 避免在 requestImageResponse() 返回之前发出信号
+class IconResponse : public QQuickImageResponse {
+public:
+    void setRequest(std::shared_ptr<IconRequest> request) { m_request = std::move(request); }
+
+    void deliver(const QImage& image) {
+        {
+            QMutexLocker locker(&m_mutex);
+            m_image = image;
+        }
+        QMetaObject::invokeMethod(this, &QQuickImageResponse::finished, Qt::QueuedConnection);
+    }
+
+    QQuickTextureFactory* textureFactory() const override {
+        QMutexLocker locker(&m_mutex);
+        return QQuickTextureFactory::textureFactoryForImage(m_image);
+    }
+
+    void cancel() override {
+        // 委托滚出视图时调用；finished 仍会照常发出
+        if (m_request) {
+            m_request->cancel();
+        }
+    }
+
+private:
+    mutable QMutex m_mutex;
+    QImage m_image;
+    std::shared_ptr<IconRequest> m_request;
+};
+} // namespace
+
+// ===================== IconCache 类实现 =====================
+IconCache::IconCache(qint64 budgetBytes)
+    : m_budget(budgetBytes)
+{
+}
+
+bool IconCache::find(const QString& key, QImage& image) {
+    const auto it = m_index.constFind(key);
+    if (it == m_index.constEnd()) {
+        return false;
+    }
+    m_entries.splice(m_entries.begin(), m_entries, it.value());
+    image = it.value()->image;
+    return true;
+}
+
+void IconCache::insert(const QString& key, const QImage& image) {
+    // 没有图标的路径也缓存下来，避免反复尝试解码
+    const qint64 cost = image.sizeInBytes() + key.size() * static_cast<qint64>(sizeof(QChar)) + kEntryOverhead;
+    const auto it = m_index.find(key);
+    if (it != m_index.end()) {
+        m_bytes -= it.value()->cost;
+        m_entries.erase(it.value());
+        m_index.erase(it);
+    }
+    if (cost > m_budget) {
+        return;
+    }
+    m_entries.push_front({ key, image, cost });
+    m_index.insert(key, m_entries.begin());
+    m_bytes += cost;
+    evict();
+}
+
+void IconCache::setBudget(qint64 budgetBytes) {
+    m_budget = budgetBytes;
+    evict();
+}
+
+void IconCache::clear() {
+    m_entries.clear();
+    m_index.clear();
+    m_bytes = 0;
+}
+
+void IconCache::evict() {
+    while (m_bytes > m_budget && !m_entries.empty()) {
+        const Entry& oldest = m_entries.back();
+        m_bytes -= oldest.cost;
+        m_index.remove(oldest.key);
+        m_entries.pop_back();
+    }
+}
+
+// ===================== IconFetcher 类实现 =====================
+IconFetcher::IconFetcher(std::unique_ptr<IconLoader> loader, int maxThreads, qint64 cacheBytes)
+    : m_loader(std::move(loader))
+    , m_cache(cacheBytes)
+{
+    m_pool.setMaxThreadCount(qMax(1, maxThreads));
+}
+
+IconFetcher::~IconFetcher() {
+    waitForDone();
+}
+
+std::shared_ptr<IconRequest> IconFetcher::request(const QString& exePath, const QSize& size, IconRequest::Callback callback) {
+    std::shared_ptr<IconRequest> request(new IconRequest(std::move(callback)));
+    if (exePath.isEmpty() || !m_loader) {
+        request->m_callback(QImage());
+        return request;
+    }
+
+    const QString key = cacheKey(exePath, size);
+    QImage image;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_cache.find(key, image)) {
+            ++m_stats.misses;
+            auto it = m_pending.find(key);
+            if (it != m_pending.end()) {
+                // 同一图标已在解码，等待同一个结果
+                ++m_stats.joined;
+                it->waiters.push_back(request);
+                return request;
+            }
+            Pending& pending = m_pending[key];
+            pending.exePath = exePath;
+            pending.size = size;
+            pending.waiters.push_back(request);
+            locker.unlock();
+            m_pool.start([this, key] { run(key); });
+            return request;
+        }
+        ++m_stats.hits;
+    }
+    request->m_callback(image);
+    return request;
+}
+
+void IconFetcher::setCacheBudget(qint64 budgetBytes) {
+    QMutexLocker locker(&m_mutex);
+    m_cache.setBudget(budgetBytes);
+}
+
+void IconFetcher::waitForDone() {
+    m_pool.waitForDone();
+}
+
+IconFetcher::Stats IconFetcher::stats() const {
+    QMutexLocker locker(&m_mutex);
+    Stats stats = m_stats;
+    stats.cacheBytes = m_cache.bytes();
+    stats.cacheCount = m_cache.count();
+    return stats;
+}
+
+QString IconFetcher::cacheKey(const QString& exePath, const QSize& size) {
+    // 同一路径的不同尺寸分别缓存
+    return QString("%1|%2x%3").arg(exePath).arg(size.width()).arg(size.height());
+}
+
+void IconFetcher::run(const QString& key) {
+    HW_TRACE_SCOPE("icon", "IconFetcher::run");
+    QString exePath;
+    QSize size;
+    bool wanted = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        const Pending& pending = m_pending[key];
+        exePath = pending.exePath;
+        size = pending.size;
+        wanted = std::any_of(pending.waiters.begin(), pending.waiters.end(),
+            [](const std::shared_ptr<IconRequest>& request) { return !request->isCancelled(); });
+    }
+
+    // 解码期间不持锁，其他请求可以继续命中缓存或合并进来
+    QImage image;
+    if (wanted) {
+        image = m_loader->load(exePath, size);
+    }
+
+    std::vector<std::shared_ptr<IconRequest>> waiters;
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = m_pending.find(key);
+        if (wanted) {
+            ++m_stats.loads;
+            m_cache.insert(key, image);
+            waiters.swap(it->waiters);
+            m_pending.erase(it);
+        }
+        else {
+            // 检查之后又有请求合并进来：只打发已取消的请求，剩下的重新排队解码
+            auto alive = std::stable_partition(it->waiters.begin(), it->waiters.end(),
+                [](const std::shared_ptr<IconRequest>& request) { return request->isCancelled(); });
+            waiters.assign(it->waiters.begin(), alive);
+            it->waiters.erase(it->waiters.begin(), alive);
+            if (it->waiters.empty()) {
+                ++m_stats.skipped;
+                m_pending.erase(it);
+            }
+            else {
+                m_pool.start([this, key] { run(key); });
+            }
+        }
+    }
+    for (const std::shared_ptr<IconRequest>& request : waiters) {
+        request->m_callback(image);
+    }
+}
+
+// ===================== ProcessIconProvider 类实现 =====================
+ProcessIconProvider::ProcessIconProvider(std::unique_ptr<IconLoader> loader, int maxThreads, qint64 cacheBytes)
+    : m_fetcher(std::move(loader), maxThreads, cacheBytes)
+{
+}
+
+QQuickImageResponse* ProcessIconProvider::requestImageResponse(const QString& id, const QSize& requestedSize) {
+    // QML 侧用 encodeURIComponent 编码路径，这里还原反斜杠、空格等字符
+    const QString exePath = QUrl::fromPercentEncoding(id.toUtf8());
+    IconResponse* response = new IconResponse;
+    response->setRequest(m_fetcher.request(exePath, requestedSize,
+        [response](const QImage& image) { response->deliver(image); }));
+    return response;
+}
@@ -0,0 +1,136 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+#ifndef PROCESSICONPROVIDER_H
+#define PROCESSICONPROVIDER_H
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QQuickAsyncImageProvider>
+#include <QSize>
+#include <QString>
+#include <QThreadPool>
+#include <QtGlobal>
+#include <atomic>
+#include <functional>
+#include <list>
+#include <memory>
+#include <vector>
+#include "IconLoader.h"
+
+// 按字节预算淘汰的 LRU 图像缓存。本身不加锁，由 IconFetcher 在持锁时访问
+class IconCache {
+public:
+    explicit IconCache(qint64 budgetBytes);
+
+    // 命中时把条目移到最近使用的一端
+    bool find(const QString& key, QImage& image);
+    // 插入后从最久未用的一端淘汰，直到总字节数不超过预算；单个超预算的图像不缓存
+    void insert(const QString& key, const QImage& image);
+    void setBudget(qint64 budgetBytes);
+    void clear();
+
+    qint64 budget() const { return m_budget; }
+    qint64 bytes() const { return m_bytes; }
+    int count() const { return static_cast<int>(m_index.size()); }
+
+private:
+    struct Entry {
+        QString key;
+        QImage image;
+        qint64 cost;
+    };
+    void evict();
+
+    std::list<Entry> m_entries; // 头部为最近使用
+    QHash<QString, std::list<Entry>::iterator> m_index;
+    qint64 m_budget;
+    qint64 m_bytes = 0;
+};
+
+// 一次图标请求。回调恰好调用一次：命中缓存时在 request() 内同步调用，否则在工作线程上调用；
+// 取消只是提示，若同一图标的所有请求都已取消则跳过解码，回调仍会以空图像调用
+class IconRequest {
+public:
+    using Callback = std::function<void(const QImage&)>;
+
+    void cancel() { m_cancelled.store(true, std::memory_order_relaxed); }
+    bool isCancelled() const { return m_cancelled.load(std::memory_order_relaxed); }
+
+private:
+    friend class IconFetcher;
+    explicit IconRequest(Callback callback) : m_callback(std::move(callback)) {}
+
+    Callback m_callback;
+    std::atomic<bool> m_cancelled{ false };
+};
+
+// 与 Qt Quick 无关的图标获取核心：缓存查找、同一图标的并发请求合并、有界线程池解码。
+// 所有公开方法可在任意线程调用
+class IconFetcher {
+public:
+    struct Stats {
+        quint64 hits = 0;    // 直接命中缓存
+        quint64 misses = 0;  // 未命中（含合并到进行中解码的请求）
+        quint64 joined = 0;  // 合并到进行中解码的请求
+        quint64 loads = 0;   // 实际调用 IconLoader::load 的次数
+        quint64 skipped = 0; // 因请求全部取消而跳过的解码
+        qint64 cacheBytes = 0;
+        int cacheCount = 0;
+    };
+
+    IconFetcher(std::unique_ptr<IconLoader> loader, int maxThreads, qint64 cacheBytes);
+    ~IconFetcher();
+    IconFetcher(const IconFetcher&) = delete;
+    IconFetcher& operator=(const IconFetcher&) = delete;
+
+    // exePath 为空时立即以空图像回调
+    std::shared_ptr<IconRequest> request(const QString& exePath, const QSize& size, IconRequest::Callback callback);
+    void setCacheBudget(qint64 budgetBytes);
+    // 等待所有已提交的解码完成
+    void waitForDone();
+    Stats stats() const;
+
+private:
+    // 同一缓存键上进行中的解码及等待它的请求
+    struct Pending {
+        QString exePath;
+        QSize size;
+        std::vector<std::shared_ptr<IconRequest>> waiters;
+    };
+    static QString cacheKey(const QString& exePath, const QSize& size);
+    void run(const QString& key);
+
+    std::unique_ptr<IconLoader> m_loader;
+    mutable QMutex m_mutex; // 保护 m_cache、m_pending 与 m_stats
+    IconCache m_cache;
+    QHash<QString, Pending> m_pending;
+    Stats m_stats;
+    QThreadPool m_pool; // 最后声明，析构时最先等待工作线程结束
+};
+
+// QML 中以 "image://processicon/<百分号编码的可执行文件路径>" 引用进程图标。
+// svchost.exe 等同一程序的多个实例共用缓存中的同一张图像
+class ProcessIconProvider : public QQuickAsyncImageProvider {
+public:
+    static constexpr int kDefaultThreadCount = 2;
+    static constexpr qint64 kDefaultCacheBytes = 4 * 1024 * 1024;
+
+    explicit ProcessIconProvider(std::unique_ptr<IconLoader> loader = createDefaultIconLoader(),
+        int maxThreads = kDefaultThreadCount, qint64 cacheBytes = kDefaultCacheBytes);
+
+    QQuickImageResponse* requestImageResponse(const QString& id, const QSize& requestedSize) override;
+    IconFetcher& fetcher() { return m_fetcher; }
+
+private:
+    IconFetcher m_fetcher;
+};
+#endif
@@ -9,15 +9,32 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 #include "ProcessListModel.h"
+#include "AsyncLog.h"
+#include "Metrics.h"
+#include "ProcessHandleCache.h"
+#include "Trace.h"
 #include <QDebug>
-#include <qfileinfo.h>
-#include <Psapi.h>
-#include <tlhelp32.h>
+#include <QHash>
+#include <algorithm>
 
+#ifdef Q_OS_WIN
 // 链接所需的 Windows 库
-#pragma comment(lib, "Psapi.lib")
 #pragma comment(lib, "User32.lib")
 #pragma comment(lib, "Kernel32.lib")
+#endif
+
+namespace {
+AsyncLog::Category s_processLog("process", 20);
+
+// 进程事件的合并窗口：进程风暴时每个窗口只更新一次模型
+constexpr int kEventCoalesceMs = 50;
+// 工作集按 64 KB 取整后再比较，页级别的抖动不触发界面更新
+constexpr quint64 kWorkingSetGranularity = 64 * 1024;
+
+bool pidLess(const ProcessEntry& a, const ProcessEntry& b) {
+    return a.pid < b.pid;
+}
+} // namespace
 
 // ===================== Process 类实现 =====================
 Process::Process(QObject* parent)
@@ -25,91 +42,256 @@ Process::Process(QObject* parent)
 {
 }
 
-Process::Process(HANDLE handle, QObject* parent)
+Process::Process(const ProcessEntry& entry, QObject* parent)
     : QObject(parent)
-    , m_handle(handle)
+    , m_entry(entry)
 {
 }
 
-Process::~Process() {
-    // 关闭进程句柄，避免资源泄漏
-    if (m_handle != INVALID_HANDLE_VALUE) {
-        CloseHandle(m_handle);
-        m_handle = INVALID_HANDLE_VALUE;
+qint64 Process::getPID() const {
+    return m_entry.pid > 0 ? m_entry.pid : -1;
+}
+
+QString Process::getFile() const {
+    return m_entry.exePath;
+}
+
+QString Process::getName() const {
+    if (m_entry.name.isEmpty()) {
+        return QString("Unknown Process (PID: %1)").arg(getPID());
     }
+    return m_entry.name;
 }
 
-qint64 Process::getPID() const {
-    if (m_handle == INVALID_HANDLE_VALUE) {
-        return -1;
+// ===================== ProcessListModel 类实现 =====================
+ProcessListModel::ProcessListModel(QObject* parent)
+    : QAbstractListModel(parent)
+    , m_source(createDefaultProcessSource())
+    , m_eventSource(createDefaultProcessEventSource())
+    , m_statsSource(createDefaultProcessStatsSource())
+{
+    m_eventTimer.setSingleShot(true);
+    m_eventTimer.setInterval(kEventCoalesceMs);
+    connect(&m_eventTimer, &QTimer::timeout, this, &ProcessListModel::drainProcessEvents);
+    connect(&m_reconcileTimer, &QTimer::timeout, this, &ProcessListModel::refresh);
+    connect(&m_statsTimer, &QTimer::timeout, this, &ProcessListModel::sampleStats);
+    if (m_statsInterval > 0) {
+        m_statsTimer.start(m_statsInterval);
     }
-    return GetProcessId(m_handle);
 }
 
-QString Process::getFile() const {
-    if (m_handle == INVALID_HANDLE_VALUE) {
-        return QString();
+ProcessListModel::~ProcessListModel() {
+    // 先停止事件线程，它会回调本对象
+    stopLiveUpdates();
+    // 等待后台刷新与采样结束，避免线程访问已销毁的缓冲区
+    cancelRefreshWorker();
+    cancelStatsWorker();
+}
+
+bool ProcessListModel::incrementalRefresh() const {
+    return m_incrementalRefresh;
+}
+
+void ProcessListModel::setIncrementalRefresh(bool enabled) {
+    if (m_incrementalRefresh == enabled) {
+        return;
     }
+    m_incrementalRefresh = enabled;
+    emit incrementalRefreshChanged();
+}
+
+bool ProcessListModel::isRefreshing() const {
+    return m_refreshing;
+}
+
+void ProcessListModel::setRefreshing(bool refreshing) {
+    if (m_refreshing == refreshing) {
+        return;
+    }
+    m_refreshing = refreshing;
+    emit refreshingChanged();
+}
+
+void ProcessListModel::setProcessSource(std::unique_ptr<ProcessSource> source) {
+    const bool wasRefreshing = m_worker != nullptr;
+    cancelRefreshWorker();
+    m_source = std::move(source);
+    if (wasRefreshing) {
+        startRefreshWorker();
+    }
+}
+
+bool ProcessListModel::liveUpdates() const {
+    return m_liveUpdates;
+}
 
-    // 获取进程可执行文件路径
-    WCHAR szPath[MAX_PATH] = { 0 };
-    if (GetModuleFileNameExW(m_handle, nullptr, szPath, MAX_PATH)) {
-        return QString::fromWCharArray(szPath);
+void ProcessListModel::setLiveUpdates(bool enabled) {
+    if (m_liveUpdates == enabled) {
+        return;
+    }
+    m_liveUpdates = enabled;
+    if (enabled) {
+        // 停止期间错过的事件无从得知，重新开始前先校准一次
+        refresh();
     }
     else {
-        qWarning() << "Failed to get process file path. Error:" << GetLastError();
-        return QString();
+        stopLiveUpdates();
     }
+    emit liveUpdatesChanged();
 }
 
-QString Process::getName() const {
-    QString filePath = getFile();
-    if (filePath.isEmpty()) {
-        return QString("Unknown Process (PID: %1)").arg(getPID());
+int ProcessListModel::reconcileInterval() const {
+    return m_reconcileInterval;
+}
+
+void ProcessListModel::setReconcileInterval(int ms) {
+    ms = qMax(ms, 0);
+    if (m_reconcileInterval == ms) {
+        return;
+    }
+    m_reconcileInterval = ms;
+    if (m_reconcileTimer.isActive() || (ms > 0 && m_eventSource && m_eventSource->isRunning())) {
+        if (ms > 0) {
+            m_reconcileTimer.start(ms);
+        }
+        else {
+            m_reconcileTimer.stop();
+        }
     }
-    // 从路径中提取文件名
-    return QFileInfo(filePath).fileName();
+    emit reconcileIntervalChanged();
 }
 
-HANDLE Process::getHandle() const {
-    return m_handle;
+void ProcessListModel::setProcessEventSource(std::unique_ptr<ProcessEventSource> source) {
+    const bool wasRunning = m_eventSource && m_eventSource->isRunning();
+    stopLiveUpdates();
+    m_eventSource = std::move(source);
+    if (wasRunning) {
+        startLiveUpdates();
+    }
 }
 
-qint64 Process::getHandleAsInt() const {
-    return reinterpret_cast<qint64>(m_handle);
+ProcessEventSource* ProcessListModel::processEventSource() const {
+    return m_eventSource.get();
 }
 
-// ===================== ProcessListModel 类实现 =====================
-ProcessListModel::ProcessListModel(QObject* parent)
-    : QAbstractListModel(parent)
-{
+int ProcessListModel::statsInterval() const {
+    return m_statsInterval;
 }
 
-ProcessListModel::~ProcessListModel() {
-    // 清理所有 Process 对象
-    clearProcesses();
+void ProcessListModel::setStatsInterval(int ms) {
+    ms = qMax(ms, 0);
+    if (m_statsInterval == ms) {
+        return;
+    }
+    m_statsInterval = ms;
+    if (ms > 0) {
+        m_statsTimer.start(ms);
+    }
+    else {
+        m_statsTimer.stop();
+        // 恢复采样后的第一次差值不应跨越停止的这段时间
+        m_statsSampler.clear();
+        // 采样是句柄的主要使用者，停止后不必等空闲超时再关闭
+        ProcessHandleCache::instance().clear();
+    }
+    emit statsIntervalChanged();
+}
+
+void ProcessListModel::setProcessStatsSource(std::unique_ptr<ProcessStatsSource> source) {
+    cancelStatsWorker();
+    m_statsSource = std::move(source);
+    m_statsSampler.clear();
+}
+
+void ProcessListModel::startLiveUpdates() {
+    if (!m_liveUpdates || !m_eventSource || m_eventSource->isRunning()) {
+        return;
+    }
+    // notify 在事件线程调用，只负责把合并计时器的启动转到 GUI 线程
+    const auto notify = [this]() {
+        QMetaObject::invokeMethod(this, [this]() {
+            if (!m_eventTimer.isActive()) {
+                m_eventTimer.start();
+            }
+        }, Qt::QueuedConnection);
+    };
+    bool started = m_eventSource->start(notify);
+    if (!started) {
+        // 例如 netlink 套接字已绑定但订阅被拒绝：换成事件源给出的替代实现再试一次
+        if (std::unique_ptr<ProcessEventSource> fallback = m_eventSource->createFallback()) {
+            qInfo() << "Process event source failed to start, using its fallback";
+            m_eventSource = std::move(fallback);
+            started = m_eventSource->start(notify);
+        }
+    }
+    if (!started) {
+        qWarning() << "Process event source failed to start, live updates disabled";
+        return;
+    }
+    if (m_reconcileInterval > 0) {
+        m_reconcileTimer.start(m_reconcileInterval);
+    }
+}
+
+void ProcessListModel::stopLiveUpdates() {
+    m_eventTimer.stop();
+    m_reconcileTimer.stop();
+    if (m_eventSource) {
+        m_eventSource->stop();
+        // 丢弃残留事件，下次开始时由完整刷新校准
+        m_eventSource->takeEvents(m_events);
+    }
+    m_events.clear();
 }
 
 int ProcessListModel::rowCount(const QModelIndex& parent) const {
     Q_UNUSED(parent);
-    return m_processes.count();
+    return m_rows.count();
 }
 
 QVariant ProcessListModel::data(const QModelIndex& index, int role) const {
-    if (!index.isValid() || index.row() >= m_processes.count()) {
+    if (!index.isValid() || index.row() >= m_rows.count()) {
         return QVariant();
     }
 
-    Process* process = m_processes.at(index.row());
+    return roleData(index.row(), role);
+}
+
+void ProcessListModel::multiData(const QModelIndex& index, QModelRoleDataSpan roleDataSpan) const {
+    if (!index.isValid() || index.row() >= m_rows.count()) {
+        for (QModelRoleData& data : roleDataSpan) {
+            data.clearData();
+        }
+        return;
+    }
+
+    for (QModelRoleData& data : roleDataSpan) {
+        data.setData(roleData(index.row(), data.role()));
+    }
+}
+
+QVariant ProcessListModel::roleData(int row, int role) const {
+    // 只读取快照时缓存的元数据，绘制过程中不产生系统调用
     switch (role) {
-    case NameRole:
-        return process->getName();
+    case NameRole: {
+        QString name = m_rows.name(row);
+        if (name.isEmpty()) {
+            return QString("Unknown Process (PID: %1)").arg(m_rows.pid(row));
+        }
+        return name;
+    }
     case PidRole:
-        return process->getPID();
+        return m_rows.pid(row);
     case FileRole:
-        return process->getFile();
-    case HandleRole:
-        return process->getHandleAsInt();
+        return m_rows.exePath(row);
+    case ParentPidRole:
+        return m_rows.parentPid(row);
+    case StartTimeRole:
+        return m_rows.startTime(row);
+    case CpuRole:
+        return m_rows.cpuPermille(row) / 10.0;
+    case WorkingSetRole:
+        return m_rows.workingSet(row);
     default:
         return QVariant();
     }
@@ -120,6 +302,9 @@ QHash<int, QByteArray> ProcessListModel::roleNames() const {
     roles[NameRole] = "name";
     roles[PidRole] = "pid";
     roles[FileRole] = "file";
+    roles[ParentPidRole] = "parentPid";
+    roles[CpuRole] = "cpu";
+    roles[WorkingSetRole] = "workingSet";
     return roles;
 }
 
@@ -128,176 +313,356 @@ void ProcessListModel::addProcess(Process* process) {
         return;
     }
 
+    ProcessEntry entry = process->entry();
+    entry.pid = process->getPID();
+    entry.exePath = process->getFile();
+    entry.name = process->getName();
+    delete process;
+
     // Qt 模型添加数据的标准流程：beginInsertRows -> 添加数据 -> endInsertRows
-    beginInsertRows(QModelIndex(), m_processes.count(), m_processes.count());
-    m_processes.append(process);
+    beginInsertRows(QModelIndex(), m_rows.count(), m_rows.count());
+    m_rows.append(entry);
     endInsertRows();
 }
 
 void ProcessListModel::clearProcesses() {
-    if (m_processes.isEmpty()) {
+    if (m_rows.count() == 0) {
         return;
     }
 
     // Qt 模型删除数据的标准流程
-    beginRemoveRows(QModelIndex(), 0, m_processes.count() - 1);
-    // 释放所有 Process 对象内存
-    qDeleteAll(m_processes);
-    m_processes.clear();
+    beginRemoveRows(QModelIndex(), 0, m_rows.count() - 1);
+    m_rows.clear();
     endRemoveRows();
 }
 
 void ProcessListModel::enumerateWindowsProcesses() {
-    // 先清空现有进程列表
-    clearProcesses();
+    HW_TRACE_SCOPE("process", "enumerateWindowsProcesses");
+    refresh();
+}
 
-    // 创建进程快照
-    HANDLE hSnapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
-    if (hSnapshot == INVALID_HANDLE_VALUE) {
-        qWarning() << "Failed to create process snapshot. Error:" << GetLastError();
+void ProcessListModel::refresh() {
+    if (!m_source) {
+        qWarning() << "No process source installed";
         return;
     }
+    // 在快照开始前订阅，快照期间发生的变化排队等到快照应用之后再合并
+    startLiveUpdates();
+    if (m_reconcileTimer.isActive()) {
+        m_reconcileTimer.start(m_reconcileInterval);
+    }
 
-    PROCESSENTRY32W pe32 = { 0 };
-    pe32.dwSize = sizeof(PROCESSENTRY32W);
-
-    // 遍历第一个进程
-    if (!Process32FirstW(hSnapshot, &pe32)) {
-        qWarning() << "Failed to get first process. Error:" << GetLastError();
-        CloseHandle(hSnapshot);
+    if (m_worker) {
+        // 进行中的快照已过时：通知其尽快退出，结束后再统一刷新一次
+        m_cancelRefresh.store(true, std::memory_order_relaxed);
+        m_refreshPending = true;
         return;
     }
-
-    do {
-        // 打开进程（获取查询权限）
-        HANDLE hProcess = OpenProcess(
-            PROCESS_QUERY_INFORMATION | PROCESS_VM_READ,
-            FALSE,
-            pe32.th32ProcessID
-        );
-        
-        if(hProcess == 0)
-            {
-            qWarning() << "OpenProcess failed for PID:" << pe32.th32ProcessID
-                << ". Error:" << GetLastError();
-            continue; // 跳过无法打开的进程
-		}
-
-        if (hProcess != INVALID_HANDLE_VALUE) {
-            // 创建 Process 对象并添加到模型
-            Process* process = new Process(hProcess, this);
-            addProcess(process);
-        }
-        else {
-            // 有些系统进程无法打开，属于正常情况，仅打印警告
-            qWarning() << "Cannot open process (PID:" << pe32.th32ProcessID
-                << "). Error:" << GetLastError();
-        }
-
-    } while (Process32NextW(hSnapshot, &pe32));
-
-    // 关闭快照句柄
-    CloseHandle(hSnapshot);
+    startRefreshWorker();
 }
 
-// ===================== HideProcess 类实现 =====================
-HideProcess::HideProcess(QObject* parent)
-    : QObject(parent)
-{
+void ProcessListModel::startRefreshWorker() {
+    m_cancelRefresh.store(false, std::memory_order_relaxed);
+    m_refreshPending = false;
+
+    ProcessSource* source = m_source.get();
+    m_worker = QThread::create([this, source]() {
+        HW_TRACE_SCOPE("process", "refreshWorker");
+        m_snapshotSucceeded = source->snapshot(m_backBuffer, m_cancelRefresh);
+        // 行按 PID 排序：事件可以二分定位，校准时存活行的相对顺序也保持不变
+        if (m_snapshotSucceeded) {
+            std::sort(m_backBuffer.begin(), m_backBuffer.end(), pidLess);
+        }
+    });
+    m_worker->setObjectName(QStringLiteral("ProcessRefresh"));
+    connect(m_worker, &QThread::finished, this, &ProcessListModel::onRefreshFinished);
+    m_worker->start(QThread::LowPriority);
+    setRefreshing(true);
 }
 
-// 辅助函数：递归查找并隐藏指定PID的所有窗口
-void HideProcess::findWindows(HWND parentHwnd, HWND startHwnd, DWORD targetPid, std::function<void(HWND, DWORD)> run) {
-    // 查找父窗口下的子窗口（从 startHwnd 开始）
-    HWND hwnd = FindWindowEx(parentHwnd, startHwnd, nullptr, nullptr);
-    if (hwnd == nullptr) {
-        return; // 没有更多子窗口，终止递归
+void ProcessListModel::cancelRefreshWorker() {
+    if (!m_worker) {
+        return;
     }
+    m_cancelRefresh.store(true, std::memory_order_relaxed);
+    m_worker->disconnect(this);
+    m_worker->wait();
+    delete m_worker;
+    m_worker = nullptr;
+    m_refreshPending = false;
+    setRefreshing(false);
+}
 
-    run(hwnd, targetPid);
+void ProcessListModel::onRefreshFinished() {
+    m_worker->deleteLater();
+    m_worker = nullptr;
 
-    // 1. 递归遍历当前窗口的子窗口（深度优先）
-    //findWindows(hwnd, nullptr, targetPid, run);
-    // 2. 继续遍历同级窗口（广度优先）
-    findWindows(parentHwnd, hwnd, targetPid, run);
-}
+    if (m_snapshotSucceeded && !m_cancelRefresh.load(std::memory_order_relaxed)) {
+        // 交换前后缓冲：旧快照留作下一次后台刷新的写入目标，复用其容量
+        m_snapshot.swap(m_backBuffer);
+        applySnapshot(m_snapshot);
+    }
+    // 快照期间积压的事件在快照之后合并，较早的事件对新快照是无操作
+    drainProcessEvents();
 
-void HideProcess::hideProcess(Process* process) {
-    if (!process) {
-        qWarning() << "Process pointer is null!";
+    if (m_refreshPending) {
+        startRefreshWorker();
         return;
     }
-
-    qint64 pid = process->getPID();
-    hideProcess(pid);
+    setRefreshing(false);
 }
 
-void HideProcess::hideProcess(qint64 pid) {
-    if (pid <= 0) {
-        qWarning() << "Invalid PID:" << pid;
+void ProcessListModel::applySnapshot(const QList<ProcessEntry>& entries) {
+    HW_TRACE_SCOPE("process", "applySnapshot");
+    if (!m_incrementalRefresh) {
+        resetProcesses(entries);
         return;
     }
 
-    DWORD targetPid = static_cast<DWORD>(pid);
-    // 先校验进程是否存在（可选，增加鲁棒性）
-    HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION, FALSE, targetPid);
-    if (hProcess == INVALID_HANDLE_VALUE) {
-        qWarning() << "Cannot open process (PID:" << pid << "), need admin rights?";
-        return;
+    std::vector<ProcessKey> keys;
+    std::vector<RowSource> rows;
+    keys.reserve(entries.count());
+    rows.reserve(entries.count());
+    for (const ProcessEntry& entry : entries) {
+        keys.push_back(entry.key());
+        rows.push_back({ -1, &entry });
     }
-    CloseHandle(hProcess);
+    applyRows(keys, rows);
+}
 
-    qDebug() << "Trying to hide process (PID:" << pid << ")";
+void ProcessListModel::applyRows(const std::vector<ProcessKey>& keys, const std::vector<RowSource>& rows) {
+    std::vector<ProcessDiffOp> ops;
+    if (m_incrementalRefresh) {
+        std::vector<ProcessKey> oldKeys;
+        oldKeys.reserve(m_rows.count());
+        for (int row = 0; row < m_rows.count(); ++row) {
+            oldKeys.push_back(m_rows.key(row));
+        }
+        // 沿用的旧行内容必然未变，只比较带新条目的行
+        ops = diffProcessKeys(oldKeys, keys,
+            [&](int oldRow, int newIndex) {
+                const ProcessEntry* entry = rows[newIndex].entry;
+                return !entry || m_rows.sameContent(oldRow, *entry);
+            });
+    }
+    else {
+        ops.push_back({ ProcessDiffOp::Reset, 0, static_cast<int>(rows.size()) - 1 });
+    }
 
-    // 从桌面窗口开始遍历，初始 startHwnd 为 nullptr
-    findWindows(HWND_DESKTOP, nullptr, targetPid, &hideWindow);
+    for (const ProcessDiffOp& op : ops) {
+        switch (op.kind) {
+        case ProcessDiffOp::Reset: {
+            ProcessTable table;
+            table.reserve(static_cast<int>(rows.size()));
+            for (const RowSource& source : rows) {
+                if (source.entry) {
+                    table.append(*source.entry);
+                }
+                else {
+                    table.append(m_rows, source.oldRow);
+                }
+            }
+            beginResetModel();
+            m_rows.swap(table);
+            endResetModel();
+            return;
+        }
+        case ProcessDiffOp::Remove:
+            beginRemoveRows(QModelIndex(), op.first, op.last);
+            m_rows.remove(op.first, op.last - op.first + 1);
+            endRemoveRows();
+            break;
+        case ProcessDiffOp::Insert:
+            // 新键不会是沿用的旧行，entry 必然非空
+            beginInsertRows(QModelIndex(), op.first, op.last);
+            m_rows.insertGap(op.first, op.last - op.first + 1);
+            for (int row = op.first; row <= op.last; ++row) {
+                m_rows.set(row, *rows[row].entry);
+            }
+            endInsertRows();
+            break;
+        case ProcessDiffOp::Change:
+            for (int row = op.first; row <= op.last; ++row) {
+                m_rows.set(row, *rows[row].entry);
+            }
+            emit dataChanged(index(op.first), index(op.last));
+            break;
+        }
+    }
+    m_rows.compactStrings();
 }
 
-void HideProcess::showProcess(qint64 pid) {
-    if (pid <= 0) {
-        qWarning() << "Invalid PID:" << pid;
+void ProcessListModel::drainProcessEvents() {
+    if (!m_eventSource || m_worker) {
         return;
     }
-
-    DWORD targetPid = static_cast<DWORD>(pid);
-    // 先校验进程是否存在（可选，增加鲁棒性）
-    HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION, FALSE, targetPid);
-    if (hProcess == INVALID_HANDLE_VALUE) {
-        qWarning() << "Cannot open process (PID:" << pid << "), need admin rights?";
+    m_events.clear();
+    if (m_eventSource->takeEvents(m_events)) {
+        // 事件已经丢失，只能完整刷新
+        HW_LOG_INFO(s_processLog, "Process event queue overflowed, falling back to full refresh");
+        m_events.clear();
+        refresh();
         return;
     }
-    CloseHandle(hProcess);
+    if (!m_events.isEmpty()) {
+        applyEvents(m_events);
+    }
+}
 
-    qDebug() << "Trying to hide process (PID:" << pid << ")";
+void ProcessListModel::sampleStats() {
+    if (m_statsWorker || !m_statsSource || m_rows.count() == 0) {
+        return; // 上一次采样尚未结束时跳过本次
+    }
+    m_statsKeys.clear();
+    m_statsKeys.reserve(m_rows.count());
+    for (int row = 0; row < m_rows.count(); ++row) {
+        m_statsKeys.push_back(m_rows.key(row));
+    }
+    // 行通常已按 PID 排序；addProcess 追加的行可能打乱顺序
+    auto pidLessKey = [](const ProcessKey& a, const ProcessKey& b) { return a.pid < b.pid; };
+    if (!std::is_sorted(m_statsKeys.begin(), m_statsKeys.end(), pidLessKey)) {
+        std::sort(m_statsKeys.begin(), m_statsKeys.end(), pidLessKey);
+    }
 
-    // 从桌面窗口开始遍历，初始 startHwnd 为 nullptr
-    findWindows(HWND_DESKTOP, nullptr, targetPid, &showWindow);
+    ProcessStatsSource* source = m_statsSource.get();
+    m_statsWorker = QThread::create([this, source]() {
+        HW_TRACE_SCOPE("process", "statsWorker");
+        const quint64 started = Metrics::now();
+        source->sample(m_statsKeys, m_statsCounters);
+        // 各进程的读数分散在整个采样过程中，取中点作为采样时刻
+        m_statsTimestamp = started + (Metrics::now() - started) / 2;
+    });
+    m_statsWorker->setObjectName(QStringLiteral("ProcessStats"));
+    connect(m_statsWorker, &QThread::finished, this, &ProcessListModel::onStatsSampled);
+    m_statsWorker->start(QThread::LowPriority);
 }
 
+void ProcessListModel::onStatsSampled() {
+    HW_TRACE_SCOPE("process", "onStatsSampled");
+    m_statsWorker->deleteLater();
+    m_statsWorker = nullptr;
+    m_statsSampler.update(m_statsKeys, m_statsCounters, m_statsTimestamp, m_statsCpu);
+
+    // 只为数值变化的行发出 dataChanged，且只带统计角色，委托不必重新读取名称与路径；
+    // 相邻的变化行合并为一个区间
+    const QList<int> roles = { CpuRole, WorkingSetRole };
+    int first = -1;
+    auto flush = [&](int last) {
+        if (first >= 0) {
+            emit dataChanged(index(first), index(last), roles);
+            first = -1;
+        }
+    };
+    const std::size_t sampled = m_statsKeys.size();
+    for (int row = 0; row < m_rows.count(); ++row) {
+        const ProcessKey key = m_rows.key(row);
+        // 采样期间行未变化时下标直接对应，否则按 PID 二分查找
+        std::size_t i = static_cast<std::size_t>(row);
+        if (i >= sampled || m_statsKeys[i] != key) {
+            const auto it = std::lower_bound(m_statsKeys.begin(), m_statsKeys.end(), key.pid,
+                [](const ProcessKey& sampledKey, qint64 pid) { return sampledKey.pid < pid; });
+            i = it != m_statsKeys.end() && *it == key ? static_cast<std::size_t>(it - m_statsKeys.begin()) : sampled;
+        }
+        bool changed = false;
+        if (i < sampled) {
+            const ProcessCounters& counters = m_statsCounters[i];
+            const quint64 workingSet = counters.valid ? counters.workingSet / kWorkingSetGranularity * kWorkingSetGranularity : 0;
+            changed = m_rows.setStats(row, m_statsCpu[i], workingSet);
+        }
+        if (changed) {
+            if (first < 0) {
+                first = row;
+            }
+        }
+        else {
+            flush(row - 1);
+        }
+    }
+    flush(m_rows.count() - 1);
+}
 
+void ProcessListModel::cancelStatsWorker() {
+    if (!m_statsWorker) {
+        return;
+    }
+    m_statsWorker->disconnect(this);
+    m_statsWorker->wait();
+    delete m_statsWorker;
+    m_statsWorker = nullptr;
+}
 
-void hideWindow(HWND hwnd, DWORD targetPid) {
-    // 获取窗口所属进程ID
-    DWORD pid = 0;
-    GetWindowThreadProcessId(hwnd, &pid);
+void ProcessListModel::applyEvents(const QList<ProcessEvent>& events) {
+    HW_TRACE_SCOPE("process", "applyEvents");
+    // 同一 PID 只保留最后一个事件
+    QHash<qint64, const ProcessEvent*> latest;
+    latest.reserve(events.count());
+    for (const ProcessEvent& event : events) {
+        latest.insert(event.entry.pid, &event);
+        if (event.kind == ProcessEvent::Exited) {
+            // 立即关闭已退出进程的句柄，不让内核进程对象滞留到空闲超时
+            ProcessHandleCache::instance().remove(event.entry.pid);
+        }
+    }
 
-    // 如果是目标进程的窗口且可见，隐藏它
-    if (pid == targetPid && IsWindowVisible(hwnd)) {
-        ShowWindow(hwnd, SW_HIDE);
-        qDebug() << "Hidden window:" << hwnd << "Title:" << GetWindowTextW(hwnd, new WCHAR[256], 256)
-            << "for PID:" << targetPid;
+    // 现有行本来有序：未受事件影响的行沿用原内容，只需排好新增的进程再归并
+    std::vector<ProcessKey> keys;
+    std::vector<RowSource> rows;
+    keys.reserve(m_rows.count() + latest.count());
+    rows.reserve(m_rows.count() + latest.count());
+    std::vector<RowSource> kept;
+    kept.reserve(m_rows.count());
+    for (int row = 0; row < m_rows.count(); ++row) {
+        const auto it = latest.constFind(m_rows.pid(row));
+        if (it == latest.constEnd()) {
+            kept.push_back({ row, nullptr });
+            continue;
+        }
+        if ((*it)->kind == ProcessEvent::Started) {
+            // exec 之后同一进程的元数据更新；PID 被复用时创建时间不同，按新进程处理
+            kept.push_back({ row, &(*it)->entry });
+        }
+        latest.erase(it);
+    }
+    std::vector<const ProcessEntry*> started;
+    for (const ProcessEvent* event : std::as_const(latest)) {
+        if (event->kind == ProcessEvent::Started) {
+            started.push_back(&event->entry);
+        }
+    }
+    std::sort(started.begin(), started.end(), [](const ProcessEntry* a, const ProcessEntry* b) {
+        return pidLess(*a, *b);
+    });
+
+    auto pidOf = [this](const RowSource& source) {
+        return source.entry ? source.entry->pid : m_rows.pid(source.oldRow);
+    };
+    auto keyOf = [this](const RowSource& source) {
+        return source.entry ? source.entry->key() : m_rows.key(source.oldRow);
+    };
+    std::size_t next = 0;
+    for (const RowSource& source : kept) {
+        for (; next < started.size() && started[next]->pid < pidOf(source); ++next) {
+            keys.push_back(started[next]->key());
+            rows.push_back({ -1, started[next] });
+        }
+        keys.push_back(keyOf(source));
+        rows.push_back(source);
+    }
+    for (; next < started.size(); ++next) {
+        keys.push_back(started[next]->key());
+        rows.push_back({ -1, started[next] });
     }
+    // 连续的新 PID 由差分合并为一次插入
+    applyRows(keys, rows);
 }
 
-void showWindow(HWND hwnd, DWORD targetPid) {
-    // 获取窗口所属进程ID
-    DWORD pid = 0;
-    GetWindowThreadProcessId(hwnd, &pid);
-
-    // 如果是目标进程的窗口且可见，隐藏它
-    if (pid == targetPid && !IsWindowVisible(hwnd) && IsWindow(hwnd)) {
-        ShowWindow(hwnd, SW_RESTORE);
-        qDebug() << "Hidden window:" << hwnd << "Title:" << GetWindowTextW(hwnd, new WCHAR[256], 256)
-            << "for PID:" << targetPid;
+void ProcessListModel::resetProcesses(const QList<ProcessEntry>& entries) {
+    // 整体重置只发出一次 modelReset，而不是逐行插入
+    beginResetModel();
+    m_rows.clear();
+    m_rows.reserve(entries.count());
+    for (const ProcessEntry& entry : entries) {
+        m_rows.append(entry);
     }
-}
\ No newline at end of file
+    endResetModel();
+}
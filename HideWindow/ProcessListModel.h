@@ -15,8 +15,19 @@
 #include <QString>
 #include <QAbstractListModel>
 #include <QList>
+#include <QThread>
+#include <QTimer>
+#ifdef Q_OS_WIN
 #include <windows.h>
+#endif
 #include <filesystem>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "ProcessSource.h"
+#include "ProcessEventSource.h"
+#include "ProcessStats.h"
+#include "ProcessTable.h"
 
 namespace fs = std::filesystem;
 
@@ -24,62 +35,142 @@ class Process : public QObject {
     Q_OBJECT
 public:
     explicit Process(QObject* parent = nullptr);
-    explicit Process(HANDLE handle, QObject* parent = nullptr);
-    ~Process();
+    // 只保存快照条目中的标识与元数据，不打开进程；需要句柄时经 ProcessHandleCache 按需获取
+    explicit Process(const ProcessEntry& entry, QObject* parent = nullptr);
+
+    const ProcessEntry& entry() const { return m_entry; }
+    void setEntry(const ProcessEntry& entry) { m_entry = entry; }
 public slots:
     // 1. 替换 std::size_t 为 qint64（Qt 元对象支持的整数类型）
     qint64 getPID() const;
     // 2. 替换 fs::path 为 QString（对外暴露 Qt 类型，内部仍可用 fs::path）
+    // 直接返回快照中缓存的元数据，不再查询系统
     QString getFile() const;
     QString getName() const;
-    HANDLE getHandle() const;
-    qint64 getHandleAsInt() const;
 
 private:
-    HANDLE m_handle = INVALID_HANDLE_VALUE; // 初始化避免野指针
+    ProcessEntry m_entry;                   // 快照信息（PID、父PID、创建时间）
 };
 
 class ProcessListModel : public QAbstractListModel {
     Q_OBJECT
+    // true：按 (PID, 创建时间) 差分，仅发出最小的区间增删信号；false：整体重置
+    Q_PROPERTY(bool incrementalRefresh READ incrementalRefresh WRITE setIncrementalRefresh NOTIFY incrementalRefreshChanged)
+    // 后台线程正在生成快照
+    Q_PROPERTY(bool refreshing READ isRefreshing NOTIFY refreshingChanged)
+    // true：按进程启动 / 退出事件逐行更新，完整快照只用于定期校准
+    Q_PROPERTY(bool liveUpdates READ liveUpdates WRITE setLiveUpdates NOTIFY liveUpdatesChanged)
+    // 实时更新时完整校准的间隔（毫秒），0 表示只在事件丢失时校准
+    Q_PROPERTY(int reconcileInterval READ reconcileInterval WRITE setReconcileInterval NOTIFY reconcileIntervalChanged)
+    // CPU / 内存采样间隔（毫秒），0 表示停止采样
+    Q_PROPERTY(int statsInterval READ statsInterval WRITE setStatsInterval NOTIFY statsIntervalChanged)
 public:
     enum ProcessRoles {
         NameRole = Qt::DisplayRole,
         PidRole = Qt::UserRole + 1,
         FileRole = Qt::UserRole + 2,
-        HandleRole = Qt::UserRole + 3
+        ParentPidRole = Qt::UserRole + 4,
+        StartTimeRole = Qt::UserRole + 5, // 仅供 C++ 侧区分 PID 复用，不暴露给 QML
+        CpuRole = Qt::UserRole + 6,       // CPU 占用百分比（全部逻辑处理器为 100）
+        WorkingSetRole = Qt::UserRole + 7 // 工作集字节数
     };
     Q_ENUM(ProcessRoles) // 确保枚举被 MOC 处理
 
     explicit ProcessListModel(QObject* parent = nullptr);
     ~ProcessListModel() override;
+
+    bool incrementalRefresh() const;
+    void setIncrementalRefresh(bool enabled);
+    bool isRefreshing() const;
+    // 替换快照提供者（默认为当前平台实现，可替换为合成数据源），会等待进行中的刷新结束
+    void setProcessSource(std::unique_ptr<ProcessSource> source);
+    bool liveUpdates() const;
+    void setLiveUpdates(bool enabled);
+    int reconcileInterval() const;
+    void setReconcileInterval(int ms);
+    // 替换进程事件源（默认为当前平台实现，可替换为 FakeProcessEventSource）
+    void setProcessEventSource(std::unique_ptr<ProcessEventSource> source);
+    ProcessEventSource* processEventSource() const;
+    int statsInterval() const;
+    void setStatsInterval(int ms);
+    // 替换计数采样实现（默认为当前平台实现），会等待进行中的采样结束
+    void setProcessStatsSource(std::unique_ptr<ProcessStatsSource> source);
+    // 将一份快照应用到模型
+    void applySnapshot(const QList<ProcessEntry>& entries);
+    // 将一批进程事件合并到当前行（按 PID 有序）并以区间操作更新模型
+    void applyEvents(const QList<ProcessEvent>& events);
+signals:
+    void incrementalRefreshChanged();
+    void refreshingChanged();
+    void liveUpdatesChanged();
+    void reconcileIntervalChanged();
+    void statsIntervalChanged();
 public slots:
     int rowCount(const QModelIndex& parent = QModelIndex()) const override;
     QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    // 一次调用填充委托所需的全部角色
+    void multiData(const QModelIndex& index, QModelRoleDataSpan roleDataSpan) const override;
     QHash<int, QByteArray> roleNames() const override;
+    // 把 process 的元数据追加为一行，之后释放 process（模型只保存值）
     void addProcess(Process* process);
     void clearProcesses();
     void enumerateWindowsProcesses();
+    // 在后台线程生成快照；已有刷新进行中时取消它并合并为一次后续刷新
+    void refresh();
+private slots:
+    void onRefreshFinished();
+    // 取出事件源中积压的事件；刷新进行中时推迟到快照应用之后
+    void drainProcessEvents();
+    // 采样计时器到期：复制当前各行的键，在后台线程批量读取计数
+    void sampleStats();
+    void onStatsSampled();
 private:
-    QList<Process*> m_processes;
-};
+    void startLiveUpdates();
+    void stopLiveUpdates();
+    void startRefreshWorker();
+    void cancelRefreshWorker();
+    void cancelStatsWorker();
+    void setRefreshing(bool refreshing);
+    void resetProcesses(const QList<ProcessEntry>& entries);
+    // 新行列表中的一行：entry 非空时取其内容，否则沿用旧行 oldRow（内容不变）
+    struct RowSource {
+        int oldRow;
+        const ProcessEntry* entry;
+    };
+    // 按键差分把当前行变为 keys / rows 描述的新列表，发出最小的区间信号
+    void applyRows(const std::vector<ProcessKey>& keys, const std::vector<RowSource>& rows);
+    QVariant roleData(int row, int role) const;
 
+    ProcessTable m_rows;
+    std::unique_ptr<ProcessSource> m_source;
+    bool m_incrementalRefresh = true;
 
-// 先修正HideProcess类的定义（原定义有QObject拷贝问题）
-class HideProcess : public QObject {
-    Q_OBJECT
-public:
-    // 2. 改为接收Process指针（避免QObject拷贝）
-    explicit HideProcess(QObject* parent = nullptr);
-    void hideProcess(Process* process);
-public slots:
-    void hideProcess(qint64 pid = 0);
-    void showProcess(qint64 pid = 0);
-private:
+    // 双缓冲：后台线程只写 m_backBuffer，完成后在 GUI 线程与 m_snapshot 交换
+    QList<ProcessEntry> m_snapshot;
+    QList<ProcessEntry> m_backBuffer;
+    QThread* m_worker = nullptr;
+    std::atomic<bool> m_cancelRefresh{ false };
+    bool m_snapshotSucceeded = false; // 由后台线程写入，finished 之后才在 GUI 线程读取
+    bool m_refreshPending = false;
+    bool m_refreshing = false;
+
+    std::unique_ptr<ProcessEventSource> m_eventSource;
+    bool m_liveUpdates = true;
+    int m_reconcileInterval = 60000;
+    QTimer m_eventTimer;     // 合并短时间内的多次事件通知
+    QTimer m_reconcileTimer; // 定期完整刷新，校正丢失或重复的事件
+    QList<ProcessEvent> m_events; // 复用容量
 
-    // 辅助函数：递归查找所有窗口（包括子窗口）
-    void findWindows(HWND parentHwnd, HWND startHwnd, DWORD targetPid, std::function<void(HWND, DWORD)> run);
+    std::unique_ptr<ProcessStatsSource> m_statsSource;
+    ProcessStatsSampler m_statsSampler;
+    int m_statsInterval = 2000;
+    QTimer m_statsTimer;
+    QThread* m_statsWorker = nullptr;
+    // 以下缓冲区在采样线程运行期间只由该线程访问，复用容量
+    std::vector<ProcessKey> m_statsKeys; // 按 PID 升序
+    std::vector<ProcessCounters> m_statsCounters;
+    std::vector<quint16> m_statsCpu;
+    quint64 m_statsTimestamp = 0;
 };
 
-void hideWindow(HWND hwnd, DWORD targetPid);
-void showWindow(HWND hwnd, DWORD targetPid);
 #endif
\ No newline at end of file
@@ -0,0 +1,138 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "ProcessSource.h"
+#include "AsyncLog.h"
+#include "ProcessHandleCache.h"
+#include "Trace.h"
+#include <QDebug>
+#include <QFileInfo>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <tlhelp32.h>
+
+namespace {
+// 每次刷新都有上百个系统进程无法打开，限流后只保留少量样例
+AsyncLog::Category s_enumerationLog("process.enumeration", 20);
+
+// 以受限权限打开进程，读取创建时间与可执行文件路径；无法打开时返回 false。
+// 采样已缓存的句柄直接复用；其余进程的句柄查询完即关闭，完整快照不会把全部进程的句柄
+// 留在缓存中直到空闲超时
+bool queryProcess(DWORD pid, DWORD parentPid, const WCHAR* exeFile, ProcessEntry& entry) {
+    // 错误码在 OpenProcess 失败后立即取得，之后的调用（关闭句柄、加锁）可能覆盖 GetLastError()
+    int error = 0;
+    const std::shared_ptr<ProcessHandle> handle = ProcessHandleCache::instance().acquireTransient(pid, 0, &error);
+    if (!handle) {
+        // 有些系统进程无法打开，属于正常情况，仅打印警告
+        HW_LOG_WARNING(s_enumerationLog, "OpenProcess failed for PID: %1. Error: %2", pid, error);
+        return false;
+    }
+
+    entry = ProcessEntry();
+    entry.pid = pid;
+    entry.parentPid = parentPid;
+    entry.startTime = handle->startTime();
+
+    // 可执行文件路径只在快照时查询一次（受限权限即可）
+    WCHAR szPath[MAX_PATH] = { 0 };
+    DWORD pathLength = MAX_PATH;
+    BOOL pathOk = FALSE;
+    {
+        HW_TRACE_SCOPE("process", "QueryFullProcessImageNameW");
+        pathOk = QueryFullProcessImageNameW(handle->native(), 0, szPath, &pathLength);
+    }
+    if (pathOk) {
+        entry.exePath = QString::fromWCharArray(szPath, static_cast<int>(pathLength));
+        entry.name = QFileInfo(entry.exePath).fileName();
+    }
+    else if (exeFile) {
+        entry.name = QString::fromWCharArray(exeFile);
+    }
+    return true;
+}
+} // namespace
+
+// ===================== ToolhelpProcessSource 类实现 =====================
+bool ToolhelpProcessSource::snapshot(QList<ProcessEntry>& out, const std::atomic<bool>& cancelled) {
+    HW_TRACE_SCOPE("process", "ToolhelpProcessSource::snapshot");
+    // 创建进程快照
+    HANDLE hSnapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+    if (hSnapshot == INVALID_HANDLE_VALUE) {
+        qWarning() << "Failed to create process snapshot. Error:" << GetLastError();
+        return false;
+    }
+
+    PROCESSENTRY32W pe32 = { 0 };
+    pe32.dwSize = sizeof(PROCESSENTRY32W);
+
+    // 遍历第一个进程
+    if (!Process32FirstW(hSnapshot, &pe32)) {
+        qWarning() << "Failed to get first process. Error:" << GetLastError();
+        CloseHandle(hSnapshot);
+        return false;
+    }
+
+    out.clear();
+    do {
+        if (cancelled.load(std::memory_order_relaxed)) {
+            CloseHandle(hSnapshot);
+            return false;
+        }
+
+        ProcessEntry entry;
+        if (!queryProcess(pe32.th32ProcessID, pe32.th32ParentProcessID, pe32.szExeFile, entry)) {
+            continue; // 跳过无法打开的进程
+        }
+        out.append(entry);
+    } while (Process32NextW(hSnapshot, &pe32));
+
+    // 关闭快照句柄
+    CloseHandle(hSnapshot);
+    return true;
+}
+
+bool ToolhelpProcessSource::listPids(std::vector<qint64>& out) {
+    HW_TRACE_SCOPE("process", "ToolhelpProcessSource::listPids");
+    HANDLE hSnapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+    if (hSnapshot == INVALID_HANDLE_VALUE) {
+        qWarning() << "Failed to create process snapshot. Error:" << GetLastError();
+        return false;
+    }
+
+    PROCESSENTRY32W pe32 = { 0 };
+    pe32.dwSize = sizeof(PROCESSENTRY32W);
+    out.clear();
+    m_listed.clear();
+    if (Process32FirstW(hSnapshot, &pe32)) {
+        do {
+            // Toolhelp 快照本身已带父 PID 与名称，不必打开进程
+            out.push_back(pe32.th32ProcessID);
+            m_listed.insert(pe32.th32ProcessID,
+                ListedProcess{ pe32.th32ParentProcessID, QString::fromWCharArray(pe32.szExeFile) });
+        } while (Process32NextW(hSnapshot, &pe32));
+    }
+    CloseHandle(hSnapshot);
+    return true;
+}
+
+bool ToolhelpProcessSource::query(qint64 pid, ProcessEntry& entry) {
+    const auto listed = m_listed.constFind(pid);
+    if (listed == m_listed.constEnd()) {
+        return queryProcess(static_cast<DWORD>(pid), 0, nullptr, entry);
+    }
+    const std::wstring exeFile = listed->exeFile.toStdWString();
+    return queryProcess(static_cast<DWORD>(pid), static_cast<DWORD>(listed->parentPid), exeFile.c_str(), entry);
+}
+
+std::unique_ptr<ProcessSource> createDefaultProcessSource() {
+    return std::make_unique<ToolhelpProcessSource>();
+}
+#endif
@@ -0,0 +1,116 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+#ifndef PROCESSSOURCE_H
+#define PROCESSSOURCE_H
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QtGlobal>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "ProcessDiff.h"
+
+// 快照中的一条进程元数据记录（值类型，不持有任何系统句柄）
+// 所有字段在生成快照时一次性填好，模型读取时不再触发系统调用
+struct ProcessEntry {
+    qint64 pid = 0;
+    qint64 parentPid = 0;
+    quint64 startTime = 0; // 进程创建时间（平台相关的单调值，仅用于区分 PID 复用）
+    QString exePath;       // 可执行文件完整路径，无权限时为空
+    QString name;          // 显示名称（可执行文件名）
+
+    ProcessKey key() const { return { pid, startTime }; }
+    bool sameContent(const ProcessEntry& other) const {
+        return parentPid == other.parentPid && exePath == other.exePath && name == other.name;
+    }
+};
+
+// 进程快照提供者接口：模型只依赖此接口，便于替换为合成数据或 /proc 实现
+// snapshot() 在后台线程调用，实现不得访问 GUI 对象
+class ProcessSource {
+public:
+    virtual ~ProcessSource() = default;
+    // 将一份完整快照写入 out（复用其容量）；失败或 cancelled 被置位时返回 false
+    virtual bool snapshot(QList<ProcessEntry>& out, const std::atomic<bool>& cancelled) = 0;
+    // 只列出当前所有 PID（不打开进程、不读取元数据），供轮询时廉价比较；不支持时返回 false
+    virtual bool listPids(std::vector<qint64>& out) {
+        Q_UNUSED(out);
+        return false;
+    }
+    // 读取单个进程的元数据；进程已退出或不支持时返回 false
+    virtual bool query(qint64 pid, ProcessEntry& entry) {
+        Q_UNUSED(pid);
+        Q_UNUSED(entry);
+        return false;
+    }
+};
+
+#ifdef Q_OS_WIN
+// 基于 CreateToolhelp32Snapshot 的 Windows 实现
+class ToolhelpProcessSource : public ProcessSource {
+public:
+    bool snapshot(QList<ProcessEntry>& out, const std::atomic<bool>& cancelled) override;
+    bool listPids(std::vector<qint64>& out) override;
+    // 父 PID 与回退名称取自最近一次 listPids 的结果
+    bool query(qint64 pid, ProcessEntry& entry) override;
+
+private:
+    struct ListedProcess {
+        qint64 parentPid = 0;
+        QString exeFile;
+    };
+    QHash<qint64, ListedProcess> m_listed;
+};
+#endif
+
+#ifdef Q_OS_LINUX
+// 基于 /proc 的 Linux 实现：getdents64 批量读取目录，stat/exe 通过 openat/readlinkat
+// 相对常驻的 /proc 描述符访问，所有进程共用同一块读取缓冲区
+class LinuxProcessSource : public ProcessSource {
+public:
+    LinuxProcessSource();
+    ~LinuxProcessSource() override;
+    LinuxProcessSource(const LinuxProcessSource&) = delete;
+    LinuxProcessSource& operator=(const LinuxProcessSource&) = delete;
+
+    bool snapshot(QList<ProcessEntry>& out, const std::atomic<bool>& cancelled) override;
+    bool listPids(std::vector<qint64>& out) override;
+    bool query(qint64 pid, ProcessEntry& entry) override;
+
+private:
+    // 回到 /proc 开头，对每个 PID 目录调用 fn(name, pid)；fn 返回 false 时停止并返回 false
+    template <typename Fn>
+    bool forEachPidDirectory(Fn fn);
+    // 读取 /proc/[pid]/stat 与 exe；pidName 为目录名
+    bool readEntry(const char* pidName, ProcessEntry& entry);
+
+    int m_procFd = -1;
+    std::vector<char> m_dirBuffer;
+    std::vector<char> m_fileBuffer;
+};
+
+// /proc 文本的解析函数，供 LinuxProcessSource 与测试使用
+namespace LinuxProcfs {
+// 目录名是否为纯数字 PID，是则写入 pid
+bool parsePid(const char* name, qint64& pid);
+// 解析 /proc/[pid]/stat 的 comm、父 PID 与 starttime；comm 可能包含空格和括号。行不完整时返回 false
+bool parseStat(const char* stat, ProcessEntry& entry);
+// readlinkat 读取 exe 链接的结果（缓冲区容量 capacity）中可用的路径长度：
+// 去掉文件被替换或删除后内核追加的 " (deleted)"；读取失败或被截断时返回 -1
+qint64 exeLinkLength(const char* target, qint64 length, qint64 capacity);
+} // namespace LinuxProcfs
+#endif
+
+// 返回当前平台的默认快照提供者
+std::unique_ptr<ProcessSource> createDefaultProcessSource();
+#endif
@@ -0,0 +1,97 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "ProcessStats.h"
+#include "ProcessHandleCache.h"
+#include "Trace.h"
+#include <QThread>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <Psapi.h>
+#pragma comment(lib, "Psapi.lib")
+
+namespace {
+quint64 fileTimeValue(const FILETIME& time) {
+    return (static_cast<quint64>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+}
+} // namespace
+
+// ===================== WindowsProcessStatsSource 类实现 =====================
+void WindowsProcessStatsSource::sample(const std::vector<ProcessKey>& keys, std::vector<ProcessCounters>& out) {
+    HW_TRACE_SCOPE("process", "WindowsProcessStatsSource::sample");
+    out.assign(keys.size(), ProcessCounters());
+    ProcessHandleCache& handles = ProcessHandleCache::instance();
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        // 缓存按创建时间校验身份，PID 已被复用时取不到句柄，不会把新进程的计数算到旧行上
+        const std::shared_ptr<ProcessHandle> handle = handles.acquire(keys[i]);
+        if (!handle) {
+            continue;
+        }
+        FILETIME creation, exit, kernel, user;
+        PROCESS_MEMORY_COUNTERS memory = {};
+        if (GetProcessTimes(handle->native(), &creation, &exit, &kernel, &user)
+            && GetProcessMemoryInfo(handle->native(), &memory, sizeof(memory))) {
+            // FILETIME 以 100 纳秒为单位
+            out[i].cpuTime = (fileTimeValue(kernel) + fileTimeValue(user)) * 100;
+            out[i].workingSet = memory.WorkingSetSize;
+            out[i].valid = true;
+        }
+    }
+}
+
+std::unique_ptr<ProcessStatsSource> createDefaultProcessStatsSource() {
+    return std::make_unique<WindowsProcessStatsSource>();
+}
+#endif
+
+// ===================== ProcessStatsSampler 类实现 =====================
+ProcessStatsSampler::ProcessStatsSampler(int cpuCount)
+    : m_cpuCount(cpuCount > 0 ? cpuCount : qMax(1, QThread::idealThreadCount()))
+{
+}
+
+void ProcessStatsSampler::update(const std::vector<ProcessKey>& keys, const std::vector<ProcessCounters>& counters,
+    quint64 timestampNs, std::vector<quint16>& cpuPermille) {
+    HW_TRACE_SCOPE("process", "ProcessStatsSampler::update");
+    const quint64 elapsed = m_timestamp != 0 && timestampNs > m_timestamp ? timestampNs - m_timestamp : 0;
+    const quint64 capacity = elapsed * static_cast<quint64>(m_cpuCount);
+    cpuPermille.assign(keys.size(), 0);
+
+    // 两次采样都按 PID 升序，一次归并即可配对
+    std::size_t previous = 0;
+    for (std::size_t i = 0; i < keys.size() && capacity != 0; ++i) {
+        while (previous < m_keys.size() && m_keys[previous].pid < keys[i].pid) {
+            ++previous;
+        }
+        if (!counters[i].valid || previous == m_keys.size() || m_keys[previous] != keys[i]
+            || counters[i].cpuTime < m_cpuTime[previous]) {
+            continue;
+        }
+        const quint64 used = counters[i].cpuTime - m_cpuTime[previous];
+        cpuPermille[i] = static_cast<quint16>(qMin<quint64>(1000, (used * 1000 + capacity / 2) / capacity));
+    }
+
+    m_keys.clear();
+    m_cpuTime.clear();
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        if (counters[i].valid) {
+            m_keys.push_back(keys[i]);
+            m_cpuTime.push_back(counters[i].cpuTime);
+        }
+    }
+    m_timestamp = timestampNs;
+}
+
+void ProcessStatsSampler::clear() {
+    m_timestamp = 0;
+    m_keys.clear();
+    m_cpuTime.clear();
+}
@@ -0,0 +1,87 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+#ifndef PROCESSSTATS_H
+#define PROCESSSTATS_H
+// 进程 CPU / 内存计数的批量采样：一次采样遍历全部被跟踪的进程，
+// 增量计算放在按 PID 排序的平坦数组上，模型读取时不再触发系统调用
+#include <QtGlobal>
+#include <memory>
+#include <vector>
+#include "ProcessDiff.h"
+
+// 一个进程在某一时刻的累计计数
+struct ProcessCounters {
+    quint64 cpuTime = 0;    // 用户态 + 内核态累计 CPU 时间（纳秒）
+    quint64 workingSet = 0; // 工作集 / 常驻内存（字节）
+    bool valid = false;     // 进程已退出、无权限或 PID 已被复用时为 false
+};
+
+// 计数采样接口：sample() 在后台线程调用，实现不得访问 GUI 对象
+class ProcessStatsSource {
+public:
+    virtual ~ProcessStatsSource() = default;
+    // out 调整为 keys 的大小，out[i] 对应 keys[i]；创建时间与 keys[i] 不符的进程视为已退出
+    virtual void sample(const std::vector<ProcessKey>& keys, std::vector<ProcessCounters>& out) = 0;
+};
+
+#ifdef Q_OS_WIN
+// 经 ProcessHandleCache 取得进程句柄，读取 GetProcessTimes 与 GetProcessMemoryInfo；
+// 句柄在两次采样之间保留在缓存中，稳定运行时每次采样不再调用 OpenProcess
+class WindowsProcessStatsSource : public ProcessStatsSource {
+public:
+    void sample(const std::vector<ProcessKey>& keys, std::vector<ProcessCounters>& out) override;
+};
+#endif
+
+#ifdef Q_OS_LINUX
+// 读取 /proc/[pid]/stat 的 utime、stime、starttime 与 rss，路径相对常驻的 /proc 描述符解析
+class LinuxProcessStatsSource : public ProcessStatsSource {
+public:
+    LinuxProcessStatsSource();
+    ~LinuxProcessStatsSource() override;
+    LinuxProcessStatsSource(const LinuxProcessStatsSource&) = delete;
+    LinuxProcessStatsSource& operator=(const LinuxProcessStatsSource&) = delete;
+
+    void sample(const std::vector<ProcessKey>& keys, std::vector<ProcessCounters>& out) override;
+
+private:
+    int m_procFd = -1;
+    quint64 m_nsPerTick = 0;
+    quint64 m_pageSize = 0;
+    std::vector<char> m_buffer;
+};
+#endif
+
+// 返回当前平台的默认计数采样实现
+std::unique_ptr<ProcessStatsSource> createDefaultProcessStatsSource();
+
+// 由相邻两次采样计算 CPU 占用。占用以全部逻辑处理器为 100%（与任务管理器一致），
+// 单位为 0.1%，低于该精度的波动不视为变化
+class ProcessStatsSampler {
+public:
+    explicit ProcessStatsSampler(int cpuCount = 0);
+
+    // keys 须按 PID 升序；counters[i] 对应 keys[i]，timestampNs 为单调时钟的采样时刻。
+    // cpuPermille 调整为 keys 的大小，首次出现或无效的进程记为 0
+    void update(const std::vector<ProcessKey>& keys, const std::vector<ProcessCounters>& counters,
+        quint64 timestampNs, std::vector<quint16>& cpuPermille);
+    void clear();
+    int cpuCount() const { return m_cpuCount; }
+
+private:
+    int m_cpuCount;
+    quint64 m_timestamp = 0;
+    // 上一次采样，按 PID 升序
+    std::vector<ProcessKey> m_keys;
+    std::vector<quint64> m_cpuTime;
+};
+#endif
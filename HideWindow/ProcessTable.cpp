@@ -0,0 +1,214 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "ProcessTable.h"
+#include <algorithm>
+
+namespace {
+// 字符池中的字符串数超过 行数 * 2 + 该值 时才重建，避免少量进程反复启停时频繁重建
+constexpr int kMinStaleStrings = 1024;
+} // namespace
+
+// ===================== StringPool 类实现 =====================
+quint32 StringPool::intern(QStringView text) {
+    return intern(text, nullptr);
+}
+
+quint32 StringPool::internShared(const QString& text) {
+    return intern(QStringView(text), &text);
+}
+
+quint32 StringPool::intern(QStringView text, const QString* shared) {
+    // 负载因子保持在 1/2 以下
+    if (static_cast<std::size_t>(count() + 1) * 2 > m_slots.size()) {
+        rehash(qMax<std::size_t>(64, m_slots.size() * 2));
+    }
+    const quint32 h = hash(text);
+    const std::size_t mask = m_slots.size() - 1;
+    std::size_t slot = h & mask;
+    for (; m_slots[slot] != 0; slot = (slot + 1) & mask) {
+        const quint32 id = m_slots[slot] - 1;
+        if (m_hashes[id] == h && view(id) == text) {
+            return id;
+        }
+    }
+    const quint32 id = static_cast<quint32>(count());
+    m_strings.push_back(shared ? *shared : text.toString());
+    m_hashes.push_back(h);
+    m_slots[slot] = id + 1;
+    return id;
+}
+
+void StringPool::clear() {
+    m_strings.clear();
+    m_hashes.clear();
+    std::fill(m_slots.begin(), m_slots.end(), 0);
+}
+
+void StringPool::swap(StringPool& other) noexcept {
+    m_strings.swap(other.m_strings);
+    m_hashes.swap(other.m_hashes);
+    m_slots.swap(other.m_slots);
+}
+
+std::size_t StringPool::memoryUsage() const {
+    std::size_t chars = 0;
+    for (const QString& text : m_strings) {
+        chars += static_cast<std::size_t>(text.capacity()) * sizeof(QChar);
+    }
+    return chars + m_strings.capacity() * sizeof(QString) + m_hashes.capacity() * sizeof(quint32)
+        + m_slots.capacity() * sizeof(quint32);
+}
+
+quint32 StringPool::hash(QStringView text) {
+    // FNV-1a：路径很短，简单的逐字符哈希已经足够
+    quint32 h = 2166136261u;
+    for (qsizetype i = 0; i < text.size(); ++i) {
+        h = (h ^ text.utf16()[i]) * 16777619u;
+    }
+    return h;
+}
+
+void StringPool::rehash(std::size_t slotCount) {
+    m_slots.assign(slotCount, 0);
+    const std::size_t mask = slotCount - 1;
+    for (quint32 id = 0; id < static_cast<quint32>(count()); ++id) {
+        std::size_t slot = m_hashes[id] & mask;
+        while (m_slots[slot] != 0) {
+            slot = (slot + 1) & mask;
+        }
+        m_slots[slot] = id + 1;
+    }
+}
+
+// ===================== ProcessTable 类实现 =====================
+ProcessEntry ProcessTable::entry(int row) const {
+    ProcessEntry entry;
+    entry.pid = m_pid[row];
+    entry.parentPid = m_parentPid[row];
+    entry.startTime = m_startTime[row];
+    entry.exePath = exePath(row);
+    entry.name = name(row);
+    return entry;
+}
+
+bool ProcessTable::sameContent(int row, const ProcessEntry& entry) const {
+    return m_parentPid[row] == entry.parentPid
+        && m_strings.view(m_path[row]) == entry.exePath
+        && m_strings.view(m_name[row]) == entry.name;
+}
+
+void ProcessTable::clear() {
+    m_pid.clear();
+    m_parentPid.clear();
+    m_startTime.clear();
+    m_name.clear();
+    m_path.clear();
+    m_cpu.clear();
+    m_workingSet.clear();
+    m_strings.clear();
+}
+
+void ProcessTable::reserve(int rows) {
+    m_pid.reserve(rows);
+    m_parentPid.reserve(rows);
+    m_startTime.reserve(rows);
+    m_name.reserve(rows);
+    m_path.reserve(rows);
+    m_cpu.reserve(rows);
+    m_workingSet.reserve(rows);
+}
+
+void ProcessTable::append(const ProcessEntry& entry) {
+    m_pid.push_back(entry.pid);
+    m_parentPid.push_back(entry.parentPid);
+    m_startTime.push_back(entry.startTime);
+    m_name.push_back(m_strings.internShared(entry.name));
+    m_path.push_back(m_strings.internShared(entry.exePath));
+    m_cpu.push_back(0);
+    m_workingSet.push_back(0);
+}
+
+void ProcessTable::append(const ProcessTable& other, int row) {
+    m_pid.push_back(other.m_pid[row]);
+    m_parentPid.push_back(other.m_parentPid[row]);
+    m_startTime.push_back(other.m_startTime[row]);
+    m_name.push_back(m_strings.internShared(other.m_strings.string(other.m_name[row])));
+    m_path.push_back(m_strings.internShared(other.m_strings.string(other.m_path[row])));
+    m_cpu.push_back(other.m_cpu[row]);
+    m_workingSet.push_back(other.m_workingSet[row]);
+}
+
+void ProcessTable::insertGap(int row, int count) {
+    m_pid.insert(m_pid.begin() + row, count, 0);
+    m_parentPid.insert(m_parentPid.begin() + row, count, 0);
+    m_startTime.insert(m_startTime.begin() + row, count, 0);
+    m_name.insert(m_name.begin() + row, count, 0);
+    m_path.insert(m_path.begin() + row, count, 0);
+    m_cpu.insert(m_cpu.begin() + row, count, 0);
+    m_workingSet.insert(m_workingSet.begin() + row, count, 0);
+}
+
+void ProcessTable::set(int row, const ProcessEntry& entry) {
+    m_pid[row] = entry.pid;
+    m_parentPid[row] = entry.parentPid;
+    m_startTime[row] = entry.startTime;
+    m_name[row] = m_strings.internShared(entry.name);
+    m_path[row] = m_strings.internShared(entry.exePath);
+}
+
+bool ProcessTable::setStats(int row, quint16 cpuPermille, quint64 workingSet) {
+    if (m_cpu[row] == cpuPermille && m_workingSet[row] == workingSet) {
+        return false;
+    }
+    m_cpu[row] = cpuPermille;
+    m_workingSet[row] = workingSet;
+    return true;
+}
+
+void ProcessTable::remove(int first, int count) {
+    m_pid.erase(m_pid.begin() + first, m_pid.begin() + first + count);
+    m_parentPid.erase(m_parentPid.begin() + first, m_parentPid.begin() + first + count);
+    m_startTime.erase(m_startTime.begin() + first, m_startTime.begin() + first + count);
+    m_name.erase(m_name.begin() + first, m_name.begin() + first + count);
+    m_path.erase(m_path.begin() + first, m_path.begin() + first + count);
+    m_cpu.erase(m_cpu.begin() + first, m_cpu.begin() + first + count);
+    m_workingSet.erase(m_workingSet.begin() + first, m_workingSet.begin() + first + count);
+}
+
+void ProcessTable::swap(ProcessTable& other) noexcept {
+    m_pid.swap(other.m_pid);
+    m_parentPid.swap(other.m_parentPid);
+    m_startTime.swap(other.m_startTime);
+    m_name.swap(other.m_name);
+    m_path.swap(other.m_path);
+    m_cpu.swap(other.m_cpu);
+    m_workingSet.swap(other.m_workingSet);
+    m_strings.swap(other.m_strings);
+}
+
+void ProcessTable::compactStrings() {
+    if (m_strings.count() <= count() * 2 + kMinStaleStrings) {
+        return;
+    }
+    StringPool strings;
+    for (int row = 0; row < count(); ++row) {
+        m_name[row] = strings.internShared(m_strings.string(m_name[row]));
+        m_path[row] = strings.internShared(m_strings.string(m_path[row]));
+    }
+    m_strings.swap(strings);
+}
+
+std::size_t ProcessTable::memoryUsage() const {
+    return m_pid.capacity() * sizeof(qint64) + m_parentPid.capacity() * sizeof(qint64)
+        + m_startTime.capacity() * sizeof(quint64) + m_name.capacity() * sizeof(quint32)
+        + m_path.capacity() * sizeof(quint32) + m_cpu.capacity() * sizeof(quint16)
+        + m_workingSet.capacity() * sizeof(quint64) + m_strings.memoryUsage();
+}
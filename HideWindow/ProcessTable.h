@@ -0,0 +1,96 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+#ifndef PROCESSTABLE_H
+#define PROCESSTABLE_H
+#include <QString>
+#include <QStringView>
+#include <QtGlobal>
+#include <cstddef>
+#include <vector>
+#include "ProcessSource.h"
+
+// 字符串驻留池：相同内容只存一份，每个不同的字符串是一个 QString，
+// 读取时交出隐式共享的副本，只增加引用计数而不分配内存。
+// 查找表为开放寻址，槽位里只存编号
+class StringPool {
+public:
+    // 返回 text 的编号；已存在时直接返回原编号。新字符串复制 text
+    quint32 intern(QStringView text);
+    // 同上，新字符串与 text 共享数据而不复制
+    quint32 internShared(const QString& text);
+    QStringView view(quint32 id) const { return m_strings[id]; }
+    QString string(quint32 id) const { return m_strings[id]; }
+    int count() const { return static_cast<int>(m_strings.size()); }
+    void clear();
+    void swap(StringPool& other) noexcept;
+    std::size_t memoryUsage() const;
+
+private:
+    static quint32 hash(QStringView text);
+    void rehash(std::size_t slotCount);
+    // shared 非空时新字符串与其共享数据，否则复制 text
+    quint32 intern(QStringView text, const QString* shared);
+
+    std::vector<QString> m_strings;
+    std::vector<quint32> m_hashes; // 编号 -> 哈希值，扩容时无需重新计算
+    std::vector<quint32> m_slots;  // 0 为空槽，否则为编号 + 1
+};
+
+// 进程列表的行存储：结构数组（SoA），每行只是几个整数与两个字符串编号。
+// 路径与名称驻留在 StringPool 中，同一程序的多个实例共用一份，读取时不分配内存；
+// 整体重建与区间增删都只在各列数组上批量移动，不为单行分配内存
+class ProcessTable {
+public:
+    int count() const { return static_cast<int>(m_pid.size()); }
+    qint64 pid(int row) const { return m_pid[row]; }
+    qint64 parentPid(int row) const { return m_parentPid[row]; }
+    quint64 startTime(int row) const { return m_startTime[row]; }
+    ProcessKey key(int row) const { return { m_pid[row], m_startTime[row] }; }
+    QString name(int row) const { return m_strings.string(m_name[row]); }
+    QString exePath(int row) const { return m_strings.string(m_path[row]); }
+    // 最近一次采样的 CPU 占用（0.1% 为单位）与工作集字节数；新行为 0
+    quint16 cpuPermille(int row) const { return m_cpu[row]; }
+    quint64 workingSet(int row) const { return m_workingSet[row]; }
+    ProcessEntry entry(int row) const;
+    // 与 ProcessEntry::sameContent 的含义相同，不构造临时字符串
+    bool sameContent(int row, const ProcessEntry& entry) const;
+
+    void clear();
+    void reserve(int rows);
+    void append(const ProcessEntry& entry);
+    // 复制另一张表的一行（字符串重新驻留到本表的池中）
+    void append(const ProcessTable& other, int row);
+    // 在 row 处空出 count 行，随后用 set() 逐行填写
+    void insertGap(int row, int count);
+    // 只替换元数据，保留该行的采样值
+    void set(int row, const ProcessEntry& entry);
+    // 写入采样值，返回值是否发生变化
+    bool setStats(int row, quint16 cpuPermille, quint64 workingSet);
+    void remove(int first, int count);
+    void swap(ProcessTable& other) noexcept;
+    // 删除与替换只会让池中残留不再引用的字符串，残留过多时重建字符池
+    void compactStrings();
+
+    // 各列与字符池实际占用的字节数（按容量计）
+    std::size_t memoryUsage() const;
+
+private:
+    std::vector<qint64> m_pid;
+    std::vector<qint64> m_parentPid;
+    std::vector<quint64> m_startTime;
+    std::vector<quint32> m_name;
+    std::vector<quint32> m_path;
+    std::vector<quint16> m_cpu;
+    std::vector<quint64> m_workingSet;
+    StringPool m_strings;
+};
+#endif
@@ -0,0 +1,98 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "ProcessTree.h"
+
+// ===================== ProcessTree 类实现 =====================
+void ProcessTree::build(const QList<ProcessEntry>& entries) {
+    const int n = static_cast<int>(entries.size());
+    m_pids.resize(n);
+    m_parent.assign(n, -1);
+    m_row.resize(n);
+    m_nodes.clear();
+    m_nodes.reserve(n);
+    for (int node = 0; node < n; ++node) {
+        m_pids[node] = entries.at(node).pid;
+        m_nodes.insert(m_pids[node], node);
+    }
+
+    // 1. 解析父节点。Windows 不会在父进程退出后改写子进程的父 PID，
+    //    该 PID 可能已分配给更晚创建的进程，此时不能认作父进程
+    for (int node = 0; node < n; ++node) {
+        const ProcessEntry& entry = entries.at(node);
+        if (entry.parentPid == entry.pid) {
+            continue;
+        }
+        const auto it = m_nodes.constFind(entry.parentPid);
+        if (it == m_nodes.constEnd()) {
+            continue;
+        }
+        const ProcessEntry& parent = entries.at(it.value());
+        if (parent.startTime != 0 && entry.startTime != 0 && parent.startTime > entry.startTime) {
+            continue;
+        }
+        m_parent[node] = it.value();
+    }
+
+    // 2. 创建时间相同的异常数据可能互为父子，沿父链检查并在回到本轮路径处断开，保证结果是森林
+    std::vector<quint8> state(n, 0); // 0 未访问，1 在本轮路径上，2 已确认无环
+    std::vector<int> path;
+    for (int start = 0; start < n; ++start) {
+        int node = start;
+        path.clear();
+        while (node >= 0 && state[node] == 0) {
+            state[node] = 1;
+            path.push_back(node);
+            node = m_parent[node];
+        }
+        if (node >= 0 && state[node] == 1) {
+            m_parent[node] = -1;
+        }
+        for (int visited : path) {
+            state[visited] = 2;
+        }
+    }
+
+    // 3. 计数排序：统计每个槽位的子节点数，前缀和得到起点，再按快照顺序回填
+    m_offsets.assign(n + 2, 0);
+    for (int node = 0; node < n; ++node) {
+        ++m_offsets[m_parent[node] + 2];
+    }
+    for (int slot = 1; slot < n + 2; ++slot) {
+        m_offsets[slot] += m_offsets[slot - 1];
+    }
+    std::vector<int> cursor(m_offsets.begin(), m_offsets.end() - 1);
+    m_children.resize(n);
+    for (int node = 0; node < n; ++node) {
+        const int slot = m_parent[node] + 1;
+        const int position = cursor[slot]++;
+        m_children[position] = node;
+        m_row[node] = position - m_offsets[slot];
+    }
+}
+
+void ProcessTree::clear() {
+    m_pids.clear();
+    m_parent.clear();
+    m_row.clear();
+    m_offsets.assign(2, 0);
+    m_children.clear();
+    m_nodes.clear();
+}
+
+void ProcessTree::collectSubtree(int node, std::vector<int>& out) const {
+    // out 本身充当队列，无需额外的栈或访问标记（结构保证无环）
+    std::size_t next = out.size();
+    out.push_back(node);
+    for (; next < out.size(); ++next) {
+        const int current = out[next];
+        out.insert(out.end(), m_children.begin() + m_offsets[current + 1], m_children.begin() + m_offsets[current + 2]);
+    }
+}
@@ -0,0 +1,54 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+#ifndef PROCESSTREE_H
+#define PROCESSTREE_H
+// 进程树：父进程 -> 子进程的压缩邻接表（CSR）。
+// build() 对快照只做几次线性遍历（建 PID 下标、计数、前缀和、回填），
+// 所有子列表共用一块连续数组，不为单个节点分配内存。
+// 节点号即快照中的下标；子进程按快照中的顺序排列（快照按 PID 排序时子进程也按 PID 升序）。
+#include <QHash>
+#include <QList>
+#include <QtGlobal>
+#include <vector>
+#include "ProcessSource.h"
+
+class ProcessTree {
+public:
+    // 父进程不在快照中、创建时间晚于子进程（PID 已被复用）或父子关系成环时，按根节点处理
+    void build(const QList<ProcessEntry>& entries);
+    void clear();
+
+    int count() const { return static_cast<int>(m_pids.size()); }
+    // PID 对应的节点号，不存在返回 -1
+    int find(qint64 pid) const { return m_nodes.value(pid, -1); }
+    qint64 pid(int node) const { return m_pids[node]; }
+    // 父节点号，根节点为 -1
+    int parent(int node) const { return m_parent[node]; }
+    // 在父节点子列表（根节点为根列表）中的位置
+    int row(int node) const { return m_row[node]; }
+    // node 为 -1 时表示根列表
+    int childCount(int node) const { return m_offsets[node + 2] - m_offsets[node + 1]; }
+    int child(int node, int row) const { return m_children[m_offsets[node + 1] + row]; }
+
+    // 把 node 及其所有后代按层序追加到 out
+    void collectSubtree(int node, std::vector<int>& out) const;
+
+private:
+    std::vector<qint64> m_pids;
+    std::vector<int> m_parent;
+    std::vector<int> m_row;
+    // 槽位 0 为根列表，槽位 node + 1 为 node 的子列表，末尾多一个哨兵
+    std::vector<int> m_offsets{ 0, 0 };
+    std::vector<int> m_children;
+    QHash<qint64, int> m_nodes;
+};
+#endif
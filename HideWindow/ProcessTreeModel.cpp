@@ -0,0 +1,315 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "ProcessTreeModel.h"
+#include "ProcessListModel.h"
+#include "Trace.h"
+#include <numeric>
+#include <utility>
+
+// ===================== ProcessTreeModel 类实现 =====================
+ProcessTreeModel::ProcessTreeModel(QObject* parent)
+    : QAbstractProxyModel(parent)
+    , m_pidRole(ProcessListModel::PidRole)
+    , m_parentPidRole(ProcessListModel::ParentPidRole)
+    , m_startTimeRole(ProcessListModel::StartTimeRole)
+{
+    m_relayoutTimer.setSingleShot(true);
+    m_relayoutTimer.setInterval(0);
+    connect(&m_relayoutTimer, &QTimer::timeout, this, &ProcessTreeModel::applyPendingRelayout);
+}
+
+void ProcessTreeModel::setSourceModel(QAbstractItemModel* model) {
+    beginResetModel();
+    m_relayoutTimer.stop();
+    if (sourceModel()) {
+        disconnect(sourceModel(), nullptr, this, nullptr);
+    }
+    QAbstractProxyModel::setSourceModel(model);
+    if (model) {
+        connect(model, &QAbstractItemModel::modelAboutToBeReset, this, &ProcessTreeModel::onSourceAboutToBeReset);
+        connect(model, &QAbstractItemModel::modelReset, this, &ProcessTreeModel::onSourceReset);
+        // 行的增删都可能改变父子关系：先平移行号，合并后统一按布局变化处理
+        connect(model, &QAbstractItemModel::rowsInserted, this, &ProcessTreeModel::onSourceRowsInserted);
+        connect(model, &QAbstractItemModel::rowsRemoved, this, &ProcessTreeModel::onSourceRowsRemoved);
+        connect(model, &QAbstractItemModel::rowsAboutToBeMoved, this, &ProcessTreeModel::onSourceLayoutAboutToChange);
+        connect(model, &QAbstractItemModel::rowsMoved, this, &ProcessTreeModel::onSourceLayoutChanged);
+        connect(model, &QAbstractItemModel::layoutAboutToBeChanged, this, &ProcessTreeModel::onSourceLayoutAboutToChange);
+        connect(model, &QAbstractItemModel::layoutChanged, this, &ProcessTreeModel::onSourceLayoutChanged);
+        connect(model, &QAbstractItemModel::dataChanged, this, &ProcessTreeModel::onSourceDataChanged);
+    }
+    rebuild();
+    endResetModel();
+}
+
+void ProcessTreeModel::setTreeRoles(int pidRole, int parentPidRole, int startTimeRole) {
+    if (m_pidRole == pidRole && m_parentPidRole == parentPidRole && m_startTimeRole == startTimeRole) {
+        return;
+    }
+    m_pidRole = pidRole;
+    m_parentPidRole = parentPidRole;
+    m_startTimeRole = startTimeRole;
+    onSourceAboutToBeReset();
+    onSourceReset();
+}
+
+const ProcessTree& ProcessTreeModel::tree() const {
+    return m_tree;
+}
+
+QVariantList ProcessTreeModel::subtreePids(qint64 pid) const {
+    QVariantList pids;
+    const int node = m_tree.find(pid);
+    if (node < 0) {
+        return pids;
+    }
+    std::vector<int> nodes;
+    m_tree.collectSubtree(node, nodes);
+    pids.reserve(static_cast<qsizetype>(nodes.size()));
+    for (int descendant : nodes) {
+        pids.append(m_tree.pid(descendant));
+    }
+    return pids;
+}
+
+QModelIndex ProcessTreeModel::index(int row, int column, const QModelIndex& parent) const {
+    if (row < 0 || column < 0 || column >= columnCount() || (parent.isValid() && parent.column() != 0)) {
+        return QModelIndex();
+    }
+    const int parentNode = parent.isValid() ? static_cast<int>(parent.internalId()) : -1;
+    if (row >= m_tree.childCount(parentNode)) {
+        return QModelIndex();
+    }
+    return createIndex(row, column, static_cast<quintptr>(m_tree.child(parentNode, row)));
+}
+
+QModelIndex ProcessTreeModel::parent(const QModelIndex& child) const {
+    if (!child.isValid()) {
+        return QModelIndex();
+    }
+    const int parentNode = m_tree.parent(static_cast<int>(child.internalId()));
+    if (parentNode < 0) {
+        return QModelIndex();
+    }
+    return createIndex(m_tree.row(parentNode), 0, static_cast<quintptr>(parentNode));
+}
+
+QModelIndex ProcessTreeModel::sibling(int row, int column, const QModelIndex& index) const {
+    // 基类的实现经源模型取相邻行，而源模型中的相邻行不一定是树中的兄弟
+    return this->index(row, column, parent(index));
+}
+
+int ProcessTreeModel::rowCount(const QModelIndex& parent) const {
+    if (parent.isValid() && parent.column() != 0) {
+        return 0;
+    }
+    return m_tree.childCount(parent.isValid() ? static_cast<int>(parent.internalId()) : -1);
+}
+
+int ProcessTreeModel::columnCount(const QModelIndex& parent) const {
+    Q_UNUSED(parent);
+    return sourceModel() ? sourceModel()->columnCount() : 0;
+}
+
+bool ProcessTreeModel::hasChildren(const QModelIndex& parent) const {
+    return rowCount(parent) > 0;
+}
+
+QModelIndex ProcessTreeModel::mapToSource(const QModelIndex& proxyIndex) const {
+    if (!proxyIndex.isValid() || !sourceModel()) {
+        return QModelIndex();
+    }
+    const int row = sourceRowOf(static_cast<int>(proxyIndex.internalId()));
+    if (row < 0) {
+        return QModelIndex();
+    }
+    return sourceModel()->index(row, proxyIndex.column());
+}
+
+QModelIndex ProcessTreeModel::mapFromSource(const QModelIndex& sourceIndex) const {
+    if (!sourceIndex.isValid() || sourceIndex.model() != sourceModel()) {
+        return QModelIndex();
+    }
+    const int node = nodeOfSourceRow(sourceIndex.row());
+    if (node < 0) {
+        return QModelIndex();
+    }
+    return createIndex(m_tree.row(node), sourceIndex.column(), static_cast<quintptr>(node));
+}
+
+int ProcessTreeModel::sourceRowOf(int node) const {
+    // 没有未重建的增删时节点号即源行号
+    if (!m_rowMapped) {
+        return node;
+    }
+    return node >= 0 && node < static_cast<int>(m_nodeRow.size()) ? m_nodeRow[node] : -1;
+}
+
+int ProcessTreeModel::nodeOfSourceRow(int row) const {
+    if (!m_rowMapped) {
+        return row >= 0 && row < m_tree.count() ? row : -1;
+    }
+    return row >= 0 && row < static_cast<int>(m_rowNode.size()) ? m_rowNode[row] : -1;
+}
+
+void ProcessTreeModel::ensureRowMap() {
+    if (m_rowMapped) {
+        return;
+    }
+    m_nodeRow.resize(static_cast<size_t>(m_tree.count()));
+    std::iota(m_nodeRow.begin(), m_nodeRow.end(), 0);
+    m_rowNode = m_nodeRow;
+    m_rowMapped = true;
+}
+
+void ProcessTreeModel::onSourceAboutToBeReset() {
+    m_relayoutTimer.stop();
+    beginResetModel();
+}
+
+void ProcessTreeModel::onSourceReset() {
+    m_rowMapped = false;
+    rebuild();
+    endResetModel();
+}
+
+void ProcessTreeModel::onSourceRowsInserted(const QModelIndex& parent, int first, int last) {
+    if (parent.isValid()) {
+        return;
+    }
+    // 新行在重建前不出现在树中；其后的行号整体后移
+    ensureRowMap();
+    const int count = last - first + 1;
+    for (int& row : m_nodeRow) {
+        if (row >= first) {
+            row += count;
+        }
+    }
+    m_rowNode.insert(m_rowNode.begin() + first, static_cast<size_t>(count), -1);
+    m_relayoutTimer.start();
+}
+
+void ProcessTreeModel::onSourceRowsRemoved(const QModelIndex& parent, int first, int last) {
+    if (parent.isValid()) {
+        return;
+    }
+    // 被删除行的节点在重建前仍留在树中，但不再对应源行（数据为空）
+    ensureRowMap();
+    const int count = last - first + 1;
+    for (int& row : m_nodeRow) {
+        if (row > last) {
+            row -= count;
+        }
+        else if (row >= first) {
+            row = -1;
+        }
+    }
+    m_rowNode.erase(m_rowNode.begin() + first, m_rowNode.begin() + last + 1);
+    m_relayoutTimer.start();
+}
+
+void ProcessTreeModel::onSourceLayoutAboutToChange() {
+    // 行号即将任意重排，平移表无法跟踪：先完成挂起的重建，源模型此时尚未改变
+    flushPendingRelayout();
+    emit layoutAboutToBeChanged();
+}
+
+void ProcessTreeModel::onSourceLayoutChanged() {
+    relayout();
+}
+
+void ProcessTreeModel::applyPendingRelayout() {
+    if (!m_rowMapped) {
+        return;
+    }
+    emit layoutAboutToBeChanged();
+    relayout();
+}
+
+void ProcessTreeModel::flushPendingRelayout() {
+    if (m_relayoutTimer.isActive()) {
+        m_relayoutTimer.stop();
+        applyPendingRelayout();
+    }
+}
+
+void ProcessTreeModel::relayout() {
+    m_relayoutTimer.stop();
+    const ProcessTree previous = std::move(m_tree);
+    m_rowMapped = false;
+    rebuild();
+
+    // 持久索引按 PID 迁移到新树中的位置，已退出进程的索引失效
+    const QModelIndexList from = persistentIndexList();
+    QModelIndexList to;
+    to.reserve(from.size());
+    for (const QModelIndex& index : from) {
+        const int node = m_tree.find(previous.pid(static_cast<int>(index.internalId())));
+        to.append(node < 0 ? QModelIndex() : createIndex(m_tree.row(node), index.column(), static_cast<quintptr>(node)));
+    }
+    changePersistentIndexList(from, to);
+    emit layoutChanged();
+}
+
+void ProcessTreeModel::onSourceDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight, const QList<int>& roles) {
+    if (topLeft.parent().isValid()) {
+        return;
+    }
+    if (m_rowMapped) {
+        // 已有挂起的重建，会重新读取所有行的 PID 信息，这里只转发数据变化
+        m_relayoutTimer.start();
+        forwardDataChanged(topLeft, bottomRight, roles);
+        return;
+    }
+    const int first = topLeft.row();
+    const int last = qMin(bottomRight.row(), m_tree.count() - 1);
+    if (roles.isEmpty() || roles.contains(m_pidRole) || roles.contains(m_parentPidRole) || roles.contains(m_startTimeRole)) {
+        ProcessEntry entry;
+        for (int row = first; row <= last; ++row) {
+            readRow(row, entry);
+            const ProcessEntry& known = m_entries.at(row);
+            if (entry.pid != known.pid || entry.parentPid != known.parentPid || entry.startTime != known.startTime) {
+                emit layoutAboutToBeChanged();
+                relayout();
+                return;
+            }
+        }
+    }
+    forwardDataChanged(topLeft, bottomRight, roles);
+}
+
+void ProcessTreeModel::forwardDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight, const QList<int>& roles) {
+    // 源模型中相邻的行在树中分散在各处，逐行转发
+    for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
+        const QModelIndex left = mapFromSource(sourceModel()->index(row, topLeft.column()));
+        if (left.isValid()) {
+            emit dataChanged(left, left.siblingAtColumn(bottomRight.column()), roles);
+        }
+    }
+}
+
+void ProcessTreeModel::rebuild() {
+    HW_TRACE_SCOPE("process", "ProcessTreeModel::rebuild");
+    const int rows = sourceModel() ? sourceModel()->rowCount() : 0;
+    m_entries.resize(rows);
+    for (int row = 0; row < rows; ++row) {
+        readRow(row, m_entries[row]);
+    }
+    m_tree.build(m_entries);
+}
+
+void ProcessTreeModel::readRow(int row, ProcessEntry& entry) const {
+    // 一次调用取齐三个角色
+    QModelRoleData roles[] = { QModelRoleData(m_pidRole), QModelRoleData(m_parentPidRole), QModelRoleData(m_startTimeRole) };
+    sourceModel()->multiData(sourceModel()->index(row, 0), roles);
+    entry.pid = roles[0].data().toLongLong();
+    entry.parentPid = roles[1].data().toLongLong();
+    entry.startTime = roles[2].data().toULongLong();
+}
@@ -0,0 +1,81 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+#ifndef PROCESSTREEMODEL_H
+#define PROCESSTREEMODEL_H
+#include <QAbstractProxyModel>
+#include <QList>
+#include <QObject>
+#include <QTimer>
+#include <QVariantList>
+#include <vector>
+#include "ProcessTree.h"
+
+// 把按行排列的进程列表（默认为 ProcessListModel）按父子关系呈现为树，供 TreeView 使用。
+// - 代理中的节点号即源模型的行号，角色数据直接转发给源模型
+// - 源模型增删行时只平移节点与源行号的对应关系，同一轮事件循环中的增删合并为一次
+//   ProcessTree 重建；重建时以 layoutChanged 按 PID 迁移持久索引，视图中的展开状态与选中项得以保留
+// - 源模型移动行或整体重排时立即重建
+// - 只有显示用的角色变化时按行转发 dataChanged，不重建
+class ProcessTreeModel : public QAbstractProxyModel {
+    Q_OBJECT
+public:
+    explicit ProcessTreeModel(QObject* parent = nullptr);
+
+    void setSourceModel(QAbstractItemModel* sourceModel) override;
+    // 源模型中给出 PID、父 PID 与创建时间的角色（默认为 ProcessListModel 的对应角色）
+    void setTreeRoles(int pidRole, int parentPidRole, int startTimeRole);
+    const ProcessTree& tree() const;
+
+    // pid 及其所有后代进程的 PID，可直接交给 HideProcess::hideProcesses / showProcesses
+    Q_INVOKABLE QVariantList subtreePids(qint64 pid) const;
+
+    QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex& child) const override;
+    QModelIndex sibling(int row, int column, const QModelIndex& index) const override;
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    bool hasChildren(const QModelIndex& parent = QModelIndex()) const override;
+    QModelIndex mapToSource(const QModelIndex& proxyIndex) const override;
+    QModelIndex mapFromSource(const QModelIndex& sourceIndex) const override;
+private slots:
+    void onSourceAboutToBeReset();
+    void onSourceReset();
+    void onSourceRowsInserted(const QModelIndex& parent, int first, int last);
+    void onSourceRowsRemoved(const QModelIndex& parent, int first, int last);
+    void onSourceLayoutAboutToChange();
+    void onSourceLayoutChanged();
+    void onSourceDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight, const QList<int>& roles);
+private:
+    // 从源模型读取所有行的 PID 信息并重建 m_tree
+    void rebuild();
+    void readRow(int row, ProcessEntry& entry) const;
+    // 重建并按 PID 迁移持久索引，之后发出 layoutChanged（调用前须已发出 layoutAboutToBeChanged）
+    void relayout();
+    // 延迟重建：合并同一轮事件循环中的多次增删
+    void applyPendingRelayout();
+    void flushPendingRelayout();
+    void forwardDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight, const QList<int>& roles);
+    // 有未重建的增删时，节点号与源行号不再相同，改由下面两张表对应
+    void ensureRowMap();
+    int sourceRowOf(int node) const;
+    int nodeOfSourceRow(int row) const;
+    ProcessTree m_tree;
+    QList<ProcessEntry> m_entries; // 建树时的 PID 信息，用于判断 dataChanged 是否改变了结构
+    int m_pidRole;
+    int m_parentPidRole;
+    int m_startTimeRole;
+    QTimer m_relayoutTimer;
+    bool m_rowMapped = false;
+    std::vector<int> m_nodeRow; // 节点 -> 当前源行号，源行已删除时为 -1
+    std::vector<int> m_rowNode; // 源行号 -> 节点，重建前新增的行为 -1
+};
+#endif
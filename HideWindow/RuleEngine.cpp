@@ -0,0 +1,347 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "RuleEngine.h"
+#include <algorithm>
+
+namespace {
+bool hasWildcard(QStringView text) {
+    return text.contains(u'*') || text.contains(u'?');
+}
+
+bool parseField(QStringView name, RuleField& field) {
+    if (name.compare(u"exe", Qt::CaseInsensitive) == 0) {
+        field = RuleField::ExeName;
+    }
+    else if (name.compare(u"path", Qt::CaseInsensitive) == 0) {
+        field = RuleField::ExePath;
+    }
+    else if (name.compare(u"class", Qt::CaseInsensitive) == 0) {
+        field = RuleField::ClassName;
+    }
+    else if (name.compare(u"title", Qt::CaseInsensitive) == 0) {
+        field = RuleField::Title;
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+} // namespace
+
+// ===================== HideRule 实现 =====================
+bool HideRule::parse(const QString& line, HideRule& rule, QString* error) {
+    rule.text = line.trimmed();
+    rule.conditions.clear();
+    if (rule.text.isEmpty()) {
+        if (error) {
+            *error = QStringLiteral("empty rule");
+        }
+        return false;
+    }
+    for (QStringView part : QStringView(rule.text).split(u"&&")) {
+        part = part.trimmed();
+        const qsizetype colon = part.indexOf(u':');
+        RuleCondition condition;
+        if (colon <= 0 || !parseField(part.left(colon).trimmed(), condition.field)) {
+            if (error) {
+                *error = QStringLiteral("expected exe:, path:, class: or title: in \"%1\"").arg(part.toString());
+            }
+            return false;
+        }
+        condition.pattern = part.mid(colon + 1).trimmed().toString();
+        if (condition.pattern.isEmpty()) {
+            if (error) {
+                *error = QStringLiteral("empty pattern in \"%1\"").arg(part.toString());
+            }
+            return false;
+        }
+        rule.conditions.append(condition);
+    }
+    return true;
+}
+
+QStringView RuleSubject::field(RuleField field) const {
+    switch (field) {
+    case RuleField::ExeName:
+        return exeName;
+    case RuleField::ExePath:
+        return exePath;
+    case RuleField::ClassName:
+        return className;
+    case RuleField::Title:
+        return title;
+    }
+    return QStringView();
+}
+
+// ===================== RuleEngine 类实现 =====================
+RuleEngine::RuleEngine() {
+    compile();
+}
+
+int RuleEngine::addRule(const QString& text, QString* error) {
+    HideRule rule;
+    if (!HideRule::parse(text, rule, error)) {
+        return -1;
+    }
+    rule.id = m_nextId++;
+    m_rules.push_back(rule);
+    m_dirty = true;
+    return rule.id;
+}
+
+bool RuleEngine::removeRule(int id) {
+    auto it = std::find_if(m_rules.begin(), m_rules.end(), [id](const HideRule& rule) { return rule.id == id; });
+    if (it == m_rules.end()) {
+        return false;
+    }
+    m_rules.erase(it);
+    m_dirty = true;
+    return true;
+}
+
+void RuleEngine::clear() {
+    m_rules.clear();
+    m_dirty = true;
+}
+
+QStringList RuleEngine::ruleTexts() const {
+    QStringList texts;
+    texts.reserve(static_cast<qsizetype>(m_rules.size()));
+    for (const HideRule& rule : m_rules) {
+        texts.append(rule.text);
+    }
+    return texts;
+}
+
+QString RuleEngine::ruleText(int id) const {
+    for (const HideRule& rule : m_rules) {
+        if (rule.id == id) {
+            return rule.text;
+        }
+    }
+    return QString();
+}
+
+bool RuleEngine::usesField(RuleField field) const {
+    return m_fieldUsed[static_cast<int>(field)];
+}
+
+quint32 RuleEngine::fieldOptions(RuleField field) {
+    return field == RuleField::ExePath
+        ? (AhoCorasick::CaseInsensitive | AhoCorasick::UnifySeparators)
+        : AhoCorasick::CaseInsensitive;
+}
+
+void RuleEngine::compile() {
+    m_fields.clear();
+    m_fields.reserve(kRuleFieldCount);
+    for (int field = 0; field < kRuleFieldCount; ++field) {
+        m_fields.emplace_back(fieldOptions(static_cast<RuleField>(field)));
+    }
+    m_conditions.clear();
+    m_compiledIds.clear();
+    m_ruleConditionCount.clear();
+    m_fieldUsed.fill(false);
+
+    for (const HideRule& rule : m_rules) {
+        const int ruleIndex = static_cast<int>(m_compiledIds.size());
+        m_compiledIds.push_back(rule.id);
+        m_ruleConditionCount.push_back(static_cast<int>(rule.conditions.size()));
+
+        for (const RuleCondition& condition : rule.conditions) {
+            const QStringView pattern(condition.pattern);
+            CompiledCondition compiled;
+            compiled.rule = ruleIndex;
+            compiled.pattern = condition.pattern;
+
+            // 由通配符的位置决定判定方式；literal 为交给自动机的字面量
+            QStringView literal;
+            const qsizetype length = pattern.size();
+            if (!hasWildcard(pattern)) {
+                compiled.kind = Kind::Equals;
+                literal = pattern;
+            }
+            else if (length > 1 && pattern.endsWith(u'*') && !hasWildcard(pattern.left(length - 1))) {
+                compiled.kind = Kind::Prefix;
+                literal = pattern.left(length - 1);
+            }
+            else if (length > 1 && pattern.startsWith(u'*') && !hasWildcard(pattern.mid(1))) {
+                compiled.kind = Kind::Suffix;
+                literal = pattern.mid(1);
+            }
+            else if (length > 2 && pattern.startsWith(u'*') && pattern.endsWith(u'*')
+                && !hasWildcard(pattern.mid(1, length - 2))) {
+                compiled.kind = Kind::Contains;
+                literal = pattern.mid(1, length - 2);
+            }
+            else {
+                // 取最长的不含通配符的片段做预筛：文本中没有它就不可能匹配
+                compiled.kind = Kind::Glob;
+                qsizetype start = 0;
+                for (qsizetype i = 0; i <= length; ++i) {
+                    if (i == length || pattern[i] == u'*' || pattern[i] == u'?') {
+                        if (i - start > literal.size()) {
+                            literal = pattern.mid(start, i - start);
+                        }
+                        start = i + 1;
+                    }
+                }
+            }
+
+            const int conditionIndex = static_cast<int>(m_conditions.size());
+            FieldMatcher& matcher = m_fields[static_cast<int>(condition.field)];
+            const int patternId = matcher.automaton.addPattern(literal);
+            if (patternId < 0) {
+                matcher.unfiltered.push_back(conditionIndex);
+            }
+            else {
+                if (static_cast<int>(matcher.patternConditions.size()) <= patternId) {
+                    matcher.patternConditions.resize(patternId + 1);
+                }
+                matcher.patternConditions[patternId].push_back(conditionIndex);
+                compiled.literalLength = matcher.automaton.patternLength(patternId);
+            }
+            m_conditions.push_back(compiled);
+            m_fieldUsed[static_cast<int>(condition.field)] = true;
+        }
+    }
+
+    for (FieldMatcher& matcher : m_fields) {
+        matcher.automaton.build();
+    }
+    m_generation = 0;
+    m_conditionSeen.assign(m_conditions.size(), 0);
+    m_ruleSeen.assign(m_compiledIds.size(), 0);
+    m_ruleSatisfied.assign(m_compiledIds.size(), 0);
+    m_dirty = false;
+}
+
+bool RuleEngine::globMatch(QStringView pattern, QStringView text, quint32 options) {
+    // 贪心匹配，遇到失配时回到最近的 * 多吞一个字符
+    qsizetype p = 0;
+    qsizetype t = 0;
+    qsizetype starPattern = -1;
+    qsizetype starText = 0;
+    while (t < text.size()) {
+        if (p < pattern.size() && pattern[p] != u'*'
+            && (pattern[p] == u'?'
+                || AhoCorasick::fold(pattern.utf16()[p], options) == AhoCorasick::fold(text.utf16()[t], options))) {
+            ++p;
+            ++t;
+        }
+        else if (p < pattern.size() && pattern[p] == u'*') {
+            starPattern = p++;
+            starText = t;
+        }
+        else if (starPattern >= 0) {
+            p = starPattern + 1;
+            t = ++starText;
+        }
+        else {
+            return false;
+        }
+    }
+    while (p < pattern.size() && pattern[p] == u'*') {
+        ++p;
+    }
+    return p == pattern.size();
+}
+
+void RuleEngine::satisfy(int condition, std::vector<int>* out, int* first) const {
+    m_conditionSeen[condition] = m_generation;
+    const int rule = m_conditions[condition].rule;
+    if (m_ruleSeen[rule] != m_generation) {
+        m_ruleSeen[rule] = m_generation;
+        m_ruleSatisfied[rule] = 0;
+    }
+    if (++m_ruleSatisfied[rule] != m_ruleConditionCount[rule]) {
+        return;
+    }
+    if (out) {
+        out->push_back(rule);
+    }
+    if (first && (*first < 0 || rule < *first)) {
+        *first = rule;
+    }
+}
+
+void RuleEngine::evaluate(const RuleSubject& subject, std::vector<int>* out, int* first) const {
+    if (++m_generation == 0) {
+        // 代号回绕：清零后从 1 重新开始
+        std::fill(m_conditionSeen.begin(), m_conditionSeen.end(), 0);
+        std::fill(m_ruleSeen.begin(), m_ruleSeen.end(), 0);
+        m_generation = 1;
+    }
+
+    for (int field = 0; field < kRuleFieldCount; ++field) {
+        if (!m_fieldUsed[field]) {
+            continue;
+        }
+        const FieldMatcher& matcher = m_fields[field];
+        const QStringView text = subject.field(static_cast<RuleField>(field));
+        const int textLength = static_cast<int>(text.size());
+
+        matcher.automaton.scan(text, [&](int patternId, int end) {
+            for (int index : matcher.patternConditions[patternId]) {
+                if (m_conditionSeen[index] == m_generation) {
+                    continue;
+                }
+                const CompiledCondition& condition = m_conditions[index];
+                bool satisfied = false;
+                switch (condition.kind) {
+                case Kind::Equals:
+                    satisfied = end == textLength && condition.literalLength == textLength;
+                    break;
+                case Kind::Prefix:
+                    satisfied = end == condition.literalLength;
+                    break;
+                case Kind::Suffix:
+                    satisfied = end == textLength;
+                    break;
+                case Kind::Contains:
+                    satisfied = true;
+                    break;
+                case Kind::Glob:
+                    // 每个条件每次匹配最多校验一次
+                    m_conditionSeen[index] = m_generation;
+                    satisfied = globMatch(condition.pattern, text, matcher.automaton.options());
+                    break;
+                }
+                if (satisfied) {
+                    satisfy(index, out, first);
+                }
+            }
+            return true;
+        });
+
+        for (int index : matcher.unfiltered) {
+            if (globMatch(m_conditions[index].pattern, text, matcher.automaton.options())) {
+                satisfy(index, out, first);
+            }
+        }
+    }
+}
+
+int RuleEngine::match(const RuleSubject& subject) const {
+    int first = -1;
+    evaluate(subject, nullptr, &first);
+    return first >= 0 ? m_compiledIds[first] : -1;
+}
+
+void RuleEngine::matchAll(const RuleSubject& subject, std::vector<int>& out) const {
+    out.clear();
+    evaluate(subject, &out, nullptr);
+    std::sort(out.begin(), out.end());
+    for (int& rule : out) {
+        rule = m_compiledIds[rule];
+    }
+}
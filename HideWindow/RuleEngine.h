@@ -0,0 +1,138 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+#ifndef RULEENGINE_H
+#define RULEENGINE_H
+// 自动隐藏规则：所有规则编译进每个字段一台 Aho-Corasick 自动机，
+// 每个窗口事件对每个字段只扫描一遍即可得到全部命中的规则。
+//
+// 规则语法（一行一条，条件之间用 && 连接，全部满足才命中）：
+//     exe:*slack*.exe
+//     class:Chrome_WidgetWin_1 && title:*Netflix*
+//     path:C:\Games\*
+// 字段为 exe（可执行文件名）、path（完整路径）、class（窗口类名）、title（窗口标题）；
+// 模式为通配符（* 任意串，? 任意单个字符），不区分大小写，path 中 / 与 \ 等价。
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QStringView>
+#include <QtGlobal>
+#include <array>
+#include <vector>
+#include "AhoCorasick.h"
+
+enum class RuleField : quint8 {
+    ExeName,
+    ExePath,
+    ClassName,
+    Title
+};
+constexpr int kRuleFieldCount = 4;
+
+struct RuleCondition {
+    RuleField field = RuleField::ExeName;
+    QString pattern;
+};
+
+struct HideRule {
+    int id = -1;
+    QString text; // 原始规则文本
+    QList<RuleCondition> conditions;
+
+    // 解析一行规则；失败时返回 false 并写入 error
+    static bool parse(const QString& line, HideRule& rule, QString* error = nullptr);
+};
+
+// 参与匹配的窗口 / 进程属性；未知的字段留空
+struct RuleSubject {
+    QStringView exeName;
+    QStringView exePath;
+    QStringView className;
+    QStringView title;
+
+    QStringView field(RuleField field) const;
+};
+
+// 规则集合的编译结果与匹配。匹配时复用内部的临时状态，不是线程安全的：
+// 编译与匹配应在同一线程进行
+class RuleEngine {
+public:
+    RuleEngine();
+    RuleEngine(const RuleEngine&) = delete;
+    RuleEngine& operator=(const RuleEngine&) = delete;
+
+    // 添加规则，返回规则 id；语法错误时返回 -1 并写入 error
+    int addRule(const QString& text, QString* error = nullptr);
+    bool removeRule(int id);
+    void clear();
+    // 修改规则后必须重新编译；编译前 match 使用上一次的编译结果
+    void compile();
+    bool needsCompile() const { return m_dirty; }
+
+    bool isEmpty() const { return m_rules.empty(); }
+    int ruleCount() const { return static_cast<int>(m_rules.size()); }
+    QStringList ruleTexts() const;
+    // 规则的原始文本，id 不存在时返回空串
+    QString ruleText(int id) const;
+    // 是否有规则用到该字段（未用到的字段调用方可以不必查询）
+    bool usesField(RuleField field) const;
+
+    // 第一个命中的规则 id（按添加顺序），没有时返回 -1
+    int match(const RuleSubject& subject) const;
+    // 所有命中的规则 id，按添加顺序写入 out（先清空）
+    void matchAll(const RuleSubject& subject, std::vector<int>& out) const;
+
+    // 通配符匹配（* 与 ?），按 options 规范化字符
+    static bool globMatch(QStringView pattern, QStringView text, quint32 options);
+
+private:
+    // 条件的编译形式：能用字面量位置判定的直接判定，其余用自动机预筛后再做通配符校验
+    enum class Kind : quint8 {
+        Equals,   // 无通配符
+        Prefix,   // lit*
+        Suffix,   // *lit
+        Contains, // *lit*
+        Glob      // 其他：字面量预筛 + 通配符校验
+    };
+    struct CompiledCondition {
+        int rule = 0;          // 编译时的规则下标（见 m_compiledIds）
+        Kind kind = Kind::Glob;
+        QString pattern;       // 原始通配符模式
+        int literalLength = 0;
+    };
+    struct FieldMatcher {
+        explicit FieldMatcher(quint32 options) : automaton(options) {}
+        AhoCorasick automaton;
+        std::vector<std::vector<int>> patternConditions; // 模式编号 -> 条件下标
+        std::vector<int> unfiltered; // 没有可用字面量的通配符条件，每次都要校验
+    };
+
+    void evaluate(const RuleSubject& subject, std::vector<int>* out, int* first) const;
+    void satisfy(int condition, std::vector<int>* out, int* first) const;
+    static quint32 fieldOptions(RuleField field);
+
+    std::vector<HideRule> m_rules;
+    int m_nextId = 1;
+    bool m_dirty = false;
+
+    std::vector<FieldMatcher> m_fields;
+    std::vector<CompiledCondition> m_conditions;
+    std::vector<int> m_compiledIds;        // 编译时的规则下标 -> 规则 id
+    std::vector<int> m_ruleConditionCount;
+    std::array<bool, kRuleFieldCount> m_fieldUsed{};
+
+    // 匹配时的临时状态，按代号区分，避免每次清零
+    mutable quint32 m_generation = 0;
+    mutable std::vector<quint32> m_conditionSeen;
+    mutable std::vector<quint32> m_ruleSeen;
+    mutable std::vector<int> m_ruleSatisfied;
+};
+#endif
@@ -0,0 +1,129 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+#ifndef SPSCRING_H
+#define SPSCRING_H
+// 平台无关的有界无锁单生产者/单消费者环形队列（仅依赖标准库）
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+// 每个槽位带序号（Vyukov 有界队列），因此生产者在队列满时也可以安全地
+// 丢弃最旧的元素而不与消费者产生数据竞争。push/pop 均无锁、不分配内存。
+template <typename T>
+class SpscRing {
+    static_assert(std::is_trivially_copyable<T>::value, "ring elements are copied without locks");
+
+public:
+    enum class OverflowPolicy {
+        DropNewest, // 队列满时丢弃新元素（默认）
+        DropOldest  // 队列满时丢弃最旧的元素，为新元素腾出位置
+    };
+
+    // capacity 向上取整为 2 的幂
+    explicit SpscRing(std::size_t capacity)
+        : m_mask(roundUpPowerOfTwo(capacity) - 1)
+        , m_slots(new Slot[m_mask + 1])
+    {
+        for (std::size_t i = 0; i <= m_mask; ++i) {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    std::size_t capacity() const { return m_mask + 1; }
+
+    void setOverflowPolicy(OverflowPolicy policy) {
+        m_policy.store(policy, std::memory_order_relaxed);
+    }
+    OverflowPolicy overflowPolicy() const {
+        return m_policy.load(std::memory_order_relaxed);
+    }
+
+    // 因队列满而丢弃的元素总数
+    std::uint64_t droppedCount() const {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+    // 仅生产者线程调用；元素被丢弃时返回 false
+    bool push(const T& value) {
+        for (int attempt = 0; attempt < 2; ++attempt) {
+            Slot& slot = m_slots[m_head & m_mask];
+            if (slot.sequence.load(std::memory_order_acquire) == m_head) {
+                slot.value = value;
+                slot.sequence.store(m_head + 1, std::memory_order_release);
+                ++m_head;
+                return true;
+            }
+            if (attempt > 0 || overflowPolicy() != OverflowPolicy::DropOldest) {
+                break;
+            }
+            // 以消费者的方式取走最旧的元素；若消费者正在读取该槽位，则本次仍丢弃新元素
+            T discarded;
+            if (!pop(discarded)) {
+                break;
+            }
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // 消费者线程调用（DropOldest 时生产者也会调用，因此以 CAS 认领槽位）
+    bool pop(T& value) {
+        std::size_t pos = m_tail.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = m_slots[pos & m_mask];
+            const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0) {
+                if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    value = slot.value;
+                    slot.sequence.store(pos + m_mask + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0) {
+                return false; // 队列为空
+            }
+            else {
+                pos = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    struct Slot {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    static std::size_t roundUpPowerOfTwo(std::size_t n) {
+        std::size_t result = 2;
+        while (result < n) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    const std::size_t m_mask;
+    const std::unique_ptr<Slot[]> m_slots;
+    std::atomic<OverflowPolicy> m_policy{ OverflowPolicy::DropNewest };
+    // 生产者与消费者各自的位置分开放在不同缓存行，避免伪共享
+    alignas(64) std::size_t m_head = 0;
+    alignas(64) std::atomic<std::size_t> m_tail{ 0 };
+    alignas(64) std::atomic<std::uint64_t> m_dropped{ 0 };
+};
+#endif
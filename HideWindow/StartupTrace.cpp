@@ -0,0 +1,137 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "StartupTrace.h"
+#include "AsyncLog.h"
+#include "Metrics.h"
+#include "Trace.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <QMutex>
+#include <QString>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+AsyncLog::Category s_startupLog("startup", 20);
+
+// 最多记录的阶段数，超出的阶段被忽略
+constexpr int kMaxPhases = 32;
+
+struct Phase {
+    const char* name = nullptr;
+    quint64 at = 0; // 纳秒，与 Metrics::now() 同一时钟
+};
+
+struct State {
+    QMutex mutex;
+    Phase phases[kMaxPhases];
+    int count = 0;
+    bool finished = false;
+    QString reportPath;
+    bool exitWhenDone = false;
+};
+
+// 静态初始化时取零点：早于 main()，晚于系统加载程序映像
+const quint64 s_origin = Metrics::now();
+
+State& state() {
+    static State instance;
+    return instance;
+}
+
+double toMs(quint64 ns) {
+    return static_cast<double>(ns) / 1e6;
+}
+
+int findPhase(const State& s, const char* phase) {
+    for (int i = 0; i < s.count; ++i) {
+        if (s.phases[i].name == phase || std::strcmp(s.phases[i].name, phase) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+} // namespace
+
+namespace StartupTrace {
+
+bool mark(const char* phase) {
+    const quint64 at = Metrics::now();
+    State& s = state();
+    {
+        QMutexLocker locker(&s.mutex);
+        if (s.count == kMaxPhases || findPhase(s, phase) >= 0) {
+            return false;
+        }
+        s.phases[s.count++] = { phase, at };
+    }
+    if (Trace::isEnabled()) {
+        Trace::detail::record("startup", phase, s_origin, at - s_origin);
+    }
+    return true;
+}
+
+double elapsedMs(const char* phase) {
+    State& s = state();
+    QMutexLocker locker(&s.mutex);
+    const int index = findPhase(s, phase);
+    return index >= 0 ? toMs(s.phases[index].at - s_origin) : -1.0;
+}
+
+void initFromEnvironment() {
+    State& s = state();
+    QMutexLocker locker(&s.mutex);
+    s.reportPath = qEnvironmentVariable("HIDEWINDOW_STARTUP_TRACE");
+    s.exitWhenDone = qEnvironmentVariableIntValue("HIDEWINDOW_STARTUP_EXIT") != 0;
+}
+
+void finish() {
+    State& s = state();
+    QByteArray report;
+    bool exitWhenDone = false;
+    QString path;
+    {
+        QMutexLocker locker(&s.mutex);
+        if (s.finished) {
+            return;
+        }
+        s.finished = true;
+        for (int i = 0; i < s.count; ++i) {
+            report += s.phases[i].name;
+            report += '\t';
+            report += QByteArray::number(toMs(s.phases[i].at - s_origin), 'f', 2);
+            report += '\n';
+        }
+        path = s.reportPath;
+        exitWhenDone = s.exitWhenDone;
+    }
+    HW_LOG_INFO(s_startupLog, "Startup finished in %1 ms", toMs(Metrics::now() - s_origin));
+
+    if (path == QLatin1String("-")) {
+        fputs(report.constData(), stderr);
+        fflush(stderr);
+    }
+    else if (!path.isEmpty()) {
+        QFile file(path);
+        if (file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            file.write(report);
+        }
+        else {
+            HW_LOG_WARNING(s_startupLog, "Cannot write startup trace to %1", path);
+        }
+    }
+    if (exitWhenDone && QCoreApplication::instance()) {
+        // 排队退出，让当前帧与已排队的事件先处理完
+        QMetaObject::invokeMethod(QCoreApplication::instance(), &QCoreApplication::quit, Qt::QueuedConnection);
+    }
+}
+
+} // namespace StartupTrace
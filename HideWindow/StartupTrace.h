@@ -0,0 +1,33 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+#ifndef STARTUPTRACE_H
+#define STARTUPTRACE_H
+// 启动阶段时间戳：以本模块静态初始化（接近进程启动）为零点，记录各阶段第一次到达的时刻。
+// 追踪开启时同时写入 Trace（"startup" 分类，从零点到该阶段的完整事件）
+#include <QtGlobal>
+
+namespace StartupTrace {
+
+// 记录阶段 phase（必须是静态字符串）；同名阶段只记第一次，此时返回 true。可在任意线程调用
+bool mark(const char* phase);
+// 已记录阶段距零点的毫秒数，未记录时返回 -1
+double elapsedMs(const char* phase);
+
+// 读取环境变量：HIDEWINDOW_STARTUP_TRACE=<文件路径> 时 finish() 把各阶段写成
+// "阶段<TAB>毫秒" 的文本行（"-" 表示写到标准错误）；HIDEWINDOW_STARTUP_EXIT=1 时
+// finish() 之后退出事件循环，供 CI 反复测量首帧与列表填充时间
+void initFromEnvironment();
+// 启动完成：写出报告，按需退出。只有第一次调用生效
+void finish();
+
+} // namespace StartupTrace
+#endif
@@ -0,0 +1,230 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "Trace.h"
+#include "Metrics.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFile>
+#include <QIODevice>
+#include <QList>
+#include <QMutex>
+#include <QThread>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+namespace Trace {
+
+namespace detail {
+std::atomic<bool> g_enabled{ false };
+
+quint64 now() {
+    return Metrics::now();
+}
+} // namespace detail
+
+namespace {
+// 单个线程的环形缓冲区：只有所属线程写入，导出时其他线程按写入计数读取
+struct ThreadBuffer {
+    std::vector<Event> events;
+    quint64 mask = 0;
+    std::atomic<quint64> written{ 0 };
+    std::atomic<quint64> clearedAt{ 0 }; // clear() 时的写入计数
+    int tid = 0;
+    QString threadName;
+};
+
+struct BufferRegistry {
+    QMutex mutex;
+    // 线程退出后缓冲区仍保留，直到导出
+    QList<std::shared_ptr<ThreadBuffer>> buffers;
+    int nextTid = 1;
+    int capacity = 16384;
+    QString exitPath;
+};
+
+BufferRegistry& bufferRegistry() {
+    static BufferRegistry instance;
+    return instance;
+}
+
+thread_local ThreadBuffer* t_buffer = nullptr;
+
+ThreadBuffer* registerThread() {
+    BufferRegistry& registry = bufferRegistry();
+    QMutexLocker locker(&registry.mutex);
+    auto buffer = std::make_shared<ThreadBuffer>();
+    quint64 capacity = 2;
+    while (capacity < static_cast<quint64>(registry.capacity)) {
+        capacity <<= 1;
+    }
+    buffer->events.resize(capacity);
+    buffer->mask = capacity - 1;
+    buffer->tid = registry.nextTid++;
+    QThread* thread = QThread::currentThread();
+    buffer->threadName = thread && !thread->objectName().isEmpty()
+        ? thread->objectName()
+        : QStringLiteral("thread %1").arg(buffer->tid);
+    registry.buffers.append(buffer);
+    return buffer.get();
+}
+
+QByteArray escaped(const char* text) {
+    QByteArray out;
+    for (const char* p = text ? text : ""; *p; ++p) {
+        if (*p == '"' || *p == '\\') {
+            out.append('\\');
+        }
+        out.append(*p);
+    }
+    return out;
+}
+
+QByteArray microseconds(quint64 ns) {
+    return QByteArray::number(static_cast<double>(ns) / 1000.0, 'f', 3);
+}
+
+void writeAtExit() {
+    const QString path = bufferRegistry().exitPath;
+    if (!path.isEmpty()) {
+        writeJsonFile(path);
+    }
+}
+} // namespace
+
+namespace detail {
+void record(const char* category, const char* name, quint64 start, quint64 duration) {
+    ThreadBuffer* buffer = t_buffer;
+    if (!buffer) {
+        buffer = t_buffer = registerThread();
+    }
+    const quint64 index = buffer->written.load(std::memory_order_relaxed);
+    Event& event = buffer->events[index & buffer->mask];
+    event.category = category;
+    event.name = name;
+    event.start = start;
+    event.duration = duration;
+    buffer->written.store(index + 1, std::memory_order_release);
+}
+} // namespace detail
+
+void setEnabled(bool enabled) {
+    detail::g_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void setBufferCapacity(int events) {
+    BufferRegistry& registry = bufferRegistry();
+    QMutexLocker locker(&registry.mutex);
+    registry.capacity = qMax(2, events);
+}
+
+void clear() {
+    BufferRegistry& registry = bufferRegistry();
+    QMutexLocker locker(&registry.mutex);
+    // 写入计数只由所属线程修改，这里只记录水位线，导出时跳过之前的事件
+    for (const std::shared_ptr<ThreadBuffer>& buffer : registry.buffers) {
+        buffer->clearedAt.store(buffer->written.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+}
+
+bool writeJson(QIODevice& device) {
+    BufferRegistry& registry = bufferRegistry();
+    QMutexLocker locker(&registry.mutex);
+
+    const QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+    QByteArray out;
+    out.reserve(1 << 16);
+    out.append("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+    bool first = true;
+    auto separator = [&]() {
+        if (!first) {
+            out.append(",\n");
+        }
+        first = false;
+    };
+
+    std::vector<Event> copy;
+    for (const std::shared_ptr<ThreadBuffer>& buffer : registry.buffers) {
+        const QByteArray tid = QByteArray::number(buffer->tid);
+        separator();
+        out.append("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":").append(pid)
+            .append(",\"tid\":").append(tid)
+            .append(",\"args\":{\"name\":\"").append(escaped(buffer->threadName.toUtf8().constData())).append("\"}}");
+
+        // 先读写入计数再复制；复制后再次读取，丢弃复制期间可能被覆盖的槽位
+        const quint64 capacity = buffer->mask + 1;
+        const quint64 end = buffer->written.load(std::memory_order_acquire);
+        quint64 begin = end > capacity ? end - capacity : 0;
+        begin = qMax(begin, qMin(end, buffer->clearedAt.load(std::memory_order_relaxed)));
+        copy.clear();
+        for (quint64 i = begin; i < end; ++i) {
+            copy.push_back(buffer->events[i & buffer->mask]);
+        }
+        const quint64 after = buffer->written.load(std::memory_order_acquire);
+        const quint64 safeBegin = after > capacity ? after - capacity : 0;
+        const std::size_t skip = safeBegin > begin ? static_cast<std::size_t>(qMin(safeBegin - begin, end - begin)) : 0;
+
+        for (std::size_t i = skip; i < copy.size(); ++i) {
+            const Event& event = copy[i];
+            separator();
+            out.append("{\"name\":\"").append(escaped(event.name))
+                .append("\",\"cat\":\"").append(escaped(event.category))
+                .append("\",\"pid\":").append(pid)
+                .append(",\"tid\":").append(tid)
+                .append(",\"ts\":").append(microseconds(event.start));
+            if (event.duration == kInstant) {
+                out.append(",\"ph\":\"i\",\"s\":\"t\"}");
+            }
+            else {
+                out.append(",\"ph\":\"X\",\"dur\":").append(microseconds(event.duration)).append('}');
+            }
+        }
+        if (out.size() > (1 << 20)) {
+            device.write(out);
+            out.clear();
+        }
+    }
+    out.append("]}\n");
+    return device.write(out) == out.size();
+}
+
+bool writeJsonFile(const QString& path) {
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Cannot write trace file" << path << ":" << file.errorString();
+        return false;
+    }
+    const bool ok = writeJson(file);
+    qInfo() << "Trace written to" << path;
+    return ok;
+}
+
+void initFromEnvironment() {
+    const QString path = qEnvironmentVariable("HIDEWINDOW_TRACE");
+    if (path.isEmpty()) {
+        return;
+    }
+#ifndef HIDEWINDOW_ENABLE_TRACE
+    qWarning() << "HIDEWINDOW_TRACE is set but tracing was compiled out";
+#endif
+    BufferRegistry& registry = bufferRegistry();
+    {
+        QMutexLocker locker(&registry.mutex);
+        const bool firstTime = registry.exitPath.isEmpty();
+        registry.exitPath = path;
+        if (firstTime) {
+            std::atexit(writeAtExit);
+        }
+    }
+    setEnabled(true);
+}
+
+} // namespace Trace
@@ -0,0 +1,102 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+#ifndef TRACE_H
+#define TRACE_H
+// 作用域追踪：记录到每线程环形缓冲区，按需或退出时导出为 Chrome Trace Event JSON
+// （chrome://tracing、Perfetto 均可打开）。
+//
+// 未定义 HIDEWINDOW_ENABLE_TRACE 时 HW_TRACE_* 宏展开为空，不产生任何代码；
+// 定义后默认关闭，运行时关闭时每个作用域只有一次分支。
+// 设置环境变量 HIDEWINDOW_TRACE=<文件路径> 可在启动时开启并在退出时写出。
+#include <QString>
+#include <QtGlobal>
+#include <atomic>
+
+class QIODevice;
+
+namespace Trace {
+
+// 一条事件（Chrome Trace 的 "X" 完整事件或 "i" 瞬时事件）；名称与分类必须是静态字符串
+struct Event {
+    const char* name = nullptr;
+    const char* category = nullptr;
+    quint64 start = 0;    // 纳秒，与 Metrics::now() 同一时钟
+    quint64 duration = 0; // 纳秒；kInstant 表示瞬时事件
+};
+constexpr quint64 kInstant = ~quint64(0);
+
+namespace detail {
+extern std::atomic<bool> g_enabled;
+quint64 now();
+void record(const char* category, const char* name, quint64 start, quint64 duration);
+} // namespace detail
+
+inline bool isEnabled() {
+    return detail::g_enabled.load(std::memory_order_relaxed);
+}
+void setEnabled(bool enabled);
+
+// 每个线程缓冲区容纳的事件数，满后覆盖最旧的事件；只影响之后新建的线程缓冲区
+void setBufferCapacity(int events);
+
+// 把所有线程缓冲区中的事件写成 JSON；不清空缓冲区
+bool writeJson(QIODevice& device);
+bool writeJsonFile(const QString& path);
+// 清空所有线程缓冲区
+void clear();
+// 读取 HIDEWINDOW_TRACE 环境变量；已设置时开启追踪，并在程序退出时写出到该路径
+void initFromEnvironment();
+
+// 作用域计时：构造时记录开始，析构时写入一条完整事件
+class Scope {
+public:
+    Scope(const char* category, const char* name)
+        : m_category(category)
+        , m_name(name)
+        , m_start(isEnabled() ? detail::now() : 0)
+    {
+    }
+    ~Scope() {
+        if (m_start != 0) {
+            detail::record(m_category, m_name, m_start, detail::now() - m_start);
+        }
+    }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    const char* m_category;
+    const char* m_name;
+    quint64 m_start;
+};
+
+} // namespace Trace
+
+#ifdef HIDEWINDOW_ENABLE_TRACE
+#define HW_TRACE_CONCAT_INNER(a, b) a##b
+#define HW_TRACE_CONCAT(a, b) HW_TRACE_CONCAT_INNER(a, b)
+// 在当前作用域结束时记录一条事件，例如 HW_TRACE_SCOPE("hide", "hideWindowsOf")
+#define HW_TRACE_SCOPE(category, name) \
+    ::Trace::Scope HW_TRACE_CONCAT(hwTraceScope_, __LINE__)(category, name)
+// 记录一个瞬时事件
+#define HW_TRACE_INSTANT(category, name) \
+    do { \
+        if (::Trace::isEnabled()) { \
+            ::Trace::detail::record(category, name, ::Trace::detail::now(), ::Trace::kInstant); \
+        } \
+    } while (0)
+#else
+#define HW_TRACE_SCOPE(category, name) ((void)0)
+#define HW_TRACE_INSTANT(category, name) ((void)0)
+#endif
+
+#endif
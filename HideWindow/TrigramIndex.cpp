@@ -0,0 +1,264 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "TrigramIndex.h"
+#include <algorithm>
+
+namespace {
+// 名称与路径之间的分隔符；查询词按空白拆分，不会包含它，因此匹配不会跨越两个字段
+constexpr char16_t kSeparator = u'\n';
+// 模糊匹配时名称内命中的额外得分
+constexpr int kNameBonus = 16;
+
+bool isSpace(char16_t c) {
+    return c == u' ' || c == u'\t' || c == u'\r' || c == u'\n';
+}
+
+bool isWordBoundary(char16_t c) {
+    return c == u'\\' || c == u'.' || c == u' ' || c == u'-' || c == u'_';
+}
+
+// 从 first 起找第一个不小于 value 的位置。先按 1, 2, 4... 的步长跨越再二分：
+// 求交集的各表长度相近时目标通常就在附近，比每次对剩余部分整体二分少很多比较
+std::vector<quint32>::const_iterator gallop(std::vector<quint32>::const_iterator first,
+    std::vector<quint32>::const_iterator last, quint32 value) {
+    std::ptrdiff_t step = 1;
+    while (last - first > step && first[step] < value) {
+        first += step;
+        step *= 2;
+    }
+    return std::lower_bound(first, last - first > step ? first + step + 1 : last, value);
+}
+} // namespace
+
+// ===================== TrigramIndex 类实现 =====================
+quint32 TrigramIndex::add(QStringView name, QStringView path) {
+    const quint32 doc = nextDoc();
+    const std::size_t begin = m_pool.size();
+    for (qsizetype i = 0; i < name.size(); ++i) {
+        m_pool.push_back(AhoCorasick::fold(name.utf16()[i], kFoldOptions));
+    }
+    m_pool.push_back(kSeparator);
+    for (qsizetype i = 0; i < path.size(); ++i) {
+        m_pool.push_back(AhoCorasick::fold(path.utf16()[i], kFoldOptions));
+    }
+    m_begin.push_back(static_cast<quint32>(m_pool.size()));
+
+    // 同一文档中重复的 n 元组只登记一次，倒排表中的文档号保持唯一且递增
+    m_keys.clear();
+    const char16_t* data = m_pool.data() + begin;
+    const qsizetype length = static_cast<qsizetype>(m_pool.size() - begin);
+    for (qsizetype i = 0; i < length; ++i) {
+        for (int n = 1; n <= 3 && i + n <= length && data[i + n - 1] != kSeparator; ++n) {
+            m_keys.push_back(gramKey(data + i, n));
+        }
+    }
+    std::sort(m_keys.begin(), m_keys.end());
+    m_keys.erase(std::unique(m_keys.begin(), m_keys.end()), m_keys.end());
+    for (quint64 key : m_keys) {
+        m_postings[key].push_back(doc);
+    }
+
+    m_nameLength.push_back(static_cast<int>(name.size()));
+    m_alive.push_back(true);
+    ++m_aliveCount;
+    return doc;
+}
+
+void TrigramIndex::remove(quint32 doc) {
+    if (!isAlive(doc)) {
+        return;
+    }
+    // 倒排表与文本池中的内容留到重建时再清理，查询时按标记跳过
+    m_alive[doc] = false;
+    --m_aliveCount;
+}
+
+void TrigramIndex::clear() {
+    m_pool.clear();
+    m_begin.assign(1, 0);
+    m_nameLength.clear();
+    m_alive.clear();
+    m_aliveCount = 0;
+    m_postings.clear();
+}
+
+QStringList TrigramIndex::terms(QStringView query) {
+    QStringList result;
+    QString term;
+    for (qsizetype i = 0; i <= query.size(); ++i) {
+        if (i == query.size() || isSpace(query.utf16()[i])) {
+            if (!term.isEmpty()) {
+                result.append(term);
+                term.clear();
+            }
+            continue;
+        }
+        term.append(QChar(AhoCorasick::fold(query.utf16()[i], kFoldOptions)));
+    }
+    return result;
+}
+
+bool TrigramIndex::narrows(const QStringList& old, const QStringList& current) {
+    for (const QString& term : old) {
+        const bool covered = std::any_of(current.begin(), current.end(), [&](const QString& candidate) {
+            return candidate.contains(term);
+        });
+        if (!covered) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool TrigramIndex::matches(quint32 doc, const QStringList& terms) const {
+    if (!isAlive(doc)) {
+        return false;
+    }
+    for (const QString& term : terms) {
+        if (!contains(doc, term)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int TrigramIndex::find(quint32 doc, QStringView term, int from) const {
+    // 文本与词都很短，按首字符逐个比较比通用的查找少了每次调用的准备开销
+    const qsizetype length = term.size();
+    const char16_t* begin = m_pool.data() + m_begin[doc];
+    const char16_t* last = m_pool.data() + m_begin[doc + 1] - length;
+    if (length == 0) {
+        return from;
+    }
+    const char16_t* needle = term.utf16();
+    for (const char16_t* p = begin + from; p <= last; ++p) {
+        if (*p == needle[0] && std::equal(needle + 1, needle + length, p + 1)) {
+            return static_cast<int>(p - begin);
+        }
+    }
+    return -1;
+}
+
+const std::vector<quint32>* TrigramIndex::postings(QStringView term) const {
+    if (term.isEmpty() || term.size() > 3) {
+        return nullptr;
+    }
+    const auto it = m_postings.constFind(gramKey(term.utf16(), static_cast<int>(term.size())));
+    return it == m_postings.constEnd() ? nullptr : &it.value();
+}
+
+void TrigramIndex::lookup(const QStringList& terms, std::vector<quint32>& out) const {
+    out.clear();
+    // 短词的倒排表就是精确结果；长词取其全部三元组，求交集后还需校验
+    m_keys.clear();
+    QStringList verify;
+    for (const QString& term : terms) {
+        if (term.size() <= 3) {
+            m_keys.push_back(gramKey(term.utf16(), static_cast<int>(term.size())));
+            continue;
+        }
+        verify.append(term);
+        for (qsizetype i = 0; i + 3 <= term.size(); ++i) {
+            m_keys.push_back(gramKey(term.utf16() + i, 3));
+        }
+    }
+    if (m_keys.empty()) {
+        return;
+    }
+    std::sort(m_keys.begin(), m_keys.end());
+    m_keys.erase(std::unique(m_keys.begin(), m_keys.end()), m_keys.end());
+
+    std::vector<const std::vector<quint32>*> lists;
+    lists.reserve(m_keys.size());
+    for (quint64 key : m_keys) {
+        const auto it = m_postings.constFind(key);
+        if (it == m_postings.constEnd()) {
+            return; // 某个 n 元组从未出现，结果为空
+        }
+        lists.push_back(&it.value());
+    }
+    // 从最短的倒排表出发，其余表用游标推进求交集
+    std::sort(lists.begin(), lists.end(), [](const std::vector<quint32>* a, const std::vector<quint32>* b) {
+        return a->size() < b->size();
+    });
+    std::vector<std::vector<quint32>::const_iterator> cursors;
+    cursors.reserve(lists.size());
+    for (const std::vector<quint32>* list : lists) {
+        cursors.push_back(list->cbegin());
+    }
+    for (quint32 doc : *lists.front()) {
+        if (!m_alive[doc]) {
+            continue;
+        }
+        bool inAll = true;
+        for (std::size_t i = 1; i < lists.size(); ++i) {
+            cursors[i] = gallop(cursors[i], lists[i]->cend(), doc);
+            if (cursors[i] == lists[i]->cend()) {
+                return; // 较长的表已经耗尽，后面不会再有交集
+            }
+            if (*cursors[i] != doc) {
+                inAll = false;
+                break;
+            }
+        }
+        // 三元组都出现不代表整个长词出现，仍需校验一次
+        if (inAll && std::all_of(verify.begin(), verify.end(), [&](const QString& term) { return contains(doc, term); })) {
+            out.push_back(doc);
+        }
+    }
+}
+
+int TrigramIndex::fuzzyScan(QStringView text, QStringView pattern) {
+    int score = 0;
+    int run = 0;
+    qsizetype position = 0;
+    qsizetype previous = -2;
+    const char16_t* data = text.utf16();
+    for (qsizetype p = 0; p < pattern.size(); ++p) {
+        const char16_t c = pattern.utf16()[p];
+        qsizetype found = position;
+        while (found < text.size() && data[found] != c) {
+            ++found;
+        }
+        if (found == text.size()) {
+            return -1;
+        }
+        score += 1;
+        if (found == previous + 1) {
+            ++run;
+            score += 2 * run; // 连续命中越长加分越多
+        }
+        else {
+            run = 0;
+            score -= static_cast<int>(qMin<qsizetype>(found - position, 3));
+        }
+        if (found == 0 || isWordBoundary(data[found - 1])) {
+            score += 3;
+        }
+        previous = found;
+        position = found + 1;
+    }
+    // -1 专用于未命中
+    return qMax(score, 0);
+}
+
+int TrigramIndex::fuzzyScore(quint32 doc, QStringView pattern) const {
+    if (!isAlive(doc)) {
+        return -1;
+    }
+    const QStringView folded = text(doc);
+    const int nameLength = m_nameLength[doc];
+    const int nameScore = fuzzyScan(folded.left(nameLength), pattern);
+    if (nameScore >= 0) {
+        return nameScore + kNameBonus;
+    }
+    return fuzzyScan(folded.mid(nameLength + 1), pattern);
+}
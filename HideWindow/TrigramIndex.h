@@ -0,0 +1,84 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+#ifndef TRIGRAMINDEX_H
+#define TRIGRAMINDEX_H
+// 进程名与路径的 n 元组（n = 1..3）倒排索引，供搜索框做子串过滤。
+// 不超过三个字符的词直接由倒排表精确给出结果；更长的词用三元组求交集后再校验。
+// 文档号只增不减：新文档追加到倒排表末尾，倒排表天然有序；删除只打标记，
+// 由调用方在失效文档过多时整体重建。
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QStringView>
+#include <QtGlobal>
+#include <vector>
+#include "AhoCorasick.h"
+
+class TrigramIndex {
+public:
+    // 不区分大小写，路径分隔符 / 与 \ 等价（与 RuleEngine 的 path 字段一致）
+    static constexpr quint32 kFoldOptions = AhoCorasick::CaseInsensitive | AhoCorasick::UnifySeparators;
+
+    // 添加一个文档并返回文档号
+    quint32 add(QStringView name, QStringView path);
+    void remove(quint32 doc);
+    void clear();
+
+    bool isAlive(quint32 doc) const { return doc < m_alive.size() && m_alive[doc]; }
+    int aliveCount() const { return m_aliveCount; }
+    int deadCount() const { return static_cast<int>(m_alive.size()) - m_aliveCount; }
+    quint32 nextDoc() const { return static_cast<quint32>(m_alive.size()); }
+
+    // 把查询按空白拆成已折叠的词；所有词都出现（子串）才算命中
+    static QStringList terms(QStringView query);
+    // old 的每个词都是 current 某个词的子串时，current 的结果必然是 old 结果的子集
+    static bool narrows(const QStringList& old, const QStringList& current);
+
+    bool matches(quint32 doc, const QStringList& terms) const;
+    bool contains(quint32 doc, QStringView term) const { return find(doc, term, 0) >= 0; }
+    // term 在文档折叠文本中从 from 起首次出现的位置，未出现返回 -1
+    int find(quint32 doc, QStringView term, int from) const;
+    // 用倒排表求出命中所有词的文档（已校验，按文档号升序写入 out）
+    void lookup(const QStringList& terms, std::vector<quint32>& out) const;
+    // 不超过三个字符的词的精确倒排表；词不存在时返回 nullptr
+    const std::vector<quint32>* postings(QStringView term) const;
+
+    // 模糊匹配：pattern 的字符按顺序出现即命中，返回得分（越大越好），未命中返回 -1。
+    // 名称内的匹配优先于路径，连续字符与词首字符加分
+    int fuzzyScore(quint32 doc, QStringView pattern) const;
+
+    // 折叠后的 "名称\n路径"
+    QStringView text(quint32 doc) const {
+        return QStringView(m_pool.data() + m_begin[doc], m_begin[doc + 1] - m_begin[doc]);
+    }
+
+private:
+    // 长度写在最高位，1..3 个码元的键互不冲突
+    static quint64 gramKey(const char16_t* p, int length) {
+        quint64 key = static_cast<quint64>(length) << 48;
+        for (int i = 0; i < length; ++i) {
+            key |= static_cast<quint64>(p[i]) << (16 * (length - 1 - i));
+        }
+        return key;
+    }
+    static int fuzzyScan(QStringView text, QStringView pattern);
+
+    // 所有文档的折叠文本连续存放，校验时按文档号顺序访问，缓存友好；失效文档的文本在重建时回收
+    std::vector<char16_t> m_pool;
+    std::vector<quint32> m_begin{ 0 }; // 文档 -> 文本起点（多一个哨兵）
+    std::vector<int> m_nameLength;
+    std::vector<bool> m_alive;
+    int m_aliveCount = 0;
+    QHash<quint64, std::vector<quint32>> m_postings;
+    mutable std::vector<quint64> m_keys; // 临时缓冲，复用容量
+};
+#endif
@@ -0,0 +1,169 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "WindowIndex.h"
+#include "Trace.h"
+
+// ===================== WindowIndex 类实现 =====================
+WindowIndex::WindowIndex(WindowSystem* system)
+    : m_system(system)
+{
+    if (m_system) {
+        m_system->setEventHandler(this);
+    }
+}
+
+WindowIndex::~WindowIndex() {
+    if (m_system) {
+        m_system->setEventHandler(nullptr);
+    }
+}
+
+void WindowIndex::rebuild() {
+    HW_TRACE_SCOPE("window", "findWindows");
+    beginRebuild();
+    m_scratch.clear();
+    if (m_system) {
+        m_system->enumerateTopLevelWindows(m_scratch);
+    }
+    finishRebuild(m_scratch);
+}
+
+void WindowIndex::beginRebuild() {
+    m_rebuilding = true;
+    m_updatedDuringRebuild.clear();
+    m_destroyedDuringRebuild.clear();
+}
+
+void WindowIndex::finishRebuild(std::vector<WindowInfo>& windows) {
+    HW_TRACE_SCOPE("window", "finishRebuild");
+    // 遍历期间收到过事件的窗口，缓存比遍历结果新
+    std::vector<WindowInfo> updated;
+    updated.reserve(m_updatedDuringRebuild.size());
+    for (WindowId id : m_updatedDuringRebuild) {
+        auto it = m_windows.find(id);
+        if (it != m_windows.end()) {
+            updated.push_back(std::move(it->second));
+        }
+    }
+
+    m_windows.clear();
+    m_byPid.clear();
+    m_windows.reserve(windows.size() + updated.size());
+    m_byPid.reserve(windows.size() + updated.size());
+    for (const WindowInfo& info : windows) {
+        if (m_updatedDuringRebuild.count(info.id) == 0 && m_destroyedDuringRebuild.count(info.id) == 0) {
+            insert(info);
+        }
+    }
+    for (const WindowInfo& info : updated) {
+        insert(info);
+    }
+    windows.clear();
+
+    m_rebuilding = false;
+    m_updatedDuringRebuild.clear();
+    m_destroyedDuringRebuild.clear();
+}
+
+void WindowIndex::setObserver(WindowIndexObserver* observer) {
+    m_observer = observer;
+}
+
+const WindowInfo* WindowIndex::find(WindowId id) const {
+    auto it = m_windows.find(id);
+    return it != m_windows.end() ? &it->second : nullptr;
+}
+
+void WindowIndex::setCachedVisible(WindowId id, bool visible) {
+    auto it = m_windows.find(id);
+    if (it != m_windows.end()) {
+        it->second.visible = visible;
+        noteUpdated(id);
+    }
+}
+
+void WindowIndex::windowCreated(WindowId id) {
+    WindowInfo info;
+    if (m_system && m_system->queryWindow(id, info)) {
+        erase(id); // 句柄可能被复用
+        insert(info);
+        noteUpdated(id);
+        if (m_observer) {
+            m_observer->windowUpdated(info);
+        }
+    }
+}
+
+void WindowIndex::windowDestroyed(WindowId id) {
+    erase(id);
+    if (m_rebuilding) {
+        // 句柄随后若被复用，创建事件会把它重新记为已更新
+        m_updatedDuringRebuild.erase(id);
+        m_destroyedDuringRebuild.insert(id);
+    }
+}
+
+void WindowIndex::windowVisibilityChanged(WindowId id, bool visible) {
+    auto it = m_windows.find(id);
+    if (it != m_windows.end()) {
+        // 只通知由隐藏变为可见；自身修改可见性时已先更新缓存，不会重复通知
+        const bool shown = visible && !it->second.visible;
+        it->second.visible = visible;
+        noteUpdated(id);
+        if (shown && m_observer) {
+            m_observer->windowUpdated(it->second);
+        }
+        return;
+    }
+    // 创建事件早于窗口成为顶层窗口时可能漏掉，显示时补录
+    windowCreated(id);
+}
+
+void WindowIndex::windowTitleChanged(WindowId id) {
+    auto it = m_windows.find(id);
+    WindowInfo info;
+    if (it != m_windows.end() && m_system && m_system->queryWindow(id, info)) {
+        it->second.title = info.title;
+        noteUpdated(id);
+        if (m_observer) {
+            m_observer->windowUpdated(it->second);
+        }
+    }
+}
+
+void WindowIndex::insert(const WindowInfo& info) {
+    m_windows.emplace(info.id, info);
+    m_byPid.emplace(info.pid, info.id);
+}
+
+void WindowIndex::noteUpdated(WindowId id) {
+    if (m_rebuilding) {
+        m_updatedDuringRebuild.insert(id);
+    }
+}
+
+void WindowIndex::erase(WindowId id) {
+    auto it = m_windows.find(id);
+    if (it == m_windows.end()) {
+        return;
+    }
+    auto range = m_byPid.equal_range(it->second.pid);
+    for (auto pidIt = range.first; pidIt != range.second; ++pidIt) {
+        if (pidIt->second == id) {
+            m_byPid.erase(pidIt);
+            break;
+        }
+    }
+    m_windows.erase(it);
+    if (m_observer) {
+        m_observer->windowRemoved(id);
+    }
+}
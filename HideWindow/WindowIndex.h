@@ -0,0 +1,94 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+#ifndef WINDOWINDEX_H
+#define WINDOWINDEX_H
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "WindowSystem.h"
+
+// 索引内容变化的观察者：只报告窗口事件引起的变化，rebuild() 不逐个通知
+class WindowIndexObserver {
+public:
+    virtual ~WindowIndexObserver() = default;
+    // 窗口加入索引、变为可见或标题改变；info 为更新后的缓存
+    virtual void windowUpdated(const WindowInfo& info) = 0;
+    virtual void windowRemoved(WindowId id) = 0;
+};
+
+// PID -> 顶层窗口索引：一次遍历建立，之后由窗口事件增量维护
+class WindowIndex : public WindowEventHandler {
+public:
+    explicit WindowIndex(WindowSystem* system);
+    ~WindowIndex() override;
+    WindowIndex(const WindowIndex&) = delete;
+    WindowIndex& operator=(const WindowIndex&) = delete;
+
+    // 丢弃缓存并重新遍历所有顶层窗口
+    void rebuild();
+    // 分两步重建，遍历可放到后台线程：beginRebuild() 之后在任意线程调用
+    // WindowSystem::enumerateTopLevelWindows，再在本线程把结果交给 finishRebuild()。
+    // 其间的窗口事件照常更新缓存，合并时以事件为准，遍历期间销毁的窗口不会被加回
+    void beginRebuild();
+    void finishRebuild(std::vector<WindowInfo>& windows);
+
+    // 设置观察者（传 nullptr 取消），回调在窗口事件所在线程中同步执行
+    void setObserver(WindowIndexObserver* observer);
+
+    const WindowInfo* find(WindowId id) const;
+    size_t size() const { return m_windows.size(); }
+
+    // 对指定进程的每个窗口调用 fn(const WindowInfo&)
+    template <typename Fn>
+    void forEachWindowOf(qint64 pid, Fn fn) const {
+        auto range = m_byPid.equal_range(pid);
+        for (auto it = range.first; it != range.second; ++it) {
+            auto window = m_windows.find(it->second);
+            if (window != m_windows.end()) {
+                fn(window->second);
+            }
+        }
+    }
+
+    // 对所有窗口调用 fn(const WindowInfo&)
+    template <typename Fn>
+    void forEachWindow(Fn fn) const {
+        for (const auto& window : m_windows) {
+            fn(window.second);
+        }
+    }
+
+    // 自身改变窗口可见性后立即更新缓存，不必等待事件
+    void setCachedVisible(WindowId id, bool visible);
+
+    // WindowEventHandler
+    void windowCreated(WindowId id) override;
+    void windowDestroyed(WindowId id) override;
+    void windowVisibilityChanged(WindowId id, bool visible) override;
+    void windowTitleChanged(WindowId id) override;
+
+private:
+    void insert(const WindowInfo& info);
+    void erase(WindowId id);
+    // 分步重建期间记录由事件更新过的窗口
+    void noteUpdated(WindowId id);
+
+    WindowSystem* m_system;
+    WindowIndexObserver* m_observer = nullptr;
+    std::unordered_map<WindowId, WindowInfo> m_windows;
+    std::unordered_multimap<qint64, WindowId> m_byPid;
+    std::vector<WindowInfo> m_scratch; // rebuild 时复用的枚举缓冲区
+    bool m_rebuilding = false;
+    std::unordered_set<WindowId> m_updatedDuringRebuild;
+    std::unordered_set<WindowId> m_destroyedDuringRebuild;
+};
+#endif
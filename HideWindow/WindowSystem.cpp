@@ -0,0 +1,249 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "WindowSystem.h"
+#include "AsyncLog.h"
+#include "ProcessHandleCache.h"
+#include "Trace.h"
+
+#ifdef Q_OS_WIN
+#pragma comment(lib, "User32.lib")
+
+namespace {
+AsyncLog::Category s_windowLog("window");
+
+// 读取本进程其他线程所属窗口标题的等待上限
+constexpr UINT kOwnWindowTextTimeoutMs = 50;
+
+HWND toHwnd(WindowId id) {
+    return reinterpret_cast<HWND>(id);
+}
+
+WindowId toWindowId(HWND hwnd) {
+    return reinterpret_cast<WindowId>(hwnd);
+}
+
+void fillWindowInfo(HWND hwnd, DWORD pid, WindowInfo& info) {
+    WCHAR buffer[256] = { 0 };
+    info.id = toWindowId(hwnd);
+    info.pid = pid;
+    int length = GetClassNameW(hwnd, buffer, 256);
+    info.className = QString::fromWCharArray(buffer, length);
+    // 本进程的窗口 GetWindowText 会向其所属线程发送 WM_GETTEXT 并等待；后台遍历时该线程
+    // 可能正忙于启动或正在等待遍历结束，改为限时发送，避免阻塞甚至互相等待
+    DWORD_PTR copied = 0;
+    if (pid == GetCurrentProcessId() && GetWindowThreadProcessId(hwnd, nullptr) != GetCurrentThreadId()) {
+        length = SendMessageTimeoutW(hwnd, WM_GETTEXT, 256, reinterpret_cast<LPARAM>(buffer),
+            SMTO_ABORTIFHUNG | SMTO_BLOCK, kOwnWindowTextTimeoutMs, &copied) ? static_cast<int>(copied) : 0;
+    }
+    else {
+        length = GetWindowTextW(hwnd, buffer, 256);
+    }
+    info.title = QString::fromWCharArray(buffer, length);
+    info.visible = IsWindowVisible(hwnd) != FALSE;
+}
+} // namespace
+
+// ===================== Win32WindowSystem 类实现 =====================
+Win32WindowSystem* Win32WindowSystem::s_instance = nullptr;
+
+Win32WindowSystem::Win32WindowSystem() {
+    Win32WindowSystem::s_instance = this;
+}
+
+Win32WindowSystem::~Win32WindowSystem() {
+    setEventHandler(nullptr);
+    if (Win32WindowSystem::s_instance == this) {
+        Win32WindowSystem::s_instance = nullptr;
+    }
+}
+
+BOOL CALLBACK Win32WindowSystem::enumWindowsProc(HWND hwnd, LPARAM lParam) {
+    auto* out = reinterpret_cast<std::vector<WindowInfo>*>(lParam);
+    DWORD pid = 0;
+    GetWindowThreadProcessId(hwnd, &pid);
+    WindowInfo info;
+    fillWindowInfo(hwnd, pid, info);
+    out->push_back(std::move(info));
+    return TRUE;
+}
+
+void Win32WindowSystem::enumerateTopLevelWindows(std::vector<WindowInfo>& out) {
+    HW_TRACE_SCOPE("window", "EnumWindows");
+    // EnumWindows 在系统内部迭代，替代原先按兄弟窗口逐层递归的 FindWindowEx
+    EnumWindows(&Win32WindowSystem::enumWindowsProc, reinterpret_cast<LPARAM>(&out));
+}
+
+bool Win32WindowSystem::queryWindow(WindowId id, WindowInfo& info) {
+    HWND hwnd = toHwnd(id);
+    if (!IsWindow(hwnd) || GetAncestor(hwnd, GA_PARENT) != GetDesktopWindow()) {
+        return false;
+    }
+    DWORD pid = 0;
+    GetWindowThreadProcessId(hwnd, &pid);
+    fillWindowInfo(hwnd, pid, info);
+    return true;
+}
+
+void Win32WindowSystem::setWindowVisible(WindowId id, bool visible) {
+    setWindowsVisible({ id }, visible);
+}
+
+void Win32WindowSystem::setWindowsVisible(const std::vector<WindowId>& ids, bool visible) {
+    HW_TRACE_SCOPE("window", "setWindowsVisible");
+    // 单个与多个窗口走同一条路径：只切换可见性，不改变最小化 / 最大化状态（精确还原由
+    // restoreWindowPlacement 负责）；已销毁或可见性已符合要求的窗口跳过
+    std::vector<HWND> targets;
+    targets.reserve(ids.size());
+    for (WindowId id : ids) {
+        HWND hwnd = toHwnd(id);
+        if (IsWindow(hwnd) && (IsWindowVisible(hwnd) != FALSE) != visible) {
+            targets.push_back(hwnd);
+        }
+    }
+    if (targets.empty()) {
+        return;
+    }
+
+    // 所有修改收集到同一个 DeferWindowPos 结构中，由 EndDeferWindowPos 一次提交
+    const UINT flags = SWP_NOMOVE | SWP_NOSIZE | SWP_NOZORDER | SWP_NOACTIVATE
+        | (visible ? SWP_SHOWWINDOW : SWP_HIDEWINDOW);
+    HDWP hdwp = BeginDeferWindowPos(static_cast<int>(targets.size()));
+    for (HWND hwnd : targets) {
+        if (hdwp == nullptr) {
+            break;
+        }
+        hdwp = DeferWindowPos(hdwp, hwnd, nullptr, 0, 0, 0, 0, flags);
+    }
+    if (hdwp != nullptr && EndDeferWindowPos(hdwp)) {
+        HW_LOG_DEBUG(s_windowLog, "%1 %2 windows in one batch", visible ? "Shown" : "Hidden", targets.size());
+        return;
+    }
+
+    // 某个窗口不接受延迟定位（例如刚被销毁）时，DeferWindowPos 会释放整个结构，
+    // 退回逐个修改，标志与批量提交相同
+    HW_LOG_WARNING(s_windowLog, "DeferWindowPos batch failed, falling back to per-window update. Error: %1", GetLastError());
+    for (HWND hwnd : targets) {
+        SetWindowPos(hwnd, nullptr, 0, 0, 0, 0, flags);
+    }
+}
+
+bool Win32WindowSystem::windowPlacement(WindowId id, WindowPlacement& placement) {
+    WINDOWPLACEMENT wp = { 0 };
+    wp.length = sizeof(WINDOWPLACEMENT);
+    if (!GetWindowPlacement(toHwnd(id), &wp)) {
+        return false;
+    }
+    placement.showCmd = static_cast<qint32>(wp.showCmd);
+    placement.flags = static_cast<qint32>(wp.flags);
+    placement.left = wp.rcNormalPosition.left;
+    placement.top = wp.rcNormalPosition.top;
+    placement.right = wp.rcNormalPosition.right;
+    placement.bottom = wp.rcNormalPosition.bottom;
+    return true;
+}
+
+bool Win32WindowSystem::restoreWindowPlacement(WindowId id, const WindowPlacement& placement) {
+    HWND hwnd = toHwnd(id);
+    if (!IsWindow(hwnd)) {
+        return false;
+    }
+    WINDOWPLACEMENT wp = { 0 };
+    wp.length = sizeof(WINDOWPLACEMENT);
+    if (!GetWindowPlacement(hwnd, &wp)) {
+        return false;
+    }
+    // 隐藏时窗口必然可见，SW_HIDE 只会出现在损坏的记录中
+    wp.showCmd = placement.showCmd != SW_HIDE ? static_cast<UINT>(placement.showCmd) : SW_SHOWNORMAL;
+    wp.flags = static_cast<UINT>(placement.flags);
+    wp.rcNormalPosition = { placement.left, placement.top, placement.right, placement.bottom };
+    return SetWindowPlacement(hwnd, &wp) != FALSE;
+}
+
+QString Win32WindowSystem::processImagePath(qint64 pid) {
+    // 规则匹配时同一进程的多个窗口连续查询，句柄由缓存复用
+    const std::shared_ptr<ProcessHandle> process = ProcessHandleCache::instance().acquire(pid);
+    if (!process) {
+        return QString();
+    }
+    WCHAR path[MAX_PATH] = { 0 };
+    DWORD length = MAX_PATH;
+    const BOOL ok = QueryFullProcessImageNameW(process->native(), 0, path, &length);
+    return ok ? QString::fromWCharArray(path, static_cast<int>(length)) : QString();
+}
+
+void Win32WindowSystem::setEventHandler(WindowEventHandler* handler) {
+    m_handler = handler;
+    if (m_handler && !m_lifetimeHook) {
+        // 只接收跨进程的事件，回调在本线程消息循环中执行
+        m_lifetimeHook = SetWinEventHook(EVENT_OBJECT_CREATE, EVENT_OBJECT_HIDE, nullptr,
+            &Win32WindowSystem::winEventProc, 0, 0, WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNPROCESS);
+        m_nameHook = SetWinEventHook(EVENT_OBJECT_NAMECHANGE, EVENT_OBJECT_NAMECHANGE, nullptr,
+            &Win32WindowSystem::winEventProc, 0, 0, WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNPROCESS);
+        if (!m_lifetimeHook || !m_nameHook) {
+            HW_LOG_WARNING(s_windowLog, "SetWinEventHook failed, window index will not track changes. Error: %1", GetLastError());
+        }
+    }
+    else if (!m_handler) {
+        if (m_lifetimeHook) {
+            UnhookWinEvent(m_lifetimeHook);
+            m_lifetimeHook = nullptr;
+        }
+        if (m_nameHook) {
+            UnhookWinEvent(m_nameHook);
+            m_nameHook = nullptr;
+        }
+    }
+}
+
+void CALLBACK Win32WindowSystem::winEventProc(HWINEVENTHOOK hook, DWORD event, HWND hwnd,
+    LONG idObject, LONG idChild, DWORD eventThread, DWORD eventTime) {
+    Q_UNUSED(hook);
+    Q_UNUSED(eventThread);
+    Q_UNUSED(eventTime);
+    // 只关心窗口本身的事件，忽略窗口内部的可访问性对象
+    if (idObject != OBJID_WINDOW || idChild != CHILDID_SELF || hwnd == nullptr) {
+        return;
+    }
+    Win32WindowSystem* self = Win32WindowSystem::s_instance;
+    if (!self || !self->m_handler) {
+        return;
+    }
+
+    const WindowId id = toWindowId(hwnd);
+    switch (event) {
+    case EVENT_OBJECT_CREATE:
+        self->m_handler->windowCreated(id);
+        break;
+    case EVENT_OBJECT_DESTROY:
+        self->m_handler->windowDestroyed(id);
+        break;
+    case EVENT_OBJECT_SHOW:
+        self->m_handler->windowVisibilityChanged(id, true);
+        break;
+    case EVENT_OBJECT_HIDE:
+        self->m_handler->windowVisibilityChanged(id, false);
+        break;
+    case EVENT_OBJECT_NAMECHANGE:
+        self->m_handler->windowTitleChanged(id);
+        break;
+    default:
+        break;
+    }
+}
+
+std::unique_ptr<WindowSystem> createDefaultWindowSystem() {
+    return std::make_unique<Win32WindowSystem>();
+}
+#else
+std::unique_ptr<WindowSystem> createDefaultWindowSystem() {
+    return nullptr;
+}
+#endif
@@ -0,0 +1,117 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+#ifndef WINDOWSYSTEM_H
+#define WINDOWSYSTEM_H
+#include <QString>
+#include <QtGlobal>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// 平台无关的窗口标识（Windows 下即 HWND 的数值）
+using WindowId = std::uintptr_t;
+
+// 顶层窗口的缓存信息
+struct WindowInfo {
+    WindowId id = 0;
+    qint64 pid = 0;
+    QString className;
+    QString title;
+    bool visible = false;
+};
+
+// 窗口隐藏前的显示状态与位置，用于精确还原（固定布局，可直接写入日志文件）
+struct WindowPlacement {
+    qint32 showCmd = 0;
+    qint32 flags = 0;
+    qint32 left = 0;
+    qint32 top = 0;
+    qint32 right = 0;
+    qint32 bottom = 0;
+};
+
+// 窗口事件接收者，由窗口系统在窗口创建/销毁/显隐/改名时回调
+class WindowEventHandler {
+public:
+    virtual ~WindowEventHandler() = default;
+    virtual void windowCreated(WindowId id) = 0;
+    virtual void windowDestroyed(WindowId id) = 0;
+    virtual void windowVisibilityChanged(WindowId id, bool visible) = 0;
+    virtual void windowTitleChanged(WindowId id) = 0;
+};
+
+// 窗口系统接口：索引与隐藏逻辑只依赖此接口，便于用模拟桌面替换
+class WindowSystem {
+public:
+    virtual ~WindowSystem() = default;
+    // 一次迭代遍历所有顶层窗口；可在任意线程调用，不触发事件回调
+    virtual void enumerateTopLevelWindows(std::vector<WindowInfo>& out) = 0;
+    // 查询单个窗口，窗口已不存在或不是顶层窗口时返回 false
+    virtual bool queryWindow(WindowId id, WindowInfo& info) = 0;
+    // 只切换可见性，不改变最小化 / 最大化状态；已销毁的窗口忽略
+    virtual void setWindowVisible(WindowId id, bool visible) = 0;
+    // 批量修改可见性，实现应尽量一次性提交以避免逐个窗口闪烁
+    virtual void setWindowsVisible(const std::vector<WindowId>& ids, bool visible) {
+        for (WindowId id : ids) {
+            setWindowVisible(id, visible);
+        }
+    }
+    // 读取窗口当前的显示状态与位置
+    virtual bool windowPlacement(WindowId id, WindowPlacement& placement) = 0;
+    // 按记录的显示状态与位置还原窗口（同时使其可见）
+    virtual bool restoreWindowPlacement(WindowId id, const WindowPlacement& placement) = 0;
+    // 安装事件接收者（传 nullptr 取消订阅）
+    virtual void setEventHandler(WindowEventHandler* handler) = 0;
+    // 进程可执行文件的完整路径，无法查询时返回空串
+    virtual QString processImagePath(qint64 pid) {
+        Q_UNUSED(pid);
+        return QString();
+    }
+};
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+
+// 基于 EnumWindows 与 SetWinEventHook 的 Windows 实现
+// WinEvent 回调通过安装线程的消息循环投递，需在 GUI 线程创建
+class Win32WindowSystem : public WindowSystem {
+public:
+    Win32WindowSystem();
+    ~Win32WindowSystem() override;
+    Win32WindowSystem(const Win32WindowSystem&) = delete;
+    Win32WindowSystem& operator=(const Win32WindowSystem&) = delete;
+
+    void enumerateTopLevelWindows(std::vector<WindowInfo>& out) override;
+    bool queryWindow(WindowId id, WindowInfo& info) override;
+    void setWindowVisible(WindowId id, bool visible) override;
+    void setWindowsVisible(const std::vector<WindowId>& ids, bool visible) override;
+    bool windowPlacement(WindowId id, WindowPlacement& placement) override;
+    bool restoreWindowPlacement(WindowId id, const WindowPlacement& placement) override;
+    void setEventHandler(WindowEventHandler* handler) override;
+    QString processImagePath(qint64 pid) override;
+
+private:
+    static BOOL CALLBACK enumWindowsProc(HWND hwnd, LPARAM lParam);
+    static void CALLBACK winEventProc(HWINEVENTHOOK hook, DWORD event, HWND hwnd,
+        LONG idObject, LONG idChild, DWORD eventThread, DWORD eventTime);
+    // WinEvent 回调没有用户参数，只能通过静态指针找到实例
+    static Win32WindowSystem* s_instance;
+
+    WindowEventHandler* m_handler = nullptr;
+    HWINEVENTHOOK m_lifetimeHook = nullptr; // 创建/销毁/显示/隐藏
+    HWINEVENTHOOK m_nameHook = nullptr;     // 标题变化
+};
+#endif
+
+// 返回当前平台的默认窗口系统，不支持的平台返回 nullptr
+std::unique_ptr<WindowSystem> createDefaultWindowSystem();
+#endif
@@ -1,14 +1,168 @@
-#include <QApplication>
- // 包含你的 GlobalHook 实现
-#include "main.h"
+#include <QDebug>
+#include <QGuiApplication>
+#include <QKeySequence>
+#include <QQmlApplicationEngine>
+#include <QQmlContext>
+#include <QQuickWindow>
+#include <QTimer>
+#include <memory>
+#include "AsyncLog.h"
+#include "ControlServer.h"
+#include "ControlService.h"
+#include "GlobalHook.h"
+#include "HideProcess.h"
+#include "Metrics.h"
+#include "ProcessFilterModel.h"
+#include "ProcessIconProvider.h"
+#include "ProcessListModel.h"
+#include "ProcessTreeModel.h"
+#include "StartupTrace.h"
+#include "Trace.h"
 
+namespace {
+AsyncLog::Category s_hookLog("hook", 20);
+
+// 窗口迟迟没有画出首帧（例如启动即最小化）时，延后的初始化最多再等这么久
+constexpr int kDeferredInitFallbackMs = 1000;
+} // namespace
 
 int main(int argc, char *argv[])
 {
-    QApplication app(argc, argv);
+    StartupTrace::mark("main");
+    QGuiApplication app(argc, argv);
+    // HIDEWINDOW_TRACE=<文件路径> 时开启追踪，退出时写出 Chrome Trace JSON
+    Trace::initFromEnvironment();
+    // HIDEWINDOW_STARTUP_TRACE=<文件路径> 时写出各启动阶段的时间
+    StartupTrace::initFromEnvironment();
+    // 热路径上的日志由后台线程格式化输出
+    AsyncLog::start();
+    StartupTrace::mark("application");
+
+    // 已有实例（图形界面或 hidewindow-cli serve）在运行时交给它处理：第二个核心会争用
+    // 隐藏窗口日志，退出时还会把对方隐藏的窗口还原
+    if (ControlServer::isServing()) {
+        qWarning() << "HideWindow is already running; use hidewindow-cli to control it";
+        AsyncLog::stop();
+        return 0;
+    }
+
+    // 进程快照与窗口遍历都在后台线程进行，与下面加载 QML 并行
+    ProcessListModel processModel;
+    processModel.refresh();
+    HideProcess hideProcess(HideProcess::IndexBuild::Background);
+    ProcessFilterModel processFilter;
+    processFilter.setSourceModel(&processModel);
+    ProcessTreeModel processTree;
+    processTree.setSourceModel(&processModel);
+    // 钩子与隐藏延迟的快照，界面底部显示，hidewindow-cli stats 输出完整报告
+    MetricsStats metricsStats;
+    StartupTrace::mark("scanStarted");
+
+    // 脚本经 hidewindow-cli 通过本地套接字控制正在运行的实例，无需再启动图形界面
+    ControlService controlService(&hideProcess);
+    ControlServer controlServer(&controlService);
+    if (!controlServer.listen() && ControlServer::isServing()) {
+        // 检查之后另一个实例抢先开始监听；日志由它锁定，本实例尚未隐藏任何窗口
+        qWarning() << "HideWindow is already running; use hidewindow-cli to control it";
+        AsyncLog::stop();
+        return 0;
+    }
+    // 图形界面实例收到 shutdown 只关闭控制服务，窗口由用户关闭
+    QObject::connect(&controlService, &ControlService::shutdownRequested, &controlServer, &ControlServer::close,
+        Qt::QueuedConnection);
+
+    // QML 由 qmlcachegen 预编译进资源，加载时不再解析源码
+    QQmlApplicationEngine engine;
+    engine.addImageProvider(QStringLiteral("processicon"), new ProcessIconProvider);
+    QQmlContext* context = engine.rootContext();
+    context->setContextProperty(QStringLiteral("processModel"), &processModel);
+    context->setContextProperty(QStringLiteral("processFilter"), &processFilter);
+    context->setContextProperty(QStringLiteral("processTree"), &processTree);
+    context->setContextProperty(QStringLiteral("hideProcess"), &hideProcess);
+    context->setContextProperty(QStringLiteral("metricsStats"), &metricsStats);
+    engine.load(QUrl(QStringLiteral("qrc:/qml/main.qml")));
+    auto* window = engine.rootObjects().isEmpty() ? nullptr : qobject_cast<QQuickWindow*>(engine.rootObjects().first());
+    if (!window) {
+        AsyncLog::stop();
+        return -1;
+    }
+    StartupTrace::mark("qmlLoaded");
+
+    // 首帧、进程列表、窗口索引都就绪即启动完成
+    int pendingPhases = 3;
+    auto phaseDone = [&pendingPhases]() {
+        if (--pendingPhases == 0) {
+            StartupTrace::finish();
+        }
+    };
+    auto phaseReached = [&phaseDone](const char* phase) {
+        if (StartupTrace::mark(phase)) {
+            phaseDone();
+        }
+    };
+
+    // 全局键盘钩子不影响首屏，首帧之后再安装。只在配置了热键时安装：
+    // HIDEWINDOW_SHOW_ALL_HOTKEY=<按键序列>（如 "Ctrl+Alt+Shift+H"）按下即还原所有隐藏的窗口
+    std::unique_ptr<GlobalHook> hook;
+    bool deferredInitDone = false;
+    auto deferredInit = [&hook, &deferredInitDone, &hideProcess]() {
+        if (deferredInitDone) {
+            return;
+        }
+        deferredInitDone = true;
+        const QString showAllKeys = qEnvironmentVariable("HIDEWINDOW_SHOW_ALL_HOTKEY");
+        if (showAllKeys.isEmpty()) {
+            return;
+        }
+        hook = std::make_unique<GlobalHook>();
+        QObject::connect(hook.get(), &GlobalHook::hookInstallFailed, &hideProcess, [](int errorCode) {
+            HW_LOG_WARNING(s_hookLog, "Failed to install keyboard hook, error %1", errorCode);
+        });
+        const QKeySequence sequence(showAllKeys, QKeySequence::PortableText);
+        const int showAllId = sequence.isEmpty() ? -1 : hook->addHotkey(sequence, true);
+        if (showAllId < 0) {
+            HW_LOG_WARNING(s_hookLog, "Cannot bind hotkey \"%1\"", showAllKeys);
+            hook.reset();
+            return;
+        }
+        // 热键信号在分发线程发出，经 hideProcess 排回界面线程执行
+        QObject::connect(hook.get(), &GlobalHook::hotkeyTriggered, &hideProcess, [&hideProcess, showAllId](int id) {
+            if (id == showAllId) {
+                hideProcess.showAllHiddenWindows();
+            }
+        });
+        StartupTrace::mark("hookInstalled");
+    };
+
+    // frameSwapped 可能在渲染线程发出：直接连接以取得准确的时刻，其余工作排回界面线程
+    QObject::connect(window, &QQuickWindow::frameSwapped, window, [&app, &phaseDone, &deferredInit]() {
+        StartupTrace::mark("firstFrame");
+        QMetaObject::invokeMethod(&app, [&phaseDone, &deferredInit]() {
+            phaseDone();
+            deferredInit();
+        }, Qt::QueuedConnection);
+    }, static_cast<Qt::ConnectionType>(Qt::DirectConnection | Qt::SingleShotConnection));
+    QTimer::singleShot(kDeferredInitFallbackMs, &app, deferredInit);
 
-    MainWindow window;
-    window.show();
+    auto checkProcessList = [&processModel, &phaseReached]() {
+        if (!processModel.isRefreshing() && processModel.rowCount() > 0) {
+            phaseReached("processListPopulated");
+        }
+    };
+    QObject::connect(&processModel, &ProcessListModel::refreshingChanged, &app, checkProcessList);
+    checkProcessList();
+    if (hideProcess.isWindowIndexReady()) {
+        phaseReached("windowIndexReady");
+    }
+    else {
+        QObject::connect(&hideProcess, &HideProcess::windowIndexReady, &app,
+            [&phaseReached]() { phaseReached("windowIndexReady"); }, Qt::SingleShotConnection);
+    }
 
-    return app.exec();
+    const int result = app.exec();
+    if (hook) {
+        hook->stopGlobalHook();
+    }
+    AsyncLog::stop();
+    return result;
 }
@@ -30,6 +30,17 @@ Window {
     color: windowBgColor
     
     property var selectedProcess: null
+
+    // 弹出窗口由 Loader 按需创建，启动时只构建主窗口
+    function showUnselectedHint() {
+        unselectedProcessLoader.active = true
+        unselectedProcessLoader.item.visible = true
+    }
+
+    function showSetHideWindow() {
+        setHideWindowLoader.active = true
+        setHideWindowLoader.item.visible = true
+    }
     
     
     
@@ -47,7 +58,7 @@ Window {
             horizontalAlignment: Text.AlignHCenter
             verticalAlignment: Text.AlignVCenter
         }
-        text: "刷新进程列表(R)"
+        text: processModel.refreshing ? "正在刷新..." : "刷新进程列表(R)"
         focus: true
         Keys.onPressed: {
             if (event.key === Qt.Key_R) {
@@ -92,7 +103,7 @@ Window {
         onClicked: {
             console.log("隐藏按钮被点击")
             if (selectedProcess === null) {
-                unselectedProcess.visible = true
+                showUnselectedHint()
                 console.log("请先选择一个进程")
             } else {
                 console.log("隐藏进程：", selectedProcess.name, "PID：", selectedProcess.pid)
@@ -129,7 +140,7 @@ Button {
         onClicked: {
             console.log("显示按钮被点击")
             if (selectedProcess === null) {
-                unselectedProcess.visible = true
+                showUnselectedHint()
                 console.log("请先选择一个进程")
             } else {
                 console.log("显示进程：", selectedProcess.name, "PID：", selectedProcess.pid)
@@ -166,25 +177,49 @@ Button {
         anchors.margins: 10
         onClicked: {
         if (selectedProcess === null) {
-                unselectedProcess.visible = true
+                showUnselectedHint()
                 console.log("请先选择一个进程")
             } else {
                 console.log("设置隐藏开关按钮被点击")
-                setHideWindow.visible = true;
+                showSetHideWindow()
             }
         }
     }  
     
+    // 搜索框：按进程名与路径过滤，空格分隔的多个词须全部出现
+    TextField {
+        id: searchField
+        anchors.top: refreshBtn.bottom
+        anchors.left: parent.left
+        anchors.right: parent.right
+        anchors.margins: 10
+        placeholderText: "搜索进程名或路径(Ctrl+F)"
+        color: textColor
+        selectByMouse: true
+        background: Rectangle {
+            color: "#1a1a1a"
+            border.color: searchField.activeFocus ? buttonNormalColor : "#2a2a2a"
+            radius: 5
+        }
+        onTextChanged: processFilter.filterText = text
+        Keys.onEscapePressed: text = ""
+    }
+
+    Shortcut {
+        sequence: StandardKey.Find
+        onActivated: searchField.forceActiveFocus()
+    }
+
     ListView {
         id: processListView
-        anchors.top: refreshBtn.bottom
+        anchors.top: searchField.bottom
         anchors.left: parent.left
         anchors.right: parent.right
         anchors.bottom: copyrightText.top
         anchors.margins: 10
         clip: true
 
-        model: processModel
+        model: processFilter
 
 
         delegate: Rectangle {
@@ -205,15 +240,38 @@ Button {
                     }
                 }
                 
-                Text {
-                    id: processText
+                // 图标在后台线程解码，未就绪时只留出空位，不阻塞滚动
+                Image {
+                    id: processIcon
                     anchors.verticalCenter: parent.verticalCenter
                     anchors.left: parent.left
                     anchors.leftMargin: 10
+                    width: 16
+                    height: 16
+                    sourceSize: Qt.size(16, 16)
+                    asynchronous: true
+                    source: file ? "image://processicon/" + encodeURIComponent(file) : ""
+                }
+
+                Text {
+                    id: processText
+                    anchors.verticalCenter: parent.verticalCenter
+                    anchors.left: processIcon.right
+                    anchors.leftMargin: 8
                     text: name + " (PID: " + pid + ")"
                     color: selectedProcess === model ? buttonNormalColor : textColor
                     font.pixelSize: 14
                 }
+
+                // 采样结果只通过 cpu / workingSet 角色更新，名称与路径不会被重新读取
+                Text {
+                    anchors.verticalCenter: parent.verticalCenter
+                    anchors.right: parent.right
+                    anchors.rightMargin: 10
+                    text: cpu.toFixed(1) + "%   " + (workingSet / 1048576).toFixed(1) + " MB"
+                    color: textColor
+                    font.pixelSize: 12
+                }
                 
                 ToolTip.text: file
                 ToolTip.visible: containsMouse
@@ -235,68 +293,147 @@ Button {
         color: textColor
         text: "Copyright © 2026 Scriptforge "
     }
+
+    // 延迟为微秒；悬停显示完整指标报告
+    Text {
+        id: metricsText
+        anchors {
+            bottom: parent.bottom
+            left: parent.left
+            margins: 10
+        }
+        color: "gray"
+        font.pixelSize: 11
+        text: "钩子 p99 " + metricsStats.hookP99.toFixed(0) + " µs   隐藏 p99 "
+              + (metricsStats.hideP99 / 1000).toFixed(1) + " ms"
+
+        MouseArea {
+            id: metricsArea
+            anchors.fill: parent
+            hoverEnabled: true
+        }
+        ToolTip.text: metricsArea.containsMouse ? metricsStats.dump() : ""
+        ToolTip.visible: metricsArea.containsMouse
+    }
     
-    Window {
-        id: unselectedProcess
-        visible: false
-        width: 300
-        height: 150
-        title: "提示"
-        color: windowBgColor
-        modality: Qt.ApplicationModal
+    // 未选择进程的提示窗口，第一次提示时才创建
+    Loader {
+        id: unselectedProcessLoader
+        active: false
+        sourceComponent: Component {
+            Window {
+                id: unselectedProcess
+                visible: false
+                width: 300
+                height: 150
+                title: "提示"
+                color: windowBgColor
+                modality: Qt.ApplicationModal
         
         
         
-        Text {
-            color: textColor
-            text: "请先选择一个进程"
-            font.pixelSize: 30
-            anchors {
-                horizontalCenter: parent.horizontalCenter
-                verticalCenter: parent.verticalCenter
+                Text {
+                    color: textColor
+                    text: "请先选择一个进程"
+                    font.pixelSize: 30
+                    anchors {
+                        horizontalCenter: parent.horizontalCenter
+                        verticalCenter: parent.verticalCenter
+                    }
+                }
             }
         }
     }
 
 
-    Window {
-        id: setHideWindow
-        visible: false  // 初始不可见
-        width: 300
-        height: 200
-        title: "弹出的新窗口"
-        color: windowBgColor
-        modality: Qt.ApplicationModal
+    // 进程树隐藏窗口，第一次打开时才创建
+    Loader {
+        id: setHideWindowLoader
+        active: false
+        sourceComponent: Component {
+            Window {
+                id: setHideWindow
+                visible: false  // 初始不可见
+                width: 300
+                height: 300
+                title: "弹出的新窗口"
+                color: windowBgColor
+                modality: Qt.ApplicationModal
         
-        // 新窗口内容
-        Column {
-            anchors.centerIn: parent
-            spacing: 20
+                // 新窗口内容
+                Column {
+                    anchors.centerIn: parent
+                    spacing: 20
             
-            Text {
-                color: textColor
-                text: selectedProcess ? "当前选中进程: " + selectedProcess.name : "未选中任何进程"
-                font.pixelSize: 18
-                anchors.horizontalCenter: parent.horizontalCenter
-            }
+                    Text {
+                        color: textColor
+                        text: selectedProcess ? "当前选中进程: " + selectedProcess.name : "未选中任何进程"
+                        font.pixelSize: 18
+                        anchors.horizontalCenter: parent.horizontalCenter
+                    }
             
-            Button {
-                text: "关闭窗口"
-                background: Rectangle {
-                    color: parent.pressed ? buttonPressedColor :
-                    parent.hovered ? buttonHoverColor : buttonNormalColor
-                    radius: 10
-                }
-                contentItem: Text {
-                    text: parent.text
-                    color: textColor
-                    font.bold: true
-                    horizontalAlignment: Text.AlignHCenter
-                    verticalAlignment: Text.AlignVCenter
-                }
-                anchors.horizontalCenter: parent.horizontalCenter
-                onClicked: {
-                    setHideWindow.visible = false;
+                    // 浏览器、Electron 等应用的窗口分散在多个子进程中，按整个进程树隐藏 / 显示
+                    Button {
+                        text: "隐藏整个进程树"
+                        enabled: selectedProcess !== null
+                        background: Rectangle {
+                            color: parent.pressed ? buttonPressedColor :
+                            parent.hovered ? buttonHoverColor : buttonNormalColor
+                            radius: 10
+                        }
+                        contentItem: Text {
+                            text: parent.text
+                            color: textColor
+                            font.bold: true
+                            horizontalAlignment: Text.AlignHCenter
+                            verticalAlignment: Text.AlignVCenter
+                        }
+                        anchors.horizontalCenter: parent.horizontalCenter
+                        onClicked: {
+                            hideProcess.hideProcesses(processTree.subtreePids(selectedProcess.pid))
+                        }
+                    }
+
+                    Button {
+                        text: "显示整个进程树"
+                        enabled: selectedProcess !== null
+                        background: Rectangle {
+                            color: parent.pressed ? buttonPressedColor :
+                            parent.hovered ? buttonHoverColor : buttonNormalColor
+                            radius: 10
+                        }
+                        contentItem: Text {
+                            text: parent.text
+                            color: textColor
+                            font.bold: true
+                            horizontalAlignment: Text.AlignHCenter
+                            verticalAlignment: Text.AlignVCenter
+                        }
+                        anchors.horizontalCenter: parent.horizontalCenter
+                        onClicked: {
+                            hideProcess.showProcesses(processTree.subtreePids(selectedProcess.pid))
+                        }
+                    }
+
+                    Button {
+                        text: "关闭窗口"
+                        background: Rectangle {
+                            color: parent.pressed ? buttonPressedColor :
+                            parent.hovered ? buttonHoverColor : buttonNormalColor
+                            radius: 10
+                        }
+                        contentItem: Text {
+                            text: parent.text
+                            color: textColor
+                            font.bold: true
+                            horizontalAlignment: Text.AlignHCenter
+                            verticalAlignment: Text.AlignVCenter
+                        }
+                        anchors.horizontalCenter: parent.horizontalCenter
+                        onClicked: {
+                            setHideWindow.visible = false;
+                        }
+                    }
                 }
             }
         }
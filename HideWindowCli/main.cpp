@@ -0,0 +1,465 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// hidewindow-cli：供登录脚本、演示模式触发器等自动化使用的命令行客户端。
+// 只依赖 QtCore / QtNetwork，不加载 QML 与 Widgets。
+//
+// 有实例运行（图形界面或无界面核心）时经本地套接字发送命令；没有时：
+//   - 会修改窗口的命令启动一个无界面核心（hidewindow-cli serve）常驻，窗口保持隐藏直到 shutdown；
+//   - 只读命令（list / state）在本进程内执行，不留下常驻进程；ping / stats 报告没有实例。
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QLocalSocket>
+#include <QProcess>
+#include <QStringList>
+#include <QTextStream>
+#include <QThread>
+#include <cstdio>
+#include <vector>
+#include "AsyncLog.h"
+#include "ControlProtocol.h"
+#include "ControlServer.h"
+#include "ControlService.h"
+#include "HideProcess.h"
+#include "Trace.h"
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#endif
+
+using namespace ControlProtocol;
+
+namespace {
+constexpr int kConnectTimeoutMs = 500;
+// 启动无界面核心后等待其开始监听的总时长与重试间隔
+constexpr int kSpawnTimeoutMs = 5000;
+constexpr int kSpawnRetryMs = 20;
+constexpr int kResponseTimeoutMs = 30000;
+
+// 退出码
+constexpr int kExitOk = 0;
+constexpr int kExitCommandFailed = 1; // 至少一条命令返回错误
+constexpr int kExitUsage = 2;
+constexpr int kExitUnreachable = 3;   // 无法连接或启动实例
+
+struct Command {
+    Opcode opcode = Opcode::Ping;
+    QByteArray payload;
+    bool mutates = false; // 会修改窗口状态，没有实例时需要常驻的核心
+};
+
+QTextStream& out() {
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+QTextStream& err() {
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+void printUsage() {
+    err() << "usage: hidewindow-cli [--server NAME] COMMAND [ARGS...] [; COMMAND [ARGS...]]...\n"
+             "       hidewindow-cli [--server NAME] -      (commands from stdin, one per line)\n"
+             "       hidewindow-cli [--server NAME] serve  (run the headless core)\n"
+             "\n"
+             "commands:\n"
+             "  ping\n"
+             "  hide PID...            show PID...\n"
+             "  hide-name PATTERN      show-name PATTERN      (executable name, * and ? wildcards)\n"
+             "  add-rule RULE          remove-rule RULE       (e.g. \"exe:*slack*.exe\")\n"
+             "  list [PATTERN]         state\n"
+             "  stats                  (latency and hook counters of the running instance)\n"
+             "  show-all               shutdown\n";
+    err().flush();
+}
+
+// 把一条命令的参数编码为请求；参数有误时返回 false
+bool parseCommand(const QStringList& words, Command& command) {
+    if (words.isEmpty()) {
+        return false;
+    }
+    const QString& verb = words.first();
+    const QStringList args = words.mid(1);
+    QByteArray& payload = command.payload;
+    PayloadWriter writer(payload);
+
+    if (verb == QLatin1String("hide") || verb == QLatin1String("show")) {
+        if (args.isEmpty()) {
+            return false;
+        }
+        command.opcode = verb == QLatin1String("hide") ? Opcode::HidePids : Opcode::ShowPids;
+        command.mutates = true;
+        writer.writeVarint(static_cast<quint64>(args.size()));
+        for (const QString& arg : args) {
+            bool ok = false;
+            const qint64 pid = arg.toLongLong(&ok);
+            if (!ok || pid <= 0) {
+                return false;
+            }
+            writer.writeVarint(static_cast<quint64>(pid));
+        }
+        return true;
+    }
+    if (verb == QLatin1String("hide-name") || verb == QLatin1String("show-name")
+        || verb == QLatin1String("add-rule") || verb == QLatin1String("remove-rule")) {
+        if (args.isEmpty()) {
+            return false;
+        }
+        if (verb == QLatin1String("hide-name")) {
+            command.opcode = Opcode::HideName;
+        }
+        else if (verb == QLatin1String("show-name")) {
+            command.opcode = Opcode::ShowName;
+        }
+        else if (verb == QLatin1String("add-rule")) {
+            command.opcode = Opcode::AddRule;
+        }
+        else {
+            command.opcode = Opcode::RemoveRule;
+        }
+        command.mutates = true;
+        // 规则中的 && 两侧常被 shell 拆成多个参数，这里重新拼接
+        writer.writeString(args.join(QLatin1Char(' ')));
+        return true;
+    }
+    if (verb == QLatin1String("list")) {
+        if (args.size() > 1) {
+            return false;
+        }
+        command.opcode = Opcode::ListProcesses;
+        writer.writeString(args.value(0));
+        return true;
+    }
+    if (args.isEmpty()) {
+        if (verb == QLatin1String("ping")) {
+            command.opcode = Opcode::Ping;
+            return true;
+        }
+        if (verb == QLatin1String("state")) {
+            command.opcode = Opcode::QueryState;
+            return true;
+        }
+        if (verb == QLatin1String("stats")) {
+            command.opcode = Opcode::Stats;
+            return true;
+        }
+        if (verb == QLatin1String("show-all")) {
+            command.opcode = Opcode::ShowAll;
+            command.mutates = true;
+            return true;
+        }
+        if (verb == QLatin1String("shutdown")) {
+            command.opcode = Opcode::Shutdown;
+            return true;
+        }
+    }
+    return false;
+}
+
+// 按单独的 ";" 参数切分为多条命令
+bool parseArguments(const QStringList& args, std::vector<Command>& commands) {
+    QStringList words;
+    for (int i = 0; i <= args.size(); ++i) {
+        if (i < args.size() && args[i] != QLatin1String(";")) {
+            words.append(args[i]);
+            continue;
+        }
+        if (words.isEmpty()) {
+            continue;
+        }
+        Command command;
+        if (!parseCommand(words, command)) {
+            err() << "invalid command: " << words.join(QLatin1Char(' ')) << "\n";
+            return false;
+        }
+        commands.push_back(command);
+        words.clear();
+    }
+    return !commands.empty();
+}
+
+// 从标准输入逐行读取命令，参数以空白分隔，双引号包裹的参数可含空格
+bool parseStdin(std::vector<Command>& commands) {
+    QTextStream in(stdin);
+    QString line;
+    while (in.readLineInto(&line)) {
+        const QString trimmed = line.trimmed();
+        if (trimmed.isEmpty() || trimmed.startsWith(QLatin1Char('#'))) {
+            continue;
+        }
+        Command command;
+        if (!parseCommand(QProcess::splitCommand(trimmed), command)) {
+            err() << "invalid command: " << trimmed << "\n";
+            return false;
+        }
+        commands.push_back(command);
+    }
+    return !commands.empty();
+}
+
+QByteArray encodeRequests(const std::vector<Command>& commands) {
+    QByteArray requests;
+    for (std::size_t i = 0; i < commands.size(); ++i) {
+        appendFrame(requests, static_cast<quint8>(commands[i].opcode), static_cast<quint32>(i + 1), commands[i].payload);
+    }
+    return requests;
+}
+
+// 打印一条响应，返回该命令是否成功
+bool printResponse(const Command& command, const Frame& response) {
+    PayloadReader in(response.payload);
+    if (static_cast<Status>(response.code) != Status::Ok) {
+        QString message;
+        in.readString(message);
+        err() << "error: " << message << "\n";
+        return false;
+    }
+    quint64 first = 0;
+    quint64 second = 0;
+    switch (command.opcode) {
+    case Opcode::Ping:
+        out() << "pong\n";
+        break;
+    case Opcode::HidePids:
+    case Opcode::ShowPids:
+    case Opcode::AddRule:
+    case Opcode::RemoveRule:
+    case Opcode::ShowAll:
+        in.readVarint(first);
+        out() << first << " windows changed\n";
+        break;
+    case Opcode::HideName:
+    case Opcode::ShowName:
+        in.readVarint(first);
+        in.readVarint(second);
+        out() << first << " processes matched, " << second << " windows changed\n";
+        break;
+    case Opcode::ListProcesses: {
+        quint64 count = 0;
+        in.readVarint(count);
+        for (quint64 i = 0; i < count && in.ok(); ++i) {
+            quint64 pid = 0;
+            quint64 parentPid = 0;
+            quint64 hidden = 0;
+            QString name;
+            QString path;
+            in.readVarint(pid);
+            in.readVarint(parentPid);
+            in.readString(name);
+            in.readString(path);
+            in.readVarint(hidden);
+            out() << pid << '\t' << parentPid << '\t' << hidden << '\t' << name << '\t' << path << '\n';
+        }
+        break;
+    }
+    case Opcode::QueryState: {
+        quint64 count = 0;
+        in.readVarint(first);
+        in.readVarint(second);
+        out() << "hidden windows: " << first << "\nindexed windows: " << second << "\nhidden pids:";
+        in.readVarint(count);
+        for (quint64 i = 0; i < count && in.ok(); ++i) {
+            quint64 pid = 0;
+            in.readVarint(pid);
+            out() << ' ' << pid;
+        }
+        out() << "\nrules:\n";
+        in.readVarint(count);
+        for (quint64 i = 0; i < count && in.ok(); ++i) {
+            QString rule;
+            in.readString(rule);
+            out() << "  " << rule << '\n';
+        }
+        break;
+    }
+    case Opcode::Stats: {
+        QString report;
+        in.readString(report);
+        out() << report;
+        break;
+    }
+    case Opcode::Shutdown:
+        out() << "shutting down\n";
+        break;
+    }
+    if (!in.ok()) {
+        err() << "error: malformed response\n";
+        return false;
+    }
+    return true;
+}
+
+// 依次打印 responses 中的响应帧，返回退出码
+int printResponses(const std::vector<Command>& commands, const QByteArray& responses) {
+    int exitCode = kExitOk;
+    qsizetype offset = 0;
+    Frame frame;
+    while (takeFrame(responses, offset, frame) == ParseResult::Frame) {
+        if (frame.id == 0 || frame.id > commands.size()) {
+            continue;
+        }
+        if (!printResponse(commands[frame.id - 1], frame)) {
+            exitCode = kExitCommandFailed;
+        }
+    }
+    out().flush();
+    err().flush();
+    return exitCode;
+}
+
+bool connectTo(QLocalSocket& socket, const QString& serverName) {
+    socket.connectToServer(serverName);
+    return socket.waitForConnected(kConnectTimeoutMs);
+}
+
+// 以分离进程启动无界面核心并等待它开始监听
+bool spawnCore(QLocalSocket& socket, const QString& serverName) {
+    QProcess process;
+    process.setProgram(QCoreApplication::applicationFilePath());
+    process.setArguments({ QStringLiteral("--server"), serverName, QStringLiteral("serve") });
+    process.setStandardOutputFile(QProcess::nullDevice());
+    process.setStandardErrorFile(QProcess::nullDevice());
+#ifdef Q_OS_WIN
+    // 不为常驻核心创建控制台窗口
+    process.setCreateProcessArgumentsModifier([](QProcess::CreateProcessArguments* args) {
+        args->flags |= CREATE_NO_WINDOW;
+    });
+#endif
+    if (!process.startDetached()) {
+        err() << "error: failed to start headless core\n";
+        return false;
+    }
+    QElapsedTimer timer;
+    timer.start();
+    while (timer.elapsed() < kSpawnTimeoutMs) {
+        if (connectTo(socket, serverName)) {
+            return true;
+        }
+        socket.abort();
+        QThread::msleep(kSpawnRetryMs);
+    }
+    err() << "error: headless core did not start listening\n";
+    return false;
+}
+
+// 流水线发送全部请求并等待全部响应
+int runRemote(QLocalSocket& socket, const std::vector<Command>& commands) {
+    socket.write(encodeRequests(commands));
+    if (!socket.waitForBytesWritten(kResponseTimeoutMs) && socket.bytesToWrite() > 0) {
+        err() << "error: " << socket.errorString() << "\n";
+        return kExitUnreachable;
+    }
+    QByteArray responses;
+    std::size_t received = 0;
+    qsizetype offset = 0;
+    Frame frame;
+    while (received < commands.size()) {
+        if (socket.bytesAvailable() == 0 && !socket.waitForReadyRead(kResponseTimeoutMs)) {
+            err() << "error: " << socket.errorString() << "\n";
+            printResponses(commands, responses);
+            return kExitUnreachable;
+        }
+        responses.append(socket.readAll());
+        // 这里只数帧，全部到齐后再统一解码打印
+        while (takeFrame(responses, offset, frame) == ParseResult::Frame) {
+            ++received;
+        }
+    }
+    return printResponses(commands, responses);
+}
+
+// 没有实例且只有只读命令：在本进程内执行。日志为空路径，不触碰上次遗留的隐藏记录
+int runLocal(const std::vector<Command>& commands) {
+    HideProcess hide(createDefaultWindowSystem(), QString());
+    ControlService service(&hide);
+    QByteArray responses;
+    qsizetype offset = 0;
+    const QByteArray requests = encodeRequests(commands);
+    Frame frame;
+    while (takeFrame(requests, offset, frame) == ParseResult::Frame) {
+        service.handleNow(frame, responses);
+    }
+    return printResponses(commands, responses);
+}
+
+int runServer(QCoreApplication& app, const QString& serverName) {
+    // 先确认没有实例在运行再创建核心：HideProcess 构造时会还原日志中遗留的窗口
+    if (ControlServer::isServing(serverName)) {
+        err() << "error: another instance is already serving " << serverName << "\n";
+        return kExitUnreachable;
+    }
+    HideProcess hide;
+    ControlService service(&hide);
+    ControlServer server(&service);
+    if (!server.listen(serverName)) {
+        err() << "error: failed to serve " << serverName << "\n";
+        return kExitUnreachable;
+    }
+    // 排队执行，保证 shutdown 的响应先写出；HideProcess 析构时还原所有窗口
+    QObject::connect(&service, &ControlService::shutdownRequested, &app, &QCoreApplication::quit, Qt::QueuedConnection);
+    return app.exec();
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    // 与图形界面共用应用数据目录，无界面核心与图形界面使用同一份隐藏窗口日志
+    QCoreApplication::setApplicationName(QStringLiteral("HideWindow"));
+    Trace::initFromEnvironment();
+    AsyncLog::start();
+
+    QStringList args = app.arguments().mid(1);
+    QString serverName = ControlServer::defaultServerName();
+    if (args.size() >= 2 && args.first() == QLatin1String("--server")) {
+        serverName = args.at(1);
+        args = args.mid(2);
+    }
+
+    int result = kExitUsage;
+    std::vector<Command> commands;
+    if (args == QStringList{ QStringLiteral("serve") }) {
+        result = runServer(app, serverName);
+    }
+    else if (args == QStringList{ QStringLiteral("-") } ? parseStdin(commands) : parseArguments(args, commands)) {
+        bool mutates = false;
+        // 只有 ping / stats / shutdown，没有实例时无事可做（新进程的指标没有意义）
+        bool probeOnly = true;
+        bool shutdownOnly = true;
+        for (const Command& command : commands) {
+            mutates = mutates || command.mutates;
+            probeOnly = probeOnly && (command.opcode == Opcode::Ping || command.opcode == Opcode::Stats
+                || command.opcode == Opcode::Shutdown);
+            shutdownOnly = shutdownOnly && command.opcode == Opcode::Shutdown;
+        }
+        QLocalSocket socket;
+        if (connectTo(socket, serverName)) {
+            result = runRemote(socket, commands);
+        }
+        else if (probeOnly) {
+            out() << "no running instance\n";
+            result = shutdownOnly ? kExitOk : kExitUnreachable;
+        }
+        else if (!mutates) {
+            result = runLocal(commands);
+        }
+        else {
+            result = spawnCore(socket, serverName) ? runRemote(socket, commands) : kExitUnreachable;
+        }
+    }
+    else {
+        printUsage();
+    }
+
+    out().flush();
+    AsyncLog::stop();
+    return result;
+}
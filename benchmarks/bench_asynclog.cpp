@@ -0,0 +1,94 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include "AsyncLog.h"
+
+namespace {
+constexpr int kBatch = 1000;
+
+AsyncLog::Category s_benchLog("bench");
+AsyncLog::Category s_limitedLog("bench.limited", 1);
+
+void discardMessage(QtMsgType, const QMessageLogContext&, const QString&) {}
+} // namespace
+
+// 调用方一侧的开销：写入定长记录与限流拒绝；同步 qDebug 作为对照
+class BenchAsyncLog : public QObject {
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void write();
+    void writeText();
+    void writeRateLimited();
+    void synchronousQDebug();
+    void formatAndFlush();
+
+private:
+    QtMessageHandler m_previousHandler = nullptr;
+};
+
+void BenchAsyncLog::initTestCase() {
+    // 输出交给空处理器，只测格式化与排队本身；与实际运行一致，后台线程同时取出记录
+    m_previousHandler = qInstallMessageHandler(discardMessage);
+    AsyncLog::start();
+}
+
+void BenchAsyncLog::cleanupTestCase() {
+    AsyncLog::stop();
+    qInstallMessageHandler(m_previousHandler);
+}
+
+void BenchAsyncLog::write() {
+    QBENCHMARK {
+        for (int i = 0; i < kBatch; ++i) {
+            HW_LOG_DEBUG(s_benchLog, "Hidden window: %1 pid: %2", reinterpret_cast<void*>(quintptr(i)), i);
+        }
+    }
+}
+
+void BenchAsyncLog::writeText() {
+    const QString title = QStringLiteral("Untitled - Notepad");
+    QBENCHMARK {
+        for (int i = 0; i < kBatch; ++i) {
+            HW_LOG_DEBUG(s_benchLog, "Hidden window: %1 Title: %2", i, AsyncLog::Text(title));
+        }
+    }
+}
+
+void BenchAsyncLog::writeRateLimited() {
+    QBENCHMARK {
+        for (int i = 0; i < kBatch; ++i) {
+            HW_LOG_DEBUG(s_limitedLog, "limited %1", i);
+        }
+    }
+}
+
+void BenchAsyncLog::synchronousQDebug() {
+    QBENCHMARK {
+        for (int i = 0; i < kBatch; ++i) {
+            qDebug() << "Hidden window:" << reinterpret_cast<void*>(quintptr(i)) << "pid:" << i;
+        }
+    }
+}
+
+void BenchAsyncLog::formatAndFlush() {
+    // 后台线程一侧：把一批记录格式化并交给消息处理器
+    QBENCHMARK {
+        for (int i = 0; i < kBatch; ++i) {
+            HW_LOG_DEBUG(s_benchLog, "Hidden window: %1 pid: %2", reinterpret_cast<void*>(quintptr(i)), i);
+        }
+        AsyncLog::flush();
+    }
+}
+
+QTEST_GUILESS_MAIN(BenchAsyncLog)
+#include "bench_asynclog.moc"
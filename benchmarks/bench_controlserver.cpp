@@ -0,0 +1,220 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include <QEventLoop>
+#include <QLocalSocket>
+#include <QThread>
+#include <QTimer>
+#include <atomic>
+#include "ControlServer.h"
+#include "ControlService.h"
+#include "FakeWindowSystem.h"
+#include "HideProcess.h"
+
+using namespace ControlProtocol;
+
+namespace {
+constexpr int kProcessCount = 300;
+
+class FixedProcessSource : public ProcessSource {
+public:
+    bool snapshot(QList<ProcessEntry>& out, const std::atomic<bool>& cancelled) override {
+        out.clear();
+        for (int i = 1; i <= kProcessCount; ++i) {
+            ProcessEntry entry;
+            entry.pid = i * 4;
+            entry.parentPid = 4;
+            entry.name = QStringLiteral("app%1.exe").arg(i);
+            entry.exePath = QStringLiteral("C:\\Program Files\\Vendor\\") + entry.name;
+            out.append(entry);
+        }
+        return !cancelled.load();
+    }
+};
+
+QByteArray requestFrame(Opcode opcode, quint32 id, const QByteArray& payload = QByteArray()) {
+    QByteArray out;
+    appendFrame(out, static_cast<quint8>(opcode), id, payload);
+    return out;
+}
+
+QByteArray pidPayload(qint64 pid) {
+    QByteArray payload;
+    PayloadWriter writer(payload);
+    writer.writeVarint(1);
+    writer.writeVarint(static_cast<quint64>(pid));
+    return payload;
+}
+
+// 阻塞读取直到收到 count 个完整响应帧，返回最后一帧
+bool readFrames(QLocalSocket& socket, QByteArray& buffer, int count, Frame& last) {
+    int received = 0;
+    qsizetype offset = 0;
+    while (received < count) {
+        ParseResult result;
+        while ((result = takeFrame(buffer, offset, last)) == ParseResult::Frame) {
+            ++received;
+        }
+        if (received >= count) {
+            break;
+        }
+        if (result == ParseResult::Invalid || !socket.waitForReadyRead(5000)) {
+            return false;
+        }
+        buffer.append(socket.readAll());
+    }
+    buffer.remove(0, offset);
+    return true;
+}
+} // namespace
+
+// 控制命令经本地套接字的往返时间：服务端在自己的线程中运行事件循环，客户端阻塞等待响应
+class BenchControlServer : public QObject {
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void ping();
+    void hidePid();
+    void listProcesses();
+    void pipelined_data();
+    void pipelined();
+    void connectPingClose();
+
+private:
+    bool roundTrip(const QByteArray& requests, int count, Frame& last);
+
+    QString m_name;
+    QThread* m_serverThread = nullptr;
+    std::atomic<bool> m_ready{ false };
+    std::atomic<bool> m_stop{ false };
+    QLocalSocket m_socket;
+    QByteArray m_buffer;
+};
+
+void BenchControlServer::initTestCase() {
+    m_name = QStringLiteral("HideWindow.bench.%1").arg(QCoreApplication::applicationPid());
+    // 服务端对象都在服务线程中创建，HideProcess 与 ControlService 要求在同一线程使用
+    m_serverThread = QThread::create([this]() {
+        auto system = std::make_unique<FakeWindowSystem>();
+        system->addWindow(4, "Main");
+        HideProcess hide(std::move(system), QString());
+        ControlService service(&hide, std::make_unique<FixedProcessSource>());
+        ControlServer server(&service);
+        if (!server.listen(m_name)) {
+            return;
+        }
+        QEventLoop loop;
+        QTimer stopTimer;
+        connect(&stopTimer, &QTimer::timeout, &loop, [this, &loop]() {
+            if (m_stop.load()) {
+                loop.quit();
+            }
+        });
+        stopTimer.start(20);
+        m_ready.store(true);
+        loop.exec();
+    });
+    m_serverThread->start();
+    QTRY_VERIFY(m_ready.load());
+    m_socket.connectToServer(m_name);
+    QVERIFY(m_socket.waitForConnected(1000));
+}
+
+void BenchControlServer::cleanupTestCase() {
+    m_socket.disconnectFromServer();
+    m_stop.store(true);
+    m_serverThread->wait();
+    delete m_serverThread;
+}
+
+bool BenchControlServer::roundTrip(const QByteArray& requests, int count, Frame& last) {
+    m_socket.write(requests);
+    m_socket.flush();
+    return readFrames(m_socket, m_buffer, count, last);
+}
+
+void BenchControlServer::ping() {
+    const QByteArray request = requestFrame(Opcode::Ping, 1);
+    Frame response;
+    QBENCHMARK {
+        QVERIFY(roundTrip(request, 1, response));
+    }
+    QCOMPARE(response.code, quint8(Status::Ok));
+}
+
+void BenchControlServer::hidePid() {
+    // 隐藏与显示交替，每次都真正改变一个窗口
+    const QByteArray hide = requestFrame(Opcode::HidePids, 1, pidPayload(4));
+    const QByteArray show = requestFrame(Opcode::ShowPids, 2, pidPayload(4));
+    Frame response;
+    QBENCHMARK {
+        QVERIFY(roundTrip(hide, 1, response));
+        QVERIFY(roundTrip(show, 1, response));
+    }
+    QCOMPARE(response.code, quint8(Status::Ok));
+}
+
+void BenchControlServer::listProcesses() {
+    // 含后台快照线程的启动与 300 个进程的编码
+    QByteArray pattern;
+    PayloadWriter(pattern).writeString(QString());
+    const QByteArray request = requestFrame(Opcode::ListProcesses, 1, pattern);
+    Frame response;
+    QBENCHMARK {
+        QVERIFY(roundTrip(request, 1, response));
+    }
+    QCOMPARE(response.code, quint8(Status::Ok));
+    PayloadReader reader(response.payload);
+    quint64 count = 0;
+    QVERIFY(reader.readVarint(count));
+    QCOMPARE(count, quint64(kProcessCount));
+}
+
+void BenchControlServer::pipelined_data() {
+    QTest::addColumn<int>("count");
+    QTest::newRow("10") << 10;
+    QTest::newRow("100") << 100;
+    QTest::newRow("1000") << 1000;
+}
+
+void BenchControlServer::pipelined() {
+    // 一次写入 count 条请求，等全部响应到达；结果除以 count 即每条命令的开销
+    QFETCH(int, count);
+    QByteArray requests;
+    for (int i = 0; i < count; ++i) {
+        requests += requestFrame(Opcode::Ping, static_cast<quint32>(i));
+    }
+    Frame response;
+    QBENCHMARK {
+        QVERIFY(roundTrip(requests, count, response));
+    }
+    QCOMPARE(response.id, quint32(count - 1));
+}
+
+void BenchControlServer::connectPingClose() {
+    // hidewindow-cli 每次调用的连接开销
+    const QByteArray request = requestFrame(Opcode::Ping, 1);
+    QBENCHMARK {
+        QLocalSocket socket;
+        socket.connectToServer(m_name);
+        QVERIFY(socket.waitForConnected(1000));
+        socket.write(request);
+        socket.flush();
+        QByteArray buffer;
+        Frame response;
+        QVERIFY(readFrames(socket, buffer, 1, response));
+        socket.disconnectFromServer();
+    }
+}
+
+QTEST_GUILESS_MAIN(BenchControlServer)
+#include "bench_controlserver.moc"
@@ -0,0 +1,81 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include "FakeWindowSystem.h"
+#include "HideProcess.h"
+
+namespace {
+constexpr qint64 kProcessCount = 2000;
+constexpr int kWindowsPerProcess = 3;
+// 每次隐藏 / 显示的进程数
+constexpr qint64 kBatchSize = 200;
+} // namespace
+
+// 在 6000 个窗口的模拟桌面上比较一次批量隐藏 200 个进程与逐个进程隐藏的开销
+class BenchHideProcess : public QObject {
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void batchHideShow();
+    void perProcessHideShow();
+    void cleanupTestCase();
+
+private:
+    FakeWindowSystem* m_system = nullptr;
+    std::unique_ptr<HideProcess> m_hide;
+    QSet<qint64> m_batch;
+};
+
+void BenchHideProcess::initTestCase() {
+    auto system = std::make_unique<FakeWindowSystem>();
+    m_system = system.get();
+    for (qint64 pid = 1; pid <= kProcessCount; ++pid) {
+        for (int i = 0; i < kWindowsPerProcess; ++i) {
+            m_system->addWindow(pid, QStringLiteral("Class%1").arg(i));
+        }
+    }
+    m_hide = std::make_unique<HideProcess>(std::move(system), QString());
+    for (qint64 pid = 1; pid <= kProcessCount; pid += kProcessCount / kBatchSize) {
+        m_batch.insert(pid);
+    }
+    QCOMPARE(m_batch.size(), qsizetype(kBatchSize));
+}
+
+void BenchHideProcess::batchHideShow() {
+    int hidden = 0;
+    QBENCHMARK {
+        hidden = m_hide->hidePids(m_batch);
+        m_hide->showPids(m_batch);
+    }
+    QCOMPARE(hidden, int(kBatchSize * kWindowsPerProcess));
+}
+
+void BenchHideProcess::perProcessHideShow() {
+    int hidden = 0;
+    QBENCHMARK {
+        hidden = 0;
+        for (qint64 pid : std::as_const(m_batch)) {
+            hidden += m_hide->hidePids({ pid });
+        }
+        for (qint64 pid : std::as_const(m_batch)) {
+            m_hide->showPids({ pid });
+        }
+    }
+    QCOMPARE(hidden, int(kBatchSize * kWindowsPerProcess));
+}
+
+void BenchHideProcess::cleanupTestCase() {
+    m_hide.reset();
+    m_system = nullptr;
+}
+
+QTEST_GUILESS_MAIN(BenchHideProcess)
+#include "bench_hideprocess.moc"
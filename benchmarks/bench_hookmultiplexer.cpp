@@ -0,0 +1,63 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include "HookMultiplexer.h"
+
+namespace {
+constexpr int kBatch = 10000;
+} // namespace
+
+// deliver() 在钩子回调里执行：订阅者数量与过滤集合对单次分发开销的影响
+class BenchHookMultiplexer : public QObject {
+    Q_OBJECT
+private slots:
+    void deliver_data();
+    void deliver();
+};
+
+void BenchHookMultiplexer::deliver_data() {
+    QTest::addColumn<int>("subscribers");
+    QTest::addColumn<bool>("filtered");
+
+    QTest::newRow("1 all keys") << 1 << false;
+    QTest::newRow("8 all keys") << 8 << false;
+    // 过滤掉的订阅者只花一次位测试
+    QTest::newRow("8 filtered") << 8 << true;
+}
+
+void BenchHookMultiplexer::deliver() {
+    QFETCH(int, subscribers);
+    QFETCH(bool, filtered);
+    HookMultiplexer& hook = HookMultiplexer::instance();
+    int calls = 0;
+    QList<int> ids;
+    for (int i = 0; i < subscribers; ++i) {
+        HookMultiplexer::Subscription subscription;
+        subscription.keys = filtered ? HookMultiplexer::keys({ 0x7B }) : HookMultiplexer::allKeys();
+        subscription.handler = [&calls](const HookEvent&) { ++calls; return false; };
+        ids.append(hook.subscribe(subscription));
+    }
+
+    HookEvent event;
+    QBENCHMARK {
+        for (int i = 0; i < kBatch; ++i) {
+            event.vk = 0x41 + i % 26;
+            hook.deliver(event);
+        }
+    }
+    for (int id : ids) {
+        hook.unsubscribe(id);
+    }
+    QCOMPARE(calls > 0, !filtered);
+}
+
+QTEST_GUILESS_MAIN(BenchHookMultiplexer)
+#include "bench_hookmultiplexer.moc"
@@ -0,0 +1,85 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include "HotkeyMatcher.h"
+
+namespace {
+constexpr int kKeystrokes = 10000;
+
+// Ctrl/Alt/Shift 与字母、F 键的各种组合，外加若干两步组合键
+void addBindings(HotkeyMatcher& matcher) {
+    const std::uint8_t modifierSets[] = {
+        HotkeyModifier::Ctrl | HotkeyModifier::Alt,
+        HotkeyModifier::Ctrl | HotkeyModifier::Shift,
+        HotkeyModifier::Alt | HotkeyModifier::Shift,
+    };
+    for (std::uint8_t modifiers : modifierSets) {
+        for (std::uint8_t vk = 0x41; vk <= 0x5A; ++vk) {
+            matcher.addBinding({ HotkeyStroke{ vk, modifiers } }, true);
+        }
+    }
+    for (std::uint8_t vk = 0x41; vk <= 0x5A; ++vk) {
+        matcher.addBinding({ HotkeyStroke{ 0x4B, HotkeyModifier::Ctrl }, HotkeyStroke{ vk, HotkeyModifier::Ctrl } });
+    }
+}
+} // namespace
+
+// 钩子回调里每个按键都要经过 feed()：普通打字（全部失配）与命中热键两种负载
+class BenchHotkeyMatcher : public QObject {
+    Q_OBJECT
+private slots:
+    void feedTyping();
+    void feedMatching();
+    void compile();
+};
+
+void BenchHotkeyMatcher::feedTyping() {
+    HotkeyMatcher matcher;
+    addBindings(matcher);
+    matcher.compile();
+    int matched = 0;
+    QBENCHMARK {
+        for (int i = 0; i < kKeystrokes; ++i) {
+            const std::uint32_t vk = 0x41 + i % 26;
+            matched += matcher.feed(vk, true, std::uint64_t(i)).bindingId >= 0;
+            matcher.feed(vk, false, std::uint64_t(i));
+        }
+    }
+    QCOMPARE(matched, 0);
+}
+
+void BenchHotkeyMatcher::feedMatching() {
+    HotkeyMatcher matcher;
+    addBindings(matcher);
+    matcher.compile();
+    matcher.feed(KeyMap::Vk::LControl, true, 0);
+    matcher.feed(KeyMap::Vk::LMenu, true, 0);
+    int matched = 0;
+    QBENCHMARK {
+        for (int i = 0; i < kKeystrokes; ++i) {
+            const std::uint32_t vk = 0x41 + i % 26;
+            matched += matcher.feed(vk, true, std::uint64_t(i)).bindingId >= 0;
+            matcher.feed(vk, false, std::uint64_t(i));
+        }
+    }
+    QVERIFY(matched > 0);
+}
+
+void BenchHotkeyMatcher::compile() {
+    HotkeyMatcher matcher;
+    addBindings(matcher);
+    QBENCHMARK {
+        matcher.compile();
+    }
+}
+
+QTEST_APPLESS_MAIN(BenchHotkeyMatcher)
+#include "bench_hotkeymatcher.moc"
@@ -0,0 +1,109 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include <QThread>
+#include <atomic>
+#include "ProcessIconProvider.h"
+
+namespace {
+constexpr int kIconCount = 200;
+constexpr int kRowCount = 2000;
+
+// 模拟 SHGetFileInfo 的开销：每次解码固定耗时
+class SlowIconLoader : public IconLoader {
+public:
+    QImage load(const QString& exePath, const QSize& size) override {
+        Q_UNUSED(exePath);
+        QThread::usleep(200);
+        QImage image(size, QImage::Format_ARGB32);
+        image.fill(0xff808080u);
+        return image;
+    }
+};
+
+// 一屏进程列表：大量进程共用少数几个可执行文件
+QString pathForRow(int row) {
+    return QStringLiteral("C:\\Program Files\\Vendor\\app%1.exe").arg(row % kIconCount);
+}
+} // namespace
+
+// 列表滚动时的图标请求：缓存与同键合并 vs 每行单独解码
+class BenchIconFetcher : public QObject {
+    Q_OBJECT
+private slots:
+    void scrollCold();
+    void scrollWarm();
+    void scrollUncached();
+    void cacheFind();
+};
+
+void BenchIconFetcher::scrollCold() {
+    std::atomic<int> done{ 0 };
+    QBENCHMARK {
+        // 每轮新建，缓存为空，同键请求合并为一次解码
+        IconFetcher fetcher(std::make_unique<SlowIconLoader>(), 4, 8 << 20);
+        for (int row = 0; row < kRowCount; ++row) {
+            fetcher.request(pathForRow(row), QSize(16, 16), [&done](const QImage&) { ++done; });
+        }
+        fetcher.waitForDone();
+    }
+    QVERIFY(done.load() >= kRowCount);
+}
+
+void BenchIconFetcher::scrollWarm() {
+    IconFetcher fetcher(std::make_unique<SlowIconLoader>(), 4, 8 << 20);
+    std::atomic<int> done{ 0 };
+    for (int row = 0; row < kIconCount; ++row) {
+        fetcher.request(pathForRow(row), QSize(16, 16), [&done](const QImage&) { ++done; });
+    }
+    fetcher.waitForDone();
+    QBENCHMARK {
+        for (int row = 0; row < kRowCount; ++row) {
+            fetcher.request(pathForRow(row), QSize(16, 16), [&done](const QImage&) { ++done; });
+        }
+    }
+    QCOMPARE(fetcher.stats().loads, quint64(kIconCount));
+}
+
+void BenchIconFetcher::scrollUncached() {
+    // 对照：预算为 0 且逐行等待，相当于每行在界面线程同步解码
+    std::atomic<int> done{ 0 };
+    QBENCHMARK {
+        IconFetcher fetcher(std::make_unique<SlowIconLoader>(), 4, 0);
+        for (int row = 0; row < kRowCount; ++row) {
+            fetcher.request(pathForRow(row), QSize(16, 16), [&done](const QImage&) { ++done; });
+            fetcher.waitForDone();
+        }
+    }
+    QVERIFY(done.load() >= kRowCount);
+}
+
+void BenchIconFetcher::cacheFind() {
+    IconCache cache(8 << 20);
+    QImage image(16, 16, QImage::Format_ARGB32);
+    image.fill(0xff808080u);
+    QStringList keys;
+    for (int i = 0; i < kIconCount; ++i) {
+        keys.append(pathForRow(i) + QStringLiteral("|16x16"));
+        cache.insert(keys.last(), image);
+    }
+    int hits = 0;
+    QImage found;
+    QBENCHMARK {
+        for (int row = 0; row < kRowCount; ++row) {
+            hits += cache.find(keys.at(row % kIconCount), found);
+        }
+    }
+    QVERIFY(hits > 0);
+}
+
+QTEST_GUILESS_MAIN(BenchIconFetcher)
+#include "bench_iconfetcher.moc"
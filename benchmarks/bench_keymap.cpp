@@ -0,0 +1,129 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include <QMap>
+#include <iterator>
+#include "KeyMap.h"
+
+namespace {
+constexpr int kKeystrokes = 10000;
+
+bool isCharVk(int vk) {
+    return (vk >= 0x30 && vk <= 0x39) || (vk >= 0x41 && vk <= 0x5A);
+}
+
+// 原 GlobalHook.h 的两张表：功能键（含鼠标按键与 NULL 兜底项）与字母/数字键
+struct LegacyTables {
+    QMap<quint32, Qt::Key> vkToQtKey;
+    QMap<quint32, Qt::Key> charVkToQtKey;
+
+    LegacyTables() {
+        vkToQtKey.insert(0, Qt::Key_unknown);
+        for (quint32 vk : { KeyMap::Vk::LButton, KeyMap::Vk::RButton, KeyMap::Vk::MButton, KeyMap::Vk::XButton1,
+                 KeyMap::Vk::XButton2 }) {
+            vkToQtKey.insert(vk, Qt::Key_unknown);
+        }
+        for (int vk = 0; vk < 256; ++vk) {
+            const Qt::Key key = KeyMap::qtKeyFromVk(vk);
+            if (key != Qt::Key_unknown) {
+                (isCharVk(vk) ? charVkToQtKey : vkToQtKey).insert(vk, key);
+            }
+        }
+    }
+
+    // 原 getQtKeyFromVK：先查功能键，再查字符键，每张表 contains + operator[] 两次查找
+    Qt::Key lookup(quint32 vkCode) const {
+        if (vkToQtKey.contains(vkCode)) {
+            return vkToQtKey[vkCode];
+        }
+        if (charVkToQtKey.contains(vkCode)) {
+            return charVkToQtKey[vkCode];
+        }
+        return Qt::Key_unknown;
+    }
+};
+
+// 打字负载：以字母为主，夹杂数字、空格、回车与修饰键
+std::vector<quint32> typingStream() {
+    static const quint32 kExtras[] = { KeyMap::Vk::Space, KeyMap::Vk::Return, KeyMap::Vk::LShift,
+        KeyMap::Vk::Back, KeyMap::Vk::Digit0 + 7, KeyMap::Vk::F1 + 4 };
+    std::vector<quint32> stream;
+    stream.reserve(kKeystrokes);
+    for (int i = 0; i < kKeystrokes; ++i) {
+        stream.push_back(i % 5 == 4 ? kExtras[(i / 5) % std::size(kExtras)] : 0x41 + (i * 7) % 26);
+    }
+    return stream;
+}
+} // namespace
+
+// 键盘钩子回调中每个按键一次 VK -> Qt::Key 转换：编译期数组与原先的两张 QMap 对比
+class BenchKeyMap : public QObject {
+    Q_OBJECT
+private slots:
+    void qtKeyFromVk_data();
+    void qtKeyFromVk();
+    void vkFromQtKey();
+};
+
+void BenchKeyMap::qtKeyFromVk_data() {
+    QTest::addColumn<bool>("legacy");
+
+    QTest::newRow("constexpr") << false;
+    QTest::newRow("qmap") << true;
+}
+
+void BenchKeyMap::qtKeyFromVk() {
+    QFETCH(bool, legacy);
+    const LegacyTables tables;
+    const std::vector<quint32> stream = typingStream();
+    int mapped = 0;
+    if (legacy) {
+        QBENCHMARK {
+            for (quint32 vk : stream) {
+                mapped += tables.lookup(vk) != Qt::Key_unknown;
+            }
+        }
+    }
+    else {
+        QBENCHMARK {
+            for (quint32 vk : stream) {
+                mapped += KeyMap::qtKeyFromVk(vk) != Qt::Key_unknown;
+            }
+        }
+    }
+    QVERIFY(mapped > 0);
+
+    // 两条路径结果一致
+    for (int vk = 0; vk < 256; ++vk) {
+        QCOMPARE(tables.lookup(vk), KeyMap::qtKeyFromVk(vk));
+    }
+}
+
+void BenchKeyMap::vkFromQtKey() {
+    // 配置阶段的反向查找（二分），逐个查询所有已映射的键
+    QList<Qt::Key> keys;
+    for (int vk = 0; vk < 256; ++vk) {
+        const Qt::Key key = KeyMap::qtKeyFromVk(vk);
+        if (key != Qt::Key_unknown) {
+            keys.append(key);
+        }
+    }
+    int found = 0;
+    QBENCHMARK {
+        for (Qt::Key key : std::as_const(keys)) {
+            found += KeyMap::vkFromQtKey(key) != 0;
+        }
+    }
+    QVERIFY(found > 0);
+}
+
+QTEST_APPLESS_MAIN(BenchKeyMap)
+#include "bench_keymap.moc"
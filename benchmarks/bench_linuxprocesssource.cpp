@@ -0,0 +1,101 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include <atomic>
+#include "ProcessSource.h"
+
+namespace {
+constexpr int kProcessCount = 10000;
+} // namespace
+
+// /proc 快照的开销。测试机上通常只有几十到几百个进程，按 PID 逐个读取的部分把在运行的进程
+// 重复到 1 万个，结果即每 1 万个进程的开销（目标：1 万个进程的完整快照低于 20 ms）
+class BenchLinuxProcessSource : public QObject {
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void snapshotLive();
+    void listPidsLive();
+    void query10k();
+    void queryExited10k();
+    void parseStat10k();
+
+private:
+    std::vector<qint64> m_livePids;
+};
+
+void BenchLinuxProcessSource::initTestCase() {
+    LinuxProcessSource source;
+    QVERIFY(source.listPids(m_livePids));
+    QVERIFY(!m_livePids.empty());
+}
+
+void BenchLinuxProcessSource::snapshotLive() {
+    LinuxProcessSource source;
+    QList<ProcessEntry> entries;
+    std::atomic<bool> cancelled{ false };
+    QBENCHMARK {
+        QVERIFY(source.snapshot(entries, cancelled));
+    }
+    QVERIFY(!entries.isEmpty());
+}
+
+void BenchLinuxProcessSource::listPidsLive() {
+    LinuxProcessSource source;
+    std::vector<qint64> pids;
+    QBENCHMARK {
+        QVERIFY(source.listPids(pids));
+    }
+    QVERIFY(!pids.empty());
+}
+
+void BenchLinuxProcessSource::query10k() {
+    // 与 snapshot 对每个 PID 目录做的工作相同：读取 stat 并解析，再读取 exe 链接
+    LinuxProcessSource source;
+    ProcessEntry entry;
+    int found = 0;
+    QBENCHMARK {
+        for (int i = 0; i < kProcessCount; ++i) {
+            found += source.query(m_livePids[static_cast<std::size_t>(i) % m_livePids.size()], entry);
+        }
+    }
+    QVERIFY(found > 0);
+}
+
+void BenchLinuxProcessSource::queryExited10k() {
+    // 列出目录后进程已退出：openat 失败的路径
+    LinuxProcessSource source;
+    ProcessEntry entry;
+    int found = 0;
+    QBENCHMARK {
+        for (int i = 0; i < kProcessCount; ++i) {
+            found += source.query(0x40000000 + i, entry);
+        }
+    }
+    QCOMPARE(found, 0);
+}
+
+void BenchLinuxProcessSource::parseStat10k() {
+    const QByteArray stat = "4242 (Web Content) S 1000 4242 4242 0 -1 4194560 100 0 0 0 5 3 0 0 20 0 1 0 "
+                            "987654321 12345678 300 18446744073709551615 1 1 0 0 0 0 0 0 0 0 0 0 17 3 0 0\n";
+    ProcessEntry entry;
+    quint64 checksum = 0;
+    QBENCHMARK {
+        for (int i = 0; i < kProcessCount; ++i) {
+            LinuxProcfs::parseStat(stat.constData(), entry);
+            checksum += entry.startTime;
+        }
+    }
+    QVERIFY(checksum > 0);
+}
+
+QTEST_GUILESS_MAIN(BenchLinuxProcessSource)
+#include "bench_linuxprocesssource.moc"
@@ -0,0 +1,95 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include <QThread>
+#include "Metrics.h"
+
+namespace {
+constexpr int kBatch = 100000;
+constexpr int kThreads = 4;
+} // namespace
+
+// 记录路径常开：单次 record()/add() 的开销，以及多线程同时记录时分片的效果
+class BenchMetrics : public QObject {
+    Q_OBJECT
+private slots:
+    void record();
+    void recordConcurrent();
+    void counterAdd();
+    void scopedTimer();
+    void snapshot();
+};
+
+void BenchMetrics::record() {
+    Metrics::LatencyHistogram histogram("bench");
+    QBENCHMARK {
+        for (int i = 0; i < kBatch; ++i) {
+            histogram.record(quint64(i) * 37);
+        }
+    }
+}
+
+void BenchMetrics::recordConcurrent() {
+    Metrics::LatencyHistogram histogram("bench");
+    QBENCHMARK {
+        QList<QThread*> threads;
+        for (int t = 0; t < kThreads; ++t) {
+            threads.append(QThread::create([&histogram]() {
+                for (int i = 0; i < kBatch; ++i) {
+                    histogram.record(quint64(i) * 37);
+                }
+            }));
+        }
+        for (QThread* thread : threads) {
+            thread->start();
+        }
+        for (QThread* thread : threads) {
+            thread->wait();
+        }
+        qDeleteAll(threads);
+    }
+}
+
+void BenchMetrics::counterAdd() {
+    Metrics::Counter counter("bench");
+    QBENCHMARK {
+        for (int i = 0; i < kBatch; ++i) {
+            counter.add();
+        }
+    }
+    QVERIFY(counter.value() > 0);
+}
+
+void BenchMetrics::scopedTimer() {
+    // 包含两次读取单调时钟
+    Metrics::LatencyHistogram histogram("bench");
+    QBENCHMARK {
+        for (int i = 0; i < kBatch; ++i) {
+            Metrics::ScopedTimer timer(histogram);
+        }
+    }
+}
+
+void BenchMetrics::snapshot() {
+    // 界面每秒刷新一次时合并全部分片的开销
+    Metrics::LatencyHistogram histogram("bench");
+    for (int i = 0; i < kBatch; ++i) {
+        histogram.record(quint64(i) * 37);
+    }
+    quint64 p99 = 0;
+    QBENCHMARK {
+        p99 = histogram.snapshot().percentile(0.99);
+    }
+    QVERIFY(p99 > 0);
+}
+
+QTEST_GUILESS_MAIN(BenchMetrics)
+#include "bench_metrics.moc"
@@ -0,0 +1,131 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include <algorithm>
+#include "ProcessEventSource.h"
+#include "ProcessListModel.h"
+
+namespace {
+constexpr int kRowCount = 10000;
+
+ProcessEntry makeEntry(qint64 pid) {
+    ProcessEntry entry;
+    entry.pid = pid;
+    entry.parentPid = 1;
+    entry.startTime = static_cast<quint64>(pid) * 7;
+    entry.name = QStringLiteral("process-%1.exe").arg(pid);
+    entry.exePath = QStringLiteral("C:/Program Files/Vendor/") + entry.name;
+    return entry;
+}
+
+// 偶数 PID 组成初始列表，批次中的新进程取奇数 PID，分散插入到整个列表
+QList<ProcessEntry> baseline() {
+    QList<ProcessEntry> entries;
+    entries.reserve(kRowCount);
+    for (int i = 0; i < kRowCount; ++i) {
+        entries.append(makeEntry(2 * i));
+    }
+    return entries;
+}
+
+void makeQuiet(ProcessListModel& model) {
+    model.setLiveUpdates(false);
+    model.setStatsInterval(0);
+}
+} // namespace
+
+// 一批进程启动 / 退出：逐行合并事件与重新应用完整快照（校准路径）的开销对比
+class BenchProcessEvents : public QObject {
+    Q_OBJECT
+private slots:
+    void applyEvents_data();
+    void applyEvents();
+    void applySnapshot_data();
+    void applySnapshot();
+    void queueForkStorm();
+};
+
+void BenchProcessEvents::applyEvents_data() {
+    QTest::addColumn<int>("batch");
+    QTest::newRow("1 event") << 1;
+    QTest::newRow("50 events") << 50;
+    QTest::newRow("1000 events") << 1000;
+}
+
+void BenchProcessEvents::applyEvents() {
+    QFETCH(int, batch);
+    const QList<ProcessEntry> entries = baseline();
+    // 一半启动、一半退出，应用后行数不变，每轮都从同样规模的列表开始
+    QList<ProcessEvent> forward;
+    QList<ProcessEvent> backward;
+    for (int i = 0; i < batch; ++i) {
+        const qint64 pid = 2 * qint64(i) * (kRowCount / qMax(batch, 1)) + 1;
+        ProcessEvent started;
+        started.kind = ProcessEvent::Started;
+        started.entry = makeEntry(pid);
+        ProcessEvent exited;
+        exited.kind = ProcessEvent::Exited;
+        exited.entry.pid = pid;
+        forward.append(started);
+        backward.append(exited);
+    }
+    ProcessListModel model;
+    makeQuiet(model);
+    model.applySnapshot(entries);
+    QBENCHMARK {
+        model.applyEvents(forward);
+        model.applyEvents(backward);
+    }
+    QCOMPARE(model.rowCount(), kRowCount);
+}
+
+void BenchProcessEvents::applySnapshot_data() {
+    applyEvents_data();
+}
+
+void BenchProcessEvents::applySnapshot() {
+    // 同样的变化改由完整快照差分得到
+    QFETCH(int, batch);
+    const QList<ProcessEntry> entries = baseline();
+    QList<ProcessEntry> changed = entries;
+    for (int i = 0; i < batch; ++i) {
+        const qint64 pid = 2 * qint64(i) * (kRowCount / qMax(batch, 1)) + 1;
+        changed.append(makeEntry(pid));
+    }
+    std::sort(changed.begin(), changed.end(), [](const ProcessEntry& a, const ProcessEntry& b) { return a.pid < b.pid; });
+    ProcessListModel model;
+    makeQuiet(model);
+    model.applySnapshot(entries);
+    QBENCHMARK {
+        model.applySnapshot(changed);
+        model.applySnapshot(entries);
+    }
+    QCOMPARE(model.rowCount(), kRowCount);
+}
+
+void BenchProcessEvents::queueForkStorm() {
+    // 事件线程入队、GUI 线程一次取走的开销
+    FakeProcessEventSource source;
+    int notified = 0;
+    source.start([&notified]() { ++notified; });
+    QList<ProcessEvent> events;
+    QBENCHMARK {
+        source.forkStorm(100000, 5000, 1, QStringLiteral("C:/Windows/System32/conhost.exe"));
+        events.clear();
+        source.takeEvents(events);
+    }
+    QCOMPARE(events.size(), qsizetype(5000));
+    QVERIFY(notified > 0);
+    source.stop();
+}
+
+QTEST_GUILESS_MAIN(BenchProcessEvents)
+#include "bench_processevents.moc"
@@ -0,0 +1,130 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include "ProcessFilterModel.h"
+#include "ProcessListModel.h"
+
+namespace {
+constexpr int kRowCount = 50000;
+
+QList<ProcessEntry> makeEntries() {
+    static const QStringList vendors = {
+        QStringLiteral("Google/Chrome"), QStringLiteral("Microsoft VS Code"), QStringLiteral("Mozilla Firefox"),
+        QStringLiteral("JetBrains/CLion"), QStringLiteral("Windows/System32"), QStringLiteral("Steam/steamapps"),
+    };
+    QList<ProcessEntry> entries;
+    entries.reserve(kRowCount);
+    for (int i = 0; i < kRowCount; ++i) {
+        ProcessEntry entry;
+        entry.pid = 100 + i;
+        entry.parentPid = 1;
+        entry.startTime = static_cast<quint64>(i) * 7;
+        entry.name = QStringLiteral("process-%1.exe").arg(i);
+        entry.exePath = QStringLiteral("C:/Program Files/%1/").arg(vendors.at(i % vendors.size())) + entry.name;
+        entries.append(entry);
+    }
+    return entries;
+}
+} // namespace
+
+// 在 5 万行的进程列表上逐字输入查询（目标：每次按键低于 1 ms）：索引过滤与逐行子串比较的开销对比
+class BenchProcessFilter : public QObject {
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void typeQuery_data();
+    void typeQuery();
+    void naiveScan_data();
+    void naiveScan();
+    void rebuildIndex();
+
+private:
+    ProcessListModel m_source;
+};
+
+void BenchProcessFilter::initTestCase() {
+    m_source.setLiveUpdates(false);
+    m_source.setStatsInterval(0);
+    m_source.applySnapshot(makeEntries());
+    QCOMPARE(m_source.rowCount(), kRowCount);
+}
+
+void BenchProcessFilter::typeQuery_data() {
+    QTest::addColumn<QString>("query");
+    QTest::addColumn<int>("expected");
+    QTest::newRow("common") << QStringLiteral("program files") << kRowCount;
+    QTest::newRow("selective") << QStringLiteral("process-4242.exe") << 1;
+    QTest::newRow("two terms") << QStringLiteral("firefox process-1238.exe") << 1;
+    QTest::newRow("no match") << QStringLiteral("notepad") << 0;
+}
+
+void BenchProcessFilter::typeQuery() {
+    QFETCH(QString, query);
+    QFETCH(int, expected);
+    ProcessFilterModel filter;
+    filter.setSourceModel(&m_source);
+    int matched = 0;
+    QBENCHMARK {
+        // 每个前缀都是一次 setFilterText，最后清空回到完整列表
+        for (qsizetype length = 1; length <= query.size(); ++length) {
+            filter.setFilterText(query.left(length));
+        }
+        matched = filter.count();
+        filter.setFilterText(QString());
+    }
+    QCOMPARE(matched, expected);
+}
+
+void BenchProcessFilter::naiveScan_data() {
+    typeQuery_data();
+}
+
+void BenchProcessFilter::naiveScan() {
+    // 对照：每个前缀都对所有行的名称与路径做不区分大小写的子串比较
+    QFETCH(QString, query);
+    QFETCH(int, expected);
+    QStringList names;
+    QStringList paths;
+    for (int row = 0; row < m_source.rowCount(); ++row) {
+        names.append(m_source.data(m_source.index(row), ProcessListModel::NameRole).toString());
+        paths.append(m_source.data(m_source.index(row), ProcessListModel::FileRole).toString());
+    }
+    int matched = 0;
+    QBENCHMARK {
+        for (qsizetype length = 1; length <= query.size(); ++length) {
+            const QStringList terms = query.left(length).split(QLatin1Char(' '), Qt::SkipEmptyParts);
+            matched = 0;
+            for (int row = 0; row < names.size(); ++row) {
+                bool all = true;
+                for (const QString& term : terms) {
+                    if (!names.at(row).contains(term, Qt::CaseInsensitive) && !paths.at(row).contains(term, Qt::CaseInsensitive)) {
+                        all = false;
+                        break;
+                    }
+                }
+                matched += all;
+            }
+        }
+    }
+    QCOMPARE(matched, expected);
+}
+
+void BenchProcessFilter::rebuildIndex() {
+    // 设置源模型时为全部行建索引
+    ProcessFilterModel filter;
+    QBENCHMARK {
+        filter.setSourceModel(&m_source);
+    }
+    QCOMPARE(filter.count(), kRowCount);
+}
+
+QTEST_GUILESS_MAIN(BenchProcessFilter)
+#include "bench_processfilter.moc"
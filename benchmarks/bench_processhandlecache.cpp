@@ -0,0 +1,107 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include <atomic>
+#include "ProcessHandleCache.h"
+#include "ProcessSource.h"
+
+namespace {
+std::vector<ProcessKey> liveKeys() {
+    QList<ProcessEntry> entries;
+    std::atomic<bool> cancelled{ false };
+    createDefaultProcessSource()->snapshot(entries, cancelled);
+    std::vector<ProcessKey> keys;
+    for (const ProcessEntry& entry : std::as_const(entries)) {
+        keys.push_back(entry.key());
+    }
+    return keys;
+}
+} // namespace
+
+// 按需打开句柄的开销：缓存命中、每次重新打开与一次性访问
+class BenchProcessHandleCache : public QObject {
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void residentHandles_data();
+    void residentHandles();
+    void acquireCached();
+    void openEveryTime();
+    void acquireTransient();
+
+private:
+    std::vector<ProcessKey> m_keys;
+};
+
+void BenchProcessHandleCache::initTestCase() {
+    m_keys = liveKeys();
+    QVERIFY(!m_keys.empty());
+}
+
+void BenchProcessHandleCache::residentHandles_data() {
+    QTest::addColumn<bool>("transient");
+    QTest::newRow("cached") << false;
+    QTest::newRow("transient") << true;
+}
+
+void BenchProcessHandleCache::residentHandles() {
+    // 一次完整快照之后仍保持打开的句柄数：逐个缓存时即为可打开的进程数（旧实现在两次刷新之间常驻的句柄），
+    // 一次性访问时应为 0
+    QFETCH(bool, transient);
+    ProcessHandleCache cache;
+    int opened = 0;
+    for (const ProcessKey& key : m_keys) {
+        opened += (transient ? cache.acquireTransient(key.pid, key.startTime) : cache.acquire(key)) != nullptr;
+    }
+    QVERIFY(opened > 0);
+    QCOMPARE(cache.stats().open, transient ? 0 : qMin(opened, ProcessHandleCache::kDefaultCapacity));
+    QTest::setBenchmarkResult(cache.stats().open, QTest::Events);
+}
+
+void BenchProcessHandleCache::acquireCached() {
+    ProcessHandleCache cache;
+    for (const ProcessKey& key : m_keys) {
+        cache.acquire(key);
+    }
+    int acquired = 0;
+    QBENCHMARK {
+        for (const ProcessKey& key : m_keys) {
+            acquired += cache.acquire(key) != nullptr;
+        }
+    }
+    QVERIFY(acquired > 0);
+}
+
+void BenchProcessHandleCache::openEveryTime() {
+    // 对照：hideProcess / 采样每次重新打开并校验创建时间
+    int acquired = 0;
+    QBENCHMARK {
+        for (const ProcessKey& key : m_keys) {
+            acquired += ProcessHandle::open(key.pid, key.startTime) != nullptr;
+        }
+    }
+    QVERIFY(acquired > 0);
+}
+
+void BenchProcessHandleCache::acquireTransient() {
+    ProcessHandleCache cache;
+    int acquired = 0;
+    QBENCHMARK {
+        for (const ProcessKey& key : m_keys) {
+            acquired += cache.acquireTransient(key.pid, key.startTime) != nullptr;
+        }
+    }
+    QVERIFY(acquired > 0);
+    QCOMPARE(cache.stats().open, 0);
+}
+
+QTEST_APPLESS_MAIN(BenchProcessHandleCache)
+#include "bench_processhandlecache.moc"
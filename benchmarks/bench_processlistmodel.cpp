@@ -0,0 +1,194 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include <array>
+#include <atomic>
+#include "ProcessListModel.h"
+
+namespace {
+constexpr int kRowCount = 10000;
+// 一屏可见的行数：滚动时委托每次绘制这么多行
+constexpr int kVisibleRows = 40;
+
+// 统计调用次数的快照提供者；data() 路径上任何一次调用都说明绘制时仍在访问系统
+class CountingProcessSource : public ProcessSource {
+public:
+    bool snapshot(QList<ProcessEntry>& out, const std::atomic<bool>& cancelled) override {
+        Q_UNUSED(cancelled);
+        ++calls;
+        out.clear();
+        return true;
+    }
+    bool query(qint64 pid, ProcessEntry& entry) override {
+        Q_UNUSED(pid);
+        Q_UNUSED(entry);
+        ++calls;
+        return false;
+    }
+
+    std::atomic<int> calls{ 0 };
+};
+} // namespace
+
+// 模拟在 1 万行的进程列表中从头滚动到尾，比较逐角色 data()、一次 multiData() 与逐次查询系统的旧路径
+class BenchProcessListModel : public QObject {
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void scrollData();
+    void scrollMultiData();
+    void scrollQueryPerCall();
+    void applySnapshotDiff_data();
+    void applySnapshotDiff();
+    void cleanupTestCase();
+
+private:
+    ProcessListModel* m_model = nullptr;
+    CountingProcessSource* m_source = nullptr;
+};
+
+void BenchProcessListModel::initTestCase() {
+    m_model = new ProcessListModel(this);
+    m_model->setLiveUpdates(false);
+    m_model->setStatsInterval(0);
+    auto source = std::make_unique<CountingProcessSource>();
+    m_source = source.get();
+    m_model->setProcessSource(std::move(source));
+
+    QList<ProcessEntry> entries;
+    entries.reserve(kRowCount);
+    for (int i = 0; i < kRowCount; ++i) {
+        ProcessEntry entry;
+        entry.pid = 100 + i;
+        entry.parentPid = 1;
+        entry.startTime = static_cast<quint64>(i) * 7;
+        entry.name = QStringLiteral("process-%1.exe").arg(i);
+        entry.exePath = QStringLiteral("C:/Program Files/Vendor/") + entry.name;
+        entries.append(entry);
+    }
+    m_model->applySnapshot(entries);
+    QCOMPARE(m_model->rowCount(), kRowCount);
+}
+
+void BenchProcessListModel::scrollData() {
+    qint64 checksum = 0;
+    QBENCHMARK {
+        for (int top = 0; top + kVisibleRows <= kRowCount; top += kVisibleRows) {
+            for (int row = top; row < top + kVisibleRows; ++row) {
+                const QModelIndex index = m_model->index(row);
+                checksum += m_model->data(index, ProcessListModel::NameRole).toString().size();
+                checksum += m_model->data(index, ProcessListModel::PidRole).toLongLong();
+                checksum += m_model->data(index, ProcessListModel::FileRole).toString().size();
+            }
+        }
+    }
+    QVERIFY(checksum > 0);
+    QCOMPARE(m_source->calls.load(), 0);
+}
+
+void BenchProcessListModel::scrollMultiData() {
+    qint64 checksum = 0;
+    QBENCHMARK {
+        for (int row = 0; row < kRowCount; ++row) {
+            std::array<QModelRoleData, 3> roles = { {
+                QModelRoleData(ProcessListModel::NameRole),
+                QModelRoleData(ProcessListModel::PidRole),
+                QModelRoleData(ProcessListModel::FileRole),
+            } };
+            m_model->multiData(m_model->index(row), roles);
+            checksum += roles[0].data().toString().size() + roles[1].data().toLongLong();
+        }
+    }
+    QVERIFY(checksum > 0);
+    QCOMPARE(m_source->calls.load(), 0);
+}
+
+// 基线：缓存元数据之前 data() 每读一次名称或路径就查询一次系统（Windows 上是 OpenProcess +
+// GetModuleFileNameExW）。这里用当前平台的提供者逐次 query 在运行的进程，进程不够时循环复用
+void BenchProcessListModel::scrollQueryPerCall() {
+    std::unique_ptr<ProcessSource> source = createDefaultProcessSource();
+    std::vector<qint64> livePids;
+    if (!source->listPids(livePids) || livePids.empty()) {
+        QSKIP("No process source for this platform");
+    }
+    qint64 checksum = 0;
+    ProcessEntry entry;
+    QBENCHMARK {
+        for (int top = 0; top + kVisibleRows <= kRowCount; top += kVisibleRows) {
+            for (int row = top; row < top + kVisibleRows; ++row) {
+                const qint64 pid = livePids[static_cast<std::size_t>(row) % livePids.size()];
+                // NameRole 与 FileRole 各查询一次，PidRole 不需要查询
+                if (source->query(pid, entry)) {
+                    checksum += entry.name.size();
+                }
+                checksum += pid;
+                if (source->query(pid, entry)) {
+                    checksum += entry.exePath.size();
+                }
+            }
+        }
+    }
+    QVERIFY(checksum > 0);
+}
+
+void BenchProcessListModel::applySnapshotDiff_data() {
+    QTest::addColumn<bool>("incremental");
+    QTest::newRow("diff") << true;
+    QTest::newRow("reset") << false;
+}
+
+// 两份 1 万行快照交替应用：每次约 1% 的进程退出、1% 新启动、1% 改名，其余不变
+void BenchProcessListModel::applySnapshotDiff() {
+    QFETCH(bool, incremental);
+    std::array<QList<ProcessEntry>, 2> snapshots;
+    for (int i = 0; i < kRowCount; ++i) {
+        ProcessEntry entry;
+        entry.pid = 100 + i * 2;
+        entry.parentPid = 1;
+        entry.startTime = static_cast<quint64>(i) * 7;
+        entry.name = QStringLiteral("process-%1.exe").arg(i);
+        entry.exePath = QStringLiteral("C:/Program Files/Vendor/") + entry.name;
+        snapshots[0].append(entry);
+        if (i % 100 == 0) {
+            continue; // 退出
+        }
+        if (i % 100 == 50) {
+            entry.name += QStringLiteral(" (renamed)");
+        }
+        snapshots[1].append(entry);
+        if (i % 100 == 25) {
+            entry.pid += 1; // 新启动，插在相邻 PID 之间
+            entry.name = QStringLiteral("started-%1.exe").arg(i);
+            snapshots[1].append(entry);
+        }
+    }
+
+    ProcessListModel model;
+    model.setLiveUpdates(false);
+    model.setStatsInterval(0);
+    model.setIncrementalRefresh(incremental);
+    model.applySnapshot(snapshots[0]);
+    int next = 1;
+    QBENCHMARK {
+        model.applySnapshot(snapshots[next]);
+        next ^= 1;
+    }
+    QCOMPARE(model.rowCount(), snapshots[next ^ 1].count());
+}
+
+void BenchProcessListModel::cleanupTestCase() {
+    delete m_model;
+    m_model = nullptr;
+    m_source = nullptr;
+}
+
+QTEST_GUILESS_MAIN(BenchProcessListModel)
+#include "bench_processlistmodel.moc"
@@ -0,0 +1,117 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include <atomic>
+#include "ProcessStats.h"
+#include "ProcessSource.h"
+#include "ProcessTable.h"
+
+namespace {
+constexpr int kKeyCount = 10000;
+
+std::vector<ProcessKey> syntheticKeys() {
+    std::vector<ProcessKey> keys;
+    keys.reserve(kKeyCount);
+    for (int i = 0; i < kKeyCount; ++i) {
+        keys.push_back({ 4 * (i + 1), static_cast<std::uint64_t>(i) * 7 });
+    }
+    return keys;
+}
+} // namespace
+
+// 每次采样的开销：系统读取（采样线程）与差值计算、写回表格（界面线程）
+class BenchProcessStats : public QObject {
+    Q_OBJECT
+private slots:
+    void sampleLiveProcesses();
+    void sampleExitedProcesses();
+    void samplerUpdate();
+    void applyToTable();
+};
+
+void BenchProcessStats::sampleLiveProcesses() {
+    // 当前系统中的进程重复到 1 万个键，结果即每 1 万个进程一次采样的开销
+    QList<ProcessEntry> entries;
+    std::atomic<bool> cancelled{ false };
+    QVERIFY(createDefaultProcessSource()->snapshot(entries, cancelled));
+    QVERIFY(!entries.isEmpty());
+    std::vector<ProcessKey> keys;
+    keys.reserve(kKeyCount);
+    for (int i = 0; i < kKeyCount; ++i) {
+        keys.push_back(entries.at(i % entries.size()).key());
+    }
+
+    std::unique_ptr<ProcessStatsSource> source = createDefaultProcessStatsSource();
+    std::vector<ProcessCounters> out;
+    QBENCHMARK {
+        source->sample(keys, out);
+    }
+    QCOMPARE(out.size(), keys.size());
+}
+
+void BenchProcessStats::sampleExitedProcesses() {
+    // 采样期间大量进程已退出：打开失败的路径同样计入每次采样的开销
+    const std::vector<ProcessKey> keys = syntheticKeys();
+    std::vector<ProcessKey> missing;
+    for (const ProcessKey& key : keys) {
+        missing.push_back({ 0x40000000 + key.pid, key.startTime });
+    }
+    std::unique_ptr<ProcessStatsSource> source = createDefaultProcessStatsSource();
+    std::vector<ProcessCounters> out;
+    QBENCHMARK {
+        source->sample(missing, out);
+    }
+    QCOMPARE(out.size(), std::size_t(kKeyCount));
+}
+
+void BenchProcessStats::samplerUpdate() {
+    const std::vector<ProcessKey> keys = syntheticKeys();
+    std::vector<ProcessCounters> counters(keys.size());
+    for (std::size_t i = 0; i < counters.size(); ++i) {
+        counters[i].valid = true;
+        counters[i].workingSet = 1 << 20;
+    }
+    ProcessStatsSampler sampler(8);
+    std::vector<quint16> cpu;
+    quint64 timestamp = 1;
+    QBENCHMARK {
+        for (std::size_t i = 0; i < counters.size(); i += 20) {
+            counters[i].cpuTime += 1000000; // 5% 的进程有 CPU 活动
+        }
+        timestamp += 2000000000ull;
+        sampler.update(keys, counters, timestamp, cpu);
+    }
+    QCOMPARE(cpu.size(), keys.size());
+}
+
+void BenchProcessStats::applyToTable() {
+    ProcessTable table;
+    for (const ProcessKey& key : syntheticKeys()) {
+        ProcessEntry entry;
+        entry.pid = key.pid;
+        entry.startTime = key.startTime;
+        entry.name = QStringLiteral("app.exe");
+        table.append(entry);
+    }
+    quint16 cpu = 0;
+    int changed = 0;
+    QBENCHMARK {
+        ++cpu;
+        for (int row = 0; row < table.count(); ++row) {
+            // 与模型写回相同：每 20 行有一行数值变化
+            changed += table.setStats(row, row % 20 == 0 ? cpu : 0, 1 << 20);
+        }
+    }
+    QVERIFY(changed > 0);
+}
+
+QTEST_APPLESS_MAIN(BenchProcessStats)
+#include "bench_processstats.moc"
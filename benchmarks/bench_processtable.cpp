@@ -0,0 +1,188 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include "ProcessTable.h"
+
+namespace {
+// 大量进程共用少数可执行文件（浏览器、svchost 等），名称与路径高度重复
+QList<ProcessEntry> makeEntries(int rowCount) {
+    QList<ProcessEntry> entries;
+    entries.reserve(rowCount);
+    for (int i = 0; i < rowCount; ++i) {
+        ProcessEntry entry;
+        entry.pid = 4 * (i + 1);
+        entry.parentPid = 4;
+        entry.startTime = static_cast<quint64>(i) * 7;
+        entry.name = QStringLiteral("app%1.exe").arg(i % 200);
+        entry.exePath = QStringLiteral("C:\\Program Files\\Vendor %1\\").arg(i % 50) + entry.name;
+        entries.append(entry);
+    }
+    return entries;
+}
+
+ProcessTable makeTable(const QList<ProcessEntry>& entries) {
+    ProcessTable table;
+    for (const ProcessEntry& entry : entries) {
+        table.append(entry);
+    }
+    return table;
+}
+} // namespace
+
+// 按列存储、字符串驻留的进程表与 QList<ProcessEntry> 的对比，分别在 1k、10k、100k 行上测量
+class BenchProcessTable : public QObject {
+    Q_OBJECT
+private slots:
+    void bytesPerRow_data();
+    void bytesPerRow();
+    void appendTable_data();
+    void appendTable();
+    void appendList_data();
+    void appendList();
+    void readStrings_data();
+    void readStrings();
+    void scanKeysTable_data();
+    void scanKeysTable();
+    void scanKeysList_data();
+    void scanKeysList();
+    void compareContent_data();
+    void compareContent();
+};
+
+void BenchProcessTable::bytesPerRow_data() {
+    QTest::addColumn<int>("rowCount");
+    QTest::newRow("1k") << 1000;
+    QTest::newRow("10k") << 10000;
+    QTest::newRow("100k") << 100000;
+}
+
+void BenchProcessTable::bytesPerRow() {
+    // 各列与字符池按容量计的字节数，平均到每一行
+    QFETCH(int, rowCount);
+    const ProcessTable table = makeTable(makeEntries(rowCount));
+    QCOMPARE(table.count(), rowCount);
+    QTest::setBenchmarkResult(static_cast<qreal>(table.memoryUsage()) / rowCount, QTest::BytesAllocated);
+}
+
+void BenchProcessTable::appendTable_data() {
+    bytesPerRow_data();
+}
+
+void BenchProcessTable::appendTable() {
+    // 一次完整刷新：由快照重建整张表
+    QFETCH(int, rowCount);
+    const QList<ProcessEntry> entries = makeEntries(rowCount);
+    ProcessTable table;
+    QBENCHMARK {
+        table.clear();
+        table.reserve(rowCount);
+        for (const ProcessEntry& entry : entries) {
+            table.append(entry);
+        }
+    }
+    QCOMPARE(table.count(), rowCount);
+}
+
+void BenchProcessTable::appendList_data() {
+    bytesPerRow_data();
+}
+
+void BenchProcessTable::appendList() {
+    // 对照：深拷贝每一行的字符串（快照来自系统时字符串总是新分配的）
+    QFETCH(int, rowCount);
+    const QList<ProcessEntry> entries = makeEntries(rowCount);
+    QList<ProcessEntry> list;
+    QBENCHMARK {
+        list.clear();
+        list.reserve(rowCount);
+        for (const ProcessEntry& entry : entries) {
+            ProcessEntry copy = entry;
+            copy.name = QString(entry.name.constData(), entry.name.size());
+            copy.exePath = QString(entry.exePath.constData(), entry.exePath.size());
+            list.append(copy);
+        }
+    }
+    QCOMPARE(list.size(), qsizetype(rowCount));
+}
+
+void BenchProcessTable::readStrings_data() {
+    bytesPerRow_data();
+}
+
+void BenchProcessTable::readStrings() {
+    // 视图滚动时 data() 逐行读取名称与路径：交出的是共享副本，不分配内存
+    QFETCH(int, rowCount);
+    const ProcessTable table = makeTable(makeEntries(rowCount));
+    qsizetype length = 0;
+    QBENCHMARK {
+        for (int row = 0; row < table.count(); ++row) {
+            length += table.name(row).size() + table.exePath(row).size();
+        }
+    }
+    QVERIFY(length > 0);
+}
+
+void BenchProcessTable::scanKeysTable_data() {
+    bytesPerRow_data();
+}
+
+void BenchProcessTable::scanKeysTable() {
+    // 差分与采样只读取键列，列存储时连续访问
+    QFETCH(int, rowCount);
+    const ProcessTable table = makeTable(makeEntries(rowCount));
+    quint64 checksum = 0;
+    QBENCHMARK {
+        for (int row = 0; row < table.count(); ++row) {
+            const ProcessKey key = table.key(row);
+            checksum += static_cast<quint64>(key.pid) ^ key.startTime;
+        }
+    }
+    QVERIFY(checksum > 0);
+}
+
+void BenchProcessTable::scanKeysList_data() {
+    bytesPerRow_data();
+}
+
+void BenchProcessTable::scanKeysList() {
+    QFETCH(int, rowCount);
+    const QList<ProcessEntry> entries = makeEntries(rowCount);
+    quint64 checksum = 0;
+    QBENCHMARK {
+        for (const ProcessEntry& entry : entries) {
+            const ProcessKey key = entry.key();
+            checksum += static_cast<quint64>(key.pid) ^ key.startTime;
+        }
+    }
+    QVERIFY(checksum > 0);
+}
+
+void BenchProcessTable::compareContent_data() {
+    bytesPerRow_data();
+}
+
+void BenchProcessTable::compareContent() {
+    // 校准时逐行比较内容，不构造临时字符串
+    QFETCH(int, rowCount);
+    const QList<ProcessEntry> entries = makeEntries(rowCount);
+    const ProcessTable table = makeTable(entries);
+    int same = 0;
+    QBENCHMARK {
+        same = 0;
+        for (int row = 0; row < table.count(); ++row) {
+            same += table.sameContent(row, entries.at(row));
+        }
+    }
+    QCOMPARE(same, rowCount);
+}
+
+QTEST_APPLESS_MAIN(BenchProcessTable)
+#include "bench_processtable.moc"
@@ -0,0 +1,98 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include <QRandomGenerator>
+#include "ProcessListModel.h"
+#include "ProcessTree.h"
+#include "ProcessTreeModel.h"
+
+namespace {
+// 随机森林：每个进程的父进程是较早的某个进程，少数父进程已退出
+QList<ProcessEntry> makeEntries(int count) {
+    QRandomGenerator random(20260322);
+    QList<ProcessEntry> entries;
+    entries.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        ProcessEntry entry;
+        entry.pid = 4 * (i + 1);
+        entry.parentPid = i == 0 || random.bounded(50) == 0 ? 999999 : 4 * (random.bounded(i) + 1);
+        entry.startTime = static_cast<quint64>(i + 1);
+        entry.name = QStringLiteral("process-%1").arg(i);
+        entries.append(entry);
+    }
+    return entries;
+}
+} // namespace
+
+// 快照校准与进程增删后都要重建整棵树
+class BenchProcessTree : public QObject {
+    Q_OBJECT
+private slots:
+    void build_data();
+    void build();
+    void modelRebuild_data();
+    void modelRebuild();
+    void subtreePids();
+};
+
+void BenchProcessTree::build_data() {
+    QTest::addColumn<int>("count");
+    QTest::newRow("1k") << 1000;
+    QTest::newRow("10k") << 10000;
+    QTest::newRow("100k") << 100000;
+}
+
+void BenchProcessTree::build() {
+    QFETCH(int, count);
+    const QList<ProcessEntry> entries = makeEntries(count);
+    ProcessTree tree;
+    QBENCHMARK {
+        tree.build(entries);
+    }
+    QCOMPARE(tree.count(), count);
+}
+
+void BenchProcessTree::modelRebuild_data() {
+    QTest::addColumn<int>("count");
+    QTest::newRow("1k") << 1000;
+    QTest::newRow("10k") << 10000;
+}
+
+void BenchProcessTree::modelRebuild() {
+    // 包括经 multiData 从源模型读取 PID 信息的开销
+    QFETCH(int, count);
+    ProcessListModel source;
+    source.setLiveUpdates(false);
+    source.setStatsInterval(0);
+    source.applySnapshot(makeEntries(count));
+    ProcessTreeModel tree;
+    QBENCHMARK {
+        tree.setSourceModel(&source);
+    }
+    QCOMPARE(tree.tree().count(), count);
+}
+
+void BenchProcessTree::subtreePids() {
+    ProcessListModel source;
+    source.setLiveUpdates(false);
+    source.setStatsInterval(0);
+    source.applySnapshot(makeEntries(10000));
+    ProcessTreeModel tree;
+    tree.setSourceModel(&source);
+    qsizetype total = 0;
+    QBENCHMARK {
+        total = tree.subtreePids(4).size();
+    }
+    QVERIFY(total > 1);
+}
+
+QTEST_GUILESS_MAIN(BenchProcessTree)
+#include "bench_processtree.moc"
@@ -0,0 +1,147 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include "RuleEngine.h"
+
+namespace {
+constexpr int kEvents = 100000;
+
+struct Subject {
+    QString exeName;
+    QString exePath;
+    QString className;
+    QString title;
+};
+
+std::vector<Subject> makeSubjects() {
+    std::vector<Subject> subjects;
+    for (int i = 0; i < kEvents; ++i) {
+        Subject s;
+        s.exeName = QStringLiteral("app%1.exe").arg(i);
+        s.exePath = QStringLiteral("C:\\Program Files\\Vendor %1\\").arg(i % 37) + s.exeName;
+        s.className = QStringLiteral("WindowClass_%1").arg(i % 53);
+        s.title = QStringLiteral("Document %1 - Editor").arg(i);
+        subjects.push_back(s);
+    }
+    return subjects;
+}
+
+// 各种编译形式混合的规则集，几乎都不命中（事件路径上的典型情况）
+QStringList makeRules(int count) {
+    QStringList rules;
+    for (int i = 0; i < count; ++i) {
+        switch (i % 5) {
+        case 0: rules.append(QStringLiteral("exe:tool%1.exe").arg(i)); break;
+        case 1: rules.append(QStringLiteral("exe:*helper%1*").arg(i)); break;
+        case 2: rules.append(QStringLiteral("path:D:\\Games\\%1\\*").arg(i)); break;
+        case 3: rules.append(QStringLiteral("class:Chrome_WidgetWin_%1 && title:*Stream%1*").arg(i)); break;
+        case 4: rules.append(QStringLiteral("title:*Secret?%1*.txt").arg(i)); break;
+        }
+    }
+    return rules;
+}
+
+RuleSubject toRuleSubject(const Subject& s) {
+    RuleSubject subject;
+    subject.exeName = s.exeName;
+    subject.exePath = s.exePath;
+    subject.className = s.className;
+    subject.title = s.title;
+    return subject;
+}
+} // namespace
+
+// 每个新窗口都要对全部规则做一次匹配：10 万个窗口事件，对比自动机与逐条通配符匹配
+class BenchRuleEngine : public QObject {
+    Q_OBJECT
+private slots:
+    void match_data();
+    void match();
+    void naiveGlob_data();
+    void naiveGlob();
+    void compile();
+};
+
+void BenchRuleEngine::match_data() {
+    QTest::addColumn<int>("ruleCount");
+    QTest::newRow("10 rules") << 10;
+    QTest::newRow("100 rules") << 100;
+    QTest::newRow("1000 rules") << 1000;
+}
+
+void BenchRuleEngine::match() {
+    QFETCH(int, ruleCount);
+    RuleEngine engine;
+    for (const QString& rule : makeRules(ruleCount)) {
+        engine.addRule(rule);
+    }
+    engine.compile();
+    const std::vector<Subject> subjects = makeSubjects();
+    int matched = 0;
+    QBENCHMARK {
+        for (const Subject& s : subjects) {
+            matched += engine.match(toRuleSubject(s)) >= 0;
+        }
+    }
+    QCOMPARE(matched, 0);
+}
+
+void BenchRuleEngine::naiveGlob_data() {
+    match_data();
+}
+
+void BenchRuleEngine::naiveGlob() {
+    // 对照：每个窗口逐条规则、逐个条件做通配符匹配
+    QFETCH(int, ruleCount);
+    std::vector<HideRule> rules;
+    for (const QString& text : makeRules(ruleCount)) {
+        HideRule rule;
+        HideRule::parse(text, rule);
+        rules.push_back(rule);
+    }
+    const std::vector<Subject> subjects = makeSubjects();
+    int matched = 0;
+    QBENCHMARK {
+        for (const Subject& s : subjects) {
+            const RuleSubject subject = toRuleSubject(s);
+            for (const HideRule& rule : rules) {
+                bool all = true;
+                for (const RuleCondition& condition : rule.conditions) {
+                    const quint32 options = condition.field == RuleField::ExePath
+                        ? (AhoCorasick::CaseInsensitive | AhoCorasick::UnifySeparators)
+                        : AhoCorasick::CaseInsensitive;
+                    if (!RuleEngine::globMatch(condition.pattern, subject.field(condition.field), options)) {
+                        all = false;
+                        break;
+                    }
+                }
+                if (all) {
+                    ++matched;
+                    break;
+                }
+            }
+        }
+    }
+    QCOMPARE(matched, 0);
+}
+
+void BenchRuleEngine::compile() {
+    RuleEngine engine;
+    for (const QString& rule : makeRules(1000)) {
+        engine.addRule(rule);
+    }
+    QBENCHMARK {
+        engine.compile();
+    }
+}
+
+QTEST_APPLESS_MAIN(BenchRuleEngine)
+#include "bench_ruleengine.moc"
@@ -0,0 +1,100 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include <QThread>
+#include "HookEventDispatcher.h"
+#include "SpscRing.h"
+
+namespace {
+constexpr int kBatch = 10000;
+} // namespace
+
+// 钩子回调路径上的开销：单次入队 / 出队，以及跨线程交给分发线程的吞吐
+class BenchSpscRing : public QObject {
+    Q_OBJECT
+private slots:
+    void pushPop();
+    void pushDropOldestWhenFull();
+    void crossThreadHandOff();
+    void dispatcherPost();
+};
+
+void BenchSpscRing::pushPop() {
+    SpscRing<HookEvent> ring(1024);
+    HookEvent event;
+    QBENCHMARK {
+        for (int i = 0; i < kBatch; ++i) {
+            event.vk = static_cast<quint32>(i);
+            ring.push(event);
+            ring.pop(event);
+        }
+    }
+}
+
+void BenchSpscRing::pushDropOldestWhenFull() {
+    SpscRing<HookEvent> ring(64);
+    ring.setOverflowPolicy(SpscRing<HookEvent>::OverflowPolicy::DropOldest);
+    HookEvent event;
+    // 队列一直是满的：每次入队都要先挤出最旧的元素
+    QBENCHMARK {
+        for (int i = 0; i < kBatch; ++i) {
+            event.vk = static_cast<quint32>(i);
+            ring.push(event);
+        }
+    }
+    QVERIFY(ring.droppedCount() > 0);
+}
+
+void BenchSpscRing::crossThreadHandOff() {
+    SpscRing<HookEvent> ring(1024);
+    QBENCHMARK {
+        QThread* consumer = QThread::create([&ring]() {
+            HookEvent event;
+            int received = 0;
+            while (received < kBatch) {
+                if (ring.pop(event)) {
+                    ++received;
+                }
+                else {
+                    QThread::yieldCurrentThread();
+                }
+            }
+        });
+        consumer->start();
+        HookEvent event;
+        for (int i = 0; i < kBatch; ++i) {
+            event.vk = static_cast<quint32>(i);
+            while (!ring.push(event)) {
+                QThread::yieldCurrentThread();
+            }
+        }
+        consumer->wait();
+        delete consumer;
+    }
+}
+
+void BenchSpscRing::dispatcherPost() {
+    // 只测生产者一侧：post() 是钩子回调里唯一的开销
+    HookEventDispatcher dispatcher(kBatch * 2);
+    dispatcher.start();
+    HookEvent event;
+    QBENCHMARK {
+        for (int i = 0; i < kBatch; ++i) {
+            event.vk = static_cast<quint32>(i);
+            event.timestamp = HookEventDispatcher::now();
+            dispatcher.post(event);
+        }
+    }
+    dispatcher.stop();
+}
+
+QTEST_GUILESS_MAIN(BenchSpscRing)
+#include "bench_spscring.moc"
@@ -0,0 +1,63 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include <QBuffer>
+#include "Trace.h"
+
+namespace {
+constexpr int kBatch = 100000;
+} // namespace
+
+// 追踪点留在热路径上：运行时关闭时的代价应只有一次分支
+class BenchTrace : public QObject {
+    Q_OBJECT
+private slots:
+    void scopeDisabled();
+    void scopeEnabled();
+    void writeJson();
+};
+
+void BenchTrace::scopeDisabled() {
+    Trace::setEnabled(false);
+    QBENCHMARK {
+        for (int i = 0; i < kBatch; ++i) {
+            HW_TRACE_SCOPE("bench", "disabled");
+        }
+    }
+}
+
+void BenchTrace::scopeEnabled() {
+    Trace::setEnabled(true);
+    QBENCHMARK {
+        for (int i = 0; i < kBatch; ++i) {
+            HW_TRACE_SCOPE("bench", "enabled");
+        }
+    }
+    Trace::setEnabled(false);
+}
+
+void BenchTrace::writeJson() {
+    // 默认容量的缓冲区写满后导出一次
+    Trace::clear();
+    Trace::setEnabled(true);
+    for (int i = 0; i < kBatch; ++i) {
+        HW_TRACE_INSTANT("bench", "instant");
+    }
+    Trace::setEnabled(false);
+    QBENCHMARK {
+        QBuffer buffer;
+        buffer.open(QIODevice::WriteOnly);
+        QVERIFY(Trace::writeJson(buffer));
+    }
+}
+
+QTEST_GUILESS_MAIN(BenchTrace)
+#include "bench_trace.moc"
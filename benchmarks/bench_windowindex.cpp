@@ -0,0 +1,92 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include "FakeWindowSystem.h"
+#include "WindowIndex.h"
+
+namespace {
+constexpr qint64 kProcessCount = 2000;
+constexpr int kWindowsPerProcess = 4;
+} // namespace
+
+// 模拟有 8000 个顶层窗口的桌面：比较按 PID 查表与逐窗口遍历（旧的 FindWindowEx 路径）的开销
+class BenchWindowIndex : public QObject {
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void lookupByPid();
+    void scanAllWindows();
+    void rebuild();
+    void finishRebuild();
+
+private:
+    FakeWindowSystem m_system;
+    std::unique_ptr<WindowIndex> m_index;
+};
+
+void BenchWindowIndex::initTestCase() {
+    for (qint64 pid = 1; pid <= kProcessCount; ++pid) {
+        for (int i = 0; i < kWindowsPerProcess; ++i) {
+            m_system.addWindow(pid * 4, QStringLiteral("Class%1").arg(i), QStringLiteral("Window %1").arg(pid), i == 0);
+        }
+    }
+    m_index = std::make_unique<WindowIndex>(&m_system);
+    m_index->rebuild();
+    QCOMPARE(m_index->size(), size_t(kProcessCount * kWindowsPerProcess));
+}
+
+void BenchWindowIndex::lookupByPid() {
+    qint64 pid = 4;
+    int found = 0;
+    QBENCHMARK {
+        m_index->forEachWindowOf(pid, [&](const WindowInfo&) { ++found; });
+        pid = pid % (kProcessCount * 4) + 4;
+    }
+    QVERIFY(found > 0);
+}
+
+void BenchWindowIndex::scanAllWindows() {
+    qint64 pid = 4;
+    int found = 0;
+    std::vector<WindowInfo> windows;
+    QBENCHMARK {
+        windows.clear();
+        m_system.enumerateTopLevelWindows(windows);
+        for (const WindowInfo& window : windows) {
+            found += window.pid == pid;
+        }
+        pid = pid % (kProcessCount * 4) + 4;
+    }
+    QVERIFY(found > 0);
+}
+
+void BenchWindowIndex::rebuild() {
+    QBENCHMARK {
+        m_index->rebuild();
+    }
+    QCOMPARE(m_index->size(), size_t(kProcessCount * kWindowsPerProcess));
+}
+
+// 后台建立索引时留在界面线程的部分：遍历结果已取得，只合并进索引（含复制遍历结果的开销）
+void BenchWindowIndex::finishRebuild() {
+    std::vector<WindowInfo> snapshot;
+    m_system.enumerateTopLevelWindows(snapshot);
+    std::vector<WindowInfo> windows;
+    QBENCHMARK {
+        windows = snapshot;
+        m_index->beginRebuild();
+        m_index->finishRebuild(windows);
+    }
+    QCOMPARE(m_index->size(), size_t(kProcessCount * kWindowsPerProcess));
+}
+
+QTEST_GUILESS_MAIN(BenchWindowIndex)
+#include "bench_windowindex.moc"
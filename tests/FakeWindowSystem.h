@@ -0,0 +1,205 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+#ifndef FAKEWINDOWSYSTEM_H
+#define FAKEWINDOWSYSTEM_H
+// 测试用的模拟桌面：窗口全部保存在内存中，并统计对窗口系统的每一次调用
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <map>
+#include <vector>
+#include "WindowSystem.h"
+
+class FakeWindowSystem : public WindowSystem {
+public:
+    struct Calls {
+        int enumerate = 0;
+        int query = 0;
+        int setVisible = 0;    // 逐个窗口的 setWindowVisible
+        int batchVisible = 0;  // setWindowsVisible 的调用次数
+        int placement = 0;
+        int restorePlacement = 0;
+    };
+
+    // 添加一个顶层窗口并返回其标识；emitEvent 为 true 时像真实桌面一样通知事件接收者
+    WindowId addWindow(qint64 pid, const QString& className, const QString& title = QString(),
+                       bool visible = true, bool emitEvent = false) {
+        WindowInfo info;
+        info.id = m_nextId++;
+        info.pid = pid;
+        info.className = className;
+        info.title = title;
+        info.visible = visible;
+        m_windows[info.id] = info;
+        if (emitEvent && m_handler) {
+            m_handler->windowCreated(info.id);
+        }
+        return info.id;
+    }
+
+    void destroyWindow(WindowId id, bool emitEvent = true) {
+        m_windows.erase(id);
+        if (emitEvent && m_handler) {
+            m_handler->windowDestroyed(id);
+        }
+    }
+
+    // 由进程自身改变可见性（例如程序主动显示窗口）
+    void showWindowExternally(WindowId id, bool visible, bool emitEvent = true) {
+        auto it = m_windows.find(id);
+        if (it == m_windows.end()) {
+            return;
+        }
+        it->second.visible = visible;
+        if (emitEvent && m_handler) {
+            m_handler->windowVisibilityChanged(id, visible);
+        }
+    }
+
+    void setTitle(WindowId id, const QString& title, bool emitEvent = true) {
+        auto it = m_windows.find(id);
+        if (it == m_windows.end()) {
+            return;
+        }
+        it->second.title = title;
+        if (emitEvent && m_handler) {
+            m_handler->windowTitleChanged(id);
+        }
+    }
+
+    // 无响应的窗口：隐藏请求被忽略，窗口保持可见
+    void setStubborn(WindowId id, bool stubborn = true) {
+        if (stubborn) {
+            m_stubborn.insert(id);
+        }
+        else {
+            m_stubborn.remove(id);
+        }
+    }
+
+    // 为 true 时修改可见性会同步发出可见性事件（真实桌面上 WinEvent 可能在提交期间重入）
+    void setEmitVisibilityEvents(bool enabled) { m_emitVisibilityEvents = enabled; }
+
+    void setProcessImagePath(qint64 pid, const QString& path) { m_imagePaths.insert(pid, path); }
+
+    bool isVisible(WindowId id) const {
+        auto it = m_windows.find(id);
+        return it != m_windows.end() && it->second.visible;
+    }
+    bool contains(WindowId id) const { return m_windows.count(id) != 0; }
+    size_t windowCount() const { return m_windows.size(); }
+    WindowEventHandler* eventHandler() const { return m_handler; }
+    const Calls& calls() const { return m_calls; }
+    void resetCalls() { m_calls = Calls(); }
+
+    // WindowSystem
+    void enumerateTopLevelWindows(std::vector<WindowInfo>& out) override {
+        ++m_calls.enumerate;
+        out.reserve(out.size() + m_windows.size());
+        for (const auto& window : m_windows) {
+            out.push_back(window.second);
+        }
+    }
+
+    bool queryWindow(WindowId id, WindowInfo& info) override {
+        ++m_calls.query;
+        auto it = m_windows.find(id);
+        if (it == m_windows.end()) {
+            return false;
+        }
+        info = it->second;
+        return true;
+    }
+
+    void setWindowVisible(WindowId id, bool visible) override {
+        ++m_calls.setVisible;
+        applyVisible(id, visible);
+    }
+
+    void setWindowsVisible(const std::vector<WindowId>& ids, bool visible) override {
+        ++m_calls.batchVisible;
+        for (WindowId id : ids) {
+            applyVisible(id, visible);
+        }
+    }
+
+    bool windowPlacement(WindowId id, WindowPlacement& placement) override {
+        ++m_calls.placement;
+        auto it = m_windows.find(id);
+        if (it == m_windows.end()) {
+            return false;
+        }
+        placement = m_placements[id];
+        return true;
+    }
+
+    bool restoreWindowPlacement(WindowId id, const WindowPlacement& placement) override {
+        ++m_calls.restorePlacement;
+        if (m_windows.count(id) == 0) {
+            return false;
+        }
+        m_placements[id] = placement;
+        applyVisible(id, true);
+        return true;
+    }
+
+    void setEventHandler(WindowEventHandler* handler) override { m_handler = handler; }
+
+    QString processImagePath(qint64 pid) override { return m_imagePaths.value(pid); }
+
+private:
+    void applyVisible(WindowId id, bool visible) {
+        auto it = m_windows.find(id);
+        if (it == m_windows.end() || (!visible && m_stubborn.contains(id))) {
+            return;
+        }
+        const bool changed = it->second.visible != visible;
+        it->second.visible = visible;
+        if (changed && m_emitVisibilityEvents && m_handler) {
+            m_handler->windowVisibilityChanged(id, visible);
+        }
+    }
+
+    std::map<WindowId, WindowInfo> m_windows;
+    std::map<WindowId, WindowPlacement> m_placements;
+    QSet<WindowId> m_stubborn;
+    QHash<qint64, QString> m_imagePaths;
+    WindowEventHandler* m_handler = nullptr;
+    WindowId m_nextId = 0x1000;
+    bool m_emitVisibilityEvents = false;
+    Calls m_calls;
+};
+
+// 把所有调用转发给测试持有的 FakeWindowSystem：交给 HideProcess 等持有者之后，
+// 持有者销毁时桌面仍然存在，可以检查析构时的还原结果
+class FakeWindowSystemRef : public WindowSystem {
+public:
+    explicit FakeWindowSystemRef(FakeWindowSystem* target)
+        : m_target(target)
+    {
+    }
+
+    void enumerateTopLevelWindows(std::vector<WindowInfo>& out) override { m_target->enumerateTopLevelWindows(out); }
+    bool queryWindow(WindowId id, WindowInfo& info) override { return m_target->queryWindow(id, info); }
+    void setWindowVisible(WindowId id, bool visible) override { m_target->setWindowVisible(id, visible); }
+    void setWindowsVisible(const std::vector<WindowId>& ids, bool visible) override { m_target->setWindowsVisible(ids, visible); }
+    bool windowPlacement(WindowId id, WindowPlacement& placement) override { return m_target->windowPlacement(id, placement); }
+    bool restoreWindowPlacement(WindowId id, const WindowPlacement& placement) override {
+        return m_target->restoreWindowPlacement(id, placement);
+    }
+    void setEventHandler(WindowEventHandler* handler) override { m_target->setEventHandler(handler); }
+    QString processImagePath(qint64 pid) override { return m_target->processImagePath(pid); }
+
+private:
+    FakeWindowSystem* m_target;
+};
+#endif
@@ -0,0 +1,182 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include <QRandomGenerator>
+#include <algorithm>
+#include <utility>
+#include "AhoCorasick.h"
+
+namespace {
+using Hit = std::pair<int, int>; // (模式编号, 结束下标)
+
+std::vector<Hit> scanAll(const AhoCorasick& automaton, QStringView text) {
+    std::vector<Hit> hits;
+    automaton.scan(text, [&](int id, int end) {
+        hits.emplace_back(id, end);
+        return true;
+    });
+    std::sort(hits.begin(), hits.end());
+    return hits;
+}
+
+// 对照实现：逐个模式逐个位置比较
+std::vector<Hit> naiveScan(const QStringList& patterns, const QString& text, Qt::CaseSensitivity cs) {
+    std::vector<Hit> hits;
+    for (int id = 0; id < patterns.size(); ++id) {
+        for (qsizetype from = text.indexOf(patterns[id], 0, cs); from >= 0; from = text.indexOf(patterns[id], from + 1, cs)) {
+            hits.emplace_back(id, static_cast<int>(from + patterns[id].size()));
+        }
+    }
+    std::sort(hits.begin(), hits.end());
+    return hits;
+}
+
+QString randomString(QRandomGenerator& random, int minLength, int maxLength) {
+    const int length = random.bounded(minLength, maxLength + 1);
+    QString text;
+    for (int i = 0; i < length; ++i) {
+        // 小字母表让重叠与公共前后缀大量出现
+        text.append(QChar(u"abAB"[random.bounded(4)]));
+    }
+    return text;
+}
+} // namespace
+
+class TestAhoCorasick : public QObject {
+    Q_OBJECT
+private slots:
+    void overlappingMatches();
+    void duplicatePatterns();
+    void caseSensitivity();
+    void unifySeparators();
+    void nonAsciiFolding();
+    void stopScanning();
+    void unbuiltAndCleared();
+    void matchesNaiveScan();
+};
+
+void TestAhoCorasick::overlappingMatches() {
+    AhoCorasick automaton;
+    const int he = automaton.addPattern(u"he");
+    const int she = automaton.addPattern(u"she");
+    const int his = automaton.addPattern(u"his");
+    const int hers = automaton.addPattern(u"hers");
+    automaton.build();
+    QCOMPARE(automaton.patternCount(), 4);
+    QCOMPARE(automaton.patternLength(hers), 4);
+
+    // 经典例子：后缀链接上的所有输出都要报告
+    std::vector<Hit> expected{ { he, 4 }, { she, 4 }, { hers, 6 } };
+    std::sort(expected.begin(), expected.end());
+    QCOMPARE(scanAll(automaton, u"ushers"), expected);
+    QCOMPARE(scanAll(automaton, u"this"), std::vector<Hit>{ Hit(his, 4) });
+    QVERIFY(scanAll(automaton, u"xyz").empty());
+    QVERIFY(scanAll(automaton, u"").empty());
+}
+
+void TestAhoCorasick::duplicatePatterns() {
+    AhoCorasick automaton;
+    const int first = automaton.addPattern(u"Slack");
+    QCOMPARE(automaton.addPattern(u"slack"), first); // 折叠后相同
+    QCOMPARE(automaton.addPattern(u"SLACK"), first);
+    QCOMPARE(automaton.addPattern(u""), -1);
+    QCOMPARE(automaton.patternCount(), 1);
+}
+
+void TestAhoCorasick::caseSensitivity() {
+    AhoCorasick insensitive;
+    QCOMPARE(insensitive.options(), quint32(AhoCorasick::CaseInsensitive));
+    insensitive.addPattern(u"Chrome");
+    insensitive.build();
+    QCOMPARE(scanAll(insensitive, u"google CHROME").size(), size_t(1));
+
+    AhoCorasick sensitive(0);
+    const int lower = sensitive.addPattern(u"chrome");
+    const int upper = sensitive.addPattern(u"Chrome");
+    QVERIFY(lower != upper);
+    sensitive.build();
+    QCOMPARE(scanAll(sensitive, u"Chrome"), std::vector<Hit>{ Hit(upper, 6) });
+    QVERIFY(scanAll(sensitive, u"CHROME").empty());
+}
+
+void TestAhoCorasick::unifySeparators() {
+    AhoCorasick automaton(AhoCorasick::CaseInsensitive | AhoCorasick::UnifySeparators);
+    const int id = automaton.addPattern(u"c:/games\\");
+    automaton.build();
+    QCOMPARE(automaton.fold(u'/'), u'\\');
+    QCOMPARE(scanAll(automaton, u"C:\\Games\\x.exe"), std::vector<Hit>{ Hit(id, 9) });
+    QCOMPARE(scanAll(automaton, u"c:/games/x.exe"), std::vector<Hit>{ Hit(id, 9) });
+
+    // 不统一分隔符时二者不同
+    QCOMPARE(AhoCorasick::fold(u'/', AhoCorasick::CaseInsensitive), u'/');
+}
+
+void TestAhoCorasick::nonAsciiFolding() {
+    AhoCorasick automaton;
+    const int id = automaton.addPattern(u"Écran");
+    automaton.build();
+    QCOMPARE(scanAll(automaton, u"ÉCRAN de veille"), std::vector<Hit>{ Hit(id, 5) });
+    QCOMPARE(scanAll(automaton, u"écran"), std::vector<Hit>{ Hit(id, 5) });
+    // 模式中没有出现的字符落在字符类 0，不影响匹配
+    QCOMPARE(scanAll(automaton, u"视频écran"), std::vector<Hit>{ Hit(id, 7) });
+}
+
+void TestAhoCorasick::stopScanning() {
+    AhoCorasick automaton;
+    automaton.addPattern(u"a");
+    automaton.build();
+    int calls = 0;
+    automaton.scan(u"aaaa", [&](int, int) { return ++calls < 2; });
+    QCOMPARE(calls, 2);
+}
+
+void TestAhoCorasick::unbuiltAndCleared() {
+    AhoCorasick automaton;
+    automaton.addPattern(u"abc");
+    // 编译前扫描不报告任何结果
+    QVERIFY(scanAll(automaton, u"abc").empty());
+    automaton.build();
+    QCOMPARE(scanAll(automaton, u"abc").size(), size_t(1));
+    QVERIFY(automaton.stateCount() >= 4);
+
+    automaton.clear();
+    QCOMPARE(automaton.patternCount(), 0);
+    QVERIFY(scanAll(automaton, u"abc").empty());
+    automaton.build();
+    QVERIFY(scanAll(automaton, u"abc").empty());
+    const int id = automaton.addPattern(u"bc");
+    automaton.build();
+    QCOMPARE(scanAll(automaton, u"abc"), std::vector<Hit>{ Hit(id, 3) });
+}
+
+void TestAhoCorasick::matchesNaiveScan() {
+    QRandomGenerator random(20260317);
+    for (int round = 0; round < 200; ++round) {
+        const bool caseInsensitive = round % 2 == 0;
+        AhoCorasick automaton(caseInsensitive ? AhoCorasick::CaseInsensitive : 0);
+        QStringList patterns;
+        const int count = random.bounded(1, 12);
+        for (int i = 0; i < count; ++i) {
+            const QString pattern = randomString(random, 1, 5);
+            const int id = automaton.addPattern(pattern);
+            if (id == patterns.size()) {
+                patterns.append(pattern);
+            }
+        }
+        automaton.build();
+        const QString text = randomString(random, 0, 60);
+        QCOMPARE(scanAll(automaton, text),
+            naiveScan(patterns, text, caseInsensitive ? Qt::CaseInsensitive : Qt::CaseSensitive));
+    }
+}
+
+QTEST_APPLESS_MAIN(TestAhoCorasick)
+#include "tst_ahocorasick.moc"
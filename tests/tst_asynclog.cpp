@@ -0,0 +1,226 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include <QMutex>
+#include <QThread>
+#include "AsyncLog.h"
+
+namespace {
+// 分类必须具有静态存储期
+AsyncLog::Category s_testLog("test");
+AsyncLog::Category s_otherLog("other");
+AsyncLog::Category s_limitedLog("limited", 3);
+
+struct Line {
+    QtMsgType type;
+    QString category;
+    QString text;
+};
+
+QMutex g_linesMutex;
+QList<Line> g_lines;
+
+void captureMessage(QtMsgType type, const QMessageLogContext& context, const QString& message) {
+    QMutexLocker locker(&g_linesMutex);
+    g_lines.append({ type, QString::fromUtf8(context.category), message });
+}
+
+QList<Line> takeLines() {
+    QMutexLocker locker(&g_linesMutex);
+    QList<Line> lines;
+    lines.swap(g_lines);
+    return lines;
+}
+
+qsizetype lineCount() {
+    QMutexLocker locker(&g_linesMutex);
+    return g_lines.size();
+}
+
+QStringList texts(const QList<Line>& lines) {
+    QStringList result;
+    for (const Line& line : lines) {
+        result.append(line.text);
+    }
+    return result;
+}
+
+AsyncLog::Record record(const char* format) {
+    AsyncLog::Record result;
+    result.format = format;
+    return result;
+}
+} // namespace
+
+class TestAsyncLog : public QObject {
+    Q_OBJECT
+private slots:
+    void init();
+    void cleanup();
+    void formatArguments();
+    void formatText();
+    void flushKeepsLevelsAndCategories();
+    void flushMergesThreadsByTimestamp();
+    void rateLimit();
+    void queueFullIsReported();
+    void backgroundThread();
+
+private:
+    QtMessageHandler m_previousHandler = nullptr;
+};
+
+void TestAsyncLog::init() {
+    AsyncLog::flush();
+    m_previousHandler = qInstallMessageHandler(captureMessage);
+    takeLines();
+}
+
+void TestAsyncLog::cleanup() {
+    AsyncLog::stop();
+    qInstallMessageHandler(m_previousHandler);
+}
+
+void TestAsyncLog::formatArguments() {
+    AsyncLog::Record r = record("a=%1 b=%2 c=%3 d=%4 e=%5 100%");
+    AsyncLog::detail::encodeAll(r, -5, 7u, 1.5, "static");
+    QCOMPARE(r.argCount, quint8(4));
+    QCOMPARE(AsyncLog::format(r), QStringLiteral("a=-5 b=7 c=1.5 d=static e=%5 100%"));
+
+    // 参数可以重复引用或乱序引用，缺少的参数输出为空
+    r = record("%2/%1/%2/%3");
+    AsyncLog::detail::encodeAll(r, true, reinterpret_cast<void*>(quintptr(0xbeef)));
+    QCOMPARE(AsyncLog::format(r), QStringLiteral("0xbeef/1/0xbeef/"));
+
+    enum class Color : quint8 { Red = 2 };
+    r = record("%1 %2");
+    AsyncLog::detail::encodeAll(r, Color::Red, qint64(-1) << 40);
+    QCOMPARE(AsyncLog::format(r), QStringLiteral("2 -1099511627776"));
+
+    AsyncLog::Record empty;
+    QCOMPARE(AsyncLog::format(empty), QString());
+}
+
+void TestAsyncLog::formatText() {
+    AsyncLog::Record r = record("title: %1");
+    AsyncLog::detail::encodeAll(r, AsyncLog::Text(QStringLiteral("窗口标题")));
+    QCOMPARE(AsyncLog::format(r), QStringLiteral("title: 窗口标题"));
+
+    const wchar_t wide[] = L"wide text";
+    r = record("%1");
+    AsyncLog::detail::encodeAll(r, AsyncLog::Text(wide, 4));
+    QCOMPARE(AsyncLog::format(r), QStringLiteral("wide"));
+
+    // 超过记录内容量时截断并加省略号
+    const QString longText(40, QLatin1Char('x'));
+    r = record("%1");
+    AsyncLog::detail::encodeAll(r, AsyncLog::Text(longText));
+    QCOMPARE(r.textLength, quint16(40));
+    QCOMPARE(AsyncLog::format(r), QString(AsyncLog::Record::kTextCapacity, QLatin1Char('x')) + QChar(0x2026));
+}
+
+void TestAsyncLog::flushKeepsLevelsAndCategories() {
+    HW_LOG_DEBUG(s_testLog, "debug %1", 1);
+    HW_LOG_INFO(s_otherLog, "info %1", 2);
+    HW_LOG_WARNING(s_testLog, "warning");
+    // 未启动后台线程时记录留在队列中
+    QCOMPARE(lineCount(), qsizetype(0));
+
+    AsyncLog::flush();
+    const QList<Line> lines = takeLines();
+    QCOMPARE(texts(lines), (QStringList{ "debug 1", "info 2", "warning" }));
+    QCOMPARE(lines.at(0).type, QtDebugMsg);
+    QCOMPARE(lines.at(0).category, QStringLiteral("test"));
+    QCOMPARE(lines.at(1).type, QtInfoMsg);
+    QCOMPARE(lines.at(1).category, QStringLiteral("other"));
+    QCOMPARE(lines.at(2).type, QtWarningMsg);
+
+    AsyncLog::flush();
+    QCOMPARE(lineCount(), qsizetype(0));
+}
+
+void TestAsyncLog::flushMergesThreadsByTimestamp() {
+    HW_LOG_INFO(s_testLog, "main %1", 1);
+    QThread* worker = QThread::create([]() {
+        HW_LOG_INFO(s_testLog, "worker %1", 2);
+    });
+    worker->start();
+    worker->wait();
+    delete worker;
+    HW_LOG_INFO(s_testLog, "main %1", 3);
+
+    // 已退出线程的队列仍会被取空
+    AsyncLog::flush();
+    QCOMPARE(texts(takeLines()), (QStringList{ "main 1", "worker 2", "main 3" }));
+}
+
+void TestAsyncLog::rateLimit() {
+    QCOMPARE(s_limitedLog.maxPerSecond(), quint32(3));
+    for (int i = 0; i < 10; ++i) {
+        HW_LOG_DEBUG(s_limitedLog, "limited %1", i);
+    }
+    AsyncLog::flush();
+    const QList<Line> lines = takeLines();
+    QCOMPARE(lines.size(), qsizetype(4));
+    QCOMPARE(lines.at(2).text, QStringLiteral("limited 2"));
+    // 被限流的条数汇总为一条警告
+    QCOMPARE(lines.at(3).type, QtWarningMsg);
+    QCOMPARE(lines.at(3).category, QStringLiteral("limited"));
+    QCOMPARE(lines.at(3).text, QStringLiteral("7 messages suppressed by rate limit"));
+    QCOMPARE(s_limitedLog.takeSuppressed(), quint64(0));
+
+    s_limitedLog.setMaxPerSecond(0);
+    QVERIFY(s_limitedLog.admit());
+    s_limitedLog.setMaxPerSecond(3);
+}
+
+void TestAsyncLog::queueFullIsReported() {
+    const quint64 droppedBefore = AsyncLog::droppedCount();
+    QThread* worker = QThread::create([]() {
+        for (int i = 0; i < 5000; ++i) {
+            HW_LOG_DEBUG(s_testLog, "flood %1", i);
+        }
+    });
+    worker->start();
+    worker->wait();
+    delete worker;
+
+    // 队列满时丢弃新记录，已写入的按原样保留
+    const quint64 dropped = AsyncLog::droppedCount() - droppedBefore;
+    QVERIFY(dropped > 0);
+    AsyncLog::flush();
+    const QList<Line> lines = takeLines();
+    QCOMPARE(quint64(lines.size() - 1) + dropped, quint64(5000));
+    QCOMPARE(lines.first().text, QStringLiteral("flood 0"));
+    QCOMPARE(lines.last().category, QStringLiteral("log"));
+    QCOMPARE(lines.last().text, QStringLiteral("%1 messages dropped, log queue full").arg(dropped));
+    // 队列回收后丢弃数仍然计入
+    QCOMPARE(AsyncLog::droppedCount() - droppedBefore, dropped);
+}
+
+void TestAsyncLog::backgroundThread() {
+    HW_LOG_INFO(s_testLog, "before start");
+    AsyncLog::start();
+    AsyncLog::start(); // 重复启动无操作
+    QTRY_COMPARE(lineCount(), qsizetype(1));
+
+    // 后台线程休眠后新记录会把它唤醒
+    QTest::qWait(20);
+    HW_LOG_INFO(s_testLog, "while running");
+    QTRY_COMPARE(lineCount(), qsizetype(2));
+
+    HW_LOG_INFO(s_testLog, "before stop");
+    AsyncLog::stop();
+    QCOMPARE(texts(takeLines()), (QStringList{ "before start", "while running", "before stop" }));
+    AsyncLog::stop();
+}
+
+QTEST_GUILESS_MAIN(TestAsyncLog)
+#include "tst_asynclog.moc"
@@ -0,0 +1,219 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include <limits>
+#include "ControlProtocol.h"
+
+using namespace ControlProtocol;
+
+namespace {
+QByteArray varint(quint64 value) {
+    QByteArray bytes;
+    PayloadWriter(bytes).writeVarint(value);
+    return bytes;
+}
+} // namespace
+
+class TestControlProtocol : public QObject {
+    Q_OBJECT
+private slots:
+    void frameLayout();
+    void pipelinedFrames();
+    void incompleteFrames();
+    void invalidLengths();
+    void varintRoundTrip_data();
+    void varintRoundTrip();
+    void truncatedVarint();
+    void overlongVarint();
+    void stringRoundTrip();
+    void stringLongerThanPayload();
+};
+
+void TestControlProtocol::frameLayout() {
+    QByteArray out;
+    appendFrame(out, quint8(Opcode::HidePids), 0x01020304, QByteArray("\x02\x05\x07", 3));
+    // u32 长度（小端，code + id + payload）、code、u32 id（小端）、payload
+    QCOMPARE(out, QByteArray("\x08\x00\x00\x00" "\x02" "\x04\x03\x02\x01" "\x02\x05\x07", 12));
+    QCOMPARE(out.size(), qsizetype(kHeaderSize + 3));
+
+    qsizetype offset = 0;
+    Frame frame;
+    QCOMPARE(takeFrame(out, offset, frame), ParseResult::Frame);
+    QCOMPARE(frame.code, quint8(Opcode::HidePids));
+    QCOMPARE(frame.id, quint32(0x01020304));
+    QCOMPARE(frame.payload, QByteArray("\x02\x05\x07", 3));
+    QCOMPARE(offset, out.size());
+}
+
+void TestControlProtocol::pipelinedFrames() {
+    QByteArray out;
+    for (quint32 id = 1; id <= 100; ++id) {
+        QByteArray payload;
+        PayloadWriter(payload).writeVarint(id * 1000);
+        appendFrame(out, quint8(Opcode::Ping), id, id % 2 ? payload : QByteArray());
+    }
+    // 一次读到的多帧依次取出，最后剩下的数据不足一帧
+    qsizetype offset = 0;
+    Frame frame;
+    for (quint32 id = 1; id <= 100; ++id) {
+        QCOMPARE(takeFrame(out, offset, frame), ParseResult::Frame);
+        QCOMPARE(frame.id, id);
+        if (id % 2) {
+            PayloadReader reader(frame.payload);
+            quint64 value = 0;
+            QVERIFY(reader.readVarint(value));
+            QCOMPARE(value, quint64(id) * 1000);
+            QVERIFY(reader.atEnd());
+        }
+        else {
+            QVERIFY(frame.payload.isEmpty());
+        }
+    }
+    QCOMPARE(takeFrame(out, offset, frame), ParseResult::Incomplete);
+    QCOMPARE(offset, out.size());
+}
+
+void TestControlProtocol::incompleteFrames() {
+    QByteArray whole;
+    appendFrame(whole, quint8(Opcode::ListProcesses), 7, QByteArray("abcdef"));
+    // 任意前缀都只能是数据不足，且 offset 不动
+    for (qsizetype length = 0; length < whole.size(); ++length) {
+        qsizetype offset = 0;
+        Frame frame;
+        QCOMPARE(takeFrame(whole.left(length), offset, frame), ParseResult::Incomplete);
+        QCOMPARE(offset, qsizetype(0));
+    }
+    // 从中间的 offset 开始同样成立
+    QByteArray two = whole + whole.left(5);
+    qsizetype offset = 0;
+    Frame frame;
+    QCOMPARE(takeFrame(two, offset, frame), ParseResult::Frame);
+    QCOMPARE(takeFrame(two, offset, frame), ParseResult::Incomplete);
+    QCOMPARE(offset, whole.size());
+}
+
+void TestControlProtocol::invalidLengths() {
+    Frame frame;
+    // 长度小于 code + id
+    QByteArray tooShort("\x04\x00\x00\x00" "\x01" "\x00\x00\x00\x00", 9);
+    qsizetype offset = 0;
+    QCOMPARE(takeFrame(tooShort, offset, frame), ParseResult::Invalid);
+    QCOMPARE(offset, qsizetype(0));
+
+    // 超过单帧上限，不等待数据到齐即判定非法
+    QByteArray tooLong;
+    const quint32 length = kMaxFrameSize + 1;
+    for (int shift = 0; shift < 32; shift += 8) {
+        tooLong.append(static_cast<char>((length >> shift) & 0xff));
+    }
+    offset = 0;
+    QCOMPARE(takeFrame(tooLong, offset, frame), ParseResult::Invalid);
+
+    // 正好等于上限的长度是合法的，只是还没有到齐
+    QByteArray atLimit;
+    for (int shift = 0; shift < 32; shift += 8) {
+        atLimit.append(static_cast<char>((kMaxFrameSize >> shift) & 0xff));
+    }
+    offset = 0;
+    QCOMPARE(takeFrame(atLimit, offset, frame), ParseResult::Incomplete);
+}
+
+void TestControlProtocol::varintRoundTrip_data() {
+    QTest::addColumn<quint64>("value");
+    QTest::addColumn<int>("bytes");
+
+    QTest::newRow("zero") << quint64(0) << 1;
+    QTest::newRow("127") << quint64(127) << 1;
+    QTest::newRow("128") << quint64(128) << 2;
+    QTest::newRow("16383") << quint64(16383) << 2;
+    QTest::newRow("16384") << quint64(16384) << 3;
+    QTest::newRow("u32 max") << quint64(std::numeric_limits<quint32>::max()) << 5;
+    QTest::newRow("u64 max") << std::numeric_limits<quint64>::max() << 10;
+}
+
+void TestControlProtocol::varintRoundTrip() {
+    QFETCH(quint64, value);
+    QFETCH(int, bytes);
+    const QByteArray encoded = varint(value);
+    QCOMPARE(encoded.size(), qsizetype(bytes));
+    PayloadReader reader(encoded);
+    quint64 decoded = 1;
+    QVERIFY(reader.readVarint(decoded));
+    QCOMPARE(decoded, value);
+    QVERIFY(reader.atEnd());
+    QVERIFY(reader.ok());
+}
+
+void TestControlProtocol::truncatedVarint() {
+    // 最后一个字节仍带续位
+    const QByteArray encoded = varint(300).left(1);
+    PayloadReader reader(encoded);
+    quint64 value = 0;
+    QVERIFY(!reader.readVarint(value));
+    QVERIFY(!reader.ok());
+    // 出错之后的读取一律失败
+    QString text;
+    QVERIFY(!reader.readString(text));
+    QVERIFY(!reader.readVarint(value));
+
+    PayloadReader empty{ QByteArray() };
+    QVERIFY(!empty.readVarint(value));
+    QVERIFY(!empty.ok());
+}
+
+void TestControlProtocol::overlongVarint() {
+    // 超过 10 个字节的 varint 无法表示为 u64，视为格式错误
+    const QByteArray encoded(11, '\x80');
+    PayloadReader reader(encoded + QByteArray(1, '\x01'));
+    quint64 value = 0;
+    QVERIFY(!reader.readVarint(value));
+    QVERIFY(!reader.ok());
+}
+
+void TestControlProtocol::stringRoundTrip() {
+    QByteArray payload;
+    PayloadWriter writer(payload);
+    writer.writeString(QString());
+    writer.writeString(QStringLiteral("notepad.exe"));
+    writer.writeString(QStringLiteral("C:\\程序\\应用 (x86)\\app.exe"));
+    writer.writeVarint(42);
+
+    PayloadReader reader(payload);
+    QString text = QStringLiteral("x");
+    QVERIFY(reader.readString(text));
+    QVERIFY(text.isEmpty());
+    QVERIFY(reader.readString(text));
+    QCOMPARE(text, QStringLiteral("notepad.exe"));
+    QVERIFY(reader.readString(text));
+    QCOMPARE(text, QStringLiteral("C:\\程序\\应用 (x86)\\app.exe"));
+    quint64 value = 0;
+    QVERIFY(reader.readVarint(value));
+    QCOMPARE(value, quint64(42));
+    QVERIFY(reader.atEnd());
+    QVERIFY(reader.ok());
+}
+
+void TestControlProtocol::stringLongerThanPayload() {
+    // 声明的字节数超出剩余载荷
+    QByteArray payload = varint(10) + QByteArray("short");
+    PayloadReader reader(payload);
+    QString text;
+    QVERIFY(!reader.readString(text));
+    QVERIFY(!reader.ok());
+
+    // 极大的长度不能导致越界
+    PayloadReader huge(varint(std::numeric_limits<quint64>::max()) + QByteArray("abc"));
+    QVERIFY(!huge.readString(text));
+    QVERIFY(!huge.ok());
+}
+
+QTEST_APPLESS_MAIN(TestControlProtocol)
+#include "tst_controlprotocol.moc"
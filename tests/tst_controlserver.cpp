@@ -0,0 +1,305 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QMutex>
+#include <QWaitCondition>
+#include <atomic>
+#include "ControlServer.h"
+#include "ControlService.h"
+#include "FakeWindowSystem.h"
+#include "HideProcess.h"
+
+#ifdef Q_OS_UNIX
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using namespace ControlProtocol;
+
+namespace {
+// 每个用例一个服务名，避免与正在运行的实例或上一个用例冲突
+QString uniqueServerName() {
+    static int counter = 0;
+    return QStringLiteral("HideWindow.test.%1.%2").arg(QCoreApplication::applicationPid()).arg(++counter);
+}
+
+// snapshot() 阻塞到 release() 或被取消，用来构造“请求被推迟”的状态
+class GatedProcessSource : public ProcessSource {
+public:
+    bool snapshot(QList<ProcessEntry>& out, const std::atomic<bool>& cancelled) override {
+        ++calls;
+        QMutexLocker locker(&m_mutex);
+        while (m_gated && !cancelled.load()) {
+            m_condition.wait(&m_mutex, 5);
+        }
+        ProcessEntry entry;
+        entry.pid = 10;
+        entry.name = QStringLiteral("notepad.exe");
+        out = { entry };
+        return !cancelled.load();
+    }
+    void release() {
+        QMutexLocker locker(&m_mutex);
+        m_gated = false;
+        m_condition.wakeAll();
+    }
+
+    std::atomic<int> calls{ 0 };
+
+private:
+    QMutex m_mutex;
+    QWaitCondition m_condition;
+    bool m_gated = true;
+};
+
+QByteArray requestFrame(Opcode opcode, quint32 id, const QByteArray& payload = QByteArray()) {
+    QByteArray out;
+    appendFrame(out, static_cast<quint8>(opcode), id, payload);
+    return out;
+}
+
+QByteArray stringPayload(const QString& text) {
+    QByteArray payload;
+    PayloadWriter(payload).writeString(text);
+    return payload;
+}
+
+// 客户端：收到的数据在事件循环中累积，测试线程同时驱动服务端
+class Client {
+public:
+    explicit Client(const QString& name) {
+        QObject::connect(&socket, &QLocalSocket::readyRead, &socket, [this]() { received.append(socket.readAll()); });
+        QObject::connect(&socket, &QLocalSocket::disconnected, &socket, [this]() { disconnected = true; });
+        socket.connectToServer(name);
+    }
+
+    bool connected() { return socket.waitForConnected(1000); }
+    void send(const QByteArray& data) {
+        socket.write(data);
+        socket.flush();
+    }
+    // 当前已收到的完整响应帧
+    QList<Frame> frames() const {
+        QList<Frame> result;
+        qsizetype offset = 0;
+        Frame frame;
+        while (takeFrame(received, offset, frame) == ParseResult::Frame) {
+            result.append(frame);
+        }
+        return result;
+    }
+
+    QLocalSocket socket;
+    QByteArray received;
+    bool disconnected = false;
+};
+
+struct Fixture {
+    Fixture() {
+        auto owned = std::make_unique<FakeWindowSystem>();
+        system = owned.get();
+        window = system->addWindow(10, "Main");
+        hide = std::make_unique<HideProcess>(std::move(owned), QString());
+        auto owningSource = std::make_unique<GatedProcessSource>();
+        source = owningSource.get();
+        service = std::make_unique<ControlService>(hide.get(), std::move(owningSource));
+        server = std::make_unique<ControlServer>(service.get());
+    }
+    ~Fixture() {
+        source->release();
+        server.reset();
+    }
+
+    FakeWindowSystem* system = nullptr;
+    WindowId window = 0;
+    std::unique_ptr<HideProcess> hide;
+    GatedProcessSource* source = nullptr;
+    std::unique_ptr<ControlService> service;
+    std::unique_ptr<ControlServer> server;
+};
+} // namespace
+
+class TestControlServer : public QObject {
+    Q_OBJECT
+private slots:
+    void pipelinedRequestsAnsweredInOrder();
+    void partialFramesAreBuffered();
+    void deferredRequestHoldsLaterOnes();
+    void malformedFrameDropsOnlyThatConnection();
+    void disconnectWhileDeferred();
+    void secondServerDefersToRunningOne();
+    void staleSocketFileIsReplaced();
+};
+
+void TestControlServer::pipelinedRequestsAnsweredInOrder() {
+    Fixture fixture;
+    const QString name = uniqueServerName();
+    QVERIFY(fixture.server->listen(name));
+    QVERIFY(fixture.server->isListening());
+    QVERIFY(ControlServer::isServing(name));
+
+    Client client(name);
+    QVERIFY(client.connected());
+    // 一次写入 100 条请求，服务端逐条执行
+    QByteArray batch;
+    for (quint32 id = 1; id <= 99; ++id) {
+        batch += requestFrame(Opcode::Ping, id);
+    }
+    QByteArray pids;
+    PayloadWriter writer(pids);
+    writer.writeVarint(1);
+    writer.writeVarint(10);
+    batch += requestFrame(Opcode::HidePids, 100, pids);
+    client.send(batch);
+
+    QTRY_COMPARE(client.frames().size(), qsizetype(100));
+    const QList<Frame> frames = client.frames();
+    for (int i = 0; i < frames.size(); ++i) {
+        QCOMPARE(frames[i].id, quint32(i + 1));
+        QCOMPARE(frames[i].code, quint8(Status::Ok));
+    }
+    QVERIFY(!fixture.system->isVisible(fixture.window));
+}
+
+void TestControlServer::partialFramesAreBuffered() {
+    Fixture fixture;
+    const QString name = uniqueServerName();
+    QVERIFY(fixture.server->listen(name));
+    Client client(name);
+    QVERIFY(client.connected());
+
+    // 一帧分多次到达，凑齐之后才执行
+    const QByteArray frame = requestFrame(Opcode::Ping, 7) + requestFrame(Opcode::Ping, 8);
+    for (qsizetype i = 0; i < frame.size(); i += 3) {
+        client.send(frame.mid(i, 3));
+        QTest::qWait(2);
+    }
+    QTRY_COMPARE(client.frames().size(), qsizetype(2));
+    QCOMPARE(client.frames().at(0).id, quint32(7));
+    QCOMPARE(client.frames().at(1).id, quint32(8));
+}
+
+void TestControlServer::deferredRequestHoldsLaterOnes() {
+    Fixture fixture;
+    const QString name = uniqueServerName();
+    QVERIFY(fixture.server->listen(name));
+    Client client(name);
+    QVERIFY(client.connected());
+    Client other(name);
+    QVERIFY(other.connected());
+
+    // 按名称隐藏等待后台快照；同一连接之后的请求暂缓，保证按序执行
+    client.send(requestFrame(Opcode::HideName, 1, stringPayload(QStringLiteral("notepad*")))
+        + requestFrame(Opcode::Ping, 2));
+    QTRY_COMPARE(fixture.source->calls.load(), 1);
+    QTest::qWait(30);
+    QVERIFY(client.frames().isEmpty());
+
+    // 其他连接不受影响
+    other.send(requestFrame(Opcode::Ping, 9));
+    QTRY_COMPARE(other.frames().size(), qsizetype(1));
+
+    fixture.source->release();
+    QTRY_COMPARE(client.frames().size(), qsizetype(2));
+    QCOMPARE(client.frames().at(0).id, quint32(1));
+    QCOMPARE(client.frames().at(0).code, quint8(Status::Ok));
+    QCOMPARE(client.frames().at(1).id, quint32(2));
+    QVERIFY(!fixture.system->isVisible(fixture.window));
+}
+
+void TestControlServer::malformedFrameDropsOnlyThatConnection() {
+    Fixture fixture;
+    const QString name = uniqueServerName();
+    QVERIFY(fixture.server->listen(name));
+    Client bad(name);
+    QVERIFY(bad.connected());
+    Client good(name);
+    QVERIFY(good.connected());
+
+    // 合法请求之后跟一个非法长度：先写出已执行请求的响应，再断开
+    bad.send(requestFrame(Opcode::Ping, 1) + QByteArray("\x02\x00\x00\x00\x00\x00", 6));
+    QTRY_VERIFY(bad.disconnected);
+    QCOMPARE(bad.frames().size(), qsizetype(1));
+
+    good.send(requestFrame(Opcode::Ping, 2));
+    QTRY_COMPARE(good.frames().size(), qsizetype(1));
+}
+
+void TestControlServer::disconnectWhileDeferred() {
+    Fixture fixture;
+    const QString name = uniqueServerName();
+    QVERIFY(fixture.server->listen(name));
+    {
+        Client client(name);
+        QVERIFY(client.connected());
+        client.send(requestFrame(Opcode::ListProcesses, 1, stringPayload(QString())));
+        QTRY_COMPARE(fixture.source->calls.load(), 1);
+    }
+    // 连接断开后快照才完成，响应被丢弃
+    QTest::qWait(30);
+    fixture.source->release();
+    QTest::qWait(30);
+
+    Client next(name);
+    QVERIFY(next.connected());
+    next.send(requestFrame(Opcode::ListProcesses, 2, stringPayload(QString())));
+    QTRY_COMPARE(next.frames().size(), qsizetype(1));
+    QCOMPARE(next.frames().at(0).id, quint32(2));
+}
+
+void TestControlServer::secondServerDefersToRunningOne() {
+    Fixture first;
+    Fixture second;
+    const QString name = uniqueServerName();
+    QVERIFY(!ControlServer::isServing(name));
+    QVERIFY(first.server->listen(name));
+    // 同名服务仍在应答：不抢占，交给已运行的实例
+    QVERIFY(!second.server->listen(name));
+    QVERIFY(!second.server->isListening());
+    QVERIFY(ControlServer::isServing(name));
+
+    first.server->close();
+    QVERIFY(!first.server->isListening());
+    QVERIFY(!ControlServer::isServing(name));
+    QVERIFY(second.server->listen(name));
+}
+
+void TestControlServer::staleSocketFileIsReplaced() {
+#ifdef Q_OS_UNIX
+    // 模拟异常退出：套接字文件还在，但没有进程在监听
+    const QString name = uniqueServerName();
+    const QByteArray path = (QDir::tempPath() + QLatin1Char('/') + name).toLocal8Bit();
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.constData(), static_cast<size_t>(path.size()));
+    QCOMPARE(bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)), 0);
+    close(fd);
+    QVERIFY(QFile::exists(QString::fromLocal8Bit(path)));
+    QVERIFY(!ControlServer::isServing(name));
+
+    Fixture fixture;
+    QVERIFY(fixture.server->listen(name));
+    Client client(name);
+    QVERIFY(client.connected());
+    client.send(requestFrame(Opcode::Ping, 1));
+    QTRY_COMPARE(client.frames().size(), qsizetype(1));
+#else
+    QSKIP("named pipes leave no file behind");
+#endif
+}
+
+QTEST_GUILESS_MAIN(TestControlServer)
+#include "tst_controlserver.moc"
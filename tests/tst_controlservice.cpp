@@ -0,0 +1,493 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include <QMutex>
+#include <QSignalSpy>
+#include <QWaitCondition>
+#include <algorithm>
+#include <atomic>
+#include "ControlService.h"
+#include "FakeWindowSystem.h"
+#include "HideProcess.h"
+
+using namespace ControlProtocol;
+
+namespace {
+ProcessEntry makeEntry(qint64 pid, const QString& name) {
+    ProcessEntry entry;
+    entry.pid = pid;
+    entry.parentPid = 1;
+    entry.startTime = static_cast<quint64>(pid) * 10;
+    entry.name = name;
+    entry.exePath = QStringLiteral("C:\\Apps\\") + name;
+    return entry;
+}
+
+QList<ProcessEntry> defaultEntries() {
+    return { makeEntry(10, QStringLiteral("notepad.exe")), makeEntry(20, QStringLiteral("Notepad2.exe")),
+        makeEntry(30, QStringLiteral("slack.exe")) };
+}
+
+// 返回固定进程列表；gated 时 snapshot() 阻塞到 release() 或被取消
+class ListProcessSource : public ProcessSource {
+public:
+    explicit ListProcessSource(const QList<ProcessEntry>& entries, bool gated = false)
+        : m_entries(entries)
+        , m_gated(gated)
+    {
+    }
+
+    bool snapshot(QList<ProcessEntry>& out, const std::atomic<bool>& cancelled) override {
+        ++calls;
+        QMutexLocker locker(&m_mutex);
+        while (m_gated && m_released == 0 && !cancelled.load()) {
+            m_condition.wait(&m_mutex, 5);
+        }
+        if (m_gated && m_released > 0) {
+            --m_released;
+        }
+        out = m_entries;
+        return !cancelled.load() && !failing;
+    }
+
+    void release(int count = 1) {
+        QMutexLocker locker(&m_mutex);
+        m_released += count;
+        m_condition.wakeAll();
+    }
+
+    std::atomic<int> calls{ 0 };
+    bool failing = false;
+
+private:
+    QList<ProcessEntry> m_entries;
+    bool m_gated;
+    QMutex m_mutex;
+    QWaitCondition m_condition;
+    int m_released = 0;
+};
+
+Frame request(Opcode opcode, quint32 id, const QByteArray& payload = QByteArray()) {
+    Frame frame;
+    frame.code = static_cast<quint8>(opcode);
+    frame.id = id;
+    frame.payload = payload;
+    return frame;
+}
+
+QByteArray pidsPayload(const QList<qint64>& pids) {
+    QByteArray payload;
+    PayloadWriter writer(payload);
+    writer.writeVarint(static_cast<quint64>(pids.size()));
+    for (qint64 pid : pids) {
+        writer.writeVarint(static_cast<quint64>(pid));
+    }
+    return payload;
+}
+
+QByteArray stringPayload(const QString& text) {
+    QByteArray payload;
+    PayloadWriter(payload).writeString(text);
+    return payload;
+}
+
+// 响应帧中只有一帧，取出来
+Frame single(const QByteArray& out) {
+    Frame frame;
+    qsizetype offset = 0;
+    if (takeFrame(out, offset, frame) != ParseResult::Frame || offset != out.size()) {
+        frame.code = 0xff;
+    }
+    return frame;
+}
+
+// 同步执行一条请求并返回响应帧
+Frame call(ControlService& service, Opcode opcode, const QByteArray& payload = QByteArray(), quint32 id = 1) {
+    QByteArray out;
+    service.handleNow(request(opcode, id, payload), out);
+    return single(out);
+}
+
+quint64 varintAt(const QByteArray& payload, int index) {
+    PayloadReader reader(payload);
+    quint64 value = 0;
+    for (int i = 0; i <= index; ++i) {
+        reader.readVarint(value);
+    }
+    return value;
+}
+
+QString errorOf(const Frame& frame) {
+    PayloadReader reader(frame.payload);
+    QString text;
+    reader.readString(text);
+    return text;
+}
+
+struct Fixture {
+    Fixture(bool withWindowSystem = true, bool gated = false) {
+        std::unique_ptr<FakeWindowSystem> owned;
+        if (withWindowSystem) {
+            owned = std::make_unique<FakeWindowSystem>();
+            system = owned.get();
+            a = system->addWindow(10, "Main");
+            b = system->addWindow(10, "Tool");
+            c = system->addWindow(20, "Main");
+            d = system->addWindow(30, "Chat", "Slack");
+        }
+        hide = std::make_unique<HideProcess>(std::move(owned), QString());
+        auto owningSource = std::make_unique<ListProcessSource>(defaultEntries(), gated);
+        source = owningSource.get();
+        service = std::make_unique<ControlService>(hide.get(), std::move(owningSource));
+    }
+
+    FakeWindowSystem* system = nullptr;
+    WindowId a = 0, b = 0, c = 0, d = 0;
+    std::unique_ptr<HideProcess> hide;
+    ListProcessSource* source = nullptr;
+    std::unique_ptr<ControlService> service;
+};
+
+// responseReady 的记录
+struct Deferred {
+    quintptr tag;
+    Frame frame;
+};
+
+QList<Deferred> deferredOf(const QSignalSpy& spy) {
+    QList<Deferred> result;
+    for (int i = 0; i < spy.count(); ++i) {
+        const QList<QVariant> arguments = spy.at(i);
+        result.append({ arguments.at(0).value<quintptr>(), single(arguments.at(1).toByteArray()) });
+    }
+    return result;
+}
+} // namespace
+
+class TestControlService : public QObject {
+    Q_OBJECT
+private slots:
+    void pingAndUnknownOpcode();
+    void hideAndShowPids();
+    void malformedPidListChangesNothing();
+    void hideAndShowByName();
+    void snapshotFailureIsUnavailable();
+    void addAndRemoveRules();
+    void listProcessesReportsHiddenCounts();
+    void queryState();
+    void showAllAndShutdown();
+    void statsReport();
+    void noWindowSystem();
+    void deferredRequestsShareSnapshot();
+    void cancelDropsPendingResponses();
+    void destroyWhileSnapshotRunning();
+};
+
+void TestControlService::pingAndUnknownOpcode() {
+    Fixture fixture;
+    Frame response = call(*fixture.service, Opcode::Ping, QByteArray(), 77);
+    QCOMPARE(response.code, quint8(Status::Ok));
+    QCOMPARE(response.id, quint32(77));
+    QVERIFY(response.payload.isEmpty());
+
+    // 多余的字节视为格式错误
+    response = call(*fixture.service, Opcode::Ping, QByteArray("x"));
+    QCOMPARE(response.code, quint8(Status::BadRequest));
+    QCOMPARE(errorOf(response), QStringLiteral("malformed payload"));
+
+    response = call(*fixture.service, static_cast<Opcode>(99));
+    QCOMPARE(response.code, quint8(Status::UnknownOpcode));
+    QVERIFY(!errorOf(response).isEmpty());
+}
+
+void TestControlService::hideAndShowPids() {
+    Fixture fixture;
+    Frame response = call(*fixture.service, Opcode::HidePids, pidsPayload({ 10, 999 }));
+    QCOMPARE(response.code, quint8(Status::Ok));
+    // 只统计实际隐藏的窗口；PID 999 没有窗口
+    QCOMPARE(varintAt(response.payload, 0), quint64(2));
+    QVERIFY(!fixture.system->isVisible(fixture.a));
+    QVERIFY(!fixture.system->isVisible(fixture.b));
+    QVERIFY(fixture.system->isVisible(fixture.c));
+
+    // 再次隐藏不改变任何窗口
+    response = call(*fixture.service, Opcode::HidePids, pidsPayload({ 10 }));
+    QCOMPARE(varintAt(response.payload, 0), quint64(0));
+
+    response = call(*fixture.service, Opcode::ShowPids, pidsPayload({ 10, 20 }));
+    QCOMPARE(response.code, quint8(Status::Ok));
+    QCOMPARE(varintAt(response.payload, 0), quint64(2));
+    QVERIFY(fixture.system->isVisible(fixture.a));
+    QVERIFY(fixture.system->isVisible(fixture.c));
+}
+
+void TestControlService::malformedPidListChangesNothing() {
+    Fixture fixture;
+    // 声明 3 个只带 2 个、PID 为 0、尾部多余字节：整条请求在执行前被拒绝
+    QByteArray shortList = pidsPayload({ 10, 20 });
+    shortList[0] = 3;
+    const QList<QByteArray> payloads = { shortList, pidsPayload({ 10, 0 }), pidsPayload({ 10 }) + QByteArray("\x01", 1),
+        QByteArray() };
+    for (const QByteArray& payload : payloads) {
+        const Frame response = call(*fixture.service, Opcode::HidePids, payload);
+        QCOMPARE(response.code, quint8(Status::BadRequest));
+    }
+    QVERIFY(fixture.system->isVisible(fixture.a));
+    QCOMPARE(fixture.hide->hiddenWindows().count(), 0);
+    QCOMPARE(fixture.system->calls().batchVisible, 0);
+}
+
+void TestControlService::hideAndShowByName() {
+    Fixture fixture;
+    // 通配符不区分大小写：notepad.exe 与 Notepad2.exe
+    Frame response = call(*fixture.service, Opcode::HideName, stringPayload(QStringLiteral("NOTEPAD*")));
+    QCOMPARE(response.code, quint8(Status::Ok));
+    QCOMPARE(varintAt(response.payload, 0), quint64(2));
+    QCOMPARE(varintAt(response.payload, 1), quint64(3));
+    QVERIFY(!fixture.system->isVisible(fixture.c));
+    QVERIFY(fixture.system->isVisible(fixture.d));
+    QCOMPARE(fixture.source->calls.load(), 1);
+
+    response = call(*fixture.service, Opcode::ShowName, stringPayload(QStringLiteral("notepad2.exe")));
+    QCOMPARE(varintAt(response.payload, 0), quint64(1));
+    QCOMPARE(varintAt(response.payload, 1), quint64(1));
+    QVERIFY(fixture.system->isVisible(fixture.c));
+    QVERIFY(!fixture.system->isVisible(fixture.a));
+
+    response = call(*fixture.service, Opcode::HideName, stringPayload(QString()));
+    QCOMPARE(response.code, quint8(Status::BadRequest));
+    response = call(*fixture.service, Opcode::HideName, stringPayload(QStringLiteral("none*")));
+    QCOMPARE(response.code, quint8(Status::Ok));
+    QCOMPARE(varintAt(response.payload, 0), quint64(0));
+}
+
+void TestControlService::snapshotFailureIsUnavailable() {
+    Fixture fixture;
+    fixture.source->failing = true;
+    Frame response = call(*fixture.service, Opcode::HideName, stringPayload(QStringLiteral("*")));
+    QCOMPARE(response.code, quint8(Status::Unavailable));
+    response = call(*fixture.service, Opcode::ListProcesses, stringPayload(QString()));
+    QCOMPARE(response.code, quint8(Status::Unavailable));
+    QCOMPARE(fixture.hide->hiddenWindows().count(), 0);
+}
+
+void TestControlService::addAndRemoveRules() {
+    Fixture fixture;
+    Frame response = call(*fixture.service, Opcode::AddRule, stringPayload(QStringLiteral("title:*slack*")));
+    QCOMPARE(response.code, quint8(Status::Ok));
+    QCOMPARE(varintAt(response.payload, 0), quint64(1));
+    QVERIFY(!fixture.system->isVisible(fixture.d));
+    QCOMPARE(fixture.hide->hideRules(), QStringList{ QStringLiteral("title:*slack*") });
+
+    // 语法错误带回解析器的错误信息
+    response = call(*fixture.service, Opcode::AddRule, stringPayload(QStringLiteral("colour:red")));
+    QCOMPARE(response.code, quint8(Status::BadRequest));
+    QVERIFY(!errorOf(response).isEmpty());
+    response = call(*fixture.service, Opcode::AddRule, stringPayload(QStringLiteral("   ")));
+    QCOMPARE(response.code, quint8(Status::BadRequest));
+
+    response = call(*fixture.service, Opcode::RemoveRule, stringPayload(QStringLiteral("title:*teams*")));
+    QCOMPARE(response.code, quint8(Status::BadRequest));
+    QCOMPARE(errorOf(response), QStringLiteral("no such rule"));
+
+    response = call(*fixture.service, Opcode::RemoveRule, stringPayload(QStringLiteral("title:*slack*")));
+    QCOMPARE(response.code, quint8(Status::Ok));
+    QCOMPARE(varintAt(response.payload, 0), quint64(1));
+    QVERIFY(fixture.system->isVisible(fixture.d));
+    QVERIFY(fixture.hide->hideRules().isEmpty());
+}
+
+void TestControlService::listProcessesReportsHiddenCounts() {
+    Fixture fixture;
+    call(*fixture.service, Opcode::HidePids, pidsPayload({ 10 }));
+    Frame response = call(*fixture.service, Opcode::ListProcesses, stringPayload(QStringLiteral("*pad*")));
+    QCOMPARE(response.code, quint8(Status::Ok));
+
+    PayloadReader reader(response.payload);
+    quint64 count = 0;
+    QVERIFY(reader.readVarint(count));
+    QCOMPARE(count, quint64(2));
+    QList<qint64> pids;
+    QList<quint64> hidden;
+    for (quint64 i = 0; i < count; ++i) {
+        quint64 pid = 0, parent = 0, hiddenCount = 0;
+        QString name, path;
+        QVERIFY(reader.readVarint(pid));
+        QVERIFY(reader.readVarint(parent));
+        QVERIFY(reader.readString(name));
+        QVERIFY(reader.readString(path));
+        QVERIFY(reader.readVarint(hiddenCount));
+        QCOMPARE(parent, quint64(1));
+        QCOMPARE(path, QStringLiteral("C:\\Apps\\") + name);
+        pids.append(static_cast<qint64>(pid));
+        hidden.append(hiddenCount);
+    }
+    QVERIFY(reader.atEnd());
+    QCOMPARE(pids, (QList<qint64>{ 10, 20 }));
+    QCOMPARE(hidden, (QList<quint64>{ 2, 0 }));
+
+    // 空模式列出全部进程
+    response = call(*fixture.service, Opcode::ListProcesses, stringPayload(QString()));
+    QCOMPARE(varintAt(response.payload, 0), quint64(3));
+}
+
+void TestControlService::queryState() {
+    Fixture fixture;
+    call(*fixture.service, Opcode::HidePids, pidsPayload({ 10, 20 }));
+    call(*fixture.service, Opcode::AddRule, stringPayload(QStringLiteral("exe:never.exe")));
+    const Frame response = call(*fixture.service, Opcode::QueryState);
+    QCOMPARE(response.code, quint8(Status::Ok));
+
+    PayloadReader reader(response.payload);
+    quint64 hidden = 0, indexed = 0, pidCount = 0, ruleCount = 0;
+    QVERIFY(reader.readVarint(hidden));
+    QVERIFY(reader.readVarint(indexed));
+    QCOMPARE(hidden, quint64(3));
+    QCOMPARE(indexed, quint64(4));
+    QVERIFY(reader.readVarint(pidCount));
+    QList<qint64> pids;
+    for (quint64 i = 0; i < pidCount; ++i) {
+        quint64 pid = 0;
+        QVERIFY(reader.readVarint(pid));
+        pids.append(static_cast<qint64>(pid));
+    }
+    std::sort(pids.begin(), pids.end());
+    QCOMPARE(pids, (QList<qint64>{ 10, 20 }));
+    QVERIFY(reader.readVarint(ruleCount));
+    QCOMPARE(ruleCount, quint64(1));
+    QString rule;
+    QVERIFY(reader.readString(rule));
+    QCOMPARE(rule, QStringLiteral("exe:never.exe"));
+    QVERIFY(reader.atEnd());
+}
+
+void TestControlService::showAllAndShutdown() {
+    Fixture fixture;
+    call(*fixture.service, Opcode::HidePids, pidsPayload({ 10, 20, 30 }));
+    QSignalSpy shutdown(fixture.service.get(), &ControlService::shutdownRequested);
+    Frame response = call(*fixture.service, Opcode::ShowAll);
+    QCOMPARE(varintAt(response.payload, 0), quint64(4));
+    QCOMPARE(fixture.hide->hiddenWindows().count(), 0);
+    QCOMPARE(shutdown.count(), 0);
+
+    // 响应先写入 out，随后才发出信号
+    QByteArray out;
+    connect(fixture.service.get(), &ControlService::shutdownRequested, this, [&out]() { QVERIFY(!out.isEmpty()); });
+    fixture.service->handleNow(request(Opcode::Shutdown, 5), out);
+    QCOMPARE(shutdown.count(), 1);
+    QCOMPARE(single(out).code, quint8(Status::Ok));
+    QCOMPARE(single(out).id, quint32(5));
+
+    // 格式错误的关闭请求不生效
+    call(*fixture.service, Opcode::Shutdown, QByteArray("x"));
+    QCOMPARE(shutdown.count(), 1);
+}
+
+void TestControlService::statsReport() {
+    Fixture fixture;
+    const Frame response = call(*fixture.service, Opcode::Stats);
+    QCOMPARE(response.code, quint8(Status::Ok));
+    PayloadReader reader(response.payload);
+    QString report;
+    QVERIFY(reader.readString(report));
+    QVERIFY(reader.atEnd());
+}
+
+void TestControlService::noWindowSystem() {
+    Fixture fixture(false);
+    Frame response = call(*fixture.service, Opcode::HidePids, pidsPayload({ 10 }));
+    QCOMPARE(response.code, quint8(Status::Unavailable));
+    response = call(*fixture.service, Opcode::HideName, stringPayload(QStringLiteral("*")));
+    QCOMPARE(response.code, quint8(Status::Unavailable));
+    response = call(*fixture.service, Opcode::AddRule, stringPayload(QStringLiteral("exe:a.exe")));
+    QCOMPARE(response.code, quint8(Status::Unavailable));
+    // 只读请求不需要窗口系统；格式错误仍先于可用性报告
+    response = call(*fixture.service, Opcode::HidePids, QByteArray());
+    QCOMPARE(response.code, quint8(Status::BadRequest));
+    QCOMPARE(call(*fixture.service, Opcode::ListProcesses, stringPayload(QString())).code, quint8(Status::Ok));
+    QCOMPARE(call(*fixture.service, Opcode::QueryState).code, quint8(Status::Ok));
+}
+
+void TestControlService::deferredRequestsShareSnapshot() {
+    Fixture fixture(true, true);
+    ControlService& service = *fixture.service;
+    QSignalSpy ready(&service, &ControlService::responseReady);
+
+    // 不需要快照的请求立即完成
+    QByteArray out;
+    QVERIFY(service.handle(request(Opcode::Ping, 1), out, 1));
+    QCOMPARE(single(out).id, quint32(1));
+
+    // 第一条需要快照的请求启动后台快照；快照进行中到达的请求等下一次快照，
+    // 不使用早于请求的数据，同一批等待的请求共用一次快照
+    out.clear();
+    QVERIFY(!service.handle(request(Opcode::HideName, 2, stringPayload(QStringLiteral("notepad.exe"))), out, 1));
+    QTRY_COMPARE(fixture.source->calls.load(), 1);
+    QVERIFY(!service.handle(request(Opcode::ListProcesses, 3, stringPayload(QString())), out, 2));
+    QVERIFY(!service.handle(request(Opcode::ShowName, 4, stringPayload(QStringLiteral("notepad.exe"))), out, 1));
+    QVERIFY(out.isEmpty());
+    QCOMPARE(ready.count(), 0);
+
+    fixture.source->release();
+    QTRY_COMPARE(ready.count(), 1);
+    QTRY_COMPARE(fixture.source->calls.load(), 2);
+    fixture.source->release();
+    QTRY_COMPARE(ready.count(), 3);
+    QCOMPARE(fixture.source->calls.load(), 2);
+
+    const QList<Deferred> responses = deferredOf(ready);
+    QCOMPARE(responses[0].tag, quintptr(1));
+    QCOMPARE(responses[0].frame.id, quint32(2));
+    QCOMPARE(responses[1].tag, quintptr(2));
+    QCOMPARE(responses[1].frame.id, quint32(3));
+    QCOMPARE(responses[2].tag, quintptr(1));
+    QCOMPARE(responses[2].frame.id, quint32(4));
+    for (const Deferred& response : responses) {
+        QCOMPARE(response.frame.code, quint8(Status::Ok));
+    }
+    // 按到达顺序执行：先隐藏再显示
+    QVERIFY(fixture.system->isVisible(fixture.a));
+    QCOMPARE(fixture.hide->hiddenWindows().count(), 0);
+}
+
+void TestControlService::cancelDropsPendingResponses() {
+    Fixture fixture(true, true);
+    ControlService& service = *fixture.service;
+    QSignalSpy ready(&service, &ControlService::responseReady);
+    QByteArray out;
+    QVERIFY(!service.handle(request(Opcode::ListProcesses, 1, stringPayload(QString())), out, 1));
+    QVERIFY(!service.handle(request(Opcode::HideName, 2, stringPayload(QStringLiteral("*"))), out, 2));
+    QVERIFY(!service.handle(request(Opcode::ListProcesses, 3, stringPayload(QString())), out, 3));
+    // 连接 2 已断开：它的请求不执行，也不发出响应
+    service.cancel(2);
+    fixture.source->release(2);
+    QTRY_COMPARE(ready.count(), 2);
+    QTest::qWait(20);
+    const QList<Deferred> responses = deferredOf(ready);
+    QCOMPARE(responses.size(), qsizetype(2));
+    QCOMPARE(responses[0].tag, quintptr(1));
+    QCOMPARE(responses[1].tag, quintptr(3));
+    QCOMPARE(fixture.hide->hiddenWindows().count(), 0);
+}
+
+void TestControlService::destroyWhileSnapshotRunning() {
+    Fixture fixture(true, true);
+    QSignalSpy ready(fixture.service.get(), &ControlService::responseReady);
+    QByteArray out;
+    QVERIFY(!fixture.service->handle(request(Opcode::ListProcesses, 1, stringPayload(QString())), out, 1));
+    QTRY_COMPARE(fixture.source->calls.load(), 1);
+    // 析构取消进行中的快照并等待线程结束，不再发出响应
+    fixture.service.reset();
+    QCOMPARE(ready.count(), 0);
+}
+
+QTEST_GUILESS_MAIN(TestControlService)
+#include "tst_controlservice.moc"
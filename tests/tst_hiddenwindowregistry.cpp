@@ -0,0 +1,369 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include <QFile>
+#include <QProcess>
+#include <QTemporaryDir>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include "HiddenWindowRegistry.h"
+
+namespace {
+constexpr qint64 kHeaderBytes = 24;
+constexpr qint64 kRecordBytes = 40;
+
+qint64 journalBytes(quint32 capacity) {
+    return kHeaderBytes + kRecordBytes * capacity;
+}
+
+HiddenWindowRecord makeRecord(quint64 windowId, qint64 pid = 0) {
+    HiddenWindowRecord record;
+    record.windowId = windowId;
+    record.pid = pid ? pid : static_cast<qint64>(windowId) * 10;
+    record.placement.showCmd = 1;
+    record.placement.left = static_cast<qint32>(windowId);
+    record.placement.top = 2;
+    record.placement.right = 300;
+    record.placement.bottom = 400;
+    return record;
+}
+
+QByteArray readAll(const QString& path) {
+    QFile file(path);
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+bool writeAll(const QString& path, const QByteArray& data) {
+    QFile file(path);
+    return file.open(QIODevice::WriteOnly | QIODevice::Truncate) && file.write(data) == data.size();
+}
+
+template <typename T>
+T readAt(const QByteArray& data, qint64 offset) {
+    T value;
+    std::memcpy(&value, data.constData() + offset, sizeof(T));
+    return value;
+}
+
+template <typename T>
+void writeAt(QByteArray& data, qint64 offset, T value) {
+    std::memcpy(data.data() + offset, &value, sizeof(T));
+}
+
+// 头部字段的偏移
+constexpr qint64 kCapacityOffset = 12;
+constexpr qint64 kCountOffset = 16;
+} // namespace
+
+class TestHiddenWindowRegistry : public QObject {
+    Q_OBJECT
+private slots:
+    void init();
+    void cleanup();
+    void memoryOnlyWithoutFile();
+    void fileLayout();
+    void recordsSurviveReopen();
+    void removeMovesLastRecordIntoSlot();
+    void tornAppendKeepsValidPrefix();
+    void tornRemoveDropsDuplicate();
+    void corruptFileStartsEmpty_data();
+    void corruptFileStartsEmpty();
+    void growsAndRemaps();
+    void lockedJournalIsNotShared();
+    void staleLockIsTakenOver();
+
+private:
+    std::unique_ptr<QTemporaryDir> m_dir;
+    QString m_path;
+};
+
+void TestHiddenWindowRegistry::init() {
+    m_dir = std::make_unique<QTemporaryDir>();
+    QVERIFY(m_dir->isValid());
+    m_path = m_dir->filePath(QStringLiteral("sub/hidden.journal"));
+}
+
+void TestHiddenWindowRegistry::cleanup() {
+    m_dir.reset();
+}
+
+void TestHiddenWindowRegistry::memoryOnlyWithoutFile() {
+    HiddenWindowRegistry registry;
+    QVERIFY(!registry.isPersistent());
+    QVERIFY(registry.add(makeRecord(1)));
+    QVERIFY(registry.add(makeRecord(2)));
+    // 同一窗口重复登记覆盖旧记录
+    QVERIFY(registry.add(makeRecord(1, 77)));
+    QCOMPARE(registry.count(), 2);
+    QCOMPARE(registry.find(1)->pid, qint64(77));
+    QVERIFY(registry.remove(1));
+    QVERIFY(!registry.remove(1));
+    QVERIFY(!registry.find(1));
+    QVERIFY(registry.contains(2));
+    registry.clear();
+    QCOMPARE(registry.count(), 0);
+    QVERIFY(!registry.contains(2));
+}
+
+void TestHiddenWindowRegistry::fileLayout() {
+    {
+        HiddenWindowRegistry registry;
+        QVERIFY(registry.open(m_path));
+        QVERIFY(registry.isPersistent());
+        QVERIFY(registry.add(makeRecord(0x1122334455667788ull, 4242)));
+        QVERIFY(registry.add(makeRecord(5)));
+    }
+    // 24 字节头部（magic、version、capacity、count、reserved）之后是 64 条 40 字节的记录
+    const QByteArray data = readAll(m_path);
+    QCOMPARE(data.size(), journalBytes(64));
+    QCOMPARE(data.left(8), QByteArray("HWJRNL\0\0", 8));
+    QCOMPARE(readAt<quint32>(data, 8), quint32(1));
+    QCOMPARE(readAt<quint32>(data, kCapacityOffset), quint32(64));
+    QCOMPARE(readAt<quint32>(data, kCountOffset), quint32(2));
+    QCOMPARE(readAt<quint32>(data, 20), quint32(0));
+
+    QCOMPARE(readAt<quint64>(data, kHeaderBytes), quint64(0x1122334455667788ull));
+    QCOMPARE(readAt<qint64>(data, kHeaderBytes + 8), qint64(4242));
+    // WindowPlacement：showCmd、flags、left、top、right、bottom
+    QCOMPARE(readAt<qint32>(data, kHeaderBytes + 16), qint32(1));
+    QCOMPARE(readAt<qint32>(data, kHeaderBytes + 24), qint32(0x55667788));
+    QCOMPARE(readAt<qint32>(data, kHeaderBytes + 36), qint32(400));
+    QCOMPARE(readAt<quint64>(data, kHeaderBytes + kRecordBytes), quint64(5));
+}
+
+void TestHiddenWindowRegistry::recordsSurviveReopen() {
+    {
+        HiddenWindowRegistry registry;
+        QVERIFY(registry.open(m_path));
+        for (quint64 id = 1; id <= 3; ++id) {
+            QVERIFY(registry.add(makeRecord(id)));
+        }
+        QVERIFY(registry.remove(2));
+        // 没有调用 close()：析构等同于进程退出时映射被丢弃
+    }
+    HiddenWindowRegistry registry;
+    QVERIFY(registry.open(m_path));
+    QCOMPARE(registry.count(), 2);
+    QVERIFY(registry.contains(1));
+    QVERIFY(!registry.contains(2));
+    QCOMPARE(registry.find(3)->pid, qint64(30));
+    QCOMPARE(registry.find(3)->placement.left, qint32(3));
+    QCOMPARE(registry.find(3)->placement.bottom, qint32(400));
+
+    QList<quint64> ids;
+    registry.forEach([&](const HiddenWindowRecord& record) { ids.append(record.windowId); });
+    std::sort(ids.begin(), ids.end());
+    QCOMPARE(ids, (QList<quint64>{ 1, 3 }));
+}
+
+void TestHiddenWindowRegistry::removeMovesLastRecordIntoSlot() {
+    {
+        HiddenWindowRegistry registry;
+        QVERIFY(registry.open(m_path));
+        for (quint64 id = 1; id <= 4; ++id) {
+            QVERIFY(registry.add(makeRecord(id)));
+        }
+        QVERIFY(registry.remove(1));
+        QCOMPARE(registry.find(4)->windowId, quint64(4));
+    }
+    // 删除不移动其余记录，只用末尾记录填补空位
+    const QByteArray data = readAll(m_path);
+    QCOMPARE(readAt<quint32>(data, kCountOffset), quint32(3));
+    QCOMPARE(readAt<quint64>(data, kHeaderBytes), quint64(4));
+    QCOMPARE(readAt<quint64>(data, kHeaderBytes + kRecordBytes), quint64(2));
+    QCOMPARE(readAt<quint64>(data, kHeaderBytes + 2 * kRecordBytes), quint64(3));
+}
+
+void TestHiddenWindowRegistry::tornAppendKeepsValidPrefix() {
+    {
+        HiddenWindowRegistry registry;
+        QVERIFY(registry.open(m_path));
+        QVERIFY(registry.add(makeRecord(1)));
+        QVERIFY(registry.add(makeRecord(2)));
+    }
+    // 模拟写第三条记录时被杀死：记录只写了一半，count 尚未发布
+    QByteArray data = readAll(m_path);
+    writeAt<quint64>(data, kHeaderBytes + 2 * kRecordBytes, 3);
+    writeAt<qint64>(data, kHeaderBytes + 2 * kRecordBytes + 8, -1);
+    QVERIFY(writeAll(m_path, data));
+
+    HiddenWindowRegistry registry;
+    QVERIFY(registry.open(m_path));
+    QCOMPARE(registry.count(), 2);
+    QVERIFY(registry.contains(1));
+    QVERIFY(registry.contains(2));
+    QVERIFY(!registry.contains(3));
+    // 未发布的槽位在下一次登记时被覆盖
+    QVERIFY(registry.add(makeRecord(9)));
+    QCOMPARE(registry.find(9)->pid, qint64(90));
+}
+
+void TestHiddenWindowRegistry::tornRemoveDropsDuplicate() {
+    {
+        HiddenWindowRegistry registry;
+        QVERIFY(registry.open(m_path));
+        for (quint64 id = 1; id <= 3; ++id) {
+            QVERIFY(registry.add(makeRecord(id)));
+        }
+    }
+    // 模拟删除窗口 1 时被杀死：末尾记录已复制到空位，count 尚未减小
+    QByteArray data = readAll(m_path);
+    std::memcpy(data.data() + kHeaderBytes, data.constData() + kHeaderBytes + 2 * kRecordBytes, kRecordBytes);
+    QVERIFY(writeAll(m_path, data));
+
+    {
+        HiddenWindowRegistry registry;
+        QVERIFY(registry.open(m_path));
+        QCOMPARE(registry.count(), 2);
+        QVERIFY(!registry.contains(1));
+        // 重复记录已丢弃：删除之后不会留下无法删除的记录
+        QVERIFY(registry.remove(3));
+        QVERIFY(registry.remove(2));
+        QCOMPARE(registry.count(), 0);
+    }
+    HiddenWindowRegistry registry;
+    QVERIFY(registry.open(m_path));
+    QCOMPARE(registry.count(), 0);
+}
+
+void TestHiddenWindowRegistry::corruptFileStartsEmpty_data() {
+    QTest::addColumn<int>("damage");
+
+    QTest::newRow("bad magic") << 0;
+    QTest::newRow("bad version") << 1;
+    QTest::newRow("capacity beyond file") << 2;
+    QTest::newRow("count beyond capacity") << 3;
+    QTest::newRow("truncated header") << 4;
+    QTest::newRow("truncated records") << 5;
+}
+
+void TestHiddenWindowRegistry::corruptFileStartsEmpty() {
+    QFETCH(int, damage);
+    {
+        HiddenWindowRegistry registry;
+        QVERIFY(registry.open(m_path));
+        QVERIFY(registry.add(makeRecord(1)));
+    }
+    QByteArray data = readAll(m_path);
+    switch (damage) {
+    case 0:
+        data[0] = 'X';
+        break;
+    case 1:
+        writeAt<quint32>(data, 8, 99);
+        break;
+    case 2:
+        writeAt<quint32>(data, kCapacityOffset, 65);
+        break;
+    case 3:
+        writeAt<quint32>(data, kCountOffset, 65);
+        break;
+    case 4:
+        data.truncate(10);
+        break;
+    case 5:
+        data.truncate(journalBytes(10));
+        break;
+    }
+    QVERIFY(writeAll(m_path, data));
+
+    // 格式不符时重新初始化，仍可继续使用文件
+    HiddenWindowRegistry registry;
+    QVERIFY(registry.open(m_path));
+    QVERIFY(registry.isPersistent());
+    QCOMPARE(registry.count(), 0);
+    QVERIFY(registry.add(makeRecord(2)));
+    registry.close();
+
+    const QByteArray reset = readAll(m_path);
+    QCOMPARE(reset.size(), journalBytes(64));
+    QCOMPARE(reset.left(6), QByteArray("HWJRNL"));
+    QCOMPARE(readAt<quint32>(reset, kCountOffset), quint32(1));
+    QCOMPARE(readAt<quint64>(reset, kHeaderBytes), quint64(2));
+}
+
+void TestHiddenWindowRegistry::growsAndRemaps() {
+    constexpr quint64 kCount = 200;
+    {
+        HiddenWindowRegistry registry;
+        QVERIFY(registry.open(m_path));
+        for (quint64 id = 1; id <= kCount; ++id) {
+            QVERIFY(registry.add(makeRecord(id)));
+            // 扩容重新映射后，之前的记录仍可通过新的映射读到
+            QCOMPARE(registry.find(1)->pid, qint64(10));
+        }
+        QCOMPARE(registry.count(), int(kCount));
+        for (quint64 id = 1; id <= kCount; ++id) {
+            QCOMPARE(registry.find(id)->pid, qint64(id * 10));
+        }
+    }
+    // 容量按倍数增长：64 -> 128 -> 256
+    const QByteArray data = readAll(m_path);
+    QCOMPARE(data.size(), journalBytes(256));
+    QCOMPARE(readAt<quint32>(data, kCapacityOffset), quint32(256));
+    QCOMPARE(readAt<quint32>(data, kCountOffset), quint32(kCount));
+
+    HiddenWindowRegistry registry;
+    QVERIFY(registry.open(m_path));
+    QCOMPARE(registry.count(), int(kCount));
+    QCOMPARE(registry.find(kCount)->placement.left, qint32(kCount));
+}
+
+void TestHiddenWindowRegistry::lockedJournalIsNotShared() {
+    HiddenWindowRegistry owner;
+    QVERIFY(owner.open(m_path));
+    QVERIFY(owner.add(makeRecord(1)));
+
+    // 第二个实例不读取、也不改写被锁定的日志，只在内存中登记
+    HiddenWindowRegistry second;
+    QVERIFY(!second.open(m_path));
+    QVERIFY(!second.isPersistent());
+    QCOMPARE(second.count(), 0);
+    QVERIFY(second.add(makeRecord(2)));
+    QCOMPARE(owner.count(), 1);
+    QVERIFY(!owner.contains(2));
+
+    // 持有者关闭后锁被释放，其他实例可以接手并看到遗留的记录
+    owner.close();
+    QVERIFY(!QFile::exists(m_path + QStringLiteral(".lock")));
+    QVERIFY(second.open(m_path));
+    QVERIFY(second.isPersistent());
+    QCOMPARE(second.count(), 1);
+    QVERIFY(second.contains(1));
+}
+
+void TestHiddenWindowRegistry::staleLockIsTakenOver() {
+#ifdef Q_OS_WIN
+    QSKIP("Uses sleep(1) to obtain the PID of an exited process");
+#endif
+    {
+        HiddenWindowRegistry registry;
+        QVERIFY(registry.open(m_path));
+        QVERIFY(registry.add(makeRecord(7)));
+    }
+    // 上一个实例崩溃时留下的锁文件：其中的 PID 已不存在（主机名为空表示本机）
+    QProcess crashed;
+    crashed.start(QStringLiteral("sleep"), { QStringLiteral("60") });
+    QVERIFY(crashed.waitForStarted());
+    const qint64 deadPid = crashed.processId();
+    crashed.kill();
+    QVERIFY(crashed.waitForFinished());
+    QVERIFY(writeAll(m_path + QStringLiteral(".lock"), QByteArray::number(deadPid) + "\nhidewindow\n\n"));
+
+    HiddenWindowRegistry registry;
+    QVERIFY(registry.open(m_path));
+    QCOMPARE(registry.count(), 1);
+    QVERIFY(registry.contains(7));
+}
+
+QTEST_GUILESS_MAIN(TestHiddenWindowRegistry)
+#include "tst_hiddenwindowregistry.moc"
@@ -0,0 +1,375 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include "FakeWindowSystem.h"
+#include "HideProcess.h"
+
+namespace {
+// 日志路径为空：登记表只保存在内存中，测试之间互不影响
+std::unique_ptr<HideProcess> makeHideProcess(FakeWindowSystem*& system) {
+    auto owned = std::make_unique<FakeWindowSystem>();
+    system = owned.get();
+    return std::make_unique<HideProcess>(std::move(owned), QString());
+}
+} // namespace
+
+class TestHideProcess : public QObject {
+    Q_OBJECT
+private slots:
+    void hidePidsCommitsOneBatch();
+    void singlePidUsesIndexLookup();
+    void showPidsRestoresOnlyOwnWindows();
+    void hideProcessesIgnoresInvalidPids();
+    void stubbornWindowIsNotCounted();
+    void destroyedWindowIsDroppedOnShow();
+    void reentrantVisibilityEvents();
+    void destructorRestoresWindows();
+    void rulesHideExistingWindows();
+    void rulesHideNewAndRetitledWindows();
+    void exeRulesQueryImagePath();
+    void manuallyShownWindowIsExempt();
+    void removeRuleRestoresItsWindows();
+    void invalidRules();
+    void backgroundIndexBuildEmitsReady();
+    void hideWaitsForBackgroundIndexBuild();
+    void backgroundBuildWithoutWindowSystem();
+};
+
+void TestHideProcess::hidePidsCommitsOneBatch() {
+    FakeWindowSystem* system = nullptr;
+    auto hide = makeHideProcess(system);
+    const WindowId a1 = system->addWindow(10, "Main", QString(), true, true);
+    const WindowId a2 = system->addWindow(10, "Tool", QString(), true, true);
+    const WindowId b1 = system->addWindow(20, "Main", QString(), true, true);
+    const WindowId c1 = system->addWindow(30, "Main", QString(), true, true);
+    system->resetCalls();
+
+    QCOMPARE(hide->hidePids({ 10, 20, 40 }), 3);
+    // 所有可见性修改合并为一次提交，不重新遍历桌面
+    QCOMPARE(system->calls().batchVisible, 1);
+    QCOMPARE(system->calls().setVisible, 0);
+    QCOMPARE(system->calls().enumerate, 0);
+    QVERIFY(!system->isVisible(a1));
+    QVERIFY(!system->isVisible(a2));
+    QVERIFY(!system->isVisible(b1));
+    QVERIFY(system->isVisible(c1));
+    QCOMPARE(hide->hiddenWindows().count(), 3);
+
+    // 已隐藏的窗口不会被再次登记
+    QCOMPARE(hide->hidePids({ 10, 20 }), 0);
+    QCOMPARE(hide->hiddenWindows().count(), 3);
+
+    QCOMPARE(hide->showPids({ 10, 20 }), 3);
+    QVERIFY(system->isVisible(a1));
+    QVERIFY(system->isVisible(b1));
+    QCOMPARE(hide->hiddenWindows().count(), 0);
+    QCOMPARE(hide->showPids({}), 0);
+    QCOMPARE(hide->hidePids({}), 0);
+}
+
+void TestHideProcess::singlePidUsesIndexLookup() {
+    FakeWindowSystem* system = nullptr;
+    auto hide = makeHideProcess(system);
+    for (qint64 pid = 1; pid <= 20; ++pid) {
+        system->addWindow(pid, "Main", QString(), true, true);
+    }
+    system->resetCalls();
+
+    hide->hideProcess(7);
+    QCOMPARE(hide->hiddenWindows().count(), 1);
+    // 只查询了被隐藏的那个窗口
+    QCOMPARE(system->calls().placement, 1);
+    QCOMPARE(system->calls().enumerate, 0);
+
+    hide->showProcess(7);
+    QCOMPARE(hide->hiddenWindows().count(), 0);
+}
+
+void TestHideProcess::showPidsRestoresOnlyOwnWindows() {
+    FakeWindowSystem* system = nullptr;
+    auto hide = makeHideProcess(system);
+    const WindowId visible = system->addWindow(10, "Main", QString(), true, true);
+    // 进程自己隐藏的窗口不由本程序登记，也不会被还原
+    const WindowId ownHidden = system->addWindow(10, "Tray", QString(), false, true);
+
+    QCOMPARE(hide->hidePids({ 10 }), 1);
+    QVERIFY(hide->hiddenWindows().contains(visible));
+    QVERIFY(!hide->hiddenWindows().contains(ownHidden));
+
+    QCOMPARE(hide->showPids({ 10 }), 1);
+    QVERIFY(system->isVisible(visible));
+    QVERIFY(!system->isVisible(ownHidden));
+}
+
+void TestHideProcess::hideProcessesIgnoresInvalidPids() {
+    FakeWindowSystem* system = nullptr;
+    auto hide = makeHideProcess(system);
+    const WindowId a = system->addWindow(11, "Main", QString(), true, true);
+    const WindowId b = system->addWindow(12, "Main", QString(), true, true);
+
+    hide->hideProcesses({ QVariant(qint64(11)), QVariant(QStringLiteral("x")), QVariant(-5), QVariant(12) });
+    QVERIFY(!system->isVisible(a));
+    QVERIFY(!system->isVisible(b));
+
+    hide->showProcesses({ QVariant(11), QVariant(0) });
+    QVERIFY(system->isVisible(a));
+    QVERIFY(!system->isVisible(b));
+}
+
+void TestHideProcess::stubbornWindowIsNotCounted() {
+    FakeWindowSystem* system = nullptr;
+    auto hide = makeHideProcess(system);
+    const WindowId ok = system->addWindow(10, "Main", QString(), true, true);
+    const WindowId stuck = system->addWindow(10, "Hung", QString(), true, true);
+    system->setStubborn(stuck);
+
+    // 仍然可见的窗口撤销登记，不计入返回值
+    QCOMPARE(hide->hidePids({ 10 }), 1);
+    QVERIFY(hide->hiddenWindows().contains(ok));
+    QVERIFY(!hide->hiddenWindows().contains(stuck));
+    QVERIFY(system->isVisible(stuck));
+}
+
+void TestHideProcess::destroyedWindowIsDroppedOnShow() {
+    FakeWindowSystem* system = nullptr;
+    auto hide = makeHideProcess(system);
+    const WindowId kept = system->addWindow(10, "Main", QString(), true, true);
+    const WindowId gone = system->addWindow(10, "Dialog", QString(), true, true);
+    QCOMPARE(hide->hidePids({ 10 }), 2);
+
+    // 隐藏期间窗口被销毁且事件丢失：还原时记录作废，不计入还原数
+    system->destroyWindow(gone, false);
+    QCOMPARE(hide->showPids({ 10 }), 1);
+    QVERIFY(system->isVisible(kept));
+    QCOMPARE(hide->hiddenWindows().count(), 0);
+}
+
+void TestHideProcess::reentrantVisibilityEvents() {
+    FakeWindowSystem* system = nullptr;
+    auto hide = makeHideProcess(system);
+    system->setEmitVisibilityEvents(true);
+    for (int i = 0; i < 8; ++i) {
+        system->addWindow(100 + i % 2, "Main", QString(), true, true);
+    }
+
+    // 提交期间同步到达的可见性事件不影响计数
+    QCOMPARE(hide->hidePids({ 100, 101 }), 8);
+    QCOMPARE(hide->hiddenWindows().count(), 8);
+    QCOMPARE(hide->showAllHiddenWindows(), 8);
+    QCOMPARE(hide->hiddenWindows().count(), 0);
+}
+
+void TestHideProcess::destructorRestoresWindows() {
+    // 桌面由测试持有，HideProcess 析构之后仍可检查窗口状态
+    FakeWindowSystem desktop;
+    const WindowId id = desktop.addWindow(10, "Main");
+    {
+        HideProcess hide(std::make_unique<FakeWindowSystemRef>(&desktop), QString());
+        QCOMPARE(hide.hidePids({ 10 }), 1);
+        QVERIFY(!desktop.isVisible(id));
+    }
+    QVERIFY(desktop.isVisible(id));
+    QVERIFY(!desktop.eventHandler());
+}
+
+void TestHideProcess::rulesHideExistingWindows() {
+    FakeWindowSystem* system = nullptr;
+    auto hide = makeHideProcess(system);
+    const WindowId chrome = system->addWindow(10, "Chrome_WidgetWin_1", "Netflix - Google Chrome");
+    const WindowId mail = system->addWindow(10, "Chrome_WidgetWin_1", "Inbox - Google Chrome");
+    const WindowId other = system->addWindow(20, "Notepad", "Netflix notes");
+    hide->rebuildWindowIndex();
+
+    // 空行与注释行被跳过
+    QVERIFY(hide->setHideRules({ "# streaming", "", "class:Chrome_WidgetWin_1 && title:*Netflix*" }));
+    QCOMPARE(hide->hideRules(), QStringList{ "class:Chrome_WidgetWin_1 && title:*Netflix*" });
+    QVERIFY(!system->isVisible(chrome));
+    QVERIFY(system->isVisible(mail));
+    QVERIFY(system->isVisible(other));
+
+    // 清空规则不还原已隐藏的窗口
+    QVERIFY(hide->setHideRules({}));
+    QVERIFY(!system->isVisible(chrome));
+    QCOMPARE(hide->applyHideRules(), 0);
+}
+
+void TestHideProcess::rulesHideNewAndRetitledWindows() {
+    FakeWindowSystem* system = nullptr;
+    auto hide = makeHideProcess(system);
+    QSignalSpy autoHidden(hide.get(), &HideProcess::windowAutoHidden);
+    int hidden = -1;
+    QVERIFY(hide->addHideRule(QStringLiteral("title:*Netflix*"), nullptr, &hidden));
+    QCOMPARE(hidden, 0);
+    // 重复添加无操作
+    QVERIFY(hide->addHideRule(QStringLiteral(" title:*Netflix* ")));
+    QCOMPARE(hide->hideRules().size(), qsizetype(1));
+
+    const WindowId created = system->addWindow(30, "Main", "Netflix", true, true);
+    QVERIFY(!system->isVisible(created));
+    QCOMPARE(autoHidden.count(), 1);
+    QCOMPARE(autoHidden.at(0).at(0).toLongLong(), qint64(30));
+    QCOMPARE(autoHidden.at(0).at(1).toString(), QStringLiteral("title:*Netflix*"));
+
+    // 标题变化后才命中规则
+    const WindowId browser = system->addWindow(31, "Main", "Start page", true, true);
+    QVERIFY(system->isVisible(browser));
+    system->setTitle(browser, "Netflix - Browser");
+    QVERIFY(!system->isVisible(browser));
+    QCOMPARE(autoHidden.count(), 2);
+    QCOMPARE(hide->hiddenWindows().count(), 2);
+}
+
+void TestHideProcess::exeRulesQueryImagePath() {
+    FakeWindowSystem* system = nullptr;
+    auto hide = makeHideProcess(system);
+    system->setProcessImagePath(40, "C:\\Program Files\\Slack\\slack.exe");
+    system->setProcessImagePath(41, "C:/Games/doom.exe");
+    const WindowId slack = system->addWindow(40, "Main");
+    const WindowId slackTool = system->addWindow(40, "Tool");
+    const WindowId doom = system->addWindow(41, "Main");
+    const WindowId unknown = system->addWindow(42, "Main");
+    hide->rebuildWindowIndex();
+
+    int hidden = 0;
+    QVERIFY(hide->addHideRule(QStringLiteral("exe:SLACK.exe"), nullptr, &hidden));
+    QCOMPARE(hidden, 2);
+    QVERIFY(!system->isVisible(slack));
+    QVERIFY(!system->isVisible(slackTool));
+
+    QVERIFY(hide->addHideRule(QStringLiteral("path:c:\\games\\*"), nullptr, &hidden));
+    QCOMPARE(hidden, 1);
+    QVERIFY(!system->isVisible(doom));
+    QVERIFY(system->isVisible(unknown));
+}
+
+void TestHideProcess::manuallyShownWindowIsExempt() {
+    FakeWindowSystem* system = nullptr;
+    auto hide = makeHideProcess(system);
+    const WindowId id = system->addWindow(50, "Main", "Netflix");
+    hide->rebuildWindowIndex();
+    QVERIFY(hide->setHideRules({ "title:Netflix" }));
+    QVERIFY(!system->isVisible(id));
+
+    // 用户手动还原后不再被同一规则自动隐藏
+    QCOMPARE(hide->showPids({ 50 }), 1);
+    QVERIFY(system->isVisible(id));
+    QCOMPARE(hide->applyHideRules(), 0);
+    system->showWindowExternally(id, false);
+    system->showWindowExternally(id, true);
+    QVERIFY(system->isVisible(id));
+
+    // 窗口销毁后豁免随之清除；复用同一句柄的新窗口照常处理
+    system->destroyWindow(id);
+    const WindowId again = system->addWindow(51, "Main", "Netflix", true, true);
+    QVERIFY(!system->isVisible(again));
+}
+
+void TestHideProcess::removeRuleRestoresItsWindows() {
+    FakeWindowSystem* system = nullptr;
+    auto hide = makeHideProcess(system);
+    const WindowId netflix = system->addWindow(60, "Main", "Netflix");
+    const WindowId both = system->addWindow(61, "Player", "Netflix");
+    const WindowId manual = system->addWindow(62, "Main", "Netflix");
+    hide->rebuildWindowIndex();
+    QCOMPARE(hide->hidePids({ 62 }), 1);
+    QVERIFY(hide->setHideRules({ "title:Netflix", "class:Player" }));
+    QVERIFY(!system->isVisible(netflix));
+    QVERIFY(!system->isVisible(both));
+
+    // 只还原匹配被移除规则、且不再匹配其余规则的窗口；手动隐藏的窗口同样按属性判断
+    int restored = -1;
+    QVERIFY(hide->removeHideRule(QStringLiteral("title:Netflix"), &restored));
+    QCOMPARE(restored, 2);
+    QVERIFY(system->isVisible(netflix));
+    QVERIFY(!system->isVisible(both));
+    QVERIFY(system->isVisible(manual));
+    QCOMPARE(hide->hideRules(), QStringList{ "class:Player" });
+
+    QVERIFY(!hide->removeHideRule(QStringLiteral("title:Netflix"), &restored));
+}
+
+void TestHideProcess::invalidRules() {
+    FakeWindowSystem* system = nullptr;
+    auto hide = makeHideProcess(system);
+    const WindowId id = system->addWindow(70, "Main", "Netflix");
+    hide->rebuildWindowIndex();
+
+    QString error;
+    QVERIFY(!hide->addHideRule(QStringLiteral("pid:70"), &error));
+    QVERIFY(!error.isEmpty());
+    QVERIFY(hide->hideRules().isEmpty());
+
+    // 有错误的规则被忽略，其余规则照常生效
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("Ignoring hide rule"));
+    QVERIFY(!hide->setHideRules({ "bogus", "title:Netflix" }));
+    QCOMPARE(hide->hideRules(), QStringList{ "title:Netflix" });
+    QVERIFY(!system->isVisible(id));
+}
+
+void TestHideProcess::backgroundIndexBuildEmitsReady() {
+    FakeWindowSystem desktop;
+    const WindowId a = desktop.addWindow(10, "Main");
+    const WindowId b = desktop.addWindow(10, "Tool");
+    desktop.addWindow(20, "Main");
+    HideProcess hide(std::make_unique<FakeWindowSystemRef>(&desktop), QString(), HideProcess::IndexBuild::Background);
+    QSignalSpy ready(&hide, &HideProcess::windowIndexReady);
+    // 遍历结束后排队回到本线程合并，构造返回时索引一定尚未就绪
+    QVERIFY(!hide.isWindowIndexReady());
+
+    QTRY_COMPARE(ready.count(), 1);
+    QVERIFY(hide.isWindowIndexReady());
+    QCOMPARE(desktop.calls().enumerate, 1);
+    QCOMPARE(hide.hidePids({ 10 }), 2);
+    QVERIFY(!desktop.isVisible(a));
+    QVERIFY(!desktop.isVisible(b));
+    QCOMPARE(desktop.calls().enumerate, 1);
+    QCOMPARE(ready.count(), 1);
+}
+
+void TestHideProcess::hideWaitsForBackgroundIndexBuild() {
+    FakeWindowSystem desktop;
+    const WindowId id = desktop.addWindow(10, "Main");
+    {
+        HideProcess hide(std::make_unique<FakeWindowSystemRef>(&desktop), QString(), HideProcess::IndexBuild::Background);
+        QSignalSpy ready(&hide, &HideProcess::windowIndexReady);
+        // 不进入事件循环：隐藏请求同步等待遍历并合并，仍能看到所有窗口
+        QCOMPARE(hide.hidePids({ 10 }), 1);
+        QVERIFY(hide.isWindowIndexReady());
+        QCOMPARE(ready.count(), 1);
+        QVERIFY(!desktop.isVisible(id));
+
+        // 之后到达的线程结束通知被忽略，不会重复合并
+        QTest::qWait(20);
+        QCOMPARE(ready.count(), 1);
+        QCOMPARE(desktop.calls().enumerate, 1);
+    }
+    QVERIFY(desktop.isVisible(id));
+
+    // 析构等待仍在进行的遍历
+    {
+        HideProcess hide(std::make_unique<FakeWindowSystemRef>(&desktop), QString(), HideProcess::IndexBuild::Background);
+    }
+    QCOMPARE(desktop.calls().enumerate, 2);
+    QVERIFY(!desktop.eventHandler());
+}
+
+void TestHideProcess::backgroundBuildWithoutWindowSystem() {
+    HideProcess hide(std::unique_ptr<WindowSystem>(), QString(), HideProcess::IndexBuild::Background);
+    QSignalSpy ready(&hide, &HideProcess::windowIndexReady);
+    // 没有窗口系统时不启动后台线程，索引立即就绪
+    QVERIFY(hide.isWindowIndexReady());
+    QCOMPARE(hide.hidePids({ 10 }), 0);
+    QTest::qWait(10);
+    QCOMPARE(ready.count(), 0);
+}
+
+QTEST_GUILESS_MAIN(TestHideProcess)
+#include "tst_hideprocess.moc"
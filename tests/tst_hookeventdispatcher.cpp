@@ -0,0 +1,136 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include <QThread>
+#include "HookEventDispatcher.h"
+
+namespace {
+HookEvent keyEvent(quint32 vk, bool keyUp = false) {
+    HookEvent event;
+    event.vk = vk;
+    event.flags = keyUp ? HookEvent::KeyUp : 0;
+    event.timestamp = HookEventDispatcher::now();
+    return event;
+}
+} // namespace
+
+class TestHookEventDispatcher : public QObject {
+    Q_OBJECT
+private slots:
+    void deliversInOrderOnDispatcherThread();
+    void countsDroppedEventsWhenFull();
+    void dropOldestKeepsNewestEvents();
+    void wakesAfterIdle();
+    void stopAndRestart();
+};
+
+void TestHookEventDispatcher::deliversInOrderOnDispatcherThread() {
+    HookEventDispatcher dispatcher(256);
+    QList<quint32> received;
+    QThread* emitter = nullptr;
+    // 信号在分发线程发出，排队回到测试线程
+    connect(&dispatcher, &HookEventDispatcher::eventReceived, this, [&](const HookEvent& event) {
+        received.append(event.vk);
+    });
+    connect(&dispatcher, &HookEventDispatcher::eventReceived, &dispatcher, [&](const HookEvent&) {
+        emitter = QThread::currentThread();
+    }, Qt::DirectConnection);
+
+    dispatcher.start();
+    for (quint32 vk = 1; vk <= 100; ++vk) {
+        QVERIFY(dispatcher.post(keyEvent(vk)));
+    }
+    QTRY_COMPARE(received.size(), qsizetype(100));
+    for (int i = 0; i < received.size(); ++i) {
+        QCOMPARE(received.at(i), quint32(i + 1));
+    }
+    QVERIFY(emitter);
+    QVERIFY(emitter != QThread::currentThread());
+    QCOMPARE(dispatcher.postedCount(), quint64(100));
+    QCOMPARE(dispatcher.dispatchedCount(), quint64(100));
+    QCOMPARE(dispatcher.droppedCount(), quint64(0));
+    dispatcher.stop();
+}
+
+void TestHookEventDispatcher::countsDroppedEventsWhenFull() {
+    HookEventDispatcher dispatcher(8);
+    QCOMPARE(dispatcher.capacity(), std::size_t(8));
+    // 分发线程尚未启动，队列满后按默认策略丢弃新事件
+    for (quint32 vk = 0; vk < 12; ++vk) {
+        dispatcher.post(keyEvent(vk));
+    }
+    QCOMPARE(dispatcher.postedCount(), quint64(12));
+    QCOMPARE(dispatcher.droppedCount(), quint64(4));
+
+    QList<quint32> received;
+    connect(&dispatcher, &HookEventDispatcher::eventReceived, this, [&](const HookEvent& event) {
+        received.append(event.vk);
+    });
+    dispatcher.start();
+    QTRY_COMPARE(received.size(), qsizetype(8));
+    QCOMPARE(received.first(), quint32(0));
+    QCOMPARE(received.last(), quint32(7));
+    QCOMPARE(dispatcher.dispatchedCount(), quint64(8));
+}
+
+void TestHookEventDispatcher::dropOldestKeepsNewestEvents() {
+    HookEventDispatcher dispatcher(4);
+    dispatcher.setOverflowPolicy(HookEventDispatcher::OverflowPolicy::DropOldest);
+    QCOMPARE(dispatcher.overflowPolicy(), HookEventDispatcher::OverflowPolicy::DropOldest);
+    for (quint32 vk = 0; vk < 10; ++vk) {
+        QVERIFY(dispatcher.post(keyEvent(vk)));
+    }
+    QCOMPARE(dispatcher.droppedCount(), quint64(6));
+
+    QList<quint32> received;
+    connect(&dispatcher, &HookEventDispatcher::eventReceived, this, [&](const HookEvent& event) {
+        received.append(event.vk);
+    });
+    dispatcher.start();
+    QTRY_COMPARE(received.size(), qsizetype(4));
+    QCOMPARE(received, (QList<quint32>{ 6, 7, 8, 9 }));
+}
+
+void TestHookEventDispatcher::wakesAfterIdle() {
+    HookEventDispatcher dispatcher(16);
+    QList<HookEvent> received;
+    connect(&dispatcher, &HookEventDispatcher::eventReceived, this, [&](const HookEvent& event) {
+        received.append(event);
+    });
+    dispatcher.start();
+    // 让分发线程进入休眠，之后的事件必须把它唤醒
+    QTest::qWait(50);
+    dispatcher.post(keyEvent(0x41, true));
+    QTRY_COMPARE(received.size(), qsizetype(1));
+    QCOMPARE(received.first().vk, quint32(0x41));
+    QCOMPARE(received.first().flags, quint32(HookEvent::KeyUp));
+    QCOMPARE(received.first().binding, qint32(-1));
+}
+
+void TestHookEventDispatcher::stopAndRestart() {
+    HookEventDispatcher dispatcher(16);
+    int received = 0;
+    connect(&dispatcher, &HookEventDispatcher::eventReceived, this, [&](const HookEvent&) { ++received; });
+    dispatcher.stop(); // 未启动时无操作
+    dispatcher.start();
+    dispatcher.start(); // 重复启动无操作
+    dispatcher.post(keyEvent(1));
+    QTRY_COMPARE(received, 1);
+    dispatcher.stop();
+    dispatcher.stop();
+
+    dispatcher.start();
+    dispatcher.post(keyEvent(2));
+    QTRY_COMPARE(received, 2);
+}
+
+QTEST_GUILESS_MAIN(TestHookEventDispatcher)
+#include "tst_hookeventdispatcher.moc"
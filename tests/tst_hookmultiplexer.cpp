@@ -0,0 +1,296 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include <QThread>
+#include <memory>
+#include <vector>
+#include "HookMultiplexer.h"
+
+namespace {
+constexpr quint32 kVkA = 0x41;
+constexpr quint32 kVkB = 0x42;
+
+HookEvent keyEvent(quint32 vk) {
+    HookEvent event;
+    event.vk = vk;
+    event.timestamp = HookEventDispatcher::now();
+    return event;
+}
+
+HookMultiplexer::Subscription direct(HookMultiplexer::KeyFilter keys, HookMultiplexer::Handler handler) {
+    HookMultiplexer::Subscription subscription;
+    subscription.keys = keys;
+    subscription.handler = std::move(handler);
+    return subscription;
+}
+} // namespace
+
+// 多路复用器是进程内单例：每个用例结束时都必须退订干净
+class TestHookMultiplexer : public QObject {
+    Q_OBJECT
+private slots:
+    void cleanup();
+    void keyFilters();
+    void directFilterAndSwallow();
+    void queuedRunsOnContextThread();
+    void unsubscribeDropsPendingQueued();
+    void unsubscribeInsideCallback();
+    void invalidSubscription();
+    void unsubscribeWhileDelivering();
+    void concurrentSubscribersStress();
+};
+
+void TestHookMultiplexer::cleanup() {
+    QCOMPARE(HookMultiplexer::instance().subscriberCount(), 0);
+}
+
+void TestHookMultiplexer::keyFilters() {
+    QVERIFY(HookMultiplexer::allKeys().none());
+    const HookMultiplexer::KeyFilter filter = HookMultiplexer::keys({ kVkA, kVkB, 300 });
+    QCOMPARE(filter.count(), size_t(2));
+    QVERIFY(filter.test(kVkA));
+    QVERIFY(filter.test(kVkB));
+}
+
+void TestHookMultiplexer::directFilterAndSwallow() {
+    HookMultiplexer& hook = HookMultiplexer::instance();
+    QList<quint32> all;
+    QList<quint32> onlyA;
+    const int allId = hook.subscribe(direct(HookMultiplexer::allKeys(), [&](const HookEvent& event) {
+        all.append(event.vk);
+        return false;
+    }));
+    const int aId = hook.subscribe(direct(HookMultiplexer::keys({ kVkA }), [&](const HookEvent& event) {
+        onlyA.append(event.vk);
+        return true;
+    }));
+    QVERIFY(allId > 0);
+    QVERIFY(aId > allId);
+    QCOMPARE(hook.subscriberCount(), 2);
+
+    // 任一订阅者拦截即拦截，其余订阅者照常收到
+    QVERIFY(hook.deliver(keyEvent(kVkA)));
+    QVERIFY(!hook.deliver(keyEvent(kVkB)));
+    QVERIFY(!hook.deliver(keyEvent(0x1FF)));
+    QCOMPARE(all, (QList<quint32>{ kVkA, kVkB, 0x1FF }));
+    QCOMPARE(onlyA, QList<quint32>{ kVkA });
+
+    hook.unsubscribe(aId);
+    QVERIFY(!hook.deliver(keyEvent(kVkA)));
+    QCOMPARE(onlyA.size(), qsizetype(1));
+    hook.unsubscribe(aId); // 重复退订无操作
+    QCOMPARE(hook.subscriberCount(), 1);
+    hook.unsubscribe(allId);
+}
+
+void TestHookMultiplexer::queuedRunsOnContextThread() {
+    HookMultiplexer& hook = HookMultiplexer::instance();
+    QList<quint32> received;
+    QThread* thread = nullptr;
+    HookMultiplexer::Subscription subscription;
+    subscription.delivery = HookMultiplexer::Delivery::Queued;
+    subscription.context = this;
+    subscription.handler = [&](const HookEvent& event) {
+        received.append(event.vk);
+        thread = QThread::currentThread();
+        return true; // Queued 订阅者的返回值不起作用
+    };
+    const int id = hook.subscribe(subscription);
+
+    // 从另一个线程分发（模拟钩子线程），回调回到 context 所在线程
+    bool swallowed = true;
+    QThread* source = QThread::create([&]() { swallowed = hook.deliver(keyEvent(kVkA)); });
+    source->start();
+    source->wait();
+    delete source;
+    QVERIFY(!swallowed);
+    QVERIFY(received.isEmpty());
+    QTRY_COMPARE(received, QList<quint32>{ kVkA });
+    QCOMPARE(thread, QThread::currentThread());
+    hook.unsubscribe(id);
+}
+
+void TestHookMultiplexer::unsubscribeDropsPendingQueued() {
+    HookMultiplexer& hook = HookMultiplexer::instance();
+    int calls = 0;
+    HookMultiplexer::Subscription subscription;
+    subscription.delivery = HookMultiplexer::Delivery::Queued;
+    subscription.context = this;
+    subscription.handler = [&](const HookEvent&) { ++calls; return false; };
+    const int id = hook.subscribe(subscription);
+
+    hook.deliver(keyEvent(kVkA));
+    hook.deliver(keyEvent(kVkB));
+    // 已投递但尚未执行的事件在退订后丢弃
+    hook.unsubscribe(id);
+    QTest::qWait(20);
+    QCOMPARE(calls, 0);
+}
+
+void TestHookMultiplexer::unsubscribeInsideCallback() {
+    HookMultiplexer& hook = HookMultiplexer::instance();
+    int selfCalls = 0;
+    int otherCalls = 0;
+    int selfId = -1;
+    // 回调内退订自己：不能等待读者（自己就是读者），也不能影响本轮其他订阅者
+    selfId = hook.subscribe(direct(HookMultiplexer::allKeys(), [&](const HookEvent&) {
+        ++selfCalls;
+        hook.unsubscribe(selfId);
+        return false;
+    }));
+    const int otherId = hook.subscribe(direct(HookMultiplexer::allKeys(), [&](const HookEvent&) {
+        ++otherCalls;
+        return false;
+    }));
+
+    hook.deliver(keyEvent(kVkA));
+    hook.deliver(keyEvent(kVkB));
+    QCOMPARE(selfCalls, 1);
+    QCOMPARE(otherCalls, 2);
+    QCOMPARE(hook.subscriberCount(), 1);
+    hook.unsubscribe(otherId);
+}
+
+void TestHookMultiplexer::invalidSubscription() {
+    HookMultiplexer& hook = HookMultiplexer::instance();
+    QTest::ignoreMessage(QtWarningMsg, "Invalid hook subscription");
+    QCOMPARE(hook.subscribe(HookMultiplexer::Subscription()), -1);
+
+    HookMultiplexer::Subscription queued;
+    queued.delivery = HookMultiplexer::Delivery::Queued;
+    queued.handler = [](const HookEvent&) { return false; };
+    QTest::ignoreMessage(QtWarningMsg, "Invalid hook subscription");
+    QCOMPARE(hook.subscribe(queued), -1);
+}
+
+void TestHookMultiplexer::unsubscribeWhileDelivering() {
+    HookMultiplexer& hook = HookMultiplexer::instance();
+    std::atomic<bool> stop{ false };
+    std::atomic<bool> removed{ false };
+    std::atomic<int> lateCalls{ 0 };
+    std::atomic<int> delivered{ 0 };
+
+    QThread* source = QThread::create([&]() {
+        while (!stop.load()) {
+            hook.deliver(keyEvent(kVkA));
+            delivered.fetch_add(1);
+            QThread::yieldCurrentThread();
+        }
+    });
+    source->start();
+
+    // unsubscribe() 返回后回调不再执行；旧订阅表在读者离开后才释放
+    for (int round = 0; round < 200; ++round) {
+        removed.store(false);
+        const int id = hook.subscribe(direct(HookMultiplexer::allKeys(), [&](const HookEvent&) {
+            if (removed.load()) {
+                lateCalls.fetch_add(1);
+            }
+            return false;
+        }));
+        QThread::yieldCurrentThread();
+        hook.unsubscribe(id);
+        removed.store(true);
+    }
+    stop.store(true);
+    source->wait();
+    delete source;
+    QVERIFY(delivered.load() > 0);
+    QCOMPARE(lateCalls.load(), 0);
+}
+
+void TestHookMultiplexer::concurrentSubscribersStress() {
+    // 64 个线程反复订阅 / 退订，同时一个线程持续分发；timestamp 字段携带事件序号
+    constexpr int kSubscriberThreads = 64;
+    constexpr int kRounds = 50;
+    HookMultiplexer& hook = HookMultiplexer::instance();
+    std::atomic<bool> stop{ false };
+    std::atomic<quint64> nextSeq{ 0 }; // 下一个要分配的序号
+    std::atomic<quint64> doneSeq{ 0 }; // 此序号之前的事件都已分发完毕
+    std::atomic<int> lostEvents{ 0 };
+    std::atomic<int> lateCalls{ 0 };
+    std::atomic<int> failedSubscribes{ 0 };
+
+    QThread* source = QThread::create([&]() {
+        while (!stop.load()) {
+            HookEvent event = keyEvent(kVkA);
+            event.timestamp = nextSeq.fetch_add(1);
+            hook.deliver(event);
+            doneSeq.store(event.timestamp + 1);
+        }
+    });
+    source->start();
+
+    struct Lifetime {
+        std::vector<quint64> received; // 只由分发线程写入，退订返回后才读取
+        std::atomic<bool> removed{ false };
+    };
+
+    QList<QThread*> subscribers;
+    for (int t = 0; t < kSubscriberThreads; ++t) {
+        subscribers.append(QThread::create([&]() {
+            for (int round = 0; round < kRounds; ++round) {
+                auto lifetime = std::make_shared<Lifetime>();
+                const int id = hook.subscribe(direct(HookMultiplexer::allKeys(), [lifetime, &lateCalls](const HookEvent& event) {
+                    if (lifetime->removed.load()) {
+                        lateCalls.fetch_add(1);
+                    }
+                    lifetime->received.push_back(event.timestamp);
+                    return false;
+                }));
+                if (id < 0) {
+                    failedSubscribes.fetch_add(1);
+                    return;
+                }
+                // subscribe() 返回之后才分配序号的事件一定能看到新表
+                const quint64 first = nextSeq.load();
+                while (doneSeq.load() < first + 3) {
+                    QThread::yieldCurrentThread();
+                }
+                // 退订之前已完成的事件都必须收到
+                const quint64 last = doneSeq.load();
+                hook.unsubscribe(id);
+                lifetime->removed.store(true);
+
+                quint64 inRange = 0;
+                for (quint64 seq : lifetime->received) {
+                    inRange += seq >= first && seq < last;
+                }
+                if (inRange != last - first) {
+                    lostEvents.fetch_add(1);
+                }
+            }
+        }));
+    }
+    for (QThread* thread : subscribers) {
+        thread->start();
+    }
+    for (QThread* thread : subscribers) {
+        thread->wait();
+        delete thread;
+    }
+    // 最后一轮退订之后继续分发一段时间，捕捉迟到的回调
+    const quint64 tail = doneSeq.load() + 100;
+    while (doneSeq.load() < tail) {
+        QThread::yieldCurrentThread();
+    }
+    stop.store(true);
+    source->wait();
+    delete source;
+
+    QCOMPARE(failedSubscribes.load(), 0);
+    QCOMPARE(lostEvents.load(), 0);
+    QCOMPARE(lateCalls.load(), 0);
+    QCOMPARE(hook.subscriberCount(), 0);
+}
+
+QTEST_GUILESS_MAIN(TestHookMultiplexer)
+#include "tst_hookmultiplexer.moc"
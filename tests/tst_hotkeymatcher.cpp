@@ -0,0 +1,298 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include "HotkeyMatcher.h"
+
+namespace {
+constexpr std::uint32_t kVkC = 0x43;
+constexpr std::uint32_t kVkH = 0x48;
+constexpr std::uint32_t kVkK = 0x4B;
+constexpr std::uint64_t kMs = 1000ull * 1000;
+
+// 模拟 GetAsyncKeyState：只有列在这里的键视为按下
+bool g_held[256] = {};
+bool heldProbe(std::uint32_t vk) {
+    return vk < 256 && g_held[vk];
+}
+
+// 按下并抬起一个键，返回按下时的匹配结果
+HotkeyMatch tap(HotkeyMatcher& matcher, std::uint32_t vk, std::uint64_t timestamp) {
+    const HotkeyMatch match = matcher.feed(vk, true, timestamp);
+    matcher.feed(vk, false, timestamp);
+    return match;
+}
+} // namespace
+
+class TestHotkeyMatcher : public QObject {
+    Q_OBJECT
+private slots:
+    void init();
+    void singleStroke();
+    void rightModifiersCount();
+    void bindingsNeedCompile();
+    void unmappableSequence();
+    void chordMatches();
+    void chordTimesOut();
+    void chordMismatchRestarts();
+    void swallowsDownAndUp();
+    void shorterBindingWins();
+    void duplicateBindingIgnored();
+    void removeBinding();
+    void probeClearsStuckModifier();
+    void resetClearsState();
+};
+
+void TestHotkeyMatcher::init() {
+    std::fill(std::begin(g_held), std::end(g_held), false);
+}
+
+void TestHotkeyMatcher::singleStroke() {
+    HotkeyMatcher matcher;
+    const int id = matcher.addBinding(QKeySequence(Qt::CTRL | Qt::ALT | Qt::Key_H));
+    QVERIFY(id >= 0);
+    QCOMPARE(matcher.bindingCount(), 1);
+    matcher.compile();
+
+    // 没有修饰键时不命中
+    QCOMPARE(tap(matcher, kVkH, 0).bindingId, -1);
+
+    matcher.feed(KeyMap::Vk::LControl, true, 0);
+    QCOMPARE(tap(matcher, kVkH, 0).bindingId, -1); // 只有 Ctrl
+    matcher.feed(KeyMap::Vk::LMenu, true, 0);
+    QCOMPARE(matcher.currentModifiers(), std::uint8_t(HotkeyModifier::Ctrl | HotkeyModifier::Alt));
+    const HotkeyMatch match = tap(matcher, kVkH, 0);
+    QCOMPARE(match.bindingId, id);
+    QVERIFY(!match.swallow);
+    QVERIFY(!matcher.inChord());
+
+    // 多按一个 Shift 就不再是同一个组合键
+    matcher.feed(KeyMap::Vk::LShift, true, 0);
+    QCOMPARE(tap(matcher, kVkH, 0).bindingId, -1);
+}
+
+void TestHotkeyMatcher::rightModifiersCount() {
+    HotkeyMatcher matcher;
+    const int id = matcher.addBinding(QKeySequence(Qt::CTRL | Qt::Key_H));
+    matcher.compile();
+
+    // 左右修饰键合并为同一个修饰位，一侧抬起不影响另一侧
+    matcher.feed(KeyMap::Vk::LControl, true, 0);
+    matcher.feed(KeyMap::Vk::RControl, true, 0);
+    matcher.feed(KeyMap::Vk::LControl, false, 0);
+    QCOMPARE(matcher.currentModifiers(), std::uint8_t(HotkeyModifier::Ctrl));
+    QCOMPARE(tap(matcher, kVkH, 0).bindingId, id);
+    matcher.feed(KeyMap::Vk::RControl, false, 0);
+    QCOMPARE(matcher.currentModifiers(), std::uint8_t(0));
+}
+
+void TestHotkeyMatcher::bindingsNeedCompile() {
+    HotkeyMatcher matcher;
+    const int id = matcher.addBinding({ HotkeyStroke{ std::uint8_t(kVkH), HotkeyModifier::Alt } });
+    matcher.feed(KeyMap::Vk::LMenu, true, 0);
+    QCOMPARE(tap(matcher, kVkH, 0).bindingId, -1);
+    matcher.compile();
+    QCOMPARE(tap(matcher, kVkH, 0).bindingId, id);
+}
+
+void TestHotkeyMatcher::unmappableSequence() {
+    HotkeyMatcher matcher;
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("Cannot bind hotkey"));
+    QCOMPARE(matcher.addBinding(QKeySequence(Qt::CTRL | Qt::Key_Launch9)), -1);
+    // 修饰键本身不能作为一步
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("Cannot bind hotkey"));
+    QCOMPARE(matcher.addBinding(QKeySequence(Qt::CTRL | Qt::Key_Shift)), -1);
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("Cannot bind hotkey"));
+    QCOMPARE(matcher.addBinding(QKeySequence()), -1);
+    QCOMPARE(matcher.addBinding(QList<HotkeyStroke>()), -1);
+    QCOMPARE(matcher.bindingCount(), 0);
+
+    QList<HotkeyStroke> strokes;
+    QVERIFY(HotkeyMatcher::strokesFromSequence(QKeySequence(Qt::CTRL | Qt::Key_K, Qt::SHIFT | Qt::Key_F1), strokes));
+    QCOMPARE(strokes.size(), qsizetype(2));
+    QCOMPARE(strokes.at(0).vk, std::uint8_t(kVkK));
+    QCOMPARE(strokes.at(0).modifiers, std::uint8_t(HotkeyModifier::Ctrl));
+    QCOMPARE(strokes.at(1).vk, KeyMap::Vk::F1);
+    QCOMPARE(strokes.at(1).modifiers, std::uint8_t(HotkeyModifier::Shift));
+}
+
+void TestHotkeyMatcher::chordMatches() {
+    HotkeyMatcher matcher;
+    const int id = matcher.addBinding(QKeySequence(Qt::CTRL | Qt::Key_K, Qt::CTRL | Qt::Key_C));
+    matcher.compile();
+
+    matcher.feed(KeyMap::Vk::LControl, true, 0);
+    QCOMPARE(tap(matcher, kVkK, 10 * kMs).bindingId, -1);
+    QVERIFY(matcher.inChord());
+    QCOMPARE(tap(matcher, kVkC, 20 * kMs).bindingId, id);
+    QVERIFY(!matcher.inChord());
+}
+
+void TestHotkeyMatcher::chordTimesOut() {
+    HotkeyMatcher matcher;
+    matcher.setChordTimeout(100 * kMs);
+    QCOMPARE(matcher.chordTimeout(), 100 * kMs);
+    const int id = matcher.addBinding(QKeySequence(Qt::CTRL | Qt::Key_K, Qt::CTRL | Qt::Key_C));
+    matcher.compile();
+
+    matcher.feed(KeyMap::Vk::LControl, true, 0);
+    tap(matcher, kVkK, 0);
+    QVERIFY(matcher.inChord());
+    // 超过期限后第二步不再接续
+    QCOMPARE(tap(matcher, kVkC, 101 * kMs).bindingId, -1);
+    QVERIFY(!matcher.inChord());
+
+    tap(matcher, kVkK, 200 * kMs);
+    QCOMPARE(tap(matcher, kVkC, 300 * kMs).bindingId, id); // 恰好在期限上仍然有效
+}
+
+void TestHotkeyMatcher::chordMismatchRestarts() {
+    HotkeyMatcher matcher;
+    const int chord = matcher.addBinding(QKeySequence(Qt::CTRL | Qt::Key_K, Qt::CTRL | Qt::Key_C));
+    const int single = matcher.addBinding(QKeySequence(Qt::CTRL | Qt::Key_H));
+    matcher.compile();
+
+    matcher.feed(KeyMap::Vk::LControl, true, 0);
+    tap(matcher, kVkK, 0);
+    QVERIFY(matcher.inChord());
+    // 中途失配的按键作为新序列的第一步重新匹配
+    QCOMPARE(tap(matcher, kVkH, 0).bindingId, single);
+    QVERIFY(!matcher.inChord());
+
+    tap(matcher, kVkK, 0);
+    tap(matcher, kVkK, 0); // Ctrl+K 重新开始组合键
+    QVERIFY(matcher.inChord());
+    QCOMPARE(tap(matcher, kVkC, 0).bindingId, chord);
+}
+
+void TestHotkeyMatcher::swallowsDownAndUp() {
+    HotkeyMatcher matcher;
+    const int id = matcher.addBinding(QKeySequence(Qt::ALT | Qt::Key_K, Qt::ALT | Qt::Key_C), true);
+    matcher.compile();
+
+    matcher.feed(KeyMap::Vk::LMenu, true, 0);
+    // 要拦截的组合键，其前缀也被拦截
+    HotkeyMatch match = matcher.feed(kVkK, true, 0);
+    QCOMPARE(match.bindingId, -1);
+    QVERIFY(match.swallow);
+    QVERIFY(matcher.swallowsKey(kVkK));
+    QVERIFY(matcher.feed(kVkK, false, 0).swallow);
+    QVERIFY(!matcher.swallowsKey(kVkK));
+
+    match = matcher.feed(kVkC, true, 0);
+    QCOMPARE(match.bindingId, id);
+    QVERIFY(match.swallow);
+    // 自动重复的按下不再匹配，抬起仍按首次按下拦截，且只拦截一次
+    QCOMPARE(matcher.feed(kVkC, true, 0).bindingId, -1);
+    QVERIFY(matcher.swallowsKey(kVkC));
+    QVERIFY(matcher.feed(kVkC, false, 0).swallow);
+    QVERIFY(!matcher.feed(kVkC, false, 0).swallow);
+
+    // 修饰键本身从不拦截
+    QVERIFY(!matcher.feed(KeyMap::Vk::LMenu, false, 0).swallow);
+    QVERIFY(!matcher.feed(kVkH, true, 0).swallow);
+}
+
+void TestHotkeyMatcher::shorterBindingWins() {
+    {
+        HotkeyMatcher matcher;
+        const int shorter = matcher.addBinding(QKeySequence(Qt::CTRL | Qt::Key_K));
+        matcher.addBinding(QKeySequence(Qt::CTRL | Qt::Key_K, Qt::CTRL | Qt::Key_C));
+        QTest::ignoreMessage(QtWarningMsg, QRegularExpression("is shadowed by binding"));
+        matcher.compile();
+        matcher.feed(KeyMap::Vk::LControl, true, 0);
+        QCOMPARE(tap(matcher, kVkK, 0).bindingId, shorter);
+        QVERIFY(!matcher.inChord());
+    }
+    {
+        // 较长的绑定先登记时结果相同
+        HotkeyMatcher matcher;
+        matcher.addBinding(QKeySequence(Qt::CTRL | Qt::Key_K, Qt::CTRL | Qt::Key_C));
+        const int shorter = matcher.addBinding(QKeySequence(Qt::CTRL | Qt::Key_K));
+        QTest::ignoreMessage(QtWarningMsg, QRegularExpression("shadows longer chords"));
+        matcher.compile();
+        matcher.feed(KeyMap::Vk::LControl, true, 0);
+        QCOMPARE(tap(matcher, kVkK, 0).bindingId, shorter);
+        QVERIFY(!matcher.inChord());
+    }
+}
+
+void TestHotkeyMatcher::duplicateBindingIgnored() {
+    HotkeyMatcher matcher;
+    const int first = matcher.addBinding(QKeySequence(Qt::CTRL | Qt::Key_H));
+    const int second = matcher.addBinding(QKeySequence(Qt::CTRL | Qt::Key_H));
+    QVERIFY(first != second);
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("duplicates binding"));
+    matcher.compile();
+    matcher.feed(KeyMap::Vk::LControl, true, 0);
+    QCOMPARE(tap(matcher, kVkH, 0).bindingId, first);
+}
+
+void TestHotkeyMatcher::removeBinding() {
+    HotkeyMatcher matcher;
+    const int a = matcher.addBinding(QKeySequence(Qt::CTRL | Qt::Key_H));
+    const int b = matcher.addBinding(QKeySequence(Qt::CTRL | Qt::Key_K));
+    matcher.compile();
+
+    QVERIFY(matcher.removeBinding(a));
+    QVERIFY(!matcher.removeBinding(a));
+    matcher.compile();
+    QCOMPARE(matcher.bindingCount(), 1);
+    matcher.feed(KeyMap::Vk::LControl, true, 0);
+    QCOMPARE(tap(matcher, kVkH, 0).bindingId, -1);
+    QCOMPARE(tap(matcher, kVkK, 0).bindingId, b);
+
+    matcher.clearBindings();
+    matcher.compile();
+    QCOMPARE(matcher.bindingCount(), 0);
+    QCOMPARE(tap(matcher, kVkK, 0).bindingId, -1);
+}
+
+void TestHotkeyMatcher::probeClearsStuckModifier() {
+    HotkeyMatcher matcher;
+    const int plain = matcher.addBinding(QKeySequence(Qt::Key_F1));
+    const int withCtrl = matcher.addBinding(QKeySequence(Qt::CTRL | Qt::Key_F1));
+    matcher.compile();
+
+    // Ctrl 的抬起事件丢失：没有探测函数时按 Ctrl+F1 处理
+    matcher.feed(KeyMap::Vk::LControl, true, 0);
+    QCOMPARE(tap(matcher, KeyMap::Vk::F1, 0).bindingId, withCtrl);
+
+    // 探测到实际没有按住任何修饰键，重新同步后命中不带修饰键的绑定
+    matcher.setKeyStateProbe(&heldProbe);
+    QCOMPARE(tap(matcher, KeyMap::Vk::F1, 0).bindingId, plain);
+    QCOMPARE(matcher.currentModifiers(), std::uint8_t(0));
+
+    // 反过来，错过的按下事件也会被补上
+    g_held[KeyMap::Vk::RControl] = true;
+    QCOMPARE(tap(matcher, KeyMap::Vk::F1, 0).bindingId, withCtrl);
+    QCOMPARE(matcher.currentModifiers(), std::uint8_t(HotkeyModifier::Ctrl));
+}
+
+void TestHotkeyMatcher::resetClearsState() {
+    HotkeyMatcher matcher;
+    matcher.addBinding(QKeySequence(Qt::CTRL | Qt::Key_K, Qt::CTRL | Qt::Key_C), true);
+    matcher.compile();
+    matcher.feed(KeyMap::Vk::LControl, true, 0);
+    matcher.feed(kVkK, true, 0);
+    QVERIFY(matcher.inChord());
+    QVERIFY(matcher.swallowsKey(kVkK));
+
+    matcher.reset();
+    QVERIFY(!matcher.inChord());
+    QVERIFY(!matcher.swallowsKey(kVkK));
+    QCOMPARE(matcher.currentModifiers(), std::uint8_t(0));
+    // 超出范围的虚拟键直接忽略
+    QCOMPARE(matcher.feed(0x1FF, true, 0).bindingId, -1);
+    QVERIFY(!matcher.swallowsKey(0x1FF));
+}
+
+QTEST_APPLESS_MAIN(TestHotkeyMatcher)
+#include "tst_hotkeymatcher.moc"
@@ -0,0 +1,340 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include <QMutex>
+#include <QSemaphore>
+#include <QSignalSpy>
+#include <QStringList>
+#include <atomic>
+#include "ProcessIconProvider.h"
+
+namespace {
+// 按请求尺寸生成纯色图标；gated 时每次解码都阻塞到 release()
+class FakeIconLoader : public IconLoader {
+public:
+    explicit FakeIconLoader(bool gated = false)
+        : m_gated(gated)
+    {
+    }
+
+    QImage load(const QString& exePath, const QSize& size) override {
+        {
+            QMutexLocker locker(&m_mutex);
+            paths.append(exePath);
+        }
+        ++started;
+        if (m_gated) {
+            m_gate.acquire();
+        }
+        ++loads;
+        if (exePath.endsWith(QStringLiteral("noicon"))) {
+            return QImage();
+        }
+        QImage image(size.isValid() ? size : QSize(32, 32), QImage::Format_ARGB32);
+        image.fill(qHash(exePath) | 0xff000000u);
+        return image;
+    }
+
+    void release(int count = 1) { m_gate.release(count); }
+    QStringList loadedPaths() const {
+        QMutexLocker locker(&m_mutex);
+        return paths;
+    }
+
+    std::atomic<int> started{ 0 };
+    std::atomic<int> loads{ 0 };
+
+private:
+    bool m_gated;
+    QSemaphore m_gate;
+    mutable QMutex m_mutex;
+    QStringList paths;
+};
+
+// 收集回调结果；回调在工作线程或调用线程中执行
+struct Results {
+    QMutex mutex;
+    QList<QImage> images;
+    std::atomic<int> count{ 0 };
+
+    IconRequest::Callback callback() {
+        return [this](const QImage& image) {
+            QMutexLocker locker(&mutex);
+            images.append(image);
+            ++count;
+        };
+    }
+};
+
+QImage solidImage(int side) {
+    QImage image(side, side, QImage::Format_ARGB32);
+    image.fill(0xff336699u);
+    return image;
+}
+} // namespace
+
+class TestIconFetcher : public QObject {
+    Q_OBJECT
+private slots:
+    void cacheEvictsLeastRecentlyUsed();
+    void cacheSkipsOversizedImages();
+    void cacheReplaceAndBudget();
+    void emptyPathCompletesImmediately();
+    void loadsOnceThenHits();
+    void sizesAreCachedSeparately();
+    void concurrentRequestsJoin();
+    void cancelledRequestsSkipDecode();
+    void missingIconIsCached();
+    void providerDecodesPathAndFinishes();
+};
+
+void TestIconFetcher::cacheEvictsLeastRecentlyUsed() {
+    const QImage image = solidImage(16); // 1 KiB 像素
+    IconCache probe(1 << 20);
+    probe.insert(QStringLiteral("a"), image);
+    const qint64 cost = probe.bytes();
+    QVERIFY(cost > image.sizeInBytes());
+
+    // 预算正好容纳三个条目
+    IconCache cache(cost * 3);
+    cache.insert(QStringLiteral("a"), image);
+    cache.insert(QStringLiteral("b"), image);
+    cache.insert(QStringLiteral("c"), image);
+    QCOMPARE(cache.count(), 3);
+    QCOMPARE(cache.bytes(), cost * 3);
+
+    // 命中的条目移到最近使用的一端，淘汰的是 b
+    QImage found;
+    QVERIFY(cache.find(QStringLiteral("a"), found));
+    QCOMPARE(found, image);
+    cache.insert(QStringLiteral("d"), image);
+    QCOMPARE(cache.count(), 3);
+    QVERIFY(!cache.find(QStringLiteral("b"), found));
+    QVERIFY(cache.find(QStringLiteral("a"), found));
+    QVERIFY(cache.find(QStringLiteral("c"), found));
+    QVERIFY(cache.find(QStringLiteral("d"), found));
+    QVERIFY(cache.bytes() <= cache.budget());
+}
+
+void TestIconFetcher::cacheSkipsOversizedImages() {
+    IconCache cache(2048);
+    cache.insert(QStringLiteral("small"), solidImage(8));
+    QCOMPARE(cache.count(), 1);
+    const qint64 bytes = cache.bytes();
+    // 单个超预算的图像不缓存，也不挤掉已有条目
+    cache.insert(QStringLiteral("huge"), solidImage(64));
+    QCOMPARE(cache.count(), 1);
+    QCOMPARE(cache.bytes(), bytes);
+    QImage found;
+    QVERIFY(!cache.find(QStringLiteral("huge"), found));
+    QVERIFY(cache.find(QStringLiteral("small"), found));
+}
+
+void TestIconFetcher::cacheReplaceAndBudget() {
+    IconCache cache(1 << 20);
+    cache.insert(QStringLiteral("key"), solidImage(8));
+    const qint64 small = cache.bytes();
+    // 同一键重新插入时替换，字节数按新图像计算
+    cache.insert(QStringLiteral("key"), solidImage(32));
+    QCOMPARE(cache.count(), 1);
+    QVERIFY(cache.bytes() > small);
+    QImage found;
+    QVERIFY(cache.find(QStringLiteral("key"), found));
+    QCOMPARE(found.size(), QSize(32, 32));
+
+    for (int i = 0; i < 10; ++i) {
+        cache.insert(QStringLiteral("other-%1").arg(i), solidImage(8));
+    }
+    QCOMPARE(cache.count(), 11);
+    // 缩小预算立即淘汰；key 最久未用
+    cache.setBudget(small * 4);
+    QCOMPARE(cache.budget(), small * 4);
+    QVERIFY(cache.bytes() <= small * 4);
+    QVERIFY(!cache.find(QStringLiteral("key"), found));
+    QVERIFY(cache.find(QStringLiteral("other-9"), found));
+
+    cache.clear();
+    QCOMPARE(cache.count(), 0);
+    QCOMPARE(cache.bytes(), qint64(0));
+}
+
+void TestIconFetcher::emptyPathCompletesImmediately() {
+    auto loader = std::make_unique<FakeIconLoader>();
+    FakeIconLoader* fake = loader.get();
+    IconFetcher fetcher(std::move(loader), 2, 1 << 20);
+    Results results;
+    fetcher.request(QString(), QSize(16, 16), results.callback());
+    // 不经过线程池，返回前已回调
+    QCOMPARE(results.count.load(), 1);
+    QVERIFY(results.images.first().isNull());
+    QCOMPARE(fake->started.load(), 0);
+
+    // 没有解码器时同样立即以空图像回调
+    IconFetcher empty(nullptr, 1, 1 << 20);
+    empty.request(QStringLiteral("/usr/bin/bash"), QSize(16, 16), results.callback());
+    QCOMPARE(results.count.load(), 2);
+    QVERIFY(results.images.last().isNull());
+}
+
+void TestIconFetcher::loadsOnceThenHits() {
+    auto loader = std::make_unique<FakeIconLoader>();
+    FakeIconLoader* fake = loader.get();
+    IconFetcher fetcher(std::move(loader), 2, 1 << 20);
+    Results results;
+
+    fetcher.request(QStringLiteral("C:\\Windows\\notepad.exe"), QSize(16, 16), results.callback());
+    fetcher.waitForDone();
+    QCOMPARE(results.count.load(), 1);
+    QCOMPARE(results.images.first().size(), QSize(16, 16));
+
+    // 第二次直接命中缓存，在调用线程中回调
+    fetcher.request(QStringLiteral("C:\\Windows\\notepad.exe"), QSize(16, 16), results.callback());
+    QCOMPARE(results.count.load(), 2);
+    QCOMPARE(results.images.last(), results.images.first());
+    QCOMPARE(fake->loads.load(), 1);
+
+    const IconFetcher::Stats stats = fetcher.stats();
+    QCOMPARE(stats.hits, quint64(1));
+    QCOMPARE(stats.misses, quint64(1));
+    QCOMPARE(stats.loads, quint64(1));
+    QCOMPARE(stats.joined, quint64(0));
+    QCOMPARE(stats.cacheCount, 1);
+    QVERIFY(stats.cacheBytes > 0);
+}
+
+void TestIconFetcher::sizesAreCachedSeparately() {
+    auto loader = std::make_unique<FakeIconLoader>();
+    FakeIconLoader* fake = loader.get();
+    IconFetcher fetcher(std::move(loader), 1, 1 << 20);
+    Results results;
+    fetcher.request(QStringLiteral("/usr/bin/vim"), QSize(16, 16), results.callback());
+    fetcher.request(QStringLiteral("/usr/bin/vim"), QSize(32, 32), results.callback());
+    fetcher.waitForDone();
+    QCOMPARE(fake->loads.load(), 2);
+    QCOMPARE(fetcher.stats().cacheCount, 2);
+
+    // 预算缩小后旧条目被淘汰，再次请求会重新解码
+    fetcher.setCacheBudget(0);
+    QCOMPARE(fetcher.stats().cacheCount, 0);
+    fetcher.request(QStringLiteral("/usr/bin/vim"), QSize(16, 16), results.callback());
+    fetcher.waitForDone();
+    QCOMPARE(fake->loads.load(), 3);
+    QCOMPARE(results.count.load(), 3);
+}
+
+void TestIconFetcher::concurrentRequestsJoin() {
+    auto loader = std::make_unique<FakeIconLoader>(true);
+    FakeIconLoader* fake = loader.get();
+    IconFetcher fetcher(std::move(loader), 4, 1 << 20);
+    Results results;
+
+    // 同一图标的解码进行中，后续请求等待同一个结果
+    fetcher.request(QStringLiteral("/opt/app"), QSize(16, 16), results.callback());
+    QTRY_COMPARE(fake->started.load(), 1);
+    for (int i = 0; i < 9; ++i) {
+        fetcher.request(QStringLiteral("/opt/app"), QSize(16, 16), results.callback());
+    }
+    QCOMPARE(results.count.load(), 0);
+
+    fake->release();
+    fetcher.waitForDone();
+    QCOMPARE(results.count.load(), 10);
+    QCOMPARE(fake->loads.load(), 1);
+    for (const QImage& image : std::as_const(results.images)) {
+        QCOMPARE(image, results.images.first());
+    }
+    const IconFetcher::Stats stats = fetcher.stats();
+    QCOMPARE(stats.misses, quint64(10));
+    QCOMPARE(stats.joined, quint64(9));
+    QCOMPARE(stats.loads, quint64(1));
+}
+
+void TestIconFetcher::cancelledRequestsSkipDecode() {
+    auto loader = std::make_unique<FakeIconLoader>(true);
+    FakeIconLoader* fake = loader.get();
+    // 单线程：第一个解码阻塞时，其余任务在队列中等待
+    IconFetcher fetcher(std::move(loader), 1, 1 << 20);
+    Results results;
+    fetcher.request(QStringLiteral("/opt/blocker"), QSize(16, 16), results.callback());
+    QTRY_COMPARE(fake->started.load(), 1);
+
+    std::vector<std::shared_ptr<IconRequest>> requests;
+    for (int i = 0; i < 20; ++i) {
+        requests.push_back(fetcher.request(QStringLiteral("/opt/scrolled-%1").arg(i), QSize(16, 16), results.callback()));
+    }
+    // 委托滚出视图：除最后一个外全部取消
+    for (std::size_t i = 0; i + 1 < requests.size(); ++i) {
+        requests[i]->cancel();
+        QVERIFY(requests[i]->isCancelled());
+    }
+    fake->release(2);
+    fetcher.waitForDone();
+
+    // 取消的请求也会回调（空图像），但不解码
+    QCOMPARE(results.count.load(), 21);
+    QCOMPARE(fake->loads.load(), 2);
+    QCOMPARE(fake->loadedPaths(), (QStringList{ QStringLiteral("/opt/blocker"), QStringLiteral("/opt/scrolled-19") }));
+    const IconFetcher::Stats stats = fetcher.stats();
+    QCOMPARE(stats.skipped, quint64(19));
+    QCOMPARE(stats.loads, quint64(2));
+    int nullImages = 0;
+    for (const QImage& image : std::as_const(results.images)) {
+        nullImages += image.isNull();
+    }
+    QCOMPARE(nullImages, 19);
+}
+
+void TestIconFetcher::missingIconIsCached() {
+    auto loader = std::make_unique<FakeIconLoader>();
+    FakeIconLoader* fake = loader.get();
+    IconFetcher fetcher(std::move(loader), 1, 1 << 20);
+    Results results;
+    // 没有图标的可执行文件也记入缓存，不反复尝试
+    fetcher.request(QStringLiteral("/usr/bin/noicon"), QSize(16, 16), results.callback());
+    fetcher.waitForDone();
+    fetcher.request(QStringLiteral("/usr/bin/noicon"), QSize(16, 16), results.callback());
+    QCOMPARE(results.count.load(), 2);
+    QVERIFY(results.images.at(0).isNull());
+    QVERIFY(results.images.at(1).isNull());
+    QCOMPARE(fake->loads.load(), 1);
+    QCOMPARE(fetcher.stats().hits, quint64(1));
+}
+
+void TestIconFetcher::providerDecodesPathAndFinishes() {
+    auto loader = std::make_unique<FakeIconLoader>();
+    FakeIconLoader* fake = loader.get();
+    ProcessIconProvider provider(std::move(loader), 1, 1 << 20);
+
+    // QML 侧以 encodeURIComponent 编码路径
+    QQuickImageResponse* response = provider.requestImageResponse(
+        QStringLiteral("C%3A%5CProgram%20Files%5CApp%5Capp.exe"), QSize(24, 24));
+    QSignalSpy finished(response, &QQuickImageResponse::finished);
+    QTRY_COMPARE(finished.count(), 1);
+    QCOMPARE(fake->loadedPaths(), QStringList{ QStringLiteral("C:\\Program Files\\App\\app.exe") });
+
+    QQuickTextureFactory* factory = response->textureFactory();
+    QVERIFY(factory);
+    QCOMPARE(factory->image().size(), QSize(24, 24));
+    delete factory;
+
+    // 缓存命中时 finished 同样排队发出，不会在返回之前触发
+    QQuickImageResponse* cached = provider.requestImageResponse(
+        QStringLiteral("C%3A%5CProgram%20Files%5CApp%5Capp.exe"), QSize(24, 24));
+    QSignalSpy cachedFinished(cached, &QQuickImageResponse::finished);
+    QCOMPARE(cachedFinished.count(), 0);
+    QTRY_COMPARE(cachedFinished.count(), 1);
+    QCOMPARE(provider.fetcher().stats().hits, quint64(1));
+    delete response;
+    delete cached;
+}
+
+QTEST_GUILESS_MAIN(TestIconFetcher)
+#include "tst_iconfetcher.moc"
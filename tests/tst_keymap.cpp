@@ -0,0 +1,99 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include "KeyMap.h"
+
+class TestKeyMap : public QObject {
+    Q_OBJECT
+private slots:
+    void vkToQt_data();
+    void vkToQt();
+    void qtToVk_data();
+    void qtToVk();
+    void outOfRangeIsUnknown();
+    void reverseTableIsSorted();
+    void roundTrip();
+};
+
+void TestKeyMap::vkToQt_data() {
+    QTest::addColumn<int>("vk");
+    QTest::addColumn<Qt::Key>("key");
+
+    QTest::newRow("A") << 0x41 << Qt::Key_A;
+    QTest::newRow("Z") << 0x5A << Qt::Key_Z;
+    QTest::newRow("digit 7") << 0x37 << Qt::Key_7;
+    QTest::newRow("numpad 7") << KeyMap::Vk::Numpad0 + 7 << Qt::Key_7;
+    QTest::newRow("F1") << int(KeyMap::Vk::F1) << Qt::Key_F1;
+    QTest::newRow("F24") << KeyMap::Vk::F1 + 23 << Qt::Key_F24;
+    QTest::newRow("escape") << int(KeyMap::Vk::Escape) << Qt::Key_Escape;
+    QTest::newRow("snapshot") << int(KeyMap::Vk::Snapshot) << Qt::Key_Print;
+    QTest::newRow("left shift") << int(KeyMap::Vk::LShift) << Qt::Key_Shift;
+    QTest::newRow("right alt") << int(KeyMap::Vk::RMenu) << Qt::Key_Alt;
+    QTest::newRow("left win") << int(KeyMap::Vk::LWin) << Qt::Key_Meta;
+    QTest::newRow("play/pause") << int(KeyMap::Vk::MediaPlayPause) << Qt::Key_MediaTogglePlayPause;
+    QTest::newRow("mouse button") << int(KeyMap::Vk::LButton) << Qt::Key_unknown;
+    QTest::newRow("unassigned") << 0x07 << Qt::Key_unknown;
+}
+
+void TestKeyMap::vkToQt() {
+    QFETCH(int, vk);
+    QFETCH(Qt::Key, key);
+    QCOMPARE(KeyMap::qtKeyFromVk(static_cast<std::uint32_t>(vk)), key);
+}
+
+void TestKeyMap::qtToVk_data() {
+    QTest::addColumn<Qt::Key>("key");
+    QTest::addColumn<int>("vk");
+
+    QTest::newRow("A") << Qt::Key_A << 0x41;
+    // 同一 Qt::Key 对应多个虚拟键时取码值最小的：主键盘数字、通用修饰键
+    QTest::newRow("digit 0") << Qt::Key_0 << int(KeyMap::Vk::Digit0);
+    QTest::newRow("shift") << Qt::Key_Shift << int(KeyMap::Vk::Shift);
+    QTest::newRow("control") << Qt::Key_Control << int(KeyMap::Vk::Control);
+    QTest::newRow("meta") << Qt::Key_Meta << int(KeyMap::Vk::LWin);
+    QTest::newRow("F12") << Qt::Key_F12 << KeyMap::Vk::F1 + 11;
+    QTest::newRow("unmapped") << Qt::Key_Launch9 << 0;
+    QTest::newRow("unknown") << Qt::Key_unknown << 0;
+}
+
+void TestKeyMap::qtToVk() {
+    QFETCH(Qt::Key, key);
+    QFETCH(int, vk);
+    QCOMPARE(int(KeyMap::vkFromQtKey(key)), vk);
+}
+
+void TestKeyMap::outOfRangeIsUnknown() {
+    QCOMPARE(KeyMap::qtKeyFromVk(256), Qt::Key_unknown);
+    QCOMPARE(KeyMap::qtKeyFromVk(0xFFFFFFFFu), Qt::Key_unknown);
+}
+
+void TestKeyMap::reverseTableIsSorted() {
+    const auto& pairs = KeyMap::detail::kQtToVk;
+    for (std::size_t i = 1; i < pairs.size(); ++i) {
+        QVERIFY2(pairs[i - 1].qtKey <= pairs[i].qtKey, qPrintable(QString::number(i)));
+    }
+}
+
+void TestKeyMap::roundTrip() {
+    // 每个已映射的虚拟键经反向表回到同一 Qt::Key（虚拟键本身可能换成码值更小的那个）
+    for (std::uint32_t vk = 0; vk < 256; ++vk) {
+        const Qt::Key key = KeyMap::qtKeyFromVk(vk);
+        if (key == Qt::Key_unknown) {
+            continue;
+        }
+        const std::uint8_t reverse = KeyMap::vkFromQtKey(key);
+        QVERIFY2(reverse != 0 && reverse <= vk, qPrintable(QString::number(vk, 16)));
+        QCOMPARE(KeyMap::qtKeyFromVk(reverse), key);
+    }
+}
+
+QTEST_APPLESS_MAIN(TestKeyMap)
+#include "tst_keymap.moc"
@@ -0,0 +1,165 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include "KeyStateTracker.h"
+
+namespace {
+using Transition = KeyStateTracker::Transition;
+constexpr quint32 kVkA = 0x41;
+constexpr quint32 kVkB = 0x42;
+constexpr quint64 kMs = 1000ull * 1000;
+} // namespace
+
+class TestKeyStateTracker : public QObject {
+    Q_OBJECT
+private slots:
+    void defaults();
+    void transitions();
+    void repeatsCountedOnlyWhenSuppressed();
+    void outOfRangeKeys();
+    void debounce();
+    void debounceIsPerKey();
+    void fireOnRelease();
+    void resetKeepsCounters();
+};
+
+void TestKeyStateTracker::defaults() {
+    KeyStateTracker tracker;
+    QVERIFY(tracker.suppressRepeats());
+    QVERIFY(!tracker.fireOnRelease());
+    QCOMPARE(tracker.debounceInterval(), quint64(0));
+    QCOMPARE(tracker.firedCount(), quint64(0));
+}
+
+void TestKeyStateTracker::transitions() {
+    KeyStateTracker tracker;
+    // 钩子安装前已按下的键：只收到抬起
+    QCOMPARE(tracker.update(kVkA, false), Transition::StrayRelease);
+    QCOMPARE(tracker.update(kVkA, true), Transition::Press);
+    QVERIFY(tracker.isDown(kVkA));
+    QVERIFY(!tracker.isDown(kVkB));
+    QCOMPARE(tracker.update(kVkA, true), Transition::Repeat);
+    QCOMPARE(tracker.update(kVkA, true), Transition::Repeat);
+    QCOMPARE(tracker.update(kVkA, false), Transition::Release);
+    QVERIFY(!tracker.isDown(kVkA));
+    QCOMPARE(tracker.update(kVkA, true), Transition::Press);
+
+    // 跨越 64 位字边界的键码互不干扰
+    QCOMPARE(tracker.update(63, true), Transition::Press);
+    QCOMPARE(tracker.update(64, true), Transition::Press);
+    QCOMPARE(tracker.update(255, true), Transition::Press);
+    QCOMPARE(tracker.update(64, false), Transition::Release);
+    QVERIFY(tracker.isDown(63));
+    QVERIFY(tracker.isDown(255));
+}
+
+void TestKeyStateTracker::repeatsCountedOnlyWhenSuppressed() {
+    KeyStateTracker tracker;
+    tracker.update(kVkA, true);
+    tracker.update(kVkA, true);
+    tracker.update(kVkA, true);
+    QCOMPARE(tracker.suppressedRepeats(), quint64(2));
+
+    // 不丢弃时仍报告 Repeat，由调用者决定是否触发，但不计数
+    tracker.setSuppressRepeats(false);
+    QVERIFY(!tracker.suppressRepeats());
+    QCOMPARE(tracker.update(kVkA, true), Transition::Repeat);
+    QCOMPARE(tracker.suppressedRepeats(), quint64(2));
+}
+
+void TestKeyStateTracker::outOfRangeKeys() {
+    KeyStateTracker tracker;
+    QCOMPARE(tracker.update(256, true), Transition::Press);
+    QCOMPARE(tracker.update(256, true), Transition::Press); // 不记录状态
+    QCOMPARE(tracker.update(256, false), Transition::StrayRelease);
+    QVERIFY(!tracker.isDown(256));
+    QVERIFY(!tracker.trigger(256, 1, kMs));
+    qint32 payload = 0;
+    QVERIFY(!tracker.release(256, kMs, payload));
+}
+
+void TestKeyStateTracker::debounce() {
+    KeyStateTracker tracker;
+    tracker.setDebounceInterval(50 * kMs);
+    QCOMPARE(tracker.debounceInterval(), 50 * kMs);
+
+    QVERIFY(tracker.trigger(kVkA, 1, 1000 * kMs));
+    QVERIFY(!tracker.trigger(kVkA, 1, 1020 * kMs));
+    QVERIFY(!tracker.trigger(kVkA, 1, 1049 * kMs));
+    // 被去抖的触发不刷新时间起点
+    QVERIFY(tracker.trigger(kVkA, 1, 1050 * kMs));
+    QCOMPARE(tracker.suppressedBounces(), quint64(2));
+    QCOMPARE(tracker.firedCount(), quint64(2));
+
+    tracker.setDebounceInterval(0);
+    QVERIFY(tracker.trigger(kVkA, 1, 1051 * kMs));
+    QVERIFY(tracker.trigger(kVkA, 1, 1051 * kMs));
+    QCOMPARE(tracker.firedCount(), quint64(4));
+}
+
+void TestKeyStateTracker::debounceIsPerKey() {
+    KeyStateTracker tracker;
+    tracker.setDebounceInterval(50 * kMs);
+    QVERIFY(tracker.trigger(kVkA, 1, 1000 * kMs));
+    QVERIFY(tracker.trigger(kVkB, 2, 1001 * kMs));
+    QVERIFY(!tracker.trigger(kVkA, 1, 1002 * kMs));
+    QCOMPARE(tracker.suppressedBounces(), quint64(1));
+}
+
+void TestKeyStateTracker::fireOnRelease() {
+    KeyStateTracker tracker;
+    tracker.setFireOnRelease(true);
+    QVERIFY(tracker.fireOnRelease());
+
+    qint32 payload = -1;
+    // 没有按下时匹配的抬起不触发
+    QVERIFY(!tracker.release(kVkA, kMs, payload));
+    QCOMPARE(payload, -1);
+
+    // 按下只记录，抬起时带着记录的 payload 触发一次
+    QVERIFY(!tracker.trigger(kVkA, 7, kMs));
+    QVERIFY(!tracker.trigger(kVkA, 9, 2 * kMs)); // 自动重复覆盖为最后一次
+    QCOMPARE(tracker.firedCount(), quint64(0));
+    QVERIFY(tracker.release(kVkA, 3 * kMs, payload));
+    QCOMPARE(payload, 9);
+    QVERIFY(!tracker.release(kVkA, 4 * kMs, payload));
+    QCOMPARE(tracker.firedCount(), quint64(1));
+
+    // 负数 payload 也能原样取回
+    QVERIFY(!tracker.trigger(kVkB, -1, kMs));
+    QVERIFY(tracker.release(kVkB, kMs, payload));
+    QCOMPARE(payload, -1);
+
+    // 抬起时触发同样经过去抖
+    tracker.setDebounceInterval(50 * kMs);
+    tracker.trigger(kVkA, 7, 10 * kMs);
+    QVERIFY(!tracker.release(kVkA, 20 * kMs, payload));
+    QCOMPARE(tracker.suppressedBounces(), quint64(1));
+}
+
+void TestKeyStateTracker::resetKeepsCounters() {
+    KeyStateTracker tracker;
+    tracker.setFireOnRelease(true);
+    tracker.update(kVkA, true);
+    tracker.update(kVkA, true);
+    tracker.trigger(kVkA, 3, kMs);
+
+    tracker.reset();
+    QVERIFY(!tracker.isDown(kVkA));
+    qint32 payload = 0;
+    QVERIFY(!tracker.release(kVkA, kMs, payload));
+    QCOMPARE(tracker.update(kVkA, false), Transition::StrayRelease);
+    // 计数是累计值，不随状态一起清空
+    QCOMPARE(tracker.suppressedRepeats(), quint64(1));
+}
+
+QTEST_APPLESS_MAIN(TestKeyStateTracker)
+#include "tst_keystatetracker.moc"
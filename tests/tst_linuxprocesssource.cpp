@@ -0,0 +1,207 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include <QCoreApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QProcess>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <algorithm>
+#include <limits>
+#include "ProcessSource.h"
+
+namespace {
+// 第 3 到第 22 个字段：state ppid pgrp session tty_nr tpgid flags minflt cminflt majflt cmajflt
+// utime stime cutime cstime priority nice num_threads itrealvalue starttime
+QByteArray statLine(const QByteArray& comm, qint64 parentPid, quint64 startTime) {
+    return "4242 (" + comm + ") S " + QByteArray::number(parentPid) + " 4242 4242 0 -1 4194560 100 0 0 0 "
+        "5 3 0 0 20 0 1 0 " + QByteArray::number(startTime) + " 12345678 300 18446744073709551615\n";
+}
+} // namespace
+
+class TestLinuxProcessSource : public QObject {
+    Q_OBJECT
+private slots:
+    void parsePid_data();
+    void parsePid();
+    void parseStatReadsFields();
+    void parseStatCommWithSpacesAndParens_data();
+    void parseStatCommWithSpacesAndParens();
+    void parseStatRejectsTruncatedLine_data();
+    void parseStatRejectsTruncatedLine();
+    void exeLinkLength();
+    void queryOwnProcess();
+    void snapshotListsOwnProcess();
+    void deletedExecutableHasNoSuffix();
+};
+
+void TestLinuxProcessSource::parsePid_data() {
+    QTest::addColumn<QByteArray>("name");
+    QTest::addColumn<bool>("valid");
+    QTest::addColumn<qint64>("pid");
+
+    QTest::newRow("one") << QByteArray("1") << true << qint64(1);
+    QTest::newRow("large") << QByteArray("4194304") << true << qint64(4194304);
+    QTest::newRow("leading zero") << QByteArray("012") << false << qint64(0);
+    QTest::newRow("zero") << QByteArray("0") << false << qint64(0);
+    QTest::newRow("self") << QByteArray("self") << false << qint64(0);
+    QTest::newRow("trailing letter") << QByteArray("12a") << false << qint64(0);
+    QTest::newRow("empty") << QByteArray("") << false << qint64(0);
+    QTest::newRow("negative") << QByteArray("-5") << false << qint64(0);
+}
+
+void TestLinuxProcessSource::parsePid() {
+    QFETCH(QByteArray, name);
+    QFETCH(bool, valid);
+    QFETCH(qint64, pid);
+    qint64 parsed = 0;
+    QCOMPARE(LinuxProcfs::parsePid(name.constData(), parsed), valid);
+    QCOMPARE(parsed, pid);
+}
+
+void TestLinuxProcessSource::parseStatReadsFields() {
+    ProcessEntry entry;
+    QVERIFY(LinuxProcfs::parseStat(statLine("bash", 1000, 987654321).constData(), entry));
+    QCOMPARE(entry.name, QStringLiteral("bash"));
+    QCOMPARE(entry.parentPid, qint64(1000));
+    QCOMPARE(entry.startTime, quint64(987654321));
+}
+
+void TestLinuxProcessSource::parseStatCommWithSpacesAndParens_data() {
+    QTest::addColumn<QByteArray>("comm");
+
+    QTest::newRow("spaces") << QByteArray("Web Content");
+    QTest::newRow("close paren") << QByteArray("a) S 1 2");
+    QTest::newRow("nested parens") << QByteArray("(sd-pam)");
+    QTest::newRow("only paren") << QByteArray(")");
+    QTest::newRow("empty") << QByteArray("");
+}
+
+void TestLinuxProcessSource::parseStatCommWithSpacesAndParens() {
+    QFETCH(QByteArray, comm);
+    // comm 中的 ')' 与空格不能让后续字段错位：以最后一个 ')' 为界
+    ProcessEntry entry;
+    QVERIFY(LinuxProcfs::parseStat(statLine(comm, 77, 5555).constData(), entry));
+    QCOMPARE(entry.name, QString::fromUtf8(comm));
+    QCOMPARE(entry.parentPid, qint64(77));
+    QCOMPARE(entry.startTime, quint64(5555));
+}
+
+void TestLinuxProcessSource::parseStatRejectsTruncatedLine_data() {
+    QTest::addColumn<QByteArray>("stat");
+
+    const QByteArray full = statLine("cat", 1, 424242);
+    QTest::newRow("empty") << QByteArray("");
+    QTest::newRow("no comm") << QByteArray("4242 cat S 1");
+    QTest::newRow("unterminated comm") << QByteArray("4242 (cat S 1 4242");
+    QTest::newRow("after comm") << full.left(full.indexOf(')') + 1);
+    QTest::newRow("before starttime") << full.left(full.indexOf(" 424242"));
+    QTest::newRow("trailing space before starttime") << full.left(full.indexOf("424242"));
+}
+
+void TestLinuxProcessSource::parseStatRejectsTruncatedLine() {
+    QFETCH(QByteArray, stat);
+    ProcessEntry entry;
+    QVERIFY(!LinuxProcfs::parseStat(stat.constData(), entry));
+}
+
+void TestLinuxProcessSource::exeLinkLength() {
+    const QByteArray plain("/usr/bin/sleep");
+    QCOMPARE(LinuxProcfs::exeLinkLength(plain.constData(), plain.size(), 4096), qint64(plain.size()));
+
+    // 可执行文件被替换（例如升级时）后链接目标带上 " (deleted)"
+    const QByteArray deleted("/usr/bin/sleep (deleted)");
+    QCOMPARE(LinuxProcfs::exeLinkLength(deleted.constData(), deleted.size(), 4096), qint64(plain.size()));
+    const QByteArray onlySuffix(" (deleted)");
+    QCOMPARE(LinuxProcfs::exeLinkLength(onlySuffix.constData(), onlySuffix.size(), 4096), qint64(onlySuffix.size()));
+
+    // 填满缓冲区视为被截断；readlinkat 失败返回 -1
+    QCOMPARE(LinuxProcfs::exeLinkLength(plain.constData(), plain.size(), plain.size()), qint64(-1));
+    QCOMPARE(LinuxProcfs::exeLinkLength(plain.constData(), plain.size(), plain.size() + 1), qint64(plain.size()));
+    QCOMPARE(LinuxProcfs::exeLinkLength(plain.constData(), -1, 4096), qint64(-1));
+    QCOMPARE(LinuxProcfs::exeLinkLength(plain.constData(), 0, 4096), qint64(-1));
+}
+
+void TestLinuxProcessSource::queryOwnProcess() {
+    LinuxProcessSource source;
+    const qint64 pid = QCoreApplication::applicationPid();
+    ProcessEntry entry;
+    QVERIFY(source.query(pid, entry));
+    QCOMPARE(entry.pid, pid);
+    QVERIFY(entry.parentPid > 0);
+    QVERIFY(entry.startTime > 0);
+    QCOMPARE(entry.exePath, QFileInfo(QCoreApplication::applicationFilePath()).canonicalFilePath());
+    QCOMPARE(entry.name, QFileInfo(entry.exePath).fileName());
+
+    // 同一进程再次查询得到相同的键
+    ProcessEntry again;
+    QVERIFY(source.query(pid, again));
+    QVERIFY(again.key() == entry.key());
+
+    QVERIFY(!source.query(0, entry));
+    QVERIFY(!source.query(-1, entry));
+    QVERIFY(!source.query(std::numeric_limits<int>::max(), entry));
+}
+
+void TestLinuxProcessSource::snapshotListsOwnProcess() {
+    LinuxProcessSource source;
+    const qint64 pid = QCoreApplication::applicationPid();
+    std::atomic<bool> cancelled{ false };
+    QList<ProcessEntry> entries;
+    QVERIFY(source.snapshot(entries, cancelled));
+    QVERIFY(entries.size() > 1);
+    const auto self = std::find_if(entries.cbegin(), entries.cend(),
+        [pid](const ProcessEntry& entry) { return entry.pid == pid; });
+    QVERIFY(self != entries.cend());
+    QCOMPARE(self->exePath, QFileInfo(QCoreApplication::applicationFilePath()).canonicalFilePath());
+
+    std::vector<qint64> pids;
+    QVERIFY(source.listPids(pids));
+    QVERIFY(std::find(pids.begin(), pids.end(), pid) != pids.end());
+    QVERIFY(std::find(pids.begin(), pids.end(), qint64(1)) != pids.end());
+
+    // 已取消时立即停止
+    cancelled = true;
+    QVERIFY(!source.snapshot(entries, cancelled));
+}
+
+void TestLinuxProcessSource::deletedExecutableHasNoSuffix() {
+    const QString sleep = QStandardPaths::findExecutable(QStringLiteral("sleep"));
+    if (sleep.isEmpty()) {
+        QSKIP("sleep not found");
+    }
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString copy = dir.filePath(QStringLiteral("hw-replaced"));
+    QVERIFY(QFile::copy(sleep, copy));
+    QVERIFY(QFile::setPermissions(copy, QFile::ReadOwner | QFile::ExeOwner));
+
+    QProcess child;
+    child.start(copy, { QStringLiteral("60") });
+    QVERIFY(child.waitForStarted());
+    LinuxProcessSource source;
+    ProcessEntry entry;
+    const QString expected = QFileInfo(copy).canonicalFilePath();
+    QTRY_VERIFY(source.query(child.processId(), entry) && entry.exePath == expected);
+
+    // 运行中的可执行文件被删除：exe 链接变为 "<路径> (deleted)"
+    QVERIFY(QFile::remove(copy));
+    QVERIFY(source.query(child.processId(), entry));
+    QCOMPARE(entry.exePath, expected);
+    QCOMPARE(entry.name, QStringLiteral("hw-replaced"));
+
+    child.kill();
+    child.waitForFinished();
+}
+
+QTEST_GUILESS_MAIN(TestLinuxProcessSource)
+#include "tst_linuxprocesssource.moc"
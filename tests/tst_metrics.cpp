@@ -0,0 +1,238 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include <QThread>
+#include "HookMultiplexer.h"
+#include "Metrics.h"
+
+using Metrics::LatencyHistogram;
+
+namespace {
+constexpr int kThreads = 4;
+constexpr int kPerThread = 10000;
+} // namespace
+
+class TestMetrics : public QObject {
+    Q_OBJECT
+private slots:
+    void init();
+    void bucketIndex_data();
+    void bucketIndex();
+    void bucketBoundsAreTight();
+    void percentiles();
+    void emptySnapshot();
+    void concurrentRecord();
+    void counter();
+    void scopedTimer();
+    void registryDumpAndReset();
+    void hookDeliveryIsCounted();
+    void statsRefresh();
+};
+
+void TestMetrics::init() {
+    Metrics::registry().reset();
+}
+
+void TestMetrics::bucketIndex_data() {
+    QTest::addColumn<quint64>("value");
+    QTest::addColumn<int>("index");
+
+    // 32 以下每个值一个桶
+    QTest::newRow("0") << quint64(0) << 0;
+    QTest::newRow("31") << quint64(31) << 31;
+    QTest::newRow("32") << quint64(32) << 32;
+    QTest::newRow("63") << quint64(63) << 63;
+    // 64 起每个子桶宽 2，依此类推
+    QTest::newRow("64") << quint64(64) << 64;
+    QTest::newRow("65") << quint64(65) << 64;
+    QTest::newRow("66") << quint64(66) << 65;
+    QTest::newRow("128") << quint64(128) << 96;
+    QTest::newRow("overflow") << (quint64(1) << 50) << LatencyHistogram::kBucketCount - 1;
+    QTest::newRow("max") << ~quint64(0) << LatencyHistogram::kBucketCount - 1;
+}
+
+void TestMetrics::bucketIndex() {
+    QFETCH(quint64, value);
+    QFETCH(int, index);
+    QCOMPARE(LatencyHistogram::bucketIndex(value), index);
+}
+
+void TestMetrics::bucketBoundsAreTight() {
+    // 桶号随数值单调递增，上界不小于数值且相对误差不超过 1/32
+    int previous = 0;
+    for (quint64 value = 1; value < (quint64(1) << 40); value += value / 7 + 1) {
+        const int index = LatencyHistogram::bucketIndex(value);
+        QVERIFY(index >= previous);
+        previous = index;
+        const quint64 upper = LatencyHistogram::bucketUpperBound(index);
+        QVERIFY2(upper >= value, qPrintable(QString::number(value)));
+        QVERIFY2((upper - value) * LatencyHistogram::kSubBucketCount <= value, qPrintable(QString::number(value)));
+        QCOMPARE(LatencyHistogram::bucketIndex(upper), index);
+    }
+}
+
+void TestMetrics::percentiles() {
+    LatencyHistogram histogram("test");
+    QCOMPARE(QByteArray(histogram.name()), QByteArray("test"));
+    for (quint64 value = 1; value <= 100; ++value) {
+        histogram.record(value * 1000);
+    }
+    const Metrics::HistogramSnapshot snapshot = histogram.snapshot();
+    QCOMPARE(snapshot.count, quint64(100));
+    QCOMPARE(snapshot.sum, quint64(5050 * 1000));
+    QCOMPARE(snapshot.mean(), 50500.0);
+    QCOMPARE(snapshot.buckets.size(), size_t(LatencyHistogram::kBucketCount));
+
+    const auto upper = [](quint64 value) {
+        return LatencyHistogram::bucketUpperBound(LatencyHistogram::bucketIndex(value));
+    };
+    QCOMPARE(snapshot.percentile(0.0), upper(1000));
+    QCOMPARE(snapshot.percentile(0.5), upper(50000));
+    QCOMPARE(snapshot.percentile(0.99), upper(99000));
+    QCOMPARE(snapshot.percentile(1.0), upper(100000));
+    QCOMPARE(snapshot.max(), upper(100000));
+
+    histogram.reset();
+    QCOMPARE(histogram.snapshot().count, quint64(0));
+    QCOMPARE(histogram.snapshot().sum, quint64(0));
+}
+
+void TestMetrics::emptySnapshot() {
+    LatencyHistogram histogram("empty");
+    const Metrics::HistogramSnapshot snapshot = histogram.snapshot();
+    QCOMPARE(snapshot.count, quint64(0));
+    QCOMPARE(snapshot.mean(), 0.0);
+    QCOMPARE(snapshot.percentile(0.5), quint64(0));
+    QCOMPARE(snapshot.max(), quint64(0));
+}
+
+void TestMetrics::concurrentRecord() {
+    LatencyHistogram histogram("concurrent");
+    Metrics::Counter counter("concurrent");
+    QList<QThread*> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.append(QThread::create([&histogram, &counter, t]() {
+            for (int i = 0; i < kPerThread; ++i) {
+                histogram.record(quint64(t + 1));
+                counter.add();
+            }
+        }));
+    }
+    for (QThread* thread : threads) {
+        thread->start();
+    }
+    for (QThread* thread : threads) {
+        thread->wait();
+    }
+    qDeleteAll(threads);
+
+    // 分片合并后不丢样本
+    const Metrics::HistogramSnapshot snapshot = histogram.snapshot();
+    QCOMPARE(snapshot.count, quint64(kThreads * kPerThread));
+    QCOMPARE(snapshot.sum, quint64(kPerThread) * (kThreads * (kThreads + 1) / 2));
+    for (int t = 0; t < kThreads; ++t) {
+        QCOMPARE(snapshot.buckets[t + 1], quint64(kPerThread));
+    }
+    QCOMPARE(counter.value(), quint64(kThreads * kPerThread));
+}
+
+void TestMetrics::counter() {
+    Metrics::Counter counter("counter");
+    QCOMPARE(QByteArray(counter.name()), QByteArray("counter"));
+    QCOMPARE(counter.value(), quint64(0));
+    counter.add();
+    counter.add(41);
+    QCOMPARE(counter.value(), quint64(42));
+    counter.reset();
+    QCOMPARE(counter.value(), quint64(0));
+
+    const int shard = Metrics::currentShard();
+    QVERIFY(shard >= 0 && shard < Metrics::kShardCount);
+    QCOMPARE(Metrics::currentShard(), shard);
+}
+
+void TestMetrics::scopedTimer() {
+    LatencyHistogram histogram("timer");
+    const quint64 before = Metrics::now();
+    {
+        Metrics::ScopedTimer timer(histogram);
+        QThread::msleep(2);
+    }
+    const quint64 elapsed = Metrics::now() - before;
+    const Metrics::HistogramSnapshot snapshot = histogram.snapshot();
+    QCOMPARE(snapshot.count, quint64(1));
+    QVERIFY(snapshot.sum >= 2 * 1000 * 1000);
+    QVERIFY(snapshot.sum <= elapsed);
+}
+
+void TestMetrics::registryDumpAndReset() {
+    Metrics::Registry& metrics = Metrics::registry();
+    metrics.eventsSeen.add(3);
+    metrics.hideDuration.record(1500);
+
+    const QString dump = metrics.dump();
+    QVERIFY(dump.contains(QStringLiteral("hook.events_seen 3\n")));
+    QVERIFY(dump.contains(QStringLiteral("hook.events_dropped 0\n")));
+    QVERIFY(dump.contains(QStringLiteral("hide.duration count=1 ")));
+    QVERIFY(dump.contains(QStringLiteral("hide.hotkey_to_hidden count=0 ")));
+    QCOMPARE(dump.count(QLatin1Char('\n')), 8);
+
+    metrics.reset();
+    QCOMPARE(metrics.eventsSeen.value(), quint64(0));
+    QCOMPARE(metrics.hideDuration.snapshot().count, quint64(0));
+}
+
+void TestMetrics::hookDeliveryIsCounted() {
+    HookMultiplexer& hook = HookMultiplexer::instance();
+    HookMultiplexer::Subscription subscription;
+    subscription.handler = [](const HookEvent&) { return false; };
+    const int id = hook.subscribe(subscription);
+    HookEvent event;
+    event.vk = 0x41;
+    for (int i = 0; i < 5; ++i) {
+        hook.deliver(event);
+    }
+    hook.unsubscribe(id);
+
+    QCOMPARE(Metrics::registry().eventsSeen.value(), quint64(5));
+    QCOMPARE(Metrics::registry().hookTime.snapshot().count, quint64(5));
+}
+
+void TestMetrics::statsRefresh() {
+    MetricsStats stats;
+    QCOMPARE(stats.interval(), 1000);
+    QSignalSpy intervalSpy(&stats, &MetricsStats::intervalChanged);
+    stats.setInterval(0);
+    stats.setInterval(0);
+    QCOMPARE(stats.interval(), 0);
+    QCOMPARE(intervalSpy.count(), 1);
+
+    Metrics::registry().eventsMatched.add(2);
+    Metrics::registry().hookTime.record(20 * 1000);
+    QCOMPARE(stats.eventsMatched(), quint64(0)); // 只在刷新时更新
+
+    QSignalSpy updatedSpy(&stats, &MetricsStats::updated);
+    stats.refresh();
+    QCOMPARE(updatedSpy.count(), 1);
+    QCOMPARE(stats.eventsMatched(), quint64(2));
+    // 界面上的延迟以微秒为单位
+    const double expected = LatencyHistogram::bucketUpperBound(LatencyHistogram::bucketIndex(20 * 1000)) / 1000.0;
+    QCOMPARE(stats.hookP50(), expected);
+    QCOMPARE(stats.hookMax(), expected);
+    QVERIFY(stats.dump().contains(QStringLiteral("hook.events_matched 2")));
+
+    stats.reset();
+    QCOMPARE(stats.eventsMatched(), quint64(0));
+    QCOMPARE(stats.hookP99(), 0.0);
+}
+
+QTEST_GUILESS_MAIN(TestMetrics)
+#include "tst_metrics.moc"
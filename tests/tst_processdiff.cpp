@@ -0,0 +1,183 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include <QRandomGenerator>
+#include <QSet>
+#include <algorithm>
+#include "ProcessDiff.h"
+
+namespace {
+// 创建时间固定为 PID 的 10 倍，需要模拟 PID 复用时再单独构造
+std::vector<ProcessKey> keysOf(std::initializer_list<std::int64_t> pids) {
+    std::vector<ProcessKey> keys;
+    for (std::int64_t pid : pids) {
+        keys.push_back({ pid, static_cast<std::uint64_t>(pid) * 10 });
+    }
+    return keys;
+}
+
+// 操作序列的紧凑文本形式，例如 "R3-4 I0-1 C5-5"
+QString describe(const std::vector<ProcessDiffOp>& ops) {
+    static const char kKinds[] = { 'R', 'I', 'C', 'X' };
+    QStringList parts;
+    for (const ProcessDiffOp& op : ops) {
+        parts.append(QStringLiteral("%1%2-%3").arg(QChar(kKinds[op.kind])).arg(op.first).arg(op.last));
+    }
+    return parts.join(' ');
+}
+
+// 内容全部未变
+bool unchanged(int, int) {
+    return true;
+}
+
+// 把操作序列套用到 oldKeys 上，验证结果与 newKeys 一致
+std::vector<ProcessKey> apply(std::vector<ProcessKey> rows, const std::vector<ProcessKey>& newKeys,
+                              const std::vector<ProcessDiffOp>& ops) {
+    for (const ProcessDiffOp& op : ops) {
+        switch (op.kind) {
+        case ProcessDiffOp::Remove:
+            rows.erase(rows.begin() + op.first, rows.begin() + op.last + 1);
+            break;
+        case ProcessDiffOp::Insert:
+            rows.insert(rows.begin() + op.first, newKeys.begin() + op.first, newKeys.begin() + op.last + 1);
+            break;
+        case ProcessDiffOp::Change:
+            break;
+        case ProcessDiffOp::Reset:
+            return newKeys;
+        }
+    }
+    return rows;
+}
+} // namespace
+
+class TestProcessDiff : public QObject {
+    Q_OBJECT
+private slots:
+    void identicalListsProduceNoOps();
+    void removalsAreMergedBackToFront();
+    void insertionsAreMergedInNewOrder();
+    void changesUseNewRowNumbers();
+    void reorderedSurvivorsReset();
+    void reusedPidIsRemoveAndInsert();
+    void emptyLists();
+    void randomSnapshotsRoundTrip();
+    void keyHashSpreadsSequentialPids();
+};
+
+void TestProcessDiff::identicalListsProduceNoOps() {
+    const std::vector<ProcessKey> keys = keysOf({ 1, 2, 3 });
+    QVERIFY(diffProcessKeys(keys, keys, unchanged).empty());
+}
+
+void TestProcessDiff::removalsAreMergedBackToFront() {
+    const std::vector<ProcessKey> oldKeys = keysOf({ 1, 2, 3, 4, 5, 6, 7 });
+    const std::vector<ProcessKey> newKeys = keysOf({ 1, 4, 7 });
+    // 从后往前删除，前面的行号不受影响
+    const std::vector<ProcessDiffOp> ops = diffProcessKeys(oldKeys, newKeys, unchanged);
+    QCOMPARE(describe(ops), QStringLiteral("R4-5 R1-2"));
+    QVERIFY(apply(oldKeys, newKeys, ops) == newKeys);
+}
+
+void TestProcessDiff::insertionsAreMergedInNewOrder() {
+    const std::vector<ProcessKey> oldKeys = keysOf({ 3, 6 });
+    const std::vector<ProcessKey> newKeys = keysOf({ 1, 2, 3, 4, 5, 6, 7 });
+    const std::vector<ProcessDiffOp> ops = diffProcessKeys(oldKeys, newKeys, unchanged);
+    QCOMPARE(describe(ops), QStringLiteral("I0-1 I3-4 I6-6"));
+    QVERIFY(apply(oldKeys, newKeys, ops) == newKeys);
+}
+
+void TestProcessDiff::changesUseNewRowNumbers() {
+    const std::vector<ProcessKey> oldKeys = keysOf({ 1, 2, 3, 4, 5 });
+    const std::vector<ProcessKey> newKeys = keysOf({ 2, 3, 4, 5, 9 });
+    // 旧行 1、2、4 内容变化；删除之后它们位于新行 0、1、3
+    const QSet<int> changedOldRows = { 1, 2, 4 };
+    int mismatched = 0;
+    const std::vector<ProcessDiffOp> ops = diffProcessKeys(oldKeys, newKeys,
+        [&](int oldRow, int newIndex) {
+            mismatched += oldKeys[oldRow] != newKeys[newIndex];
+            return !changedOldRows.contains(oldRow);
+        });
+    QCOMPARE(describe(ops), QStringLiteral("R0-0 I4-4 C0-1 C3-3"));
+    QCOMPARE(mismatched, 0);
+    QVERIFY(apply(oldKeys, newKeys, ops) == newKeys);
+}
+
+void TestProcessDiff::reorderedSurvivorsReset() {
+    const std::vector<ProcessKey> oldKeys = keysOf({ 1, 2, 3 });
+    const std::vector<ProcessKey> newKeys = keysOf({ 0, 3, 2, 4 });
+    const std::vector<ProcessDiffOp> ops = diffProcessKeys(oldKeys, newKeys, unchanged);
+    QCOMPARE(describe(ops), QStringLiteral("X0-3"));
+}
+
+void TestProcessDiff::reusedPidIsRemoveAndInsert() {
+    const std::vector<ProcessKey> oldKeys = keysOf({ 1, 2, 3 });
+    std::vector<ProcessKey> newKeys = oldKeys;
+    newKeys[1].startTime = 999;
+    // 键不同即视为不同进程，即使 PID 相同
+    int compared = 0;
+    const std::vector<ProcessDiffOp> ops = diffProcessKeys(oldKeys, newKeys, [&](int, int) {
+        ++compared;
+        return true;
+    });
+    QCOMPARE(describe(ops), QStringLiteral("R1-1 I1-1"));
+    QCOMPARE(compared, 2);
+    QVERIFY(apply(oldKeys, newKeys, ops) == newKeys);
+}
+
+void TestProcessDiff::emptyLists() {
+    const std::vector<ProcessKey> none;
+    const std::vector<ProcessKey> some = keysOf({ 1, 2 });
+    QVERIFY(diffProcessKeys(none, none, unchanged).empty());
+    QCOMPARE(describe(diffProcessKeys(none, some, unchanged)), QStringLiteral("I0-1"));
+    QCOMPARE(describe(diffProcessKeys(some, none, unchanged)), QStringLiteral("R0-1"));
+}
+
+void TestProcessDiff::randomSnapshotsRoundTrip() {
+    // 随机的进程启动 / 退出（PID 有序，不会触发重置），套用操作后必须得到新快照
+    QRandomGenerator random(20260101);
+    std::vector<ProcessKey> current;
+    for (int round = 0; round < 200; ++round) {
+        std::vector<ProcessKey> next;
+        for (std::int64_t pid = 1; pid <= 300; ++pid) {
+            const bool alive = std::any_of(current.begin(), current.end(),
+                [pid](const ProcessKey& key) { return key.pid == pid; });
+            const int roll = random.bounded(100);
+            if (alive ? roll >= 10 : roll < 10) {
+                // 偶尔复用 PID：创建时间换成新的
+                const std::uint64_t startTime = alive && roll < 12 ? 1000 + round : static_cast<std::uint64_t>(pid) * 10;
+                next.push_back({ pid, startTime });
+            }
+        }
+        const std::vector<ProcessDiffOp> ops = diffProcessKeys(current, next, unchanged);
+        for (const ProcessDiffOp& op : ops) {
+            QVERIFY(op.kind != ProcessDiffOp::Reset);
+            QVERIFY(op.first <= op.last);
+        }
+        QVERIFY2(apply(current, next, ops) == next, qPrintable(QString::number(round)));
+        current = next;
+    }
+}
+
+void TestProcessDiff::keyHashSpreadsSequentialPids() {
+    // 连续 PID、相同创建时间时低位也要分散，否则 unordered_map 退化为少数桶
+    ProcessKeyHash hash;
+    QSet<std::size_t> buckets;
+    for (std::int64_t pid = 0; pid < 4096; ++pid) {
+        buckets.insert(hash({ pid, 0 }) & 1023);
+    }
+    QVERIFY2(buckets.size() > 900, qPrintable(QString::number(buckets.size())));
+    QVERIFY(hash({ 5, 1 }) != hash({ 5, 2 }));
+}
+
+QTEST_APPLESS_MAIN(TestProcessDiff)
+#include "tst_processdiff.moc"
@@ -0,0 +1,311 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include <QMutex>
+#include <QSet>
+#include <atomic>
+#include <map>
+#include "ProcessEventSource.h"
+
+namespace {
+ProcessEntry makeEntry(qint64 pid, const QString& name) {
+    ProcessEntry entry;
+    entry.pid = pid;
+    entry.parentPid = 1;
+    entry.startTime = static_cast<quint64>(pid) * 10;
+    entry.name = name;
+    return entry;
+}
+
+// 进程集合可在测试线程中修改，轮询线程通过 listPids / query 读取
+class MutableProcessSource : public ProcessSource {
+public:
+    bool snapshot(QList<ProcessEntry>& out, const std::atomic<bool>& cancelled) override {
+        QMutexLocker locker(&m_mutex);
+        out.clear();
+        for (const auto& [pid, entry] : m_entries) {
+            out.append(entry);
+        }
+        return !cancelled.load();
+    }
+    bool listPids(std::vector<qint64>& out) override {
+        QMutexLocker locker(&m_mutex);
+        ++polls;
+        out.clear();
+        for (const auto& [pid, entry] : m_entries) {
+            out.push_back(pid);
+        }
+        return true;
+    }
+    bool query(qint64 pid, ProcessEntry& entry) override {
+        QMutexLocker locker(&m_mutex);
+        // 列出之后、查询之前就已退出的进程
+        if (m_vanished.contains(pid)) {
+            return false;
+        }
+        const auto it = m_entries.find(pid);
+        if (it == m_entries.end()) {
+            return false;
+        }
+        entry = it->second;
+        return true;
+    }
+
+    void add(const ProcessEntry& entry) {
+        QMutexLocker locker(&m_mutex);
+        m_entries[entry.pid] = entry;
+    }
+    void remove(qint64 pid) {
+        QMutexLocker locker(&m_mutex);
+        m_entries.erase(pid);
+    }
+    void markVanished(qint64 pid) {
+        QMutexLocker locker(&m_mutex);
+        m_vanished.insert(pid);
+    }
+
+    std::atomic<int> polls{ 0 };
+
+private:
+    QMutex m_mutex;
+    std::map<qint64, ProcessEntry> m_entries;
+    QSet<qint64> m_vanished;
+};
+
+// 在测试线程收集事件：notify 只计数，事件在 QTRY 轮询时取出
+struct Collector {
+    std::atomic<int> notified{ 0 };
+    QList<ProcessEvent> events;
+    bool overflow = false;
+
+    std::function<void()> notify() {
+        return [this]() { ++notified; };
+    }
+    void drain(ProcessEventSource& source) {
+        overflow = source.takeEvents(events) || overflow;
+    }
+    // 先取出新到的事件再查找，供 QTRY_VERIFY 轮询
+    bool received(ProcessEventSource& source, ProcessEvent::Kind kind, qint64 pid) {
+        drain(source);
+        return contains(kind, pid);
+    }
+    bool contains(ProcessEvent::Kind kind, qint64 pid) const {
+        for (const ProcessEvent& event : events) {
+            if (event.kind == kind && event.entry.pid == pid) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+} // namespace
+
+class TestProcessEventSource : public QObject {
+    Q_OBJECT
+private slots:
+    void takeEventsPreservesOrder();
+    void notifiesOncePerBatch();
+    void overflowIsReportedOnce();
+    void queueLimitDropsNewEvents();
+    void stopDetachesNotify();
+    void forkStormFillsMetadata();
+    void pollingReportsStartsAndExits();
+    void pollingSkipsVanishedProcesses();
+    void pollingWithoutSourceFailsToStart();
+};
+
+void TestProcessEventSource::takeEventsPreservesOrder() {
+    FakeProcessEventSource source;
+    // 未启动时事件照样排队，只是不通知
+    source.emitStarted(makeEntry(5, "a"));
+    source.emitExited(3);
+    source.emitStarted(makeEntry(7, "b"));
+
+    QList<ProcessEvent> events;
+    QVERIFY(!source.takeEvents(events));
+    QCOMPARE(events.size(), qsizetype(3));
+    QCOMPARE(events.at(0).kind, ProcessEvent::Started);
+    QCOMPARE(events.at(0).entry.pid, qint64(5));
+    QCOMPARE(events.at(0).entry.name, QStringLiteral("a"));
+    QCOMPARE(events.at(1).kind, ProcessEvent::Exited);
+    QCOMPARE(events.at(1).entry.pid, qint64(3));
+    QCOMPARE(events.at(2).entry.pid, qint64(7));
+
+    // out 非空时追加而不是替换
+    source.emitExited(5);
+    QVERIFY(!source.takeEvents(events));
+    QCOMPARE(events.size(), qsizetype(4));
+    QCOMPARE(events.last().kind, ProcessEvent::Exited);
+
+    QList<ProcessEvent> empty;
+    QVERIFY(!source.takeEvents(empty));
+    QVERIFY(empty.isEmpty());
+}
+
+void TestProcessEventSource::notifiesOncePerBatch() {
+    FakeProcessEventSource source;
+    Collector collector;
+    QVERIFY(source.start(collector.notify()));
+    QVERIFY(source.isRunning());
+    // 重复启动无操作
+    QVERIFY(source.start(collector.notify()));
+
+    source.forkStorm(100, 50, 1, QStringLiteral("/usr/bin/sh"));
+    source.emitExited(100);
+    QCOMPARE(collector.notified.load(), 1);
+
+    collector.drain(source);
+    QCOMPARE(collector.events.size(), qsizetype(51));
+    // 取走之后的下一个事件重新通知
+    source.emitExited(101);
+    QCOMPARE(collector.notified.load(), 2);
+    source.stop();
+}
+
+void TestProcessEventSource::overflowIsReportedOnce() {
+    FakeProcessEventSource source;
+    Collector collector;
+    source.start(collector.notify());
+    source.emitStarted(makeEntry(1, "x"));
+    source.emitOverflow();
+    QCOMPARE(collector.notified.load(), 1);
+
+    QList<ProcessEvent> events;
+    QVERIFY(source.takeEvents(events));
+    QCOMPARE(events.size(), qsizetype(1));
+    events.clear();
+    QVERIFY(!source.takeEvents(events));
+
+    // 单独的溢出也会通知
+    source.emitOverflow();
+    QCOMPARE(collector.notified.load(), 2);
+    QVERIFY(source.takeEvents(events));
+    source.stop();
+}
+
+void TestProcessEventSource::queueLimitDropsNewEvents() {
+    FakeProcessEventSource source;
+    const int extra = 10;
+    source.forkStorm(1, int(ProcessEventSource::kQueueLimit) + extra, 1, QStringLiteral("/bin/true"));
+
+    QList<ProcessEvent> events;
+    QVERIFY(source.takeEvents(events));
+    QCOMPARE(events.size(), ProcessEventSource::kQueueLimit);
+    // 保留的是最早的事件，超出上限的新事件被丢弃
+    QCOMPARE(events.first().entry.pid, qint64(1));
+    QCOMPARE(events.last().entry.pid, qint64(ProcessEventSource::kQueueLimit));
+
+    events.clear();
+    source.emitExited(1);
+    QVERIFY(!source.takeEvents(events));
+    QCOMPARE(events.size(), qsizetype(1));
+}
+
+void TestProcessEventSource::stopDetachesNotify() {
+    FakeProcessEventSource source;
+    Collector collector;
+    source.stop(); // 未启动时无操作
+    source.start(collector.notify());
+    source.stop();
+    QVERIFY(!source.isRunning());
+
+    source.emitStarted(makeEntry(9, "late"));
+    QCOMPARE(collector.notified.load(), 0);
+    // 停止之后的事件仍在队列中，由调用方决定丢弃
+    collector.drain(source);
+    QCOMPARE(collector.events.size(), qsizetype(1));
+
+    // 重新启动后使用新的回调
+    Collector second;
+    source.start(second.notify());
+    source.emitExited(9);
+    QCOMPARE(second.notified.load(), 1);
+    QCOMPARE(collector.notified.load(), 0);
+    source.stop();
+}
+
+void TestProcessEventSource::forkStormFillsMetadata() {
+    FakeProcessEventSource source;
+    source.forkStorm(4000, 3, 77, QStringLiteral("/opt/tool/worker"));
+
+    QList<ProcessEvent> events;
+    source.takeEvents(events);
+    QCOMPARE(events.size(), qsizetype(3));
+    for (int i = 0; i < events.size(); ++i) {
+        const ProcessEntry& entry = events.at(i).entry;
+        QCOMPARE(events.at(i).kind, ProcessEvent::Started);
+        QCOMPARE(entry.pid, qint64(4000 + i));
+        QCOMPARE(entry.parentPid, qint64(77));
+        QCOMPARE(entry.startTime, quint64(4000 + i));
+        QCOMPARE(entry.name, QStringLiteral("worker"));
+        QCOMPARE(entry.exePath, QStringLiteral("/opt/tool/worker"));
+    }
+}
+
+void TestProcessEventSource::pollingReportsStartsAndExits() {
+    auto owned = std::make_unique<MutableProcessSource>();
+    MutableProcessSource* processes = owned.get();
+    processes->add(makeEntry(10, "init"));
+    processes->add(makeEntry(20, "shell"));
+    PollingProcessEventSource source(std::move(owned), 10);
+    Collector collector;
+    QVERIFY(source.start(collector.notify()));
+
+    // 第一轮只记录基准，已有进程不产生事件
+    QTRY_VERIFY(processes->polls.load() >= 2);
+    collector.drain(source);
+    QVERIFY(collector.events.isEmpty());
+
+    processes->add(makeEntry(15, "editor"));
+    processes->remove(20);
+    QTRY_VERIFY(collector.received(source, ProcessEvent::Exited, 20));
+    QTRY_VERIFY(collector.received(source, ProcessEvent::Started, 15));
+    QCOMPARE(collector.events.size(), qsizetype(2));
+    QVERIFY(!collector.overflow);
+    for (const ProcessEvent& event : std::as_const(collector.events)) {
+        if (event.kind == ProcessEvent::Started) {
+            QCOMPARE(event.entry.name, QStringLiteral("editor"));
+        }
+    }
+
+    source.stop();
+    QVERIFY(!source.isRunning());
+    const int polls = processes->polls.load();
+    QTest::qWait(50);
+    QCOMPARE(processes->polls.load(), polls);
+}
+
+void TestProcessEventSource::pollingSkipsVanishedProcesses() {
+    auto owned = std::make_unique<MutableProcessSource>();
+    MutableProcessSource* processes = owned.get();
+    PollingProcessEventSource source(std::move(owned), 10);
+    Collector collector;
+    source.start(collector.notify());
+    QTRY_VERIFY(processes->polls.load() >= 2);
+
+    // 查询失败的新 PID 不报告启动；随后的正常进程照常报告
+    processes->markVanished(30);
+    processes->add(makeEntry(30, "short-lived"));
+    processes->add(makeEntry(31, "normal"));
+    QTRY_VERIFY(collector.received(source, ProcessEvent::Started, 31));
+    QVERIFY(!collector.contains(ProcessEvent::Started, 30));
+    source.stop();
+}
+
+void TestProcessEventSource::pollingWithoutSourceFailsToStart() {
+    PollingProcessEventSource source(nullptr, 10);
+    QVERIFY(!source.start([]() {}));
+    QVERIFY(!source.isRunning());
+    source.stop();
+}
+
+QTEST_GUILESS_MAIN(TestProcessEventSource)
+#include "tst_processeventsource.moc"
@@ -0,0 +1,390 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include <QRandomGenerator>
+#include <QSignalSpy>
+#include "ProcessFilterModel.h"
+#include "ProcessListModel.h"
+
+namespace {
+ProcessEntry makeEntry(qint64 pid, const QString& name, const QString& exePath = QString()) {
+    ProcessEntry entry;
+    entry.pid = pid;
+    entry.parentPid = 1;
+    entry.startTime = static_cast<quint64>(pid) * 10;
+    entry.name = name;
+    entry.exePath = exePath.isEmpty() ? QStringLiteral("C:\\Windows\\System32\\") + name : exePath;
+    return entry;
+}
+
+ProcessEvent startedEvent(const ProcessEntry& entry) {
+    ProcessEvent event;
+    event.kind = ProcessEvent::Started;
+    event.entry = entry;
+    return event;
+}
+
+ProcessEvent exitedEvent(qint64 pid) {
+    ProcessEvent event;
+    event.kind = ProcessEvent::Exited;
+    event.entry.pid = pid;
+    return event;
+}
+
+QList<qint64> pidsOf(const ProcessFilterModel& model) {
+    QList<qint64> pids;
+    for (int row = 0; row < model.rowCount(); ++row) {
+        pids.append(model.data(model.index(row, 0), ProcessListModel::PidRole).toLongLong());
+    }
+    return pids;
+}
+
+// 对照实现：逐行检查名称与路径是否包含查询的每个词，结果按源行顺序
+QList<qint64> naiveFilter(const ProcessListModel& source, const QString& query) {
+    const QStringList terms = TrigramIndex::terms(query);
+    QList<qint64> pids;
+    for (int row = 0; row < source.rowCount(); ++row) {
+        const QModelIndex index = source.index(row);
+        const QString name = TrigramIndex::terms(index.data(ProcessListModel::NameRole).toString()).join(QLatin1Char(' '));
+        const QString path = TrigramIndex::terms(index.data(ProcessListModel::FileRole).toString()).join(QLatin1Char(' '));
+        const bool all = std::all_of(terms.begin(), terms.end(), [&](const QString& term) {
+            return name.contains(term) || path.contains(term);
+        });
+        if (all) {
+            pids.append(index.data(ProcessListModel::PidRole).toLongLong());
+        }
+    }
+    return pids;
+}
+
+void makeQuiet(ProcessListModel& model) {
+    model.setLiveUpdates(false);
+    model.setStatsInterval(0);
+}
+
+QList<ProcessEntry> sampleProcesses() {
+    return {
+        makeEntry(4, QStringLiteral("System")),
+        makeEntry(100, QStringLiteral("chrome.exe"), QStringLiteral("C:/Program Files/Google/Chrome/chrome.exe")),
+        makeEntry(101, QStringLiteral("chrome.exe"), QStringLiteral("C:/Program Files/Google/Chrome/chrome.exe")),
+        makeEntry(200, QStringLiteral("Code.exe"), QStringLiteral("C:\\Program Files\\Microsoft VS Code\\Code.exe")),
+        makeEntry(300, QStringLiteral("explorer.exe")),
+        makeEntry(400, QStringLiteral("notepad.exe")),
+    };
+}
+} // namespace
+
+class TestProcessFilterModel : public QObject {
+    Q_OBJECT
+private slots:
+    void emptyFilterShowsAll();
+    void filtersByNameAndPath_data();
+    void filtersByNameAndPath();
+    void narrowingOnlyRemovesRows();
+    void wideningOnlyInsertsRows();
+    void sourceInsertAndRemove();
+    void sourceDataChangeRefilters();
+    void sourceResetRebuilds();
+    void fuzzyRanksByScore();
+    void mapping();
+    void matchesNaiveFilter();
+};
+
+void TestProcessFilterModel::emptyFilterShowsAll() {
+    ProcessListModel source;
+    makeQuiet(source);
+    source.applySnapshot(sampleProcesses());
+    ProcessFilterModel filter;
+    QCOMPARE(filter.rowCount(), 0);
+    QCOMPARE(filter.columnCount(), 0);
+    filter.setSourceModel(&source);
+
+    QCOMPARE(filter.count(), 6);
+    QCOMPARE(filter.columnCount(), 1);
+    QCOMPARE(pidsOf(filter), (QList<qint64>{ 4, 100, 101, 200, 300, 400 }));
+    // 只有空白变化不改变结果
+    QSignalSpy reset(&filter, &ProcessFilterModel::modelReset);
+    QSignalSpy textChanged(&filter, &ProcessFilterModel::filterTextChanged);
+    filter.setFilterText(QStringLiteral("   "));
+    QCOMPARE(textChanged.count(), 1);
+    QCOMPARE(filter.count(), 6);
+    QCOMPARE(reset.count(), 0);
+}
+
+void TestProcessFilterModel::filtersByNameAndPath_data() {
+    QTest::addColumn<QString>("query");
+    QTest::addColumn<QList<qint64>>("pids");
+
+    QTest::newRow("name") << QStringLiteral("chrome") << QList<qint64>{ 100, 101 };
+    QTest::newRow("case insensitive") << QStringLiteral("CODE") << QList<qint64>{ 200 };
+    QTest::newRow("path only") << QStringLiteral("google") << QList<qint64>{ 100, 101 };
+    QTest::newRow("separator") << QStringLiteral("program files/microsoft") << QList<qint64>{ 200 };
+    QTest::newRow("two terms") << QStringLiteral("exe system32") << QList<qint64>{ 300, 400 };
+    QTest::newRow("short term") << QStringLiteral("x") << QList<qint64>{ 100, 101, 200, 300, 400 };
+    QTest::newRow("no match") << QStringLiteral("firefox") << QList<qint64>{};
+}
+
+void TestProcessFilterModel::filtersByNameAndPath() {
+    QFETCH(QString, query);
+    QFETCH(QList<qint64>, pids);
+    ProcessListModel source;
+    makeQuiet(source);
+    source.applySnapshot(sampleProcesses());
+    ProcessFilterModel filter;
+    filter.setSourceModel(&source);
+    QSignalSpy count(&filter, &ProcessFilterModel::countChanged);
+
+    filter.setFilterText(query);
+    QCOMPARE(filter.filterText(), query);
+    QCOMPARE(pidsOf(filter), pids);
+    QCOMPARE(filter.count(), int(pids.size()));
+    QCOMPARE(count.count(), pids.size() == 6 ? 0 : 1);
+}
+
+void TestProcessFilterModel::narrowingOnlyRemovesRows() {
+    ProcessListModel source;
+    makeQuiet(source);
+    source.applySnapshot(sampleProcesses());
+    ProcessFilterModel filter;
+    filter.setSourceModel(&source);
+    filter.setFilterText(QStringLiteral("e"));
+    QSignalSpy removed(&filter, &ProcessFilterModel::rowsRemoved);
+    QSignalSpy inserted(&filter, &ProcessFilterModel::rowsInserted);
+    QSignalSpy reset(&filter, &ProcessFilterModel::modelReset);
+
+    // 逐字输入：每一步都只删除不再命中的区间
+    const QString typed = QStringLiteral("explorer");
+    for (qsizetype length = 2; length <= typed.size(); ++length) {
+        filter.setFilterText(typed.left(length));
+        QCOMPARE(pidsOf(filter), naiveFilter(source, typed.left(length)));
+    }
+    QCOMPARE(pidsOf(filter), QList<qint64>{ 300 });
+    QVERIFY(removed.count() > 0);
+    QCOMPARE(inserted.count(), 0);
+    QCOMPARE(reset.count(), 0);
+
+    // 追加一个词同样只删除
+    filter.setFilterText(QStringLiteral("explorer zzz"));
+    QCOMPARE(filter.count(), 0);
+    QCOMPARE(inserted.count(), 0);
+    QCOMPARE(reset.count(), 0);
+}
+
+void TestProcessFilterModel::wideningOnlyInsertsRows() {
+    ProcessListModel source;
+    makeQuiet(source);
+    source.applySnapshot(sampleProcesses());
+    ProcessFilterModel filter;
+    filter.setSourceModel(&source);
+    filter.setFilterText(QStringLiteral("chrome.exe"));
+    QCOMPARE(filter.count(), 2);
+    QSignalSpy removed(&filter, &ProcessFilterModel::rowsRemoved);
+    QSignalSpy inserted(&filter, &ProcessFilterModel::rowsInserted);
+
+    // 退格：旧结果是新结果的子集，新增行以区间插入
+    filter.setFilterText(QStringLiteral(".exe"));
+    QCOMPARE(pidsOf(filter), (QList<qint64>{ 100, 101, 200, 300, 400 }));
+    QCOMPARE(removed.count(), 0);
+    QCOMPARE(inserted.count(), 1);
+    QCOMPARE(inserted.at(0).at(1).toInt(), 2);
+    QCOMPARE(inserted.at(0).at(2).toInt(), 4);
+
+    filter.setFilterText(QString());
+    QCOMPARE(filter.count(), 6);
+    QCOMPARE(removed.count(), 0);
+}
+
+void TestProcessFilterModel::sourceInsertAndRemove() {
+    ProcessListModel source;
+    makeQuiet(source);
+    source.applySnapshot(sampleProcesses());
+    ProcessFilterModel filter;
+    filter.setSourceModel(&source);
+    filter.setFilterText(QStringLiteral("chrome"));
+    QSignalSpy inserted(&filter, &ProcessFilterModel::rowsInserted);
+    QSignalSpy removed(&filter, &ProcessFilterModel::rowsRemoved);
+
+    // 新进程插在源模型中间；不命中的行不出现在代理中
+    source.applyEvents({
+        startedEvent(makeEntry(150, QStringLiteral("chrome.exe"), QStringLiteral("C:/Google/chrome.exe"))),
+        startedEvent(makeEntry(151, QStringLiteral("chrome.exe"), QStringLiteral("C:/Google/chrome.exe"))),
+        startedEvent(makeEntry(152, QStringLiteral("svchost.exe"))),
+    });
+    QCOMPARE(pidsOf(filter), (QList<qint64>{ 100, 101, 150, 151 }));
+    QCOMPARE(inserted.count(), 1);
+
+    source.applyEvents({ exitedEvent(101), exitedEvent(150), exitedEvent(400) });
+    QCOMPARE(pidsOf(filter), (QList<qint64>{ 100, 151 }));
+    QCOMPARE(removed.count(), 1);
+
+    // 代理的源行号随源模型的删除同步平移
+    for (int row = 0; row < filter.rowCount(); ++row) {
+        const QModelIndex sourceIndex = filter.mapToSource(filter.index(row, 0));
+        QCOMPARE(sourceIndex.data(ProcessListModel::PidRole), filter.index(row, 0).data(ProcessListModel::PidRole));
+    }
+    filter.setFilterText(QString());
+    QCOMPARE(pidsOf(filter), naiveFilter(source, QString()));
+}
+
+void TestProcessFilterModel::sourceDataChangeRefilters() {
+    ProcessListModel source;
+    makeQuiet(source);
+    source.applySnapshot(sampleProcesses());
+    ProcessFilterModel filter;
+    filter.setSourceModel(&source);
+    filter.setFilterText(QStringLiteral("notepad"));
+    QCOMPARE(pidsOf(filter), QList<qint64>{ 400 });
+
+    // exec 之后名称与路径变化：原来命中的行移出，新命中的行移入
+    ProcessEntry renamed = makeEntry(400, QStringLiteral("wordpad.exe"));
+    ProcessEntry becameNotepad = makeEntry(300, QStringLiteral("notepad.exe"));
+    source.applyEvents({ startedEvent(renamed), startedEvent(becameNotepad) });
+    QCOMPARE(pidsOf(filter), QList<qint64>{ 300 });
+
+    filter.setFilterText(QStringLiteral("pad"));
+    QCOMPARE(pidsOf(filter), (QList<qint64>{ 300, 400 }));
+}
+
+void TestProcessFilterModel::sourceResetRebuilds() {
+    ProcessListModel source;
+    makeQuiet(source);
+    source.applySnapshot(sampleProcesses());
+    ProcessFilterModel filter;
+    filter.setSourceModel(&source);
+    filter.setFilterText(QStringLiteral("exe"));
+    QSignalSpy reset(&filter, &ProcessFilterModel::modelReset);
+
+    // 整体重置的刷新路径
+    source.setIncrementalRefresh(false);
+    source.applySnapshot({ makeEntry(7, QStringLiteral("a.exe")), makeEntry(8, QStringLiteral("b.dll")) });
+    QCOMPARE(reset.count(), 1);
+    QCOMPARE(pidsOf(filter), QList<qint64>{ 7 });
+
+    // 换用另一组匹配角色
+    filter.setMatchRoles(ProcessListModel::FileRole, ProcessListModel::FileRole);
+    QCOMPARE(reset.count(), 2);
+    QCOMPARE(pidsOf(filter), QList<qint64>{ 7 });
+
+    filter.setSourceModel(nullptr);
+    QCOMPARE(filter.count(), 0);
+    source.applySnapshot(sampleProcesses());
+    QCOMPARE(filter.count(), 0);
+}
+
+void TestProcessFilterModel::fuzzyRanksByScore() {
+    ProcessListModel source;
+    makeQuiet(source);
+    source.applySnapshot(sampleProcesses());
+    ProcessFilterModel filter;
+    filter.setSourceModel(&source);
+    QSignalSpy fuzzyChanged(&filter, &ProcessFilterModel::fuzzyChanged);
+    QSignalSpy reset(&filter, &ProcessFilterModel::modelReset);
+
+    filter.setFuzzy(true);
+    filter.setFuzzy(true);
+    QVERIFY(filter.fuzzy());
+    QCOMPARE(fuzzyChanged.count(), 1);
+    QCOMPARE(filter.count(), 6);
+
+    // 名称中按顺序出现即命中，名称内的命中排在只在路径中命中的前面
+    filter.setFilterText(QStringLiteral("cde"));
+    QCOMPARE(pidsOf(filter).first(), qint64(200));
+    QCOMPARE(reset.count(), 2);
+    filter.setFilterText(QStringLiteral("zq"));
+    QCOMPARE(filter.count(), 0);
+
+    // 同分的行保持源模型顺序
+    filter.setFilterText(QStringLiteral("chrm"));
+    QCOMPARE(reset.count(), 4);
+    QCOMPARE(pidsOf(filter), (QList<qint64>{ 100, 101 }));
+
+    // 新进程按得分插入到应在的位置
+    source.applyEvents({ startedEvent(makeEntry(50, QStringLiteral("chrome.exe"))) });
+    QCOMPARE(pidsOf(filter), (QList<qint64>{ 50, 100, 101 }));
+
+    filter.setFuzzy(false);
+    QCOMPARE(pidsOf(filter), QList<qint64>{});
+}
+
+void TestProcessFilterModel::mapping() {
+    ProcessListModel source;
+    makeQuiet(source);
+    source.applySnapshot(sampleProcesses());
+    ProcessFilterModel filter;
+    filter.setSourceModel(&source);
+    filter.setFilterText(QStringLiteral("exe"));
+
+    const QModelIndex proxy = filter.index(1, 0);
+    QVERIFY(proxy.isValid());
+    QCOMPARE(filter.mapToSource(proxy), source.index(2));
+    QCOMPARE(filter.mapFromSource(source.index(2)), proxy);
+    // System 不命中
+    QVERIFY(!filter.mapFromSource(source.index(0)).isValid());
+    QVERIFY(!filter.mapToSource(QModelIndex()).isValid());
+    QVERIFY(!filter.index(filter.count(), 0).isValid());
+    QVERIFY(!filter.index(0, 1).isValid());
+    QVERIFY(!filter.parent(proxy).isValid());
+    QCOMPARE(filter.rowCount(proxy), 0);
+}
+
+void TestProcessFilterModel::matchesNaiveFilter() {
+    QRandomGenerator random(20260320);
+    static const QStringList names = {
+        QStringLiteral("chrome.exe"), QStringLiteral("Code.exe"), QStringLiteral("explorer.exe"),
+        QStringLiteral("svchost.exe"), QStringLiteral("notepad.exe"), QStringLiteral("bash"),
+    };
+    ProcessListModel source;
+    makeQuiet(source);
+    QList<ProcessEntry> entries;
+    for (qint64 pid = 1; pid <= 3000; ++pid) {
+        entries.append(makeEntry(pid * 2, names.at(random.bounded(int(names.size())))));
+    }
+    source.applySnapshot(entries);
+    ProcessFilterModel filter;
+    filter.setSourceModel(&source);
+
+    // 随机地输入、退格、替换查询，穿插源模型的增删；大批删除会触发索引重建
+    static const QStringList queries = {
+        QStringLiteral("c"), QStringLiteral("ch"), QStringLiteral("chrome"), QStringLiteral("e"),
+        QStringLiteral("exe"), QStringLiteral("ex pl"), QStringLiteral("system32 no"), QStringLiteral("o"),
+        QStringLiteral("host"), QString(),
+    };
+    for (int step = 0; step < 200; ++step) {
+        if (step == 100) {
+            // 删除大半的行，失效文档多于存活文档
+            source.applySnapshot(entries.mid(0, 200));
+        }
+        switch (random.bounded(3)) {
+        case 0: {
+            QList<ProcessEvent> events;
+            const int count = random.bounded(1, 50);
+            for (int i = 0; i < count; ++i) {
+                const qint64 pid = random.bounded(1, 6000);
+                events.append(random.bounded(2) == 0
+                    ? exitedEvent(pid)
+                    : startedEvent(makeEntry(pid, names.at(random.bounded(int(names.size()))))));
+            }
+            source.applyEvents(events);
+            break;
+        }
+        default: {
+            const QString& query = queries.at(random.bounded(int(queries.size())));
+            filter.setFilterText(query);
+            break;
+        }
+        }
+        QVERIFY2(pidsOf(filter) == naiveFilter(source, filter.filterText()),
+                 qPrintable(QStringLiteral("step %1, query \"%2\"").arg(step).arg(filter.filterText())));
+    }
+}
+
+QTEST_GUILESS_MAIN(TestProcessFilterModel)
+#include "tst_processfiltermodel.moc"
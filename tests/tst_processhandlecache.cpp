@@ -0,0 +1,271 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include <QProcess>
+#include <QThread>
+#include <atomic>
+#include <cerrno>
+#include "ProcessHandleCache.h"
+#include "ProcessSource.h"
+
+namespace {
+// 一个不会自行退出的子进程，用来观察进程退出后的行为
+bool startChild(QProcess& process) {
+#ifdef Q_OS_WIN
+    process.start(QStringLiteral("ping"), { QStringLiteral("-n"), QStringLiteral("60"), QStringLiteral("127.0.0.1") });
+#else
+    process.start(QStringLiteral("sleep"), { QStringLiteral("60") });
+#endif
+    return process.waitForStarted();
+}
+
+void stopChild(QProcess& process) {
+    process.kill();
+    process.waitForFinished();
+}
+
+qint64 selfPid() {
+    return QCoreApplication::applicationPid();
+}
+
+quint64 selfStartTime() {
+    ProcessEntry self;
+    return createDefaultProcessSource()->query(selfPid(), self) ? self.startTime : 0;
+}
+
+// 一个几乎不可能存在的 PID
+constexpr qint64 kMissingPid = 0x7ffffff0;
+} // namespace
+
+class TestProcessHandleCache : public QObject {
+    Q_OBJECT
+private slots:
+    void openVerifiesStartTime();
+    void handleObservesExit();
+    void acquireHitsCache();
+    void exitedProcessIsEvicted();
+    void fullCacheReturnsUncachedHandle();
+    void transientDoesNotFillCache();
+    void idleHandlesAreEvicted();
+    void removeAndClear();
+    void concurrentAcquire();
+};
+
+void TestProcessHandleCache::openVerifiesStartTime() {
+    const quint64 startTime = selfStartTime();
+    QVERIFY(startTime != 0);
+    // 打开时读取的创建时间与快照中的 startTime 同源
+    std::unique_ptr<ProcessHandle> handle = ProcessHandle::open(selfPid(), 0);
+    QVERIFY(handle);
+    QCOMPARE(handle->pid(), selfPid());
+    QCOMPARE(handle->startTime(), startTime);
+    QVERIFY(handle->isAlive());
+    QVERIFY(ProcessHandle::open(selfPid(), startTime));
+
+    // 创建时间不符视为 PID 已被复用
+    QVERIFY(!ProcessHandle::open(selfPid(), startTime + 1));
+    QVERIFY(!ProcessHandle::open(kMissingPid, 0));
+
+    // 失败时给出失败调用之后立即取得的错误码；创建时间不符不是系统错误
+    int error = -1;
+    QVERIFY(!ProcessHandle::open(selfPid(), startTime + 1, &error));
+    QCOMPARE(error, 0);
+    QVERIFY(!ProcessHandle::open(kMissingPid, 0, &error));
+#ifdef Q_OS_WIN
+    QCOMPARE(error, int(ERROR_INVALID_PARAMETER));
+#else
+    QCOMPARE(error, ESRCH);
+#endif
+}
+
+void TestProcessHandleCache::handleObservesExit() {
+    QProcess child;
+    QVERIFY(startChild(child));
+    std::unique_ptr<ProcessHandle> handle = ProcessHandle::open(child.processId(), 0);
+    QVERIFY(handle);
+    QVERIFY(handle->isAlive());
+    stopChild(child);
+    QTRY_VERIFY(!handle->isAlive());
+}
+
+void TestProcessHandleCache::acquireHitsCache() {
+    ProcessHandleCache cache(16, 60000);
+    const quint64 startTime = selfStartTime();
+    const std::shared_ptr<ProcessHandle> first = cache.acquire(selfPid(), startTime);
+    QVERIFY(first);
+    const std::shared_ptr<ProcessHandle> second = cache.acquire(ProcessKey{ selfPid(), startTime });
+    QCOMPARE(second.get(), first.get());
+    // startTime 为 0 时不校验
+    QCOMPARE(cache.acquire(selfPid()).get(), first.get());
+
+    ProcessHandleCache::Stats stats = cache.stats();
+    QCOMPARE(stats.opens, quint64(1));
+    QCOMPARE(stats.hits, quint64(2));
+    QCOMPARE(stats.open, 1);
+
+    // 创建时间不符时不返回缓存的句柄，也不重新打开
+    QVERIFY(!cache.acquire(selfPid(), startTime + 1));
+    QVERIFY(!cache.acquire(0));
+    QVERIFY(!cache.acquire(-4));
+    stats = cache.stats();
+    QCOMPARE(stats.opens, quint64(1));
+    QCOMPARE(stats.hits, quint64(2));
+    QCOMPARE(stats.open, 1);
+}
+
+void TestProcessHandleCache::exitedProcessIsEvicted() {
+    ProcessHandleCache cache(16, 60000);
+    QProcess child;
+    QVERIFY(startChild(child));
+    const qint64 pid = child.processId();
+    std::shared_ptr<ProcessHandle> handle = cache.acquire(pid);
+    QVERIFY(handle);
+    const quint64 startTime = handle->startTime();
+    handle.reset();
+    QCOMPARE(cache.stats().open, 1);
+
+    stopChild(child);
+    // 缓存的句柄已失效：丢弃并尝试重新打开，进程已不存在因此失败
+    QTRY_VERIFY(!cache.acquire(pid, startTime));
+    const ProcessHandleCache::Stats stats = cache.stats();
+    QCOMPARE(stats.open, 0);
+    QCOMPARE(stats.evictions, quint64(1));
+    QVERIFY(stats.failures >= 1);
+}
+
+void TestProcessHandleCache::fullCacheReturnsUncachedHandle() {
+    ProcessHandleCache cache(1, 60000);
+    QProcess child;
+    QVERIFY(startChild(child));
+    QVERIFY(cache.acquire(selfPid()));
+
+    // 缓存已满：新句柄照常返回，但不挤掉已缓存的句柄，释放即关闭
+    std::shared_ptr<ProcessHandle> uncached = cache.acquire(child.processId());
+    QVERIFY(uncached);
+    QVERIFY(uncached->isAlive());
+    std::weak_ptr<ProcessHandle> weak = uncached;
+    uncached.reset();
+    QVERIFY(weak.expired());
+
+    ProcessHandleCache::Stats stats = cache.stats();
+    QCOMPARE(stats.uncached, quint64(1));
+    QCOMPARE(stats.open, 1);
+    QCOMPARE(stats.evictions, quint64(0));
+    QVERIFY(cache.acquire(selfPid()));
+    QCOMPARE(cache.stats().hits, quint64(1));
+    stopChild(child);
+}
+
+void TestProcessHandleCache::transientDoesNotFillCache() {
+    ProcessHandleCache cache(16, 60000);
+    QProcess child;
+    QVERIFY(startChild(child));
+    std::shared_ptr<ProcessHandle> transient = cache.acquireTransient(child.processId());
+    QVERIFY(transient);
+    ProcessHandleCache::Stats stats = cache.stats();
+    QCOMPARE(stats.transient, quint64(1));
+    QCOMPARE(stats.open, 0);
+
+    // 已缓存的存活句柄直接复用
+    const std::shared_ptr<ProcessHandle> cached = cache.acquire(selfPid());
+    QCOMPARE(cache.acquireTransient(selfPid()).get(), cached.get());
+    QVERIFY(!cache.acquireTransient(selfPid(), cached->startTime() + 1));
+    QVERIFY(!cache.acquireTransient(kMissingPid));
+    QVERIFY(!cache.acquireTransient(0));
+    stats = cache.stats();
+    QCOMPARE(stats.transient, quint64(1));
+    QCOMPARE(stats.hits, quint64(1));
+    QCOMPARE(stats.failures, quint64(1));
+    QCOMPARE(stats.open, 1);
+
+    // 缓存命中但创建时间不符时错误码为 0，打开失败时为系统错误码
+    int error = -1;
+    QVERIFY(!cache.acquireTransient(selfPid(), cached->startTime() + 1, &error));
+    QCOMPARE(error, 0);
+    QVERIFY(!cache.acquireTransient(kMissingPid, 0, &error));
+    QVERIFY(error != 0);
+    stopChild(child);
+}
+
+void TestProcessHandleCache::idleHandlesAreEvicted() {
+    ProcessHandleCache cache(16, 20);
+    QCOMPARE(cache.idleMs(), 20);
+    std::shared_ptr<ProcessHandle> held = cache.acquire(selfPid());
+    QVERIFY(held);
+    QTest::qWait(50);
+    cache.evictIdle();
+    QCOMPARE(cache.stats().open, 0);
+    QCOMPARE(cache.stats().evictions, quint64(1));
+    // 仍在使用的句柄不受淘汰影响
+    QVERIFY(held->isAlive());
+
+    // acquire 时也会顺带淘汰超时的条目
+    QProcess child;
+    QVERIFY(startChild(child));
+    QVERIFY(cache.acquire(child.processId()));
+    QTest::qWait(50);
+    QVERIFY(cache.acquire(selfPid()));
+    QCOMPARE(cache.stats().open, 1);
+    QCOMPARE(cache.stats().evictions, quint64(2));
+    stopChild(child);
+}
+
+void TestProcessHandleCache::removeAndClear() {
+    ProcessHandleCache cache(16, 60000);
+    QProcess child;
+    QVERIFY(startChild(child));
+    std::weak_ptr<ProcessHandle> weak = cache.acquire(child.processId());
+    QVERIFY(cache.acquire(selfPid()));
+    QCOMPARE(cache.stats().open, 2);
+
+    // 进程退出事件到达时立即关闭句柄
+    cache.remove(child.processId());
+    QVERIFY(weak.expired());
+    QCOMPARE(cache.stats().open, 1);
+    cache.remove(kMissingPid);
+    QCOMPARE(cache.stats().evictions, quint64(1));
+
+    cache.clear();
+    QCOMPARE(cache.stats().open, 0);
+    QCOMPARE(cache.stats().evictions, quint64(2));
+    stopChild(child);
+}
+
+void TestProcessHandleCache::concurrentAcquire() {
+    ProcessHandleCache cache(16, 60000);
+    const quint64 startTime = selfStartTime();
+    std::atomic<int> failures{ 0 };
+    std::vector<QThread*> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.push_back(QThread::create([&]() {
+            for (int i = 0; i < 2000; ++i) {
+                const std::shared_ptr<ProcessHandle> handle = cache.acquire(selfPid(), startTime);
+                if (!handle || handle->startTime() != startTime) {
+                    ++failures;
+                }
+            }
+        }));
+        threads.back()->start();
+    }
+    for (QThread* thread : threads) {
+        thread->wait();
+        delete thread;
+    }
+    QCOMPARE(failures.load(), 0);
+    // 并发打开同一进程时以后完成者为准，缓存中始终只有一个条目
+    const ProcessHandleCache::Stats stats = cache.stats();
+    QCOMPARE(stats.open, 1);
+    QCOMPARE(stats.hits + stats.opens, quint64(8000));
+    QVERIFY(stats.opens <= 4);
+}
+
+QTEST_GUILESS_MAIN(TestProcessHandleCache)
+#include "tst_processhandlecache.moc"
@@ -0,0 +1,772 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include <QMutex>
+#include <QPointer>
+#include <QSignalSpy>
+#include <QWaitCondition>
+#include <array>
+#include <atomic>
+#include "ProcessListModel.h"
+
+namespace {
+ProcessEntry makeEntry(qint64 pid, const QString& name, qint64 parentPid = 1) {
+    ProcessEntry entry;
+    entry.pid = pid;
+    entry.parentPid = parentPid;
+    entry.startTime = static_cast<quint64>(pid) * 10;
+    entry.name = name;
+    entry.exePath = name.isEmpty() ? QString() : QStringLiteral("/usr/bin/") + name;
+    return entry;
+}
+
+// 记录每一次系统查询的快照提供者，用来确认读取角色时不再访问系统
+class CountingProcessSource : public ProcessSource {
+public:
+    explicit CountingProcessSource(const QList<ProcessEntry>& entries)
+        : m_entries(entries)
+    {
+    }
+
+    bool snapshot(QList<ProcessEntry>& out, const std::atomic<bool>& cancelled) override {
+        ++calls;
+        out = m_entries;
+        return !cancelled.load();
+    }
+    bool listPids(std::vector<qint64>& out) override {
+        ++calls;
+        out.clear();
+        for (const ProcessEntry& entry : m_entries) {
+            out.push_back(entry.pid);
+        }
+        return true;
+    }
+    bool query(qint64 pid, ProcessEntry& entry) override {
+        ++calls;
+        for (const ProcessEntry& candidate : m_entries) {
+            if (candidate.pid == pid) {
+                entry = candidate;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::atomic<int> calls{ 0 };
+
+private:
+    QList<ProcessEntry> m_entries;
+};
+
+// snapshot() 阻塞到 release() 或被取消为止，用来构造“刷新进行中”的状态
+class GatedProcessSource : public ProcessSource {
+public:
+    bool snapshot(QList<ProcessEntry>& out, const std::atomic<bool>& cancelled) override {
+        ++calls;
+        QMutexLocker locker(&m_mutex);
+        while (!m_released && !cancelled.load()) {
+            m_releasedCondition.wait(&m_mutex, 5);
+        }
+        if (cancelled.load()) {
+            ++cancelledCalls;
+            return false;
+        }
+        out = m_entries;
+        return true;
+    }
+
+    void release(const QList<ProcessEntry>& entries) {
+        QMutexLocker locker(&m_mutex);
+        m_entries = entries;
+        m_released = true;
+        m_releasedCondition.wakeAll();
+    }
+
+    std::atomic<int> calls{ 0 };
+    std::atomic<int> cancelledCalls{ 0 };
+
+private:
+    QMutex m_mutex;
+    QWaitCondition m_releasedCondition;
+    bool m_released = false;
+    QList<ProcessEntry> m_entries;
+};
+
+// 每次快照生成 count 个条目，名称带上快照序号；生成过程中定期检查取消，
+// 让重复的 refresh() 能在快照进行到一半时取消它
+class GenerationProcessSource : public ProcessSource {
+public:
+    explicit GenerationProcessSource(int count)
+        : m_count(count)
+    {
+    }
+
+    bool snapshot(QList<ProcessEntry>& out, const std::atomic<bool>& cancelled) override {
+        const int generation = ++calls;
+        out.clear();
+        out.reserve(m_count);
+        // 倒序返回，由模型负责排序
+        for (int i = m_count; i > 0; --i) {
+            if (i % 1000 == 0 && cancelled.load()) {
+                ++cancelledCalls;
+                return false;
+            }
+            ProcessEntry entry = makeEntry(i, QStringLiteral("p%1-g%2").arg(i).arg(generation));
+            // 每一代有不同的一批进程已退出
+            if (i % 10 != generation % 10) {
+                out.append(entry);
+            }
+        }
+        return true;
+    }
+
+    // 第 generation 次快照中的行数
+    int expectedRows(int generation) const {
+        const int residue = generation % 10;
+        return m_count - (m_count / 10 + (residue != 0 && residue <= m_count % 10 ? 1 : 0));
+    }
+
+    std::atomic<int> calls{ 0 };
+    std::atomic<int> cancelledCalls{ 0 };
+
+private:
+    int m_count;
+};
+
+// 快照总是失败的提供者
+class FailingProcessSource : public ProcessSource {
+public:
+    bool snapshot(QList<ProcessEntry>& out, const std::atomic<bool>& cancelled) override {
+        Q_UNUSED(out);
+        Q_UNUSED(cancelled);
+        return false;
+    }
+};
+
+// 关闭所有后台活动（实时事件、计数采样），只测试快照到角色数据的路径
+void makeQuiet(ProcessListModel& model) {
+    model.setLiveUpdates(false);
+    model.setStatsInterval(0);
+}
+
+QList<qint64> pidsOf(const ProcessListModel& model) {
+    QList<qint64> pids;
+    for (int row = 0; row < model.rowCount(); ++row) {
+        pids.append(model.data(model.index(row), ProcessListModel::PidRole).toLongLong());
+    }
+    return pids;
+}
+
+// 监听总是失败的事件源（例如 netlink 订阅被拒绝），可以给出替代实现
+class FailingProcessEventSource : public ProcessEventSource {
+public:
+    explicit FailingProcessEventSource(bool hasFallback)
+        : m_hasFallback(hasFallback)
+    {
+    }
+
+    std::unique_ptr<ProcessEventSource> createFallback() const override {
+        if (!m_hasFallback) {
+            return nullptr;
+        }
+        return std::make_unique<FakeProcessEventSource>();
+    }
+
+protected:
+    bool startWatching() override { return false; }
+    void stopWatching() override {}
+
+private:
+    bool m_hasFallback;
+};
+
+ProcessEvent startedEvent(const ProcessEntry& entry) {
+    ProcessEvent event;
+    event.kind = ProcessEvent::Started;
+    event.entry = entry;
+    return event;
+}
+
+ProcessEvent exitedEvent(qint64 pid) {
+    ProcessEvent event;
+    event.kind = ProcessEvent::Exited;
+    event.entry.pid = pid;
+    return event;
+}
+
+// 安装假事件源与快照提供者并完成首次刷新，之后只由注入的事件驱动
+FakeProcessEventSource* startLiveModel(ProcessListModel& model, CountingProcessSource** counter,
+                                       const QList<ProcessEntry>& entries) {
+    model.setStatsInterval(0);
+    auto events = std::make_unique<FakeProcessEventSource>();
+    FakeProcessEventSource* fake = events.get();
+    model.setProcessEventSource(std::move(events));
+    auto source = std::make_unique<CountingProcessSource>(entries);
+    *counter = source.get();
+    model.setProcessSource(std::move(source));
+    model.refresh();
+    return fake;
+}
+} // namespace
+
+class TestProcessListModel : public QObject {
+    Q_OBJECT
+private slots:
+    void dataReadsSnapshotMetadata();
+    void emptyNameFallsBackToPid();
+    void invalidIndexReturnsNothing();
+    void multiDataMatchesData();
+    void multiDataClearsInvalidIndex();
+    void dataDoesNotQueryProcessSource();
+    void addProcessCopiesMetadata();
+    void roleNamesExposeQmlRoles();
+    void snapshotEmitsRangedRemoveAndInsert();
+    void snapshotEmitsDataChangedForChangedRows();
+    void snapshotWithReorderedRowsResets();
+    void snapshotWithReusedPidReplacesRow();
+    void nonIncrementalSnapshotResets();
+    void refreshRunsInBackground();
+    void refreshWhileRunningCoalesces();
+    void repeatedRefreshOfLargeSnapshot();
+    void failedSnapshotKeepsRows();
+    void replaceSourceDuringRefresh();
+    void destroyDuringRefresh();
+    void applyEventsMergesRanges();
+    void applyEventsKeepsLastEventPerPid();
+    void applyEventsHandlesPidReuse();
+    void liveUpdatesApplyQueuedEvents();
+    void eventOverflowFallsBackToRefresh();
+    void disablingLiveUpdatesStopsEventSource();
+    void failedEventSourceUsesFallback();
+    void failedEventSourceWithoutFallback();
+};
+
+void TestProcessListModel::dataReadsSnapshotMetadata() {
+    ProcessListModel model;
+    makeQuiet(model);
+    model.applySnapshot({ makeEntry(4, "init"), makeEntry(17, "bash", 4), makeEntry(42, "editor", 17) });
+
+    QCOMPARE(model.rowCount(), 3);
+    const QModelIndex index = model.index(1);
+    QCOMPARE(model.data(index, ProcessListModel::NameRole).toString(), QStringLiteral("bash"));
+    QCOMPARE(model.data(index, ProcessListModel::PidRole).toLongLong(), qint64(17));
+    QCOMPARE(model.data(index, ProcessListModel::FileRole).toString(), QStringLiteral("/usr/bin/bash"));
+    QCOMPARE(model.data(index, ProcessListModel::ParentPidRole).toLongLong(), qint64(4));
+    QCOMPARE(model.data(index, ProcessListModel::StartTimeRole).toULongLong(), quint64(170));
+}
+
+void TestProcessListModel::emptyNameFallsBackToPid() {
+    ProcessListModel model;
+    makeQuiet(model);
+    model.applySnapshot({ makeEntry(99, QString()) });
+
+    QCOMPARE(model.data(model.index(0), ProcessListModel::NameRole).toString(),
+             QStringLiteral("Unknown Process (PID: 99)"));
+    QVERIFY(model.data(model.index(0), ProcessListModel::FileRole).toString().isEmpty());
+}
+
+void TestProcessListModel::invalidIndexReturnsNothing() {
+    ProcessListModel model;
+    makeQuiet(model);
+    model.applySnapshot({ makeEntry(1, "a") });
+
+    QVERIFY(!model.data(QModelIndex(), ProcessListModel::NameRole).isValid());
+    QVERIFY(!model.data(model.index(0), Qt::DecorationRole).isValid());
+    model.clearProcesses();
+    QCOMPARE(model.rowCount(), 0);
+    QVERIFY(!model.index(0).isValid());
+}
+
+void TestProcessListModel::multiDataMatchesData() {
+    ProcessListModel model;
+    makeQuiet(model);
+    model.applySnapshot({ makeEntry(5, "svc", 1), makeEntry(6, QString(), 5) });
+
+    for (int row = 0; row < model.rowCount(); ++row) {
+        const QModelIndex index = model.index(row);
+        std::array<QModelRoleData, 5> roles = { {
+            QModelRoleData(ProcessListModel::NameRole),
+            QModelRoleData(ProcessListModel::PidRole),
+            QModelRoleData(ProcessListModel::FileRole),
+            QModelRoleData(ProcessListModel::ParentPidRole),
+            QModelRoleData(ProcessListModel::StartTimeRole),
+        } };
+        model.multiData(index, roles);
+        for (const QModelRoleData& data : roles) {
+            QCOMPARE(data.data(), model.data(index, data.role()));
+        }
+    }
+}
+
+void TestProcessListModel::multiDataClearsInvalidIndex() {
+    ProcessListModel model;
+    makeQuiet(model);
+
+    std::array<QModelRoleData, 2> roles = { {
+        QModelRoleData(ProcessListModel::NameRole),
+        QModelRoleData(ProcessListModel::PidRole),
+    } };
+    roles[0].setData(QStringLiteral("stale"));
+    roles[1].setData(7);
+    model.multiData(QModelIndex(), roles);
+    QVERIFY(!roles[0].data().isValid());
+    QVERIFY(!roles[1].data().isValid());
+}
+
+void TestProcessListModel::dataDoesNotQueryProcessSource() {
+    const QList<ProcessEntry> entries = { makeEntry(10, "one"), makeEntry(11, "two"), makeEntry(12, "three") };
+    auto source = std::make_unique<CountingProcessSource>(entries);
+    CountingProcessSource* counter = source.get();
+
+    ProcessListModel model;
+    makeQuiet(model);
+    model.setProcessSource(std::move(source));
+    model.applySnapshot(entries);
+
+    const QList<int> roles = model.roleNames().keys();
+    for (int row = 0; row < model.rowCount(); ++row) {
+        for (int role : roles) {
+            model.data(model.index(row), role);
+        }
+    }
+    QCOMPARE(counter->calls.load(), 0);
+}
+
+void TestProcessListModel::addProcessCopiesMetadata() {
+    ProcessListModel model;
+    makeQuiet(model);
+
+    QPointer<Process> process = new Process(makeEntry(321, "daemon", 1));
+    model.addProcess(process);
+    // 模型只保存值，进程对象在复制后立即释放
+    QVERIFY(process.isNull());
+    QCOMPARE(model.rowCount(), 1);
+    QCOMPARE(model.data(model.index(0), ProcessListModel::NameRole).toString(), QStringLiteral("daemon"));
+    QCOMPARE(model.data(model.index(0), ProcessListModel::PidRole).toLongLong(), qint64(321));
+
+    model.addProcess(nullptr);
+    QCOMPARE(model.rowCount(), 1);
+}
+
+void TestProcessListModel::roleNamesExposeQmlRoles() {
+    ProcessListModel model;
+    makeQuiet(model);
+    const QHash<int, QByteArray> roles = model.roleNames();
+
+    QCOMPARE(roles.value(ProcessListModel::NameRole), QByteArray("name"));
+    QCOMPARE(roles.value(ProcessListModel::PidRole), QByteArray("pid"));
+    QCOMPARE(roles.value(ProcessListModel::FileRole), QByteArray("file"));
+    QCOMPARE(roles.value(ProcessListModel::ParentPidRole), QByteArray("parentPid"));
+    // 创建时间只在 C++ 侧区分 PID 复用
+    QVERIFY(!roles.contains(ProcessListModel::StartTimeRole));
+}
+
+void TestProcessListModel::snapshotEmitsRangedRemoveAndInsert() {
+    ProcessListModel model;
+    makeQuiet(model);
+    model.applySnapshot({ makeEntry(10, "a"), makeEntry(20, "b"), makeEntry(30, "c"), makeEntry(40, "d"),
+        makeEntry(50, "e") });
+    QSignalSpy inserted(&model, &ProcessListModel::rowsInserted);
+    QSignalSpy removed(&model, &ProcessListModel::rowsRemoved);
+    QSignalSpy changed(&model, &ProcessListModel::dataChanged);
+    QSignalSpy reset(&model, &ProcessListModel::modelReset);
+
+    model.applySnapshot({ makeEntry(10, "a"), makeEntry(15, "p"), makeEntry(16, "q"), makeEntry(40, "d"),
+        makeEntry(50, "e"), makeEntry(60, "f") });
+    QCOMPARE(pidsOf(model), (QList<qint64>{ 10, 15, 16, 40, 50, 60 }));
+    // 相邻的退出进程合并为一次删除，相邻的新进程合并为一次插入
+    QCOMPARE(removed.count(), 1);
+    QCOMPARE(removed.at(0).at(1).toInt(), 1);
+    QCOMPARE(removed.at(0).at(2).toInt(), 2);
+    QCOMPARE(inserted.count(), 2);
+    QCOMPARE(inserted.at(0).at(1).toInt(), 1);
+    QCOMPARE(inserted.at(0).at(2).toInt(), 2);
+    QCOMPARE(inserted.at(1).at(1).toInt(), 5);
+    QCOMPARE(inserted.at(1).at(2).toInt(), 5);
+    QCOMPARE(changed.count(), 0);
+    QCOMPARE(reset.count(), 0);
+    QCOMPARE(model.data(model.index(2), ProcessListModel::NameRole).toString(), QStringLiteral("q"));
+
+    // 内容相同的快照不发出任何信号
+    model.applySnapshot({ makeEntry(10, "a"), makeEntry(15, "p"), makeEntry(16, "q"), makeEntry(40, "d"),
+        makeEntry(50, "e"), makeEntry(60, "f") });
+    QCOMPARE(removed.count(), 1);
+    QCOMPARE(inserted.count(), 2);
+    QCOMPARE(changed.count(), 0);
+    QCOMPARE(reset.count(), 0);
+}
+
+void TestProcessListModel::snapshotEmitsDataChangedForChangedRows() {
+    ProcessListModel model;
+    makeQuiet(model);
+    model.applySnapshot({ makeEntry(10, "a"), makeEntry(20, "b"), makeEntry(30, "c"), makeEntry(40, "d") });
+    QSignalSpy inserted(&model, &ProcessListModel::rowsInserted);
+    QSignalSpy removed(&model, &ProcessListModel::rowsRemoved);
+    QSignalSpy changed(&model, &ProcessListModel::dataChanged);
+
+    // 同一进程（PID 与创建时间都相同）改名、换父进程只是数据变化，相邻的行合并为一个区间
+    ProcessEntry renamed = makeEntry(20, "b2");
+    ProcessEntry reparented = makeEntry(30, "c", 7);
+    model.applySnapshot({ makeEntry(10, "a"), renamed, reparented, makeEntry(40, "d") });
+    QCOMPARE(inserted.count(), 0);
+    QCOMPARE(removed.count(), 0);
+    QCOMPARE(changed.count(), 1);
+    QCOMPARE(changed.at(0).at(0).value<QModelIndex>().row(), 1);
+    QCOMPARE(changed.at(0).at(1).value<QModelIndex>().row(), 2);
+    QCOMPARE(model.data(model.index(1), ProcessListModel::NameRole).toString(), QStringLiteral("b2"));
+    QCOMPARE(model.data(model.index(2), ProcessListModel::ParentPidRole).toLongLong(), qint64(7));
+}
+
+void TestProcessListModel::snapshotWithReorderedRowsResets() {
+    ProcessListModel model;
+    makeQuiet(model);
+    model.applySnapshot({ makeEntry(10, "a"), makeEntry(20, "b"), makeEntry(30, "c") });
+    QSignalSpy inserted(&model, &ProcessListModel::rowsInserted);
+    QSignalSpy removed(&model, &ProcessListModel::rowsRemoved);
+    QSignalSpy reset(&model, &ProcessListModel::modelReset);
+
+    // 存活行的相对顺序变化无法用区间操作表达，整体重置
+    model.applySnapshot({ makeEntry(30, "c"), makeEntry(10, "a"), makeEntry(40, "d") });
+    QCOMPARE(reset.count(), 1);
+    QCOMPARE(inserted.count(), 0);
+    QCOMPARE(removed.count(), 0);
+    QCOMPARE(pidsOf(model), (QList<qint64>{ 30, 10, 40 }));
+    QCOMPARE(model.data(model.index(2), ProcessListModel::NameRole).toString(), QStringLiteral("d"));
+}
+
+void TestProcessListModel::snapshotWithReusedPidReplacesRow() {
+    ProcessListModel model;
+    makeQuiet(model);
+    model.applySnapshot({ makeEntry(10, "a"), makeEntry(20, "old"), makeEntry(30, "c") });
+    QSignalSpy inserted(&model, &ProcessListModel::rowsInserted);
+    QSignalSpy removed(&model, &ProcessListModel::rowsRemoved);
+    QSignalSpy changed(&model, &ProcessListModel::dataChanged);
+
+    // PID 相同、创建时间不同：另一个进程，删除旧行并在同一位置插入新行，而不是数据变化
+    ProcessEntry reused = makeEntry(20, "new");
+    reused.startTime = 12345;
+    model.applySnapshot({ makeEntry(10, "a"), reused, makeEntry(30, "c") });
+    QCOMPARE(removed.count(), 1);
+    QCOMPARE(removed.at(0).at(1).toInt(), 1);
+    QCOMPARE(inserted.count(), 1);
+    QCOMPARE(inserted.at(0).at(1).toInt(), 1);
+    QCOMPARE(inserted.at(0).at(2).toInt(), 1);
+    QCOMPARE(changed.count(), 0);
+    QCOMPARE(model.data(model.index(1), ProcessListModel::NameRole).toString(), QStringLiteral("new"));
+    QCOMPARE(model.data(model.index(1), ProcessListModel::StartTimeRole).toULongLong(), quint64(12345));
+}
+
+void TestProcessListModel::nonIncrementalSnapshotResets() {
+    ProcessListModel model;
+    makeQuiet(model);
+    QSignalSpy property(&model, &ProcessListModel::incrementalRefreshChanged);
+    QVERIFY(model.incrementalRefresh());
+    model.setIncrementalRefresh(false);
+    model.setIncrementalRefresh(false);
+    QCOMPARE(property.count(), 1);
+
+    model.applySnapshot({ makeEntry(10, "a") });
+    QSignalSpy inserted(&model, &ProcessListModel::rowsInserted);
+    QSignalSpy reset(&model, &ProcessListModel::modelReset);
+    model.applySnapshot({ makeEntry(10, "a"), makeEntry(20, "b") });
+    QCOMPARE(reset.count(), 1);
+    QCOMPARE(inserted.count(), 0);
+    QCOMPARE(model.rowCount(), 2);
+}
+
+void TestProcessListModel::refreshRunsInBackground() {
+    // 提供者按任意顺序返回，模型按 PID 排序
+    const QList<ProcessEntry> entries = { makeEntry(30, "c"), makeEntry(10, "a"), makeEntry(20, "b") };
+    ProcessListModel model;
+    makeQuiet(model);
+    model.setProcessSource(std::make_unique<CountingProcessSource>(entries));
+    QSignalSpy refreshing(&model, &ProcessListModel::refreshingChanged);
+
+    model.refresh();
+    QVERIFY(model.isRefreshing());
+    // 快照在后台线程生成，回到事件循环之前模型不变
+    QCOMPARE(model.rowCount(), 0);
+
+    QTRY_VERIFY(!model.isRefreshing());
+    QCOMPARE(refreshing.count(), 2);
+    QCOMPARE(model.rowCount(), 3);
+    QCOMPARE(model.data(model.index(0), ProcessListModel::PidRole).toLongLong(), qint64(10));
+    QCOMPARE(model.data(model.index(1), ProcessListModel::PidRole).toLongLong(), qint64(20));
+    QCOMPARE(model.data(model.index(2), ProcessListModel::PidRole).toLongLong(), qint64(30));
+}
+
+void TestProcessListModel::refreshWhileRunningCoalesces() {
+    auto source = std::make_unique<GatedProcessSource>();
+    GatedProcessSource* gate = source.get();
+    ProcessListModel model;
+    makeQuiet(model);
+    model.setProcessSource(std::move(source));
+    QSignalSpy refreshing(&model, &ProcessListModel::refreshingChanged);
+
+    model.refresh();
+    QTRY_COMPARE(gate->calls.load(), 1);
+    // 进行中的快照被取消，多次请求只合并为一次后续刷新
+    model.refresh();
+    model.refresh();
+    model.refresh();
+    QTRY_COMPARE(gate->calls.load(), 2);
+    QCOMPARE(gate->cancelledCalls.load(), 1);
+    QVERIFY(model.isRefreshing());
+    QCOMPARE(model.rowCount(), 0);
+
+    gate->release({ makeEntry(1, "x"), makeEntry(2, "y") });
+    QTRY_VERIFY(!model.isRefreshing());
+    QCOMPARE(model.rowCount(), 2);
+    QCOMPARE(gate->calls.load(), 2);
+    // refreshing 在整个合并过程中只切换一次
+    QCOMPARE(refreshing.count(), 2);
+}
+
+void TestProcessListModel::repeatedRefreshOfLargeSnapshot() {
+    constexpr int kEntries = 50000;
+    ProcessListModel model;
+    makeQuiet(model);
+    auto owned = std::make_unique<GenerationProcessSource>(kEntries);
+    GenerationProcessSource* source = owned.get();
+    model.setProcessSource(std::move(owned));
+
+    // 连续请求刷新：进行中的快照被取消，积压的请求合并，事件循环在其间应用已完成的快照
+    for (int i = 0; i < 40; ++i) {
+        model.refresh();
+        if (i % 4 == 0) {
+            model.refresh();
+        }
+        QTest::qWait(1);
+    }
+    QTRY_VERIFY_WITH_TIMEOUT(!model.isRefreshing(), 30000);
+    QVERIFY(source->cancelledCalls.load() > 0);
+    QVERIFY(source->calls.load() <= 41);
+
+    // 最后应用的一定是最后一次请求之后开始的那份快照
+    const int generation = source->calls.load();
+    QCOMPARE(model.rowCount(), source->expectedRows(generation));
+    qint64 previous = 0;
+    for (int row = 0; row < model.rowCount(); ++row) {
+        const QModelIndex index = model.index(row);
+        const qint64 pid = model.data(index, ProcessListModel::PidRole).toLongLong();
+        QVERIFY2(pid > previous, qPrintable(QString::number(row)));
+        QVERIFY(pid % 10 != generation % 10);
+        if (model.data(index, ProcessListModel::NameRole).toString()
+            != QStringLiteral("p%1-g%2").arg(pid).arg(generation)) {
+            QFAIL(qPrintable(QStringLiteral("stale row %1 (pid %2)").arg(row).arg(pid)));
+        }
+        previous = pid;
+    }
+}
+
+void TestProcessListModel::failedSnapshotKeepsRows() {
+    ProcessListModel model;
+    makeQuiet(model);
+    model.applySnapshot({ makeEntry(7, "kept") });
+    model.setProcessSource(std::make_unique<FailingProcessSource>());
+
+    model.refresh();
+    QTRY_VERIFY(!model.isRefreshing());
+    QCOMPARE(model.rowCount(), 1);
+    QCOMPARE(model.data(model.index(0), ProcessListModel::NameRole).toString(), QStringLiteral("kept"));
+}
+
+void TestProcessListModel::replaceSourceDuringRefresh() {
+    ProcessListModel model;
+    makeQuiet(model);
+    auto gated = std::make_unique<GatedProcessSource>();
+    GatedProcessSource* gate = gated.get();
+    model.setProcessSource(std::move(gated));
+    model.refresh();
+    QTRY_COMPARE(gate->calls.load(), 1);
+
+    // 替换提供者会取消并等待进行中的快照，再用新的提供者重新刷新
+    model.setProcessSource(std::make_unique<CountingProcessSource>(QList<ProcessEntry>{ makeEntry(3, "new") }));
+    QVERIFY(model.isRefreshing());
+    QTRY_VERIFY(!model.isRefreshing());
+    QCOMPARE(model.rowCount(), 1);
+    QCOMPARE(model.data(model.index(0), ProcessListModel::NameRole).toString(), QStringLiteral("new"));
+}
+
+void TestProcessListModel::destroyDuringRefresh() {
+    auto gated = std::make_unique<GatedProcessSource>();
+    GatedProcessSource* gate = gated.get();
+    auto model = std::make_unique<ProcessListModel>();
+    makeQuiet(*model);
+    model->setProcessSource(std::move(gated));
+    model->refresh();
+    QTRY_COMPARE(gate->calls.load(), 1);
+    // 析构时取消后台快照并等待线程退出，快照一直未放行也不会卡住
+    model.reset();
+}
+
+void TestProcessListModel::applyEventsMergesRanges() {
+    ProcessListModel model;
+    makeQuiet(model);
+    model.applySnapshot({ makeEntry(10, "a"), makeEntry(20, "b"), makeEntry(30, "c") });
+    QSignalSpy inserted(&model, &ProcessListModel::rowsInserted);
+    QSignalSpy removed(&model, &ProcessListModel::rowsRemoved);
+    QSignalSpy changed(&model, &ProcessListModel::dataChanged);
+    QSignalSpy reset(&model, &ProcessListModel::modelReset);
+
+    ProcessEntry execed = makeEntry(30, "c");
+    execed.name = QStringLiteral("c-after-exec");
+    model.applyEvents({
+        startedEvent(makeEntry(16, "new2")),
+        startedEvent(makeEntry(15, "new1")),
+        exitedEvent(20),
+        startedEvent(execed),
+        startedEvent(makeEntry(40, "d")),
+        exitedEvent(99), // 未知 PID 无操作
+    });
+
+    QCOMPARE(pidsOf(model), (QList<qint64>{ 10, 15, 16, 30, 40 }));
+    QCOMPARE(model.data(model.index(3), ProcessListModel::NameRole).toString(), QStringLiteral("c-after-exec"));
+    // 相邻的新 PID 合并为一次插入；exec 只是同一行的数据变化
+    QCOMPARE(inserted.count(), 2);
+    QCOMPARE(inserted.at(0).at(1).toInt(), 1);
+    QCOMPARE(inserted.at(0).at(2).toInt(), 2);
+    QCOMPARE(removed.count(), 1);
+    QCOMPARE(changed.count(), 1);
+    QCOMPARE(reset.count(), 0);
+}
+
+void TestProcessListModel::applyEventsKeepsLastEventPerPid() {
+    ProcessListModel model;
+    makeQuiet(model);
+    model.applySnapshot({ makeEntry(10, "a") });
+
+    // 同一批次内启动又退出的进程不出现；退出后又报告启动的按最后一个事件处理
+    model.applyEvents({
+        startedEvent(makeEntry(50, "transient")),
+        exitedEvent(50),
+        exitedEvent(10),
+        startedEvent(makeEntry(10, "a")),
+    });
+    QCOMPARE(pidsOf(model), QList<qint64>{ 10 });
+
+    model.applyEvents({});
+    QCOMPARE(model.rowCount(), 1);
+}
+
+void TestProcessListModel::applyEventsHandlesPidReuse() {
+    ProcessListModel model;
+    makeQuiet(model);
+    model.applySnapshot({ makeEntry(10, "a"), makeEntry(20, "old") });
+    QSignalSpy removed(&model, &ProcessListModel::rowsRemoved);
+    QSignalSpy inserted(&model, &ProcessListModel::rowsInserted);
+
+    // 创建时间不同：PID 被新进程复用，旧行删除、新行插入
+    ProcessEntry reused = makeEntry(20, "new");
+    reused.startTime = 999;
+    model.applyEvents({ startedEvent(reused) });
+    QCOMPARE(pidsOf(model), (QList<qint64>{ 10, 20 }));
+    QCOMPARE(model.data(model.index(1), ProcessListModel::NameRole).toString(), QStringLiteral("new"));
+    QCOMPARE(model.data(model.index(1), ProcessListModel::StartTimeRole).toULongLong(), quint64(999));
+    QCOMPARE(removed.count(), 1);
+    QCOMPARE(inserted.count(), 1);
+}
+
+void TestProcessListModel::liveUpdatesApplyQueuedEvents() {
+    ProcessListModel model;
+    CountingProcessSource* counter = nullptr;
+    FakeProcessEventSource* events = startLiveModel(model, &counter, { makeEntry(10, "a"), makeEntry(20, "b") });
+    QVERIFY(events->isRunning());
+    QTRY_VERIFY(!model.isRefreshing());
+    QCOMPARE(model.rowCount(), 2);
+
+    // 一批事件合并后一次应用，不再触发快照
+    QSignalSpy inserted(&model, &ProcessListModel::rowsInserted);
+    events->forkStorm(100, 20, 10, QStringLiteral("/usr/bin/worker"));
+    events->emitExited(20);
+    QTRY_COMPARE(model.rowCount(), 21);
+    QCOMPARE(inserted.count(), 1);
+    QCOMPARE(pidsOf(model).first(), qint64(10));
+    QCOMPARE(pidsOf(model).last(), qint64(119));
+    QCOMPARE(model.data(model.index(1), ProcessListModel::ParentPidRole).toLongLong(), qint64(10));
+    QCOMPARE(counter->calls.load(), 1);
+}
+
+void TestProcessListModel::eventOverflowFallsBackToRefresh() {
+    ProcessListModel model;
+    CountingProcessSource* counter = nullptr;
+    FakeProcessEventSource* events = startLiveModel(model, &counter, { makeEntry(10, "a") });
+    QTRY_VERIFY(!model.isRefreshing());
+    QCOMPARE(counter->calls.load(), 1);
+
+    // 队列溢出后积压的事件不可信，丢弃并重新取完整快照
+    events->emitStarted(makeEntry(500, "lost"));
+    events->emitOverflow();
+    QTRY_COMPARE(counter->calls.load(), 2);
+    QTRY_VERIFY(!model.isRefreshing());
+    QCOMPARE(pidsOf(model), QList<qint64>{ 10 });
+}
+
+void TestProcessListModel::disablingLiveUpdatesStopsEventSource() {
+    ProcessListModel model;
+    CountingProcessSource* counter = nullptr;
+    FakeProcessEventSource* events = startLiveModel(model, &counter, { makeEntry(10, "a") });
+    QTRY_VERIFY(!model.isRefreshing());
+    QSignalSpy liveUpdates(&model, &ProcessListModel::liveUpdatesChanged);
+
+    // 尚未合并的事件随停止一起丢弃
+    events->emitStarted(makeEntry(60, "pending"));
+    model.setLiveUpdates(false);
+    QVERIFY(!events->isRunning());
+    QCOMPARE(liveUpdates.count(), 1);
+    QTest::qWait(100);
+    QCOMPARE(model.rowCount(), 1);
+
+    // 重新开启时先完整刷新一次，校准停止期间错过的变化
+    model.setLiveUpdates(true);
+    QVERIFY(events->isRunning());
+    QTRY_COMPARE(counter->calls.load(), 2);
+    QTRY_VERIFY(!model.isRefreshing());
+    QCOMPARE(pidsOf(model), QList<qint64>{ 10 });
+    QCOMPARE(model.processEventSource(), static_cast<ProcessEventSource*>(events));
+}
+
+void TestProcessListModel::failedEventSourceUsesFallback() {
+    ProcessListModel model;
+    model.setStatsInterval(0);
+    auto failing = std::make_unique<FailingProcessEventSource>(true);
+    ProcessEventSource* original = failing.get();
+    model.setProcessEventSource(std::move(failing));
+    model.setProcessSource(std::make_unique<CountingProcessSource>(QList<ProcessEntry>{ makeEntry(10, "a") }));
+    QTest::ignoreMessage(QtInfoMsg, "Process event source failed to start, using its fallback");
+    model.refresh();
+    QTRY_VERIFY(!model.isRefreshing());
+
+    // 首次刷新后开始监听：失败的事件源被替代实现取代，实时更新照常工作
+    auto* fallback = dynamic_cast<FakeProcessEventSource*>(model.processEventSource());
+    QVERIFY(model.processEventSource() != original);
+    QVERIFY(fallback);
+    QVERIFY(fallback->isRunning());
+    fallback->emitStarted(makeEntry(20, "b"));
+    QTRY_COMPARE(pidsOf(model), (QList<qint64>{ 10, 20 }));
+}
+
+void TestProcessListModel::failedEventSourceWithoutFallback() {
+    ProcessListModel model;
+    model.setStatsInterval(0);
+    auto failing = std::make_unique<FailingProcessEventSource>(false);
+    ProcessEventSource* original = failing.get();
+    model.setProcessEventSource(std::move(failing));
+    model.setProcessSource(std::make_unique<CountingProcessSource>(QList<ProcessEntry>{ makeEntry(10, "a") }));
+    QTest::ignoreMessage(QtWarningMsg, "Process event source failed to start, live updates disabled");
+    model.refresh();
+    QTRY_VERIFY(!model.isRefreshing());
+    QCOMPARE(model.processEventSource(), original);
+    QVERIFY(!original->isRunning());
+}
+
+QTEST_GUILESS_MAIN(TestProcessListModel)
+#include "tst_processlistmodel.moc"
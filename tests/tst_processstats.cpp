@@ -0,0 +1,349 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include <QMutex>
+#include <QSignalSpy>
+#include <atomic>
+#include <map>
+#include <set>
+#include "ProcessListModel.h"
+#include "ProcessStats.h"
+
+#ifdef Q_OS_LINUX
+#include <sys/prctl.h>
+#endif
+
+namespace {
+constexpr quint64 kSecondNs = 1000ull * 1000 * 1000;
+
+ProcessCounters counters(quint64 cpuTime, quint64 workingSet = 0) {
+    ProcessCounters result;
+    result.cpuTime = cpuTime;
+    result.workingSet = workingSet;
+    result.valid = true;
+    return result;
+}
+
+ProcessEntry makeEntry(qint64 pid) {
+    ProcessEntry entry;
+    entry.pid = pid;
+    entry.parentPid = 1;
+    entry.startTime = static_cast<quint64>(pid) * 10;
+    entry.name = QStringLiteral("proc%1").arg(pid);
+    return entry;
+}
+
+// 按 PID 返回测试设定的计数；busy 的进程每次采样都记满 CPU
+class FakeStatsSource : public ProcessStatsSource {
+public:
+    void sample(const std::vector<ProcessKey>& keys, std::vector<ProcessCounters>& out) override {
+        QMutexLocker locker(&m_mutex);
+        out.assign(keys.size(), ProcessCounters());
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            const auto it = m_workingSet.find(keys[i].pid);
+            if (it == m_workingSet.end()) {
+                continue;
+            }
+            quint64& cpuTime = m_cpuTime[keys[i].pid];
+            if (m_busy.count(keys[i].pid)) {
+                cpuTime += 1000 * kSecondNs;
+            }
+            out[i] = counters(cpuTime, it->second);
+        }
+        ++samples;
+    }
+
+    // 一次性替换，采样线程不会看到只改了一半的数据
+    void setWorkingSets(const std::map<qint64, quint64>& workingSet, const std::set<qint64>& busy = {}) {
+        QMutexLocker locker(&m_mutex);
+        m_workingSet = workingSet;
+        m_busy = busy;
+    }
+
+    std::atomic<int> samples{ 0 };
+
+private:
+    QMutex m_mutex;
+    std::map<qint64, quint64> m_workingSet;
+    std::map<qint64, quint64> m_cpuTime;
+    std::set<qint64> m_busy;
+};
+
+// 记录 dataChanged 的区间与角色
+struct ChangedRange {
+    int first;
+    int last;
+    QList<int> roles;
+};
+
+QList<ChangedRange> rangesOf(const QSignalSpy& spy) {
+    QList<ChangedRange> ranges;
+    for (int i = 0; i < spy.count(); ++i) {
+        const QList<QVariant> arguments = spy.at(i);
+        ranges.append({ arguments.at(0).value<QModelIndex>().row(), arguments.at(1).value<QModelIndex>().row(),
+            arguments.at(2).value<QList<int>>() });
+    }
+    return ranges;
+}
+
+// 等到读取了最新计数的那次采样已应用到模型：采样不重叠，
+// 再下一次采样开始即说明上一次的结果已回到模型线程
+void waitForSample(FakeStatsSource* source) {
+    const int target = source->samples.load() + 2;
+    QTRY_VERIFY(source->samples.load() >= target);
+}
+} // namespace
+
+class TestProcessStats : public QObject {
+    Q_OBJECT
+private slots:
+    void samplerComputesPermille();
+    void samplerRoundsAndClamps();
+    void samplerIgnoresNewAndReusedPids();
+    void samplerClear();
+    void defaultSourceReadsOwnProcess();
+    void defaultSourceRejectsStaleKeys();
+    void linuxSourceParsesCommWithParentheses();
+    void modelEmitsOnlyChangedRowsAndStatRoles();
+    void modelStatsIntervalStopsSampling();
+};
+
+void TestProcessStats::samplerComputesPermille() {
+    ProcessStatsSampler sampler(2);
+    QCOMPARE(sampler.cpuCount(), 2);
+    const std::vector<ProcessKey> keys = { { 10, 1 }, { 20, 2 }, { 30, 3 } };
+    std::vector<quint16> cpu;
+
+    // 首次采样没有上一次的读数，全部为 0
+    sampler.update(keys, { counters(0), counters(kSecondNs), counters(0) }, kSecondNs, cpu);
+    QCOMPARE(cpu, (std::vector<quint16>{ 0, 0, 0 }));
+
+    // 1 秒内两个处理器共 2 秒容量：0.5 秒 = 25%，2 秒 = 100%
+    sampler.update(keys, { counters(kSecondNs / 2), counters(3 * kSecondNs), counters(0) }, 2 * kSecondNs, cpu);
+    QCOMPARE(cpu, (std::vector<quint16>{ 250, 1000, 0 }));
+
+    // 下一次以上一次为基准
+    sampler.update(keys, { counters(kSecondNs / 2 + kSecondNs / 10), counters(3 * kSecondNs), counters(0) },
+        3 * kSecondNs, cpu);
+    QCOMPARE(cpu, (std::vector<quint16>{ 50, 0, 0 }));
+
+    // 默认取逻辑处理器数量
+    QVERIFY(ProcessStatsSampler().cpuCount() >= 1);
+}
+
+void TestProcessStats::samplerRoundsAndClamps() {
+    ProcessStatsSampler sampler(1);
+    const std::vector<ProcessKey> keys = { { 1, 0 }, { 2, 0 }, { 3, 0 }, { 4, 0 } };
+    std::vector<quint16> cpu;
+    sampler.update(keys, { counters(0), counters(0), counters(0), counters(5 * kSecondNs) }, kSecondNs, cpu);
+    // 0.04% 舍为 0，0.05% 进为 0.1%；超过容量（计时误差）截断为 100%；计数回退记为 0
+    sampler.update(keys, { counters(400000), counters(500000), counters(3 * kSecondNs), counters(kSecondNs) },
+        2 * kSecondNs, cpu);
+    QCOMPARE(cpu, (std::vector<quint16>{ 0, 1, 1000, 0 }));
+
+    // 时间没有前进时不计算
+    sampler.update(keys, { counters(kSecondNs), counters(kSecondNs), counters(kSecondNs), counters(kSecondNs) },
+        2 * kSecondNs, cpu);
+    QCOMPARE(cpu, (std::vector<quint16>{ 0, 0, 0, 0 }));
+}
+
+void TestProcessStats::samplerIgnoresNewAndReusedPids() {
+    ProcessStatsSampler sampler(1);
+    std::vector<quint16> cpu;
+    sampler.update({ { 5, 50 }, { 7, 70 }, { 9, 90 } }, { counters(0), counters(0), counters(0) }, kSecondNs, cpu);
+
+    // PID 7 被复用（创建时间不同）；PID 6 是新进程；PID 9 本次读取失败
+    ProcessCounters invalid = counters(kSecondNs / 2);
+    invalid.valid = false;
+    sampler.update({ { 5, 50 }, { 6, 60 }, { 7, 71 }, { 9, 90 } },
+        { counters(kSecondNs / 10), counters(kSecondNs / 2), counters(kSecondNs / 2), invalid }, 2 * kSecondNs, cpu);
+    QCOMPARE(cpu, (std::vector<quint16>{ 100, 0, 0, 0 }));
+
+    // 无效读数不进入基准，PID 9 恢复后的首次采样仍为 0
+    sampler.update({ { 6, 60 }, { 7, 71 }, { 9, 90 } },
+        { counters(kSecondNs), counters(kSecondNs / 2), counters(kSecondNs) }, 3 * kSecondNs, cpu);
+    QCOMPARE(cpu, (std::vector<quint16>{ 500, 0, 0 }));
+}
+
+void TestProcessStats::samplerClear() {
+    ProcessStatsSampler sampler(1);
+    const std::vector<ProcessKey> keys = { { 1, 0 } };
+    std::vector<quint16> cpu;
+    sampler.update(keys, { counters(0) }, kSecondNs, cpu);
+    sampler.clear();
+    // 清空后不跨越停止采样的那段时间计算差值
+    sampler.update(keys, { counters(kSecondNs / 2) }, 10 * kSecondNs, cpu);
+    QCOMPARE(cpu, std::vector<quint16>{ 0 });
+    sampler.update(keys, { counters(kSecondNs) }, 11 * kSecondNs, cpu);
+    QCOMPARE(cpu, std::vector<quint16>{ 500 });
+}
+
+void TestProcessStats::defaultSourceReadsOwnProcess() {
+    ProcessEntry self;
+    QVERIFY(createDefaultProcessSource()->query(QCoreApplication::applicationPid(), self));
+    const std::vector<ProcessKey> keys = { self.key() };
+    std::unique_ptr<ProcessStatsSource> source = createDefaultProcessStatsSource();
+    std::vector<ProcessCounters> before;
+    source->sample(keys, before);
+    QCOMPARE(before.size(), std::size_t(1));
+    QVERIFY(before[0].valid);
+    QVERIFY(before[0].workingSet > 0);
+
+    // 消耗一些 CPU 时间，计数应当增长（时钟节拍粒度，最多等待 2 秒）
+    std::vector<ProcessCounters> after;
+    QElapsedTimer timer;
+    timer.start();
+    volatile quint64 sink = 0;
+    do {
+        for (int i = 0; i < 1000000; ++i) {
+            sink = sink + static_cast<quint64>(i);
+        }
+        source->sample(keys, after);
+    } while (after[0].cpuTime == before[0].cpuTime && timer.elapsed() < 2000);
+    QVERIFY(after[0].valid);
+    QVERIFY(after[0].cpuTime > before[0].cpuTime);
+}
+
+void TestProcessStats::defaultSourceRejectsStaleKeys() {
+    ProcessEntry self;
+    QVERIFY(createDefaultProcessSource()->query(QCoreApplication::applicationPid(), self));
+    ProcessKey reused = self.key();
+    reused.startTime += 1;
+    // 创建时间不符视为 PID 已被复用；不存在的 PID 视为已退出
+    const std::vector<ProcessKey> keys = { reused, { 0x7ffffff0, 1 }, self.key() };
+    std::vector<ProcessCounters> out = { counters(1), counters(2) };
+    createDefaultProcessStatsSource()->sample(keys, out);
+    QCOMPARE(out.size(), std::size_t(3));
+    QVERIFY(!out[0].valid);
+    QVERIFY(!out[1].valid);
+    QCOMPARE(out[1].cpuTime, quint64(0));
+    QVERIFY(out[2].valid);
+}
+
+void TestProcessStats::linuxSourceParsesCommWithParentheses() {
+#ifdef Q_OS_LINUX
+    // comm 中的空格与括号不能打乱字段计数
+    char original[16] = {};
+    QCOMPARE(prctl(PR_GET_NAME, original), 0);
+    QCOMPARE(prctl(PR_SET_NAME, "a) b (c) 1 2"), 0);
+    ProcessEntry self;
+    QVERIFY(createDefaultProcessSource()->query(QCoreApplication::applicationPid(), self));
+    std::vector<ProcessCounters> out;
+    LinuxProcessStatsSource().sample({ self.key() }, out);
+    prctl(PR_SET_NAME, original);
+    QVERIFY(out[0].valid);
+    QVERIFY(out[0].workingSet > 0);
+#else
+    QSKIP("/proc/[pid]/stat is Linux only");
+#endif
+}
+
+void TestProcessStats::modelEmitsOnlyChangedRowsAndStatRoles() {
+    ProcessListModel model;
+    model.setLiveUpdates(false);
+    model.setStatsInterval(0);
+    auto stats = std::make_unique<FakeStatsSource>();
+    FakeStatsSource* fake = stats.get();
+    model.setProcessStatsSource(std::move(stats));
+    QList<ProcessEntry> entries;
+    std::map<qint64, quint64> workingSet;
+    for (qint64 pid = 1; pid <= 10; ++pid) {
+        entries.append(makeEntry(pid));
+        workingSet[pid] = 1 << 20;
+    }
+    model.applySnapshot(entries);
+    fake->setWorkingSets(workingSet);
+
+    QSignalSpy spy(&model, &QAbstractItemModel::dataChanged);
+    model.setStatsInterval(10);
+    QCOMPARE(model.statsInterval(), 10);
+    waitForSample(fake);
+    // 首次采样所有行都从 0 变化，合并为一个区间，且只带统计角色
+    const QList<int> statRoles = { ProcessListModel::CpuRole, ProcessListModel::WorkingSetRole };
+    QList<ChangedRange> ranges = rangesOf(spy);
+    QCOMPARE(ranges.size(), 1);
+    QCOMPARE(ranges[0].first, 0);
+    QCOMPARE(ranges[0].last, 9);
+    QCOMPARE(ranges[0].roles, statRoles);
+    QCOMPARE(model.data(model.index(4), ProcessListModel::WorkingSetRole).toULongLong(), quint64(1 << 20));
+
+    // 数值不变时不发出信号
+    spy.clear();
+    waitForSample(fake);
+    QCOMPARE(spy.count(), 0);
+
+    // PID 3、4、8 的工作集变化，PID 6 的变化小于 64 KB 粒度；PID 10 持续占满 CPU
+    workingSet[3] += 1 << 20;
+    workingSet[4] += 1 << 20;
+    workingSet[8] += 1 << 20;
+    workingSet[6] += 4096;
+    fake->setWorkingSets(workingSet, { 10 });
+    waitForSample(fake);
+    ranges = rangesOf(spy);
+    // 区间按行合并：[2, 3]、[7]、[9]；CPU 截断在 100% 之后不再变化
+    QCOMPARE(ranges.size(), 3);
+    QCOMPARE(ranges[0].first, 2);
+    QCOMPARE(ranges[0].last, 3);
+    QCOMPARE(ranges[1].first, 7);
+    QCOMPARE(ranges[1].last, 7);
+    QCOMPARE(ranges[2].first, 9);
+    QCOMPARE(ranges[2].last, 9);
+    for (const ChangedRange& range : std::as_const(ranges)) {
+        QCOMPARE(range.roles, statRoles);
+    }
+    QCOMPARE(model.data(model.index(3), ProcessListModel::WorkingSetRole).toULongLong(), quint64(2 << 20));
+    QCOMPARE(model.data(model.index(5), ProcessListModel::WorkingSetRole).toULongLong(), quint64(1 << 20));
+    QCOMPARE(model.data(model.index(9), ProcessListModel::CpuRole).toDouble(), 100.0);
+    QCOMPARE(model.data(model.index(0), ProcessListModel::CpuRole).toDouble(), 0.0);
+    model.setStatsInterval(0);
+}
+
+void TestProcessStats::modelStatsIntervalStopsSampling() {
+    ProcessListModel model;
+    model.setLiveUpdates(false);
+    model.setStatsInterval(0);
+    auto stats = std::make_unique<FakeStatsSource>();
+    FakeStatsSource* fake = stats.get();
+    model.setProcessStatsSource(std::move(stats));
+    model.applySnapshot({ makeEntry(1) });
+    fake->setWorkingSets({ { 1, 1 << 20 } });
+
+    QSignalSpy intervalSpy(&model, &ProcessListModel::statsIntervalChanged);
+    model.setStatsInterval(-5); // 负值按 0 处理，与当前值相同
+    QCOMPARE(model.statsInterval(), 0);
+    QCOMPARE(intervalSpy.count(), 0);
+    QTest::qWait(50);
+    QCOMPARE(fake->samples.load(), 0);
+
+    model.setStatsInterval(10);
+    QCOMPARE(intervalSpy.count(), 1);
+    QTRY_VERIFY(fake->samples.load() > 0);
+    model.setStatsInterval(0);
+    QCOMPARE(intervalSpy.count(), 2);
+    QTest::qWait(30); // 已启动的采样可能仍在完成
+    const int stopped = fake->samples.load();
+    QTest::qWait(100);
+    QCOMPARE(fake->samples.load(), stopped);
+
+    // 没有行时不启动采样线程
+    ProcessListModel empty;
+    empty.setLiveUpdates(false);
+    empty.setStatsInterval(0);
+    auto emptyStats = std::make_unique<FakeStatsSource>();
+    FakeStatsSource* emptyFake = emptyStats.get();
+    empty.setProcessStatsSource(std::move(emptyStats));
+    empty.setStatsInterval(10);
+    QTest::qWait(60);
+    QCOMPARE(emptyFake->samples.load(), 0);
+}
+
+QTEST_GUILESS_MAIN(TestProcessStats)
+#include "tst_processstats.moc"
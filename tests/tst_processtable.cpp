@@ -0,0 +1,316 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include <QRandomGenerator>
+#include "ProcessTable.h"
+
+namespace {
+ProcessEntry makeEntry(qint64 pid, const QString& name, const QString& exePath = QString()) {
+    ProcessEntry entry;
+    entry.pid = pid;
+    entry.parentPid = pid / 2;
+    entry.startTime = static_cast<quint64>(pid) * 10;
+    entry.name = name;
+    entry.exePath = exePath;
+    return entry;
+}
+
+bool sameEntry(const ProcessEntry& a, const ProcessEntry& b) {
+    return a.pid == b.pid && a.parentPid == b.parentPid && a.startTime == b.startTime
+        && a.name == b.name && a.exePath == b.exePath;
+}
+} // namespace
+
+class TestProcessTable : public QObject {
+    Q_OBJECT
+private slots:
+    void poolInternsOnce();
+    void poolSurvivesRehash();
+    void poolClearAndSwap();
+    void appendAndRead();
+    void readsShareStorage();
+    void sameContent();
+    void insertGapAndSet();
+    void statsColumns();
+    void removeAndSwap();
+    void compactStringsKeepsContent();
+    void matchesReferenceList();
+};
+
+void TestProcessTable::poolInternsOnce() {
+    StringPool pool;
+    QCOMPARE(pool.count(), 0);
+    const quint32 a = pool.intern(u"chrome.exe");
+    const quint32 b = pool.intern(u"C:\\Program Files\\chrome.exe");
+    const quint32 empty = pool.intern(u"");
+    QCOMPARE(pool.intern(u"chrome.exe"), a);
+    QCOMPARE(pool.intern(QStringLiteral("chrome.exe")), a);
+    QCOMPARE(pool.intern(u""), empty);
+    QVERIFY(a != b);
+    QCOMPARE(pool.count(), 3);
+    QCOMPARE(pool.view(a), QStringView(u"chrome.exe"));
+    QCOMPARE(pool.string(b), QStringLiteral("C:\\Program Files\\chrome.exe"));
+    QVERIFY(pool.view(empty).isEmpty());
+    // 大小写不同是不同的字符串
+    QVERIFY(pool.intern(u"Chrome.exe") != a);
+}
+
+void TestProcessTable::poolSurvivesRehash() {
+    StringPool pool;
+    std::vector<quint32> ids;
+    for (int i = 0; i < 5000; ++i) {
+        ids.push_back(pool.intern(QStringLiteral("string-%1").arg(i)));
+        QCOMPARE(ids.back(), quint32(i));
+    }
+    // 多次扩容后编号与内容不变，重复驻留仍返回原编号
+    for (int i = 0; i < 5000; ++i) {
+        QCOMPARE(pool.intern(QStringLiteral("string-%1").arg(i)), ids[i]);
+        QCOMPARE(pool.string(ids[i]), QStringLiteral("string-%1").arg(i));
+    }
+    QCOMPARE(pool.count(), 5000);
+    QVERIFY(pool.memoryUsage() > 0);
+}
+
+void TestProcessTable::poolClearAndSwap() {
+    StringPool first;
+    first.intern(u"a");
+    first.intern(u"b");
+    StringPool second;
+    second.intern(u"c");
+
+    first.swap(second);
+    QCOMPARE(first.count(), 1);
+    QCOMPARE(first.string(0), QStringLiteral("c"));
+    QCOMPARE(second.count(), 2);
+    QCOMPARE(second.intern(u"b"), quint32(1));
+
+    second.clear();
+    QCOMPARE(second.count(), 0);
+    // 清空后旧字符串不会被当作已存在
+    QCOMPARE(second.intern(u"b"), quint32(0));
+    QCOMPARE(second.intern(u"a"), quint32(1));
+}
+
+void TestProcessTable::appendAndRead() {
+    ProcessTable table;
+    QCOMPARE(table.count(), 0);
+    const ProcessEntry first = makeEntry(100, QStringLiteral("svchost.exe"), QStringLiteral("C:\\Windows\\System32\\svchost.exe"));
+    const ProcessEntry second = makeEntry(200, QStringLiteral("svchost.exe"), QStringLiteral("C:\\Windows\\System32\\svchost.exe"));
+    table.append(first);
+    table.append(second);
+    table.append(makeEntry(300, QString()));
+
+    QCOMPARE(table.count(), 3);
+    QCOMPARE(table.pid(1), qint64(200));
+    QCOMPARE(table.parentPid(1), qint64(100));
+    QCOMPARE(table.startTime(1), quint64(2000));
+    QVERIFY(table.key(1) == (ProcessKey{ 200, 2000 }));
+    QCOMPARE(table.name(0), QStringLiteral("svchost.exe"));
+    QCOMPARE(table.exePath(1), QStringLiteral("C:\\Windows\\System32\\svchost.exe"));
+    QVERIFY(table.name(2).isEmpty());
+    QVERIFY(sameEntry(table.entry(0), first));
+    QVERIFY(sameEntry(table.entry(1), second));
+    QCOMPARE(table.cpuPermille(0), quint16(0));
+    QCOMPARE(table.workingSet(0), quint64(0));
+}
+
+void TestProcessTable::readsShareStorage() {
+    // 读取交出的是池中字符串的共享副本：同一程序的各行、同一行的多次读取都指向同一份数据
+    ProcessTable table;
+    const QString path = QStringLiteral("C:\\Windows\\System32\\svchost.exe");
+    table.append(makeEntry(100, QStringLiteral("svchost.exe"), path));
+    table.append(makeEntry(200, QStringLiteral("svchost.exe"), QString(path.constData(), path.size())));
+    QCOMPARE(table.name(0).constData(), table.name(0).constData());
+    QCOMPARE(table.name(0).constData(), table.name(1).constData());
+    QCOMPARE(table.exePath(0).constData(), table.exePath(1).constData());
+    // 新字符串直接共享快照中的数据，不复制
+    QCOMPARE(table.exePath(0).constData(), path.constData());
+    QCOMPARE(table.entry(1).exePath.constData(), path.constData());
+
+    // 复制到另一张表或重建字符池后仍然共享
+    ProcessTable copy;
+    copy.append(table, 1);
+    QCOMPARE(copy.exePath(0).constData(), path.constData());
+
+    StringPool pool;
+    const quint32 id = pool.intern(u"bash");
+    QCOMPARE(pool.string(id).constData(), pool.string(id).constData());
+    QCOMPARE(pool.view(id).data(), pool.string(id).constData());
+}
+
+void TestProcessTable::sameContent() {
+    ProcessTable table;
+    const ProcessEntry entry = makeEntry(10, QStringLiteral("bash"), QStringLiteral("/usr/bin/bash"));
+    table.append(entry);
+    QVERIFY(table.sameContent(0, entry));
+
+    ProcessEntry renamed = entry;
+    renamed.name = QStringLiteral("vim");
+    QVERIFY(!table.sameContent(0, renamed));
+    ProcessEntry moved = entry;
+    moved.exePath = QStringLiteral("/bin/bash");
+    QVERIFY(!table.sameContent(0, moved));
+    ProcessEntry reparented = entry;
+    reparented.parentPid = 1;
+    QVERIFY(!table.sameContent(0, reparented));
+    // PID 与创建时间是键，不属于内容
+    ProcessEntry rekeyed = entry;
+    rekeyed.startTime = 12345;
+    QVERIFY(table.sameContent(0, rekeyed));
+}
+
+void TestProcessTable::insertGapAndSet() {
+    ProcessTable table;
+    table.append(makeEntry(1, QStringLiteral("a")));
+    table.append(makeEntry(4, QStringLiteral("d")));
+    table.setStats(1, 250, 4096);
+
+    table.insertGap(1, 2);
+    QCOMPARE(table.count(), 4);
+    table.set(1, makeEntry(2, QStringLiteral("b")));
+    table.set(2, makeEntry(3, QStringLiteral("c")));
+    for (int row = 0; row < 4; ++row) {
+        QCOMPARE(table.pid(row), qint64(row + 1));
+    }
+    QCOMPARE(table.name(2), QStringLiteral("c"));
+    // 原有行的采样值随行移动，新行为 0
+    QCOMPARE(table.cpuPermille(3), quint16(250));
+    QCOMPARE(table.workingSet(3), quint64(4096));
+    QCOMPARE(table.cpuPermille(1), quint16(0));
+
+    // set 只替换元数据
+    table.set(3, makeEntry(4, QStringLiteral("d-after-exec")));
+    QCOMPARE(table.name(3), QStringLiteral("d-after-exec"));
+    QCOMPARE(table.cpuPermille(3), quint16(250));
+
+    table.insertGap(4, 1);
+    table.set(4, makeEntry(5, QStringLiteral("e")));
+    QCOMPARE(table.name(4), QStringLiteral("e"));
+}
+
+void TestProcessTable::statsColumns() {
+    ProcessTable table;
+    table.append(makeEntry(1, QStringLiteral("a")));
+    QVERIFY(table.setStats(0, 125, 1 << 20));
+    QVERIFY(!table.setStats(0, 125, 1 << 20));
+    QVERIFY(table.setStats(0, 125, 2 << 20));
+    QVERIFY(table.setStats(0, 0, 2 << 20));
+    QCOMPARE(table.cpuPermille(0), quint16(0));
+    QCOMPARE(table.workingSet(0), quint64(2 << 20));
+}
+
+void TestProcessTable::removeAndSwap() {
+    ProcessTable table;
+    for (qint64 pid = 1; pid <= 6; ++pid) {
+        table.append(makeEntry(pid, QStringLiteral("p%1").arg(pid)));
+        table.setStats(int(pid - 1), quint16(pid), quint64(pid));
+    }
+    table.remove(1, 3);
+    QCOMPARE(table.count(), 3);
+    QCOMPARE(table.pid(0), qint64(1));
+    QCOMPARE(table.pid(1), qint64(5));
+    QCOMPARE(table.name(1), QStringLiteral("p5"));
+    QCOMPARE(table.cpuPermille(1), quint16(5));
+    QCOMPARE(table.workingSet(2), quint64(6));
+
+    // 跨表复制一行：字符串驻留到目标表的池中，采样值一并复制
+    ProcessTable other;
+    other.append(table, 2);
+    QCOMPARE(other.count(), 1);
+    QCOMPARE(other.name(0), QStringLiteral("p6"));
+    QCOMPARE(other.cpuPermille(0), quint16(6));
+
+    table.swap(other);
+    QCOMPARE(table.count(), 1);
+    QCOMPARE(other.count(), 3);
+    QCOMPARE(other.name(1), QStringLiteral("p5"));
+    QCOMPARE(table.name(0), QStringLiteral("p6"));
+
+    table.clear();
+    QCOMPARE(table.count(), 0);
+    table.append(makeEntry(9, QStringLiteral("x")));
+    QCOMPARE(table.name(0), QStringLiteral("x"));
+}
+
+void TestProcessTable::compactStringsKeepsContent() {
+    ProcessTable table;
+    for (qint64 pid = 1; pid <= 10; ++pid) {
+        table.append(makeEntry(pid, QStringLiteral("keep-%1").arg(pid), QStringLiteral("/bin/keep")));
+    }
+    // 残留少时不重建
+    table.compactStrings();
+    const std::size_t small = table.memoryUsage();
+
+    // 同一行反复替换为新名称，池中残留大量不再引用的字符串
+    for (int i = 0; i < 5000; ++i) {
+        table.set(0, makeEntry(1, QStringLiteral("transient-%1-with-a-reasonably-long-name").arg(i), QStringLiteral("/bin/keep")));
+    }
+    const std::size_t bloated = table.memoryUsage();
+    QVERIFY(bloated > small);
+    table.compactStrings();
+    QVERIFY(table.memoryUsage() < bloated);
+
+    QCOMPARE(table.name(0), QStringLiteral("transient-4999-with-a-reasonably-long-name"));
+    for (int row = 1; row < table.count(); ++row) {
+        QCOMPARE(table.name(row), QStringLiteral("keep-%1").arg(row + 1));
+        QCOMPARE(table.exePath(row), QStringLiteral("/bin/keep"));
+    }
+}
+
+void TestProcessTable::matchesReferenceList() {
+    QRandomGenerator random(20260323);
+    static const QStringList names = {
+        QStringLiteral("chrome.exe"), QStringLiteral("svchost.exe"), QStringLiteral("bash"), QString(),
+    };
+    ProcessTable table;
+    QList<ProcessEntry> reference;
+    qint64 nextPid = 1;
+    for (int step = 0; step < 3000; ++step) {
+        const int operation = random.bounded(4);
+        if (operation == 0 && !reference.isEmpty()) {
+            const int first = random.bounded(int(reference.size()));
+            const int count = random.bounded(1, qMin(5, int(reference.size()) - first) + 1);
+            table.remove(first, count);
+            reference.remove(first, count);
+        }
+        else if (operation == 1) {
+            const int row = random.bounded(int(reference.size()) + 1);
+            const int count = random.bounded(1, 4);
+            table.insertGap(row, count);
+            for (int i = 0; i < count; ++i) {
+                const ProcessEntry entry = makeEntry(nextPid++, names.at(random.bounded(int(names.size()))),
+                    QStringLiteral("/opt/%1").arg(random.bounded(20)));
+                table.set(row + i, entry);
+                reference.insert(row + i, entry);
+            }
+        }
+        else if (operation == 2 && !reference.isEmpty()) {
+            const int row = random.bounded(int(reference.size()));
+            const ProcessEntry entry = makeEntry(reference.at(row).pid, QStringLiteral("exec-%1").arg(step));
+            table.set(row, entry);
+            reference[row] = entry;
+        }
+        else {
+            const ProcessEntry entry = makeEntry(nextPid++, names.at(random.bounded(int(names.size()))));
+            table.append(entry);
+            reference.append(entry);
+        }
+        table.compactStrings();
+    }
+    QCOMPARE(table.count(), int(reference.size()));
+    for (int row = 0; row < table.count(); ++row) {
+        QVERIFY2(sameEntry(table.entry(row), reference.at(row)), qPrintable(QString::number(row)));
+        QVERIFY(table.sameContent(row, reference.at(row)));
+    }
+}
+
+QTEST_APPLESS_MAIN(TestProcessTable)
+#include "tst_processtable.moc"
@@ -0,0 +1,210 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include <QRandomGenerator>
+#include <algorithm>
+#include "ProcessTree.h"
+
+namespace {
+ProcessEntry makeEntry(qint64 pid, qint64 parentPid, quint64 startTime) {
+    ProcessEntry entry;
+    entry.pid = pid;
+    entry.parentPid = parentPid;
+    entry.startTime = startTime;
+    return entry;
+}
+
+QList<qint64> childPids(const ProcessTree& tree, int node) {
+    QList<qint64> pids;
+    for (int row = 0; row < tree.childCount(node); ++row) {
+        pids.append(tree.pid(tree.child(node, row)));
+    }
+    return pids;
+}
+
+QList<qint64> subtreePids(const ProcessTree& tree, qint64 pid) {
+    std::vector<int> nodes;
+    tree.collectSubtree(tree.find(pid), nodes);
+    QList<qint64> pids;
+    for (int node : nodes) {
+        pids.append(tree.pid(node));
+    }
+    return pids;
+}
+
+// 检查结构自洽：每个节点恰好出现在其父节点的子列表中一次，row 与位置一致
+bool consistent(const ProcessTree& tree) {
+    int listed = 0;
+    for (int parent = -1; parent < tree.count(); ++parent) {
+        for (int row = 0; row < tree.childCount(parent); ++row) {
+            const int node = tree.child(parent, row);
+            if (tree.parent(node) != parent || tree.row(node) != row) {
+                return false;
+            }
+            ++listed;
+        }
+    }
+    return listed == tree.count();
+}
+} // namespace
+
+class TestProcessTree : public QObject {
+    Q_OBJECT
+private slots:
+    void buildsForest();
+    void childrenKeepSnapshotOrder();
+    void missingParentIsRoot();
+    void reusedParentPidIsRoot();
+    void cyclesAreBroken();
+    void collectSubtree();
+    void clearAndRebuild();
+    void randomSnapshotsStayConsistent();
+};
+
+void TestProcessTree::buildsForest() {
+    ProcessTree tree;
+    QCOMPARE(tree.count(), 0);
+    QCOMPARE(tree.childCount(-1), 0);
+
+    tree.build({
+        makeEntry(1, 0, 1),
+        makeEntry(10, 1, 2),
+        makeEntry(11, 1, 3),
+        makeEntry(100, 10, 4),
+        makeEntry(500, 0, 5),
+    });
+    QCOMPARE(tree.count(), 5);
+    QCOMPARE(childPids(tree, -1), (QList<qint64>{ 1, 500 }));
+    QCOMPARE(childPids(tree, tree.find(1)), (QList<qint64>{ 10, 11 }));
+    QCOMPARE(childPids(tree, tree.find(10)), QList<qint64>{ 100 });
+    QCOMPARE(tree.childCount(tree.find(100)), 0);
+    QCOMPARE(tree.parent(tree.find(100)), tree.find(10));
+    QCOMPARE(tree.parent(tree.find(1)), -1);
+    QCOMPARE(tree.row(tree.find(11)), 1);
+    QCOMPARE(tree.row(tree.find(500)), 1);
+    // 节点号即快照中的位置
+    QCOMPARE(tree.find(100), 3);
+    QCOMPARE(tree.find(42), -1);
+    QVERIFY(consistent(tree));
+}
+
+void TestProcessTree::childrenKeepSnapshotOrder() {
+    ProcessTree tree;
+    // 子进程在快照中先于父进程出现也能挂上
+    tree.build({ makeEntry(30, 2, 9), makeEntry(20, 2, 8), makeEntry(2, 0, 1), makeEntry(25, 2, 7) });
+    QCOMPARE(childPids(tree, tree.find(2)), (QList<qint64>{ 30, 20, 25 }));
+    QCOMPARE(childPids(tree, -1), QList<qint64>{ 2 });
+    QVERIFY(consistent(tree));
+}
+
+void TestProcessTree::missingParentIsRoot() {
+    ProcessTree tree;
+    // 父进程已退出；自己是自己的父进程（System Idle Process 的 PID 0）
+    tree.build({ makeEntry(0, 0, 0), makeEntry(7, 99, 5), makeEntry(8, 7, 6) });
+    QCOMPARE(childPids(tree, -1), (QList<qint64>{ 0, 7 }));
+    QCOMPARE(childPids(tree, tree.find(7)), QList<qint64>{ 8 });
+    QVERIFY(consistent(tree));
+}
+
+void TestProcessTree::reusedParentPidIsRoot() {
+    ProcessTree tree;
+    // 子进程记录的父 PID 已被一个更晚创建的进程复用
+    tree.build({ makeEntry(40, 1, 1000), makeEntry(41, 40, 500), makeEntry(42, 40, 1500) });
+    QCOMPARE(childPids(tree, -1), (QList<qint64>{ 40, 41 }));
+    QCOMPARE(childPids(tree, tree.find(40)), QList<qint64>{ 42 });
+
+    // 创建时间未知（为 0）时不做判断
+    tree.build({ makeEntry(40, 1, 1000), makeEntry(41, 40, 0) });
+    QCOMPARE(childPids(tree, tree.find(40)), QList<qint64>{ 41 });
+    QVERIFY(consistent(tree));
+}
+
+void TestProcessTree::cyclesAreBroken() {
+    ProcessTree tree;
+    // 创建时间相同的异常数据互为父子
+    tree.build({ makeEntry(1, 3, 5), makeEntry(2, 1, 5), makeEntry(3, 2, 5), makeEntry(4, 3, 6) });
+    QCOMPARE(tree.childCount(-1), 1);
+    QVERIFY(consistent(tree));
+    std::vector<int> all;
+    tree.collectSubtree(tree.child(-1, 0), all);
+    QCOMPARE(all.size(), std::size_t(4));
+
+    tree.build({ makeEntry(9, 9, 1) });
+    QCOMPARE(childPids(tree, -1), QList<qint64>{ 9 });
+}
+
+void TestProcessTree::collectSubtree() {
+    ProcessTree tree;
+    tree.build({
+        makeEntry(1, 0, 1),
+        makeEntry(2, 1, 2),
+        makeEntry(3, 1, 3),
+        makeEntry(4, 2, 4),
+        makeEntry(5, 4, 5),
+        makeEntry(6, 3, 6),
+        makeEntry(7, 0, 7),
+    });
+    // 层序：先自身，再逐层展开
+    QCOMPARE(subtreePids(tree, 1), (QList<qint64>{ 1, 2, 3, 4, 6, 5 }));
+    QCOMPARE(subtreePids(tree, 2), (QList<qint64>{ 2, 4, 5 }));
+    QCOMPARE(subtreePids(tree, 7), QList<qint64>{ 7 });
+
+    // 追加到 out 末尾，不清空已有内容
+    std::vector<int> out{ -5 };
+    tree.collectSubtree(tree.find(3), out);
+    QCOMPARE(out.size(), std::size_t(3));
+    QCOMPARE(out.front(), -5);
+}
+
+void TestProcessTree::clearAndRebuild() {
+    ProcessTree tree;
+    tree.build({ makeEntry(1, 0, 1), makeEntry(2, 1, 2) });
+    tree.clear();
+    QCOMPARE(tree.count(), 0);
+    QCOMPARE(tree.childCount(-1), 0);
+    QCOMPARE(tree.find(1), -1);
+
+    tree.build({ makeEntry(5, 0, 1) });
+    QCOMPARE(tree.count(), 1);
+    QCOMPARE(tree.find(5), 0);
+    QCOMPARE(tree.find(1), -1);
+    QVERIFY(consistent(tree));
+}
+
+void TestProcessTree::randomSnapshotsStayConsistent() {
+    QRandomGenerator random(20260321);
+    ProcessTree tree;
+    for (int round = 0; round < 50; ++round) {
+        QList<ProcessEntry> entries;
+        const int count = random.bounded(1, 400);
+        QList<qint64> pids;
+        for (int i = 0; i < count; ++i) {
+            pids.append(random.bounded(1, 1000));
+        }
+        std::sort(pids.begin(), pids.end());
+        pids.erase(std::unique(pids.begin(), pids.end()), pids.end());
+        for (qint64 pid : std::as_const(pids)) {
+            // 父 PID 常常不存在或指向更晚的进程，创建时间经常相同
+            entries.append(makeEntry(pid, random.bounded(0, 1000), quint64(random.bounded(0, 20))));
+        }
+        tree.build(entries);
+        QVERIFY2(consistent(tree), qPrintable(QString::number(round)));
+        // 所有节点都能从某个根到达
+        std::vector<int> reached;
+        for (int row = 0; row < tree.childCount(-1); ++row) {
+            tree.collectSubtree(tree.child(-1, row), reached);
+        }
+        QCOMPARE(reached.size(), std::size_t(tree.count()));
+    }
+}
+
+QTEST_APPLESS_MAIN(TestProcessTree)
+#include "tst_processtree.moc"
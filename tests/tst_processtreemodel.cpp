@@ -0,0 +1,304 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include <QSignalSpy>
+#include "ProcessListModel.h"
+#include "ProcessTreeModel.h"
+
+namespace {
+ProcessEntry makeEntry(qint64 pid, qint64 parentPid, const QString& name) {
+    ProcessEntry entry;
+    entry.pid = pid;
+    entry.parentPid = parentPid;
+    entry.startTime = static_cast<quint64>(pid) * 10;
+    entry.name = name;
+    return entry;
+}
+
+ProcessEvent startedEvent(const ProcessEntry& entry) {
+    ProcessEvent event;
+    event.kind = ProcessEvent::Started;
+    event.entry = entry;
+    return event;
+}
+
+ProcessEvent exitedEvent(qint64 pid) {
+    ProcessEvent event;
+    event.kind = ProcessEvent::Exited;
+    event.entry.pid = pid;
+    return event;
+}
+
+void makeQuiet(ProcessListModel& model) {
+    model.setLiveUpdates(false);
+    model.setStatsInterval(0);
+}
+
+qint64 pidOf(const QModelIndex& index) {
+    return index.data(ProcessListModel::PidRole).toLongLong();
+}
+
+QList<qint64> childPids(const ProcessTreeModel& model, const QModelIndex& parent) {
+    QList<qint64> pids;
+    for (int row = 0; row < model.rowCount(parent); ++row) {
+        pids.append(pidOf(model.index(row, 0, parent)));
+    }
+    return pids;
+}
+
+QModelIndex findPid(const ProcessTreeModel& model, qint64 pid, const QModelIndex& parent = QModelIndex()) {
+    for (int row = 0; row < model.rowCount(parent); ++row) {
+        const QModelIndex index = model.index(row, 0, parent);
+        if (pidOf(index) == pid) {
+            return index;
+        }
+        const QModelIndex found = findPid(model, pid, index);
+        if (found.isValid()) {
+            return found;
+        }
+    }
+    return QModelIndex();
+}
+
+QList<ProcessEntry> sampleProcesses() {
+    // init -> sshd -> bash -> vim；init -> cron；systemd-journald 的父进程已退出
+    return {
+        makeEntry(1, 0, QStringLiteral("init")),
+        makeEntry(20, 1, QStringLiteral("sshd")),
+        makeEntry(30, 1, QStringLiteral("cron")),
+        makeEntry(40, 20, QStringLiteral("bash")),
+        makeEntry(50, 40, QStringLiteral("vim")),
+        makeEntry(60, 999, QStringLiteral("systemd-journald")),
+    };
+}
+} // namespace
+
+class TestProcessTreeModel : public QObject {
+    Q_OBJECT
+private slots:
+    void buildsHierarchy();
+    void parentAndSibling();
+    void mapping();
+    void subtreePids();
+    void eventsRelayoutOnce();
+    void persistentIndexFollowsPid();
+    void exitedProcessIndexInvalidated();
+    void parentChangeRelayouts();
+    void dataChangeForwarded();
+    void sourceReset();
+};
+
+void TestProcessTreeModel::buildsHierarchy() {
+    ProcessListModel source;
+    makeQuiet(source);
+    source.applySnapshot(sampleProcesses());
+    ProcessTreeModel tree;
+    QCOMPARE(tree.rowCount(), 0);
+    QCOMPARE(tree.columnCount(), 0);
+    tree.setSourceModel(&source);
+
+    QCOMPARE(tree.columnCount(), 1);
+    QCOMPARE(childPids(tree, QModelIndex()), (QList<qint64>{ 1, 60 }));
+    const QModelIndex init = tree.index(0, 0);
+    QVERIFY(tree.hasChildren(init));
+    QCOMPARE(childPids(tree, init), (QList<qint64>{ 20, 30 }));
+    const QModelIndex sshd = tree.index(0, 0, init);
+    QCOMPARE(childPids(tree, sshd), QList<qint64>{ 40 });
+    const QModelIndex vim = findPid(tree, 50);
+    QVERIFY(vim.isValid());
+    QVERIFY(!tree.hasChildren(vim));
+    QCOMPARE(vim.data(ProcessListModel::NameRole).toString(), QStringLiteral("vim"));
+    QCOMPARE(tree.tree().count(), 6);
+
+    // 越界与非零列的父索引
+    QVERIFY(!tree.index(2, 0).isValid());
+    QVERIFY(!tree.index(0, 1).isValid());
+    QVERIFY(!tree.index(-1, 0).isValid());
+}
+
+void TestProcessTreeModel::parentAndSibling() {
+    ProcessListModel source;
+    makeQuiet(source);
+    source.applySnapshot(sampleProcesses());
+    ProcessTreeModel tree;
+    tree.setSourceModel(&source);
+
+    const QModelIndex bash = findPid(tree, 40);
+    QCOMPARE(pidOf(tree.parent(bash)), qint64(20));
+    QCOMPARE(pidOf(tree.parent(tree.parent(bash))), qint64(1));
+    QVERIFY(!tree.parent(tree.index(0, 0)).isValid());
+    QVERIFY(!tree.parent(QModelIndex()).isValid());
+
+    // 兄弟是树中的兄弟，不是源模型中的相邻行
+    const QModelIndex sshd = findPid(tree, 20);
+    QCOMPARE(pidOf(tree.sibling(1, 0, sshd)), qint64(30));
+    QCOMPARE(pidOf(tree.sibling(1, 0, tree.index(0, 0))), qint64(60));
+    QVERIFY(!tree.sibling(2, 0, sshd).isValid());
+}
+
+void TestProcessTreeModel::mapping() {
+    ProcessListModel source;
+    makeQuiet(source);
+    source.applySnapshot(sampleProcesses());
+    ProcessTreeModel tree;
+    tree.setSourceModel(&source);
+
+    for (int row = 0; row < source.rowCount(); ++row) {
+        const QModelIndex sourceIndex = source.index(row);
+        const QModelIndex proxy = tree.mapFromSource(sourceIndex);
+        QVERIFY(proxy.isValid());
+        QCOMPARE(pidOf(proxy), pidOf(sourceIndex));
+        QCOMPARE(tree.mapToSource(proxy), sourceIndex);
+    }
+    QVERIFY(!tree.mapToSource(QModelIndex()).isValid());
+    QVERIFY(!tree.mapFromSource(QModelIndex()).isValid());
+
+    ProcessListModel other;
+    makeQuiet(other);
+    other.applySnapshot(sampleProcesses());
+    QVERIFY(!tree.mapFromSource(other.index(0)).isValid());
+}
+
+void TestProcessTreeModel::subtreePids() {
+    ProcessListModel source;
+    makeQuiet(source);
+    source.applySnapshot(sampleProcesses());
+    ProcessTreeModel tree;
+    tree.setSourceModel(&source);
+
+    QCOMPARE(tree.subtreePids(20), (QVariantList{ qint64(20), qint64(40), qint64(50) }));
+    QCOMPARE(tree.subtreePids(1).size(), qsizetype(5));
+    QCOMPARE(tree.subtreePids(60), QVariantList{ qint64(60) });
+    QVERIFY(tree.subtreePids(12345).isEmpty());
+}
+
+void TestProcessTreeModel::eventsRelayoutOnce() {
+    ProcessListModel source;
+    makeQuiet(source);
+    source.applySnapshot(sampleProcesses());
+    ProcessTreeModel tree;
+    tree.setSourceModel(&source);
+    QSignalSpy aboutToChange(&tree, &ProcessTreeModel::layoutAboutToBeChanged);
+    QSignalSpy changed(&tree, &ProcessTreeModel::layoutChanged);
+
+    // 同一轮事件循环中的多次增删合并为一次重建
+    source.applyEvents({ startedEvent(makeEntry(45, 40, QStringLiteral("make"))) });
+    source.applyEvents({ startedEvent(makeEntry(46, 45, QStringLiteral("cc"))) });
+    source.applyEvents({ exitedEvent(30) });
+    QCOMPARE(changed.count(), 0);
+    // 重建前已退出的行不再对应源行，新行尚未出现
+    QCOMPARE(tree.tree().count(), 6);
+    QVERIFY(!findPid(tree, 45).isValid());
+
+    QTRY_COMPARE(changed.count(), 1);
+    QCOMPARE(aboutToChange.count(), 1);
+    QCOMPARE(childPids(tree, findPid(tree, 1)), QList<qint64>{ 20 });
+    QCOMPARE(childPids(tree, findPid(tree, 40)), (QList<qint64>{ 45, 50 }));
+    QCOMPARE(childPids(tree, findPid(tree, 45)), QList<qint64>{ 46 });
+    QCOMPARE(findPid(tree, 46).data(ProcessListModel::NameRole).toString(), QStringLiteral("cc"));
+}
+
+void TestProcessTreeModel::persistentIndexFollowsPid() {
+    ProcessListModel source;
+    makeQuiet(source);
+    source.applySnapshot(sampleProcesses());
+    ProcessTreeModel tree;
+    tree.setSourceModel(&source);
+
+    const QPersistentModelIndex vim = findPid(tree, 50);
+    const QPersistentModelIndex cron = findPid(tree, 30);
+    // 在 cron 之前插入兄弟进程：cron 的行号后移，父节点与 PID 不变
+    source.applyEvents({ startedEvent(makeEntry(25, 1, QStringLiteral("atd"))) });
+    QTRY_COMPARE(childPids(tree, findPid(tree, 1)), (QList<qint64>{ 20, 25, 30 }));
+    QVERIFY(vim.isValid());
+    QCOMPARE(pidOf(vim), qint64(50));
+    QVERIFY(cron.isValid());
+    QCOMPARE(cron.row(), 2);
+    QCOMPARE(pidOf(cron), qint64(30));
+}
+
+void TestProcessTreeModel::exitedProcessIndexInvalidated() {
+    ProcessListModel source;
+    makeQuiet(source);
+    source.applySnapshot(sampleProcesses());
+    ProcessTreeModel tree;
+    tree.setSourceModel(&source);
+    const QPersistentModelIndex bash = findPid(tree, 40);
+    QSignalSpy changed(&tree, &ProcessTreeModel::layoutChanged);
+
+    // bash 退出后 vim 的父进程不在快照中，成为根节点
+    source.applyEvents({ exitedEvent(40) });
+    // 重建前已删除行的节点不再映射到源行
+    QVERIFY(!tree.mapToSource(bash).isValid());
+    QTRY_COMPARE(changed.count(), 1);
+    QVERIFY(!bash.isValid());
+    QCOMPARE(childPids(tree, QModelIndex()), (QList<qint64>{ 1, 50, 60 }));
+}
+
+void TestProcessTreeModel::parentChangeRelayouts() {
+    // 父 PID 变化的 dataChanged 立即重建，无需等待事件循环
+    ProcessListModel source;
+    makeQuiet(source);
+    source.applySnapshot(sampleProcesses());
+    ProcessTreeModel tree;
+    tree.setSourceModel(&source);
+    QSignalSpy changed(&tree, &ProcessTreeModel::layoutChanged);
+
+    ProcessEntry reparented = makeEntry(60, 1, QStringLiteral("systemd-journald"));
+    source.applyEvents({ startedEvent(reparented) });
+    QCOMPARE(changed.count(), 1);
+    QCOMPARE(childPids(tree, findPid(tree, 1)), (QList<qint64>{ 20, 30, 60 }));
+}
+
+void TestProcessTreeModel::dataChangeForwarded() {
+    ProcessListModel source;
+    makeQuiet(source);
+    source.applySnapshot(sampleProcesses());
+    ProcessTreeModel tree;
+    tree.setSourceModel(&source);
+    QSignalSpy dataChanged(&tree, &ProcessTreeModel::dataChanged);
+    QSignalSpy layoutChanged(&tree, &ProcessTreeModel::layoutChanged);
+
+    // exec 只改变名称：不重建，转发到树中对应的节点
+    source.applyEvents({ startedEvent(makeEntry(50, 40, QStringLiteral("nvim"))) });
+    QCOMPARE(layoutChanged.count(), 0);
+    QCOMPARE(dataChanged.count(), 1);
+    const QModelIndex forwarded = dataChanged.at(0).at(0).value<QModelIndex>();
+    QCOMPARE(pidOf(forwarded), qint64(50));
+    QCOMPARE(forwarded.data(ProcessListModel::NameRole).toString(), QStringLiteral("nvim"));
+}
+
+void TestProcessTreeModel::sourceReset() {
+    ProcessListModel source;
+    makeQuiet(source);
+    source.applySnapshot(sampleProcesses());
+    ProcessTreeModel tree;
+    tree.setSourceModel(&source);
+    QSignalSpy reset(&tree, &ProcessTreeModel::modelReset);
+
+    source.setIncrementalRefresh(false);
+    source.applySnapshot({ makeEntry(7, 0, QStringLiteral("a")), makeEntry(8, 7, QStringLiteral("b")) });
+    QCOMPARE(reset.count(), 1);
+    QCOMPARE(childPids(tree, QModelIndex()), QList<qint64>{ 7 });
+    QCOMPARE(childPids(tree, tree.index(0, 0)), QList<qint64>{ 8 });
+
+    // 把父 PID 角色换成 PID 角色：每个进程都是自己的父进程，全部成为根节点
+    tree.setTreeRoles(ProcessListModel::PidRole, ProcessListModel::PidRole, ProcessListModel::StartTimeRole);
+    QCOMPARE(reset.count(), 2);
+    QCOMPARE(childPids(tree, QModelIndex()), (QList<qint64>{ 7, 8 }));
+
+    tree.setSourceModel(nullptr);
+    QCOMPARE(tree.rowCount(), 0);
+    QCOMPARE(tree.columnCount(), 0);
+}
+
+QTEST_GUILESS_MAIN(TestProcessTreeModel)
+#include "tst_processtreemodel.moc"
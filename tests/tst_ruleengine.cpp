@@ -0,0 +1,285 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include <QRandomGenerator>
+#include "RuleEngine.h"
+
+namespace {
+RuleSubject subject(QStringView exeName, QStringView className = {}, QStringView title = {}, QStringView exePath = {}) {
+    RuleSubject result;
+    result.exeName = exeName;
+    result.className = className;
+    result.title = title;
+    result.exePath = exePath;
+    return result;
+}
+
+QString randomText(QRandomGenerator& random, int maxLength, bool wildcards) {
+    static const char16_t plain[] = u"abcAB.";
+    static const char16_t withWildcards[] = u"abcAB.*?";
+    const int length = random.bounded(wildcards ? 1 : 0, maxLength + 1);
+    QString text;
+    for (int i = 0; i < length; ++i) {
+        text.append(QChar(wildcards ? withWildcards[random.bounded(8)] : plain[random.bounded(6)]));
+    }
+    return text;
+}
+} // namespace
+
+class TestRuleEngine : public QObject {
+    Q_OBJECT
+private slots:
+    void parse();
+    void parseErrors_data();
+    void parseErrors();
+    void globMatch_data();
+    void globMatch();
+    void patternKinds_data();
+    void patternKinds();
+    void conjunction();
+    void firstMatchAndMatchAll();
+    void pathSeparators();
+    void compileIsExplicit();
+    void removeAndClear();
+    void matchesNaiveEvaluation();
+};
+
+void TestRuleEngine::parse() {
+    HideRule rule;
+    QVERIFY(HideRule::parse(QStringLiteral("  CLASS: Chrome_WidgetWin_1 &&title:*Netflix*  "), rule));
+    QCOMPARE(rule.text, QStringLiteral("CLASS: Chrome_WidgetWin_1 &&title:*Netflix*"));
+    QCOMPARE(rule.conditions.size(), qsizetype(2));
+    QCOMPARE(rule.conditions.at(0).field, RuleField::ClassName);
+    QCOMPARE(rule.conditions.at(0).pattern, QStringLiteral("Chrome_WidgetWin_1"));
+    QCOMPARE(rule.conditions.at(1).field, RuleField::Title);
+    QCOMPARE(rule.conditions.at(1).pattern, QStringLiteral("*Netflix*"));
+
+    // 模式中的冒号属于模式本身
+    QVERIFY(HideRule::parse(QStringLiteral("path:C:\\Games\\*"), rule));
+    QCOMPARE(rule.conditions.at(0).field, RuleField::ExePath);
+    QCOMPARE(rule.conditions.at(0).pattern, QStringLiteral("C:\\Games\\*"));
+}
+
+void TestRuleEngine::parseErrors_data() {
+    QTest::addColumn<QString>("line");
+    QTest::addColumn<QString>("error");
+
+    QTest::newRow("empty") << "   " << "empty rule";
+    QTest::newRow("no field") << "slack.exe" << "expected exe:, path:, class: or title: in \"slack.exe\"";
+    QTest::newRow("unknown field") << "pid:42" << "expected exe:, path:, class: or title: in \"pid:42\"";
+    QTest::newRow("missing field") << ":x" << "expected exe:, path:, class: or title: in \":x\"";
+    QTest::newRow("empty pattern") << "exe: " << "empty pattern in \"exe:\"";
+    QTest::newRow("empty condition") << "exe:a &&" << "expected exe:, path:, class: or title: in \"\"";
+}
+
+void TestRuleEngine::parseErrors() {
+    QFETCH(QString, line);
+    QFETCH(QString, error);
+    HideRule rule;
+    QString message;
+    QVERIFY(!HideRule::parse(line, rule, &message));
+    QCOMPARE(message, error);
+
+    RuleEngine engine;
+    QCOMPARE(engine.addRule(line), -1);
+    QVERIFY(engine.isEmpty());
+}
+
+void TestRuleEngine::globMatch_data() {
+    QTest::addColumn<QString>("pattern");
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<bool>("matches");
+
+    QTest::newRow("exact") << "abc" << "abc" << true;
+    QTest::newRow("case") << "ABC" << "abc" << true;
+    QTest::newRow("longer text") << "abc" << "abcd" << false;
+    QTest::newRow("star") << "*" << "" << true;
+    QTest::newRow("star any") << "*" << "anything" << true;
+    QTest::newRow("question") << "a?c" << "abc" << true;
+    QTest::newRow("question empty") << "a?c" << "ac" << false;
+    QTest::newRow("backtrack") << "*ab*ab" << "xabyabab" << true;
+    QTest::newRow("backtrack fail") << "*ab*abc" << "xabyabab" << false;
+    QTest::newRow("trailing stars") << "a**" << "a" << true;
+    QTest::newRow("middle") << "s*k.exe" << "slack.exe" << true;
+}
+
+void TestRuleEngine::globMatch() {
+    QFETCH(QString, pattern);
+    QFETCH(QString, text);
+    QFETCH(bool, matches);
+    QCOMPARE(RuleEngine::globMatch(pattern, text, AhoCorasick::CaseInsensitive), matches);
+}
+
+void TestRuleEngine::patternKinds_data() {
+    QTest::addColumn<QString>("rule");
+    QTest::addColumn<QString>("exe");
+    QTest::addColumn<bool>("matches");
+
+    // 每种编译形式（全等、前缀、后缀、包含、通配符、纯 *）各取命中与不命中
+    QTest::newRow("equals") << "exe:slack.exe" << "Slack.EXE" << true;
+    QTest::newRow("equals longer") << "exe:slack.exe" << "slack.exe.bak" << false;
+    QTest::newRow("equals inside") << "exe:slack.exe" << "myslack.exe" << false;
+    QTest::newRow("prefix") << "exe:chrome*" << "chrome_proxy.exe" << true;
+    QTest::newRow("prefix not at start") << "exe:chrome*" << "xchrome.exe" << false;
+    QTest::newRow("suffix") << "exe:*.scr" << "bubbles.scr" << true;
+    QTest::newRow("suffix not at end") << "exe:*.scr" << "a.scr.exe" << false;
+    QTest::newRow("contains") << "exe:*team*" << "MS-Teams.exe" << true;
+    QTest::newRow("contains missing") << "exe:*team*" << "slack.exe" << false;
+    QTest::newRow("glob") << "exe:s?ack*.exe" << "slack64.exe" << true;
+    QTest::newRow("glob prefiltered") << "exe:s?ack*.exe" << "slack64.dll" << false;
+    QTest::newRow("only star") << "exe:*" << "anything.exe" << true;
+    QTest::newRow("only star empty") << "exe:*" << "" << true;
+    QTest::newRow("only question") << "exe:?" << "ab" << false;
+}
+
+void TestRuleEngine::patternKinds() {
+    QFETCH(QString, rule);
+    QFETCH(QString, exe);
+    QFETCH(bool, matches);
+    RuleEngine engine;
+    const int id = engine.addRule(rule);
+    QVERIFY(id > 0);
+    engine.compile();
+    QCOMPARE(engine.match(subject(exe)), matches ? id : -1);
+}
+
+void TestRuleEngine::conjunction() {
+    RuleEngine engine;
+    const int id = engine.addRule(QStringLiteral("class:Chrome_WidgetWin_1 && title:*Netflix*"));
+    engine.compile();
+    QVERIFY(engine.usesField(RuleField::ClassName));
+    QVERIFY(engine.usesField(RuleField::Title));
+    QVERIFY(!engine.usesField(RuleField::ExeName));
+    QVERIFY(!engine.usesField(RuleField::ExePath));
+
+    QCOMPARE(engine.match(subject({}, u"Chrome_WidgetWin_1", u"Netflix - Google Chrome")), id);
+    QCOMPARE(engine.match(subject({}, u"Chrome_WidgetWin_1", u"Inbox - Google Chrome")), -1);
+    QCOMPARE(engine.match(subject({}, u"MozillaWindowClass", u"Netflix - Firefox")), -1);
+    // 同一条件在文本中多次出现只算一次
+    QCOMPARE(engine.match(subject({}, u"Other", u"Netflix Netflix Netflix")), -1);
+}
+
+void TestRuleEngine::firstMatchAndMatchAll() {
+    RuleEngine engine;
+    const int contains = engine.addRule(QStringLiteral("title:*video*"));
+    const int exact = engine.addRule(QStringLiteral("exe:player.exe"));
+    const int other = engine.addRule(QStringLiteral("exe:other.exe"));
+    const int both = engine.addRule(QStringLiteral("exe:player.exe && title:*video*"));
+    engine.compile();
+    QCOMPARE(engine.ruleCount(), 4);
+    QCOMPARE(engine.ruleText(exact), QStringLiteral("exe:player.exe"));
+    QCOMPARE(engine.ruleText(999), QString());
+
+    const RuleSubject player = subject(u"player.exe", {}, u"My Video");
+    // 按添加顺序取第一条
+    QCOMPARE(engine.match(player), contains);
+    std::vector<int> all;
+    engine.matchAll(player, all);
+    QCOMPARE(all, (std::vector<int>{ contains, exact, both }));
+
+    engine.matchAll(subject(u"other.exe"), all);
+    QCOMPARE(all, std::vector<int>{ other });
+    engine.matchAll(subject(u"none.exe"), all);
+    QVERIFY(all.empty());
+}
+
+void TestRuleEngine::pathSeparators() {
+    RuleEngine engine;
+    const int id = engine.addRule(QStringLiteral("path:C:/Games/*"));
+    engine.compile();
+    QCOMPARE(engine.match(subject({}, {}, {}, u"c:\\games\\doom.exe")), id);
+    QCOMPARE(engine.match(subject({}, {}, {}, u"D:\\games\\doom.exe")), -1);
+
+    // 只有 path 字段统一分隔符
+    const int title = engine.addRule(QStringLiteral("title:a/b"));
+    engine.compile();
+    QCOMPARE(engine.match(subject({}, {}, u"a\\b")), -1);
+    QCOMPARE(engine.match(subject({}, {}, u"a/b")), title);
+}
+
+void TestRuleEngine::compileIsExplicit() {
+    RuleEngine engine;
+    QVERIFY(!engine.needsCompile());
+    const int id = engine.addRule(QStringLiteral("exe:slack.exe"));
+    QVERIFY(engine.needsCompile());
+    // 编译前沿用上一次的编译结果
+    QCOMPARE(engine.match(subject(u"slack.exe")), -1);
+    engine.compile();
+    QVERIFY(!engine.needsCompile());
+    QCOMPARE(engine.match(subject(u"slack.exe")), id);
+}
+
+void TestRuleEngine::removeAndClear() {
+    RuleEngine engine;
+    const int a = engine.addRule(QStringLiteral("exe:a.exe"));
+    const int b = engine.addRule(QStringLiteral("exe:b.exe"));
+    engine.compile();
+    QVERIFY(engine.removeRule(a));
+    QVERIFY(!engine.removeRule(a));
+    engine.compile();
+    QCOMPARE(engine.ruleTexts(), QStringList{ "exe:b.exe" });
+    QCOMPARE(engine.match(subject(u"a.exe")), -1);
+    QCOMPARE(engine.match(subject(u"b.exe")), b);
+
+    // id 不复用
+    const int c = engine.addRule(QStringLiteral("exe:a.exe"));
+    QVERIFY(c > b);
+
+    engine.clear();
+    engine.compile();
+    QVERIFY(engine.isEmpty());
+    QCOMPARE(engine.match(subject(u"b.exe")), -1);
+    QVERIFY(!engine.usesField(RuleField::ExeName));
+}
+
+void TestRuleEngine::matchesNaiveEvaluation() {
+    // 与逐条规则、逐个条件做通配符匹配的结果对照
+    QRandomGenerator random(20260318);
+    for (int round = 0; round < 100; ++round) {
+        RuleEngine engine;
+        std::vector<HideRule> rules;
+        const int ruleCount = random.bounded(1, 8);
+        for (int i = 0; i < ruleCount; ++i) {
+            QString text = QStringLiteral("exe:") + randomText(random, 5, true);
+            if (random.bounded(2)) {
+                text += QStringLiteral(" && title:") + randomText(random, 4, true);
+            }
+            HideRule rule;
+            QVERIFY(HideRule::parse(text, rule));
+            rule.id = engine.addRule(text);
+            rules.push_back(rule);
+        }
+        engine.compile();
+
+        for (int probe = 0; probe < 20; ++probe) {
+            const QString exe = randomText(random, 8, false);
+            const QString title = randomText(random, 8, false);
+            std::vector<int> expected;
+            for (const HideRule& rule : rules) {
+                bool all = true;
+                for (const RuleCondition& condition : rule.conditions) {
+                    const QString& text = condition.field == RuleField::ExeName ? exe : title;
+                    all = all && RuleEngine::globMatch(condition.pattern, text, AhoCorasick::CaseInsensitive);
+                }
+                if (all) {
+                    expected.push_back(rule.id);
+                }
+            }
+            std::vector<int> actual;
+            engine.matchAll(subject(exe, {}, title), actual);
+            QVERIFY2(actual == expected, qPrintable(exe + QLatin1Char('|') + title + QLatin1Char('|') + engine.ruleTexts().join(QLatin1Char(';'))));
+            QCOMPARE(engine.match(subject(exe, {}, title)), expected.empty() ? -1 : expected.front());
+        }
+    }
+}
+
+QTEST_APPLESS_MAIN(TestRuleEngine)
+#include "tst_ruleengine.moc"
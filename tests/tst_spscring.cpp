@@ -0,0 +1,181 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include <QThread>
+#include "SpscRing.h"
+
+namespace {
+constexpr int kConcurrentCount = 200000;
+} // namespace
+
+class TestSpscRing : public QObject {
+    Q_OBJECT
+private slots:
+    void capacityRoundsUp_data();
+    void capacityRoundsUp();
+    void fifoOrder();
+    void dropNewestWhenFull();
+    void dropOldestWhenFull();
+    void wrapAround();
+    void concurrentLossless();
+    void concurrentDropOldest();
+};
+
+void TestSpscRing::capacityRoundsUp_data() {
+    QTest::addColumn<int>("requested");
+    QTest::addColumn<int>("capacity");
+
+    QTest::newRow("zero") << 0 << 2;
+    QTest::newRow("one") << 1 << 2;
+    QTest::newRow("two") << 2 << 2;
+    QTest::newRow("three") << 3 << 4;
+    QTest::newRow("power of two") << 64 << 64;
+    QTest::newRow("thousand") << 1000 << 1024;
+}
+
+void TestSpscRing::capacityRoundsUp() {
+    QFETCH(int, requested);
+    QFETCH(int, capacity);
+    SpscRing<int> ring(static_cast<std::size_t>(requested));
+    QCOMPARE(ring.capacity(), static_cast<std::size_t>(capacity));
+}
+
+void TestSpscRing::fifoOrder() {
+    SpscRing<int> ring(8);
+    int value = -1;
+    QVERIFY(!ring.pop(value));
+    for (int i = 0; i < 5; ++i) {
+        QVERIFY(ring.push(i));
+    }
+    for (int i = 0; i < 5; ++i) {
+        QVERIFY(ring.pop(value));
+        QCOMPARE(value, i);
+    }
+    QVERIFY(!ring.pop(value));
+    QCOMPARE(ring.droppedCount(), std::uint64_t(0));
+}
+
+void TestSpscRing::dropNewestWhenFull() {
+    SpscRing<int> ring(4);
+    QCOMPARE(ring.overflowPolicy(), SpscRing<int>::OverflowPolicy::DropNewest);
+    for (int i = 0; i < 4; ++i) {
+        QVERIFY(ring.push(i));
+    }
+    QVERIFY(!ring.push(4));
+    QVERIFY(!ring.push(5));
+    QCOMPARE(ring.droppedCount(), std::uint64_t(2));
+
+    int value = -1;
+    for (int i = 0; i < 4; ++i) {
+        QVERIFY(ring.pop(value));
+        QCOMPARE(value, i);
+    }
+    QVERIFY(!ring.pop(value));
+}
+
+void TestSpscRing::dropOldestWhenFull() {
+    SpscRing<int> ring(4);
+    ring.setOverflowPolicy(SpscRing<int>::OverflowPolicy::DropOldest);
+    for (int i = 0; i < 6; ++i) {
+        QVERIFY(ring.push(i));
+    }
+    // 0、1 被挤出，新元素全部保留
+    QCOMPARE(ring.droppedCount(), std::uint64_t(2));
+
+    int value = -1;
+    for (int i = 2; i < 6; ++i) {
+        QVERIFY(ring.pop(value));
+        QCOMPARE(value, i);
+    }
+    QVERIFY(!ring.pop(value));
+}
+
+void TestSpscRing::wrapAround() {
+    SpscRing<int> ring(4);
+    int value = -1;
+    // 序号远超容量后仍保持先进先出
+    for (int i = 0; i < 1000; ++i) {
+        QVERIFY(ring.push(i));
+        QVERIFY(ring.push(i + 100000));
+        QVERIFY(ring.pop(value));
+        QCOMPARE(value, i);
+        QVERIFY(ring.pop(value));
+        QCOMPARE(value, i + 100000);
+    }
+}
+
+void TestSpscRing::concurrentLossless() {
+    SpscRing<int> ring(64);
+    // 生产者在队列满时重试，消费者应按顺序收到每一个元素
+    QThread* producer = QThread::create([&ring]() {
+        for (int i = 0; i < kConcurrentCount; ++i) {
+            while (!ring.push(i)) {
+                QThread::yieldCurrentThread();
+            }
+        }
+    });
+    producer->start();
+
+    int expected = 0;
+    int value = -1;
+    bool ordered = true;
+    while (expected < kConcurrentCount) {
+        if (ring.pop(value)) {
+            ordered = ordered && value == expected;
+            ++expected;
+        }
+        else {
+            QThread::yieldCurrentThread();
+        }
+    }
+    producer->wait();
+    delete producer;
+    QVERIFY(ordered);
+    QVERIFY(!ring.pop(value));
+}
+
+void TestSpscRing::concurrentDropOldest() {
+    SpscRing<int> ring(16);
+    ring.setOverflowPolicy(SpscRing<int>::OverflowPolicy::DropOldest);
+    std::atomic<bool> done{ false };
+    QThread* producer = QThread::create([&ring, &done]() {
+        for (int i = 0; i < kConcurrentCount; ++i) {
+            ring.push(i);
+        }
+        done.store(true);
+    });
+    producer->start();
+
+    // 生产者与消费者争抢最旧的槽位时也不能重复或乱序
+    int popped = 0;
+    int last = -1;
+    bool increasing = true;
+    int value = -1;
+    for (;;) {
+        const bool finished = done.load();
+        while (ring.pop(value)) {
+            increasing = increasing && value > last;
+            last = value;
+            ++popped;
+        }
+        if (finished) {
+            break;
+        }
+        QThread::yieldCurrentThread();
+    }
+    producer->wait();
+    delete producer;
+    QVERIFY(increasing);
+    QCOMPARE(std::uint64_t(popped) + ring.droppedCount(), std::uint64_t(kConcurrentCount));
+}
+
+QTEST_APPLESS_MAIN(TestSpscRing)
+#include "tst_spscring.moc"
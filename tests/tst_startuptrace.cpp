@@ -0,0 +1,168 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include <QBuffer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QThread>
+#include "StartupTrace.h"
+#include "Trace.h"
+
+// 阶段表是进程级的且只增不减：各用例使用互不相同的阶段名，按声明顺序执行
+namespace {
+const char* const kFillNames[] = { "f0", "f1", "f2", "f3", "f4", "f5", "f6", "f7", "f8", "f9", "f10", "f11",
+    "f12", "f13", "f14", "f15", "f16", "f17", "f18", "f19", "f20", "f21", "f22", "f23", "f24", "f25", "f26",
+    "f27", "f28", "f29", "f30", "f31" };
+} // namespace
+
+class TestStartupTrace : public QObject {
+    Q_OBJECT
+private slots:
+    void firstMarkWins();
+    void lookupComparesNames();
+    void phasesAreOrdered();
+    void concurrentMarksRecordOnce();
+    void recordsTraceEvent();
+    void finishWritesReportOnce();
+    void ignoresPhasesBeyondCapacity();
+};
+
+void TestStartupTrace::firstMarkWins() {
+    QCOMPARE(StartupTrace::elapsedMs("first"), -1.0);
+    QVERIFY(StartupTrace::mark("first"));
+    const double at = StartupTrace::elapsedMs("first");
+    QVERIFY(at >= 0.0);
+
+    QTest::qWait(5);
+    QVERIFY(!StartupTrace::mark("first"));
+    QCOMPARE(StartupTrace::elapsedMs("first"), at);
+}
+
+void TestStartupTrace::lookupComparesNames() {
+    QVERIFY(StartupTrace::mark("byName"));
+    // 查询不要求与记录时是同一个字符串指针
+    const QByteArray copy("byName");
+    QVERIFY(copy.constData() != static_cast<const char*>("byName"));
+    QVERIFY(StartupTrace::elapsedMs(copy.constData()) >= 0.0);
+    QVERIFY(!StartupTrace::mark(copy.constData()));
+}
+
+void TestStartupTrace::phasesAreOrdered() {
+    QVERIFY(StartupTrace::mark("early"));
+    QTest::qWait(5);
+    QVERIFY(StartupTrace::mark("late"));
+    const double early = StartupTrace::elapsedMs("early");
+    const double late = StartupTrace::elapsedMs("late");
+    QVERIFY(early >= StartupTrace::elapsedMs("first"));
+    QVERIFY2(late - early >= 4.0, qPrintable(QString::number(late - early)));
+}
+
+void TestStartupTrace::concurrentMarksRecordOnce() {
+    constexpr int kThreads = 8;
+    std::atomic<int> winners{ 0 };
+    QList<QThread*> threads;
+    for (int i = 0; i < kThreads; ++i) {
+        threads.append(QThread::create([&winners]() {
+            if (StartupTrace::mark("race")) {
+                ++winners;
+            }
+        }));
+    }
+    for (QThread* thread : threads) {
+        thread->start();
+    }
+    for (QThread* thread : threads) {
+        thread->wait();
+        delete thread;
+    }
+    QCOMPARE(winners.load(), 1);
+    QVERIFY(StartupTrace::elapsedMs("race") >= 0.0);
+}
+
+void TestStartupTrace::recordsTraceEvent() {
+    Trace::clear();
+    Trace::setEnabled(true);
+    QVERIFY(StartupTrace::mark("traced"));
+    Trace::setEnabled(false);
+
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    QVERIFY(Trace::writeJson(buffer));
+    const QJsonArray events = QJsonDocument::fromJson(buffer.data()).object().value("traceEvents").toArray();
+    // 完整事件从零点开始，时长即该阶段的时刻
+    int found = 0;
+    for (const QJsonValue& value : events) {
+        const QJsonObject event = value.toObject();
+        if (event.value("name").toString() == QLatin1String("traced")) {
+            QCOMPARE(event.value("cat").toString(), QStringLiteral("startup"));
+            QCOMPARE(event.value("ph").toString(), QStringLiteral("X"));
+            QVERIFY(qAbs(event.value("dur").toDouble() / 1000.0 - StartupTrace::elapsedMs("traced")) < 0.01);
+            ++found;
+        }
+    }
+    QCOMPARE(found, 1);
+    Trace::clear();
+}
+
+void TestStartupTrace::finishWritesReportOnce() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("startup.txt");
+    qputenv("HIDEWINDOW_STARTUP_TRACE", QFile::encodeName(path));
+    StartupTrace::initFromEnvironment();
+    qunsetenv("HIDEWINDOW_STARTUP_TRACE");
+
+    StartupTrace::finish();
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QList<QByteArray> lines = file.readAll().split('\n');
+    file.close();
+    // 每个阶段一行 "阶段<TAB>毫秒"，按记录顺序，末尾换行
+    const QList<QByteArray> expected = { "first", "byName", "early", "late", "race", "traced" };
+    QCOMPARE(lines.size(), expected.size() + 1);
+    QVERIFY(lines.last().isEmpty());
+    for (int i = 0; i < expected.size(); ++i) {
+        const QList<QByteArray> fields = lines.at(i).split('\t');
+        QCOMPARE(fields.size(), qsizetype(2));
+        QCOMPARE(fields.at(0), expected.at(i));
+        bool ok = false;
+        const double ms = fields.at(1).toDouble(&ok);
+        QVERIFY(ok);
+        QVERIFY(qAbs(ms - StartupTrace::elapsedMs(expected.at(i).constData())) < 0.01);
+    }
+
+    // 只有第一次调用生效
+    QVERIFY(file.remove());
+    StartupTrace::finish();
+    QVERIFY(!QFile::exists(path));
+    // 完成之后仍可记录与查询
+    QVERIFY(StartupTrace::mark("afterFinish"));
+    QVERIFY(StartupTrace::elapsedMs("afterFinish") >= 0.0);
+}
+
+void TestStartupTrace::ignoresPhasesBeyondCapacity() {
+    // 已记录 7 个阶段，表满之后新的阶段被忽略
+    int recorded = 0;
+    for (const char* name : kFillNames) {
+        recorded += StartupTrace::mark(name);
+    }
+    QCOMPARE(recorded, 32 - 7);
+    QVERIFY(StartupTrace::elapsedMs("f24") >= 0.0);
+    QCOMPARE(StartupTrace::elapsedMs("f25"), -1.0);
+    QCOMPARE(StartupTrace::elapsedMs("f31"), -1.0);
+    QVERIFY(StartupTrace::elapsedMs("first") >= 0.0);
+}
+
+QTEST_GUILESS_MAIN(TestStartupTrace)
+#include "tst_startuptrace.moc"
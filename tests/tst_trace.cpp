@@ -0,0 +1,212 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include <QBuffer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QThread>
+#include "Trace.h"
+
+namespace {
+// 导出并解析全部事件；JSON 无法解析时返回空数组并让调用处失败
+QJsonArray exportEvents() {
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    if (!Trace::writeJson(buffer)) {
+        return QJsonArray();
+    }
+    QJsonParseError error;
+    const QJsonDocument document = QJsonDocument::fromJson(buffer.data(), &error);
+    if (error.error != QJsonParseError::NoError) {
+        qWarning() << "Invalid trace JSON:" << error.errorString();
+        return QJsonArray();
+    }
+    return document.object().value("traceEvents").toArray();
+}
+
+// 除线程名元数据以外、名称为 name 的事件
+QList<QJsonObject> eventsNamed(const QJsonArray& events, const QString& name) {
+    QList<QJsonObject> result;
+    for (const QJsonValue& value : events) {
+        const QJsonObject event = value.toObject();
+        if (event.value("ph").toString() != QLatin1String("M") && event.value("name").toString() == name) {
+            result.append(event);
+        }
+    }
+    return result;
+}
+
+const char* const kRingNames[] = { "e0", "e1", "e2", "e3", "e4", "e5", "e6", "e7", "e8", "e9" };
+} // namespace
+
+class TestTrace : public QObject {
+    Q_OBJECT
+private slots:
+    void init();
+    void cleanup();
+    void disabledRecordsNothing();
+    void scopeAndInstant();
+    void namesAreEscaped();
+    void clearDropsEarlierEvents();
+    void ringKeepsNewestPerThread();
+    void writeJsonFile();
+    void environmentUnset();
+};
+
+void TestTrace::init() {
+    Trace::clear();
+    Trace::setEnabled(true);
+}
+
+void TestTrace::cleanup() {
+    Trace::setEnabled(false);
+}
+
+void TestTrace::disabledRecordsNothing() {
+    Trace::setEnabled(false);
+    QVERIFY(!Trace::isEnabled());
+    {
+        HW_TRACE_SCOPE("test", "disabled");
+        HW_TRACE_INSTANT("test", "disabledInstant");
+    }
+    const QJsonArray events = exportEvents();
+    QVERIFY(eventsNamed(events, "disabled").isEmpty());
+    QVERIFY(eventsNamed(events, "disabledInstant").isEmpty());
+
+    // 在作用域中途开启：构造时关闭的作用域不记录
+    {
+        Trace::Scope scope("test", "enabledMidway");
+        Trace::setEnabled(true);
+    }
+    QVERIFY(eventsNamed(exportEvents(), "enabledMidway").isEmpty());
+}
+
+void TestTrace::scopeAndInstant() {
+    {
+        HW_TRACE_SCOPE("test", "scope");
+        QThread::msleep(2);
+    }
+    HW_TRACE_INSTANT("test", "instant");
+
+    const QJsonArray events = exportEvents();
+    const QList<QJsonObject> scopes = eventsNamed(events, "scope");
+    QCOMPARE(scopes.size(), qsizetype(1));
+    const QJsonObject scope = scopes.first();
+    QCOMPARE(scope.value("ph").toString(), QStringLiteral("X"));
+    QCOMPARE(scope.value("cat").toString(), QStringLiteral("test"));
+    QCOMPARE(scope.value("pid").toInteger(), QCoreApplication::applicationPid());
+    // 时间单位为微秒
+    QVERIFY(scope.value("dur").toDouble() >= 2000.0);
+
+    const QList<QJsonObject> instants = eventsNamed(events, "instant");
+    QCOMPARE(instants.size(), qsizetype(1));
+    QCOMPARE(instants.first().value("ph").toString(), QStringLiteral("i"));
+    QVERIFY(!instants.first().contains("dur"));
+    QCOMPARE(instants.first().value("tid").toInt(), scope.value("tid").toInt());
+    QVERIFY(instants.first().value("ts").toDouble() >= scope.value("ts").toDouble() + scope.value("dur").toDouble());
+
+    // 每个线程一条线程名元数据
+    bool hasThreadName = false;
+    for (const QJsonValue& value : events) {
+        const QJsonObject event = value.toObject();
+        if (event.value("ph").toString() == QLatin1String("M") && event.value("tid").toInt() == scope.value("tid").toInt()) {
+            QCOMPARE(event.value("name").toString(), QStringLiteral("thread_name"));
+            hasThreadName = !event.value("args").toObject().value("name").toString().isEmpty();
+        }
+    }
+    QVERIFY(hasThreadName);
+}
+
+void TestTrace::namesAreEscaped() {
+    Trace::detail::record("quote\"cat", "back\\slash \"name\"", Trace::detail::now(), 1000);
+    const QJsonArray events = exportEvents();
+    const QList<QJsonObject> found = eventsNamed(events, QStringLiteral("back\\slash \"name\""));
+    QCOMPARE(found.size(), qsizetype(1));
+    QCOMPARE(found.first().value("cat").toString(), QStringLiteral("quote\"cat"));
+    QCOMPARE(found.first().value("dur").toDouble(), 1.0);
+}
+
+void TestTrace::clearDropsEarlierEvents() {
+    HW_TRACE_INSTANT("test", "beforeClear");
+    Trace::clear();
+    HW_TRACE_INSTANT("test", "afterClear");
+    const QJsonArray events = exportEvents();
+    QVERIFY(eventsNamed(events, "beforeClear").isEmpty());
+    QCOMPARE(eventsNamed(events, "afterClear").size(), qsizetype(1));
+
+    // 导出不清空缓冲区
+    QCOMPARE(eventsNamed(exportEvents(), "afterClear").size(), qsizetype(1));
+}
+
+void TestTrace::ringKeepsNewestPerThread() {
+    // 容量只影响之后新建的线程缓冲区
+    Trace::setBufferCapacity(3);
+    QThread* worker = QThread::create([]() {
+        for (const char* name : kRingNames) {
+            HW_TRACE_INSTANT("ring", name);
+        }
+    });
+    worker->setObjectName(QStringLiteral("ring worker"));
+    worker->start();
+    worker->wait();
+    delete worker;
+    Trace::setBufferCapacity(16384);
+
+    // 线程退出后缓冲区仍可导出；容量向上取整到 4，只保留最新的 4 条
+    const QJsonArray events = exportEvents();
+    for (int i = 0; i < 6; ++i) {
+        QVERIFY2(eventsNamed(events, kRingNames[i]).isEmpty(), kRingNames[i]);
+    }
+    int workerTid = -1;
+    for (int i = 6; i < 10; ++i) {
+        const QList<QJsonObject> found = eventsNamed(events, kRingNames[i]);
+        QCOMPARE(found.size(), qsizetype(1));
+        workerTid = found.first().value("tid").toInt();
+    }
+    bool named = false;
+    for (const QJsonValue& value : events) {
+        const QJsonObject event = value.toObject();
+        if (event.value("ph").toString() == QLatin1String("M") && event.value("tid").toInt() == workerTid) {
+            named = event.value("args").toObject().value("name").toString() == QLatin1String("ring worker");
+        }
+    }
+    QVERIFY(named);
+}
+
+void TestTrace::writeJsonFile() {
+    HW_TRACE_INSTANT("test", "toFile");
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath(QStringLiteral("trace.json"));
+    QVERIFY(Trace::writeJsonFile(path));
+
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll());
+    QVERIFY(document.isObject());
+    QCOMPARE(document.object().value("displayTimeUnit").toString(), QStringLiteral("ns"));
+    QCOMPARE(eventsNamed(document.object().value("traceEvents").toArray(), "toFile").size(), qsizetype(1));
+
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("Cannot write trace file"));
+    QVERIFY(!Trace::writeJsonFile(dir.filePath(QStringLiteral("missing/trace.json"))));
+}
+
+void TestTrace::environmentUnset() {
+    Trace::setEnabled(false);
+    qunsetenv("HIDEWINDOW_TRACE");
+    Trace::initFromEnvironment();
+    QVERIFY(!Trace::isEnabled());
+}
+
+QTEST_GUILESS_MAIN(TestTrace)
+#include "tst_trace.moc"
@@ -0,0 +1,242 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include <QRandomGenerator>
+#include <algorithm>
+#include "TrigramIndex.h"
+
+namespace {
+std::vector<quint32> lookup(const TrigramIndex& index, const QString& query) {
+    std::vector<quint32> docs;
+    index.lookup(TrigramIndex::terms(query), docs);
+    return docs;
+}
+
+// 对照实现：逐个文档在折叠文本中查找每个词
+std::vector<quint32> naiveLookup(const TrigramIndex& index, const QStringList& terms) {
+    std::vector<quint32> docs;
+    for (quint32 doc = 0; doc < index.nextDoc(); ++doc) {
+        if (!index.isAlive(doc)) {
+            continue;
+        }
+        // 名称与路径分别查找，跨越两者分界的位置不算命中
+        const QString text = index.text(doc).toString();
+        const qsizetype separator = text.indexOf(QLatin1Char('\n'));
+        const QString name = text.left(separator);
+        const QString path = text.mid(separator + 1);
+        const bool all = std::all_of(terms.begin(), terms.end(), [&](const QString& term) {
+            return name.contains(term) || path.contains(term);
+        });
+        if (all) {
+            docs.push_back(doc);
+        }
+    }
+    return docs;
+}
+
+QString randomWord(QRandomGenerator& random, int minLength, int maxLength) {
+    // 小字母表让短词与长词都经常命中
+    static const QString alphabet = QStringLiteral("abcABC./\\-");
+    QString word;
+    const int length = random.bounded(minLength, maxLength + 1);
+    for (int i = 0; i < length; ++i) {
+        word.append(alphabet.at(random.bounded(int(alphabet.size()))));
+    }
+    return word;
+}
+} // namespace
+
+class TestTrigramIndex : public QObject {
+    Q_OBJECT
+private slots:
+    void termsFoldAndSplit_data();
+    void termsFoldAndSplit();
+    void narrows_data();
+    void narrows();
+    void shortAndLongTerms();
+    void termsDoNotSpanFields();
+    void removeAndClear();
+    void findFromPosition();
+    void fuzzyScore();
+    void matchesNaiveLookup();
+};
+
+void TestTrigramIndex::termsFoldAndSplit_data() {
+    QTest::addColumn<QString>("query");
+    QTest::addColumn<QStringList>("terms");
+
+    QTest::newRow("empty") << QString() << QStringList();
+    QTest::newRow("whitespace only") << QStringLiteral(" \t ") << QStringList();
+    QTest::newRow("case") << QStringLiteral("Chrome") << QStringList{ QStringLiteral("chrome") };
+    QTest::newRow("several") << QStringLiteral("  Foo\tBAR  baz ")
+                             << QStringList{ QStringLiteral("foo"), QStringLiteral("bar"), QStringLiteral("baz") };
+    QTest::newRow("separators") << QStringLiteral("C:/Program Files")
+                                << QStringList{ QStringLiteral("c:\\program"), QStringLiteral("files") };
+    QTest::newRow("non-ascii") << QStringLiteral("ÄRGER") << QStringList{ QStringLiteral("ärger") };
+}
+
+void TestTrigramIndex::termsFoldAndSplit() {
+    QFETCH(QString, query);
+    QFETCH(QStringList, terms);
+    QCOMPARE(TrigramIndex::terms(query), terms);
+}
+
+void TestTrigramIndex::narrows_data() {
+    QTest::addColumn<QStringList>("old");
+    QTest::addColumn<QStringList>("current");
+    QTest::addColumn<bool>("narrows");
+
+    QTest::newRow("appended char") << QStringList{ "chr" } << QStringList{ "chro" } << true;
+    QTest::newRow("prepended char") << QStringList{ "hro" } << QStringList{ "chro" } << true;
+    QTest::newRow("new term") << QStringList{ "chr" } << QStringList{ "chr", "exe" } << true;
+    QTest::newRow("covered by other term") << QStringList{ "ex" } << QStringList{ "chr", "exe" } << true;
+    QTest::newRow("deleted char") << QStringList{ "chro" } << QStringList{ "chr" } << false;
+    QTest::newRow("replaced term") << QStringList{ "chr" } << QStringList{ "fir" } << false;
+    QTest::newRow("dropped term") << QStringList{ "chr", "exe" } << QStringList{ "chr" } << false;
+    QTest::newRow("from empty") << QStringList() << QStringList{ "a" } << true;
+}
+
+void TestTrigramIndex::narrows() {
+    QFETCH(QStringList, old);
+    QFETCH(QStringList, current);
+    QFETCH(bool, narrows);
+    QCOMPARE(TrigramIndex::narrows(old, current), narrows);
+}
+
+void TestTrigramIndex::shortAndLongTerms() {
+    TrigramIndex index;
+    const quint32 chrome = index.add(u"chrome.exe", u"C:/Program Files/Google/Chrome/chrome.exe");
+    const quint32 code = index.add(u"Code.exe", u"C:\\Users\\dev\\AppData\\Local\\Programs\\VS Code\\Code.exe");
+    const quint32 bash = index.add(u"bash", u"/usr/bin/bash");
+    QCOMPARE(index.aliveCount(), 3);
+    QCOMPARE(index.text(bash), QStringView(u"bash\n\\usr\\bin\\bash"));
+
+    // 不超过三个字符的词直接由倒排表给出
+    QCOMPARE(lookup(index, "e"), (std::vector<quint32>{ chrome, code }));
+    QCOMPARE(lookup(index, "EXE"), (std::vector<quint32>{ chrome, code }));
+    QCOMPARE(lookup(index, "sh"), std::vector<quint32>{ bash });
+    QVERIFY(index.postings(u"exe"));
+    QCOMPARE(index.postings(u"exe")->size(), std::size_t(2));
+    QVERIFY(!index.postings(u"zzz"));
+    QVERIFY(!index.postings(u"chrome"));
+    QVERIFY(!index.postings(u""));
+
+    // 长词的三元组都出现也要校验整个词
+    QCOMPARE(lookup(index, "program"), (std::vector<quint32>{ chrome, code }));
+    QCOMPARE(lookup(index, "c:/program files"), std::vector<quint32>{ chrome });
+    QCOMPARE(lookup(index, "\\usr\\bin"), std::vector<quint32>{ bash });
+    QCOMPARE(lookup(index, "chrome goo"), std::vector<quint32>{ chrome });
+    QVERIFY(lookup(index, "chrome bash").empty());
+    QVERIFY(lookup(index, "gramgram").empty());
+    QVERIFY(lookup(index, QString()).empty());
+
+    QVERIFY(index.matches(code, TrigramIndex::terms(u"vs code")));
+    QVERIFY(!index.matches(code, TrigramIndex::terms(u"vs chrome")));
+    QVERIFY(index.contains(bash, u"bin"));
+}
+
+void TestTrigramIndex::termsDoNotSpanFields() {
+    TrigramIndex index;
+    const quint32 doc = index.add(u"ab", u"cd");
+    // "bc" 只能跨越名称与路径的分界才出现
+    QVERIFY(lookup(index, "bc").empty());
+    QVERIFY(lookup(index, "abcd").empty());
+    QVERIFY(!index.contains(doc, u"bc"));
+    QCOMPARE(lookup(index, "ab cd"), std::vector<quint32>{ doc });
+}
+
+void TestTrigramIndex::removeAndClear() {
+    TrigramIndex index;
+    const quint32 first = index.add(u"notepad.exe", u"C:\\Windows\\notepad.exe");
+    const quint32 second = index.add(u"notepad++.exe", u"C:\\Tools\\notepad++.exe");
+    index.remove(first);
+    index.remove(first); // 重复删除无操作
+    QVERIFY(!index.isAlive(first));
+    QVERIFY(index.isAlive(second));
+    QVERIFY(!index.isAlive(99));
+    QCOMPARE(index.aliveCount(), 1);
+    QCOMPARE(index.deadCount(), 1);
+
+    QCOMPARE(lookup(index, "notepad"), std::vector<quint32>{ second });
+    QCOMPARE(lookup(index, "exe"), std::vector<quint32>{ second });
+    QVERIFY(!index.matches(first, TrigramIndex::terms(u"notepad")));
+    QCOMPARE(index.fuzzyScore(first, u"np"), -1);
+
+    // 文档号只增不减
+    const quint32 third = index.add(u"notepad.exe", QStringView());
+    QCOMPARE(third, quint32(2));
+    QCOMPARE(lookup(index, "notepad"), (std::vector<quint32>{ second, third }));
+
+    index.clear();
+    QCOMPARE(index.nextDoc(), quint32(0));
+    QCOMPARE(index.aliveCount(), 0);
+    QCOMPARE(index.deadCount(), 0);
+    QVERIFY(lookup(index, "e").empty());
+    QCOMPARE(index.add(u"x", u"y"), quint32(0));
+}
+
+void TestTrigramIndex::findFromPosition() {
+    TrigramIndex index;
+    const quint32 doc = index.add(u"abab", u"/ab");
+    QCOMPARE(index.find(doc, u"ab", 0), 0);
+    QCOMPARE(index.find(doc, u"ab", 1), 2);
+    QCOMPARE(index.find(doc, u"ab", 3), 6);
+    QCOMPARE(index.find(doc, u"ab", 7), -1);
+    QCOMPARE(index.find(doc, u"\\ab", 0), 5);
+    QCOMPARE(index.find(doc, u"abc", 0), -1);
+    QCOMPARE(index.find(doc, u"", 4), 4);
+}
+
+void TestTrigramIndex::fuzzyScore() {
+    TrigramIndex index;
+    const quint32 vscode = index.add(u"Code.exe", u"C:\\Programs\\VS Code\\Code.exe");
+    const quint32 chrome = index.add(u"chrome.exe", u"C:\\Google\\Chrome\\chrome.exe");
+    const quint32 helper = index.add(u"helper.exe", u"C:\\Google\\Chrome\\helper.exe");
+
+    QVERIFY(index.fuzzyScore(vscode, u"cde") >= 0);
+    QCOMPARE(index.fuzzyScore(vscode, u"xyz"), -1);
+    // 字符顺序不对不算命中
+    QCOMPARE(index.fuzzyScore(chrome, u"emorhc"), -1);
+    // 连续命中优于分散命中
+    QVERIFY(index.fuzzyScore(chrome, u"chr") > index.fuzzyScore(chrome, u"cre"));
+    // 名称内命中优于只在路径中命中
+    QVERIFY(index.fuzzyScore(chrome, u"chrome") > index.fuzzyScore(helper, u"chrome"));
+    QVERIFY(index.fuzzyScore(helper, u"chrome") >= 0);
+    // 词首命中加分：h 位于名称开头，p 在词中间
+    QVERIFY(index.fuzzyScore(helper, u"hx") > index.fuzzyScore(helper, u"px"));
+}
+
+void TestTrigramIndex::matchesNaiveLookup() {
+    QRandomGenerator random(20260319);
+    TrigramIndex index;
+    for (int i = 0; i < 300; ++i) {
+        index.add(randomWord(random, 0, 8), randomWord(random, 0, 16));
+        if (random.bounded(4) == 0) {
+            index.remove(static_cast<quint32>(random.bounded(int(index.nextDoc()))));
+        }
+    }
+    for (int i = 0; i < 500; ++i) {
+        QString query = randomWord(random, 1, 5);
+        if (random.bounded(3) == 0) {
+            query += QLatin1Char(' ') + randomWord(random, 1, 3);
+        }
+        const QStringList terms = TrigramIndex::terms(query);
+        std::vector<quint32> docs;
+        index.lookup(terms, docs);
+        QVERIFY2(docs == naiveLookup(index, terms), qPrintable(query));
+        for (quint32 doc : docs) {
+            QVERIFY(index.matches(doc, terms));
+        }
+    }
+}
+
+QTEST_APPLESS_MAIN(TestTrigramIndex)
+#include "tst_trigramindex.moc"
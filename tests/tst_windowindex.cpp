@@ -0,0 +1,227 @@
+// Copyright 2026 Scriptforge
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <QtTest>
+#include <algorithm>
+#include "FakeWindowSystem.h"
+#include "WindowIndex.h"
+
+namespace {
+// 记录观察者回调的顺序
+class RecordingObserver : public WindowIndexObserver {
+public:
+    void windowUpdated(const WindowInfo& info) override { updated.push_back(info.id); }
+    void windowRemoved(WindowId id) override { removed.push_back(id); }
+
+    std::vector<WindowId> updated;
+    std::vector<WindowId> removed;
+};
+
+std::vector<WindowId> windowsOf(const WindowIndex& index, qint64 pid) {
+    std::vector<WindowId> ids;
+    index.forEachWindowOf(pid, [&](const WindowInfo& info) { ids.push_back(info.id); });
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+} // namespace
+
+class TestWindowIndex : public QObject {
+    Q_OBJECT
+private slots:
+    void rebuildGroupsWindowsByPid();
+    void lookupsDoNotTouchWindowSystem();
+    void createdAndDestroyedEvents();
+    void visibilityEventAddsMissedWindow();
+    void titleChangeRefreshesCache();
+    void observerSeesOnlyNewlyShownWindows();
+    void destructorUnsubscribes();
+    void splitRebuildPrefersEvents();
+    void splitRebuildWithoutEvents();
+};
+
+void TestWindowIndex::rebuildGroupsWindowsByPid() {
+    FakeWindowSystem system;
+    const WindowId a = system.addWindow(10, "Main");
+    const WindowId b = system.addWindow(10, "Tool", QString(), false);
+    const WindowId c = system.addWindow(20, "Main");
+    WindowIndex index(&system);
+    QCOMPARE(index.size(), size_t(0));
+
+    index.rebuild();
+    QCOMPARE(system.calls().enumerate, 1);
+    QCOMPARE(index.size(), size_t(3));
+    QCOMPARE(windowsOf(index, 10), (std::vector<WindowId>{ a, b }));
+    QCOMPARE(windowsOf(index, 20), std::vector<WindowId>{ c });
+    QVERIFY(windowsOf(index, 30).empty());
+    QVERIFY(index.find(b));
+    QVERIFY(!index.find(b)->visible);
+    QVERIFY(!index.find(0xdead));
+
+    // 重建丢弃已不存在的窗口
+    system.destroyWindow(a, false);
+    index.rebuild();
+    QCOMPARE(index.size(), size_t(2));
+    QCOMPARE(windowsOf(index, 10), std::vector<WindowId>{ b });
+}
+
+void TestWindowIndex::lookupsDoNotTouchWindowSystem() {
+    FakeWindowSystem system;
+    for (qint64 pid = 1; pid <= 50; ++pid) {
+        system.addWindow(pid, "Main");
+        system.addWindow(pid, "Popup", QString(), false);
+    }
+    WindowIndex index(&system);
+    index.rebuild();
+    system.resetCalls();
+
+    int found = 0;
+    for (qint64 pid = 1; pid <= 50; ++pid) {
+        index.forEachWindowOf(pid, [&](const WindowInfo&) { ++found; });
+    }
+    QCOMPARE(found, 100);
+    QCOMPARE(system.calls().enumerate, 0);
+    QCOMPARE(system.calls().query, 0);
+}
+
+void TestWindowIndex::createdAndDestroyedEvents() {
+    FakeWindowSystem system;
+    WindowIndex index(&system);
+    index.rebuild();
+
+    const WindowId id = system.addWindow(7, "Late", "title", true, true);
+    QVERIFY(index.find(id));
+    QCOMPARE(index.find(id)->title, QStringLiteral("title"));
+    QCOMPARE(windowsOf(index, 7), std::vector<WindowId>{ id });
+
+    system.destroyWindow(id);
+    QVERIFY(!index.find(id));
+    QVERIFY(windowsOf(index, 7).empty());
+    QCOMPARE(index.size(), size_t(0));
+}
+
+void TestWindowIndex::visibilityEventAddsMissedWindow() {
+    FakeWindowSystem system;
+    WindowIndex index(&system);
+    index.rebuild();
+
+    // 创建事件丢失（窗口当时还不是顶层窗口），显示事件补录
+    const WindowId id = system.addWindow(9, "Main", QString(), false, false);
+    QVERIFY(!index.find(id));
+    system.showWindowExternally(id, true);
+    QVERIFY(index.find(id));
+    QVERIFY(index.find(id)->visible);
+}
+
+void TestWindowIndex::titleChangeRefreshesCache() {
+    FakeWindowSystem system;
+    const WindowId id = system.addWindow(3, "Editor", "old");
+    WindowIndex index(&system);
+    index.rebuild();
+
+    system.setTitle(id, "new");
+    QCOMPARE(index.find(id)->title, QStringLiteral("new"));
+}
+
+void TestWindowIndex::observerSeesOnlyNewlyShownWindows() {
+    FakeWindowSystem system;
+    const WindowId id = system.addWindow(5, "Main");
+    WindowIndex index(&system);
+    RecordingObserver observer;
+    index.setObserver(&observer);
+    // rebuild 不逐个通知
+    index.rebuild();
+    QVERIFY(observer.updated.empty());
+
+    // 可见窗口再次收到显示事件不算新显示
+    system.showWindowExternally(id, true);
+    QVERIFY(observer.updated.empty());
+
+    system.showWindowExternally(id, false);
+    system.showWindowExternally(id, true);
+    QCOMPARE(observer.updated, std::vector<WindowId>{ id });
+
+    // 自身修改可见性时先更新缓存，随后的事件不重复通知
+    index.setCachedVisible(id, false);
+    system.showWindowExternally(id, false);
+    index.setCachedVisible(id, true);
+    system.showWindowExternally(id, true);
+    QCOMPARE(observer.updated.size(), size_t(1));
+
+    system.destroyWindow(id);
+    QCOMPARE(observer.removed, std::vector<WindowId>{ id });
+    index.setObserver(nullptr);
+}
+
+void TestWindowIndex::destructorUnsubscribes() {
+    FakeWindowSystem system;
+    {
+        WindowIndex index(&system);
+        QCOMPARE(system.eventHandler(), static_cast<WindowEventHandler*>(&index));
+    }
+    QVERIFY(!system.eventHandler());
+    // 没有窗口系统时索引保持为空
+    WindowIndex empty(nullptr);
+    empty.rebuild();
+    QCOMPARE(empty.size(), size_t(0));
+}
+
+void TestWindowIndex::splitRebuildPrefersEvents() {
+    FakeWindowSystem system;
+    const WindowId kept = system.addWindow(1, "Main", "kept");
+    const WindowId retitled = system.addWindow(2, "Main", "old");
+    const WindowId destroyed = system.addWindow(3, "Main");
+    const WindowId stale = system.addWindow(4, "Main");
+    WindowIndex index(&system);
+    index.rebuild();
+
+    // 遍历结果在事件之前取得，相当于后台线程遍历时桌面仍在变化
+    index.beginRebuild();
+    std::vector<WindowInfo> windows;
+    system.enumerateTopLevelWindows(windows);
+    const WindowId created = system.addWindow(5, "Late", "late", true, true);
+    system.setTitle(retitled, "new");
+    system.destroyWindow(destroyed);
+    system.destroyWindow(stale, false);
+    index.finishRebuild(windows);
+
+    QVERIFY(windows.empty());
+    QVERIFY(index.find(kept));
+    QCOMPARE(index.find(created)->title, QStringLiteral("late"));
+    QCOMPARE(index.find(retitled)->title, QStringLiteral("new"));
+    // 遍历期间销毁的窗口不会被加回；未收到事件的窗口以遍历结果为准
+    QVERIFY(!index.find(destroyed));
+    QVERIFY(index.find(stale));
+    QCOMPARE(index.size(), size_t(4));
+    QCOMPARE(windowsOf(index, 2), std::vector<WindowId>{ retitled });
+    QVERIFY(windowsOf(index, 3).empty());
+
+    // 合并之后事件恢复直接更新，下一次重建不再沿用上次的记录
+    index.rebuild();
+    QVERIFY(!index.find(stale));
+    QCOMPARE(index.size(), size_t(3));
+}
+
+void TestWindowIndex::splitRebuildWithoutEvents() {
+    FakeWindowSystem system;
+    const WindowId a = system.addWindow(10, "Main");
+    WindowIndex index(&system);
+    index.rebuild();
+    const WindowId b = system.addWindow(10, "Tool", QString(), true, false);
+
+    index.beginRebuild();
+    std::vector<WindowInfo> windows;
+    system.enumerateTopLevelWindows(windows);
+    index.finishRebuild(windows);
+    QCOMPARE(windowsOf(index, 10), (std::vector<WindowId>{ a, b }));
+    QCOMPARE(system.calls().enumerate, 2);
+}
+
+QTEST_GUILESS_MAIN(TestWindowIndex)
+#include "tst_windowindex.moc"